@@ -437,8 +437,8 @@ static inline PetscErrorCode DMGetLocalOffset_Private(DM dm, PetscInt point, Pet
     *end = *start + dof;
   } else {
     const PetscSection s = dm->localSection;
-    *start               = s->atlasOff[point - s->pStart];
-    *end                 = *start + s->atlasDof[point - s->pStart];
+    *start               = PetscSectionGetOffset_Private(s, point - s->pStart);
+    *end                 = *start + PetscSectionGetDof_Private(s, point - s->pStart);
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -455,8 +455,8 @@ static inline PetscErrorCode DMGetLocalFieldOffset_Private(DM dm, PetscInt point
     *end = *start + dof;
   } else {
     const PetscSection s = dm->localSection->field[field];
-    *start               = s->atlasOff[point - s->pStart];
-    *end                 = *start + s->atlasDof[point - s->pStart];
+    *start               = PetscSectionGetOffset_Private(s, point - s->pStart);
+    *end                 = *start + PetscSectionGetDof_Private(s, point - s->pStart);
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -475,9 +475,9 @@ static inline PetscErrorCode DMGetGlobalOffset_Private(DM dm, PetscInt point, Pe
     *end = *start + dof - cdof + (dof < 0 ? 1 : 0);
   } else {
     const PetscSection s    = dm->globalSection;
-    const PetscInt     dof  = s->atlasDof[point - s->pStart];
-    const PetscInt     cdof = s->bc ? s->bc->atlasDof[point - s->bc->pStart] : 0;
-    *start                  = s->atlasOff[point - s->pStart];
+    const PetscInt     dof  = PetscSectionGetDof_Private(s, point - s->pStart);
+    const PetscInt     cdof = s->bc ? PetscSectionGetDof_Private(s->bc, point - s->bc->pStart) : 0;
+    *start                  = PetscSectionGetOffset_Private(s, point - s->pStart);
     *end                    = *start + dof - cdof + (dof < 0 ? 1 : 0);
   }
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -506,16 +506,16 @@ static inline PetscErrorCode DMGetGlobalFieldOffset_Private(DM dm, PetscInt poin
     const PetscSection s      = dm->localSection;
     const PetscSection fs     = dm->localSection->field[field];
     const PetscSection gs     = dm->globalSection;
-    const PetscInt     loff   = s->atlasOff[point - s->pStart];
-    const PetscInt     goff   = gs->atlasOff[point - s->pStart];
-    const PetscInt     lfoff  = fs->atlasOff[point - s->pStart];
-    const PetscInt     fdof   = fs->atlasDof[point - s->pStart];
-    const PetscInt     fcdof  = fs->bc ? fs->bc->atlasDof[point - fs->bc->pStart] : 0;
+    const PetscInt     loff   = PetscSectionGetOffset_Private(s, point - s->pStart);
+    const PetscInt     goff   = PetscSectionGetOffset_Private(gs, point - s->pStart);
+    const PetscInt     lfoff  = PetscSectionGetOffset_Private(fs, point - s->pStart);
+    const PetscInt     fdof   = PetscSectionGetDof_Private(fs, point - s->pStart);
+    const PetscInt     fcdof  = fs->bc ? PetscSectionGetDof_Private(fs->bc, point - fs->bc->pStart) : 0;
     PetscInt           ffcdof = 0, f;
 
     for (f = 0; f < field; ++f) {
       const PetscSection ffs = dm->localSection->field[f];
-      ffcdof += ffs->bc ? ffs->bc->atlasDof[point - ffs->bc->pStart] : 0;
+      ffcdof += ffs->bc ? PetscSectionGetDof_Private(ffs->bc, point - ffs->bc->pStart) : 0;
     }
     *start = goff + (goff < 0 ? loff - lfoff + ffcdof : lfoff - loff - ffcdof);
     *end   = *start < 0 ? *start - (fdof - fcdof) : *start + fdof - fcdof;
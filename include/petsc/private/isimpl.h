@@ -62,6 +62,8 @@ struct _p_IS {
 
 PETSC_INTERN PetscErrorCode ISView_Binary(IS, PetscViewer);
 PETSC_INTERN PetscErrorCode ISLoad_Default(IS, PetscViewer);
+PETSC_INTERN PetscErrorCode ISSum_Segment(IS, IS, IS *);
+PETSC_INTERN PetscErrorCode ISDifference_Segment(IS, IS, IS *);
 
 struct _ISLocalToGlobalMappingOps {
   PetscErrorCode (*globaltolocalmappingsetup)(ISLocalToGlobalMapping);
@@ -88,6 +90,8 @@ struct _p_ISLocalToGlobalMapping {
   void      *data;           /* type specific data is stored here */
 };
 
+PETSC_INTERN PetscErrorCode ISLocalToGlobalMappingApplySegment_Private(ISLocalToGlobalMapping, IS, PetscInt[]);
+
 struct _n_ISColoring {
   PetscInt         refct;
   PetscInt         n;  /* number of colors */
@@ -0,0 +1,106 @@
+/*
+    Dense LU factorization with partial pivoting, and the corresponding solve, of PETSC_KERNEL_BATCH_LANES
+  systems of the same size n interleaved so that the innermost loops run over the systems with unit stride.
+
+    Entry (i,j) of the matrix of system l is stored in a[(i + j * n) * PETSC_KERNEL_BATCH_LANES + l] and entry i of
+  a vector of system l in x[i * PETSC_KERNEL_BATCH_LANES + l]. Used by PCBJBATCH and PCPATCH.
+*/
+#pragma once
+#include <petscsys.h>
+
+#define PETSC_KERNEL_BATCH_LANES 8
+
+/* the pivot search and the row swaps are done system by system, piv has n * PETSC_KERNEL_BATCH_LANES entries;
+   a zero pivot is replaced by one so the other systems are not polluted and flagged in zeropivot[] */
+static inline void PetscKernel_BatchLUFactor(PetscInt n, PetscScalar *a, PetscInt *piv, PetscBool *zeropivot)
+{
+  PetscScalar ipiv[PETSC_KERNEL_BATCH_LANES];
+
+  for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) zeropivot[l] = PETSC_FALSE;
+  for (PetscInt k = 0; k < n; k++) {
+    for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) {
+      PetscInt  p    = k;
+      PetscReal amax = PetscAbsScalar(a[(k + k * n) * PETSC_KERNEL_BATCH_LANES + l]);
+
+      for (PetscInt i = k + 1; i < n; i++) {
+        if (PetscAbsScalar(a[(i + k * n) * PETSC_KERNEL_BATCH_LANES + l]) > amax) {
+          amax = PetscAbsScalar(a[(i + k * n) * PETSC_KERNEL_BATCH_LANES + l]);
+          p    = i;
+        }
+      }
+      piv[k * PETSC_KERNEL_BATCH_LANES + l] = p;
+      if (p != k) {
+        for (PetscInt j = 0; j < n; j++) {
+          PetscScalar t = a[(k + j * n) * PETSC_KERNEL_BATCH_LANES + l];
+
+          a[(k + j * n) * PETSC_KERNEL_BATCH_LANES + l] = a[(p + j * n) * PETSC_KERNEL_BATCH_LANES + l];
+          a[(p + j * n) * PETSC_KERNEL_BATCH_LANES + l] = t;
+        }
+      }
+      if (amax == 0.0) {
+        zeropivot[l]                                  = PETSC_TRUE;
+        a[(k + k * n) * PETSC_KERNEL_BATCH_LANES + l] = 1.0;
+      }
+      ipiv[l] = 1.0 / a[(k + k * n) * PETSC_KERNEL_BATCH_LANES + l];
+    }
+    for (PetscInt i = k + 1; i < n; i++) {
+      PetscScalar *aik = a + (i + k * n) * PETSC_KERNEL_BATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) aik[l] *= ipiv[l];
+    }
+    for (PetscInt j = k + 1; j < n; j++) {
+      const PetscScalar *akj = a + (k + j * n) * PETSC_KERNEL_BATCH_LANES;
+
+      for (PetscInt i = k + 1; i < n; i++) {
+        const PetscScalar *aik = a + (i + k * n) * PETSC_KERNEL_BATCH_LANES;
+        PetscScalar       *aij = a + (i + j * n) * PETSC_KERNEL_BATCH_LANES;
+
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) aij[l] -= aik[l] * akj[l];
+      }
+    }
+  }
+}
+
+/* x is overwritten by the solutions */
+static inline void PetscKernel_BatchLUSolve(PetscInt n, const PetscScalar *a, const PetscInt *piv, PetscScalar *x)
+{
+  for (PetscInt k = 0; k < n; k++) {
+    for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) {
+      PetscInt p = piv[k * PETSC_KERNEL_BATCH_LANES + l];
+
+      if (p != k) {
+        PetscScalar t = x[k * PETSC_KERNEL_BATCH_LANES + l];
+
+        x[k * PETSC_KERNEL_BATCH_LANES + l] = x[p * PETSC_KERNEL_BATCH_LANES + l];
+        x[p * PETSC_KERNEL_BATCH_LANES + l] = t;
+      }
+    }
+  }
+  for (PetscInt j = 0; j < n; j++) {
+    const PetscScalar *xj = x + j * PETSC_KERNEL_BATCH_LANES;
+
+    for (PetscInt i = j + 1; i < n; i++) {
+      const PetscScalar *aij = a + (i + j * n) * PETSC_KERNEL_BATCH_LANES;
+      PetscScalar       *xi  = x + i * PETSC_KERNEL_BATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) xi[l] -= aij[l] * xj[l];
+    }
+  }
+  for (PetscInt j = n - 1; j >= 0; j--) {
+    const PetscScalar *ajj = a + (j + j * n) * PETSC_KERNEL_BATCH_LANES;
+    PetscScalar       *xj  = x + j * PETSC_KERNEL_BATCH_LANES;
+
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) xj[l] /= ajj[l];
+    for (PetscInt i = 0; i < j; i++) {
+      const PetscScalar *aij = a + (i + j * n) * PETSC_KERNEL_BATCH_LANES;
+      PetscScalar       *xi  = x + i * PETSC_KERNEL_BATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) xi[l] -= aij[l] * xj[l];
+    }
+  }
+}
@@ -0,0 +1,19 @@
+/*
+   Private kernels shared by the block and pseudo-block Krylov methods used by KSPMatSolve() with KSPCG and KSPGMRES, and by KSPECG
+
+   A block of vectors is stored as the columns of a MATDENSE, so that the operator and the preconditioner are applied to all
+   the vectors at once, and the inner products of all the vectors are computed with a single global reduction.
+*/
+#pragma once
+
+#include <petsc/private/kspimpl.h>
+
+PETSC_INTERN PetscErrorCode KSPBlockMatMult_Private(KSP, Mat, Mat, Mat *);
+PETSC_INTERN PetscErrorCode KSPBlockDot_Private(Mat, Mat, PetscScalar[]);
+PETSC_INTERN PetscErrorCode KSPBlockDots_Private(PetscInt, const Mat[], const Mat[], PetscScalar *[]);
+PETSC_INTERN PetscErrorCode KSPBlockColumnDot_Private(Mat, Mat, PetscScalar[]);
+PETSC_INTERN PetscErrorCode KSPBlockGEMM_Private(PetscScalar, Mat, PetscScalar, Mat, const PetscScalar[], PetscInt);
+PETSC_INTERN PetscErrorCode KSPBlockColumnMAXPY_Private(Mat, PetscScalar, Mat, const PetscScalar[]);
+PETSC_INTERN PetscErrorCode KSPBlockGramFactor_Private(PetscInt, PetscScalar[], const PetscReal[], PetscReal, PetscReal, PetscScalar[], PetscScalar[], PetscInt *);
+PETSC_INTERN PetscErrorCode KSPBlockCopyColumns_Private(PetscInt, Mat, const PetscInt[], Mat, const PetscInt[], InsertMode);
+PETSC_INTERN PetscErrorCode KSPBlockConverged_Private(KSP, PetscInt, PetscInt, const PetscReal[], const PetscReal[], PetscBool[], KSPConvergedReason *);
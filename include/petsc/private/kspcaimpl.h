@@ -0,0 +1,35 @@
+/*
+   Private data shared by the communication-avoiding (s-step) Krylov methods KSPCACG and KSPCAGMRES
+*/
+#pragma once
+
+#include <petsc/private/kspimpl.h>
+
+typedef struct {
+  PetscInt         s;          /* number of iterations per block, each block needs a single global reduction */
+  KSPCABasisType   basistype;  /* polynomial basis used to generate the s vectors of a block */
+  PetscReal        emin, emax; /* bounds of the spectrum of the preconditioned operator provided by the user */
+  PetscBool        userbounds; /* emin and emax have been provided */
+  PetscBool        mpk;        /* use the matrix powers kernel when possible */
+  PetscScalar     *a, *b, *c;  /* basis recurrence, Op v_j = c_j v_{j+1} + a_j v_j + b_j v_{j-1} for 0 <= j < s */
+  PetscBool        shifts;     /* a, b and c are set */
+  PetscObjectState state;      /* state of the operators the shifts were computed for */
+
+  /* matrix powers kernel */
+  Mat             *Aloc;     /* rows and columns of A in the depth-s overlap of the local rows */
+  IS               ovl;      /* global indices of the depth-s overlap */
+  VecScatter       scatter;  /* gathers the overlap of a vector */
+  Vec             *Xloc;     /* s+1 sequential vectors on the overlap */
+  PetscInt         ostart;   /* position of the first local row in the overlap */
+  PetscObjectState mpkstate; /* state of A when Aloc was extracted */
+} KSP_CA;
+
+PETSC_INTERN PetscErrorCode KSPCAInitialize_Private(KSP_CA *);
+PETSC_INTERN PetscErrorCode KSPCASetFromOptions_Private(KSP, KSP_CA *, PetscOptionItems);
+PETSC_INTERN PetscErrorCode KSPCAView_Private(KSP_CA *, PetscViewer);
+PETSC_INTERN PetscErrorCode KSPCASetUp_Private(KSP, KSP_CA *);
+PETSC_INTERN PetscErrorCode KSPCAReset_Private(KSP_CA *);
+PETSC_INTERN PetscErrorCode KSPCASetUpShifts_Private(KSP, KSP_CA *, PetscBool *);
+PETSC_INTERN PetscErrorCode KSPCASetRitzValues_Private(KSP, KSP_CA *, PetscInt, PetscReal[], PetscReal[]);
+PETSC_INTERN PetscErrorCode KSPCAComputeBasis_Private(KSP, KSP_CA *, PetscInt, Vec[], Vec[], Vec);
+PETSC_INTERN PetscErrorCode KSPCAChangeOfBasis_Private(KSP_CA *, PetscInt, PetscInt, PetscScalar[]);
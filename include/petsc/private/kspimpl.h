@@ -504,6 +504,7 @@ PETSC_EXTERN PetscLogEvent KSP_MatSolveTranspose;
 
 PETSC_INTERN PetscErrorCode MatGetSchurComplement_Basic(Mat, IS, IS, IS, IS, MatReuse, Mat *, MatSchurComplementAinvType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode PCPreSolveChangeRHS(PC, PetscBool *);
+PETSC_INTERN PetscErrorCode PCJacobiGetDiagonalRead_Private(PC, Vec *);
 
 /*MC
    KSPCheckDot - Checks if the result of a dot product used by the corresponding `KSP` contains infinity or NaN. These indicate that the previous
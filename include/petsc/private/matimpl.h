@@ -587,6 +587,7 @@ struct _p_MatCoarsen {
   PetscReal         threshold; /* HEM can filter interim graphs */
   PetscInt          strength_index_size;
   PetscInt          strength_index[MAT_COARSEN_STRENGTH_INDEX_SIZE];
+  PetscBool         luby; /* select the MIS vertices of each sweep in parallel */
 };
 
 PETSC_EXTERN PetscErrorCode MatCoarsenMISKSetDistance(MatCoarsen, PetscInt);
@@ -1681,6 +1682,13 @@ PETSC_EXTERN PetscErrorCode PetscCDGetHeadPos(const PetscCoarsenData *, PetscInt
 PETSC_EXTERN PetscErrorCode PetscCDGetNextPos(const PetscCoarsenData *, PetscInt, PetscCDIntNd **);
 PETSC_EXTERN PetscErrorCode PetscCDGetASMBlocks(const PetscCoarsenData *, const PetscInt, PetscInt *, IS **);
 
+/* kinds of the vertices of a sweep of the greedy MIS, for MatCoarsenMISLuby_Private() */
+#define MIS_LUBY_DONE      0 /* already in an aggregate */
+#define MIS_LUBY_BLOCKED   1 /* waits for a ghost neighbor or was removed, may only be added to an aggregate */
+#define MIS_LUBY_SINGLETON 2 /* removed if not added to an aggregate before its turn */
+#define MIS_LUBY_CANDIDATE 3 /* may be selected */
+PETSC_INTERN PetscErrorCode MatCoarsenMISLuby_Private(PetscInt, const PetscInt[], const PetscInt[], const PetscInt[], const PetscInt[], PetscInt[], PetscInt[], PetscInt *[]);
+
 PETSC_SINGLE_LIBRARY_VISIBILITY_INTERNAL PetscErrorCode MatFDColoringApply_AIJ(Mat, MatFDColoring, Vec, void *);
 
 typedef struct {
@@ -19,6 +19,7 @@ typedef struct {
   PetscBool       type_set;      /* if user set this value (so won't change it for symmetric problems) */
   PetscBool       sort_indices;  /* flag to sort subdomain indices */
   PetscBool       dm_subdomains; /* whether DM is allowed to define subdomains */
+  PetscBool       shared_memory; /* whether the rows of processes on the same node are read from shared memory */
   PCCompositeType loctype;       /* the type of composition for local solves */
   MatType         sub_mat_type;  /* the type of Mat used for subdomain solves (can be MATSAME or NULL) */
   /* For multiplicative solve */
@@ -10,6 +10,7 @@ struct _PCGAMGOps {
   PetscErrorCode (*coarsen)(PC, Mat *, PetscCoarsenData **);
   PetscErrorCode (*prolongator)(PC, Mat, PetscCoarsenData *, Mat *);
   PetscErrorCode (*optprolongator)(PC, Mat, Mat *);
+  PetscErrorCode (*updateprolongator)(PC, Mat, Mat, Mat); /* recompute the values of the optimized prolongator from the tentative one */
   PetscErrorCode (*createlevel)(PC, Mat, PetscInt, Mat *, Mat *, PetscMPIInt *, IS *, PetscBool);
   PetscErrorCode (*createdefaultdata)(PC, Mat); /* for data methods that have a default (SA) */
   PetscErrorCode (*setfromoptions)(PC, PetscOptionItems);
@@ -22,6 +23,7 @@ typedef struct gamg_TAG {
   PetscInt         Nlevels;
   PetscBool        repart;
   PetscBool        reuse_prol;
+  PetscBool        reuse_aggs;
   PetscBool        use_aggs_in_asm;
   PetscBool        use_parallel_coarse_grid_solver;
   PCGAMGLayoutType layout_type;
@@ -43,6 +45,10 @@ typedef struct gamg_TAG {
   PetscReal *data;      /* [data_sz] blocked vector of vertex data on fine grid (coordinates/nullspace) */
   PetscReal *orig_data; /* cache data */
   PetscReal  prolongator_filter;
+  /* kept with reuse_aggs to update the prolongators when only the matrix values change */
+  Mat Ptent[PETSC_MG_MAXLEVELS];    /* tentative prolongators */
+  Mat Psmooth[PETSC_MG_MAXLEVELS];  /* optimized prolongators, before the repartitioning */
+  IS  Pcolperm[PETSC_MG_MAXLEVELS]; /* columns of the optimized prolongators after the repartitioning */
 
   struct _PCGAMGOps *ops;
   char              *gamg_type_name;
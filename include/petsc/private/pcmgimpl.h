@@ -41,6 +41,8 @@ typedef struct {
   Mat           restrct;          /* restrict is a reserved word in C99 and on Cray */
   Mat           inject;           /* Used for moving state if provided. */
   Vec           rscale;           /* scaling of restriction matrix */
+  Vec           dinv;             /* inverse of the l1 row sums of A, for the smoothed interpolation of PC_MG_MULTADDITIVE */
+  Vec           w;                /* work vector of PC_MG_MULTADDITIVE on the finest level */
   PetscLogEvent eventsmoothsetup; /* if logging times for each level */
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
@@ -95,6 +97,7 @@ PETSC_INTERN PetscErrorCode PCMGComputeCoarseSpace_Internal(PC, PetscInt, PCMGCo
 PETSC_INTERN PetscErrorCode PCMGAdaptInterpolator_Internal(PC, PetscInt, KSP, KSP, Mat, Mat);
 PETSC_INTERN PetscErrorCode PCMGRecomputeLevelOperators_Internal(PC, PetscInt);
 PETSC_INTERN PetscErrorCode PCMGACycle_Private(PC, PC_MG_Levels **, PetscBool, PetscBool);
+PETSC_INTERN PetscErrorCode PCMGMACycle_Private(PC, PC_MG_Levels **, PetscBool, PetscBool);
 PETSC_INTERN PetscErrorCode PCMGFCycle_Private(PC, PC_MG_Levels **, PetscBool, PetscBool);
 PETSC_INTERN PetscErrorCode PCMGKCycle_Private(PC, PC_MG_Levels **, PetscBool, PetscBool);
 PETSC_INTERN PetscErrorCode PCMGMCycle_Private(PC, PC_MG_Levels **, PetscBool, PetscBool, PCRichardsonConvergedReason *);
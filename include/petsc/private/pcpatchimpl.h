@@ -5,11 +5,23 @@
 #include <petsc/private/pcimpl.h>
 #include <petsc/private/hashseti.h>
 #include <petsc/private/hashmapi.h>
+#include <petsc/private/kernels/batchlu.h>
 #include <petscksp.h>
 
 PETSC_INTERN PetscBool  PCPatchcite;
 PETSC_INTERN const char PCPatchCitation[];
 
+/* PETSC_KERNEL_BATCH_LANES patches with the same number of dofs whose dense LU factorizations are interleaved */
+typedef struct {
+  PetscInt     n;                                /* Number of dofs of the patches */
+  PetscInt     npatch;                           /* Number of patches in the pack, the other lanes hold the identity */
+  PetscInt     patch[PETSC_KERNEL_BATCH_LANES];  /* Patch of each lane */
+  PetscScalar *a;                                /* Interleaved LU factors */
+  PetscInt    *piv;                              /* Interleaved pivots */
+  PetscScalar *mat;                              /* Interleaved patch matrices that were factored, kept with densereuse */
+  PetscBool    zeropivot[PETSC_KERNEL_BATCH_LANES];
+} PCPatchDensePack;
+
 typedef struct {
   /* Topology */
   PCPatchConstructType ctype;                                           /* Algorithm for patch construction */
@@ -109,6 +121,12 @@ typedef struct {
   PetscObject *solver;                         /* Solvers for each patch TODO Do we need a new KSP for each patch? */
   PetscBool    denseinverse;                   /* Should the patch inverse by applied by computing the inverse and a matmult? (Skips KSP/PC etc...) */
   PetscErrorCode (*densesolve)(Mat, Vec, Vec); /* Matmult for dense solve (used with denseinverse) */
+  PetscBool         densebatch;                /* Factor and apply the dense patch matrices in packs of patches with the same number of dofs (used with denseinverse) */
+  PetscBool         densereuse;                /* Keep the factors of a pack whose patch matrices did not change (used with densebatch) */
+  PetscInt          npack;                     /* Number of packs */
+  PCPatchDensePack *packs;                     /* Packs of patches */
+  PetscInt         *patchToPack;               /* [patch] pack * PETSC_KERNEL_BATCH_LANES + lane of the patch */
+  PetscScalar      *packWork;                  /* Work array for the interleaved matrices or vectors of a pack */
   PetscErrorCode (*setupsolver)(PC);
   PetscErrorCode (*applysolver)(PC, PetscInt, Vec, Vec);
   PetscErrorCode (*resetsolver)(PC);
@@ -34,6 +34,11 @@ struct _p_PetscSection {
   PetscBool    includesConstraints; /* True if constrained dofs are included when computing offsets */
   PetscInt    *atlasDof;            /* Describes layout of storage, point --> # of values */
   PetscInt    *atlasOff;            /* Describes layout of storage, point --> offset into storage */
+  PetscInt     numRanges;           /* If positive, atlasDof and atlasOff are NULL and the layout is given by ranges of points with equal dof */
+  PetscInt    *rangeStart;          /* The first point of each range relative to pStart, rangeStart[numRanges] = pEnd - pStart */
+  PetscInt    *rangeDof;            /* The number of values of each point in the range */
+  PetscInt    *rangeOff;            /* The offset of the first point in the range */
+  PetscInt    *rangeStride;         /* The difference of the offsets of consecutive points in the range */
   PetscInt     maxDof;              /* Maximum dof on any point */
   PetscSection bc;                  /* Describes constraints, point --> # local dofs which are constrained */
   PetscInt    *bcIndices;           /* Local indices for constrained dofs */
@@ -86,13 +91,47 @@ PETSC_INTERN PetscErrorCode PetscSectionView_HDF5_Internal(PetscSection, PetscVi
 PETSC_INTERN PetscErrorCode PetscSectionLoad_HDF5_Internal(PetscSection, PetscViewer);
 #endif
 PETSC_INTERN PetscErrorCode PetscSectionArrayView_ASCII_Internal(PetscSection, void *, PetscDataType, PetscViewer);
+PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode PetscSectionMaterialize_Internal(PetscSection);
+
+// Return the range containing the point q, given relative to pStart, of a section stored as ranges
+static inline PetscInt PetscSectionFindRange_Private(PetscSection s, PetscInt q)
+{
+  PetscInt lo = 0, hi = s->numRanges;
+
+  while (hi - lo > 1) {
+    const PetscInt mid = lo + (hi - lo) / 2;
+
+    if (s->rangeStart[mid] <= q) lo = mid;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// Use these instead of atlasDof[q] and atlasOff[q] unless the section is known to have per-point arrays
+static inline PetscInt PetscSectionGetDof_Private(PetscSection s, PetscInt q)
+{
+  if (PetscLikely(!s->numRanges)) return s->atlasDof[q];
+  return s->rangeDof[PetscSectionFindRange_Private(s, q)];
+}
+
+static inline PetscInt PetscSectionGetOffset_Private(PetscSection s, PetscInt q)
+{
+  PetscInt r;
+
+  if (PetscLikely(!s->numRanges)) return s->atlasOff[q];
+  r = PetscSectionFindRange_Private(s, q);
+  return s->rangeOff[r] + (q - s->rangeStart[r]) * s->rangeStride[r];
+}
 
 static inline PetscErrorCode PetscSectionCheckConstraints_Private(PetscSection s)
 {
   PetscFunctionBegin;
   if (!s->bc) {
+    /* Constrained sections always have per-point arrays */
+    PetscCall(PetscSectionMaterialize_Internal(s));
     PetscCall(PetscSectionCreate(PETSC_COMM_SELF, &s->bc));
     PetscCall(PetscSectionSetChart(s->bc, s->pStart, s->pEnd));
+    PetscCall(PetscSectionMaterialize_Internal(s->bc));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
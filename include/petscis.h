@@ -25,7 +25,8 @@ PETSC_EXTERN PetscErrorCode ISFinalizePackage(void);
    Values:
 +  `ISGENERAL` - the values are stored with an array of indices and generally have no structure
 .  `ISSTRIDE`  - the values have a simple structure of an initial offset and then a step size between values
--  `ISBLOCK`   - values are an array of indices, each representing a block (of the same common length) of values
+.  `ISBLOCK`   - values are an array of indices, each representing a block (of the same common length) of values
+-  `ISSEGMENT` - the values are stored as a list of segments of consecutive integers, each given by its first value and its length
 
    Level: beginner
 
@@ -36,6 +37,7 @@ typedef const char *ISType;
 #define ISGENERAL "general"
 #define ISSTRIDE  "stride"
 #define ISBLOCK   "block"
+#define ISSEGMENT "segment"
 
 /* Dynamic creation and loading functions */
 PETSC_EXTERN PetscFunctionList ISList;
@@ -164,6 +166,12 @@ PETSC_EXTERN PetscErrorCode ISCreateStride(MPI_Comm, PetscInt, PetscInt, PetscIn
 PETSC_EXTERN PetscErrorCode ISStrideSetStride(IS, PetscInt, PetscInt, PetscInt);
 PETSC_EXTERN PetscErrorCode ISStrideGetInfo(IS, PetscInt *, PetscInt *);
 
+/* ISSEGMENT specific */
+PETSC_EXTERN PetscErrorCode ISCreateSegment(MPI_Comm, PetscInt, const PetscInt[], const PetscInt[], IS *);
+PETSC_EXTERN PetscErrorCode ISSegmentSetSegments(IS, PetscInt, const PetscInt[], const PetscInt[]);
+PETSC_EXTERN PetscErrorCode ISSegmentSetIndices(IS, PetscInt, const PetscInt[]);
+PETSC_EXTERN PetscErrorCode ISSegmentGetSegments(IS, PetscInt *, const PetscInt *[], const PetscInt *[]);
+
 #define IS_LTOGM_FILE_CLASSID 1211217
 PETSC_EXTERN PetscClassId IS_LTOGM_CLASSID;
 
@@ -187,16 +195,18 @@ typedef enum {
    ISLocalToGlobalMappingType - String with the name of a mapping method
 
    Values:
-+  `ISLOCALTOGLOBALMAPPINGBASIC` - a non-memory scalable way of storing `ISLocalToGlobalMapping` that allows applying `ISGlobalToLocalMappingApply()` efficiently
--  `ISLOCALTOGLOBALMAPPINGHASH`  - a memory scalable way of storing `ISLocalToGlobalMapping` that allows applying `ISGlobalToLocalMappingApply()` reasonably efficiently
++  `ISLOCALTOGLOBALMAPPINGBASIC`  - a non-memory scalable way of storing `ISLocalToGlobalMapping` that allows applying `ISGlobalToLocalMappingApply()` efficiently
+.  `ISLOCALTOGLOBALMAPPINGHASH`   - a memory scalable way of storing `ISLocalToGlobalMapping` that allows applying `ISGlobalToLocalMappingApply()` reasonably efficiently
+-  `ISLOCALTOGLOBALMAPPINGSORTED` - a memory scalable way of storing `ISLocalToGlobalMapping` as sorted runs of consecutive indices, efficient when there are few runs
 
    Level: beginner
 
 .seealso: `ISLocalToGlobalMapping`, `ISLocalToGlobalMappingSetType()`, `ISLocalToGlobalSetFromOptions()`, `ISGlobalToLocalMappingMode`
 J*/
 typedef const char *ISLocalToGlobalMappingType;
-#define ISLOCALTOGLOBALMAPPINGBASIC "basic"
-#define ISLOCALTOGLOBALMAPPINGHASH  "hash"
+#define ISLOCALTOGLOBALMAPPINGBASIC  "basic"
+#define ISLOCALTOGLOBALMAPPINGHASH   "hash"
+#define ISLOCALTOGLOBALMAPPINGSORTED "sorted"
 
 PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingSetType(ISLocalToGlobalMapping, ISLocalToGlobalMappingType);
 PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingGetType(ISLocalToGlobalMapping, ISLocalToGlobalMappingType *);
@@ -353,6 +363,7 @@ PETSC_EXTERN PetscErrorCode PetscLayoutSetISLocalToGlobalMapping(PetscLayout, IS
 PETSC_EXTERN PetscErrorCode PetscLayoutMapLocal(PetscLayout, PetscInt, const PetscInt[], PetscInt *, PetscInt *[], PetscInt *[]);
 
 PETSC_EXTERN PetscErrorCode PetscParallelSortInt(PetscLayout, PetscLayout, PetscInt *, PetscInt *);
+PETSC_EXTERN PetscErrorCode PetscParallelSortIntWithDataArray(PetscLayout, PetscLayout, PetscInt[], void *, size_t, PetscInt[], void *);
 
 /*S
   PetscKDTree - Implementation of KDTree for efficiently querying spatial points
@@ -362,7 +373,7 @@ PETSC_EXTERN PetscErrorCode PetscParallelSortInt(PetscLayout, PetscLayout, Petsc
   Note:
   See <https://en.wikipedia.org/wiki/K-d_tree> for a description of K-d trees
 
-.seealso: `PetscKDTreeCreate()`, `PetscKDTreeDestroy()`, `PetscKDTreeView()`, `PetscKDTreeQueryPointsNearestNeighbor()`
+.seealso: `PetscKDTreeCreate()`, `PetscKDTreeDestroy()`, `PetscKDTreeView()`, `PetscKDTreeQueryPointsNearestNeighbor()`, `PetscKDTreeQueryPointsRadius()`
 S*/
 typedef struct _n_PetscKDTree *PetscKDTree;
 
@@ -370,6 +381,7 @@ PETSC_EXTERN PetscErrorCode PetscKDTreeCreate(PetscCount, PetscInt, const PetscR
 PETSC_EXTERN PetscErrorCode PetscKDTreeDestroy(PetscKDTree *);
 PETSC_EXTERN PetscErrorCode PetscKDTreeView(PetscKDTree, PetscViewer);
 PETSC_EXTERN PetscErrorCode PetscKDTreeQueryPointsNearestNeighbor(PetscKDTree, PetscCount, const PetscReal[], PetscReal, PetscCount[], PetscReal[]);
+PETSC_EXTERN PetscErrorCode PetscKDTreeQueryPointsRadius(PetscKDTree, PetscCount, const PetscReal[], PetscReal, PetscCount *[], PetscCount *[]);
 
 PETSC_EXTERN PetscErrorCode ISGetLayout(IS, PetscLayout *);
 PETSC_EXTERN PetscErrorCode ISSetLayout(IS, PetscLayout);
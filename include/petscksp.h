@@ -48,6 +48,9 @@ typedef const char *KSPType;
 #define KSPPIPELCG    "pipelcg"
 #define KSPPIPEPRCG   "pipeprcg"
 #define KSPPIPECG2    "pipecg2"
+#define KSPCACG       "cacg"
+#define KSPRCG        "rcg"
+#define KSPECG        "ecg"
 #define KSPCGNE       "cgne"
 #define KSPNASH       "nash"
 #define KSPSTCG       "stcg"
@@ -63,6 +66,8 @@ typedef const char *KSPType;
 #define KSPLGMRES     "lgmres"
 #define KSPDGMRES     "dgmres"
 #define KSPPGMRES     "pgmres"
+#define KSPCAGMRES    "cagmres"
+#define KSPGCRODR     "gcrodr"
 #define KSPTCQMR      "tcqmr"
 #define KSPBCGS       "bcgs"
 #define KSPIBCGS      "ibcgs"
@@ -117,6 +122,27 @@ PETSC_DEPRECATED_FUNCTION(3, 15, 0, "KSPGetMatSolveBatchSize()", ) static inline
 {
   return KSPGetMatSolveBatchSize(ksp, n);
 }
+
+/*E
+   KSPMatSolveType - The algorithm used by `KSPMatSolve()` with the Krylov methods that provide several
+
+   Values:
++  `KSP_MATSOLVE_COLUMN`      - each right-hand side is solved independently with `KSPSolve()`
+.  `KSP_MATSOLVE_PSEUDOBLOCK` - the right-hand sides are solved independently, but the iterations are batched together so that
+                                the operator, the preconditioner, and the inner products are applied to all the columns at once
+-  `KSP_MATSOLVE_BLOCK`       - a block Krylov method is used, all the right-hand sides share a single block Krylov subspace
+
+   Level: intermediate
+
+.seealso: [](ch_ksp), `KSPMatSolve()`, `KSPCGSetMatSolveType()`, `KSPGMRESSetMatSolveType()`, `KSPCG`, `KSPGMRES`
+E*/
+typedef enum {
+  KSP_MATSOLVE_COLUMN      = 0,
+  KSP_MATSOLVE_PSEUDOBLOCK = 1,
+  KSP_MATSOLVE_BLOCK       = 2
+} KSPMatSolveType;
+PETSC_EXTERN const char *const KSPMatSolveTypes[];
+
 PETSC_EXTERN PetscErrorCode KSPReset(KSP);
 PETSC_EXTERN PetscErrorCode KSPResetViewers(KSP);
 PETSC_EXTERN PetscErrorCode KSPDestroy(KSP *);
@@ -273,6 +299,7 @@ PETSC_EXTERN PetscErrorCode PCMGGetSmootherUp(PC, PetscInt, KSP *);
 PETSC_EXTERN PetscErrorCode PCMGGetCoarseSolve(PC, KSP *);
 PETSC_EXTERN PetscErrorCode PCGalerkinGetKSP(PC, KSP *);
 PETSC_EXTERN PetscErrorCode PCDeflationGetCoarseKSP(PC, KSP *);
+PETSC_EXTERN PetscErrorCode PCBJBatchGetKSP(PC, KSP *);
 
 /*S
   PCMGCoarseSpaceConstructorFn - A function prototype for functions registered with `PCMGRegisterCoarseSpaceConstructor()`
@@ -322,6 +349,9 @@ PETSC_EXTERN PetscErrorCode KSPRichardsonSetSelfScale(KSP, PetscBool);
 PETSC_EXTERN PetscErrorCode KSPChebyshevSetEigenvalues(KSP, PetscReal, PetscReal);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSet(KSP, PetscReal, PetscReal, PetscReal, PetscReal);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP, PetscBool);
+PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSetUseCache(KSP, PetscBool);
+PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSetRefresh(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPChebyshevSetFused(KSP, PetscBool);
 PETSC_EXTERN PetscErrorCode KSPChebyshevSetKind(KSP, KSPChebyshevKind);
 PETSC_EXTERN PetscErrorCode KSPChebyshevGetKind(KSP, KSPChebyshevKind *);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigGetKSP(KSP, KSP *);
@@ -403,12 +433,17 @@ PETSC_EXTERN PetscErrorCode KSPGMRESSetRestart(KSP, PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGMRESGetRestart(KSP, PetscInt *);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetHapTol(KSP, PetscReal);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetBreakdownTolerance(KSP, PetscReal);
+PETSC_EXTERN PetscErrorCode KSPGMRESSetMatSolveType(KSP, KSPMatSolveType);
+PETSC_EXTERN PetscErrorCode KSPGMRESGetMatSolveType(KSP, KSPMatSolveType *);
 
 PETSC_EXTERN PetscErrorCode KSPGMRESSetPreAllocateVectors(KSP);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetOrthogonalization(KSP, PetscErrorCode (*)(KSP, PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESGetOrthogonalization(KSP, PetscErrorCode (**)(KSP, PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESModifiedGramSchmidtOrthogonalization(KSP, PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGMRESDCGS2Orthogonalization(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGMRESMGSICWYOrthogonalization(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGMRESLaggedCGS2Orthogonalization(KSP, PetscInt);
 
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetAugDim(KSP, PetscInt);
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
@@ -1060,12 +1095,50 @@ PETSC_EXTERN const char *const KSPCGTypes[];
 
 PETSC_EXTERN PetscErrorCode KSPCGSetType(KSP, KSPCGType);
 PETSC_EXTERN PetscErrorCode KSPCGUseSingleReduction(KSP, PetscBool);
+PETSC_EXTERN PetscErrorCode KSPCGSetMatSolveType(KSP, KSPMatSolveType);
+PETSC_EXTERN PetscErrorCode KSPCGGetMatSolveType(KSP, KSPMatSolveType *);
 
 PETSC_EXTERN PetscErrorCode KSPCGSetRadius(KSP, PetscReal);
 PETSC_EXTERN PetscErrorCode KSPCGSetObjectiveTarget(KSP, PetscReal);
 PETSC_EXTERN PetscErrorCode KSPCGGetNormD(KSP, PetscReal *);
 PETSC_EXTERN PetscErrorCode KSPCGGetObjFcn(KSP, PetscReal *);
 
+/*E
+   KSPCABasisType - The polynomial basis used by the communication-avoiding Krylov methods `KSPCACG` and `KSPCAGMRES` to
+   generate the vectors of a block of iterations
+
+   Values:
++  `KSP_CA_BASIS_MONOMIAL`  - the vectors are the powers of the operator applied to the starting vector, only stable for very small block sizes
+.  `KSP_CA_BASIS_NEWTON`    - the vectors are generated with shifts, the Leja-ordered Ritz values of the operator
+-  `KSP_CA_BASIS_CHEBYSHEV` - the vectors are scaled Chebyshev polynomials of the operator on an interval containing the Ritz values
+
+   Level: advanced
+
+.seealso: [](ch_ksp), `KSPCACG`, `KSPCAGMRES`, `KSP`, `KSPCASetBasisType()`, `KSPCASetStepSize()`, `KSPCASetEigenvalues()`
+E*/
+typedef enum {
+  KSP_CA_BASIS_MONOMIAL  = 0,
+  KSP_CA_BASIS_NEWTON    = 1,
+  KSP_CA_BASIS_CHEBYSHEV = 2
+} KSPCABasisType;
+PETSC_EXTERN const char *const KSPCABasisTypes[];
+
+PETSC_EXTERN PetscErrorCode KSPCASetStepSize(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPCAGetStepSize(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPCASetBasisType(KSP, KSPCABasisType);
+PETSC_EXTERN PetscErrorCode KSPCAGetBasisType(KSP, KSPCABasisType *);
+PETSC_EXTERN PetscErrorCode KSPCASetEigenvalues(KSP, PetscReal, PetscReal);
+PETSC_EXTERN PetscErrorCode KSPCASetUseMatrixPowers(KSP, PetscBool);
+
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRecycleDimension(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycleDimension(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycledDimension(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPRCGSetRecycleDimension(KSP, PetscInt, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPRCGGetRecycleDimension(KSP, PetscInt *, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPRCGGetRecycledDimension(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPECGSetEnlargingFactor(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPECGGetEnlargingFactor(KSP, PetscInt *);
+
 PETSC_EXTERN PetscErrorCode KSPGLTRGetMinEig(KSP, PetscReal *);
 PETSC_EXTERN PetscErrorCode KSPGLTRGetLambda(KSP, PetscReal *);
 PETSC_DEPRECATED_FUNCTION(3, 12, 0, "KSPGLTRGetMinEig()", ) static inline PetscErrorCode KSPCGGLTRGetMinEig(KSP ksp, PetscReal *x)
@@ -176,6 +176,8 @@ typedef const char *MatSolverType;
 #define MATSOLVERMATLAB       "matlab"
 #define MATSOLVERPETSC        "petsc"
 #define MATSOLVERBAS          "bas"
+#define MATSOLVERPARILU       "parilu"
+#define MATSOLVERSUPERNODAL   "supernodal"
 #define MATSOLVERCUSPARSE     "cusparse"
 #define MATSOLVERCUDA         "cuda"
 #define MATSOLVERHIPSPARSE    "hipsparse"
@@ -220,6 +220,7 @@ PETSC_EXTERN PetscErrorCode PCFactorReorderForNonzeroDiagonal(PC, PetscReal);
 PETSC_EXTERN PetscErrorCode PCFactorSetMatOrderingType(PC, MatOrderingType);
 PETSC_EXTERN PetscErrorCode PCFactorSetReuseOrdering(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCFactorSetReuseFill(PC, PetscBool);
+PETSC_EXTERN PetscErrorCode PCFactorSetShareSymbolic(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCFactorSetUseInPlace(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCFactorGetUseInPlace(PC, PetscBool *);
 PETSC_EXTERN PetscErrorCode PCFactorSetAllowDiagonalFill(PC, PetscBool);
@@ -238,6 +239,8 @@ PETSC_EXTERN PetscErrorCode PCASMSetTotalSubdomains(PC, PetscInt, IS[], IS[]);
 PETSC_EXTERN PetscErrorCode PCASMSetOverlap(PC, PetscInt);
 PETSC_EXTERN PetscErrorCode PCASMSetDMSubdomains(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCASMGetDMSubdomains(PC, PetscBool *);
+PETSC_EXTERN PetscErrorCode PCASMSetSharedMemory(PC, PetscBool);
+PETSC_EXTERN PetscErrorCode PCASMGetSharedMemory(PC, PetscBool *);
 PETSC_EXTERN PetscErrorCode PCASMSetSortIndices(PC, PetscBool);
 
 PETSC_EXTERN PetscErrorCode PCASMSetType(PC, PCASMType);
@@ -363,6 +366,7 @@ PETSC_EXTERN PetscErrorCode PCGAMGSetNlevels(PC, PetscInt);
 PETSC_EXTERN PetscErrorCode PCGAMGSetNSmooths(PC, PetscInt);
 PETSC_EXTERN PetscErrorCode PCGAMGSetAggressiveLevels(PC, PetscInt);
 PETSC_EXTERN PetscErrorCode PCGAMGSetReuseInterpolation(PC, PetscBool);
+PETSC_EXTERN PetscErrorCode PCGAMGSetReuseAggregates(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCGAMGFinalizePackage(void);
 PETSC_EXTERN PetscErrorCode PCGAMGInitializePackage(void);
 PETSC_EXTERN PetscErrorCode PCGAMGRegister(PCGAMGType, PetscErrorCode (*)(PC));
@@ -488,6 +492,10 @@ PETSC_EXTERN PetscErrorCode PCPatchSetPrecomputeElementTensors(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCPatchGetPrecomputeElementTensors(PC, PetscBool *);
 PETSC_EXTERN PetscErrorCode PCPatchSetPartitionOfUnity(PC, PetscBool);
 PETSC_EXTERN PetscErrorCode PCPatchGetPartitionOfUnity(PC, PetscBool *);
+PETSC_EXTERN PetscErrorCode PCPatchSetDenseBatch(PC, PetscBool);
+PETSC_EXTERN PetscErrorCode PCPatchGetDenseBatch(PC, PetscBool *);
+PETSC_EXTERN PetscErrorCode PCPatchSetDenseReuse(PC, PetscBool);
+PETSC_EXTERN PetscErrorCode PCPatchGetDenseReuse(PC, PetscBool *);
 PETSC_EXTERN PetscErrorCode PCPatchSetSubMatType(PC, MatType);
 PETSC_EXTERN PetscErrorCode PCPatchGetSubMatType(PC, MatType *);
 PETSC_EXTERN PetscErrorCode PCPatchSetCellNumbering(PC, PetscSection);
@@ -519,6 +527,7 @@ PETSC_EXTERN PetscErrorCode PCDeflationSetSpace(PC, Mat, PetscBool);
 PETSC_EXTERN PetscErrorCode PCDeflationSetProjectionNullSpaceMat(PC, Mat);
 PETSC_EXTERN PetscErrorCode PCDeflationSetCoarseMat(PC, Mat);
 PETSC_EXTERN PetscErrorCode PCDeflationGetPC(PC, PC *);
+PETSC_EXTERN PetscErrorCode PCDeflationSetAdaptive(PC, PetscInt, PetscInt);
 
 PETSC_EXTERN PetscErrorCode PCHPDDMSetAuxiliaryMat(PC, IS, Mat, PetscErrorCode (*)(Mat, PetscReal, Vec, Vec, PetscReal, IS, void *), void *);
 PETSC_EXTERN PetscErrorCode PCHPDDMSetRHSMat(PC, Mat);
@@ -41,6 +41,7 @@ typedef const char *PCType;
 #define PCGASM               "gasm"
 #define PCKSP                "ksp"
 #define PCBJKOKKOS           "bjkokkos"
+#define PCBJBATCH            "bjbatch"
 #define PCCOMPOSITE          "composite"
 #define PCREDUNDANT          "redundant"
 #define PCSPAI               "spai"
@@ -351,7 +352,11 @@ typedef const char *PCGAMGClassicalType;
                                       to the next, performs a cycle etc. This is much like the F-cycle presented in "Multigrid" by Trottenberg, Oosterlee, Schuller page 49, but that
                                       algorithm supports smoothing on before the restriction on each level in the initial restriction to the coarsest stage. In addition that algorithm
                                       calls the V-cycle only on the coarser level and has a post-smoother instead.
--  `PC_MG_KASKADE`                  - Cascadic or Kaskadic multigrid, like full multigrid except one never goes back to a coarser level from a finer
+.  `PC_MG_KASKADE`                  - Cascadic or Kaskadic multigrid, like full multigrid except one never goes back to a coarser level from a finer
+-  `PC_MG_MULTADDITIVE`             - the mult-additive multigrid preconditioner, the additive form with the interpolations smoothed by
+                                      l1-Jacobi, $(I - D^{-1} A) P$, and their transposes for the restrictions. Like the additive form all
+                                      levels are smoothed independently, with a convergence closer to the multiplicative V-cycle. This only
+                                      uses the down smoother
 
    Level: beginner
 
@@ -361,7 +366,8 @@ typedef enum {
   PC_MG_MULTIPLICATIVE,
   PC_MG_ADDITIVE,
   PC_MG_FULL,
-  PC_MG_KASKADE
+  PC_MG_KASKADE,
+  PC_MG_MULTADDITIVE
 } PCMGType;
 #define PC_MG_CASCADE PC_MG_KASKADE;
 
@@ -1140,8 +1140,9 @@ class LGMapMapMode(object):
 
 class LGMapType(object):
     """Local to global map types."""
-    BASIC = S_(ISLOCALTOGLOBALMAPPINGBASIC)
-    HASH  = S_(ISLOCALTOGLOBALMAPPINGHASH)
+    BASIC  = S_(ISLOCALTOGLOBALMAPPINGBASIC)
+    HASH   = S_(ISLOCALTOGLOBALMAPPINGHASH)
+    SORTED = S_(ISLOCALTOGLOBALMAPPINGSORTED)
 
 
 # --------------------------------------------------------------------
@@ -32,6 +32,15 @@ class KSPType(object):
     `PIPECG2`
         Pipelined conjugate gradient method with a single non-blocking
         reduction per two iterations. `petsc.KSPPIPECG2`
+    `CACG`
+        Communication-avoiding (s-step) conjugate gradient method with a
+        single global reduction every s iterations. `petsc.KSPCACG`
+    `RCG`
+        Recycled (deflated) conjugate gradient method for sequences of
+        linear systems. `petsc.KSPRCG`
+    `ECG`
+        Enlarged conjugate gradient method, which splits the residual by
+        subdomain. `petsc.KSPECG`
     `CGNE`
         Applies the preconditioned conjugate gradient method to the
         normal equations without explicitly forming AᵀA. `petsc.KSPCGNE`
@@ -71,6 +80,12 @@ class KSPType(object):
     `PGMRES`
         Pipelined Generalized Minimal Residual method.
         `petsc.KSPPGMRES`
+    `CAGMRES`
+        Communication-avoiding (s-step) Generalized Minimal Residual method.
+        `petsc.KSPCAGMRES`
+    `GCRODR`
+        GCRO method with deflated restarting, which recycles a subspace
+        between cycles and linear solves. `petsc.KSPGCRODR`
     `TCQMR`
         A variant of Quasi Minimal Residual (QMR).
         `petsc.KSPTCQMR`
@@ -183,6 +198,9 @@ class KSPType(object):
     PIPELCG    = S_(KSPPIPELCG)
     PIPEPRCG   = S_(KSPPIPEPRCG)
     PIPECG2    = S_(KSPPIPECG2)
+    CACG       = S_(KSPCACG)
+    RCG        = S_(KSPRCG)
+    ECG        = S_(KSPECG)
     CGNE       = S_(KSPCGNE)
     NASH       = S_(KSPNASH)
     STCG       = S_(KSPSTCG)
@@ -195,6 +213,8 @@ class KSPType(object):
     LGMRES     = S_(KSPLGMRES)
     DGMRES     = S_(KSPDGMRES)
     PGMRES     = S_(KSPPGMRES)
+    CAGMRES    = S_(KSPCAGMRES)
+    GCRODR     = S_(KSPGCRODR)
     TCQMR      = S_(KSPTCQMR)
     BCGS       = S_(KSPBCGS)
     IBCGS      = S_(KSPIBCGS)
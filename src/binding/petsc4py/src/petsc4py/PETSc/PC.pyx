@@ -51,6 +51,7 @@ class PCType(object):
     DEFLATION          = S_(PCDEFLATION)
     HPDDM              = S_(PCHPDDM)
     H2OPUS             = S_(PCH2OPUS)
+    BJBATCH            = S_(PCBJBATCH)
 
 
 class PCSide(object):
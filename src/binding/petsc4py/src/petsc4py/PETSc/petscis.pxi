@@ -66,6 +66,7 @@ cdef extern from * nogil:
     ctypedef const char* PetscISLocalToGlobalMappingType "ISLocalToGlobalMappingType"
     PetscISLocalToGlobalMappingType ISLOCALTOGLOBALMAPPINGBASIC
     PetscISLocalToGlobalMappingType ISLOCALTOGLOBALMAPPINGHASH
+    PetscISLocalToGlobalMappingType ISLOCALTOGLOBALMAPPINGSORTED
 
     ctypedef enum PetscGLMapMode "ISGlobalToLocalMappingMode":
         PETSC_IS_GTOLM_MASK "IS_GTOLM_MASK"
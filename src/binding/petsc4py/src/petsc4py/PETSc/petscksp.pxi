@@ -10,6 +10,9 @@ cdef extern from * nogil:
     PetscKSPType KSPPIPELCG
     PetscKSPType KSPPIPEPRCG
     PetscKSPType KSPPIPECG2
+    PetscKSPType KSPCACG
+    PetscKSPType KSPRCG
+    PetscKSPType KSPECG
     PetscKSPType KSPCGNE
     PetscKSPType KSPNASH
     PetscKSPType KSPSTCG
@@ -22,6 +25,8 @@ cdef extern from * nogil:
     PetscKSPType   KSPLGMRES
     PetscKSPType   KSPDGMRES
     PetscKSPType   KSPPGMRES
+    PetscKSPType   KSPCAGMRES
+    PetscKSPType   KSPGCRODR
     PetscKSPType KSPTCQMR
     PetscKSPType KSPBCGS
     PetscKSPType   KSPIBCGS
@@ -50,6 +50,7 @@ cdef extern from * nogil:
     PetscPCType PCDEFLATION
     PetscPCType PCHPDDM
     PetscPCType PCH2OPUS
+    PetscPCType PCBJBATCH
 
     ctypedef enum PetscPCSide "PCSide":
         PC_SIDE_DEFAULT
@@ -4112,17 +4112,17 @@ static inline PetscErrorCode DMPlexGetTransitiveClosure_Hot_Private(DM dm, Petsc
     if (useCone) {
       const PetscSection s   = mesh->coneSection;
       const PetscInt     ps  = p - s->pStart;
-      const PetscInt     off = s->atlasOff[ps];
+      const PetscInt     off = PetscSectionGetOffset_Private(s, ps);
 
-      *size = s->atlasDof[ps];
+      *size = PetscSectionGetDof_Private(s, ps);
       *arr  = mesh->cones + off;
       *ornt = mesh->coneOrientations + off;
     } else {
       const PetscSection s   = mesh->supportSection;
       const PetscInt     ps  = p - s->pStart;
-      const PetscInt     off = s->atlasOff[ps];
+      const PetscInt     off = PetscSectionGetOffset_Private(s, ps);
 
-      *size = s->atlasDof[ps];
+      *size = PetscSectionGetDof_Private(s, ps);
       *arr  = mesh->supports + off;
     }
   }
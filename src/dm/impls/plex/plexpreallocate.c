@@ -380,6 +380,9 @@ static PetscErrorCode DMPlexCreateAdjacencySection_Static(DM dm, PetscInt bs, Pe
   }
   /* Get maximum remote adjacency sizes for owned dofs on interface (roots) */
   if (doComm) {
+    /* The dof are reduced directly into the per-point arrays */
+    PetscCall(PetscSectionMaterialize_Internal(leafSectionAdj));
+    PetscCall(PetscSectionMaterialize_Internal(rootSectionAdj));
     PetscCall(PetscSFReduceBegin(sfDof, MPIU_INT, leafSectionAdj->atlasDof, rootSectionAdj->atlasDof, MPI_SUM));
     PetscCall(PetscSFReduceEnd(sfDof, MPIU_INT, leafSectionAdj->atlasDof, rootSectionAdj->atlasDof, MPI_SUM));
     PetscCall(PetscSectionInvalidateMaxDof_Internal(rootSectionAdj));
@@ -2590,6 +2590,8 @@ PetscErrorCode PetscSectionCreateGlobalSectionLabel(PetscSection s, PetscSF sf,
   PetscCall(PetscSectionCreate(PetscObjectComm((PetscObject)s), gsection));
   PetscCall(PetscSectionGetChart(s, &pStart, &pEnd));
   PetscCall(PetscSectionSetChart(*gsection, pStart, pEnd));
+  /* The ghost dof and the offsets are set directly in the per-point arrays */
+  PetscCall(PetscSectionMaterialize_Internal(*gsection));
   PetscCall(PetscSFGetGraph(sf, &nroots, NULL, NULL, NULL));
   if (nroots >= 0) {
     PetscCheck(nroots >= pEnd - pStart, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "PetscSF nroots %" PetscInt_FMT " < %" PetscInt_FMT " section size", nroots, pEnd - pStart);
@@ -2624,7 +2626,7 @@ PetscErrorCode PetscSectionCreateGlobalSectionLabel(PetscSection s, PetscSF sf,
   }
   /* Calculate new sizes, get process offset, and calculate point offsets */
   for (p = 0, off = 0; p < pEnd - pStart; ++p) {
-    cdof                     = (!includeConstraints && s->bc) ? s->bc->atlasDof[p] : 0;
+    cdof                     = (!includeConstraints && s->bc) ? PetscSectionGetDof_Private(s->bc, p) : 0;
     (*gsection)->atlasOff[p] = off;
     off += (*gsection)->atlasDof[p] > 0 ? (*gsection)->atlasDof[p] - cdof : 0;
   }
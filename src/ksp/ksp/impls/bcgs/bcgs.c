@@ -21,6 +21,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
   PetscScalar rho, rhoold, alpha, beta, omega, omegaold, d1;
   Vec         X, B, V, P, R, RP, T, S;
   PetscReal   dp   = 0.0, d2;
+  PetscBool   lag  = PETSC_FALSE;
   KSP_BCGS   *bcgs = (KSP_BCGS *)ksp->data;
 
   PetscFunctionBegin;
@@ -71,7 +72,29 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
   i = 0;
   do {
-    PetscCall(VecDot(R, RP, &rho)); /*   rho <- (r,rp)      */
+    if (lag) {
+      /* the residual norm of the previous iteration shares its reduction with rho */
+      PetscCall(VecDotBegin(R, RP, &rho));
+      PetscCall(VecNormBegin(R, NORM_2, &dp));
+      PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R)));
+      PetscCall(VecDotEnd(R, RP, &rho));
+      PetscCall(VecNormEnd(R, NORM_2, &dp));
+      KSPCheckNorm(ksp, dp);
+      lag = PETSC_FALSE;
+      PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+      ksp->rnorm = dp;
+      PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+      PetscCall(KSPLogResidualHistory(ksp, dp));
+      PetscCall(KSPMonitor(ksp, i, dp));
+      PetscCall((*ksp->converged)(ksp, i, dp, &ksp->reason, ksp->cnvP));
+      if (ksp->reason) break;
+      if (rhoold == 0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "KSPSolve breakdown due to zero inner product");
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        PetscCall(PetscInfo(ksp, "Breakdown due to zero rho inner product\n"));
+        break;
+      }
+    } else PetscCall(VecDot(R, RP, &rho)); /*   rho <- (r,rp)      */
     beta = (rho / rhoold) * (alpha / omegaold);
     PetscCall(VecAXPBYPCZ(P, 1.0, -omegaold * beta, beta, R, V)); /* p <- r - omega * beta* v + beta * p */
     PetscCall(KSP_PCApplyBAorAB(ksp, P, V, T));                   /*   v <- K p           */
@@ -110,14 +133,22 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     omega = d1 / d2;                                    /*   w <- (t's) / (t't) */
     PetscCall(VecAXPBYPCZ(X, alpha, omega, 1.0, P, S)); /* x <- alpha * p + omega * s + x */
     PetscCall(VecWAXPY(R, -omega, T, S));               /*   r <- s - w t       */
+    rhoold   = rho;
+    omegaold = omega;
     if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i + 2) {
+      if (ksp->lagnorm) {
+        /* postpone the convergence test to the start of the next iteration */
+        PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+        ksp->its++;
+        PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+        lag = PETSC_TRUE;
+        i++;
+        continue;
+      }
       PetscCall(VecNorm(R, NORM_2, &dp));
       KSPCheckNorm(ksp, dp);
     }
 
-    rhoold   = rho;
-    omegaold = omega;
-
     PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
     ksp->its++;
     ksp->rnorm = dp;
@@ -134,8 +165,18 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     }
     i++;
   } while (i < ksp->max_it);
+  if (lag) {
+    PetscCall(VecNorm(R, NORM_2, &dp));
+    KSPCheckNorm(ksp, dp);
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->rnorm = dp;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+    PetscCall(KSPLogResidualHistory(ksp, dp));
+    PetscCall(KSPMonitor(ksp, i, dp));
+    PetscCall((*ksp->converged)(ksp, i, dp, &ksp->reason, ksp->cnvP));
+  }
 
-  if (i >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (i >= ksp->max_it && !ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
 
   PetscCall(KSPUnwindPreconditioner(ksp, X, T));
   if (bcgs->guess) PetscCall(VecAXPY(X, 1.0, bcgs->guess));
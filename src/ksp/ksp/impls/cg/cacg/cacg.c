@@ -0,0 +1,384 @@
+/*
+    This file implements the communication-avoiding (s-step) preconditioned conjugate gradient method, see
+    Chronopoulos and Gear 1989 and Hoemmen 2010.
+
+    A block of s iterations starts from the search direction p and the preconditioned residual z and computes, with 2s-1
+    applications of A and of the preconditioner B and no global reduction, the bases
+
+       Y  = [P, Z] = [p_0, ..., p_s, z_0, ..., z_{s-1}]        of K_{s+1}(B A, p) and K_s(B A, z)
+       Yh = B^{-1} Y                                           with Yh_{j+1} = (A Y_j - a_j Yh_j - b_j Yh_{j-1}) / c_j
+
+    followed by a single global reduction for the Gram matrix G = Yh^H Y. The s iterations of CG are then performed on the
+    coordinates of the vectors in these bases: B A Y[:, j] = Y B[:, j] and, for instance, r^H z = r'^H G r' and p^H A p = p'^H G B p'.
+*/
+#include <petsc/private/kspcaimpl.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  KSP_CA       ca;
+  Vec         *Y, *Yh;             /* bases of B A and A B, 2s+1 vectors each */
+  PetscScalar *G, *Gn, *Bc;        /* Gram matrix Yh^H Y, Gram matrix for the norm, change of basis, (2s+1)^2 each */
+  PetscScalar *xc, *rc, *pc, *wc;  /* coordinates of the update of x, of r (and z), of p and of A p (and B A p) */
+  PetscReal   *d, *e;              /* Lanczos tridiagonal matrix of the first iterations */
+} KSP_CACG;
+
+static PetscErrorCode KSPCAGetContext_CACG(KSP ksp, KSP_CA **ca)
+{
+  KSP_CACG *cg = (KSP_CACG *)ksp->data;
+
+  PetscFunctionBegin;
+  *ca = &cg->ca;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetUp_CACG(KSP ksp)
+{
+  KSP_CACG      *cg = (KSP_CACG *)ksp->data;
+  const PetscInt s = cg->ca.s, n = 2 * s + 1;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCASetUp_Private(ksp, &cg->ca));
+  PetscCall(KSPSetWorkVecs(ksp, 4));
+  PetscCall(VecDuplicateVecs(ksp->work[0], n, &cg->Y));
+  PetscCall(VecDuplicateVecs(ksp->work[0], n, &cg->Yh));
+  PetscCall(PetscMalloc7(n * n, &cg->G, n * n, &cg->Gn, n * n, &cg->Bc, n, &cg->xc, n, &cg->rc, n, &cg->pc, n, &cg->wc));
+  PetscCall(PetscMalloc2(s, &cg->d, s, &cg->e));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_CACG(KSP ksp)
+{
+  KSP_CACG      *cg = (KSP_CACG *)ksp->data;
+  const PetscInt n  = 2 * cg->ca.s + 1;
+
+  PetscFunctionBegin;
+  if (cg->Y) PetscCall(VecDestroyVecs(n, &cg->Y));
+  if (cg->Yh) PetscCall(VecDestroyVecs(n, &cg->Yh));
+  PetscCall(PetscFree7(cg->G, cg->Gn, cg->Bc, cg->xc, cg->rc, cg->pc, cg->wc));
+  PetscCall(PetscFree2(cg->d, cg->e));
+  PetscCall(KSPCAReset_Private(&cg->ca));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_CACG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_CACG(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCAGetContext_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_CACG(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_CACG *cg = (KSP_CACG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCASetFromOptions_Private(ksp, &cg->ca, PetscOptionsObject));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_CACG(KSP ksp, PetscViewer viewer)
+{
+  KSP_CACG *cg = (KSP_CACG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCAView_Private(&cg->ca, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* val = x^H G y */
+static inline PetscScalar KSPCACGInner(PetscInt n, const PetscScalar G[], const PetscScalar x[], const PetscScalar y[])
+{
+  PetscScalar val = 0.0;
+
+  for (PetscInt j = 0; j < n; j++) {
+    PetscScalar Gy = 0.0;
+
+    if (y[j] == 0.0) continue;
+    for (PetscInt i = 0; i < n; i++) Gy += PetscConj(x[i]) * G[i + j * n];
+    val += Gy * y[j];
+  }
+  return val;
+}
+
+static PetscErrorCode KSPCACGNorm(KSP ksp, Vec R, Vec Z, PetscScalar *rz, PetscReal *dp)
+{
+  PetscFunctionBegin;
+  PetscCall(VecDotBegin(R, Z, rz));
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecNormBegin(Z, NORM_2, dp));
+  else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecNormBegin(R, NORM_2, dp));
+  PetscCall(VecDotEnd(R, Z, rz));
+  KSPCheckDot(ksp, *rz);
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecNormEnd(Z, NORM_2, dp));
+  else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecNormEnd(R, NORM_2, dp));
+  else if (ksp->normtype == KSP_NORM_NATURAL) *dp = PetscSqrtReal(PetscAbsScalar(*rz));
+  else *dp = 0.0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCACGConverged(KSP ksp, PetscReal dp)
+{
+  PetscFunctionBegin;
+  KSPCheckNorm(ksp, dp);
+  ksp->rnorm = dp;
+  PetscCall(KSPLogResidualHistory(ksp, dp));
+  PetscCall(KSPMonitor(ksp, ksp->its, dp));
+  PetscCall((*ksp->converged)(ksp, ksp->its, dp, &ksp->reason, ksp->cnvP));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Performs the first s iterations with the standard method and computes the Ritz values from the Lanczos tridiagonal matrix,
+   the shifts of the basis of the following blocks
+*/
+static PetscErrorCode KSPCACGStandardIterations(KSP ksp, Mat Amat)
+{
+  KSP_CACG      *cg = (KSP_CACG *)ksp->data;
+  const PetscInt s  = cg->ca.s;
+  Vec            X = ksp->vec_sol, P = cg->Y[0], Ph = cg->Yh[0], Z = cg->Y[s + 1], R = cg->Yh[s + 1], W = ksp->work[0];
+  PetscScalar    rz, rzold, pAp, alpha, alphaold = 1.0, beta = 0.0;
+  PetscReal      dp;
+  PetscInt       k;
+  PetscBLASInt   bn, ldz = 1;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCACGNorm(ksp, R, Z, &rz, &dp));
+  PetscCall(KSPCACGConverged(ksp, dp));
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+  for (k = 0; k < s && ksp->its < ksp->max_it; k++) {
+    PetscCall(KSP_MatMult(ksp, Amat, P, W)); /*     w <- Ap                          */
+    PetscCall(VecDot(P, W, &pAp));           /*     pAp <- p'w                       */
+    KSPCheckDot(ksp, pAp);
+    if (pAp == 0.0 || PetscRealPart(pAp) < 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite matrix, p'Ap %g", (double)PetscRealPart(pAp));
+      ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    alpha = rz / pAp;
+    PetscCall(VecAXPY(X, alpha, P));  /*     x <- x + alpha p                 */
+    PetscCall(VecAXPY(R, -alpha, W)); /*     r <- r - alpha w                 */
+    PetscCall(KSP_PCApply(ksp, R, Z)); /*     z <- Br                          */
+    rzold = rz;
+    PetscCall(KSPCACGNorm(ksp, R, Z, &rz, &dp));
+    ksp->its++;
+    PetscCall(KSPCACGConverged(ksp, dp));
+    if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+    if (PetscRealPart(rz) < 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite preconditioner, r'z %g", (double)PetscRealPart(rz));
+      ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    cg->d[k] = PetscRealPart(1.0 / alpha + beta / alphaold);
+    beta     = rz / rzold;
+    cg->e[k] = PetscSqrtReal(PetscAbsScalar(beta)) / PetscRealPart(alpha);
+    alphaold = alpha;
+    PetscCall(VecAYPX(P, beta, Z));  /*     p <- z + beta p                  */
+    PetscCall(VecAYPX(Ph, beta, R)); /*     B^{-1} p <- r + beta B^{-1} p    */
+  }
+
+  /* the Ritz values are the eigenvalues of the Lanczos tridiagonal matrix */
+  PetscCall(PetscBLASIntCast(k, &bn));
+  if (bn) {
+    PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+    PetscCallLAPACKInfo("LAPACKREALstev", LAPACKREALstev_("N", &bn, cg->d, cg->e, NULL, &ldz, NULL, &info));
+    PetscCall(PetscFPTrapPop());
+  }
+  PetscCall(KSPCASetRitzValues_Private(ksp, &cg->ca, k, cg->d, NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_CACG(KSP ksp)
+{
+  KSP_CACG      *cg = (KSP_CACG *)ksp->data;
+  KSP_CA        *ca = &cg->ca;
+  const PetscInt s = ca->s, n = 2 * s + 1;
+  Vec            X = ksp->vec_sol, B = ksp->vec_rhs, P = cg->Y[0], Ph = cg->Yh[0], Z = cg->Y[s + 1], R = cg->Yh[s + 1];
+  Vec           *T = ksp->work;
+  PetscScalar   *G = cg->G, *Gn = cg->Gn, *xc = cg->xc, *rc = cg->rc, *pc = cg->pc, *wc = cg->wc;
+  PetscScalar    rz, rzold, pAp, alpha, beta;
+  PetscReal      dp = 0.0;
+  Mat            Amat;
+  MPI_Comm       comm;
+  PetscBool      diagonalscale, needritz;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+  PetscCall(PetscObjectGetComm((PetscObject)X, &comm));
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, Amat, X, R)); /*     r <- b - Ax                       */
+    PetscCall(VecAYPX(R, -1.0, B));
+  } else {
+    PetscCall(VecCopy(B, R)); /*     r <- b (x is 0)                   */
+  }
+  PetscCall(KSP_PCApply(ksp, R, Z)); /*     z <- Br                           */
+  PetscCall(VecCopy(Z, P));
+  PetscCall(VecCopy(R, Ph));
+
+  PetscCall(KSPCASetUpShifts_Private(ksp, ca, &needritz));
+  if (needritz) {
+    PetscCall(KSPCACGStandardIterations(ksp, Amat));
+    if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscArrayzero(cg->Bc, n * n));
+  PetscCall(KSPCAChangeOfBasis_Private(ca, s, n, cg->Bc));
+  PetscCall(KSPCAChangeOfBasis_Private(ca, s - 1, n, cg->Bc + (s + 1) * (n + 1)));
+
+  while (!ksp->reason && ksp->its < ksp->max_it) {
+    /* bases of the block and their Gram matrices with a single reduction */
+    PetscCall(KSPCAComputeBasis_Private(ksp, ca, s, cg->Y, cg->Yh, NULL));
+    PetscCall(KSPCAComputeBasis_Private(ksp, ca, s - 1, cg->Y + s + 1, cg->Yh + s + 1, NULL));
+    for (PetscInt j = 0; j < n; j++) {
+      PetscCall(VecMDotBegin(cg->Y[j], j + 1, cg->Yh, G + j * n));
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecMDotBegin(cg->Y[j], j + 1, cg->Y, Gn + j * n));
+      else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecMDotBegin(cg->Yh[j], j + 1, cg->Yh, Gn + j * n));
+    }
+    PetscCall(PetscCommSplitReductionBegin(comm));
+    for (PetscInt j = 0; j < n; j++) {
+      PetscCall(VecMDotEnd(cg->Y[j], j + 1, cg->Yh, G + j * n));
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecMDotEnd(cg->Y[j], j + 1, cg->Y, Gn + j * n));
+      else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecMDotEnd(cg->Yh[j], j + 1, cg->Yh, Gn + j * n));
+    }
+    for (PetscInt j = 0; j < n; j++) {
+      for (PetscInt i = 0; i < j; i++) G[j + i * n] = PetscConj(G[i + j * n]);
+      if (ksp->normtype != KSP_NORM_PRECONDITIONED && ksp->normtype != KSP_NORM_UNPRECONDITIONED) continue;
+      for (PetscInt i = 0; i < j; i++) Gn[j + i * n] = PetscConj(Gn[i + j * n]);
+    }
+
+    /* s iterations on the coordinates, p = Y e_0, z = Y e_{s+1} and r = Yh e_{s+1} */
+    PetscCall(PetscArrayzero(xc, n));
+    PetscCall(PetscArrayzero(rc, n));
+    PetscCall(PetscArrayzero(pc, n));
+    pc[0]     = 1.0;
+    rc[s + 1] = 1.0;
+    rz        = G[(s + 1) * (n + 1)];
+    KSPCheckDot(ksp, rz);
+    if (!ksp->its) {
+      if (ksp->normtype == KSP_NORM_NATURAL) dp = PetscSqrtReal(PetscAbsScalar(rz));
+      else if (ksp->normtype != KSP_NORM_NONE) dp = PetscSqrtReal(PetscAbsScalar(Gn[(s + 1) * (n + 1)]));
+      PetscCall(KSPCACGConverged(ksp, dp));
+      if (ksp->reason) break;
+    }
+    if (rz == 0.0) {
+      ksp->reason = KSP_CONVERGED_ATOL;
+      PetscCall(PetscInfo(ksp, "converged due to r'z = 0\n"));
+      break;
+    } else if (PetscRealPart(rz) < 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite preconditioner, r'z %g", (double)PetscRealPart(rz));
+      ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+      PetscCall(PetscInfo(ksp, "diverging due to indefinite preconditioner\n"));
+      break;
+    }
+    for (PetscInt j = 0; j < s && ksp->its < ksp->max_it; j++) {
+      for (PetscInt i = 0; i < n; i++) {
+        wc[i] = 0.0;
+        for (PetscInt k = 0; k < n; k++) wc[i] += cg->Bc[i + k * n] * pc[k]; /*     w <- B A p, A p = Yh w          */
+      }
+      pAp = KSPCACGInner(n, G, pc, wc);
+      if (pAp == 0.0 || PetscRealPart(pAp) < 0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite matrix, p'Ap %g", (double)PetscRealPart(pAp));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        PetscCall(PetscInfo(ksp, "diverging due to indefinite matrix\n"));
+        break;
+      }
+      alpha = rz / pAp;
+      for (PetscInt i = 0; i < n; i++) {
+        xc[i] += alpha * pc[i]; /*     x <- x + alpha p                 */
+        rc[i] -= alpha * wc[i]; /*     r <- r - alpha A p               */
+      }
+      rzold = rz;
+      rz    = KSPCACGInner(n, G, rc, rc);
+      ksp->its++;
+      if (ksp->normtype == KSP_NORM_NATURAL) dp = PetscSqrtReal(PetscAbsScalar(rz));
+      else if (ksp->normtype != KSP_NORM_NONE) dp = PetscSqrtReal(PetscAbsScalar(KSPCACGInner(n, Gn, rc, rc)));
+      PetscCall(KSPCACGConverged(ksp, dp));
+      if (ksp->reason) break;
+      if (PetscRealPart(rz) < 0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite preconditioner, r'z %g", (double)PetscRealPart(rz));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+        PetscCall(PetscInfo(ksp, "diverging due to indefinite preconditioner\n"));
+        break;
+      }
+      beta = rz / rzold;
+      for (PetscInt i = 0; i < n; i++) pc[i] = rc[i] + beta * pc[i]; /*     p <- z + beta p                  */
+    }
+
+    /* back to the vectors */
+    PetscCall(VecMAXPY(X, n, xc, cg->Y));
+    if (ksp->reason) break;
+    PetscCall(VecMAXPBY(T[0], n, rc, 0.0, cg->Y));
+    PetscCall(VecMAXPBY(T[1], n, rc, 0.0, cg->Yh));
+    PetscCall(VecMAXPBY(T[2], n, pc, 0.0, cg->Y));
+    PetscCall(VecMAXPBY(T[3], n, pc, 0.0, cg->Yh));
+    PetscCall(VecCopy(T[0], Z));
+    PetscCall(VecCopy(T[1], R));
+    PetscCall(VecCopy(T[2], P));
+    PetscCall(VecCopy(T[3], Ph));
+  }
+  if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPCACG - The communication-avoiding, or s-step, preconditioned conjugate gradient method {cite}`chronopoulos_gear_1989`, {cite}`mohiyuddin2009minimizing`
+
+   Options Database Keys:
++  -ksp_ca_s s                                      - number of iterations per global reduction, see `KSPCASetStepSize()`
+.  -ksp_ca_basis_type (monomial|newton|chebyshev)   - polynomial basis of a block, see `KSPCASetBasisType()`
+.  -ksp_ca_eigenvalues emin,emax                    - bounds of the spectrum used to build the basis, see `KSPCASetEigenvalues()`
+-  -ksp_ca_matrix_powers (true|false)               - use the matrix powers kernel, see `KSPCASetUseMatrixPowers()`
+
+   Level: intermediate
+
+   Notes:
+   Each block of `s` iterations applies the matrix and the preconditioner `2s-1` times to build a basis of the Krylov subspaces
+   of the residual and of the search direction, then computes all the inner products of the block with a single global reduction
+   of the Gram matrix of this basis. The `s` iterations are then performed on the coordinates of the vectors in the basis, with
+   no further communication. `KSPCG` needs `2s` global reductions for the same iterations, which limits its scalability when the
+   latency of `MPI_Allreduce()` dominates.
+
+   The default basis is the Newton basis whose shifts are the Leja-ordered Ritz values of the preconditioned operator. These
+   are computed by the first `s` iterations of the first solve, which are performed with the standard method. The monomial
+   basis is only stable for small values of `s`.
+
+   The residual computed by the recurrences of the method may deviate more from the true residual than with `KSPCG`, in
+   particular for large values of `s`.
+
+   The natural norm is used by default since it does not require any additional reduction, the preconditioned and
+   unpreconditioned norms double the size of the reduction of a block.
+
+   The preconditioner must be linear and symmetric positive definite, only left preconditioning is supported.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPCG`, `KSPCAGMRES`, `KSPPIPECG`, `KSPPIPELCG`, `KSPCASetStepSize()`,
+          `KSPCASetBasisType()`, `KSPCASetEigenvalues()`, `KSPCASetUseMatrixPowers()`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_CACG(KSP ksp)
+{
+  KSP_CACG *cg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&cg));
+  PetscCall(KSPCAInitialize_Private(&cg->ca));
+  ksp->data = (void *)cg;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NATURAL, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_CACG;
+  ksp->ops->solve          = KSPSolve_CACG;
+  ksp->ops->reset          = KSPReset_CACG;
+  ksp->ops->destroy        = KSPDestroy_CACG;
+  ksp->ops->view           = KSPView_CACG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_CACG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCAGetContext_C", KSPCAGetContext_CACG));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -120,12 +120,13 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
 {
   PetscInt    i, stored_max_it, eigs;
   PetscScalar dpi = 0.0, a = 1.0, beta, betaold = 1.0, b = 0, *e = NULL, *d = NULL, dpiold;
-  PetscReal   dp = 0.0;
+  PetscScalar rw = 0.0;
+  PetscReal   dp = 0.0, rr = 0.0, ww = 0.0;
   PetscReal   r2, norm_p, norm_d, dMp;
   Vec         X, B, Z, R, P, W;
   KSP_CG     *cg;
   Mat         Amat, Pmat;
-  PetscBool   diagonalscale, testobj;
+  PetscBool   diagonalscale, testobj, fused = PETSC_FALSE, fusednorm = PETSC_FALSE;
 
   PetscFunctionBegin;
   PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
@@ -255,7 +256,22 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     }
     dpiold = dpi;
     PetscCall(KSP_MatMult(ksp, Amat, P, W)); /*     w <- Ap                          */
-    PetscCall(VecXDot(P, W, &dpi));          /*     dpi <- p'w                       */
+    fusednorm = (PetscBool)(ksp->lagnorm && ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i + 2 && !cg->radius);
+    if (fusednorm) {
+      /* compute the terms of the norm of the next residual r - a w in the same reduction as dpi, so that the convergence test does
+         not need the preconditioner */
+      if (cg->type == KSP_CG_HERMITIAN) PetscCall(VecDotBegin(P, W, &dpi));
+      else PetscCall(VecTDotBegin(P, W, &dpi));
+      PetscCall(VecNormBegin(R, NORM_2, &rr));
+      PetscCall(VecDotBegin(W, R, &rw));
+      PetscCall(VecNormBegin(W, NORM_2, &ww));
+      PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R)));
+      if (cg->type == KSP_CG_HERMITIAN) PetscCall(VecDotEnd(P, W, &dpi));
+      else PetscCall(VecTDotEnd(P, W, &dpi));
+      PetscCall(VecNormEnd(R, NORM_2, &rr));
+      PetscCall(VecDotEnd(W, R, &rw));
+      PetscCall(VecNormEnd(W, NORM_2, &ww));
+    } else PetscCall(VecXDot(P, W, &dpi)); /*     dpi <- p'w                       */
     KSPCheckDot(ksp, dpi);
     betaold = beta;
 
@@ -304,7 +320,27 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     }
     PetscCall(VecAXPY(X, a, P));  /*     x <- x + ap                      */
     PetscCall(VecAXPY(R, -a, W)); /*     r <- r - aw                      */
-    if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i + 2) {
+    fused = (PetscBool)(ksp->lagnorm && ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i + 2);
+    if (fusednorm) {
+      /* |r - a w|^2 = |r|^2 - 2 Re(a w'r) + |a|^2 |w|^2, computed again with VecNorm() if the cancellation is too large */
+      PetscReal dp2 = rr * rr - 2.0 * PetscRealPart(a * rw) + PetscRealPart(a * PetscConj(a)) * ww * ww;
+
+      if (dp2 > 1.e4 * PETSC_MACHINE_EPSILON * rr * rr) dp = PetscSqrtReal(dp2);
+      else PetscCall(VecNorm(R, NORM_2, &dp));
+      KSPCheckNorm(ksp, dp);
+    } else if (fused) {
+      /* compute beta for the next iteration in the same reduction as the residual norm */
+      PetscCall(KSP_PCApply(ksp, R, Z)); /*     z <- Br                          */
+      PetscCall(VecNormBegin(Z, NORM_2, &dp));
+      if (cg->type == KSP_CG_HERMITIAN) PetscCall(VecDotBegin(Z, R, &beta));
+      else PetscCall(VecTDotBegin(Z, R, &beta));
+      PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R)));
+      PetscCall(VecNormEnd(Z, NORM_2, &dp));
+      if (cg->type == KSP_CG_HERMITIAN) PetscCall(VecDotEnd(Z, R, &beta));
+      else PetscCall(VecTDotEnd(Z, R, &beta));
+      KSPCheckNorm(ksp, dp);
+      KSPCheckDot(ksp, beta);
+    } else if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i + 2) {
       PetscCall(KSP_PCApply(ksp, R, Z));  /*     z <- Br                          */
       PetscCall(VecNorm(Z, NORM_2, &dp)); /*     dp <- z'*z                       */
       KSPCheckNorm(ksp, dp);
@@ -339,10 +375,12 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
       norm_d *= norm_d;
     }
 
-    if ((ksp->normtype != KSP_NORM_PRECONDITIONED && ksp->normtype != KSP_NORM_NATURAL) || ksp->chknorm >= i + 2) PetscCall(KSP_PCApply(ksp, R, Z)); /*     z <- Br                          */
-    if (ksp->normtype != KSP_NORM_NATURAL || ksp->chknorm >= i + 2) {
-      PetscCall(VecXDot(Z, R, &beta)); /*     beta <- z'*r                     */
-      KSPCheckDot(ksp, beta);
+    if (!fused) {
+      if ((ksp->normtype != KSP_NORM_PRECONDITIONED && ksp->normtype != KSP_NORM_NATURAL) || ksp->chknorm >= i + 2) PetscCall(KSP_PCApply(ksp, R, Z)); /*     z <- Br                          */
+      if (ksp->normtype != KSP_NORM_NATURAL || ksp->chknorm >= i + 2) {
+        PetscCall(VecXDot(Z, R, &beta)); /*     beta <- z'*r                     */
+        KSPCheckDot(ksp, beta);
+      }
     }
 
     i++;
@@ -551,6 +589,8 @@ PetscErrorCode KSPDestroy_CG(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGSetType_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGUseSingleReduction_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGGetObjFcn_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGSetMatSolveType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGGetMatSolveType_C", NULL));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -569,6 +609,7 @@ PetscErrorCode KSPView_CG(KSP ksp, PetscViewer viewer)
   if (isascii) {
     if (PetscDefined(USE_COMPLEX)) PetscCall(PetscViewerASCIIPrintf(viewer, "  variant %s\n", KSPCGTypes[cg->type]));
     if (cg->singlereduction) PetscCall(PetscViewerASCIIPrintf(viewer, "  using single-reduction variant\n"));
+    if (cg->matsolvetype != KSP_MATSOLVE_COLUMN) PetscCall(PetscViewerASCIIPrintf(viewer, "  KSPMatSolve() algorithm %s\n", KSPMatSolveTypes[cg->matsolvetype]));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -579,14 +620,22 @@ PetscErrorCode KSPView_CG(KSP ksp, PetscViewer viewer)
 */
 PetscErrorCode KSPSetFromOptions_CG(KSP ksp, PetscOptionItems PetscOptionsObject)
 {
-  KSP_CG   *cg = (KSP_CG *)ksp->data;
-  PetscBool flg;
+  KSP_CG         *cg = (KSP_CG *)ksp->data;
+  KSPMatSolveType type;
+  PetscBool       flg;
+  PetscErrorCode (*f)(KSP, KSPMatSolveType);
 
   PetscFunctionBegin;
   PetscOptionsHeadBegin(PetscOptionsObject, "KSP CG and CGNE options");
   if (PetscDefined(USE_COMPLEX)) PetscCall(PetscOptionsEnum("-ksp_cg_type", "Matrix is Hermitian or complex symmetric", "KSPCGSetType", KSPCGTypes, (PetscEnum)cg->type, (PetscEnum *)&cg->type, NULL));
   PetscCall(PetscOptionsBool("-ksp_cg_single_reduction", "Merge inner products into single MPI_Allreduce()", "KSPCGUseSingleReduction", cg->singlereduction, &cg->singlereduction, &flg));
   if (flg) PetscCall(KSPCGUseSingleReduction(ksp, cg->singlereduction));
+  /* KSPCGNE shares these options but does not implement KSPMatSolve() */
+  PetscCall(PetscObjectQueryFunction((PetscObject)ksp, "KSPCGSetMatSolveType_C", &f));
+  if (f) {
+    PetscCall(PetscOptionsEnum("-ksp_cg_matsolve_type", "Algorithm used by KSPMatSolve()", "KSPCGSetMatSolveType", KSPMatSolveTypes, (PetscEnum)cg->matsolvetype, (PetscEnum *)&type, &flg));
+    if (flg) PetscCall(KSPCGSetMatSolveType(ksp, type));
+  }
   PetscOptionsHeadEnd();
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -628,6 +677,29 @@ static PetscErrorCode KSPCGUseSingleReduction_CG(KSP ksp, PetscBool flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+    KSPCGSetMatSolveType_CG - like KSPCGUseSingleReduction_CG(), it swaps out the routine called when
+    KSPMatSolve() is invoked, KSPMatSolve() falls back to one KSPSolve() per column when there is none.
+*/
+static PetscErrorCode KSPCGSetMatSolveType_CG(KSP ksp, KSPMatSolveType type)
+{
+  KSP_CG *cg = (KSP_CG *)ksp->data;
+
+  PetscFunctionBegin;
+  cg->matsolvetype   = type;
+  ksp->ops->matsolve = type == KSP_MATSOLVE_COLUMN ? NULL : KSPMatSolve_CG;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCGGetMatSolveType_CG(KSP ksp, KSPMatSolveType *type)
+{
+  KSP_CG *cg = (KSP_CG *)ksp->data;
+
+  PetscFunctionBegin;
+  *type = cg->matsolvetype;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp, Vec t, Vec v, Vec *V)
 {
   PetscFunctionBegin;
@@ -641,7 +713,8 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp, Vec t, Vec v, Vec *V)
 
    Options Database Keys:
 +   -ksp_cg_type (hermitian|symmetric) - (for complex matrices only) indicates the matrix is Hermitian or symmetric, see `KSPCGSetType()`
--   -ksp_cg_single_reduction           - performs both inner products needed in the algorithm with a single `MPI_Allreduce()` call, see `KSPCGUseSingleReduction()`
+.   -ksp_cg_single_reduction           - performs both inner products needed in the algorithm with a single `MPI_Allreduce()` call, see `KSPCGUseSingleReduction()`
+-   -ksp_cg_matsolve_type (column|pseudoblock|block) - algorithm used by `KSPMatSolve()` with several right-hand sides, see `KSPCGSetMatSolveType()`
 
    Level: beginner
 
@@ -665,6 +738,9 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp, Vec t, Vec v, Vec *V)
 
    One can use `KSPSetComputeEigenvalues()` and `KSPComputeEigenvalues()` to compute the eigenvalues of the (preconditioned) operator
 
+   `KSPMatSolve()` can run the iterations of several right-hand sides together, either independently or as a block conjugate gradient
+   method, see `KSPCGSetMatSolveType()`
+
    There are two pipelined implementations of CG in PETSc `KSPPIPECG` and `KSPGROPPCG`. These may perform better for very large
    numbers of MPI processes since they overlap communication and computation so the reduction operations in CG, that is inner products and norms,
    do not dominate the compute time.
@@ -674,7 +750,7 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp, Vec t, Vec v, Vec *V)
    indicate it to the `KSP` object.
 
 .seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPSetComputeEigenvalues()`, `KSPComputeEigenvalues()`,
-          `KSPCGSetType()`, `KSPCGUseSingleReduction()`, `KSPPIPECG`, `KSPGROPPCG`
+          `KSPCGSetType()`, `KSPCGUseSingleReduction()`, `KSPCGSetMatSolveType()`, `KSPPIPECG`, `KSPGROPPCG`
 M*/
 
 /*
@@ -720,5 +796,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGSetRadius_C", KSPCGSetRadius_CG));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGSetObjectiveTarget_C", KSPCGSetObjectiveTarget_CG));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGGetObjFcn_C", KSPCGGetObjFcn_CG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGSetMatSolveType_C", KSPCGSetMatSolveType_CG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCGGetMatSolveType_C", KSPCGGetMatSolveType_CG));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
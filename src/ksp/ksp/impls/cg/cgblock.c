@@ -0,0 +1,203 @@
+/*
+    Pseudo-block and block conjugate gradient methods used by KSPMatSolve() with KSPCG, see KSPCGSetMatSolveType()
+*/
+#include <../src/ksp/ksp/impls/cg/cgimpl.h> /*I "petscksp.h" I*/
+#include <petsc/private/kspblockimpl.h>
+
+/* residual norms of the columns of the block, depending on the norm type, rz holds the inner products r_j^H z_j for KSP_NORM_NATURAL */
+static PetscErrorCode KSPCGBlockNorms(KSP ksp, Mat R, Mat Z, const PetscScalar rz[], PetscReal norms[])
+{
+  PetscInt n;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(R, NULL, &n));
+  switch (ksp->normtype) {
+  case KSP_NORM_PRECONDITIONED:
+    PetscCall(MatGetColumnNorms(Z, NORM_2, norms));
+    break;
+  case KSP_NORM_UNPRECONDITIONED:
+    PetscCall(MatGetColumnNorms(R, NORM_2, norms));
+    break;
+  case KSP_NORM_NATURAL:
+    for (PetscInt j = 0; j < n; j++) norms[j] = PetscSqrtReal(PetscAbsScalar(rz[j]));
+    break;
+  case KSP_NORM_NONE:
+    for (PetscInt j = 0; j < n; j++) norms[j] = 0.0;
+    break;
+  default:
+    SETERRQ(PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "%s", KSPNormTypes[ksp->normtype]);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCGBlockMonitor(KSP ksp, PetscInt it, PetscInt n, const PetscReal norms[], const PetscReal norms0[], PetscBool converged[])
+{
+  PetscFunctionBegin;
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = it;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPBlockConverged_Private(ksp, it, n, norms, norms0, converged, &ksp->reason));
+  PetscCall(KSPLogResidualHistory(ksp, ksp->rnorm));
+  PetscCall(KSPMonitor(ksp, it, ksp->rnorm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Independent conjugate gradient iterations on the columns, all the columns are iterated together so that the operator and the
+   preconditioner are applied once per iteration, and the inner products of all the columns need a single reduction. A column that
+   has converged is no longer updated.
+*/
+static PetscErrorCode KSPMatSolve_CG_PseudoBlock(KSP ksp, Mat A, Mat X, Mat R, Mat Z, PetscScalar rz[], PetscReal norms[], PetscReal norms0[], PetscBool converged[])
+{
+  Mat          P, Q = NULL;
+  Vec          p, z;
+  PetscInt     n;
+  PetscScalar *pq, *alpha, *rzold;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(R, NULL, &n));
+  PetscCall(PetscMalloc3(n, &pq, n, &alpha, n, &rzold));
+  PetscCall(MatDuplicate(Z, MAT_COPY_VALUES, &P)); /*   p <- z   */
+  for (PetscInt i = 0; i < ksp->max_it; i++) {
+    PetscCall(KSPBlockMatMult_Private(ksp, A, P, &Q)); /*   q <- Ap   */
+    PetscCall(KSPBlockColumnDot_Private(P, Q, pq));    /*   pq <- p'q */
+    for (PetscInt j = 0; j < n; j++) {
+      alpha[j] = 0.0;
+      if (converged[j]) continue;
+      if (pq[j] == (PetscScalar)0.0 || PetscRealPart(pq[j]) * PetscRealPart(rz[j]) < 0.0) {
+        PetscCall(PetscInfo(ksp, "Indefinite operator detected on column %" PetscInt_FMT " at iteration %" PetscInt_FMT "\n", j, i));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        break;
+      }
+      alpha[j] = rz[j] / pq[j]; /*   a <- z'r/p'q */
+    }
+    if (ksp->reason) break;
+    PetscCall(KSPBlockColumnMAXPY_Private(X, 1.0, P, alpha));  /*   x <- x + ap  */
+    PetscCall(KSPBlockColumnMAXPY_Private(R, -1.0, Q, alpha)); /*   r <- r - aq  */
+    PetscCall(KSP_PCMatApply(ksp, R, Z));                      /*   z <- Br      */
+    PetscCall(PetscArraycpy(rzold, rz, n));
+    PetscCall(KSPBlockColumnDot_Private(R, Z, rz)); /*   rz <- r'z   */
+    PetscCall(KSPCGBlockNorms(ksp, R, Z, rz, norms));
+    PetscCall(KSPCGBlockMonitor(ksp, i + 1, n, norms, norms0, converged));
+    if (ksp->reason) break;
+    for (PetscInt j = 0; j < n; j++) { /*   p <- z + b p, b <- rz/rzold */
+      PetscCall(MatDenseGetColumnVecRead(Z, j, &z));
+      PetscCall(MatDenseGetColumnVec(P, j, &p));
+      PetscCall(VecAYPX(p, converged[j] || rzold[j] == (PetscScalar)0.0 ? 0.0 : rz[j] / rzold[j], z));
+      PetscCall(MatDenseRestoreColumnVec(P, j, &p));
+      PetscCall(MatDenseRestoreColumnVecRead(Z, j, &z));
+    }
+  }
+  PetscCall(MatDestroy(&Q));
+  PetscCall(MatDestroy(&P));
+  PetscCall(PetscFree3(pq, alpha, rzold));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Breakdown-free block conjugate gradient method {cite}`ji2017breakdown`. The block of search directions P is made A-orthonormal
+   at each iteration, so the step is alpha = P^H R, and the directions that are (nearly) linearly dependent are dropped, so the
+   number r of columns of P may be smaller than the number of right-hand sides. The new block of directions only needs to be made
+   A-orthogonal to the previous one.
+*/
+static PetscErrorCode KSPMatSolve_CG_Block(KSP ksp, Mat A, Mat B, Mat X, Mat R, Mat Z, PetscScalar rz[], PetscReal norms[], PetscReal norms0[], PetscBool converged[])
+{
+  Mat          W, AW = NULL, P, Q, Pr, Qr;
+  PetscInt     n, r = 0;
+  PetscScalar *G, *T, *C;
+  PetscReal   *d;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(R, NULL, &n));
+  PetscCall(PetscMalloc4(n * n, &G, n * n, &T, n * n, &C, n, &d));
+  PetscCall(MatDuplicate(Z, MAT_COPY_VALUES, &W)); /*   w <- z   */
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &P));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &Q));
+  for (PetscInt i = 0; i < ksp->max_it; i++) {
+    if (r) { /*   w <- w - p (q'w)   */
+      PetscCall(MatDenseGetSubMatrix(P, PETSC_DECIDE, PETSC_DECIDE, 0, r, &Pr));
+      PetscCall(MatDenseGetSubMatrix(Q, PETSC_DECIDE, PETSC_DECIDE, 0, r, &Qr));
+      PetscCall(KSPBlockDot_Private(Qr, W, C));
+      PetscCall(KSPBlockGEMM_Private(1.0, W, -1.0, Pr, C, r));
+      PetscCall(MatDenseRestoreSubMatrix(Q, &Qr));
+      PetscCall(MatDenseRestoreSubMatrix(P, &Pr));
+    }
+    PetscCall(KSPBlockMatMult_Private(ksp, A, W, &AW)); /*   aw <- Aw   */
+    PetscCall(KSPBlockDot_Private(W, AW, G));           /*   G <- w'Aw  */
+    for (PetscInt j = 0; j < n; j++) { /* only the upper triangular part of G is used */
+      if (PetscRealPart(G[j + j * n]) < 0.0) {
+        PetscCall(PetscInfo(ksp, "Indefinite operator detected at iteration %" PetscInt_FMT "\n", i));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      }
+      d[j] = PetscRealPart(G[j + j * n]) > 0.0 ? 1.0 / PetscSqrtReal(PetscRealPart(G[j + j * n])) : 0.0;
+    }
+    if (ksp->reason) break;
+    /* the columns are scaled before looking for linearly dependent directions, so that a column is not dropped because it is small */
+    PetscCall(KSPBlockGramFactor_Private(n, G, d, PETSC_SQRT_MACHINE_EPSILON, 0.0, T, NULL, &r));
+    if (!r) {
+      PetscCall(PetscInfo(ksp, "Breakdown, no search direction left at iteration %" PetscInt_FMT "\n", i));
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    PetscCall(MatDenseGetSubMatrix(P, PETSC_DECIDE, PETSC_DECIDE, 0, r, &Pr));
+    PetscCall(MatDenseGetSubMatrix(Q, PETSC_DECIDE, PETSC_DECIDE, 0, r, &Qr));
+    PetscCall(KSPBlockGEMM_Private(0.0, Pr, 1.0, W, T, n));  /*   p <- w T, p'Ap = I  */
+    PetscCall(KSPBlockGEMM_Private(0.0, Qr, 1.0, AW, T, n)); /*   q <- Ap             */
+    PetscCall(KSPBlockDot_Private(Pr, R, C));                /*   a <- p'r            */
+    PetscCall(KSPBlockGEMM_Private(1.0, X, 1.0, Pr, C, r));  /*   x <- x + p a        */
+    PetscCall(KSPBlockGEMM_Private(1.0, R, -1.0, Qr, C, r)); /*   r <- r - q a        */
+    PetscCall(MatDenseRestoreSubMatrix(Q, &Qr));
+    PetscCall(MatDenseRestoreSubMatrix(P, &Pr));
+    PetscCall(KSP_PCMatApply(ksp, R, Z)); /*   z <- Br   */
+    if (ksp->normtype == KSP_NORM_NATURAL) PetscCall(KSPBlockColumnDot_Private(R, Z, rz));
+    PetscCall(KSPCGBlockNorms(ksp, R, Z, rz, norms));
+    PetscCall(KSPCGBlockMonitor(ksp, i + 1, n, norms, norms0, converged));
+    if (ksp->reason) break;
+    PetscCall(MatCopy(Z, W, SAME_NONZERO_PATTERN)); /*   w <- z   */
+  }
+  PetscCall(MatDestroy(&AW));
+  PetscCall(MatDestroy(&Q));
+  PetscCall(MatDestroy(&P));
+  PetscCall(MatDestroy(&W));
+  PetscCall(PetscFree4(G, T, C, d));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPMatSolve_CG(KSP ksp, Mat B, Mat X)
+{
+  KSP_CG      *cg = (KSP_CG *)ksp->data;
+  Mat          A, R, Z, AX = NULL;
+  PetscInt     n;
+  PetscScalar *rz;
+  PetscReal   *norms, *norms0;
+  PetscBool   *converged, diagonalscale;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+  PetscCheck(!PetscDefined(USE_COMPLEX) || cg->type == KSP_CG_HERMITIAN, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "KSPMatSolve() with %s %s is only for Hermitian matrices", ((PetscObject)ksp)->type_name, KSPMatSolveTypes[cg->matsolvetype]);
+  PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+  PetscCall(MatGetSize(B, NULL, &n));
+  PetscCall(PetscMalloc4(n, &rz, n, &norms, n, &norms0, n, &converged));
+  PetscCall(MatDuplicate(B, MAT_COPY_VALUES, &R));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &Z));
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  if (!ksp->guess_zero) { /*   r <- b - Ax   */
+    PetscCall(KSPBlockMatMult_Private(ksp, A, X, &AX));
+    PetscCall(MatAXPY(R, -1.0, AX, SAME_NONZERO_PATTERN));
+    PetscCall(MatDestroy(&AX));
+  }
+  PetscCall(KSP_PCMatApply(ksp, R, Z)); /*   z <- Br   */
+  PetscCall(KSPBlockColumnDot_Private(R, Z, rz));
+  PetscCall(KSPCGBlockNorms(ksp, R, Z, rz, norms0));
+  PetscCall(PetscArraycpy(norms, norms0, n));
+  PetscCall(KSPCGBlockMonitor(ksp, 0, n, norms, norms0, converged));
+  if (!ksp->reason) {
+    if (cg->matsolvetype == KSP_MATSOLVE_PSEUDOBLOCK) PetscCall(KSPMatSolve_CG_PseudoBlock(ksp, A, X, R, Z, rz, norms, norms0, converged));
+    else PetscCall(KSPMatSolve_CG_Block(ksp, A, B, X, R, Z, rz, norms, norms0, converged));
+  }
+  PetscCall(MatDestroy(&Z));
+  PetscCall(MatDestroy(&R));
+  PetscCall(PetscFree4(rz, norms, norms0, converged));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -17,6 +17,7 @@ PETSC_INTERN PetscErrorCode KSPDestroy_CG(KSP);
 PETSC_INTERN PetscErrorCode KSPView_CG(KSP, PetscViewer);
 PETSC_INTERN PetscErrorCode KSPSetFromOptions_CG(KSP, PetscOptionItems);
 PETSC_INTERN PetscErrorCode KSPCGSetType_CG(KSP, KSPCGType);
+PETSC_INTERN PetscErrorCode KSPMatSolve_CG(KSP, Mat, Mat);
 
 /*
     This struct is shared by several KSP implementations
@@ -35,4 +36,6 @@ typedef struct {
   PetscReal obj_min;
 
   PetscBool singlereduction; /* use variant of CG that combines both inner products */
+
+  KSPMatSolveType matsolvetype; /* algorithm used by KSPMatSolve() */
 } KSP_CG;
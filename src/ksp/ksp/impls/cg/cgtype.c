@@ -66,6 +66,76 @@ PetscErrorCode KSPCGUseSingleReduction(KSP ksp, PetscBool flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  KSPCGSetMatSolveType - Sets the algorithm used by `KSPMatSolve()` with `KSPCG`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp  - the iterative context
+- type - the algorithm, one of `KSP_MATSOLVE_COLUMN` (default), `KSP_MATSOLVE_PSEUDOBLOCK`, or `KSP_MATSOLVE_BLOCK`
+
+  Options Database Key:
+. -ksp_cg_matsolve_type (column|pseudoblock|block) - the algorithm used by `KSPMatSolve()`
+
+  Level: intermediate
+
+  Notes:
+  With `KSP_MATSOLVE_COLUMN`, each column of the block of right-hand sides is solved with its own `KSPSolve()`.
+
+  With `KSP_MATSOLVE_PSEUDOBLOCK`, the columns are solved with independent conjugate gradient iterations that are run together, so that
+  the operator and the preconditioner are applied to all the columns at once with `MatMatMult()` and `PCMatApply()`, and the inner
+  products of all the columns are computed with a single global reduction. Each column converges as if it were solved alone.
+
+  With `KSP_MATSOLVE_BLOCK`, the block conjugate gradient method {cite}`o1980block` is used, the columns share a single block
+  Krylov subspace, which usually reduces the number of iterations, in particular when the spectrum of the preconditioned operator has
+  isolated extreme eigenvalues. The search directions are made $A$-orthonormal at each iteration and the directions that are linearly
+  dependent are dropped {cite}`ji2017breakdown`, so the method does not break down when some of the columns converge before the others.
+
+  In both the pseudo-block and the block variants, the convergence test is applied to each column relative to its own initial residual
+  norm, the solve stops when all the columns have converged. The residual norm passed to the monitors is the largest residual norm
+  of the columns. The convergence test set with `KSPSetConvergenceTest()` is not used.
+
+  This has no effect on `KSPCGNE`.
+
+  `KSPSetMatSolveBatchSize()` can be used to limit the number of columns solved together.
+
+.seealso: [](ch_ksp), `KSP`, `KSPCG`, `KSPMatSolve()`, `KSPMatSolveType`, `KSPCGGetMatSolveType()`, `KSPGMRESSetMatSolveType()`, `KSPSetMatSolveBatchSize()`
+@*/
+PetscErrorCode KSPCGSetMatSolveType(KSP ksp, KSPMatSolveType type)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveEnum(ksp, type, 2);
+  PetscTryMethod(ksp, "KSPCGSetMatSolveType_C", (KSP, KSPMatSolveType), (ksp, type));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCGGetMatSolveType - Gets the algorithm used by `KSPMatSolve()` with `KSPCG`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the iterative context
+
+  Output Parameter:
+. type - the algorithm
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSP`, `KSPCG`, `KSPMatSolve()`, `KSPMatSolveType`, `KSPCGSetMatSolveType()`
+@*/
+PetscErrorCode KSPCGGetMatSolveType(KSP ksp, KSPMatSolveType *type)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(type, 2);
+  *type = KSP_MATSOLVE_COLUMN;
+  PetscTryMethod(ksp, "KSPCGGetMatSolveType_C", (KSP, KSPMatSolveType *), (ksp, type));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   KSPCGSetRadius - Sets the radius of the trust region used by the `KSPCG` when the solver is used inside `SNESNEWTONTR`
 
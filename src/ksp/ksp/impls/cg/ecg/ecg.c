@@ -0,0 +1,391 @@
+/*
+    This file implements the enlarged conjugate gradient method, see Grigori, Moufawad, and Nataf 2016.
+
+    The residual is split into t vectors T(r), the restrictions of r to t subdomains, and the solution is searched in the enlarged
+    Krylov subspace spanned by T(r_0), B A T(r_0), (B A)^2 T(r_0), ..., B being the preconditioner, applied to T(r_0) too. The block of
+    search directions P_k is made A-orthonormal, so that the step is alpha = P_k^H r_{k-1}, and the next block B A P_k only needs to be
+    A-orthogonalized against P_k and P_{k-1}. The directions that are (nearly) linearly dependent are dropped, so the block may shrink.
+
+    All the blocks are stored as MATDENSE with t columns at most. Each iteration applies the operator and the preconditioner to a block,
+    and needs two global reductions: one for the Gram matrix of the new block, its inner products with the residual, and the residual
+    norm, and one for the A-orthogonalization against the two previous blocks.
+*/
+#include <petsc/private/kspblockimpl.h> /*I "petscksp.h" I*/
+
+typedef struct {
+  PetscInt  t;      /* enlarging factor, the number of subdomains */
+  PetscInt  nt;     /* number of subdomains actually used, at most the number of rows */
+  PetscInt *domain; /* subdomain of each local row */
+} KSP_ECG;
+
+/*
+   The rows are split into t contiguous subdomains following the row distribution: the process p owns the subdomains
+   floor(p t / size) to floor((p + 1) t / size) - 1, and splits its rows evenly between them. When t is smaller than the number of
+   processes, the rows of a process that owns no subdomain go to the subdomain floor(p t / size).
+*/
+static PetscErrorCode KSPSetUp_ECG(KSP ksp)
+{
+  KSP_ECG    *ecg = (KSP_ECG *)ksp->data;
+  Mat         A;
+  PetscInt    m, N, d0, d1;
+  PetscMPIInt rank, size;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetWorkVecs(ksp, 2));
+  PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+  PetscCall(MatGetLocalSize(A, &m, NULL));
+  PetscCall(MatGetSize(A, &N, NULL));
+  PetscCallMPI(MPI_Comm_rank(PetscObjectComm((PetscObject)ksp), &rank));
+  PetscCallMPI(MPI_Comm_size(PetscObjectComm((PetscObject)ksp), &size));
+  ecg->nt = PetscMax(PetscMin(ecg->t, N), 1);
+  d0      = (PetscInt)(((PetscInt64)rank * ecg->nt) / size);
+  d1      = (PetscInt)(((PetscInt64)(rank + 1) * ecg->nt) / size);
+  PetscCall(PetscFree(ecg->domain));
+  PetscCall(PetscMalloc1(m, &ecg->domain));
+  for (PetscInt i = 0; i < m; i++) ecg->domain[i] = d1 > d0 ? d0 + (PetscInt)(((PetscInt64)i * (d1 - d0)) / m) : d0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_ECG(KSP ksp)
+{
+  KSP_ECG *ecg = (KSP_ECG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(ecg->domain));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_ECG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_ECG(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPECGSetEnlargingFactor_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPECGGetEnlargingFactor_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_ECG(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_ECG  *ecg = (KSP_ECG *)ksp->data;
+  PetscInt  t   = ecg->t;
+  PetscBool flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP ECG Options");
+  PetscCall(PetscOptionsInt("-ksp_ecg_enlarging_factor", "Number of subdomains the residual is split into", "KSPECGSetEnlargingFactor", t, &t, &flg));
+  if (flg) PetscCall(KSPECGSetEnlargingFactor(ksp, t));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_ECG(KSP ksp, PetscViewer viewer)
+{
+  KSP_ECG  *ecg = (KSP_ECG *)ksp->data;
+  PetscBool isascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii) PetscCall(PetscViewerASCIIPrintf(viewer, "  enlarging factor %" PetscInt_FMT ", subdomains following the row distribution\n", ecg->t));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* creates *Y with the layout of the solution and n columns, unless it already has n columns */
+static PetscErrorCode KSPECGCreateBlock_Private(KSP ksp, PetscInt n, Mat *Y)
+{
+  VecType  vtype;
+  PetscInt m, M, N;
+
+  PetscFunctionBegin;
+  if (*Y) {
+    PetscCall(MatGetSize(*Y, NULL, &N));
+    if (N == n) PetscFunctionReturn(PETSC_SUCCESS);
+    PetscCall(MatDestroy(Y));
+  }
+  PetscCall(VecGetType(ksp->vec_sol, &vtype));
+  PetscCall(VecGetLocalSize(ksp->vec_sol, &m));
+  PetscCall(VecGetSize(ksp->vec_sol, &M));
+  PetscCall(MatCreateDenseFromVecType(PetscObjectComm((PetscObject)ksp), vtype, m, PETSC_DECIDE, M, n, PETSC_DECIDE, NULL, Y));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Z = T(v), the column j of Z is the restriction of v to the subdomain j */
+static PetscErrorCode KSPECGSplit_Private(KSP ksp, Vec v, Mat Z)
+{
+  KSP_ECG           *ecg = (KSP_ECG *)ksp->data;
+  const PetscScalar *a;
+  PetscScalar       *z;
+  PetscInt           m, lda;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetLocalSize(v, &m));
+  PetscCall(MatDenseGetLDA(Z, &lda));
+  PetscCall(MatDenseGetArrayWrite(Z, &z));
+  PetscCall(VecGetArrayRead(v, &a));
+  for (PetscInt j = 0; j < ecg->nt; j++) PetscCall(PetscArrayzero(z + j * lda, m));
+  for (PetscInt i = 0; i < m; i++) z[i + ecg->domain[i] * lda] = a[i];
+  PetscCall(VecRestoreArrayRead(v, &a));
+  PetscCall(MatDenseRestoreArrayWrite(Z, &z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_ECG(KSP ksp)
+{
+  KSP_ECG     *ecg = (KSP_ECG *)ksp->data;
+  Mat          A, X = NULL, R = NULL, Z = NULL, AZ = NULL, P = NULL, AP = NULL, Pold = NULL, APold = NULL, swap, Xs[3], Ys[3];
+  Vec          x, r;
+  PetscInt     t = ecg->nt, nz = ecg->nt, np, npold = 0;
+  PetscScalar *G, *T, *C, *Cold, *c, *alpha, rr, *Gs[3];
+  PetscReal   *d, rnorm;
+  PetscBool    diagonalscale;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+  PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+  PetscCall(PetscMalloc7(t * t, &G, t * t, &T, t * t, &C, t * t, &Cold, t, &c, t, &alpha, t, &d));
+
+  /* r <- b - Ax, the solution and the residual are blocks of one column */
+  r = ksp->work[0];
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, A, ksp->vec_sol, r));
+    PetscCall(VecAYPX(r, -1.0, ksp->vec_rhs));
+  } else PetscCall(VecCopy(ksp->vec_rhs, r));
+  PetscCall(KSPECGCreateBlock_Private(ksp, 1, &X));
+  PetscCall(KSPECGCreateBlock_Private(ksp, 1, &R));
+  PetscCall(MatDenseGetColumnVecWrite(X, 0, &x));
+  PetscCall(VecCopy(ksp->vec_sol, x));
+  PetscCall(MatDenseRestoreColumnVecWrite(X, 0, &x));
+  PetscCall(MatDenseGetColumnVecWrite(R, 0, &x));
+  PetscCall(VecCopy(r, x));
+  PetscCall(MatDenseRestoreColumnVecWrite(R, 0, &x));
+
+  /* z <- T(B r) */
+  PetscCall(KSP_PCApply(ksp, r, ksp->work[1]));
+  PetscCall(KSPECGCreateBlock_Private(ksp, t, &Z));
+  PetscCall(KSPECGSplit_Private(ksp, ksp->work[1], Z));
+
+  ksp->its = 0;
+  while (PETSC_TRUE) {
+    /* G <- z'Az, c <- z'r, and rr <- r'r with a single global reduction */
+    PetscCall(KSPBlockMatMult_Private(ksp, A, Z, &AZ));
+    Xs[0] = Z;
+    Ys[0] = AZ;
+    Gs[0] = G;
+    Xs[1] = Z;
+    Ys[1] = R;
+    Gs[1] = c;
+    Xs[2] = R;
+    Ys[2] = R;
+    Gs[2] = &rr;
+    PetscCall(KSPBlockDots_Private(3, Xs, Ys, Gs));
+    rnorm = ksp->normtype == KSP_NORM_NONE ? 0.0 : PetscSqrtReal(PetscAbsScalar(rr));
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->rnorm = rnorm;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+    PetscCall(KSPLogResidualHistory(ksp, rnorm));
+    PetscCall(KSPMonitor(ksp, ksp->its, rnorm));
+    PetscCall((*ksp->converged)(ksp, ksp->its, rnorm, &ksp->reason, ksp->cnvP));
+    if (ksp->reason) break;
+    if (ksp->its >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+
+    /* p <- z T with p'Ap = I, dropping the nearly linearly dependent directions */
+    for (PetscInt j = 0; j < nz; j++) {
+      if (PetscRealPart(G[j + j * nz]) < 0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite matrix");
+        PetscCall(PetscInfo(ksp, "Indefinite operator detected at iteration %" PetscInt_FMT "\n", ksp->its));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      }
+      d[j] = PetscRealPart(G[j + j * nz]) > 0.0 ? 1.0 / PetscSqrtReal(PetscRealPart(G[j + j * nz])) : 0.0;
+    }
+    if (ksp->reason) break;
+    PetscCall(KSPBlockGramFactor_Private(nz, G, d, PETSC_SQRT_MACHINE_EPSILON, 0.0, T, NULL, &np));
+    if (!np) {
+      PetscCall(PetscInfo(ksp, "Breakdown, no search direction left at iteration %" PetscInt_FMT "\n", ksp->its));
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    if (np < nz) PetscCall(PetscInfo(ksp, "Dropping %" PetscInt_FMT " search directions at iteration %" PetscInt_FMT "\n", nz - np, ksp->its));
+    PetscCall(KSPECGCreateBlock_Private(ksp, np, &P));
+    PetscCall(KSPECGCreateBlock_Private(ksp, np, &AP));
+    PetscCall(KSPBlockGEMM_Private(0.0, P, 1.0, Z, T, nz));   /*   p <- z T    */
+    PetscCall(KSPBlockGEMM_Private(0.0, AP, 1.0, AZ, T, nz)); /*   ap <- Ap    */
+    for (PetscInt j = 0; j < np; j++) {                       /*   a <- p'r    */
+      alpha[j] = 0.0;
+      for (PetscInt i = 0; i < nz; i++) alpha[j] += PetscConj(T[i + j * nz]) * c[i];
+    }
+    PetscCall(KSPBlockGEMM_Private(1.0, X, 1.0, P, alpha, np));   /*   x <- x + p a   */
+    PetscCall(KSPBlockGEMM_Private(1.0, R, -1.0, AP, alpha, np)); /*   r <- r - ap a  */
+
+    /* z <- B ap - p (ap'B ap) - pold (apold'B ap), with a single global reduction */
+    if (np != nz) {
+      PetscCall(MatDestroy(&AZ));
+      PetscCall(KSPECGCreateBlock_Private(ksp, np, &Z));
+      nz = np;
+    }
+    PetscCall(KSP_PCMatApply(ksp, AP, Z));
+    Xs[0] = AP;
+    Ys[0] = Z;
+    Gs[0] = C;
+    Xs[1] = APold;
+    Ys[1] = Z;
+    Gs[1] = Cold;
+    PetscCall(KSPBlockDots_Private(npold ? 2 : 1, Xs, Ys, Gs));
+    PetscCall(KSPBlockGEMM_Private(1.0, Z, -1.0, P, C, np));
+    if (npold) PetscCall(KSPBlockGEMM_Private(1.0, Z, -1.0, Pold, Cold, npold));
+    swap  = Pold;
+    Pold  = P;
+    P     = swap;
+    swap  = APold;
+    APold = AP;
+    AP    = swap;
+    npold = np;
+
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->its++;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  }
+
+  PetscCall(MatDenseGetColumnVecRead(X, 0, &x));
+  PetscCall(VecCopy(x, ksp->vec_sol));
+  PetscCall(MatDenseRestoreColumnVecRead(X, 0, &x));
+  PetscCall(MatDestroy(&APold));
+  PetscCall(MatDestroy(&Pold));
+  PetscCall(MatDestroy(&AP));
+  PetscCall(MatDestroy(&P));
+  PetscCall(MatDestroy(&AZ));
+  PetscCall(MatDestroy(&Z));
+  PetscCall(MatDestroy(&R));
+  PetscCall(MatDestroy(&X));
+  PetscCall(PetscFree7(G, T, C, Cold, c, alpha, d));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPECGSetEnlargingFactor_ECG(KSP ksp, PetscInt t)
+{
+  KSP_ECG *ecg = (KSP_ECG *)ksp->data;
+
+  PetscFunctionBegin;
+  if (t == PETSC_DETERMINE) t = 8;
+  PetscCheck(t >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Enlarging factor %" PetscInt_FMT " must be positive", t);
+  if (t != ecg->t) {
+    ecg->t          = t;
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPECGGetEnlargingFactor_ECG(KSP ksp, PetscInt *t)
+{
+  PetscFunctionBegin;
+  *t = ((KSP_ECG *)ksp->data)->t;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPECGSetEnlargingFactor - Sets the number of subdomains the residual is split into by `KSPECG`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space context
+- t   - the enlarging factor, or `PETSC_DETERMINE` to use the default 8
+
+  Options Database Key:
+. -ksp_ecg_enlarging_factor t - the enlarging factor
+
+  Level: intermediate
+
+  Notes:
+  The subdomains follow the row distribution of the operator. With `t` equal to the number of MPI processes, each process owns one
+  subdomain. `KSPECG` stores 6 blocks of `t` vectors, and each iteration applies the operator and the preconditioner to a block of
+  `t` vectors at most.
+
+  With `t` equal to 1, `KSPECG` computes the same iterates as `KSPCG`.
+
+.seealso: [](ch_ksp), `KSPECG`, `KSPECGGetEnlargingFactor()`
+@*/
+PetscErrorCode KSPECGSetEnlargingFactor(KSP ksp, PetscInt t)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, t, 2);
+  PetscTryMethod(ksp, "KSPECGSetEnlargingFactor_C", (KSP, PetscInt), (ksp, t));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPECGGetEnlargingFactor - Gets the number of subdomains the residual is split into by `KSPECG`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space context
+
+  Output Parameter:
+. t - the enlarging factor
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPECG`, `KSPECGSetEnlargingFactor()`
+@*/
+PetscErrorCode KSPECGGetEnlargingFactor(KSP ksp, PetscInt *t)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(t, 2);
+  PetscUseMethod(ksp, "KSPECGGetEnlargingFactor_C", (KSP, PetscInt *), (ksp, t));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPECG - The enlarged conjugate gradient method {cite}`grigori2016enlarged` for symmetric (Hermitian) positive definite linear
+   systems, which splits the residual into `t` vectors by subdomain and searches the solution in the resulting enlarged Krylov subspace
+
+   Options Database Key:
+.   -ksp_ecg_enlarging_factor t - the number of subdomains, see `KSPECGSetEnlargingFactor()`
+
+   Level: intermediate
+
+   Notes:
+   The initial preconditioned residual is split into `t` vectors, its restrictions to `t` subdomains that follow the row distribution
+   of the operator, and a block conjugate gradient method is run on them: the search directions are blocks of up to `t` vectors, made
+   A-orthonormal, and the block applications of the operator and of the preconditioner use `MatMatMult()` and `PCMatApply()`. The
+   directions that become (nearly) linearly dependent are dropped. Each iteration needs two global reductions, as `KSPCG`, but the
+   enlarged subspace is richer than the Krylov subspace, so the number of iterations, hence of reductions, is often much smaller,
+   at the price of `t` times more local work. This trades communication for computation on large numbers of processes.
+
+   The operator and the preconditioner must be symmetric (Hermitian) positive definite. The blocks are stored as `MATDENSE`. The
+   norms `KSP_NORM_UNPRECONDITIONED` and `KSP_NORM_NONE` are supported with left preconditioning, the norm of the residual being
+   computed in the same reduction as the Gram matrix of the block.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPCG`, `KSPECGSetEnlargingFactor()`, `KSPCGSetMatSolveType()`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_ECG(KSP ksp)
+{
+  KSP_ECG *ecg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&ecg));
+  ecg->t    = 8;
+  ksp->data = (void *)ecg;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_ECG;
+  ksp->ops->solve          = KSPSolve_ECG;
+  ksp->ops->reset          = KSPReset_ECG;
+  ksp->ops->destroy        = KSPDestroy_ECG;
+  ksp->ops->view           = KSPView_ECG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_ECG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPECGSetEnlargingFactor_C", KSPECGSetEnlargingFactor_ECG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPECGGetEnlargingFactor_C", KSPECGGetEnlargingFactor_ECG));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,553 @@
+/*
+    This file implements a recycled, or deflated, preconditioned conjugate gradient method, see Saad, Yeung, Erhel, and Guyomarc'h 2000.
+
+    The recycled subspace is spanned by W, with W^H A W = I, and the products A W and B A W, B being the preconditioner, are kept.
+    The initial guess is first corrected so that the residual is orthogonal to W, x = x + W W^H r, and the search directions are then
+    A-orthogonalized against W, p = z + beta p - W (A W)^H z, the inner products with A W being fused with the global reduction of CG.
+
+    The first l search directions P of a solve are kept with A P and B A P = (z_i - z_{i+1}) / alpha_i. At the end of the solve, W is
+    replaced by the approximate eigenvectors of B A in range([W P]) associated with the smallest eigenvalues, i.e., the solutions
+    of (A Z)^H B (A Z) y = theta (A Z)^H Z y with Z = [W P], which are A-orthonormal. When the operators have changed between two
+    solves, W is A-orthonormalized again and A W and B A W are recomputed before the solve.
+*/
+#include <petsc/private/kspimpl.h> /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscInt         kmax, lmax;         /* largest dimension of the recycled subspace and number of kept search directions */
+  PetscInt         k, l;               /* current dimension of the recycled subspace and number of kept search directions */
+  Vec             *W, *AW, *MAW;       /* the recycled subspace, with W^H A W = I, and its images by A and B A */
+  Vec             *Wn, *AWn, *MAWn;    /* the recycled subspace at the end of the solve */
+  Vec             *P, *AP, *MAP;       /* the first search directions of the solve and their images by A and B A */
+  Vec             *Z, *AZ, *MAZ;       /* pointers to [W, P], [A W, A P], and [B A W, B A P] */
+  PetscScalar     *F, *G, *mu, *work;  /* (A Z)^H Z and (A Z)^H B (A Z), coefficients of the projection, work space of LAPACK */
+  PetscReal       *theta, *rwork;      /* eigenvalues, work space of LAPACK */
+  PetscObjectId    Aid, Pid;           /* the operators used to compute A W and B A W */
+  PetscObjectState Astate, Pstate;     /* and their states */
+} KSP_RCG;
+
+static PetscErrorCode KSPSetUp_RCG(KSP ksp)
+{
+  KSP_RCG *rcg = (KSP_RCG *)ksp->data;
+  PetscInt n   = rcg->kmax + rcg->lmax;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetWorkVecs(ksp, 4));
+  if (rcg->kmax) {
+    PetscCall(KSPCreateVecs(ksp, rcg->kmax, &rcg->W, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->kmax, &rcg->AW, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->kmax, &rcg->MAW, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->kmax, &rcg->Wn, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->kmax, &rcg->AWn, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->kmax, &rcg->MAWn, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->lmax, &rcg->P, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->lmax, &rcg->AP, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, rcg->lmax, &rcg->MAP, 0, NULL));
+  }
+  PetscCall(PetscMalloc3(n, &rcg->Z, n, &rcg->AZ, n, &rcg->MAZ));
+  PetscCall(PetscMalloc6(n * n, &rcg->F, n * n, &rcg->G, n, &rcg->mu, 3 * n, &rcg->work, n, &rcg->theta, 3 * n, &rcg->rwork));
+  rcg->k = rcg->l = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_RCG(KSP ksp)
+{
+  KSP_RCG *rcg = (KSP_RCG *)ksp->data;
+
+  PetscFunctionBegin;
+  if (rcg->W) {
+    PetscCall(VecDestroyVecs(rcg->kmax, &rcg->W));
+    PetscCall(VecDestroyVecs(rcg->kmax, &rcg->AW));
+    PetscCall(VecDestroyVecs(rcg->kmax, &rcg->MAW));
+    PetscCall(VecDestroyVecs(rcg->kmax, &rcg->Wn));
+    PetscCall(VecDestroyVecs(rcg->kmax, &rcg->AWn));
+    PetscCall(VecDestroyVecs(rcg->kmax, &rcg->MAWn));
+    PetscCall(VecDestroyVecs(rcg->lmax, &rcg->P));
+    PetscCall(VecDestroyVecs(rcg->lmax, &rcg->AP));
+    PetscCall(VecDestroyVecs(rcg->lmax, &rcg->MAP));
+  }
+  PetscCall(PetscFree3(rcg->Z, rcg->AZ, rcg->MAZ));
+  PetscCall(PetscFree6(rcg->F, rcg->G, rcg->mu, rcg->work, rcg->theta, rcg->rwork));
+  rcg->k   = rcg->l = 0;
+  rcg->Aid = rcg->Pid = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_RCG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_RCG(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPRCGSetRecycleDimension_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPRCGGetRecycleDimension_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPRCGGetRecycledDimension_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_RCG(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_RCG  *rcg = (KSP_RCG *)ksp->data;
+  PetscInt  k = rcg->kmax, l = rcg->lmax;
+  PetscBool flg1, flg2;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP RCG Options");
+  PetscCall(PetscOptionsInt("-ksp_rcg_recycle", "Dimension of the recycled subspace", "KSPRCGSetRecycleDimension", k, &k, &flg1));
+  PetscCall(PetscOptionsInt("-ksp_rcg_directions", "Number of search directions kept to update the recycled subspace", "KSPRCGSetRecycleDimension", l, &l, &flg2));
+  if (flg1 || flg2) PetscCall(KSPRCGSetRecycleDimension(ksp, k, l));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_RCG(KSP ksp, PetscViewer viewer)
+{
+  KSP_RCG  *rcg = (KSP_RCG *)ksp->data;
+  PetscBool isascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  recycled subspace of dimension %" PetscInt_FMT " (requested %" PetscInt_FMT ")\n", rcg->k, rcg->kmax));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  number of search directions kept to update the recycled subspace %" PetscInt_FMT "\n", rcg->lmax));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPRCGSwap_Private(KSP_RCG *rcg)
+{
+  Vec *tmp;
+
+  PetscFunctionBegin;
+  tmp       = rcg->W;
+  rcg->W    = rcg->Wn;
+  rcg->Wn   = tmp;
+  tmp       = rcg->AW;
+  rcg->AW   = rcg->AWn;
+  rcg->AWn  = tmp;
+  tmp       = rcg->MAW;
+  rcg->MAW  = rcg->MAWn;
+  rcg->MAWn = tmp;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   When the operators have changed since A W was computed, W is A-orthonormalized with the Cholesky factorization
+   W^H A W = R^H R and A W and B A W are recomputed. The recycled subspace is discarded if W^H A W is not positive definite.
+*/
+static PetscErrorCode KSPRCGUpdateOperators(KSP ksp)
+{
+  KSP_RCG         *rcg = (KSP_RCG *)ksp->data;
+  Mat              A, P;
+  PetscObjectState Astate, Pstate;
+  PetscInt         k = rcg->k;
+  PetscScalar     *F = rcg->F, *T = rcg->G, one = 1.0;
+  PetscBLASInt     bk, info;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &A, &P));
+  PetscCall(PetscObjectStateGet((PetscObject)A, &Astate));
+  PetscCall(PetscObjectStateGet((PetscObject)P, &Pstate));
+  if (((PetscObject)A)->id == rcg->Aid && ((PetscObject)P)->id == rcg->Pid && Astate == rcg->Astate && Pstate == rcg->Pstate) PetscFunctionReturn(PETSC_SUCCESS);
+  rcg->Aid    = ((PetscObject)A)->id;
+  rcg->Pid    = ((PetscObject)P)->id;
+  rcg->Astate = Astate;
+  rcg->Pstate = Pstate;
+  if (!k) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscInfo(ksp, "Operators have changed, recomputing the images of the recycled subspace of dimension %" PetscInt_FMT "\n", k));
+
+  for (PetscInt j = 0; j < k; j++) PetscCall(KSP_MatMult(ksp, A, rcg->W[j], rcg->AW[j]));
+  for (PetscInt j = 0; j < k; j++) PetscCall(VecMDotBegin(rcg->AW[j], k, rcg->W, F + j * k));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp)));
+  for (PetscInt j = 0; j < k; j++) PetscCall(VecMDotEnd(rcg->AW[j], k, rcg->W, F + j * k));
+
+  /* T = R^{-1} */
+  PetscCall(PetscBLASIntCast(k, &bk));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKpotrf", LAPACKpotrf_("U", &bk, F, &bk, &info));
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(info >= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %d", (int)info);
+  if (info) {
+    PetscCall(PetscInfo(ksp, "Recycled subspace is not A-definite, discarding it\n"));
+    rcg->k = 0;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscArrayzero(T, k * k));
+  for (PetscInt i = 0; i < k; i++) T[i + i * k] = 1.0;
+  PetscCallBLAS("BLAStrsm", BLAStrsm_("L", "U", "N", "N", &bk, &bk, &one, F, &bk, T, &bk));
+
+  for (PetscInt j = 0; j < k; j++) {
+    PetscCall(VecMAXPBY(rcg->Wn[j], j + 1, T + j * k, 0.0, rcg->W));
+    PetscCall(VecMAXPBY(rcg->AWn[j], j + 1, T + j * k, 0.0, rcg->AW));
+    PetscCall(KSP_PCApply(ksp, rcg->AWn[j], rcg->MAWn[j]));
+  }
+  PetscCall(KSPRCGSwap_Private(rcg));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* replaces W with the approximate eigenvectors of B A in range([W P]) associated with the smallest eigenvalues */
+static PetscErrorCode KSPRCGUpdateRecycledSubspace(KSP ksp)
+{
+  KSP_RCG     *rcg = (KSP_RCG *)ksp->data;
+  PetscInt     k = rcg->k, n = rcg->k + rcg->l, kk;
+  PetscScalar *F = rcg->F, *G = rcg->G;
+  PetscBLASInt bn, lwork, info, one = 1;
+
+  PetscFunctionBegin;
+  if (!rcg->l) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt i = 0; i < k; i++) {
+    rcg->Z[i]   = rcg->W[i];
+    rcg->AZ[i]  = rcg->AW[i];
+    rcg->MAZ[i] = rcg->MAW[i];
+  }
+  for (PetscInt i = 0; i < rcg->l; i++) {
+    rcg->Z[k + i]   = rcg->P[i];
+    rcg->AZ[k + i]  = rcg->AP[i];
+    rcg->MAZ[k + i] = rcg->MAP[i];
+  }
+
+  /* F = (A Z)^H Z and G = (A Z)^H B (A Z), with a single global reduction */
+  for (PetscInt j = 0; j < n; j++) {
+    PetscCall(VecMDotBegin(rcg->AZ[j], n, rcg->Z, F + j * n));
+    PetscCall(VecMDotBegin(rcg->AZ[j], n, rcg->MAZ, G + j * n));
+  }
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp)));
+  for (PetscInt j = 0; j < n; j++) {
+    PetscCall(VecMDotEnd(rcg->AZ[j], n, rcg->Z, F + j * n));
+    PetscCall(VecMDotEnd(rcg->AZ[j], n, rcg->MAZ, G + j * n));
+  }
+  /* only the upper triangular parts are used, averaged with the lower triangular parts to symmetrize the rounding errors */
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt i = 0; i < j; i++) {
+      F[i + j * n] = 0.5 * (F[i + j * n] + PetscConj(F[j + i * n]));
+      G[i + j * n] = 0.5 * (G[i + j * n] + PetscConj(G[j + i * n]));
+    }
+  }
+
+  /* G y = theta F y, the eigenvectors being F-orthonormal and the eigenvalues in ascending order */
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(3 * n, &lwork));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if PetscDefined(USE_COMPLEX)
+  PetscCallBLAS("LAPACKsygv", LAPACKsygv_(&one, "V", "U", &bn, G, &bn, F, &bn, rcg->theta, rcg->work, &lwork, rcg->rwork, &info));
+#else
+  PetscCallBLAS("LAPACKsygv", LAPACKsygv_(&one, "V", "U", &bn, G, &bn, F, &bn, rcg->theta, rcg->work, &lwork, &info));
+#endif
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(info >= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %d", (int)info);
+  rcg->l = 0;
+  if (info) {
+    PetscCall(PetscInfo(ksp, "Generalized eigenvalue problem is not definite, the recycled subspace is not updated\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  kk = PetscMin(rcg->kmax, n);
+  for (PetscInt j = 0; j < kk; j++) {
+    PetscCall(VecMAXPBY(rcg->Wn[j], n, G + j * n, 0.0, rcg->Z));
+    PetscCall(VecMAXPBY(rcg->AWn[j], n, G + j * n, 0.0, rcg->AZ));
+    PetscCall(VecMAXPBY(rcg->MAWn[j], n, G + j * n, 0.0, rcg->MAZ));
+  }
+  PetscCall(KSPRCGSwap_Private(rcg));
+  rcg->k = kk;
+  PetscCall(PetscInfo(ksp, "Smallest approximate eigenvalue of the preconditioned operator %g\n", (double)rcg->theta[0]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the preconditioned residual z and, with a single global reduction, r^H z, the norm of the residual, and (A W)^H z */
+static PetscErrorCode KSPRCGApplyPCAndReduce_Private(KSP ksp, Vec R, Vec Z, PetscScalar *beta, PetscReal *dp)
+{
+  KSP_RCG *rcg = (KSP_RCG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(KSP_PCApply(ksp, R, Z));
+  PetscCall(VecDotBegin(Z, R, beta));
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecNormBegin(Z, NORM_2, dp));
+  else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecNormBegin(R, NORM_2, dp));
+  if (rcg->k) PetscCall(VecMDotBegin(Z, rcg->k, rcg->AW, rcg->mu));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)Z)));
+  PetscCall(VecDotEnd(Z, R, beta));
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecNormEnd(Z, NORM_2, dp));
+  else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecNormEnd(R, NORM_2, dp));
+  if (rcg->k) PetscCall(VecMDotEnd(Z, rcg->k, rcg->AW, rcg->mu));
+  KSPCheckDot(ksp, *beta);
+  if (ksp->normtype == KSP_NORM_NATURAL) *dp = PetscSqrtReal(PetscAbsScalar(*beta));
+  else if (ksp->normtype == KSP_NORM_NONE) *dp = 0.0;
+  for (PetscInt i = 0; i < rcg->k; i++) rcg->mu[i] = -rcg->mu[i];
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_RCG(KSP ksp)
+{
+  KSP_RCG    *rcg = (KSP_RCG *)ksp->data;
+  Vec         X, B, R, Z, P, Q;
+  Mat         Amat, Pmat;
+  PetscScalar alpha, beta, betaold, dpi;
+  PetscReal   dp = 0.0;
+  PetscBool   diagonalscale, keep;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+
+  X = ksp->vec_sol;
+  B = ksp->vec_rhs;
+  R = ksp->work[0];
+  Z = ksp->work[1];
+  P = ksp->work[2];
+  Q = ksp->work[3];
+
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+  PetscCall(KSPRCGUpdateOperators(ksp));
+  rcg->l = 0;
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, Amat, X, R)); /*     r <- b - Ax     */
+    PetscCall(VecAYPX(R, -1.0, B));
+  } else {
+    PetscCall(VecCopy(B, R)); /*     r <- b (x is 0) */
+  }
+  /* the initial guess is corrected so that the residual is orthogonal to W */
+  if (rcg->k) {
+    PetscCall(VecMDot(R, rcg->k, rcg->W, rcg->mu));
+    PetscCall(VecMAXPY(X, rcg->k, rcg->mu, rcg->W));
+    for (PetscInt i = 0; i < rcg->k; i++) rcg->mu[i] = -rcg->mu[i];
+    PetscCall(VecMAXPY(R, rcg->k, rcg->mu, rcg->AW));
+  }
+  PetscCall(KSPRCGApplyPCAndReduce_Private(ksp, R, Z, &beta, &dp));
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(KSPLogResidualHistory(ksp, dp));
+  PetscCall(KSPMonitor(ksp, 0, dp));
+  ksp->rnorm = dp;
+  PetscCall((*ksp->converged)(ksp, 0, dp, &ksp->reason, ksp->cnvP));
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(VecCopy(Z, P));
+  if (rcg->k) PetscCall(VecMAXPY(P, rcg->k, rcg->mu, rcg->W)); /*     p <- z - W (AW)^H z */
+
+  do {
+    PetscCall(KSP_MatMult(ksp, Amat, P, Q)); /*     q <- Ap          */
+    PetscCall(VecDot(Q, P, &dpi));           /*     dpi <- p^H q     */
+    KSPCheckDot(ksp, dpi);
+    if (PetscRealPart(dpi) <= 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Diverged due to indefinite matrix, dpi %g", (double)PetscRealPart(dpi));
+      ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      PetscCall(PetscInfo(ksp, "diverging due to indefinite matrix\n"));
+      break;
+    }
+    alpha = beta / dpi;
+    /* the first search directions are kept to update the recycled subspace, B A p = (z_i - z_{i+1}) / alpha */
+    keep = (PetscBool)(rcg->kmax && rcg->l < rcg->lmax);
+    if (keep) {
+      PetscCall(VecCopy(P, rcg->P[rcg->l]));
+      PetscCall(VecCopy(Q, rcg->AP[rcg->l]));
+      PetscCall(VecCopy(Z, rcg->MAP[rcg->l]));
+    }
+    PetscCall(VecAXPY(X, alpha, P));  /*     x <- x + alpha p */
+    PetscCall(VecAXPY(R, -alpha, Q)); /*     r <- r - alpha q */
+    betaold = beta;
+    PetscCall(KSPRCGApplyPCAndReduce_Private(ksp, R, Z, &beta, &dp));
+    if (ksp->reason) break;
+    if (keep) {
+      PetscCall(VecAXPBY(rcg->MAP[rcg->l], -1.0 / alpha, 1.0 / alpha, Z));
+      rcg->l++;
+    }
+
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->its++;
+    ksp->rnorm = dp;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+    PetscCall(KSPLogResidualHistory(ksp, dp));
+    PetscCall(KSPMonitor(ksp, ksp->its, dp));
+    PetscCall((*ksp->converged)(ksp, ksp->its, dp, &ksp->reason, ksp->cnvP));
+    if (ksp->reason) break;
+
+    PetscCall(VecAYPX(P, beta / betaold, Z));                    /*     p <- z + b p     */
+    if (rcg->k) PetscCall(VecMAXPY(P, rcg->k, rcg->mu, rcg->W)); /*     p <- p - W mu    */
+  } while (ksp->its < ksp->max_it);
+  if (ksp->its >= ksp->max_it && !ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+
+  /* the kept search directions are valid as long as the iteration did not break down */
+  if (ksp->reason > 0 || ksp->reason == KSP_DIVERGED_ITS) PetscCall(KSPRCGUpdateRecycledSubspace(ksp));
+  rcg->l = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPRCGSetRecycleDimension_RCG(KSP ksp, PetscInt k, PetscInt l)
+{
+  KSP_RCG *rcg = (KSP_RCG *)ksp->data;
+
+  PetscFunctionBegin;
+  if (l == PETSC_DETERMINE) l = 2 * k;
+  PetscCheck(k >= 0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Dimension of the recycled subspace must be nonnegative");
+  PetscCheck(l >= 0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Number of kept search directions must be nonnegative");
+  if (k != rcg->kmax || l != rcg->lmax) {
+    /* free the data structures with the current dimensions, they are created again by KSPSetUp() */
+    if (ksp->setupstage) {
+      PetscCall(KSPReset_RCG(ksp));
+      ksp->setupstage = KSP_SETUP_NEW;
+    }
+    rcg->kmax = k;
+    rcg->lmax = l;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPRCGGetRecycleDimension_RCG(KSP ksp, PetscInt *k, PetscInt *l)
+{
+  KSP_RCG *rcg = (KSP_RCG *)ksp->data;
+
+  PetscFunctionBegin;
+  if (k) *k = rcg->kmax;
+  if (l) *l = rcg->lmax;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPRCGGetRecycledDimension_RCG(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  *k = ((KSP_RCG *)ksp->data)->k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPRCGSetRecycleDimension - Sets the largest dimension of the subspace recycled by `KSPRCG` between consecutive solves and
+  the number of search directions of a solve used to update it
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space context
+. k   - the dimension of the recycled subspace
+- l   - the number of search directions kept, or `PETSC_DETERMINE` to use 2 `k`
+
+  Options Database Keys:
++ -ksp_rcg_recycle k     - the dimension of the recycled subspace
+- -ksp_rcg_directions l  - the number of search directions kept
+
+  Level: intermediate
+
+  Notes:
+  The defaults are 10 and 20. The first `l` search directions of each solve are kept, together with their images by the operator
+  and the preconditioned operator, so that `KSPRCG` needs 6 `k` + 3 `l` additional vectors.
+
+  With `k` equal to 0, `KSPRCG` is `KSPCG`.
+
+.seealso: [](ch_ksp), `KSPRCG`, `KSPRCGGetRecycleDimension()`, `KSPRCGGetRecycledDimension()`
+@*/
+PetscErrorCode KSPRCGSetRecycleDimension(KSP ksp, PetscInt k, PetscInt l)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, k, 2);
+  PetscValidLogicalCollectiveInt(ksp, l, 3);
+  PetscTryMethod(ksp, "KSPRCGSetRecycleDimension_C", (KSP, PetscInt, PetscInt), (ksp, k, l));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPRCGGetRecycleDimension - Gets the largest dimension of the subspace recycled by `KSPRCG` and the number of search directions used to update it
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space context
+
+  Output Parameters:
++ k - the dimension of the recycled subspace, pass `NULL` if not needed
+- l - the number of search directions kept, pass `NULL` if not needed
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPRCG`, `KSPRCGSetRecycleDimension()`, `KSPRCGGetRecycledDimension()`
+@*/
+PetscErrorCode KSPRCGGetRecycleDimension(KSP ksp, PetscInt *k, PetscInt *l)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscUseMethod(ksp, "KSPRCGGetRecycleDimension_C", (KSP, PetscInt *, PetscInt *), (ksp, k, l));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPRCGGetRecycledDimension - Gets the dimension of the subspace currently recycled by `KSPRCG`, that will be used by the next solve
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space context
+
+  Output Parameter:
+. k - the current dimension of the recycled subspace
+
+  Level: intermediate
+
+  Note:
+  The recycled subspace is discarded by `KSPReset()`, it is kept when the operators are changed with `KSPSetOperators()`.
+
+.seealso: [](ch_ksp), `KSPRCG`, `KSPRCGSetRecycleDimension()`, `KSPRCGGetRecycleDimension()`
+@*/
+PetscErrorCode KSPRCGGetRecycledDimension(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(k, 2);
+  PetscUseMethod(ksp, "KSPRCGGetRecycledDimension_C", (KSP, PetscInt *), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPRCG - The recycled, or deflated, preconditioned conjugate gradient method {cite}`saad2000deflated` for sequences of symmetric
+   (Hermitian) positive definite linear systems, which recycles between consecutive solves an approximate invariant subspace of the
+   preconditioned operator associated with its smallest eigenvalues
+
+   Options Database Keys:
++   -ksp_rcg_recycle k    - the dimension of the recycled subspace, see `KSPRCGSetRecycleDimension()`
+-   -ksp_rcg_directions l - the number of search directions of a solve used to update the recycled subspace
+
+   Level: intermediate
+
+   Notes:
+   The search directions are A-orthogonalized against the recycled subspace, which removes its eigenvalues from the convergence of
+   the method. This costs `k` additional inner products per iteration, which are fused with the global reduction of `KSPCG`. At the
+   end of each solve, the recycled subspace is updated with a Rayleigh-Ritz procedure over the previous subspace and the first
+   `l` search directions of the solve. It is kept by the `KSP` between calls to `KSPSolve()`, including when the operators are changed
+   with `KSPSetOperators()`, in which case it is A-orthonormalized again at the beginning of the next solve with `k` applications of the
+   operator and of the preconditioner. For sequences of linear systems whose operators change slowly, e.g., in Newton's method or time
+   stepping, and whose preconditioned operators have a few small outlying eigenvalues, this can divide the number of iterations by several units.
+
+   The operator and the preconditioner must be symmetric (Hermitian) positive definite. The norms `KSP_NORM_PRECONDITIONED`,
+   `KSP_NORM_UNPRECONDITIONED`, `KSP_NORM_NATURAL`, and `KSP_NORM_NONE` are supported with left preconditioning.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPCG`, `KSPGCRODR`, `PCDEFLATION`, `KSPRCGSetRecycleDimension()`,
+          `KSPRCGGetRecycledDimension()`, `KSPGuess`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_RCG(KSP ksp)
+{
+  KSP_RCG *rcg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&rcg));
+  rcg->kmax = 10;
+  rcg->lmax = 20;
+  ksp->data = (void *)rcg;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NATURAL, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_RCG;
+  ksp->ops->solve          = KSPSolve_RCG;
+  ksp->ops->reset          = KSPReset_RCG;
+  ksp->ops->destroy        = KSPDestroy_RCG;
+  ksp->ops->view           = KSPView_RCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_RCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPRCGSetRecycleDimension_C", KSPRCGSetRecycleDimension_RCG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPRCGGetRecycleDimension_C", KSPRCGGetRecycleDimension_RCG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPRCGGetRecycledDimension_C", KSPRCGGetRecycledDimension_RCG));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
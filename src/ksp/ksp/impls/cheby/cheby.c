@@ -1,5 +1,6 @@
 #include "chebyshevimpl.h"
 #include <../src/ksp/ksp/impls/cheby/chebyshevimpl.h> /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
 
 static const char *const KSPChebyshevKinds[] = {"FIRST", "FOURTH", "OPT_FOURTH", "KSPChebyshevKinds", "KSP_CHEBYSHEV_", NULL};
 
@@ -37,6 +38,196 @@ static PetscErrorCode KSPChebyshevComputeExtremeEigenvalues_Private(KSP kspest,
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   The eigenvalue estimates of the preconditioned operator are cached on the preconditioning matrix, so that they are shared by all the
+   KSPCHEBYSHEV with the same operators and the same type of preconditioner, for example the smoothers of a PCMG that is set up again.
+   The key is the operator, the type of the preconditioner, and the states of both matrices.
+*/
+typedef struct {
+  char             pctype[64];               /* type of the preconditioner */
+  PetscObjectId    amatid;                   /* the operator, the preconditioning matrix is the one the cache is composed with */
+  PetscObjectState amatstate, pmatstate;     /* states of the operators */
+  PetscObjectState amatnzstate, pmatnzstate; /* and their nonzero states */
+} KSPChebyshevCacheKey;
+
+typedef struct {
+  KSPChebyshevCacheKey key;          /* key of the estimates */
+  char                 esttype[64];  /* type of the KSP that computed the estimates, "power" if refreshed with the power method */
+  PetscInt             eststeps;     /* and its number of steps */
+  PetscReal            emin, emax;   /* the estimates, zero if there are none */
+  Vec                  v;            /* last iterate of the power method */
+} KSPChebyshevCache;
+
+static PetscErrorCode KSPChebyshevCacheDestroy_Private(PetscCtxRt ctx)
+{
+  KSPChebyshevCache *cache = *(KSPChebyshevCache **)ctx;
+
+  PetscFunctionBegin;
+  PetscCall(VecDestroy(&cache->v));
+  PetscCall(PetscFree(cache));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPChebyshevCacheGetKey_Private(KSP ksp, KSPChebyshevCacheKey *key)
+{
+  Mat    Amat, Pmat;
+  PCType pctype;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+  PetscCall(PCGetType(ksp->pc, &pctype));
+  PetscCall(PetscMemzero(key, sizeof(*key)));
+  PetscCall(PetscStrncpy(key->pctype, pctype ? pctype : "", sizeof(key->pctype)));
+  PetscCall(PetscObjectGetId((PetscObject)Amat, &key->amatid));
+  PetscCall(PetscObjectStateGet((PetscObject)Amat, &key->amatstate));
+  PetscCall(PetscObjectStateGet((PetscObject)Pmat, &key->pmatstate));
+  PetscCall(MatGetNonzeroState(Amat, &key->amatnzstate));
+  PetscCall(MatGetNonzeroState(Pmat, &key->pmatnzstate));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* whether the keys are equal, or only differ by the values of the matrices when values is true */
+static PetscErrorCode KSPChebyshevCacheKeyCompare_Private(const KSPChebyshevCacheKey *a, const KSPChebyshevCacheKey *b, PetscBool values, PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscStrcmp(a->pctype, b->pctype, flg));
+  *flg = (PetscBool)(*flg && a->amatid == b->amatid && a->amatnzstate == b->amatnzstate && a->pmatnzstate == b->pmatnzstate);
+  if (!values) *flg = (PetscBool)(*flg && a->amatstate == b->amatstate && a->pmatstate == b->pmatstate);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPChebyshevCacheGet_Private(KSP ksp, PetscBool create, KSPChebyshevCache **cache)
+{
+  Mat Pmat;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, NULL, &Pmat));
+  *cache = NULL;
+  PetscCall(PetscObjectContainerQuery((PetscObject)Pmat, "KSPChebyshevCache", (void **)cache));
+  if (!*cache && create) {
+    PetscCall(PetscNew(cache));
+    PetscCall(PetscObjectContainerCompose((PetscObject)Pmat, "KSPChebyshevCache", *cache, KSPChebyshevCacheDestroy_Private));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Refreshes the estimates of the cache, computed for other values of the matrices, with cheb->refresh iterations of the power method
+   started from its last iterate. The largest eigenvalue is estimated by the Rayleigh quotient (B A v, v)_A / (v, v)_A, computed in
+   the same reduction as the norm of B A v, or by the norm if the operator is not positive definite. The smallest eigenvalue is scaled
+   as the largest one.
+*/
+static PetscErrorCode KSPChebyshevCachePowerRefresh_Private(KSP ksp, KSPChebyshevCache *cache, PetscReal *emin, PetscReal *emax)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+  Mat            Amat;
+  Vec            v = ksp->work[0], w = ksp->work[1], z = ksp->work[2];
+  PetscScalar    zw, vw;
+  PetscReal      nrm = 0.0, lambda = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+  if (cache->v) PetscCall(VecCopy(cache->v, v));
+  else {
+    PetscCall(KSPSetNoisy_Private(Amat, v));
+    PetscCall(VecNormalize(v, NULL));
+  }
+  for (PetscInt k = 0; k < cheb->refresh; k++) {
+    PetscCall(KSP_MatMult(ksp, Amat, v, w)); /* w <- A v   */
+    PetscCall(KSP_PCApply(ksp, w, z));       /* z <- B A v */
+    PetscCall(VecNormBegin(z, NORM_2, &nrm));
+    PetscCall(VecDotBegin(z, w, &zw));
+    PetscCall(VecDotBegin(v, w, &vw));
+    PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)v)));
+    PetscCall(VecNormEnd(z, NORM_2, &nrm));
+    PetscCall(VecDotEnd(z, w, &zw));
+    PetscCall(VecDotEnd(v, w, &vw));
+    if (nrm == 0.0) break;
+    lambda = PetscRealPart(vw) > 0.0 ? PetscRealPart(zw) / PetscRealPart(vw) : nrm;
+    PetscCall(VecAXPBY(v, 1.0 / nrm, 0.0, z));
+  }
+  if (lambda > 0.0) {
+    *emin = cache->emin * lambda / cache->emax;
+    *emax = lambda;
+    if (!cache->v) PetscCall(VecDuplicate(v, &cache->v));
+    PetscCall(VecCopy(v, cache->v));
+  } else {
+    *emin = cache->emin;
+    *emax = cache->emax;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Sets emin_computed and emax_computed from the cache of the preconditioning matrix if possible: estimates computed by the same
+   estimator for the same matrices, or, if cheb->refresh is positive, estimates computed for other values of the matrices, refreshed
+   with the power method
+*/
+static PetscErrorCode KSPChebyshevCacheLookup_Private(KSP ksp, PetscBool *found)
+{
+  KSP_Chebyshev       *cheb = (KSP_Chebyshev *)ksp->data;
+  KSPChebyshevCache   *cache;
+  KSPChebyshevCacheKey key;
+  PetscBool            flg, same;
+  KSPType              esttype;
+
+  PetscFunctionBegin;
+  *found = PETSC_FALSE;
+  if (!cheb->usecache || !cheb->usenoisy) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(KSPChebyshevCacheGet_Private(ksp, PETSC_FALSE, &cache));
+  if (!cache) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(KSPChebyshevCacheGetKey_Private(ksp, &key));
+  PetscCall(KSPGetType(cheb->kspest, &esttype));
+  PetscCall(PetscStrcmp(cache->esttype, esttype ? esttype : KSPGMRES, &same));
+  same = (PetscBool)(same && cache->eststeps == cheb->kspest->max_it);
+  if (cache->emax != 0.0) {
+    PetscCall(KSPChebyshevCacheKeyCompare_Private(&cache->key, &key, PETSC_FALSE, &flg));
+    if (flg && (same || cheb->refresh)) {
+      cheb->emin_computed = cache->emin;
+      cheb->emax_computed = cache->emax;
+      *found              = PETSC_TRUE;
+      PetscCall(PetscInfo(ksp, "Using the eigenvalue estimates min %g max %g cached on the matrix\n", (double)cache->emin, (double)cache->emax));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  if (!cheb->refresh) PetscFunctionReturn(PETSC_SUCCESS);
+  if (cache->emax != 0.0) {
+    PetscCall(KSPChebyshevCacheKeyCompare_Private(&cache->key, &key, PETSC_TRUE, &flg));
+    if (flg) {
+      PetscCall(KSPChebyshevCachePowerRefresh_Private(ksp, cache, &cheb->emin_computed, &cheb->emax_computed));
+      *found = PETSC_TRUE;
+      PetscCall(PetscInfo(ksp, "Refreshed the eigenvalue estimates cached on the matrix with %" PetscInt_FMT " power iterations: min %g max %g\n", cheb->refresh, (double)cheb->emin_computed, (double)cheb->emax_computed));
+      PetscCall(PetscStrncpy(cache->esttype, "power", sizeof(cache->esttype)));
+      cache->eststeps = cheb->refresh;
+    }
+  }
+  if (*found) {
+    cache->key  = key;
+    cache->emin = cheb->emin_computed;
+    cache->emax = cheb->emax_computed;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* stores the estimates computed by cheb->kspest in the cache of the preconditioning matrix */
+static PetscErrorCode KSPChebyshevCacheStore_Private(KSP ksp)
+{
+  KSP_Chebyshev     *cheb = (KSP_Chebyshev *)ksp->data;
+  KSPChebyshevCache *cache;
+  KSPType            esttype;
+
+  PetscFunctionBegin;
+  if (!cheb->usecache || !cheb->usenoisy || cheb->emax_computed == 0.0) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(KSPChebyshevCacheGet_Private(ksp, PETSC_TRUE, &cache));
+  PetscCall(KSPChebyshevCacheGetKey_Private(ksp, &cache->key));
+  PetscCall(KSPGetType(cheb->kspest, &esttype));
+  PetscCall(PetscStrncpy(cache->esttype, esttype, sizeof(cache->esttype)));
+  cache->eststeps = cheb->kspest->max_it;
+  cache->emin     = cheb->emin_computed;
+  cache->emax     = cheb->emax_computed;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode KSPChebyshevGetEigenvalues_Chebyshev(KSP ksp, PetscReal *emax, PetscReal *emin)
 {
   KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
@@ -121,6 +312,34 @@ static PetscErrorCode KSPChebyshevEstEigSetUseNoisy_Chebyshev(KSP ksp, PetscBool
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode KSPChebyshevEstEigSetUseCache_Chebyshev(KSP ksp, PetscBool use)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+
+  PetscFunctionBegin;
+  cheb->usecache = use;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPChebyshevSetFused_Chebyshev(KSP ksp, PetscBool fused)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+
+  PetscFunctionBegin;
+  cheb->fused = fused;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPChebyshevEstEigSetRefresh_Chebyshev(KSP ksp, PetscInt refresh)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(refresh >= 0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Number of power iterations %" PetscInt_FMT " must be nonnegative", refresh);
+  cheb->refresh = refresh;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode KSPChebyshevSetKind_Chebyshev(KSP ksp, KSPChebyshevKind kind)
 {
   KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
@@ -249,6 +468,107 @@ PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP ksp, PetscBool use)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  KSPChebyshevEstEigSetUseCache - share the estimates of the extreme eigenvalues with the other `KSPCHEBYSHEV` through the preconditioning matrix
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - linear solver context
+- use - `PETSC_TRUE` to use the estimates cached on the preconditioning matrix
+
+  Options Database Key:
+. -ksp_chebyshev_esteig_cache (true|false) - Use the estimates cached on the matrix
+
+  Level: advanced
+
+  Notes:
+  The estimates are cached on the preconditioning matrix, keyed by the operator, the type of the preconditioner, and the states of
+  the matrices, so that a `KSPCHEBYSHEV` with the same operators and the same type of preconditioner, for example a smoother of a
+  `PCMG` or `PCGAMG` that is set up again, does not run the eigenvalue estimator. The estimates are only shared between `KSPCHEBYSHEV`
+  using the same estimator `KSP` with the same number of steps and a noisy right-hand side, see `KSPChebyshevEstEigSetUseNoisy()`.
+
+  This is off by default. The preconditioners are only compared by type, not by their parameters, so it must only be turned on
+  for `KSPCHEBYSHEV` whose preconditioners are configured identically, for example not for the down and up smoothers of a `PCMG` level
+  with different `PCSOR` or `PCJACOBI` options.
+
+.seealso: [](ch_ksp), `KSPCHEBYSHEV`, `KSPChebyshevEstEigSet()`, `KSPChebyshevEstEigSetRefresh()`
+@*/
+PetscErrorCode KSPChebyshevEstEigSetUseCache(KSP ksp, PetscBool use)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(ksp, use, 2);
+  PetscTryMethod(ksp, "KSPChebyshevEstEigSetUseCache_C", (KSP, PetscBool), (ksp, use));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPChebyshevSetFused - compute the residual, apply the inverse diagonal of `PCJACOBI` and update the iterates in a single sweep over
+  the matrix and the vectors
+
+  Logically Collective
+
+  Input Parameters:
++ ksp   - linear solver context
+- fused - `PETSC_TRUE` to use the fused sweep when possible
+
+  Options Database Key:
+. -ksp_chebyshev_fused (true|false) - Use the fused sweep
+
+  Level: advanced
+
+  Notes:
+  The fused sweep is only used with `PCJACOBI`, a `MATSEQAIJ` or `MATMPIAIJ` operator, and `KSP_NORM_NONE`, the usual setting for a
+  smoother, otherwise the separate `MatMult()`, `PCApply()` and vector operations are used. The arithmetic is the same, only the number
+  of passes over memory is reduced. The inverse diagonal is the one of the `PCJACOBI`, so all its `PCJacobiType` and options are honored.
+
+  This is off by default.
+
+.seealso: [](ch_ksp), `KSPCHEBYSHEV`, `PCJACOBI`, `KSPSetNormType()`
+@*/
+PetscErrorCode KSPChebyshevSetFused(KSP ksp, PetscBool fused)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(ksp, fused, 2);
+  PetscTryMethod(ksp, "KSPChebyshevSetFused_C", (KSP, PetscBool), (ksp, fused));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPChebyshevEstEigSetRefresh - refresh the estimates of the extreme eigenvalues cached on the preconditioning matrix with a few power
+  iterations when only the values of the matrices changed, instead of running the eigenvalue estimator
+
+  Logically Collective
+
+  Input Parameters:
++ ksp     - linear solver context
+- refresh - number of power iterations, 0 to always run the eigenvalue estimator when the matrices changed
+
+  Options Database Key:
+. -ksp_chebyshev_esteig_refresh refresh - Number of power iterations
+
+  Level: advanced
+
+  Notes:
+  This is useful when the operators of the smoothers of a multigrid method are recomputed with the same nonzero pattern, for example
+  in a nonlinear or time-dependent solve. The estimate of the largest eigenvalue is refreshed with `refresh` iterations of the power
+  method, started from the last power iterate, and the estimate of the smallest eigenvalue is scaled accordingly.
+
+  This requires `KSPChebyshevEstEigSetUseCache()`. The default is 0.
+
+.seealso: [](ch_ksp), `KSPCHEBYSHEV`, `KSPChebyshevEstEigSet()`, `KSPChebyshevEstEigSetUseCache()`
+@*/
+PetscErrorCode KSPChebyshevEstEigSetRefresh(KSP ksp, PetscInt refresh)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, refresh, 2);
+  PetscTryMethod(ksp, "KSPChebyshevEstEigSetRefresh_C", (KSP, PetscInt), (ksp, refresh));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   KSPChebyshevEstEigGetKSP - Get the Krylov method context used to estimate the eigenvalues for the Chebyshev method.
 
@@ -374,26 +694,59 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(KSP ksp, PetscOptionItems Pets
 
   cheb->chebykind = KSP_CHEBYSHEV_FIRST; /* Default to 1st-kind Chebyshev polynomial */
   PetscCall(PetscOptionsEnum("-ksp_chebyshev_kind", "Type of Chebyshev polynomial", "KSPChebyshevKind", KSPChebyshevKinds, (PetscEnum)cheb->chebykind, (PetscEnum *)&cheb->chebykind, NULL));
+  PetscCall(PetscOptionsBool("-ksp_chebyshev_fused", "Apply the matrix, PCJACOBI and the vector updates in a single sweep", "KSPChebyshevSetFused", cheb->fused, &cheb->fused, NULL));
 
   /* We need to estimate eigenvalues; need to set this here so that KSPSetFromOptions() is called on the estimator */
   if ((cheb->emin == 0. || cheb->emax == 0.) && !cheb->kspest) PetscCall(KSPChebyshevEstEigSet(ksp, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE));
 
   if (cheb->kspest) {
     PetscCall(PetscOptionsBool("-ksp_chebyshev_esteig_noisy", "Use noisy random number generated right-hand side for estimate", "KSPChebyshevEstEigSetUseNoisy", cheb->usenoisy, &cheb->usenoisy, NULL));
+    PetscCall(PetscOptionsBool("-ksp_chebyshev_esteig_cache", "Use the estimates cached on the matrix", "KSPChebyshevEstEigSetUseCache", cheb->usecache, &cheb->usecache, NULL));
+    PetscCall(PetscOptionsInt("-ksp_chebyshev_esteig_refresh", "Number of power iterations refreshing the cached estimates", "KSPChebyshevEstEigSetRefresh", cheb->refresh, &cheb->refresh, NULL));
     PetscCall(KSPSetFromOptions(cheb->kspest));
   }
   PetscOptionsHeadEnd();
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+typedef PetscErrorCode (*MatJacobiPolynomialUpdateFn)(Mat, Vec, Vec, Vec, Vec, PetscScalar, Vec, PetscScalar, PetscScalar, Vec, PetscScalar, Vec);
+
+/*
+   Returns the kernel of the operator that, in one sweep, computes r = s - A v, z = alpha w + beta v + gamma D^{-1} r and x = x + delta z,
+   and the inverse diagonal D^{-1} of PCJACOBI, or NULL when the iteration needs the separate MatMult(), PCApply() and vector updates.
+   D^{-1} is the vector PCJACOBI itself applies, not a copy, so it follows every change of the preconditioner.
+*/
+static PetscErrorCode KSPChebyshevGetFusedUpdate_Private(KSP ksp, MatJacobiPolynomialUpdateFn *update, Vec *dinv)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
+  Mat            Amat;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  *update = NULL;
+  *dinv   = NULL;
+  if (!cheb->fused || ksp->normtype != KSP_NORM_NONE || ksp->transpose_solve) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp->pc, PCJACOBI, &flg));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+  /* the kernels work on the host arrays, do not use them for the device subclasses */
+  PetscCall(PetscObjectTypeCompareAny((PetscObject)Amat, &flg, MATSEQAIJ, MATMPIAIJ, ""));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectQueryFunction((PetscObject)Amat, "MatJacobiPolynomialUpdate_C", update));
+  if (!*update) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PCJacobiGetDiagonalRead_Private(ksp->pc, dinv));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode KSPSolve_Chebyshev_FirstKind(KSP ksp)
 {
-  PetscInt    k, kp1, km1, ktmp, i;
-  PetscScalar alpha, omegaprod, mu, omega, Gamma, c[3], scale;
-  PetscReal   rnorm = 0.0, emax, emin;
-  Vec         sol_orig, b, p[3], r;
-  Mat         Amat, Pmat;
-  PetscBool   diagonalscale;
+  PetscInt                    k, kp1, km1, ktmp, i;
+  PetscScalar                 alpha, omegaprod, mu, omega, Gamma, c[3], scale;
+  PetscReal                   rnorm = 0.0, emax, emin;
+  Vec                         sol_orig, b, p[3], r, dinv;
+  Mat                         Amat, Pmat;
+  PetscBool                   diagonalscale;
+  MatJacobiPolynomialUpdateFn update;
 
   PetscFunctionBegin;
   PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
@@ -466,12 +819,29 @@ static PetscErrorCode KSPSolve_Chebyshev_FirstKind(KSP ksp)
   PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
   ksp->its = 1;
   PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPChebyshevGetFusedUpdate_Private(ksp, &update, &dinv));
 
   for (i = 1; i < ksp->max_it; i++) {
     PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
     ksp->its++;
     PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
 
+    if (update) {
+      c[kp1] = 2.0 * mu * c[k] - c[km1];
+      omega  = omegaprod * c[k] / c[kp1];
+
+      /* r = b - Ap[k], p[kp1] = omega(p[k] - p[km1] + Gamma*scale*B^{-1}r) + p[km1] in one sweep */
+      PetscCall((*update)(Amat, dinv, p[k], b, r, 1.0 - omega, p[km1], omega, omega * Gamma * scale, p[kp1], 0.0, NULL));
+      ksp->vec_sol = p[k];
+      PetscCall(KSPLogErrorHistory(ksp));
+
+      ktmp = km1;
+      km1  = k;
+      k    = kp1;
+      kp1  = ktmp;
+      continue;
+    }
+
     PetscCall(KSP_MatMult(ksp, Amat, p[k], r)); /*  r = b - Ap[k]    */
     PetscCall(VecAYPX(r, -1.0, b));
     /* calculate residual norm if requested */
@@ -556,14 +926,15 @@ static PetscErrorCode KSPSolve_Chebyshev_FirstKind(KSP ksp)
 
 static PetscErrorCode KSPSolve_Chebyshev_FourthKind(KSP ksp)
 {
-  KSP_Chebyshev *cheb = (KSP_Chebyshev *)ksp->data;
-  PetscInt       i;
-  PetscScalar    scale, rScale, dScale;
-  PetscReal      rnorm = 0.0, emax, emin;
-  Vec            x, b, d, r, Br;
-  Mat            Amat, Pmat;
-  PetscBool      diagonalscale;
-  PetscReal     *betas = cheb->betas;
+  KSP_Chebyshev              *cheb = (KSP_Chebyshev *)ksp->data;
+  PetscInt                    i;
+  PetscScalar                 scale, rScale, dScale;
+  PetscReal                   rnorm = 0.0, emax, emin;
+  Vec                         x, b, d, r, Br, dinv;
+  Mat                         Amat, Pmat;
+  PetscBool                   diagonalscale;
+  PetscReal                  *betas = cheb->betas;
+  MatJacobiPolynomialUpdateFn update;
 
   PetscFunctionBegin;
   PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
@@ -622,6 +993,32 @@ static PetscErrorCode KSPSolve_Chebyshev_FourthKind(KSP ksp)
   PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
   ksp->its = 1;
   PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPChebyshevGetFusedUpdate_Private(ksp, &update, &dinv));
+
+  if (update && ksp->nwork > 3) {
+    Vec dn = ksp->work[3], tmp;
+
+    /* the solution is updated with each new direction in the same sweep, beginning with the first one */
+    PetscCall(VecAXPBY(x, betas[0], 1.0, d));
+    for (i = 1; i < ksp->max_it; i++) {
+      PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+      ksp->its++;
+      PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+      rScale = scale * (8.0 * i + 4.0) / (2.0 * i + 3.0);
+      dScale = (2.0 * i - 1.0) / (2.0 * i + 3.0);
+
+      /* r = r - Ad, d_k+1 = \dfrac{2k-1}{2k+3} d_k + \dfrac{8k+4}{2k+3} \dfrac{1}{\rho(SA)} Br, x = x + \beta_k+1 d_k+1 in one sweep */
+      PetscCall((*update)(Amat, dinv, d, r, r, 0.0, NULL, dScale, rScale, dn, betas[i], x));
+      PetscCall(KSPLogErrorHistory(ksp));
+      tmp = d;
+      d   = dn;
+      dn  = tmp;
+    }
+    ksp->reason = KSP_CONVERGED_ITS;
+    PetscCall(KSPLogErrorHistory(ksp));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
 
   for (i = 1; i < ksp->max_it; i++) {
     PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
@@ -733,10 +1130,14 @@ static PetscErrorCode KSPView_Chebyshev(KSP ksp, PetscViewer viewer)
     if (cheb->kspest) {
       PetscCall(PetscViewerASCIIPrintf(viewer, "  eigenvalues estimated via %s: min %g, max %g\n", ((PetscObject)cheb->kspest)->type_name, (double)cheb->emin_computed, (double)cheb->emax_computed));
       PetscCall(PetscViewerASCIIPrintf(viewer, "  eigenvalues estimated using %s with transform: [%g %g; %g %g]\n", ((PetscObject)cheb->kspest)->type_name, (double)cheb->tform[0], (double)cheb->tform[1], (double)cheb->tform[2], (double)cheb->tform[3]));
-      PetscCall(PetscViewerASCIIPushTab(viewer));
-      PetscCall(KSPView(cheb->kspest, viewer));
-      PetscCall(PetscViewerASCIIPopTab(viewer));
+      if (cheb->fromcache) PetscCall(PetscViewerASCIIPrintf(viewer, "  eigenvalue estimates taken from the cache of the preconditioning matrix, the estimator was not run\n"));
+      else {
+        PetscCall(PetscViewerASCIIPushTab(viewer));
+        PetscCall(KSPView(cheb->kspest, viewer));
+        PetscCall(PetscViewerASCIIPopTab(viewer));
+      }
       if (cheb->usenoisy) PetscCall(PetscViewerASCIIPrintf(viewer, "  estimating eigenvalues using a noisy random number generated right-hand side\n"));
+      if (cheb->usecache && cheb->refresh) PetscCall(PetscViewerASCIIPrintf(viewer, "  refreshing the estimates cached on the matrix with %" PetscInt_FMT " power iterations\n", cheb->refresh));
     } else if (cheb->emax_provided != 0.) {
       PetscCall(PetscViewerASCIIPrintf(viewer, "  eigenvalues provided (min %g, max %g) with transform: [%g %g; %g %g]\n", (double)cheb->emin_provided, (double)cheb->emax_provided, (double)cheb->tform[0], (double)cheb->tform[1], (double)cheb->tform[2],
                                        (double)cheb->tform[3]));
@@ -776,7 +1177,7 @@ static PetscErrorCode KSPSetUp_Chebyshev(KSP ksp)
   // coefficients for optimized 4th-kind Chebyshev
   if (cheb->chebykind == KSP_CHEBYSHEV_OPT_FOURTH) PetscCall(KSPChebyshevGetBetas_Private(ksp));
 
-  PetscCall(KSPSetWorkVecs(ksp, 3));
+  PetscCall(KSPSetWorkVecs(ksp, cheb->fused && cheb->chebykind != KSP_CHEBYSHEV_FIRST ? 4 : 3));
   if (cheb->emin == 0. || cheb->emax == 0.) { // User did not specify eigenvalues
     PC pc;
 
@@ -807,47 +1208,53 @@ static PetscErrorCode KSPSetUp_Chebyshev(KSP ksp)
       PetscReal          max = 0.0, min = 0.0;
       Vec                B;
       KSPConvergedReason reason;
+      PetscBool          found;
 
-      PetscCall(KSPSetPC(cheb->kspest, ksp->pc));
-      if (cheb->usenoisy) {
-        B = ksp->work[1];
-        PetscCall(KSPSetNoisy_Private(Amat, B));
-      } else {
-        PetscBool change;
-
-        PetscCheck(ksp->vec_rhs, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Chebyshev must use a noisy random number generated right-hand side to estimate the eigenvalues when no right-hand side is available");
-        PetscCall(PCPreSolveChangeRHS(ksp->pc, &change));
-        if (change) {
+      PetscCall(KSPChebyshevCacheLookup_Private(ksp, &found));
+      cheb->fromcache = found;
+      if (!found) {
+        PetscCall(KSPSetPC(cheb->kspest, ksp->pc));
+        if (cheb->usenoisy) {
           B = ksp->work[1];
-          PetscCall(VecCopy(ksp->vec_rhs, B));
-        } else B = ksp->vec_rhs;
+          PetscCall(KSPSetNoisy_Private(Amat, B));
+        } else {
+          PetscBool change;
+
+          PetscCheck(ksp->vec_rhs, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Chebyshev must use a noisy random number generated right-hand side to estimate the eigenvalues when no right-hand side is available");
+          PetscCall(PCPreSolveChangeRHS(ksp->pc, &change));
+          if (change) {
+            B = ksp->work[1];
+            PetscCall(VecCopy(ksp->vec_rhs, B));
+          } else B = ksp->vec_rhs;
+        }
+        if (ksp->setfromoptionscalled && !cheb->kspest->setfromoptionscalled) PetscCall(KSPSetFromOptions(cheb->kspest));
+        PetscCall(KSPSolve(cheb->kspest, B, ksp->work[0]));
+        PetscCall(KSPGetConvergedReason(cheb->kspest, &reason));
+        if (reason == KSP_DIVERGED_ITS) {
+          PetscCall(PetscInfo(ksp, "Eigen estimator ran for prescribed number of iterations\n"));
+        } else if (reason == KSP_DIVERGED_PC_FAILED) {
+          PetscInt       its;
+          PCFailedReason pcreason;
+
+          PetscCall(KSPGetIterationNumber(cheb->kspest, &its));
+          if (ksp->normtype == KSP_NORM_NONE) PetscCall(PCReduceFailedReason(ksp->pc));
+          PetscCall(PCGetFailedReason(ksp->pc, &pcreason));
+          ksp->reason = KSP_DIVERGED_PC_FAILED;
+          PetscCall(PetscInfo(ksp, "Eigen estimator failed: %s %s at iteration %" PetscInt_FMT "\n", KSPConvergedReasons[reason], PCFailedReasons[pcreason], its));
+          PetscFunctionReturn(PETSC_SUCCESS);
+        } else if (reason == KSP_CONVERGED_RTOL || reason == KSP_CONVERGED_ATOL) {
+          PetscCall(PetscInfo(ksp, "Eigen estimator converged prematurely. Should not happen except for small or low rank problem\n"));
+        } else if (reason < 0) {
+          PetscCall(PetscInfo(ksp, "Eigen estimator failed %s, using estimates anyway\n", KSPConvergedReasons[reason]));
+        }
+
+        PetscCall(KSPChebyshevComputeExtremeEigenvalues_Private(cheb->kspest, &min, &max));
+        PetscCall(KSPSetPC(cheb->kspest, NULL));
+
+        cheb->emin_computed = min;
+        cheb->emax_computed = max;
+        PetscCall(KSPChebyshevCacheStore_Private(ksp));
       }
-      if (ksp->setfromoptionscalled && !cheb->kspest->setfromoptionscalled) PetscCall(KSPSetFromOptions(cheb->kspest));
-      PetscCall(KSPSolve(cheb->kspest, B, ksp->work[0]));
-      PetscCall(KSPGetConvergedReason(cheb->kspest, &reason));
-      if (reason == KSP_DIVERGED_ITS) {
-        PetscCall(PetscInfo(ksp, "Eigen estimator ran for prescribed number of iterations\n"));
-      } else if (reason == KSP_DIVERGED_PC_FAILED) {
-        PetscInt       its;
-        PCFailedReason pcreason;
-
-        PetscCall(KSPGetIterationNumber(cheb->kspest, &its));
-        if (ksp->normtype == KSP_NORM_NONE) PetscCall(PCReduceFailedReason(ksp->pc));
-        PetscCall(PCGetFailedReason(ksp->pc, &pcreason));
-        ksp->reason = KSP_DIVERGED_PC_FAILED;
-        PetscCall(PetscInfo(ksp, "Eigen estimator failed: %s %s at iteration %" PetscInt_FMT "\n", KSPConvergedReasons[reason], PCFailedReasons[pcreason], its));
-        PetscFunctionReturn(PETSC_SUCCESS);
-      } else if (reason == KSP_CONVERGED_RTOL || reason == KSP_CONVERGED_ATOL) {
-        PetscCall(PetscInfo(ksp, "Eigen estimator converged prematurely. Should not happen except for small or low rank problem\n"));
-      } else if (reason < 0) {
-        PetscCall(PetscInfo(ksp, "Eigen estimator failed %s, using estimates anyway\n", KSPConvergedReasons[reason]));
-      }
-
-      PetscCall(KSPChebyshevComputeExtremeEigenvalues_Private(cheb->kspest, &min, &max));
-      PetscCall(KSPSetPC(cheb->kspest, NULL));
-
-      cheb->emin_computed = min;
-      cheb->emax_computed = max;
 
       cheb->amatid    = amatid;
       cheb->pmatid    = pmatid;
@@ -869,6 +1276,9 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetEigenvalues_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSet_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetUseNoisy_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetUseCache_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetRefresh_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetFused_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetKind_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevGetKind_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigGetKSP_C", NULL));
@@ -885,7 +1295,13 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 .   -ksp_chebyshev_esteig a,b,c,d        - estimate eigenvalues using a Krylov method, then use this
                                            transform for Chebyshev eigenvalue bounds (`KSPChebyshevEstEigSet()`)
 .   -ksp_chebyshev_esteig_steps          - number of eigenvalue estimation steps
--   -ksp_chebyshev_esteig_noisy          - use a noisy random number generator to create right-hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_noisy          - use a noisy random number generator to create right-hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_cache          - share the eigenvalue estimates through the matrix (`KSPChebyshevEstEigSetUseCache()`)
+.   -ksp_chebyshev_esteig_refresh n      - refresh the cached estimates with `n` power iterations when only the values of the matrices changed
+                                           (`KSPChebyshevEstEigSetRefresh()`)
+.   -ksp_chebyshev_kind <first,fourth,opt_fourth> - the kind of Chebyshev polynomial (`KSPChebyshevSetKind()`)
+-   -ksp_chebyshev_fused <true,false>    - apply the matrix, the preconditioner and the vector updates in a single sweep when possible
+                                           (`KSPChebyshevSetFused()`)
 
    Level: beginner
 
@@ -900,8 +1316,17 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
    By default this uses `KSPGMRES` to estimate the extreme eigenvalues, if the matrix is known to be SPD then it uses `KSPCG` to estimate the eigenvalues.
    See `MatIsSPDKnown()` for how to indicate a `Mat`, matrix is SPD.
 
+   The estimates can be cached on the preconditioning matrix and reused by the other `KSPCHEBYSHEV` with the same operators and the same
+   type of preconditioner, see `KSPChebyshevEstEigSetUseCache()`, and can be refreshed with a few power iterations when only the values
+   of the matrices change, see `KSPChebyshevEstEigSetRefresh()`.
+
+   With `PCJACOBI`, a `MATSEQAIJ` or `MATMPIAIJ` operator and `KSP_NORM_NONE`, the usual setting for a smoother, each iteration can compute
+   the residual, apply the inverse diagonal and update the iterates in a single sweep over the matrix and the vectors instead of
+   separate `MatMult()`, `PCApply()` and vector operations, see `KSPChebyshevSetFused()`.
+
 .seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`,
-          `KSPChebyshevSetEigenvalues()`, `KSPChebyshevEstEigSet()`, `KSPChebyshevEstEigSetUseNoisy()`,
+          `KSPChebyshevSetEigenvalues()`, `KSPChebyshevEstEigSet()`, `KSPChebyshevEstEigSetUseNoisy()`, `KSPChebyshevEstEigSetUseCache()`,
+          `KSPChebyshevEstEigSetRefresh()`, `KSPChebyshevSetFused()`,
           `KSPRICHARDSON`, `KSPCG`, `PCMG`
 M*/
 
@@ -927,6 +1352,8 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   chebyshevP->tform[3] = 1.1;
   chebyshevP->eststeps = 10;
   chebyshevP->usenoisy = PETSC_TRUE;
+  chebyshevP->usecache = PETSC_FALSE;
+  chebyshevP->fused    = PETSC_FALSE;
   ksp->setupnewmatrix  = PETSC_TRUE;
 
   ksp->ops->setup          = KSPSetUp_Chebyshev;
@@ -940,6 +1367,9 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetEigenvalues_C", KSPChebyshevSetEigenvalues_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSet_C", KSPChebyshevEstEigSet_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetUseNoisy_C", KSPChebyshevEstEigSetUseNoisy_Chebyshev));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetUseCache_C", KSPChebyshevEstEigSetUseCache_Chebyshev));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigSetRefresh_C", KSPChebyshevEstEigSetRefresh_Chebyshev));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetFused_C", KSPChebyshevSetFused_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevSetKind_C", KSPChebyshevSetKind_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevGetKind_C", KSPChebyshevGetKind_Chebyshev));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPChebyshevEstEigGetKSP_C", KSPChebyshevEstEigGetKSP_Chebyshev));
@@ -17,7 +17,11 @@ typedef struct {
   PetscReal        tform[4]; /* transform from Krylov estimates to Chebyshev bounds */
   PetscInt         eststeps; /* number of kspest steps in KSP used to estimate eigenvalues */
   PetscBool        usenoisy; /* use noisy right-hand side vector to estimate eigenvalues */
+  PetscBool        usecache;  /* share the estimates through the preconditioning matrix */
+  PetscBool        fromcache; /* the current estimates were taken from the cache, kspest was not run */
+  PetscInt         refresh;  /* number of power iterations refreshing the cached estimates when only the values of the operators changed */
   KSPChebyshevKind chebykind;
+  PetscBool        fused; /* apply the matrix, PCJACOBI and the vector updates in a single sweep when possible */
   /* For tracking when to update the eigenvalue estimates */
   PetscObjectId    amatid, pmatid;
   PetscObjectState amatstate, pmatstate;
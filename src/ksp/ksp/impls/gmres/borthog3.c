@@ -0,0 +1,344 @@
+/*
+    Low-synchronization orthogonalization routines of the Hessenberg matrix.
+
+    The normalization of the new Krylov vector VEC_VV(it + 1) is lagged: its norm is first estimated with the Pythagorean
+    identity from the inner products computed in the same global reduction as the projection, and the exact norm is computed
+    in the reduction of the next iteration, which then corrects VEC_VV(it + 1) and the previous column of the Hessenberg
+    matrix. KSPGMRESLowSyncFinalize_Private() does the last correction at the end of a cycle, and the plane rotations are
+    then recomputed by the cycle from the corrected Hessenberg matrix.
+
+    Note that for the complex numbers version, the VecDot() and
+    VecMDot() arguments within the code MUST remain in the order
+    given for correct computation of inner products.
+*/
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+/*
+   Work arrays of the low-synchronization routines: the inner products s of the previous Krylov vector, z of the new one,
+   the new column c of the Hessenberg matrix, and the strictly lower triangular part L of V^H V used by MGS-ICWY
+*/
+static PetscErrorCode KSPGMRESLowSyncGetWork(KSP ksp, PetscBool *flexible, PetscScalar **s, PetscScalar **z, PetscScalar **c, PetscScalar **L)
+{
+  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
+  PetscInt   n     = gmres->max_k + 2;
+  PetscBool  flg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompareAny((PetscObject)ksp, &flg, KSPGMRES, KSPFGMRES, ""));
+  PetscCheck(flg, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Low-synchronization orthogonalizations are only available with %s and %s", KSPGMRES, KSPFGMRES);
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp, KSPFGMRES, flexible));
+  if (!gmres->lowsyncwork) PetscCall(PetscMalloc1(3 * n + n * n, &gmres->lowsyncwork));
+  *s = gmres->lowsyncwork;
+  *z = *s + n;
+  *c = *z + n;
+  *L = *c + n;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Stores the new column of the Hessenberg matrix, and normalizes VEC_VV(it + 1) with the estimate nrm2 of its squared norm.
+   When the estimate suffers from cancellation, the norm is computed with an additional reduction.
+*/
+static PetscErrorCode KSPGMRESLowSyncNormalize(KSP ksp, PetscInt it, const PetscScalar c[], PetscReal nrm2, PetscReal w2)
+{
+  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
+  PetscReal  tt;
+
+  PetscFunctionBegin;
+  for (PetscInt i = 0; i <= it; i++) {
+    *HH(i, it)  = c[i];
+    *HES(i, it) = c[i];
+  }
+  if (nrm2 > PETSC_SQRT_MACHINE_EPSILON * w2) tt = PetscSqrtReal(nrm2);
+  else {
+    PetscCall(PetscInfo(ksp, "Computing the norm of the Krylov vector, estimate %g relative to the norm before the projection %g\n", (double)nrm2, (double)w2));
+    PetscCall(VecNorm(VEC_VV(it + 1), NORM_2, &tt));
+    KSPCheckNorm(ksp, tt);
+    if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (tt > 0.0) PetscCall(VecScale(VEC_VV(it + 1), 1.0 / tt));
+  *HH(it + 1, it)  = tt;
+  *HES(it + 1, it) = tt;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Orthogonalization with a single reduction per iteration: DCGS2 when icwy is false, MGS-ICWY otherwise.
+
+   With DCGS2, the second pass of classical Gram-Schmidt on VEC_VV(it) is delayed to this iteration, s = V(0:it)^H VEC_VV(it).
+   The previous column of the Hessenberg matrix is corrected, and since VEC_VV(it + 1) is the operator applied to VEC_VV(it) before
+   its correction, Op V(0:it) s = V(0:it+1) H s is removed from it, except with KSPFGMRES where the preconditioned vectors are unchanged.
+
+   With MGS-ICWY, VEC_VV(it) is only normalized, s gives the last row of L, and the projection is (I - V (I + L)^{-1} V^H),
+   which is modified Gram-Schmidt written with a single reduction.
+*/
+static PetscErrorCode KSPGMRESOneReduceOrthogonalization(KSP ksp, PetscInt it, PetscBool icwy)
+{
+  KSP_GMRES   *gmres = (KSP_GMRES *)ksp->data;
+  PetscInt     ldl   = gmres->max_k + 2;
+  PetscScalar *s, *z, *c, *L, hv;
+  PetscReal    nrmv = 1.0, nrmw, rho = 1.0, scale, ss, nrm2;
+  PetscBool    flexible;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscCall(KSPGMRESLowSyncGetWork(ksp, &flexible, &s, &z, &c, &L));
+  if (it) {
+    PetscCall(VecMDotBegin(VEC_VV(it), it, &VEC_VV(0), s));
+    PetscCall(VecNormBegin(VEC_VV(it), NORM_2, &nrmv));
+  }
+  PetscCall(VecMDotBegin(VEC_VV(it + 1), it + 1, &VEC_VV(0), z));
+  PetscCall(VecNormBegin(VEC_VV(it + 1), NORM_2, &nrmw));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it + 1))));
+  if (it) {
+    PetscCall(VecMDotEnd(VEC_VV(it), it, &VEC_VV(0), s));
+    PetscCall(VecNormEnd(VEC_VV(it), NORM_2, &nrmv));
+  }
+  PetscCall(VecMDotEnd(VEC_VV(it + 1), it + 1, &VEC_VV(0), z));
+  PetscCall(VecNormEnd(VEC_VV(it + 1), NORM_2, &nrmw));
+  KSPCheckNorm(ksp, nrmw);
+  if (ksp->reason) goto done;
+  for (PetscInt i = 0; i <= it; i++) {
+    KSPCheckDot(ksp, z[i]);
+    if (ksp->reason) goto done;
+  }
+
+  /* delayed normalization, and reorthogonalization with DCGS2, of VEC_VV(it) */
+  if (it) {
+    hv = *HES(it, it - 1);
+    if (!icwy) {
+      ss = 0.0;
+      for (PetscInt i = 0; i < it; i++) ss += PetscRealPart(PetscConj(s[i]) * s[i]);
+      rho = nrmv * nrmv - ss > 0.0 ? PetscSqrtReal(nrmv * nrmv - ss) : nrmv;
+      for (PetscInt i = 0; i < it; i++) c[i] = -s[i] / rho;
+      PetscCall(VecMAXPBY(VEC_VV(it), it, c, 1.0 / rho, &VEC_VV(0)));
+      for (PetscInt i = 0; i < it; i++) {
+        *HES(i, it - 1) += hv * s[i];
+        z[it] -= PetscConj(s[i]) * z[i];
+      }
+    } else {
+      rho = nrmv;
+      PetscCall(VecScale(VEC_VV(it), 1.0 / rho));
+      for (PetscInt i = 0; i < it; i++) L[it + i * ldl] = PetscConj(s[i]) / rho;
+    }
+    z[it] /= rho;
+    *HES(it, it - 1) = hv * rho;
+  }
+
+  /* the operator applied to the corrected VEC_VV(it) is VEC_VV(it + 1) / rho with GMRES */
+  scale = flexible ? 1.0 : 1.0 / rho;
+  for (PetscInt i = 0; i <= it; i++) z[i] *= scale;
+  nrmw *= scale;
+  nrm2 = nrmw * nrmw;
+  if (!icwy) {
+    for (PetscInt i = 0; i <= it; i++) {
+      c[i] = z[i];
+      nrm2 -= PetscRealPart(PetscConj(z[i]) * z[i]);
+    }
+    /* c = z - H s */
+    if (it && !flexible) {
+      for (PetscInt l = 0; l < it; l++)
+        for (PetscInt i = 0; i <= l + 1; i++) c[i] -= scale * *HES(i, l) * s[l];
+    }
+  } else {
+    /* c = (I + L)^{-1} z, and the squared norm of the projection is |w|^2 - 2 Re(z^H c) + c^H (I + L + L^H) c */
+    for (PetscInt i = 0; i <= it; i++) {
+      c[i] = z[i];
+      for (PetscInt k = 0; k < i; k++) c[i] -= L[i + k * ldl] * c[k];
+      nrm2 += PetscRealPart(PetscConj(c[i]) * c[i] - 2.0 * PetscConj(z[i]) * c[i]);
+      for (PetscInt k = 0; k < i; k++) nrm2 += 2.0 * PetscRealPart(PetscConj(c[i]) * L[i + k * ldl] * c[k]);
+    }
+  }
+  for (PetscInt i = 0; i <= it; i++) s[i] = icwy ? -c[i] : -z[i];
+  PetscCall(VecMAXPBY(VEC_VV(it + 1), it + 1, s, scale, &VEC_VV(0)));
+  PetscCall(KSPGMRESLowSyncNormalize(ksp, it, c, nrm2, nrmw * nrmw));
+done:
+  PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGMRESDCGS2Orthogonalization - Orthogonalization routine using classical Gram-Schmidt with a delayed reorthogonalization (DCGS2),
+  with a single global reduction per iteration
+
+  Collective, No Fortran Support
+
+  Input Parameters:
++ ksp - `KSP` object, must be associated with `KSPGMRES` or `KSPFGMRES` Krylov method
+- it  - one less than the current GMRES restart iteration, i.e. the size of the Krylov space
+
+  Options Database Key:
+. -ksp_gmres_dcgs2 - Activates `KSPGMRESDCGS2Orthogonalization()`
+
+  Level: intermediate
+
+  Notes:
+  The second pass of classical Gram-Schmidt on a Krylov vector, and its normalization, are delayed to the next iteration
+  where the inner products they need are computed in the same reduction as the projection of the next Krylov vector
+  {cite}`bielich2022dcgs2`. The norm of the new Krylov vector is first estimated, the exact value is used to correct the
+  Hessenberg matrix in the next iteration, so the residual norms passed to the monitors and to the convergence test are
+  slightly lagged estimates, and the least-squares problem is solved at the end of each cycle with the corrected Hessenberg matrix.
+
+  This has the stability of `KSPGMRESClassicalGramSchmidtOrthogonalization()` with `KSP_GMRES_CGS_REFINE_ALWAYS`
+  with one global reduction per iteration instead of three, and `KSPGMRESSetCGSRefinementType()` has no effect.
+
+.seealso: [](ch_ksp), `KSPGMRESSetOrthogonalization()`, `KSPGMRESClassicalGramSchmidtOrthogonalization()`, `KSPGMRESLaggedCGS2Orthogonalization()`,
+          `KSPGMRESMGSICWYOrthogonalization()`, `KSPGMRESGetOrthogonalization()`
+@*/
+PetscErrorCode KSPGMRESDCGS2Orthogonalization(KSP ksp, PetscInt it)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPGMRESOneReduceOrthogonalization(ksp, it, PETSC_FALSE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGMRESMGSICWYOrthogonalization - Orthogonalization routine using modified Gram-Schmidt in inverse compact WY form (MGS-ICWY),
+  with a single global reduction per iteration
+
+  Collective, No Fortran Support
+
+  Input Parameters:
++ ksp - `KSP` object, must be associated with `KSPGMRES` or `KSPFGMRES` Krylov method
+- it  - one less than the current GMRES restart iteration, i.e. the size of the Krylov space
+
+  Options Database Key:
+. -ksp_gmres_mgs_icwy - Activates `KSPGMRESMGSICWYOrthogonalization()`
+
+  Level: intermediate
+
+  Notes:
+  The projection of modified Gram-Schmidt is written as $I - V (I + L)^{-1} V^H$, where $L$ is the strictly lower triangular part
+  of $V^H V$ {cite}`swirydowicz2021lowsync`. The last row of $L$ and the normalization of the previous Krylov vector are computed in
+  the same reduction as the inner products of the new Krylov vector with the basis. The norm of the new Krylov vector is first
+  estimated, the exact value is used to correct the Hessenberg matrix in the next iteration, see `KSPGMRESDCGS2Orthogonalization()`.
+
+  This has the stability of `KSPGMRESModifiedGramSchmidtOrthogonalization()` with one global reduction per iteration instead of
+  one per Krylov vector.
+
+.seealso: [](ch_ksp), `KSPGMRESSetOrthogonalization()`, `KSPGMRESModifiedGramSchmidtOrthogonalization()`, `KSPGMRESDCGS2Orthogonalization()`,
+          `KSPGMRESLaggedCGS2Orthogonalization()`, `KSPGMRESGetOrthogonalization()`
+@*/
+PetscErrorCode KSPGMRESMGSICWYOrthogonalization(KSP ksp, PetscInt it)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPGMRESOneReduceOrthogonalization(ksp, it, PETSC_TRUE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGMRESLaggedCGS2Orthogonalization - Orthogonalization routine using classical Gram-Schmidt with reorthogonalization (CGS2)
+  and a lagged normalization
+
+  Collective, No Fortran Support
+
+  Input Parameters:
++ ksp - `KSP` object, must be associated with `KSPGMRES` or `KSPFGMRES` Krylov method
+- it  - one less than the current GMRES restart iteration, i.e. the size of the Krylov space
+
+  Options Database Key:
+. -ksp_gmres_lagged_cgs2 - Activates `KSPGMRESLaggedCGS2Orthogonalization()`
+
+  Level: intermediate
+
+  Notes:
+  Both passes of classical Gram-Schmidt are done in the current iteration, the norm of the previous Krylov vector is computed
+  in the reduction of the first pass, and the norm of the new Krylov vector is estimated from the reduction of the second pass,
+  see `KSPGMRESDCGS2Orthogonalization()`. This needs two global reductions per iteration instead of three with
+  `KSPGMRESClassicalGramSchmidtOrthogonalization()` and `KSP_GMRES_CGS_REFINE_ALWAYS`, and unlike
+  `KSPGMRESDCGS2Orthogonalization()` it does not modify a Krylov vector after the operator has been applied to it.
+
+.seealso: [](ch_ksp), `KSPGMRESSetOrthogonalization()`, `KSPGMRESClassicalGramSchmidtOrthogonalization()`, `KSPGMRESDCGS2Orthogonalization()`,
+          `KSPGMRESMGSICWYOrthogonalization()`, `KSPGMRESGetOrthogonalization()`
+@*/
+PetscErrorCode KSPGMRESLaggedCGS2Orthogonalization(KSP ksp, PetscInt it)
+{
+  KSP_GMRES   *gmres = (KSP_GMRES *)ksp->data;
+  PetscScalar *s, *z, *c, *L;
+  PetscReal    nrmv = 1.0, nrmw, rho = 1.0, scale, nrm2;
+  PetscBool    flexible;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscCall(KSPGMRESLowSyncGetWork(ksp, &flexible, &s, &z, &c, &L));
+  if (it) PetscCall(VecNormBegin(VEC_VV(it), NORM_2, &nrmv));
+  PetscCall(VecMDotBegin(VEC_VV(it + 1), it + 1, &VEC_VV(0), z));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it + 1))));
+  if (it) PetscCall(VecNormEnd(VEC_VV(it), NORM_2, &nrmv));
+  PetscCall(VecMDotEnd(VEC_VV(it + 1), it + 1, &VEC_VV(0), z));
+  for (PetscInt i = 0; i <= it; i++) {
+    KSPCheckDot(ksp, z[i]);
+    if (ksp->reason) goto done;
+  }
+  if (it) {
+    rho = nrmv;
+    PetscCall(VecScale(VEC_VV(it), 1.0 / rho));
+    z[it] /= rho;
+    *HES(it, it - 1) *= rho;
+  }
+  scale = flexible ? 1.0 : 1.0 / rho;
+  for (PetscInt i = 0; i <= it; i++) {
+    c[i] = scale * z[i];
+    s[i] = -c[i];
+  }
+  PetscCall(VecMAXPBY(VEC_VV(it + 1), it + 1, s, scale, &VEC_VV(0)));
+
+  /* second pass */
+  PetscCall(VecMDotBegin(VEC_VV(it + 1), it + 1, &VEC_VV(0), z));
+  PetscCall(VecNormBegin(VEC_VV(it + 1), NORM_2, &nrmw));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it + 1))));
+  PetscCall(VecMDotEnd(VEC_VV(it + 1), it + 1, &VEC_VV(0), z));
+  PetscCall(VecNormEnd(VEC_VV(it + 1), NORM_2, &nrmw));
+  KSPCheckNorm(ksp, nrmw);
+  if (ksp->reason) goto done;
+  nrm2 = nrmw * nrmw;
+  for (PetscInt i = 0; i <= it; i++) {
+    c[i] += z[i];
+    s[i] = -z[i];
+    nrm2 -= PetscRealPart(PetscConj(z[i]) * z[i]);
+  }
+  PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, s, &VEC_VV(0)));
+  PetscCall(KSPGMRESLowSyncNormalize(ksp, it, c, nrm2, nrmw * nrmw));
+done:
+  PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   KSPGMRESLowSyncFinalize_Private - completes the normalization, and the reorthogonalization with DCGS2, of the last Krylov
+   vector VEC_VV(it) of a cycle, and corrects the last column of the Hessenberg matrix. The cycle must then recompute the plane rotations.
+*/
+PetscErrorCode KSPGMRESLowSyncFinalize_Private(KSP ksp, PetscInt it, PetscBool hapend)
+{
+  KSP_GMRES   *gmres = (KSP_GMRES *)ksp->data;
+  PetscScalar *s, *z, *c, *L, hv;
+  PetscReal    nrmv, ss = 0.0, rho;
+  PetscBool    flexible, delayed = (PetscBool)(gmres->orthog == KSPGMRESDCGS2Orthogonalization);
+
+  PetscFunctionBegin;
+  if (!it || hapend) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(KSPGMRESLowSyncGetWork(ksp, &flexible, &s, &z, &c, &L));
+  if (delayed) {
+    PetscCall(VecMDotBegin(VEC_VV(it), it, &VEC_VV(0), s));
+    PetscCall(VecNormBegin(VEC_VV(it), NORM_2, &nrmv));
+    PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it))));
+    PetscCall(VecMDotEnd(VEC_VV(it), it, &VEC_VV(0), s));
+    PetscCall(VecNormEnd(VEC_VV(it), NORM_2, &nrmv));
+  } else PetscCall(VecNorm(VEC_VV(it), NORM_2, &nrmv));
+  KSPCheckNorm(ksp, nrmv);
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+  hv = *HES(it, it - 1);
+  if (delayed) {
+    for (PetscInt i = 0; i < it; i++) {
+      *HES(i, it - 1) += hv * s[i];
+      ss += PetscRealPart(PetscConj(s[i]) * s[i]);
+    }
+  }
+  rho = nrmv * nrmv - ss > 0.0 ? PetscSqrtReal(nrmv * nrmv - ss) : nrmv;
+  if (rho > 0.0 && delayed) {
+    for (PetscInt i = 0; i < it; i++) c[i] = -s[i] / rho;
+    PetscCall(VecMAXPBY(VEC_VV(it), it, c, 1.0 / rho, &VEC_VV(0)));
+  } else if (rho > 0.0) PetscCall(VecScale(VEC_VV(it), 1.0 / rho));
+  *HES(it, it - 1) = hv * rho;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
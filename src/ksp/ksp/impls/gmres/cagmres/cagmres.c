@@ -0,0 +1,559 @@
+/*
+    This file implements the communication-avoiding (s-step) GMRES method, see Hoemmen 2010.
+
+    A block of s iterations starts from the last orthonormal vector q_k of the Arnoldi basis Q = [q_0, ..., q_k] and computes,
+    with s applications of the preconditioned operator and no global reduction, the vectors V = [v_1, ..., v_s] of a polynomial
+    basis with Op [q_k, V[0:s-1]] = [q_k, V] B. A single global reduction then gives both the projections C = Q^H V and the Gram
+    matrix V^H V, from which the block is orthogonalized against Q (block classical Gram-Schmidt) and within itself (Cholesky QR
+    of the Gram matrix updated with C^H C). Unless the CGS refinement is turned off, this is done twice (BCGS2 with CholQR2) since
+    a single pass lets Q lose its orthogonality as the method converges. The s new columns of the Hessenberg matrix are recovered
+    from B and the triangular factors, and the least squares problem is updated with the usual Givens rotations.
+*/
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h> /*I  "petscksp.h"  I*/
+#include <petsc/private/kspcaimpl.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  KSPGMRESHEADER
+  KSP_CA       ca;
+  PetscScalar *C;          /* projections and Gram matrix of a block, (max_k+1) x s */
+  PetscScalar *R;          /* Cholesky factors of the Gram matrices of the projected block in the two passes, 2 x s x s */
+  PetscScalar *U;          /* coordinates of [q_k, V] in the new orthonormal basis, (max_k+1) x (s+1) */
+  PetscScalar *M;          /* Op [q_k, V[0:s-1]] in the new orthonormal basis, (max_k+1) x s */
+  PetscScalar *B;          /* change of basis of a block, (s+1) x s */
+  PetscScalar *work;       /* work array of length max_k+1 */
+  PetscScalar *ritz;       /* Hessenberg matrix of the first iterations and the work space of LAPACK, s x s + 5 s, or inverse of R */
+  PetscReal    cond;       /* largest condition number of a block */
+  PetscReal   *re, *im;    /* Ritz values of the first iterations */
+} KSP_CAGMRES;
+
+#define HH(a, b)  (cagmres->hh_origin + (b) * (cagmres->max_k + 2) + (a))
+#define HES(a, b) (cagmres->hes_origin + (b) * (cagmres->max_k + 1) + (a))
+#define CC(a)     (cagmres->cc_origin + (a))
+#define SS(a)     (cagmres->ss_origin + (a))
+#define RS(a)     (cagmres->rs_origin + (a))
+
+#define VEC_OFFSET     2
+#define VEC_TEMP       cagmres->vecs[0]
+#define VEC_TEMP_MATOP cagmres->vecs[1]
+#define VEC_VV(i)      cagmres->vecs[VEC_OFFSET + i]
+
+#define CAGMRES_DEFAULT_MAXK 30
+
+static PetscErrorCode KSPCAGetContext_CAGMRES(KSP ksp, KSP_CA **ca)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  *ca = &cagmres->ca;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetUp_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES   *cagmres = (KSP_CAGMRES *)ksp->data;
+  const PetscInt s = cagmres->ca.s, ld = cagmres->max_k + 1;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetUp_GMRES(ksp));
+  PetscCall(KSPCASetUp_Private(ksp, &cagmres->ca));
+  PetscCall(PetscMalloc7(ld * s, &cagmres->C, 2 * s * s, &cagmres->R, ld * (s + 1), &cagmres->U, ld * s, &cagmres->M, (s + 1) * s, &cagmres->B, ld, &cagmres->work, s * s + 5 * s, &cagmres->ritz));
+  PetscCall(PetscMalloc2(2 * s, &cagmres->re, 2 * s, &cagmres->im));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree7(cagmres->C, cagmres->R, cagmres->U, cagmres->M, cagmres->B, cagmres->work, cagmres->ritz));
+  PetscCall(PetscFree2(cagmres->re, cagmres->im));
+  PetscCall(KSPCAReset_Private(&cagmres->ca));
+  PetscCall(KSPReset_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_CAGMRES(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_CAGMRES(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCAGetContext_C", NULL));
+  PetscCall(KSPDestroy_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_CAGMRES(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetFromOptions_GMRES(ksp, PetscOptionsObject));
+  PetscCall(KSPCASetFromOptions_Private(ksp, &cagmres->ca, PetscOptionsObject));
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP CA-GMRES Options");
+  PetscCall(PetscOptionsReal("-ksp_cagmres_max_condition", "Largest estimated condition number of the basis of a block before it is truncated", "None", cagmres->cond, &cagmres->cond, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_CAGMRES(KSP ksp, PetscViewer viewer)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(KSPView_GMRES(ksp, viewer));
+  PetscCall(KSPCAView_Private(&cagmres->ca, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* applies the previous rotations to the column it of the Hessenberg matrix, saved in HES first, and computes the new one */
+static PetscErrorCode KSPCAGMRESUpdateHessenberg(KSP ksp, PetscInt it, PetscBool *hapend, PetscReal *res)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+  PetscScalar *hh = HH(0, it), *cc = CC(0), *ss = SS(0), *rs = RS(0);
+  PetscReal    hapbnd;
+
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j <= it + 1; j++) *HES(j, it) = hh[j];
+
+  /* check for the happy breakdown */
+  hapbnd = PetscMin(PetscAbsScalar(hh[it + 1] / rs[it]), cagmres->haptol);
+  if (PetscAbsScalar(hh[it + 1]) < hapbnd) {
+    PetscCall(PetscInfo(ksp, "Detected happy breakdown, current hapbnd = %14.12e H(%" PetscInt_FMT ",%" PetscInt_FMT ") = %14.12e\n", (double)hapbnd, it + 1, it, (double)PetscAbsScalar(hh[it + 1])));
+    *hapend = PETSC_TRUE;
+  }
+
+  for (PetscInt j = 0; j < it; j++) {
+    PetscScalar hhj = hh[j];
+    hh[j]           = PetscConj(cc[j]) * hhj + ss[j] * hh[j + 1];
+    hh[j + 1]       = -ss[j] * hhj + cc[j] * hh[j + 1];
+  }
+
+  if (!*hapend) {
+    PetscReal delta = PetscSqrtReal(PetscSqr(PetscAbsScalar(hh[it])) + PetscSqr(PetscAbsScalar(hh[it + 1])));
+    if (delta == 0.0) {
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    cc[it]     = hh[it] / delta;
+    ss[it]     = hh[it + 1] / delta;
+    hh[it]     = PetscConj(cc[it]) * hh[it] + ss[it] * hh[it + 1];
+    rs[it + 1] = -ss[it] * rs[it];
+    rs[it]     = PetscConj(cc[it]) * rs[it];
+    *res       = PetscAbsScalar(rs[it + 1]);
+  } else *res = 0.0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCAGMRESBuildSoln(PetscScalar *nrs, Vec vguess, Vec vdest, KSP ksp, PetscInt it)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+  PetscScalar  tt;
+
+  PetscFunctionBegin;
+  if (it < 0) {
+    PetscCall(VecCopy(vguess, vdest));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (*HH(it, it) != 0.0) nrs[it] = *RS(it) / *HH(it, it);
+  else nrs[it] = 0.0;
+  for (PetscInt k = it - 1; k >= 0; k--) {
+    tt = *RS(k);
+    for (PetscInt j = k + 1; j <= it; j++) tt -= *HH(k, j) * nrs[j];
+    nrs[k] = tt / *HH(k, k);
+  }
+  PetscCall(VecMAXPBY(VEC_TEMP, it + 1, nrs, 0, &VEC_VV(0)));
+  PetscCall(KSPUnwindPreconditioner(ksp, VEC_TEMP, VEC_TEMP_MATOP));
+  if (vdest == vguess) PetscCall(VecAXPY(vdest, 1.0, VEC_TEMP));
+  else PetscCall(VecWAXPY(vdest, 1.0, VEC_TEMP, vguess));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* one iteration of the standard Arnoldi process, computes the column it of the Hessenberg matrix */
+static PetscErrorCode KSPCAGMRESStandardStep(KSP ksp, PetscInt it)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+  PetscReal    tt;
+
+  PetscFunctionBegin;
+  PetscCall(KSP_PCApplyBAorAB(ksp, VEC_VV(it), VEC_VV(it + 1), VEC_TEMP_MATOP));
+  PetscCall((*cagmres->orthog)(ksp, it));
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(VecNormalize(VEC_VV(it + 1), &tt));
+  KSPCheckNorm(ksp, tt);
+  *HH(it + 1, it) = tt;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the Ritz values are the eigenvalues of the Hessenberg matrix of the first n iterations */
+static PetscErrorCode KSPCAGMRESSetRitzValues(KSP ksp, PetscInt n)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+  PetscScalar *H = cagmres->ritz, *work = H + n * n, sdummy = 0;
+  PetscBLASInt bn, lwork, idummy = 1;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(5 * n, &lwork));
+  for (PetscInt j = 0; j < n; j++)
+    for (PetscInt i = 0; i < n; i++) H[i + j * n] = *HES(i, j);
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if !PetscDefined(USE_COMPLEX)
+  PetscCallLAPACKInfo("LAPACKgeev", LAPACKgeev_("N", "N", &bn, H, &bn, cagmres->re, cagmres->im, &sdummy, &idummy, &sdummy, &idummy, work, &lwork, &info));
+#else
+  {
+    PetscScalar *eigs;
+
+    PetscCall(PetscMalloc1(n, &eigs));
+    PetscCallLAPACKInfo("LAPACKgeev", LAPACKgeev_("N", "N", &bn, H, &bn, eigs, &sdummy, &idummy, &sdummy, &idummy, work, &lwork, cagmres->re, &info));
+    for (PetscInt i = 0; i < n; i++) {
+      cagmres->re[i] = PetscRealPart(eigs[i]);
+      cagmres->im[i] = PetscImaginaryPart(eigs[i]);
+    }
+    PetscCall(PetscFree(eigs));
+  }
+#endif
+  PetscCall(PetscFPTrapPop());
+  PetscCall(KSPCASetRitzValues_Private(ksp, &cagmres->ca, n, cagmres->re, cagmres->im));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  Orthogonalizes the n vectors following q_k against Q = [q_0, ..., q_k] (block classical Gram-Schmidt) and among themselves
+  (Cholesky QR) with a single global reduction, [q_{k+1}, ..., q_{k+rank}] = (V - Q C) R^{-1}. The Gram matrix of the projected
+  vectors is V^H V - C^H C. The block is truncated to its first rank vectors where the condition number of V with normalized
+  columns, estimated from R, gets too large.
+*/
+static PetscErrorCode KSPCAGMRESOrthogonalizeBlock(KSP ksp, PetscInt k, PetscInt n, PetscScalar C[], PetscScalar R[], PetscInt *rank)
+{
+  KSP_CAGMRES   *cagmres = (KSP_CAGMRES *)ksp->data;
+  const PetscInt s = cagmres->ca.s, ld = cagmres->max_k + 1;
+  PetscScalar   *Rinv = cagmres->ritz, *work = cagmres->work;
+  PetscReal      nrm = 0.0, nrminv = 0.0;
+  PetscBLASInt   bn, bs, info;
+
+  PetscFunctionBegin;
+  /* C[:, j] = [q_0, ..., q_k, v_1, ..., v_{j+1}]^H v_{j+1} */
+  for (PetscInt j = 0; j < n; j++) PetscCall(VecMDotBegin(VEC_VV(k + 1 + j), k + j + 2, &VEC_VV(0), C + j * ld));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(0))));
+  for (PetscInt j = 0; j < n; j++) PetscCall(VecMDotEnd(VEC_VV(k + 1 + j), k + j + 2, &VEC_VV(0), C + j * ld));
+
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt i = 0; i <= k; i++) work[i] = -C[i + j * ld];
+    PetscCall(VecMAXPY(VEC_VV(k + 1 + j), k + 1, work, &VEC_VV(0)));
+    for (PetscInt i = 0; i <= j; i++) {
+      PetscScalar g = C[k + 1 + i + j * ld];
+
+      for (PetscInt l = 0; l <= k; l++) g -= PetscConj(C[l + i * ld]) * C[l + j * ld];
+      R[i + j * s] = g;
+    }
+  }
+
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(s, &bs));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKpotrf", LAPACKpotrf_("U", &bn, R, &bs, &info));
+  PetscCall(PetscFPTrapPop());
+  *rank = info > 0 ? info - 1 : n;
+  for (PetscInt j = 0; j < *rank; j++) {
+    const PetscReal scale = 1.0 / PetscSqrtReal(PetscRealPart(C[k + 1 + j + j * ld]));
+
+    /* Frobenius norms of the leading (j+1) x (j+1) block of the scaled factor T and of its inverse, computed by columns */
+    Rinv[j + j * s] = 1.0 / (R[j + j * s] * scale);
+    for (PetscInt i = j - 1; i >= 0; i--) {
+      PetscScalar t = 0.0;
+
+      for (PetscInt l = i; l < j; l++) t += Rinv[i + l * s] * R[l + j * s];
+      Rinv[i + j * s] = -t * scale * Rinv[j + j * s];
+    }
+    for (PetscInt i = 0; i <= j; i++) {
+      nrm += PetscSqr(PetscAbsScalar(R[i + j * s] * scale));
+      nrminv += PetscSqr(PetscAbsScalar(Rinv[i + j * s]));
+    }
+    if (PetscSqrtReal(nrm * nrminv) > cagmres->cond || PetscAbsScalar(R[j + j * s] * scale) < 1.0 / cagmres->cond) {
+      *rank = j;
+      break;
+    }
+  }
+  for (PetscInt j = 0; j < *rank; j++) {
+    for (PetscInt i = 0; i < j; i++) work[i] = -R[i + j * s];
+    PetscCall(VecMAXPY(VEC_VV(k + 1 + j), j, work, &VEC_VV(k + 1)));
+    PetscCall(VecScale(VEC_VV(k + 1 + j), 1.0 / R[j + j * s]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  Computes and orthogonalizes the next (at most) n vectors of the basis from q_k and fills the corresponding columns of the
+  (unrotated) Hessenberg matrix. On output nb is the number of vectors that could be orthogonalized in a stable way, nb = 0
+  means that the block must be replaced by a standard iteration.
+*/
+static PetscErrorCode KSPCAGMRESBlock(KSP ksp, PetscInt k, PetscInt n, PetscInt *nb)
+{
+  KSP_CAGMRES   *cagmres = (KSP_CAGMRES *)ksp->data;
+  KSP_CA        *ca      = &cagmres->ca;
+  const PetscInt s = ca->s, ld = cagmres->max_k + 1;
+  PetscScalar   *C = cagmres->C, *R = cagmres->R, *U = cagmres->U, *M = cagmres->M, *B = cagmres->B;
+  PetscInt       rank;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCAComputeBasis_Private(ksp, ca, n, &VEC_VV(k), NULL, VEC_TEMP_MATOP));
+  PetscCall(KSPCAGMRESOrthogonalizeBlock(ksp, k, n, C, R, &rank));
+  if (rank && cagmres->cgstype != KSP_GMRES_CGS_REFINE_NEVER) {
+    PetscScalar *C2 = M, *R2 = R + s * s;
+    PetscInt     rank2;
+
+    /* second pass, V = Q C + Y R with Y = (Y1 - Q C2) R2^{-1} gives C = C + C2 R and R = R2 R */
+    PetscCall(KSPCAGMRESOrthogonalizeBlock(ksp, k, rank, C2, R2, &rank2));
+    for (PetscInt j = 0; j < rank2; j++) {
+      for (PetscInt l = 0; l <= j; l++)
+        for (PetscInt i = 0; i <= k; i++) C[i + j * ld] += C2[i + l * ld] * R[l + j * s];
+      for (PetscInt i = 0; i <= j; i++) {
+        PetscScalar t = 0.0;
+
+        for (PetscInt l = i; l <= j; l++) t += R2[i + l * s] * R[l + j * s];
+        R[i + j * s] = t;
+      }
+    }
+    rank = rank2;
+  }
+  if (rank < n) PetscCall(PetscInfo(ksp, "Only %" PetscInt_FMT " of the %" PetscInt_FMT " vectors of the block starting at %" PetscInt_FMT " are kept\n", rank, n, k));
+  *nb = n = rank;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+
+  /* U = [e_k, [C; R]], coordinates of [q_k, V] in the basis [q_0, ..., q_{k+n}] */
+  PetscCall(PetscArrayzero(U, ld * (n + 1)));
+  U[k] = 1.0;
+  for (PetscInt j = 1; j <= n; j++) {
+    for (PetscInt i = 0; i <= k; i++) U[i + j * ld] = C[i + (j - 1) * ld];
+    for (PetscInt i = 0; i < j; i++) U[k + 1 + i + j * ld] = R[i + (j - 1) * s];
+  }
+
+  /* Op V[0:n-1] = Q H U[0:k-1, 0:n-1] + Op [q_k, ..., q_{k+n-1}] U[k:k+n-1, 0:n-1] = Q U B, solved for the new columns of H */
+  PetscCall(KSPCAChangeOfBasis_Private(ca, n, s + 1, B));
+  for (PetscInt j = 0; j < n; j++) {
+    PetscScalar *m = M + j * ld;
+
+    for (PetscInt i = 0; i <= k + n; i++) m[i] = 0.0;
+    for (PetscInt l = PetscMax(j - 1, 0); l <= j + 1; l++) {
+      const PetscScalar b = B[l + j * (s + 1)];
+
+      if (b != 0.0)
+        for (PetscInt i = 0; i <= k + l; i++) m[i] += U[i + l * ld] * b;
+    }
+    for (PetscInt l = 0; l < k; l++) {
+      const PetscScalar u = U[l + j * ld];
+
+      if (u != 0.0)
+        for (PetscInt i = 0; i <= l + 1; i++) m[i] -= *HES(i, l) * u;
+    }
+    for (PetscInt i = 0; i < j; i++) {
+      const PetscScalar u = U[k + i + j * ld];
+
+      for (PetscInt r = 0; r <= k + i + 1; r++) m[r] -= *HH(r, k + i) * u;
+    }
+    for (PetscInt i = 0; i <= k + j + 1; i++) *HH(i, k + j) = m[i] / U[k + j + j * ld];
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCAGMRESCycle(PetscInt *itcount, KSP ksp)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+  KSP_CA      *ca      = &cagmres->ca;
+  PetscReal    res;
+  PetscInt     it = 0, max_k = cagmres->max_k, n, nb = 0;
+  PetscBool    hapend = PETSC_FALSE, needritz, standard = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  PetscCall(VecNormalize(VEC_VV(0), &res));
+  KSPCheckNorm(ksp, res);
+  *RS(0) = cagmres->rnorm0 = res;
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = res;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  cagmres->it = it - 1;
+  PetscCall(KSPLogResidualHistory(ksp, res));
+  PetscCall(KSPMonitor(ksp, ksp->its, res));
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "Converged due to zero residual norm on entry\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+
+  PetscCall(KSPCASetUpShifts_Private(ksp, ca, &needritz));
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    /* the first iterations are performed with the standard method to compute the shifts of the basis */
+    n = PetscMin(PetscMin(ca->s, max_k - it), ksp->max_it - ksp->its);
+    if (cagmres->vv_allocated <= it + n + VEC_OFFSET) PetscCall(KSPGMRESGetNewVectors(ksp, it + n));
+    if (needritz || standard) nb = 0;
+    else {
+      PetscCall(KSPCAGMRESBlock(ksp, it, n, &nb));
+      /* the basis is too ill-conditioned to keep a single vector, the rest of the cycle uses the standard method */
+      standard = nb ? PETSC_FALSE : PETSC_TRUE;
+    }
+    n = nb ? nb : 1;
+    for (PetscInt j = 0; j < n; j++) {
+      if (it) {
+        PetscCall(KSPLogResidualHistory(ksp, res));
+        PetscCall(KSPMonitor(ksp, ksp->its, res));
+      }
+      if (!nb) {
+        cagmres->it = it - 1;
+        PetscCall(KSPCAGMRESStandardStep(ksp, it));
+        if (ksp->reason) break;
+      }
+      PetscCall(KSPCAGMRESUpdateHessenberg(ksp, it, &hapend, &res));
+      it++;
+      cagmres->it = it - 1;
+      ksp->its++;
+      ksp->rnorm = res;
+      if (ksp->reason) break;
+      PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+      if (hapend) {
+        if (ksp->normtype == KSP_NORM_NONE) ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+        else if (!ksp->reason) {
+          PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Reached happy break down, but convergence was not indicated. Residual norm = %g", (double)res);
+          ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        }
+      }
+      if (ksp->reason) break;
+    }
+    if (needritz && (it == ca->s || it == max_k || ksp->reason || ksp->its == ksp->max_it)) {
+      PetscCall(KSPCAGMRESSetRitzValues(ksp, PetscMin(it, ca->s)));
+      needritz = PETSC_FALSE;
+    }
+  }
+
+  if (itcount) *itcount = it;
+  PetscCall(KSPCAGMRESBuildSoln(RS(0), ksp->vec_sol, ksp->vec_sol, ksp, it - 1));
+
+  if (ksp->reason == KSP_CONVERGED_ITERATING && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (it && ksp->reason) {
+    PetscCall(KSPLogResidualHistory(ksp, res));
+    PetscCall(KSPMonitor(ksp, ksp->its, res));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES *cagmres    = (KSP_CAGMRES *)ksp->data;
+  PetscInt     its, itcount = 0;
+  PetscBool    guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  PetscCheck(!ksp->calc_sings || cagmres->Rsvd, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ORDER, "Must call KSPSetComputeSingularValues() before KSPSetUp() is called");
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    PetscCall(KSPInitialResidual(ksp, ksp->vec_sol, VEC_TEMP, VEC_TEMP_MATOP, VEC_VV(0), ksp->vec_rhs));
+    PetscCall(KSPCAGMRESCycle(&its, ksp));
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE;
+  }
+  ksp->guess_zero = guess_zero;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPBuildSolution_CAGMRES(KSP ksp, Vec ptr, Vec *result)
+{
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!cagmres->sol_temp) PetscCall(VecDuplicate(ksp->vec_sol, &cagmres->sol_temp));
+    ptr = cagmres->sol_temp;
+  }
+  if (!cagmres->nrs) PetscCall(PetscMalloc1(cagmres->max_k, &cagmres->nrs));
+  PetscCall(KSPCAGMRESBuildSoln(cagmres->nrs, ksp->vec_sol, ptr, ksp, cagmres->it));
+  if (result) *result = ptr;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPCAGMRES - Implements the communication-avoiding (s-step) Generalized Minimal Residual method {cite}`mohiyuddin2009minimizing`
+
+   Options Database Keys:
++   -ksp_gmres_restart restart                               - the number of Krylov directions to orthogonalize against
+.   -ksp_gmres_haptol tol                                    - sets the tolerance for "happy breakdown" (exact convergence)
+.   -ksp_gmres_cgs_refinement_type (refine_never|refine_ifneeded|refine_always) - orthogonalize each block once or twice (the default)
+.   -ksp_ca_s s                                              - number of iterations per block
+.   -ksp_ca_basis_type (monomial|newton|chebyshev)           - polynomial basis of a block of iterations
+.   -ksp_ca_eigenvalues emin,emax                            - bounds of the (real) spectrum of the preconditioned operator used to build the basis
+.   -ksp_ca_matrix_powers (true|false)                       - compute the basis with the matrix powers kernel, `MATMPIAIJ` with `PCNONE` only
+-   -ksp_cagmres_max_condition cond                          - largest estimated condition number of the basis of a block, the block is truncated beyond
+
+   Level: intermediate
+
+   Notes:
+   Each block of `s` iterations computes `s` vectors of a polynomial basis of the Krylov subspace from the last vector of the Arnoldi
+   basis, with no global reduction, and orthogonalizes them with two global reductions (block classical Gram-Schmidt followed by
+   a Cholesky QR factorization, performed twice for stability), or a single one with `-ksp_gmres_cgs_refinement_type refine_never`.
+   `KSPGMRES` needs `2s` global reductions for the same iterations.
+
+   The default basis is the Newton basis whose shifts are the Leja-ordered Ritz values of the preconditioned operator, computed
+   by the first `s` iterations of the first solve which are performed with the standard method. The monomial basis is only stable
+   for small values of `s`. When the block is too ill-conditioned the last vectors are discarded and recomputed by the next block.
+
+   Developer Note:
+   This object is subclassed off of `KSPGMRES`, see the source code in src/ksp/ksp/impls/gmres for comments on the structure of the code
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPPGMRES`, `KSPCACG`, `KSPCASetStepSize()`, `KSPCASetBasisType()`,
+          `KSPCASetEigenvalues()`, `KSPCASetUseMatrixPowers()`, `KSPGMRESSetRestart()`, `KSPGMRESSetHapTol()`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES *cagmres;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&cagmres));
+  PetscCall(KSPCAInitialize_Private(&cagmres->ca));
+
+  ksp->data                              = (void *)cagmres;
+  ksp->ops->buildsolution                = KSPBuildSolution_CAGMRES;
+  ksp->ops->setup                        = KSPSetUp_CAGMRES;
+  ksp->ops->solve                        = KSPSolve_CAGMRES;
+  ksp->ops->reset                        = KSPReset_CAGMRES;
+  ksp->ops->destroy                      = KSPDestroy_CAGMRES;
+  ksp->ops->view                         = KSPView_CAGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_CAGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetPreAllocateVectors_C", KSPGMRESSetPreAllocateVectors_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetOrthogonalization_C", KSPGMRESSetOrthogonalization_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetOrthogonalization_C", KSPGMRESGetOrthogonalization_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPGMRESSetRestart_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetHapTol_C", KSPGMRESSetHapTol_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", KSPGMRESSetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", KSPGMRESGetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPCAGetContext_C", KSPCAGetContext_CAGMRES));
+
+  cagmres->haptol         = 1.0e-30;
+  cagmres->q_preallocate  = PETSC_TRUE;
+  cagmres->delta_allocate = CAGMRES_DEFAULT_MAXK;
+  cagmres->orthog         = KSPGMRESClassicalGramSchmidtOrthogonalization;
+  cagmres->max_k          = CAGMRES_DEFAULT_MAXK;
+  cagmres->cgstype        = KSP_GMRES_CGS_REFINE_IFNEEDED;
+  cagmres->breakdowntol   = 0.1;
+  cagmres->cond           = 1.0e6;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -80,7 +80,7 @@ static PetscErrorCode KSPFGMRESCycle(PetscInt *itcount, KSP ksp)
 
   /* The first entry in the right-hand side of the Hessenberg system is just
      the initial residual norm */
-  *RS(0) = res_norm;
+  *RS(0) = fgmres->rnorm0 = res_norm;
 
   ksp->rnorm = res_norm;
   PetscCall(KSPLogResidualHistory(ksp, res_norm));
@@ -130,12 +130,15 @@ static PetscErrorCode KSPFGMRESCycle(PetscInt *itcount, KSP ksp)
        VEC_VV(1+loc_it)*/
     PetscCall((*fgmres->orthog)(ksp, loc_it));
 
-    /* new entry in Hessenberg is the 2-norm of our new direction */
-    PetscCall(VecNorm(VEC_VV(loc_it + 1), NORM_2, &tt));
-    KSPCheckNorm(ksp, tt);
+    if (fgmres->lowsync) tt = PetscRealPart(*HES(loc_it + 1, loc_it)); /* already scaled with an estimate of its norm */
+    else {
+      /* new entry in Hessenberg is the 2-norm of our new direction */
+      PetscCall(VecNorm(VEC_VV(loc_it + 1), NORM_2, &tt));
+      KSPCheckNorm(ksp, tt);
 
-    *HH(loc_it + 1, loc_it)  = tt;
-    *HES(loc_it + 1, loc_it) = tt;
+      *HH(loc_it + 1, loc_it)  = tt;
+      *HES(loc_it + 1, loc_it) = tt;
+    }
 
     /* Happy Breakdown Check */
     hapbnd = PetscAbsScalar((tt) / *RS(loc_it));
@@ -143,7 +146,7 @@ static PetscErrorCode KSPFGMRESCycle(PetscInt *itcount, KSP ksp)
     hapbnd = PetscMin(fgmres->haptol, hapbnd);
     if (tt > hapbnd) {
       /* scale new direction by its norm */
-      PetscCall(VecScale(VEC_VV(loc_it + 1), 1.0 / tt));
+      if (!fgmres->lowsync) PetscCall(VecScale(VEC_VV(loc_it + 1), 1.0 / tt));
     } else {
       /* This happens when the solution is exactly reached. */
       /* So there is no new direction... */
@@ -185,6 +188,17 @@ static PetscErrorCode KSPFGMRESCycle(PetscInt *itcount, KSP ksp)
 
   if (itcount) *itcount = loc_it;
 
+  /* the last column of the Hessenberg matrix is only exact once the last Krylov vector is normalized, recompute the rotations */
+  if (fgmres->lowsync && loc_it && ksp->reason >= 0) {
+    PetscCall(KSPGMRESLowSyncFinalize_Private(ksp, loc_it, hapend));
+    *RS(0) = fgmres->rnorm0;
+    for (PetscInt i = 0; i < loc_it && ksp->reason >= 0; i++) {
+      for (PetscInt j = 0; j <= i + 1; j++) *HH(j, i) = *HES(j, i);
+      PetscCall(KSPFGMRESUpdateHessenberg(ksp, i, (PetscBool)(hapend && i == loc_it - 1), &res_norm));
+    }
+    ksp->rnorm = res_norm;
+  }
+
   /*
     Down here we have to solve for the "best" coefficients of the Krylov
     columns, add the solution values together, and possibly unwind the
@@ -495,6 +509,8 @@ static PetscErrorCode KSPGMRESGetRestart_FGMRES(KSP ksp, PetscInt *max_k)
 .   -ksp_gmres_preallocate                                                      - preallocate all the Krylov search directions initially (otherwise groups of vectors are allocated as needed)
 .   -ksp_gmres_classicalgramschmidt                                             - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt                                              - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+.   -ksp_gmres_dcgs2                                                            - use classical Gram-Schmidt with a delayed refinement, one global reduction per iteration
+.   -ksp_gmres_mgs_icwy                                                         - use modified Gram-Schmidt in inverse compact WY form, one global reduction per iteration
 .   -ksp_gmres_cgs_refinement_type (refine_never|refine_ifneeded|refine_always) - determine if iterative refinement is used to increase the
                                                                                   stability of the classical Gram-Schmidt orthogonalization.
 .   -ksp_gmres_krylov_monitor                                                   - plot the Krylov space generated
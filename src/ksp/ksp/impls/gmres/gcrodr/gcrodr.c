@@ -0,0 +1,746 @@
+/*
+    This file implements GCRO-DR, the GCRO method with deflated restarting, see Parks, de Sturler, Mackey, Johnson, and Maiti 2006.
+
+    The recycled subspace is spanned by U, with Op U = C and C^H C = I, where Op is the preconditioned operator. A cycle builds
+    with max_k - k iterations the Arnoldi basis V of the operator (I - C C^H) Op, so that Op [U D, V(0:j-1)] = [C, V(0:j)] G
+    with G = [D, B; 0, H], D = diag(1 / |U|), and B = C^H Op V. Since the residual is orthogonal to C at the beginning of a cycle,
+    the minimal residual solution over range([U V]) is given by the usual least-squares problem of the Hessenberg matrix H,
+    the coefficients of U being -B y. At the end of each cycle, including the last one of a solve, U is replaced by the harmonic
+    Ritz vectors of Op in range([U V]) of smallest magnitude, which are thus recycled by the next solve. When the operators have
+    changed between two solves, C is recomputed from U before the first cycle.
+*/
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h> /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  KSPGMRESHEADER
+  PetscInt         kmax;           /* largest dimension of the recycled subspace, one more for a pair of complex conjugate harmonic Ritz values */
+  PetscInt         k;              /* current dimension of the recycled subspace */
+  Vec             *U, *C;          /* the recycled subspace, Op U = C with C^H C = I */
+  Vec             *Unew, *Cnew;    /* the recycled subspace at the end of the current cycle */
+  Vec             *W;              /* pointers to [C, V] */
+  PetscScalar     *B;              /* C^H Op V, (kmax + 1) x max_k */
+  PetscScalar     *y;              /* coefficients of U in the solution update of the current cycle, without -B y */
+  PetscScalar     *t;              /* work array of length max_k + 1 */
+  PetscScalar     *G, *WV;         /* G and [C, V]^H [U D, V(0:j-1)], (max_k + 1) x max_k */
+  PetscScalar     *F, *M, *P;      /* the matrices of the generalized eigenvalue problem and the eigenvectors, max_k x max_k */
+  PetscScalar     *work, *eig;     /* work space of LAPACK of size 5 max_k and eigenvalues of size 2 max_k */
+  PetscReal       *modul, *nrmu;   /* moduli of the eigenvalues and norms of U */
+  PetscInt        *perm;           /* permutation sorting the eigenvalues */
+  PetscBLASInt    *ipiv;           /* pivots of the LU factorization */
+  PetscObjectId    Aid, Pid;       /* the operators used to compute C */
+  PetscObjectState Astate, Pstate; /* and their states */
+} KSP_GCRODR;
+
+#define HH(a, b)  (gcrodr->hh_origin + (b) * (gcrodr->max_k + 2) + (a))
+#define HES(a, b) (gcrodr->hes_origin + (b) * (gcrodr->max_k + 1) + (a))
+#define CC(a)     (gcrodr->cc_origin + (a))
+#define SS(a)     (gcrodr->ss_origin + (a))
+#define RS(a)     (gcrodr->rs_origin + (a))
+#define BB(a, b)  (gcrodr->B + (b) * (gcrodr->kmax + 1) + (a))
+
+#define VEC_OFFSET     2
+#define VEC_TEMP       gcrodr->vecs[0]
+#define VEC_TEMP_MATOP gcrodr->vecs[1]
+#define VEC_VV(i)      gcrodr->vecs[VEC_OFFSET + i]
+
+#define GCRODR_DEFAULT_MAXK 30
+#define GCRODR_DEFAULT_K    10
+
+static PetscErrorCode KSPSetUp_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt    n = gcrodr->max_k, k = gcrodr->kmax + 1;
+
+  PetscFunctionBegin;
+  PetscCheck(gcrodr->kmax < gcrodr->max_k, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_INCOMP, "The dimension of the recycled subspace %" PetscInt_FMT " must be smaller than the restart %" PetscInt_FMT, gcrodr->kmax, gcrodr->max_k);
+  PetscCall(KSPSetUp_GMRES(ksp));
+  PetscCall(KSPCreateVecs(ksp, k, &gcrodr->U, 0, NULL));
+  PetscCall(KSPCreateVecs(ksp, k, &gcrodr->C, 0, NULL));
+  PetscCall(KSPCreateVecs(ksp, k, &gcrodr->Unew, 0, NULL));
+  PetscCall(KSPCreateVecs(ksp, k, &gcrodr->Cnew, 0, NULL));
+  PetscCall(PetscMalloc1(k + n + 1, &gcrodr->W));
+  PetscCall(PetscMalloc7(k * n, &gcrodr->B, k, &gcrodr->y, n + 1, &gcrodr->t, (n + 1) * n, &gcrodr->G, (n + 1) * n, &gcrodr->WV, n * n, &gcrodr->F, n * n, &gcrodr->M));
+  PetscCall(PetscMalloc7(n * n, &gcrodr->P, 5 * n, &gcrodr->work, 2 * n, &gcrodr->eig, 2 * n, &gcrodr->modul, k, &gcrodr->nrmu, n, &gcrodr->perm, n, &gcrodr->ipiv));
+  gcrodr->k = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (gcrodr->U) {
+    PetscCall(VecDestroyVecs(gcrodr->kmax + 1, &gcrodr->U));
+    PetscCall(VecDestroyVecs(gcrodr->kmax + 1, &gcrodr->C));
+    PetscCall(VecDestroyVecs(gcrodr->kmax + 1, &gcrodr->Unew));
+    PetscCall(VecDestroyVecs(gcrodr->kmax + 1, &gcrodr->Cnew));
+  }
+  PetscCall(PetscFree(gcrodr->W));
+  PetscCall(PetscFree7(gcrodr->B, gcrodr->y, gcrodr->t, gcrodr->G, gcrodr->WV, gcrodr->F, gcrodr->M));
+  PetscCall(PetscFree7(gcrodr->P, gcrodr->work, gcrodr->eig, gcrodr->modul, gcrodr->nrmu, gcrodr->perm, gcrodr->ipiv));
+  gcrodr->k   = 0;
+  gcrodr->Aid = gcrodr->Pid = 0;
+  PetscCall(KSPReset_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_GCRODR(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_GCRODR(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRSetRecycleDimension_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycleDimension_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycledDimension_C", NULL));
+  PetscCall(KSPDestroy_GMRES(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_GCRODR(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt    k      = gcrodr->kmax;
+  PetscBool   flg;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetFromOptions_GMRES(ksp, PetscOptionsObject));
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP GCRO-DR Options");
+  PetscCall(PetscOptionsInt("-ksp_gcrodr_recycle", "Dimension of the recycled subspace", "KSPGCRODRSetRecycleDimension", k, &k, &flg));
+  if (flg) PetscCall(KSPGCRODRSetRecycleDimension(ksp, k));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_GCRODR(KSP ksp, PetscViewer viewer)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscBool   isascii;
+
+  PetscFunctionBegin;
+  PetscCall(KSPView_GMRES(ksp, viewer));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii) PetscCall(PetscViewerASCIIPrintf(viewer, "  recycled subspace of dimension %" PetscInt_FMT " (requested %" PetscInt_FMT ")\n", gcrodr->k, gcrodr->kmax));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   When the operators have changed since C was computed, C = Op U is recomputed and orthonormalized, the same linear combinations
+   being applied to U. The vectors of U that are (numerically) in the span of the previous ones are discarded.
+*/
+static PetscErrorCode KSPGCRODRUpdateOperators(KSP ksp)
+{
+  KSP_GCRODR      *gcrodr = (KSP_GCRODR *)ksp->data;
+  Mat              A, P;
+  PetscObjectState Astate, Pstate;
+  PetscScalar     *r = gcrodr->t;
+  PetscReal        nrm, nrm0;
+  PetscInt         k = 0;
+  Vec              tmp;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &A, &P));
+  PetscCall(PetscObjectStateGet((PetscObject)A, &Astate));
+  PetscCall(PetscObjectStateGet((PetscObject)P, &Pstate));
+  if (((PetscObject)A)->id == gcrodr->Aid && ((PetscObject)P)->id == gcrodr->Pid && Astate == gcrodr->Astate && Pstate == gcrodr->Pstate) PetscFunctionReturn(PETSC_SUCCESS);
+  if (gcrodr->k) PetscCall(PetscInfo(ksp, "Operators have changed, recomputing the image of the recycled subspace of dimension %" PetscInt_FMT "\n", gcrodr->k));
+  for (PetscInt i = 0; i < gcrodr->k; i++) {
+    if (k != i) {
+      tmp          = gcrodr->U[k];
+      gcrodr->U[k] = gcrodr->U[i];
+      gcrodr->U[i] = tmp;
+      tmp          = gcrodr->C[k];
+      gcrodr->C[k] = gcrodr->C[i];
+      gcrodr->C[i] = tmp;
+    }
+    PetscCall(KSP_PCApplyBAorAB(ksp, gcrodr->U[k], gcrodr->C[k], VEC_TEMP_MATOP));
+    PetscCall(VecNorm(gcrodr->C[k], NORM_2, &nrm0));
+    KSPCheckNorm(ksp, nrm0);
+    /* classical Gram-Schmidt with reorthogonalization */
+    for (PetscInt pass = 0; pass < 2 && k; pass++) {
+      PetscCall(VecMDot(gcrodr->C[k], k, gcrodr->C, r));
+      for (PetscInt l = 0; l < k; l++) r[l] = -r[l];
+      PetscCall(VecMAXPY(gcrodr->C[k], k, r, gcrodr->C));
+      PetscCall(VecMAXPY(gcrodr->U[k], k, r, gcrodr->U));
+    }
+    PetscCall(VecNorm(gcrodr->C[k], NORM_2, &nrm));
+    if (nrm <= PETSC_SQRT_MACHINE_EPSILON * nrm0) continue;
+    PetscCall(VecScale(gcrodr->C[k], 1.0 / nrm));
+    PetscCall(VecScale(gcrodr->U[k], 1.0 / nrm));
+    k++;
+  }
+  if (k < gcrodr->k) PetscCall(PetscInfo(ksp, "Discarding %" PetscInt_FMT " linearly dependent vectors of the recycled subspace\n", gcrodr->k - k));
+  gcrodr->k      = k;
+  gcrodr->Aid    = ((PetscObject)A)->id;
+  gcrodr->Pid    = ((PetscObject)P)->id;
+  gcrodr->Astate = Astate;
+  gcrodr->Pstate = Pstate;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Replaces the recycled subspace with the harmonic Ritz vectors of Op in range([U V(0:it-1)]) associated with the harmonic Ritz
+   values of smallest magnitude, i.e., the solutions of G^H G z = theta G^H [C, V]^H [U D, V(0:it-1)] z. With Y the selected
+   eigenvectors and G Y = Q R, the new subspace is U = [U D, V(0:it-1)] Y R^{-1} with C = [C, V(0:it)] Q.
+*/
+static PetscErrorCode KSPGCRODRUpdateRecycledSubspace(KSP ksp, PetscInt it)
+{
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscInt     k = gcrodr->k, n = k + it, ld = gcrodr->max_k + 1, ldn = gcrodr->max_k, kk;
+  PetscScalar *G = gcrodr->G, *WV = gcrodr->WV, *F = gcrodr->F, *M = gcrodr->M, *P = gcrodr->P, *work = gcrodr->work, *tau = gcrodr->t;
+  PetscReal   *modul = gcrodr->modul, *nrmu = gcrodr->nrmu;
+  PetscInt    *perm  = gcrodr->perm;
+  PetscBLASInt bn, bn1, bld, bldn, bkk, lwork, info;
+  Vec         *tmp;
+
+  PetscFunctionBegin;
+  if (!gcrodr->kmax || !it) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt i = 0; i < k; i++) gcrodr->W[i] = gcrodr->C[i];
+  for (PetscInt i = 0; i <= it; i++) gcrodr->W[k + i] = VEC_VV(i);
+
+  /* [C, V]^H U and the norms of U, with a single global reduction */
+  PetscCall(PetscArrayzero(WV, ld * n));
+  for (PetscInt j = 0; j < k; j++) {
+    PetscCall(VecMDotBegin(gcrodr->U[j], n + 1, gcrodr->W, WV + j * ld));
+    PetscCall(VecNormBegin(gcrodr->U[j], NORM_2, nrmu + j));
+  }
+  if (k) PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp)));
+  for (PetscInt j = 0; j < k; j++) {
+    PetscCall(VecMDotEnd(gcrodr->U[j], n + 1, gcrodr->W, WV + j * ld));
+    PetscCall(VecNormEnd(gcrodr->U[j], NORM_2, nrmu + j));
+  }
+
+  /* G = [D, B; 0, H] and [C, V]^H [U D, V(0:it-1)] = [C^H U D, 0; V^H U D, I] */
+  PetscCall(PetscArrayzero(G, ld * n));
+  for (PetscInt j = 0; j < k; j++) {
+    G[j + j * ld] = 1.0 / nrmu[j];
+    for (PetscInt i = 0; i <= n; i++) WV[i + j * ld] /= nrmu[j];
+  }
+  for (PetscInt j = 0; j < it; j++) {
+    for (PetscInt i = 0; i < k; i++) G[i + (k + j) * ld] = *BB(i, j);
+    for (PetscInt i = 0; i <= j + 1; i++) G[k + i + (k + j) * ld] = *HES(i, j);
+    WV[k + j + (k + j) * ld] = 1.0;
+  }
+
+  /* F = G^H G and M = G^H [C, V]^H [U D, V(0:it-1)] */
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt i = 0; i < n; i++) {
+      PetscScalar f = 0.0, m = 0.0;
+
+      for (PetscInt l = 0; l <= n; l++) {
+        f += PetscConj(G[l + i * ld]) * G[l + j * ld];
+        m += PetscConj(G[l + i * ld]) * WV[l + j * ld];
+      }
+      F[i + j * ldn] = f;
+      M[i + j * ldn] = m;
+    }
+  }
+
+  /* F = M^{-1} F, whose eigenvalues are the harmonic Ritz values */
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(n + 1, &bn1));
+  PetscCall(PetscBLASIntCast(ld, &bld));
+  PetscCall(PetscBLASIntCast(ldn, &bldn));
+  PetscCall(PetscBLASIntCast(5 * ldn, &lwork));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKgesv", LAPACKgesv_(&bn, &bn, M, &bldn, gcrodr->ipiv, F, &bldn, &info));
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(info >= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %d", (int)info);
+  if (info) {
+    PetscCall(PetscInfo(ksp, "Singular generalized eigenvalue problem, the recycled subspace is not updated\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  {
+    PetscScalar  sdummy = 0;
+    PetscBLASInt idummy = 1;
+#if PetscDefined(USE_COMPLEX)
+    PetscReal *rwork = modul;
+
+    PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+    PetscCallLAPACKInfo("LAPACKgeev", LAPACKgeev_("N", "V", &bn, F, &bldn, gcrodr->eig, &sdummy, &idummy, P, &bldn, work, &lwork, rwork, &info));
+    PetscCall(PetscFPTrapPop());
+    for (PetscInt i = 0; i < n; i++) modul[i] = PetscAbsScalar(gcrodr->eig[i]);
+#else
+    PetscReal *wr = gcrodr->eig, *wi = gcrodr->eig + ldn;
+
+    PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+    PetscCallLAPACKInfo("LAPACKgeev", LAPACKgeev_("N", "V", &bn, F, &bldn, wr, wi, &sdummy, &idummy, P, &bldn, work, &lwork, &info));
+    PetscCall(PetscFPTrapPop());
+    for (PetscInt i = 0; i < n; i++) modul[i] = PetscSqrtReal(wr[i] * wr[i] + wi[i] * wi[i]);
+#endif
+  }
+  for (PetscInt i = 0; i < n; i++) perm[i] = i;
+  PetscCall(PetscSortRealWithPermutation(n, modul, perm));
+  kk = PetscMin(gcrodr->kmax, n);
+#if !PetscDefined(USE_COMPLEX)
+  {
+    PetscReal *wi = gcrodr->eig + ldn;
+    PetscInt   last = perm[kk - 1], other = wi[last] > 0.0 ? last + 1 : last - 1;
+    PetscBool  found = PETSC_FALSE;
+
+    /* the real and imaginary parts of the eigenvectors of a pair of complex conjugate eigenvalues are both kept, unless a cycle would be empty */
+    if (wi[last] != 0.0 && kk < gcrodr->max_k - 1) {
+      for (PetscInt i = 0; i < kk - 1; i++) found = (PetscBool)(found || perm[i] == other);
+      if (!found) perm[kk++] = other;
+    }
+  }
+#endif
+
+  /* G Y = Q R, and Y R^{-1} */
+  for (PetscInt j = 0; j < kk; j++) {
+    PetscCall(PetscArraycpy(F + j * ldn, P + perm[j] * ldn, n));
+    for (PetscInt i = 0; i <= n; i++) {
+      PetscScalar gy = 0.0;
+
+      for (PetscInt l = 0; l < n; l++) gy += G[i + l * ld] * F[l + j * ldn];
+      WV[i + j * ld] = gy;
+    }
+  }
+  PetscCall(PetscBLASIntCast(kk, &bkk));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallLAPACKInfo("LAPACKgeqrf", LAPACKgeqrf_(&bn1, &bkk, WV, &bld, tau, work, &lwork, &info));
+  for (PetscInt j = 0; j < kk; j++)
+    for (PetscInt i = 0; i <= j; i++) M[i + j * ldn] = WV[i + j * ld];
+  PetscCallLAPACKInfo("LAPACKorgqr", LAPACKorgqr_(&bn1, &bkk, &bkk, WV, &bld, tau, work, &lwork, &info));
+  {
+    PetscScalar one = 1.0;
+
+    PetscCallBLAS("BLAStrsm", BLAStrsm_("R", "U", "N", "N", &bn, &bkk, &one, M, &bldn, F, &bldn));
+  }
+  PetscCall(PetscFPTrapPop());
+
+  /* U = [U D, V(0:it-1)] Y R^{-1} and C = [C, V(0:it)] Q */
+  for (PetscInt j = 0; j < kk; j++) {
+    for (PetscInt i = 0; i < k; i++) F[i + j * ldn] /= nrmu[i];
+    PetscCall(VecMAXPBY(gcrodr->Unew[j], k, F + j * ldn, 0.0, gcrodr->U));
+    PetscCall(VecMAXPY(gcrodr->Unew[j], it, F + k + j * ldn, &VEC_VV(0)));
+    PetscCall(VecMAXPBY(gcrodr->Cnew[j], n + 1, WV + j * ld, 0.0, gcrodr->W));
+  }
+  tmp          = gcrodr->U;
+  gcrodr->U    = gcrodr->Unew;
+  gcrodr->Unew = tmp;
+  tmp          = gcrodr->C;
+  gcrodr->C    = gcrodr->Cnew;
+  gcrodr->Cnew = tmp;
+  gcrodr->k    = kk;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRUpdateHessenberg(KSP ksp, PetscInt it, PetscBool hapend, PetscReal *res)
+{
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscScalar *hh = HH(0, it), *cc = CC(0), *ss = SS(0), *rs = RS(0);
+
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < it; j++) {
+    PetscScalar hhj = hh[j];
+    hh[j]           = PetscConj(cc[j]) * hhj + ss[j] * hh[j + 1];
+    hh[j + 1]       = -ss[j] * hhj + cc[j] * hh[j + 1];
+  }
+  if (!hapend) {
+    PetscReal delta = PetscSqrtReal(PetscSqr(PetscAbsScalar(hh[it])) + PetscSqr(PetscAbsScalar(hh[it + 1])));
+    if (delta == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "tt == 0.0");
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    cc[it]     = hh[it] / delta;
+    ss[it]     = hh[it + 1] / delta;
+    hh[it]     = PetscConj(cc[it]) * hh[it] + ss[it] * hh[it + 1];
+    rs[it + 1] = -ss[it] * rs[it];
+    rs[it]     = PetscConj(cc[it]) * rs[it];
+    *res       = PetscAbsScalar(rs[it + 1]);
+  } else *res = 0.0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the update of the solution is [U, V(0:it)] [y - B nrs; nrs], with nrs the solution of the least-squares problem */
+static PetscErrorCode KSPGCRODRBuildSoln(PetscScalar *nrs, Vec vguess, Vec vdest, KSP ksp, PetscInt it)
+{
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscScalar *yu     = gcrodr->t, tt;
+
+  PetscFunctionBegin;
+  if (it < 0 && !gcrodr->k) {
+    PetscCall(VecCopy(vguess, vdest));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (it >= 0) {
+    if (*HH(it, it) != 0.0) nrs[it] = *RS(it) / *HH(it, it);
+    else nrs[it] = 0.0;
+    for (PetscInt k = it - 1; k >= 0; k--) {
+      tt = *RS(k);
+      for (PetscInt j = k + 1; j <= it; j++) tt -= *HH(k, j) * nrs[j];
+      nrs[k] = tt / *HH(k, k);
+    }
+  }
+  for (PetscInt i = 0; i < gcrodr->k; i++) {
+    yu[i] = gcrodr->y[i];
+    for (PetscInt j = 0; j <= it; j++) yu[i] -= *BB(i, j) * nrs[j];
+  }
+  PetscCall(VecMAXPBY(VEC_TEMP, gcrodr->k, yu, 0.0, gcrodr->U));
+  if (it >= 0) PetscCall(VecMAXPY(VEC_TEMP, it + 1, nrs, &VEC_VV(0)));
+  PetscCall(KSPUnwindPreconditioner(ksp, VEC_TEMP, VEC_TEMP_MATOP));
+  if (vdest == vguess) PetscCall(VecAXPY(vdest, 1.0, VEC_TEMP));
+  else PetscCall(VecWAXPY(vdest, 1.0, VEC_TEMP, vguess));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRCycle(PetscInt *itcount, KSP ksp)
+{
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR *)ksp->data;
+  PetscScalar *t      = gcrodr->t;
+  PetscReal    res, rnorm = 0.0, tt, hapbnd;
+  PetscInt     it = 0, k = gcrodr->k, max_k = gcrodr->max_k - k;
+  PetscBool    hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  /* the residual is projected onto the orthogonal complement of range(C), the solution is updated with U C^H r */
+  if (k) {
+    PetscCall(VecMDotBegin(VEC_VV(0), k, gcrodr->C, gcrodr->y));
+    PetscCall(VecNormBegin(VEC_VV(0), NORM_2, &rnorm));
+    PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(0))));
+    PetscCall(VecMDotEnd(VEC_VV(0), k, gcrodr->C, gcrodr->y));
+    PetscCall(VecNormEnd(VEC_VV(0), NORM_2, &rnorm));
+    for (PetscInt i = 0; i < k; i++) t[i] = -gcrodr->y[i];
+    PetscCall(VecMAXPY(VEC_VV(0), k, t, gcrodr->C));
+  }
+  PetscCall(VecNormalize(VEC_VV(0), &res));
+  KSPCheckNorm(ksp, res);
+  *RS(0) = gcrodr->rnorm0 = res;
+  /* the norm of the residual before its projection is the initial residual norm of the solve */
+  if (!k || ksp->its) rnorm = res;
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = rnorm;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  gcrodr->it = it - 1;
+  PetscCall(KSPLogResidualHistory(ksp, rnorm));
+  PetscCall(KSPLogErrorHistory(ksp));
+  PetscCall(KSPMonitor(ksp, ksp->its, rnorm));
+  if (!rnorm) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "Converged due to zero residual norm on entry\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  /* check for the convergence, the residual may also lie in range(C) */
+  PetscCall((*ksp->converged)(ksp, ksp->its, rnorm, &ksp->reason, ksp->cnvP));
+  if (!res && !ksp->reason) ksp->reason = KSP_CONVERGED_ATOL;
+
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    if (it) {
+      PetscCall(KSPLogResidualHistory(ksp, res));
+      PetscCall(KSPLogErrorHistory(ksp));
+      PetscCall(KSPMonitor(ksp, ksp->its, res));
+    }
+    gcrodr->it = it - 1;
+    if (gcrodr->vv_allocated <= it + VEC_OFFSET + 1) PetscCall(KSPGMRESGetNewVectors(ksp, it + 1));
+    PetscCall(KSP_PCApplyBAorAB(ksp, VEC_VV(it), VEC_VV(it + 1), VEC_TEMP_MATOP));
+
+    /* B(:, it) = C^H Op v_it, the new vector is orthogonalized against C before V */
+    if (k) {
+      PetscCall(VecMDot(VEC_VV(it + 1), k, gcrodr->C, BB(0, it)));
+      for (PetscInt i = 0; i < k; i++) t[i] = -*BB(i, it);
+      PetscCall(VecMAXPY(VEC_VV(it + 1), k, t, gcrodr->C));
+    }
+    PetscCall((*gcrodr->orthog)(ksp, it));
+    if (ksp->reason) break;
+    PetscCall(VecNormalize(VEC_VV(it + 1), &tt));
+    KSPCheckNorm(ksp, tt);
+    *HH(it + 1, it)  = tt;
+    *HES(it + 1, it) = tt;
+
+    /* check for the happy breakdown */
+    hapbnd = PetscMin(PetscAbsScalar(tt / *RS(it)), gcrodr->haptol);
+    if (tt < hapbnd) {
+      PetscCall(PetscInfo(ksp, "Detected happy breakdown, current hapbnd = %14.12e tt = %14.12e\n", (double)hapbnd, (double)tt));
+      hapend = PETSC_TRUE;
+    }
+    PetscCall(KSPGCRODRUpdateHessenberg(ksp, it, hapend, &res));
+
+    it++;
+    gcrodr->it = it - 1;
+    ksp->its++;
+    ksp->rnorm = res;
+    if (ksp->reason) break;
+    PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+    if (hapend) {
+      if (ksp->normtype == KSP_NORM_NONE) ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      else if (!ksp->reason) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Reached happy break down, but convergence was not indicated. Residual norm = %g", (double)res);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        break;
+      }
+    }
+  }
+
+  if (itcount) *itcount = it;
+  PetscCall(KSPGCRODRBuildSoln(RS(0), ksp->vec_sol, ksp->vec_sol, ksp, it - 1));
+
+  if (ksp->reason == KSP_CONVERGED_ITERATING && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (it && ksp->reason) {
+    PetscCall(KSPLogResidualHistory(ksp, res));
+    PetscCall(KSPLogErrorHistory(ksp));
+    PetscCall(KSPMonitor(ksp, ksp->its, res));
+  }
+
+  /* the recycled subspace is updated once the solution of the cycle has been formed and monitored */
+  if (ksp->reason >= 0) PetscCall(KSPGCRODRUpdateRecycledSubspace(ksp, it));
+  PetscCall(PetscArrayzero(gcrodr->y, gcrodr->kmax + 1));
+  gcrodr->it = -1;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr     = (KSP_GCRODR *)ksp->data;
+  PetscInt    its, itcount = 0;
+  PetscBool   guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  PetscCheck(!ksp->calc_sings || gcrodr->Rsvd, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ORDER, "Must call KSPSetComputeSingularValues() before KSPSetUp() is called");
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+  PetscCall(KSPGCRODRUpdateOperators(ksp));
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    PetscCall(KSPInitialResidual(ksp, ksp->vec_sol, VEC_TEMP, VEC_TEMP_MATOP, VEC_VV(0), ksp->vec_rhs));
+    PetscCall(KSPGCRODRCycle(&its, ksp));
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE;
+  }
+  ksp->guess_zero = guess_zero;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPBuildSolution_GCRODR(KSP ksp, Vec ptr, Vec *result)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!gcrodr->sol_temp) PetscCall(VecDuplicate(ksp->vec_sol, &gcrodr->sol_temp));
+    ptr = gcrodr->sol_temp;
+  }
+  if (!gcrodr->nrs) PetscCall(PetscMalloc1(gcrodr->max_k, &gcrodr->nrs));
+  PetscCall(KSPGCRODRBuildSoln(gcrodr->nrs, ksp->vec_sol, ptr, ksp, gcrodr->it));
+  if (result) *result = ptr;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the arrays of GCRODR depend on the restart, they must be freed before KSPSetUp_GCRODR() creates them again */
+static PetscErrorCode KSPGMRESSetRestart_GCRODR(KSP ksp, PetscInt max_k)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (ksp->setupstage && max_k != gcrodr->max_k) {
+    PetscCall(KSPReset_GCRODR(ksp));
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscCall(KSPGMRESSetRestart_GMRES(ksp, max_k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRSetRecycleDimension_GCRODR(KSP ksp, PetscInt k)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(k >= 0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Dimension of the recycled subspace must be nonnegative");
+  if (k != gcrodr->kmax) {
+    /* free the data structures with the current dimension, they are created again by KSPSetUp() */
+    if (ksp->setupstage) {
+      PetscCall(KSPReset_GCRODR(ksp));
+      ksp->setupstage = KSP_SETUP_NEW;
+    }
+    gcrodr->kmax = k;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycleDimension_GCRODR(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  *k = ((KSP_GCRODR *)ksp->data)->kmax;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycledDimension_GCRODR(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  *k = ((KSP_GCRODR *)ksp->data)->k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRSetRecycleDimension - Sets the largest dimension of the subspace recycled by `KSPGCRODR` between its cycles and between
+  consecutive solves
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space context
+- k   - the dimension of the recycled subspace, which must be smaller than the restart
+
+  Options Database Key:
+. -ksp_gcrodr_recycle k - the dimension of the recycled subspace
+
+  Level: intermediate
+
+  Notes:
+  The default is 10. With `k` equal to 0, `KSPGCRODR` is `KSPGMRES`.
+
+  In real arithmetic, the subspace may have dimension `k` + 1 so that the two vectors associated with a pair of complex conjugate
+  harmonic Ritz values are both kept.
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRGetRecycleDimension()`, `KSPGCRODRGetRecycledDimension()`, `KSPGMRESSetRestart()`
+@*/
+PetscErrorCode KSPGCRODRSetRecycleDimension(KSP ksp, PetscInt k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, k, 2);
+  PetscTryMethod(ksp, "KSPGCRODRSetRecycleDimension_C", (KSP, PetscInt), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRGetRecycleDimension - Gets the largest dimension of the subspace recycled by `KSPGCRODR`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space context
+
+  Output Parameter:
+. k - the dimension of the recycled subspace
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRSetRecycleDimension()`, `KSPGCRODRGetRecycledDimension()`
+@*/
+PetscErrorCode KSPGCRODRGetRecycleDimension(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(k, 2);
+  PetscUseMethod(ksp, "KSPGCRODRGetRecycleDimension_C", (KSP, PetscInt *), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRGetRecycledDimension - Gets the dimension of the subspace currently recycled by `KSPGCRODR`, that will be used by the next solve
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space context
+
+  Output Parameter:
+. k - the current dimension of the recycled subspace
+
+  Level: intermediate
+
+  Note:
+  The recycled subspace is discarded by `KSPReset()`, it is kept when the operators are changed with `KSPSetOperators()`.
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRSetRecycleDimension()`, `KSPGCRODRGetRecycleDimension()`
+@*/
+PetscErrorCode KSPGCRODRGetRecycledDimension(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(k, 2);
+  PetscUseMethod(ksp, "KSPGCRODRGetRecycledDimension_C", (KSP, PetscInt *), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPGCRODR - Implements the GCRO method with deflated restarting (GCRO-DR) {cite}`parks2006recycling`, a restarted GMRES that
+   recycles a subspace between its cycles and between consecutive solves
+
+   Options Database Keys:
++   -ksp_gcrodr_recycle k                                                       - the dimension of the recycled subspace, see `KSPGCRODRSetRecycleDimension()`
+.   -ksp_gmres_restart restart                                                  - the dimension of the approximation space of a cycle, including the recycled subspace
+.   -ksp_gmres_haptol tol                                                       - sets the tolerance for "happy breakdown" (exact convergence)
+.   -ksp_gmres_classicalgramschmidt                                             - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
+.   -ksp_gmres_modifiedgramschmidt                                              - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+-   -ksp_gmres_cgs_refinement_type (refine_never|refine_ifneeded|refine_always) - determine if iterative refinement is used to increase the
+                                                                                  stability of the classical Gram-Schmidt orthogonalization.
+
+   Level: intermediate
+
+   Notes:
+   Each cycle performs `restart - k` iterations of GMRES projected onto the orthogonal complement of the image of the recycled subspace,
+   and minimizes the residual over the sum of both subspaces. At the end of each cycle, the recycled subspace is replaced by the harmonic
+   Ritz vectors of the preconditioned operator associated with the harmonic Ritz values of smallest magnitude. It is kept by the
+   `KSP` between calls to `KSPSolve()`, including when the operators are changed with `KSPSetOperators()`, in which case its image
+   is recomputed at the beginning of the next solve with `k` applications of the preconditioned operator. For sequences of linear
+   systems whose operators change slowly, e.g., in Newton's method or time stepping, this can divide the number of iterations
+   by several units compared to `KSPGMRES`.
+
+   The residual norm at the first iteration of a solve is the norm of the initial residual, before its projection which updates
+   the initial guess.
+
+   Left and right preconditioning are supported, but not symmetric preconditioning.
+
+   Developer Note:
+   This object is subclassed off of `KSPGMRES`, see the source code in src/ksp/ksp/impls/gmres for comments on the structure of the code
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPDGMRES`, `KSPLGMRES`, `KSPRCG`, `KSPGCRODRSetRecycleDimension()`,
+          `KSPGCRODRGetRecycledDimension()`, `KSPGMRESSetRestart()`, `KSPGMRESSetHapTol()`, `KSPGuess`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gcrodr;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&gcrodr));
+
+  ksp->data                              = (void *)gcrodr;
+  ksp->ops->buildsolution                = KSPBuildSolution_GCRODR;
+  ksp->ops->setup                        = KSPSetUp_GCRODR;
+  ksp->ops->solve                        = KSPSolve_GCRODR;
+  ksp->ops->reset                        = KSPReset_GCRODR;
+  ksp->ops->destroy                      = KSPDestroy_GCRODR;
+  ksp->ops->view                         = KSPView_GCRODR;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_GCRODR;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetPreAllocateVectors_C", KSPGMRESSetPreAllocateVectors_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetOrthogonalization_C", KSPGMRESSetOrthogonalization_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetOrthogonalization_C", KSPGMRESGetOrthogonalization_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPGMRESSetRestart_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetHapTol_C", KSPGMRESSetHapTol_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", KSPGMRESSetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", KSPGMRESGetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRSetRecycleDimension_C", KSPGCRODRSetRecycleDimension_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycleDimension_C", KSPGCRODRGetRecycleDimension_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycledDimension_C", KSPGCRODRGetRecycledDimension_GCRODR));
+
+  gcrodr->haptol         = 1.0e-30;
+  gcrodr->q_preallocate  = PETSC_TRUE;
+  gcrodr->delta_allocate = GCRODR_DEFAULT_MAXK;
+  gcrodr->orthog         = KSPGMRESClassicalGramSchmidtOrthogonalization;
+  gcrodr->max_k          = GCRODR_DEFAULT_MAXK;
+  gcrodr->cgstype        = KSP_GMRES_CGS_REFINE_IFNEEDED;
+  gcrodr->breakdowntol   = 0.1;
+  gcrodr->kmax           = GCRODR_DEFAULT_K;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
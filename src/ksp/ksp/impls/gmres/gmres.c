@@ -136,13 +136,16 @@ static PetscErrorCode KSPGMRESCycle(PetscInt *itcount, KSP ksp)
     PetscCall((*gmres->orthog)(ksp, it));
     if (ksp->reason) break;
 
-    /* vv(i+1) . vv(i+1) */
-    PetscCall(VecNormalize(VEC_VV(it + 1), &tt));
-    KSPCheckNorm(ksp, tt);
-
-    /* save the magnitude */
-    *HH(it + 1, it)  = tt;
-    *HES(it + 1, it) = tt;
+    if (gmres->lowsync) tt = PetscRealPart(*HES(it + 1, it)); /* already normalized with an estimate of its norm */
+    else {
+      /* vv(i+1) . vv(i+1) */
+      PetscCall(VecNormalize(VEC_VV(it + 1), &tt));
+      KSPCheckNorm(ksp, tt);
+
+      /* save the magnitude */
+      *HH(it + 1, it)  = tt;
+      *HES(it + 1, it) = tt;
+    }
 
     /* check for the happy breakdown */
     hapbnd = PetscAbsScalar(tt / *GRS(it));
@@ -175,6 +178,17 @@ static PetscErrorCode KSPGMRESCycle(PetscInt *itcount, KSP ksp)
 
   if (itcount) *itcount = it;
 
+  /* the last column of the Hessenberg matrix is only exact once the last Krylov vector is normalized, recompute the rotations */
+  if (gmres->lowsync && it && ksp->reason >= 0) {
+    PetscCall(KSPGMRESLowSyncFinalize_Private(ksp, it, hapend));
+    *GRS(0) = gmres->rnorm0;
+    for (PetscInt i = 0; i < it && ksp->reason >= 0; i++) {
+      for (PetscInt j = 0; j <= i + 1; j++) *HH(j, i) = *HES(j, i);
+      PetscCall(KSPGMRESUpdateHessenberg(ksp, i, (PetscBool)(hapend && i == it - 1), &res));
+    }
+    ksp->rnorm = res;
+  }
+
   /*
     Down here we have to solve for the "best" coefficients of the Krylov
     columns, add the solution values together, and possibly unwind the
@@ -259,6 +273,7 @@ PetscErrorCode KSPReset_GMRES(KSP ksp)
   PetscCall(PetscFree(gmres->Rsvd));
   PetscCall(PetscFree(gmres->Dsvd));
   PetscCall(PetscFree(gmres->orthogwork));
+  PetscCall(PetscFree(gmres->lowsyncwork));
 
   gmres->vv_allocated   = 0;
   gmres->vecs_allocated = 0;
@@ -281,6 +296,8 @@ PetscErrorCode KSPDestroy_GMRES(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetBreakdownTolerance_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetMatSolveType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetMatSolveType_C", NULL));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 /*
@@ -462,12 +479,19 @@ PetscErrorCode KSPView_GMRES(KSP ksp, PetscViewer viewer)
     }
   } else if (gmres->orthog == KSPGMRESModifiedGramSchmidtOrthogonalization) {
     cstr = "modified Gram-Schmidt orthogonalization";
+  } else if (gmres->orthog == KSPGMRESLaggedCGS2Orthogonalization) {
+    cstr = "classical (unmodified) Gram-Schmidt orthogonalization with one step of iterative refinement and a lagged normalization";
+  } else if (gmres->orthog == KSPGMRESDCGS2Orthogonalization) {
+    cstr = "classical (unmodified) Gram-Schmidt orthogonalization with a delayed step of iterative refinement (DCGS2)";
+  } else if (gmres->orthog == KSPGMRESMGSICWYOrthogonalization) {
+    cstr = "modified Gram-Schmidt orthogonalization in inverse compact WY form (MGS-ICWY)";
   } else {
     cstr = "unknown orthogonalization";
   }
   if (isascii) {
     PetscCall(PetscViewerASCIIPrintf(viewer, "  restart=%" PetscInt_FMT ", using %s\n", gmres->max_k, cstr));
     PetscCall(PetscViewerASCIIPrintf(viewer, "  happy breakdown tolerance=%g\n", (double)gmres->haptol));
+    if (gmres->matsolvetype != KSP_MATSOLVE_COLUMN) PetscCall(PetscViewerASCIIPrintf(viewer, "  KSPMatSolve() algorithm %s\n", KSPMatSolveTypes[gmres->matsolvetype]));
   } else if (isstring) {
     PetscCall(PetscViewerStringSPrintf(viewer, "%s restart %" PetscInt_FMT, cstr, gmres->max_k));
   }
@@ -517,10 +541,12 @@ PetscErrorCode KSPGMRESMonitorKrylov(KSP ksp, PetscInt its, PetscReal fgnorm, vo
 
 PetscErrorCode KSPSetFromOptions_GMRES(KSP ksp, PetscOptionItems PetscOptionsObject)
 {
-  PetscInt   restart;
-  PetscReal  haptol, breakdowntol;
-  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
-  PetscBool  flg, set;
+  PetscInt        restart;
+  PetscReal       haptol, breakdowntol;
+  KSP_GMRES      *gmres = (KSP_GMRES *)ksp->data;
+  KSPMatSolveType type;
+  PetscBool       flg, set;
+  PetscErrorCode (*f)(KSP, KSPMatSolveType);
 
   PetscFunctionBegin;
   PetscOptionsHeadBegin(PetscOptionsObject, "KSP GMRES Options");
@@ -536,9 +562,21 @@ PetscErrorCode KSPSetFromOptions_GMRES(KSP ksp, PetscOptionItems PetscOptionsObj
   if (set) PetscCall(KSPGMRESSetPreAllocateVectors(ksp));
   PetscCall(PetscOptionsBoolGroupBegin("-ksp_gmres_classicalgramschmidt", "classical (unmodified) Gram-Schmidt (fast)", "KSPGMRESSetOrthogonalization", &flg));
   if (flg) PetscCall(KSPGMRESSetOrthogonalization(ksp, KSPGMRESClassicalGramSchmidtOrthogonalization));
+  PetscCall(PetscOptionsBoolGroup("-ksp_gmres_lagged_cgs2", "classical Gram-Schmidt with refinement and a lagged normalization (two reductions)", "KSPGMRESSetOrthogonalization", &flg));
+  if (flg) PetscCall(KSPGMRESSetOrthogonalization(ksp, KSPGMRESLaggedCGS2Orthogonalization));
+  PetscCall(PetscOptionsBoolGroup("-ksp_gmres_dcgs2", "classical Gram-Schmidt with a delayed refinement (one reduction)", "KSPGMRESSetOrthogonalization", &flg));
+  if (flg) PetscCall(KSPGMRESSetOrthogonalization(ksp, KSPGMRESDCGS2Orthogonalization));
+  PetscCall(PetscOptionsBoolGroup("-ksp_gmres_mgs_icwy", "modified Gram-Schmidt in inverse compact WY form (one reduction)", "KSPGMRESSetOrthogonalization", &flg));
+  if (flg) PetscCall(KSPGMRESSetOrthogonalization(ksp, KSPGMRESMGSICWYOrthogonalization));
   PetscCall(PetscOptionsBoolGroupEnd("-ksp_gmres_modifiedgramschmidt", "modified Gram-Schmidt (slow, more stable)", "KSPGMRESSetOrthogonalization", &flg));
   if (flg) PetscCall(KSPGMRESSetOrthogonalization(ksp, KSPGMRESModifiedGramSchmidtOrthogonalization));
   PetscCall(PetscOptionsEnum("-ksp_gmres_cgs_refinement_type", "Type of iterative refinement for classical (unmodified) Gram-Schmidt", "KSPGMRESSetCGSRefinementType", KSPGMRESCGSRefinementTypes, (PetscEnum)gmres->cgstype, (PetscEnum *)&gmres->cgstype, &flg));
+  /* the types built on KSPGMRES do not implement KSPMatSolve() */
+  PetscCall(PetscObjectQueryFunction((PetscObject)ksp, "KSPGMRESSetMatSolveType_C", &f));
+  if (f) {
+    PetscCall(PetscOptionsEnum("-ksp_gmres_matsolve_type", "Algorithm used by KSPMatSolve()", "KSPGMRESSetMatSolveType", KSPMatSolveTypes, (PetscEnum)gmres->matsolvetype, (PetscEnum *)&type, &flg));
+    if (flg) PetscCall(KSPGMRESSetMatSolveType(ksp, type));
+  }
   flg = PETSC_FALSE;
   PetscCall(PetscOptionsBool("-ksp_gmres_krylov_monitor", "Plot the Krylov directions", "KSPMonitorSet", flg, &flg, NULL));
   if (flg) {
@@ -575,6 +613,25 @@ static PetscErrorCode KSPGMRESSetBreakdownTolerance_GMRES(KSP ksp, PetscReal tol
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode KSPGMRESSetMatSolveType_GMRES(KSP ksp, KSPMatSolveType type)
+{
+  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  gmres->matsolvetype = type;
+  ksp->ops->matsolve  = type == KSP_MATSOLVE_COLUMN ? NULL : KSPMatSolve_GMRES;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESGetMatSolveType_GMRES(KSP ksp, KSPMatSolveType *type)
+{
+  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  *type = gmres->matsolvetype;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode KSPGMRESGetRestart_GMRES(KSP ksp, PetscInt *max_k)
 {
   KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
@@ -603,8 +660,11 @@ PetscErrorCode KSPGMRESSetRestart_GMRES(KSP ksp, PetscInt max_k)
 
 PetscErrorCode KSPGMRESSetOrthogonalization_GMRES(KSP ksp, FCN fcn)
 {
+  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
+
   PetscFunctionBegin;
-  ((KSP_GMRES *)ksp->data)->orthog = fcn;
+  gmres->orthog  = fcn;
+  gmres->lowsync = (PetscBool)(fcn == KSPGMRESLaggedCGS2Orthogonalization || fcn == KSPGMRESDCGS2Orthogonalization || fcn == KSPGMRESMGSICWYOrthogonalization);
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -841,6 +901,77 @@ PetscErrorCode KSPGMRESSetBreakdownTolerance(KSP ksp, PetscReal tol)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  KSPGMRESSetMatSolveType - Sets the algorithm used by `KSPMatSolve()` with `KSPGMRES`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp  - the Krylov space solver context
+- type - the algorithm, one of `KSP_MATSOLVE_COLUMN` (default), `KSP_MATSOLVE_PSEUDOBLOCK`, or `KSP_MATSOLVE_BLOCK`
+
+  Options Database Key:
+. -ksp_gmres_matsolve_type (column|pseudoblock|block) - the algorithm used by `KSPMatSolve()`
+
+  Level: intermediate
+
+  Notes:
+  With `KSP_MATSOLVE_COLUMN`, each column of the block of right-hand sides is solved with its own `KSPSolve()`.
+
+  With `KSP_MATSOLVE_PSEUDOBLOCK`, the columns are solved with independent GMRES iterations that are run together, so that the
+  operator and the preconditioner are applied to all the columns at once with `MatMatMult()` and `PCMatApply()`, and the
+  orthogonalization of all the columns needs a single global reduction per classical Gram-Schmidt pass.
+
+  With `KSP_MATSOLVE_BLOCK`, block GMRES is used, the columns share a single block Krylov subspace, and the restart set with
+  `KSPGMRESSetRestart()` is the number of block iterations. The blocks of the basis are orthonormalized with two passes of block
+  classical Gram-Schmidt and Cholesky QR, and the directions that are linearly dependent are dropped, so the size of the blocks
+  decreases when some of the columns converge before the others.
+
+  In both the pseudo-block and the block variants, the cycles are ended with estimates of the residual norms, and the convergence
+  test is applied to each column with the true residual norms at the beginning of each cycle, relative to the initial residual norm
+  of the column. The residual norm passed to the monitors is the largest residual norm of the columns. The convergence test set with
+  `KSPSetConvergenceTest()` is not used, and only left and right preconditioning are supported.
+
+  `KSPSetMatSolveBatchSize()` can be used to limit the number of columns solved together.
+
+  This has no effect on the types built on `KSPGMRES`, such as `KSPFGMRES` or `KSPLGMRES`.
+
+.seealso: [](ch_ksp), `KSPGMRES`, `KSPMatSolve()`, `KSPMatSolveType`, `KSPGMRESGetMatSolveType()`, `KSPCGSetMatSolveType()`, `KSPSetMatSolveBatchSize()`
+@*/
+PetscErrorCode KSPGMRESSetMatSolveType(KSP ksp, KSPMatSolveType type)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveEnum(ksp, type, 2);
+  PetscTryMethod(ksp, "KSPGMRESSetMatSolveType_C", (KSP, KSPMatSolveType), (ksp, type));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGMRESGetMatSolveType - Gets the algorithm used by `KSPMatSolve()` with `KSPGMRES`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. type - the algorithm
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPGMRES`, `KSPMatSolve()`, `KSPMatSolveType`, `KSPGMRESSetMatSolveType()`
+@*/
+PetscErrorCode KSPGMRESGetMatSolveType(KSP ksp, KSPMatSolveType *type)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(type, 2);
+  *type = KSP_MATSOLVE_COLUMN;
+  PetscTryMethod(ksp, "KSPGMRESGetMatSolveType_C", (KSP, KSPMatSolveType *), (ksp, type));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*MC
    KSPGMRES - Implements the Generalized Minimal Residual method {cite}`saad.schultz:gmres` with restart for solving linear systems using `KSP`.
 
@@ -852,8 +983,16 @@ PetscErrorCode KSPGMRESSetBreakdownTolerance(KSP ksp, PetscReal tol)
 .   -ksp_gmres_classicalgramschmidt                                             - use classical (unmodified) Gram-Schmidt to orthogonalize against
                                                                                   the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt                                              - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+.   -ksp_gmres_lagged_cgs2                                                      - use classical Gram-Schmidt with refinement and a lagged normalization,
+                                                                                  two global reductions per iteration, see `KSPGMRESLaggedCGS2Orthogonalization()`
+.   -ksp_gmres_dcgs2                                                            - use classical Gram-Schmidt with a delayed refinement, one global reduction
+                                                                                  per iteration, see `KSPGMRESDCGS2Orthogonalization()`
+.   -ksp_gmres_mgs_icwy                                                         - use modified Gram-Schmidt in inverse compact WY form, one global reduction
+                                                                                  per iteration, see `KSPGMRESMGSICWYOrthogonalization()`
 .   -ksp_gmres_cgs_refinement_type (refine_never|refine_ifneeded|refine_always) - determine if iterative refinement is used to increase the
                                                                                   stability of the classical Gram-Schmidt  orthogonalization.
+.   -ksp_gmres_matsolve_type (column|pseudoblock|block)                         - algorithm used by `KSPMatSolve()` with several right-hand sides,
+                                                                                  see `KSPGMRESSetMatSolveType()`
 -   -ksp_gmres_krylov_monitor                                                   - plot the Krylov space generated
 
    Level: beginner
@@ -863,10 +1002,14 @@ PetscErrorCode KSPGMRESSetBreakdownTolerance(KSP ksp, PetscReal tol)
 
    Using `KSPGMRESSetPreAllocateVectors()` or `-ksp_gmres_preallocate` can improve the efficiency of the orthogonalization step with certain vector implementations.
 
+   `KSPMatSolve()` can run the iterations of several right-hand sides together, either independently or as block GMRES, see `KSPGMRESSetMatSolveType()`.
+
 .seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPFGMRES`, `KSPLGMRES`, `KSPPGMRES`, `KSPAGMRES`, `KSPDGMRES`, `KSPPIPEFGMRES`,
           `KSPGMRESSetRestart()`, `KSPGMRESSetHapTol()`, `KSPGMRESSetPreAllocateVectors()`, `KSPGMRESSetOrthogonalization()`, `KSPGMRESGetOrthogonalization()`,
-          `KSPGMRESClassicalGramSchmidtOrthogonalization()`, `KSPGMRESModifiedGramSchmidtOrthogonalization()`,
-          `KSPGMRESCGSRefinementType`, `KSPGMRESSetCGSRefinementType()`, `KSPGMRESGetCGSRefinementType()`, `KSPGMRESMonitorKrylov()`, `KSPSetPCSide()`
+          `KSPGMRESClassicalGramSchmidtOrthogonalization()`, `KSPGMRESModifiedGramSchmidtOrthogonalization()`, `KSPGMRESDCGS2Orthogonalization()`,
+          `KSPGMRESMGSICWYOrthogonalization()`, `KSPGMRESLaggedCGS2Orthogonalization()`,
+          `KSPGMRESCGSRefinementType`, `KSPGMRESSetCGSRefinementType()`, `KSPGMRESGetCGSRefinementType()`, `KSPGMRESMonitorKrylov()`, `KSPSetPCSide()`,
+          `KSPGMRESSetMatSolveType()`
 M*/
 
 PETSC_EXTERN PetscErrorCode KSPCreate_GMRES(KSP ksp)
@@ -902,6 +1045,8 @@ PETSC_EXTERN PetscErrorCode KSPCreate_GMRES(KSP ksp)
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetBreakdownTolerance_C", KSPGMRESSetBreakdownTolerance_GMRES));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", KSPGMRESSetCGSRefinementType_GMRES));
   PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", KSPGMRESGetCGSRefinementType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetMatSolveType_C", KSPGMRESSetMatSolveType_GMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetMatSolveType_C", KSPGMRESGetMatSolveType_GMRES));
 
   gmres->haptol         = 1.0e-30;
   gmres->breakdowntol   = 0.1;
@@ -15,7 +15,10 @@
 
   Options Database Keys:
 + -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
-- -ksp_gmres_modifiedgramschmidt  - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+. -ksp_gmres_modifiedgramschmidt  - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+. -ksp_gmres_lagged_cgs2          - Activates KSPGMRESLaggedCGS2Orthogonalization()
+. -ksp_gmres_dcgs2                - Activates KSPGMRESDCGS2Orthogonalization()
+- -ksp_gmres_mgs_icwy             - Activates KSPGMRESMGSICWYOrthogonalization()
 
   Level: intermediate
 
@@ -25,9 +28,14 @@
 
   Use `KSPGMRESSetCGSRefinementType()` to determine if iterative refinement is used to increase stability.
 
+  With `KSPGMRES` and `KSPFGMRES` only, the low-synchronization routines `KSPGMRESLaggedCGS2Orthogonalization()`,
+  `KSPGMRESDCGS2Orthogonalization()`, and `KSPGMRESMGSICWYOrthogonalization()` need one or two global reductions per
+  iteration, they also normalize the new Krylov vector.
+
 .seealso: [](ch_ksp), `KSPGMRESSetRestart()`, `KSPGMRESSetPreAllocateVectors()`,
 `KSPGMRESSetCGSRefinementType()`, `KSPGMRESModifiedGramSchmidtOrthogonalization()`,
-`KSPGMRESClassicalGramSchmidtOrthogonalization()`, `KSPGMRESGetCGSRefinementType()`
+`KSPGMRESClassicalGramSchmidtOrthogonalization()`, `KSPGMRESGetCGSRefinementType()`, `KSPGMRESDCGS2Orthogonalization()`,
+`KSPGMRESMGSICWYOrthogonalization()`, `KSPGMRESLaggedCGS2Orthogonalization()`
 @*/
 PetscErrorCode KSPGMRESSetOrthogonalization(KSP ksp, PetscErrorCode (*fcn)(KSP ksp, PetscInt it))
 {
@@ -0,0 +1,507 @@
+/*
+    Pseudo-block and block GMRES methods used by KSPMatSolve() with KSPGMRES, see KSPGMRESSetMatSolveType()
+*/
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h> /*I "petscksp.h" I*/
+#include <petsc/private/kspblockimpl.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  Mat          A;         /* operator */
+  Mat          V;         /* basis of the Krylov subspace, max_k + 1 blocks of at most n columns */
+  Mat          W, W2;     /* operator applied to the last block of the basis, and its first orthogonalization */
+  Mat          Xw, Yw;    /* work blocks for the operator and the preconditioner, recreated when the number of columns changes */
+  Mat          AXw;       /* output of MatMatMult() */
+  Mat          AX;        /* operator applied to the solution */
+  Mat          U, T;      /* correction of the solution and work block */
+  PetscInt     n, m;      /* number of right-hand sides, maximum number of (block) iterations per cycle */
+  PetscInt     a;         /* number of columns iterated in the current cycle */
+  PetscInt    *active;    /* the columns iterated in the current cycle */
+  PetscReal   *est;       /* estimates of the residual norms of the active columns */
+  PetscInt    *off;       /* block GMRES, the columns of block i of the basis are off[i] to off[i + 1] - 1 */
+  PetscScalar *H, *G;     /* block GMRES, Hessenberg matrix reduced to triangular form by Householder reflections, and right-hand sides */
+  PetscScalar *tau, *Y;   /* block GMRES, coefficients of the Householder reflections, coefficients of the correction in the basis */
+  PetscScalar *C1, *C2;   /* block GMRES, coefficients of the projections on the basis */
+  PetscScalar *Gm, *T1, *S1, *T2, *S2, *work;
+  PetscInt     lwork;
+  PetscScalar *hh, *cc, *ss, *grs; /* pseudo-block GMRES, Hessenberg matrices, plane rotations, and right-hand sides of the columns */
+  PetscScalar *dots;
+  PetscReal   *hnorm;
+  PetscInt    *len; /* pseudo-block GMRES, number of iterations of a column in the current cycle */
+} KSP_GMRESBlock;
+
+#define KSPGMRES_BLOCK_CONJTRANS (PetscDefined(USE_COMPLEX) ? "C" : "T")
+
+/*
+   W = Op V, with Op = B A or A B depending on the side of the preconditioner. The column layouts of the submatrices of the basis
+   do not match each other, so V is first copied into a block of work vectors with the same layout as the other work blocks
+*/
+static PetscErrorCode KSPGMRESBlockApply(KSP ksp, KSP_GMRESBlock *blk, Mat V, Mat W)
+{
+  PetscInt w, wx = -1, m, M;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(V, &M, &w));
+  if (blk->Xw) PetscCall(MatGetSize(blk->Xw, NULL, &wx));
+  if (w != wx) {
+    PetscCall(MatDestroy(&blk->AXw));
+    PetscCall(MatDestroy(&blk->Yw));
+    PetscCall(MatDestroy(&blk->Xw));
+    PetscCall(MatGetLocalSize(V, &m, NULL));
+    PetscCall(MatCreate(PetscObjectComm((PetscObject)V), &blk->Xw));
+    PetscCall(MatSetSizes(blk->Xw, m, PETSC_DECIDE, M, w));
+    PetscCall(MatSetType(blk->Xw, ((PetscObject)V)->type_name));
+    PetscCall(MatSetUp(blk->Xw));
+    PetscCall(MatDuplicate(blk->Xw, MAT_DO_NOT_COPY_VALUES, &blk->Yw));
+  }
+  PetscCall(MatCopy(V, blk->Xw, SAME_NONZERO_PATTERN));
+  if (ksp->pc_side == PC_LEFT) {
+    PetscCall(KSPBlockMatMult_Private(ksp, blk->A, blk->Xw, &blk->AXw));
+    PetscCall(KSP_PCMatApply(ksp, blk->AXw, blk->Yw));
+    PetscCall(MatCopy(blk->Yw, W, SAME_NONZERO_PATTERN));
+  } else {
+    PetscCall(KSP_PCMatApply(ksp, blk->Xw, blk->Yw));
+    PetscCall(KSPBlockMatMult_Private(ksp, blk->A, blk->Yw, &blk->AXw));
+    PetscCall(MatCopy(blk->AXw, W, SAME_NONZERO_PATTERN));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* R = B - A X, preconditioned with a left preconditioner */
+static PetscErrorCode KSPGMRESBlockResidual(KSP ksp, KSP_GMRESBlock *blk, Mat B, Mat X, PetscBool zero, Mat R)
+{
+  PetscFunctionBegin;
+  PetscCall(MatCopy(B, blk->T, SAME_NONZERO_PATTERN));
+  if (!zero) {
+    PetscCall(KSPBlockMatMult_Private(ksp, blk->A, X, &blk->AX));
+    PetscCall(MatAXPY(blk->T, -1.0, blk->AX, SAME_NONZERO_PATTERN));
+  }
+  if (ksp->pc_side == PC_LEFT) PetscCall(KSP_PCMatApply(ksp, blk->T, R));
+  else PetscCall(MatCopy(blk->T, R, SAME_NONZERO_PATTERN));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* X(:,active) += U, or B U with a right preconditioner */
+static PetscErrorCode KSPGMRESBlockUpdateSolution(KSP ksp, KSP_GMRESBlock *blk, Mat X)
+{
+  Mat U, T;
+
+  PetscFunctionBegin;
+  PetscCall(MatDenseGetSubMatrix(blk->U, PETSC_DECIDE, PETSC_DECIDE, 0, blk->a, &U));
+  if (ksp->pc_side == PC_RIGHT) {
+    PetscCall(MatDenseGetSubMatrix(blk->T, PETSC_DECIDE, PETSC_DECIDE, 0, blk->a, &T));
+    PetscCall(KSP_PCMatApply(ksp, U, T));
+    PetscCall(KSPBlockCopyColumns_Private(blk->a, T, NULL, X, blk->active, ADD_VALUES));
+    PetscCall(MatDenseRestoreSubMatrix(blk->T, &T));
+  } else PetscCall(KSPBlockCopyColumns_Private(blk->a, U, NULL, X, blk->active, ADD_VALUES));
+  PetscCall(MatDenseRestoreSubMatrix(blk->U, &U));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* convergence test with the estimates of the residual norms of the active columns, ends the cycle when it returns true */
+static PetscErrorCode KSPGMRESBlockMonitor(KSP ksp, KSP_GMRESBlock *blk, PetscReal norms[], const PetscReal norms0[], PetscBool converged[], PetscBool *end)
+{
+  KSPConvergedReason reason;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its++;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  for (PetscInt j = 0; j < blk->a; j++) norms[blk->active[j]] = blk->est[j];
+  PetscCall(KSPBlockConverged_Private(ksp, ksp->its, blk->n, norms, norms0, converged, &reason));
+  PetscCall(KSPLogResidualHistory(ksp, ksp->rnorm));
+  PetscCall(KSPMonitor(ksp, ksp->its, ksp->rnorm));
+  /* the estimates are checked against the true residuals at the beginning of the next cycle, unless the iteration has failed */
+  if (reason < 0 && reason != KSP_DIVERGED_ITS) ksp->reason = reason;
+  *end = (PetscBool)(reason != KSP_CONVERGED_ITERATING);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Orthogonalizes the first w columns of blk->W against the first nb columns of the basis, and orthonormalizes them into the columns
+   nb to nb + r - 1 of the basis, with two passes of block classical Gram-Schmidt and of Cholesky QR. The rank r may be smaller
+   than w when the columns are (nearly) linearly dependent. On output, W = V(:,0:nb) Hc + V(:,nb:nb+r) S. With scale, the columns
+   are normalized before looking for linearly dependent directions, so that a small column is not dropped.
+*/
+static PetscErrorCode KSPGMRESBlockOrthogonalize(KSP ksp, KSP_GMRESBlock *blk, PetscInt nb, PetscInt w, PetscBool scale, PetscScalar Hc[], PetscInt ldhc, PetscScalar S[], PetscInt lds, PetscInt *r)
+{
+  Mat          Vb, Wk, W2k, Vn;
+  PetscReal   *d = blk->hnorm, sigma = 0.0, atol = 0.0;
+  PetscInt     r1, r2;
+  PetscBLASInt bnb, bw, br1, br2, bldhc, blds;
+  PetscScalar  one = 1.0, zero = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(MatDenseGetSubMatrix(blk->W, PETSC_DECIDE, PETSC_DECIDE, 0, w, &Wk));
+  if (nb) {
+    PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, 0, nb, &Vb));
+    PetscCall(KSPBlockDot_Private(Vb, Wk, blk->C1));
+    PetscCall(KSPBlockGEMM_Private(1.0, Wk, -1.0, Vb, blk->C1, nb));
+    PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vb));
+  }
+  PetscCall(KSPBlockDot_Private(Wk, Wk, blk->Gm));
+  for (PetscInt j = 0; j < w; j++) {
+    PetscReal gjj = PetscRealPart(blk->Gm[j + j * w]);
+
+    if (scale) d[j] = gjj > 0.0 ? 1.0 / PetscSqrtReal(gjj) : 0.0;
+    else {
+      for (PetscInt i = 0; i < nb; i++) gjj += PetscRealPart(PetscConj(blk->C1[i + j * nb]) * blk->C1[i + j * nb]);
+      sigma = PetscMax(sigma, gjj);
+    }
+  }
+  /* the directions much smaller than the columns of W before the projection are rounding errors */
+  if (!scale) atol = PetscSqr(PETSC_SMALL) * sigma;
+  PetscCall(KSPBlockGramFactor_Private(w, blk->Gm, scale ? d : NULL, PETSC_SQRT_MACHINE_EPSILON, atol, blk->T1, blk->S1, &r1));
+  r2 = 0;
+  if (r1) {
+    PetscCall(MatDenseGetSubMatrix(blk->W2, PETSC_DECIDE, PETSC_DECIDE, 0, r1, &W2k));
+    PetscCall(KSPBlockGEMM_Private(0.0, W2k, 1.0, Wk, blk->T1, w));
+    if (nb) {
+      PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, 0, nb, &Vb));
+      PetscCall(KSPBlockDot_Private(Vb, W2k, blk->C2));
+      PetscCall(KSPBlockGEMM_Private(1.0, W2k, -1.0, Vb, blk->C2, nb));
+      PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vb));
+    }
+    PetscCall(KSPBlockDot_Private(W2k, W2k, blk->Gm));
+    PetscCall(KSPBlockGramFactor_Private(r1, blk->Gm, NULL, PETSC_SQRT_MACHINE_EPSILON, 0.0, blk->T2, blk->S2, &r2));
+    if (r2) {
+      PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, nb, nb + r2, &Vn));
+      PetscCall(KSPBlockGEMM_Private(0.0, Vn, 1.0, W2k, blk->T2, r1));
+      PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vn));
+    }
+    PetscCall(MatDenseRestoreSubMatrix(blk->W2, &W2k));
+  }
+  PetscCall(MatDenseRestoreSubMatrix(blk->W, &Wk));
+  /* Hc = C1 + C2 S1 and S = S2 S1 */
+  PetscCall(PetscBLASIntCast(nb, &bnb));
+  PetscCall(PetscBLASIntCast(w, &bw));
+  PetscCall(PetscBLASIntCast(r1, &br1));
+  PetscCall(PetscBLASIntCast(r2, &br2));
+  PetscCall(PetscBLASIntCast(ldhc, &bldhc));
+  PetscCall(PetscBLASIntCast(PetscMax(lds, 1), &blds));
+  for (PetscInt j = 0; j < w; j++)
+    for (PetscInt i = 0; i < nb; i++) Hc[i + j * ldhc] = blk->C1[i + j * nb];
+  if (nb && r1) PetscCallBLAS("BLASgemm", BLASgemm_("N", "N", &bnb, &bw, &br1, &one, blk->C2, &bnb, blk->S1, &br1, &one, Hc, &bldhc));
+  if (r2) PetscCallBLAS("BLASgemm", BLASgemm_("N", "N", &br2, &bw, &br1, &one, blk->S2, &br2, blk->S1, &br1, &zero, S, &blds));
+  *r = r2;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* applies the Householder reflections of the previous block columns to block column k of H, and reduces it to triangular form */
+static PetscErrorCode KSPGMRESBlockUpdateHessenberg(KSP ksp, KSP_GMRESBlock *blk, PetscInt k)
+{
+  const PetscInt *off = blk->off;
+  PetscInt        ldh = (blk->m + 1) * blk->n;
+  PetscBLASInt    bldh, bm, bw, bk, ba, blwork;
+
+  PetscFunctionBegin;
+  PetscCall(PetscBLASIntCast(ldh, &bldh));
+  PetscCall(PetscBLASIntCast(off[k + 1] - off[k], &bw));
+  PetscCall(PetscBLASIntCast(blk->a, &ba));
+  PetscCall(PetscBLASIntCast(blk->lwork, &blwork));
+  for (PetscInt i = 0; i < k; i++) {
+    PetscCall(PetscBLASIntCast(off[i + 2] - off[i], &bm));
+    PetscCall(PetscBLASIntCast(off[i + 1] - off[i], &bk));
+    PetscCallLAPACKInfo("LAPACKormqr", LAPACKormqr_("L", KSPGMRES_BLOCK_CONJTRANS, &bm, &bw, &bk, blk->H + off[i] + off[i] * ldh, &bldh, blk->tau + off[i], blk->H + off[i] + off[k] * ldh, &bldh, blk->work, &blwork, &info));
+  }
+  PetscCall(PetscBLASIntCast(off[k + 2] - off[k], &bm));
+  PetscCallLAPACKInfo("LAPACKgeqrf", LAPACKgeqrf_(&bm, &bw, blk->H + off[k] + off[k] * ldh, &bldh, blk->tau + off[k], blk->work, &blwork, &info));
+  PetscCallLAPACKInfo("LAPACKormqr", LAPACKormqr_("L", KSPGMRES_BLOCK_CONJTRANS, &bm, &ba, &bw, blk->H + off[k] + off[k] * ldh, &bldh, blk->tau + off[k], blk->G + off[k], &bldh, blk->work, &blwork, &info));
+  /* the residual of the least-squares problem of column j is in the rows of G below the triangular part */
+  for (PetscInt j = 0; j < blk->a; j++) {
+    PetscReal est = 0.0;
+
+    for (PetscInt i = off[k + 1]; i < off[k + 2]; i++) est += PetscRealPart(PetscConj(blk->G[i + j * ldh]) * blk->G[i + j * ldh]);
+    blk->est[j] = PetscSqrtReal(est);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   A cycle of block GMRES on the active columns of R. The first block of the basis is an orthonormal basis of the residuals, with
+   fewer columns than the number of active columns if the residuals are (nearly) linearly dependent, and a block of the basis
+   has fewer columns than the previous one when the block Krylov subspace has (nearly) stopped growing in some directions.
+*/
+static PetscErrorCode KSPGMRESBlockCycle(KSP ksp, KSP_GMRESBlock *blk, Mat R, Mat X, PetscReal norms[], const PetscReal norms0[], PetscBool converged[])
+{
+  Mat          Vk, Wk, Vb, U;
+  PetscInt    *off = blk->off, ldh = (blk->m + 1) * blk->n, a = blk->a, k, r, nk = 0;
+  PetscBool    end = PETSC_FALSE;
+  PetscBLASInt bnk, ba, bldh;
+  PetscScalar  one = 1.0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArrayzero(blk->G, ldh * a));
+  PetscCall(MatDenseGetSubMatrix(blk->W, PETSC_DECIDE, PETSC_DECIDE, 0, a, &Wk));
+  PetscCall(KSPBlockCopyColumns_Private(a, R, blk->active, Wk, NULL, INSERT_VALUES));
+  PetscCall(MatDenseRestoreSubMatrix(blk->W, &Wk));
+  PetscCall(KSPGMRESBlockOrthogonalize(ksp, blk, 0, a, PETSC_TRUE, NULL, ldh, blk->G, ldh, &r));
+  off[0] = 0;
+  off[1] = r;
+  for (k = 0; r && k < blk->m && !end; k++) {
+    PetscInt w = off[k + 1] - off[k];
+
+    PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, off[k], off[k + 1], &Vk));
+    PetscCall(MatDenseGetSubMatrix(blk->W, PETSC_DECIDE, PETSC_DECIDE, 0, w, &Wk));
+    PetscCall(KSPGMRESBlockApply(ksp, blk, Vk, Wk));
+    PetscCall(MatDenseRestoreSubMatrix(blk->W, &Wk));
+    PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vk));
+    PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+    PetscCall(KSPGMRESBlockOrthogonalize(ksp, blk, off[k + 1], w, PETSC_FALSE, blk->H + off[k] * ldh, ldh, blk->H + off[k + 1] + off[k] * ldh, ldh, &r));
+    PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+    for (PetscInt j = off[k]; j < off[k + 1]; j++)
+      for (PetscInt i = off[k + 1] + r; i < ldh; i++) blk->H[i + j * ldh] = 0.0;
+    off[k + 2] = off[k + 1] + r;
+    PetscCall(KSPGMRESBlockUpdateHessenberg(ksp, blk, k));
+    nk = off[k + 1];
+    if (!r) PetscCall(PetscInfo(ksp, "Block Krylov subspace is invariant at iteration %" PetscInt_FMT "\n", ksp->its + 1));
+    PetscCall(KSPGMRESBlockMonitor(ksp, blk, norms, norms0, converged, &end));
+    if (ksp->its >= ksp->max_it) end = PETSC_TRUE;
+  }
+  if (ksp->reason || !nk) PetscFunctionReturn(PETSC_SUCCESS);
+  /* solve the triangular system and form the correction */
+  for (PetscInt i = 0; i < nk; i++) {
+    if (blk->H[i + i * ldh] == (PetscScalar)0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "You reached the break down in block GMRES; H(%" PetscInt_FMT ",%" PetscInt_FMT ") = 0", i, i);
+      PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. H(%" PetscInt_FMT ",%" PetscInt_FMT ") is identically zero\n", i, i));
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  for (PetscInt j = 0; j < a; j++)
+    for (PetscInt i = 0; i < nk; i++) blk->Y[i + j * nk] = blk->G[i + j * ldh];
+  PetscCall(PetscBLASIntCast(nk, &bnk));
+  PetscCall(PetscBLASIntCast(a, &ba));
+  PetscCall(PetscBLASIntCast(ldh, &bldh));
+  PetscCallBLAS("BLAStrsm", BLAStrsm_("L", "U", "N", "N", &bnk, &ba, &one, blk->H, &bldh, blk->Y, &bnk));
+  PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, 0, nk, &Vb));
+  PetscCall(MatDenseGetSubMatrix(blk->U, PETSC_DECIDE, PETSC_DECIDE, 0, a, &U));
+  PetscCall(KSPBlockGEMM_Private(0.0, U, 1.0, Vb, blk->Y, nk));
+  PetscCall(MatDenseRestoreSubMatrix(blk->U, &U));
+  PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vb));
+  PetscCall(KSPGMRESBlockUpdateSolution(ksp, blk, X));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* plane rotations of column j of a pseudo-block cycle, see KSPGMRESUpdateHessenberg() */
+static PetscErrorCode KSPGMRESPseudoBlockUpdateHessenberg(KSP ksp, KSP_GMRESBlock *blk, PetscInt j, PetscInt it, PetscBool hapend)
+{
+  PetscScalar *hh, *cc, *ss, *grs, tt;
+
+  PetscFunctionBegin;
+  hh  = blk->hh + j * (blk->m + 1) * blk->m + it * (blk->m + 1);
+  cc  = blk->cc + j * blk->m;
+  ss  = blk->ss + j * blk->m;
+  grs = blk->grs + j * (blk->m + 1);
+  for (PetscInt i = 1; i <= it; i++) {
+    tt  = *hh;
+    *hh = PetscConj(*cc) * tt + *ss * *(hh + 1);
+    hh++;
+    *hh = *cc++ * *hh - (*ss++ * tt);
+  }
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(*hh) * *hh + PetscConj(*(hh + 1)) * *(hh + 1));
+    if (tt == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "tt == 0.0");
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    *cc          = *hh / tt;
+    *ss          = *(hh + 1) / tt;
+    grs[it + 1]  = -(*ss * grs[it]);
+    grs[it]      = PetscConj(*cc) * grs[it];
+    *hh          = PetscConj(*cc) * *hh + *ss * *(hh + 1);
+    blk->est[j]  = PetscAbsScalar(grs[it + 1]);
+  } else blk->est[j] = 0.0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   A cycle of independent GMRES iterations on the active columns of R. Block i of the basis holds the i-th Krylov vector of all the
+   columns, so the operator and the preconditioner are applied once per iteration, and the inner products of all the columns with
+   all the previous Krylov vectors need a single reduction.
+*/
+static PetscErrorCode KSPGMRESPseudoBlockCycle(KSP ksp, KSP_GMRESBlock *blk, Mat R, Mat X, PetscReal norms[], const PetscReal norms0[], PetscBool converged[])
+{
+  KSP_GMRES *gmres = (KSP_GMRES *)ksp->data;
+  Mat        Vk, Vb, Wk, U;
+  Vec        v;
+  PetscInt   a = blk->a, m = blk->m, k, kk = 0;
+  PetscBool  end = PETSC_FALSE, all;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArrayzero(blk->hh, a * (m + 1) * m));
+  PetscCall(PetscArrayzero(blk->grs, a * (m + 1)));
+  PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, 0, a, &Vk));
+  PetscCall(KSPBlockCopyColumns_Private(a, R, blk->active, Vk, NULL, INSERT_VALUES));
+  for (PetscInt j = 0; j < a; j++) {
+    PetscReal beta = norms[blk->active[j]];
+
+    blk->grs[j * (m + 1)] = beta;
+    blk->len[j]           = 0;
+    PetscCall(MatDenseGetColumnVec(Vk, j, &v));
+    PetscCall(VecScale(v, beta > 0.0 ? 1.0 / beta : 0.0));
+    PetscCall(MatDenseRestoreColumnVec(Vk, j, &v));
+  }
+  PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vk));
+  for (k = 0; k < m && !end; k++) {
+    PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, k * a, (k + 1) * a, &Vk));
+    PetscCall(MatDenseGetSubMatrix(blk->W, PETSC_DECIDE, PETSC_DECIDE, 0, a, &Wk));
+    PetscCall(KSPGMRESBlockApply(ksp, blk, Vk, Wk));
+    PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vk));
+    /* classical Gram-Schmidt of all the columns with a single reduction, repeated unless no refinement is requested */
+    PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+    PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, 0, (k + 1) * a, &Vb));
+    for (PetscInt pass = 0; pass < (gmres->cgstype == KSP_GMRES_CGS_REFINE_NEVER ? 1 : 2); pass++) {
+      PetscCall(KSPBlockColumnDot_Private(Vb, Wk, blk->dots));
+      PetscCall(KSPBlockColumnMAXPY_Private(Wk, -1.0, Vb, blk->dots));
+      for (PetscInt j = 0; j < a; j++)
+        for (PetscInt i = 0; i <= k; i++) blk->hh[j * (m + 1) * m + k * (m + 1) + i] += blk->dots[i * a + j];
+    }
+    PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vb));
+    PetscCall(MatGetColumnNorms(Wk, NORM_2, blk->hnorm));
+    PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+    PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, (k + 1) * a, (k + 2) * a, &Vk));
+    PetscCall(MatCopy(Wk, Vk, SAME_NONZERO_PATTERN));
+    PetscCall(MatDenseRestoreSubMatrix(blk->W, &Wk));
+    all = PETSC_TRUE;
+    for (PetscInt j = 0; j < a; j++) {
+      PetscBool hapend = (PetscBool)(blk->hnorm[j] <= gmres->haptol);
+
+      PetscCall(MatDenseGetColumnVec(Vk, j, &v));
+      PetscCall(VecScale(v, hapend ? 0.0 : 1.0 / blk->hnorm[j]));
+      PetscCall(MatDenseRestoreColumnVec(Vk, j, &v));
+      /* a column whose Krylov subspace is invariant is no longer iterated, its number of iterations is stored as a negative number */
+      if (blk->len[j] < 0) continue;
+      blk->hh[j * (m + 1) * m + k * (m + 1) + k + 1] = blk->hnorm[j];
+      PetscCall(KSPGMRESPseudoBlockUpdateHessenberg(ksp, blk, j, k, hapend));
+      if (ksp->reason) break;
+      blk->len[j] = hapend ? -(k + 1) : k + 1;
+      if (!hapend) all = PETSC_FALSE;
+    }
+    PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vk));
+    if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+    kk = k + 1;
+    PetscCall(KSPGMRESBlockMonitor(ksp, blk, norms, norms0, converged, &end));
+    if (ksp->its >= ksp->max_it || all) end = PETSC_TRUE;
+  }
+  if (ksp->reason) PetscFunctionReturn(PETSC_SUCCESS);
+  /* back substitution of each column, the coefficients of the correction of column j are dots[i * a + j] */
+  PetscCall(PetscArrayzero(blk->dots, kk * a));
+  for (PetscInt j = 0; j < a; j++) {
+    PetscInt     nj  = PetscAbsInt(blk->len[j]);
+    PetscScalar *hh  = blk->hh + j * (m + 1) * m;
+    PetscScalar *grs = blk->grs + j * (m + 1);
+
+    for (PetscInt i = nj - 1; i >= 0; i--) {
+      PetscScalar tt = grs[i];
+
+      for (PetscInt l = i + 1; l < nj; l++) tt -= hh[i + l * (m + 1)] * blk->dots[l * a + j];
+      if (hh[i + i * (m + 1)] == (PetscScalar)0.0) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %" PetscInt_FMT, i);
+        PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %" PetscInt_FMT "\n", i));
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        PetscFunctionReturn(PETSC_SUCCESS);
+      }
+      blk->dots[i * a + j] = tt / hh[i + i * (m + 1)];
+    }
+  }
+  PetscCall(MatDenseGetSubMatrix(blk->U, PETSC_DECIDE, PETSC_DECIDE, 0, a, &U));
+  PetscCall(MatZeroEntries(U));
+  PetscCall(MatDenseGetSubMatrix(blk->V, PETSC_DECIDE, PETSC_DECIDE, 0, kk * a, &Vb));
+  PetscCall(KSPBlockColumnMAXPY_Private(U, 1.0, Vb, blk->dots));
+  PetscCall(MatDenseRestoreSubMatrix(blk->V, &Vb));
+  PetscCall(MatDenseRestoreSubMatrix(blk->U, &U));
+  PetscCall(KSPGMRESBlockUpdateSolution(ksp, blk, X));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPMatSolve_GMRES(KSP ksp, Mat B, Mat X)
+{
+  KSP_GMRES     *gmres = (KSP_GMRES *)ksp->data;
+  KSP_GMRESBlock blk;
+  Mat            R;
+  PetscInt       N, nloc, n, m, ldh;
+  PetscReal     *norms, *norms0;
+  PetscBool     *converged, diagonalscale, first = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+  PetscCheck(ksp->pc_side != PC_SYMMETRIC, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "KSPMatSolve() with %s %s does not support symmetric preconditioning", ((PetscObject)ksp)->type_name, KSPMatSolveTypes[gmres->matsolvetype]);
+  PetscCall(PetscMemzero(&blk, sizeof(blk)));
+  PetscCall(PCGetOperators(ksp->pc, &blk.A, NULL));
+  PetscCall(MatGetSize(B, &N, &n));
+  PetscCall(MatGetLocalSize(B, &nloc, NULL));
+  m     = gmres->max_k;
+  ldh   = (m + 1) * n;
+  blk.n = n;
+  blk.m = m;
+  PetscCall(MatCreate(PetscObjectComm((PetscObject)B), &blk.V));
+  PetscCall(MatSetSizes(blk.V, nloc, PETSC_DECIDE, N, (m + 1) * n));
+  PetscCall(MatSetType(blk.V, ((PetscObject)B)->type_name));
+  PetscCall(MatSetUp(blk.V));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &blk.W));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &blk.U));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &blk.T));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &R));
+  PetscCall(PetscMalloc5(n, &norms, n, &norms0, n, &converged, n, &blk.active, n, &blk.est));
+  PetscCall(PetscMalloc1(n, &blk.hnorm));
+  if (gmres->matsolvetype == KSP_MATSOLVE_BLOCK) {
+    PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &blk.W2));
+    blk.lwork = 64 * n;
+    PetscCall(PetscMalloc5(m + 2, &blk.off, ldh * m * n, &blk.H, ldh * n, &blk.G, m * n, &blk.tau, ldh * n, &blk.Y));
+    PetscCall(PetscMalloc5(ldh * n, &blk.C1, ldh * n, &blk.C2, n * n, &blk.Gm, n * n, &blk.T1, n * n, &blk.S1));
+    PetscCall(PetscMalloc3(n * n, &blk.T2, n * n, &blk.S2, blk.lwork, &blk.work));
+  } else {
+    PetscCall(PetscMalloc5(n * (m + 1) * m, &blk.hh, n * m, &blk.cc, n * m, &blk.ss, n * (m + 1), &blk.grs, n * (m + 1), &blk.dots));
+    PetscCall(PetscMalloc1(n, &blk.len));
+  }
+
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  while (!ksp->reason) {
+    /* the convergence is always decided with the true residuals, the estimates of the cycles only end the cycles */
+    PetscCall(KSPGMRESBlockResidual(ksp, &blk, B, X, (PetscBool)(first && ksp->guess_zero), R));
+    PetscCall(MatGetColumnNorms(R, NORM_2, norms));
+    if (first) PetscCall(PetscArraycpy(norms0, norms, n));
+    PetscCall(KSPBlockConverged_Private(ksp, ksp->its, n, norms, norms0, converged, &ksp->reason));
+    if (first) {
+      PetscCall(KSPLogResidualHistory(ksp, ksp->rnorm));
+      PetscCall(KSPMonitor(ksp, 0, ksp->rnorm));
+      first = PETSC_FALSE;
+    }
+    if (ksp->reason) break;
+    blk.a = 0;
+    for (PetscInt j = 0; j < n; j++)
+      if (!converged[j]) blk.active[blk.a++] = j;
+    /* all the columns have converged before the minimum number of iterations */
+    if (!blk.a)
+      for (PetscInt j = 0; j < n; j++) blk.active[blk.a++] = j;
+    if (gmres->matsolvetype == KSP_MATSOLVE_BLOCK) PetscCall(KSPGMRESBlockCycle(ksp, &blk, R, X, norms, norms0, converged));
+    else PetscCall(KSPGMRESPseudoBlockCycle(ksp, &blk, R, X, norms, norms0, converged));
+  }
+
+  PetscCall(MatDestroy(&R));
+  PetscCall(MatDestroy(&blk.V));
+  PetscCall(MatDestroy(&blk.W));
+  PetscCall(MatDestroy(&blk.W2));
+  PetscCall(MatDestroy(&blk.Xw));
+  PetscCall(MatDestroy(&blk.Yw));
+  PetscCall(MatDestroy(&blk.AXw));
+  PetscCall(MatDestroy(&blk.AX));
+  PetscCall(MatDestroy(&blk.U));
+  PetscCall(MatDestroy(&blk.T));
+  PetscCall(PetscFree5(norms, norms0, converged, blk.active, blk.est));
+  PetscCall(PetscFree(blk.hnorm));
+  if (gmres->matsolvetype == KSP_MATSOLVE_BLOCK) {
+    PetscCall(PetscFree5(blk.off, blk.H, blk.G, blk.tau, blk.Y));
+    PetscCall(PetscFree5(blk.C1, blk.C2, blk.Gm, blk.T1, blk.S1));
+    PetscCall(PetscFree3(blk.T2, blk.S2, blk.work));
+  } else {
+    PetscCall(PetscFree5(blk.hh, blk.cc, blk.ss, blk.grs, blk.dots));
+    PetscCall(PetscFree(blk.len));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -16,7 +16,9 @@
   PetscScalar *ss_origin;  /* holds sines for rotation matrices */ \
   PetscScalar *rs_origin;  /* holds the right-hand side of the Hessenberg system */ \
 \
-  PetscScalar *orthogwork; /* holds dot products computed in orthogonalization */ \
+  PetscScalar *orthogwork;  /* holds dot products computed in orthogonalization */ \
+  PetscScalar *lowsyncwork; /* work array of the low-synchronization orthogonalizations */ \
+  PetscBool    lowsync;     /* the orthogonalization normalizes VEC_VV(it + 1), see KSPGMRESDCGS2Orthogonalization() */ \
 \
   /* Work space for computing eigenvalues/singular values */ \
   PetscReal   *Dsvd; \
@@ -46,7 +48,9 @@
   PetscScalar *nrs;          /* temp that holds the coefficients of the Krylov vectors that form the minimum residual solution */ \
   Vec          sol_temp;     /* used to hold temporary solution */ \
   PetscReal    rnorm0;       /* residual norm at beginning of the GMRESCycle */ \
-  PetscReal    breakdowntol; /* A relative tolerance is used for breakdown check in GMRESCycle */
+  PetscReal    breakdowntol; /* A relative tolerance is used for breakdown check in GMRESCycle */ \
+\
+  KSPMatSolveType matsolvetype; /* algorithm used by KSPMatSolve() */
 
 typedef struct {
   KSPGMRESHEADER
@@ -61,6 +65,8 @@ PETSC_INTERN PetscErrorCode KSPComputeRitz_GMRES(KSP, PetscBool, PetscBool, Pets
 PETSC_INTERN PetscErrorCode KSPReset_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPDestroy_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPGMRESGetNewVectors(KSP, PetscInt);
+PETSC_INTERN PetscErrorCode KSPMatSolve_GMRES(KSP, Mat, Mat);
+PETSC_INTERN PetscErrorCode KSPGMRESLowSyncFinalize_Private(KSP, PetscInt, PetscBool);
 
 typedef PetscErrorCode (*FCN)(KSP, PetscInt); /* force argument to next function to not be extern C*/
 
@@ -339,12 +339,18 @@ PetscErrorCode KSPSetCheckNormIteration(KSP ksp, PetscInt it)
   Level: advanced
 
   Notes:
-  Currently only works with `KSPIBCGS`.
+  Currently only works with `KSPIBCGS`, `KSPCG`, and `KSPBCGS`.
 
-  This can reduce communication costs at the expense of doing
+  With `KSPIBCGS` this can reduce communication costs at the expense of doing
   one additional iteration because the norm used in the convergence test of `KSPSolve()` is one iteration behind the actual
   current residual norm (which has not yet been computed due to the lag).
 
+  With `KSPCG` (using `KSP_NORM_PRECONDITIONED`) and `KSPBCGS` the residual norm is computed with `VecNormBegin()` and `VecNormEnd()`
+  in the same reduction as the first inner product of the next iteration, so each iteration needs one less reduction while the
+  iterates and the iteration count are unchanged. With `KSPCG` using `KSP_NORM_UNPRECONDITIONED`, the norm of the new residual is
+  computed from inner products of the previous residual in the same reduction as the step length, so that the convergence test is
+  still done before the preconditioner is applied.
+
   Use `KSPSetNormType`(ksp,`KSP_NORM_NONE`) to never check the norm
 
   If you lag the norm and run with, for example, `-ksp_monitor`, the residual norm reported will be the lagged one.
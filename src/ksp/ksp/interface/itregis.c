@@ -9,6 +9,9 @@ PETSC_EXTERN PetscErrorCode KSPCreate_PIPECGRR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPELCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPEPRCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPECG2(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_CACG(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_RCG(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_ECG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_CGNE(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_NASH(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_STCG(KSP);
@@ -41,6 +44,8 @@ PETSC_EXTERN PetscErrorCode KSPCreate_LCD(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_GCR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPEGCR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_CAGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP);
 #if !PetscDefined(USE_COMPLEX)
 PETSC_EXTERN PetscErrorCode KSPCreate_DGMRES(KSP);
 #endif
@@ -74,6 +79,9 @@ PetscErrorCode KSPRegisterAll(void)
   PetscCall(KSPRegister(KSPPIPELCG, KSPCreate_PIPELCG));
   PetscCall(KSPRegister(KSPPIPEPRCG, KSPCreate_PIPEPRCG));
   PetscCall(KSPRegister(KSPPIPECG2, KSPCreate_PIPECG2));
+  PetscCall(KSPRegister(KSPCACG, KSPCreate_CACG));
+  PetscCall(KSPRegister(KSPRCG, KSPCreate_RCG));
+  PetscCall(KSPRegister(KSPECG, KSPCreate_ECG));
   PetscCall(KSPRegister(KSPCGNE, KSPCreate_CGNE));
   PetscCall(KSPRegister(KSPNASH, KSPCreate_NASH));
   PetscCall(KSPRegister(KSPSTCG, KSPCreate_STCG));
@@ -109,6 +117,8 @@ PetscErrorCode KSPRegisterAll(void)
   PetscCall(KSPRegister(KSPGCR, KSPCreate_GCR));
   PetscCall(KSPRegister(KSPPIPEGCR, KSPCreate_PIPEGCR));
   PetscCall(KSPRegister(KSPPGMRES, KSPCreate_PGMRES));
+  PetscCall(KSPRegister(KSPCAGMRES, KSPCreate_CAGMRES));
+  PetscCall(KSPRegister(KSPGCRODR, KSPCreate_GCRODR));
 #if !PetscDefined(USE_COMPLEX)
   PetscCall(KSPRegister(KSPDGMRES, KSPCreate_DGMRES));
 #endif
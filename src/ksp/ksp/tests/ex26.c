@@ -230,7 +230,7 @@ PetscErrorCode FormJacobian_Grid(GridCtx *grid, Mat jac)
     test:
       suffix: cycles
       nsize: {{1 2}}
-      args: -ksp_view_final_residual -pc_type mg -mx 5 -my 5 -pc_mg_levels 3 -pc_mg_galerkin -ksp_monitor -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -pc_mg_type {{additive multiplicative full kaskade}separate output} -nrhs 1
+      args: -ksp_view_final_residual -pc_type mg -mx 5 -my 5 -pc_mg_levels 3 -pc_mg_galerkin -ksp_monitor -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -pc_mg_type {{additive multiplicative full kaskade multadditive}separate output} -nrhs 1
 
     test:
       suffix: matcycles
@@ -0,0 +1,120 @@
+static char help[] = "Tests KSPCACG and KSPCAGMRES against KSPCG and KSPGMRES on a 2D convection-diffusion problem.\n\n\
+  -m <m>, -n <n>     : grid dimensions\n\
+  -convection <c>    : convection coefficient, 0 gives a symmetric positive definite matrix\n\
+  -ref_ksp_type <t>  : type of the reference solver\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat         A;
+  Vec         x, xref, b;
+  KSP         ksp, ref;
+  PC          pc;
+  PCType      pctype;
+  PetscInt    m = 16, n = 16, Istart, Iend, its, itsref;
+  PetscReal   convection = 0.0, rtol = 1e-10, err, nrm;
+  char        reftype[256] = KSPCG;
+  PetscRandom rand;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-convection", &convection, NULL));
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-ref_ksp_type", reftype, sizeof(reftype), NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * n, m * n, 5, NULL, 5, NULL, &A));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    PetscInt i = Ii / n, j = Ii - i * n;
+
+    if (i > 0) PetscCall(MatSetValue(A, Ii, Ii - n, -1.0 - convection, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, Ii, Ii + n, -1.0 + convection, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, Ii, Ii - 1, -1.0 - convection, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, Ii, Ii + 1, -1.0 + convection, INSERT_VALUES));
+    PetscCall(MatSetValue(A, Ii, Ii, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &xref));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  PetscCall(VecSetRandom(b, rand));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPCACG));
+  PetscCall(KSPSetTolerances(ksp, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+
+  /* the reference solver uses the same preconditioner */
+  PetscCall(KSPSetUp(ksp));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCGetType(pc, &pctype));
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ref));
+  PetscCall(KSPSetOperators(ref, A, A));
+  PetscCall(KSPSetType(ref, reftype));
+  PetscCall(KSPGetPC(ref, &pc));
+  PetscCall(PCSetType(pc, pctype));
+  PetscCall(KSPSetTolerances(ref, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetOptionsPrefix(ref, "ref_"));
+  PetscCall(KSPSetFromOptions(ref));
+  PetscCall(KSPSolve(ref, b, xref));
+  PetscCall(KSPGetIterationNumber(ref, &itsref));
+
+  /* the second solve reuses the shifts of the basis computed by the first one */
+  for (PetscInt k = 0; k < 2; k++) {
+    PetscCall(VecZeroEntries(x));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(KSPGetIterationNumber(ksp, &its));
+    PetscCall(VecAXPY(x, -1.0, xref));
+    PetscCall(VecNorm(x, NORM_2, &err));
+    PetscCall(VecNorm(xref, NORM_2, &nrm));
+    if (err > 1e-6 * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Solve %" PetscInt_FMT ": relative difference with the reference solution %g\n", k, (double)(err / nrm)));
+    if (its > itsref + itsref / 2 + 5) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Solve %" PetscInt_FMT ": %" PetscInt_FMT " iterations instead of %" PetscInt_FMT "\n", k, its, itsref));
+  }
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(KSPDestroy(&ref));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&xref));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      test:
+        suffix: cacg
+        args: -ksp_ca_s {{1 4 6}} -ksp_norm_type {{natural preconditioned unpreconditioned}} -pc_type {{none jacobi}}
+      test:
+        suffix: cacg_basis
+        args: -ksp_ca_basis_type {{monomial chebyshev}} -ksp_ca_s 3 -pc_type jacobi
+      test:
+        suffix: cacg_bounds
+        args: -ksp_ca_eigenvalues 0.1,8 -ksp_ca_basis_type {{newton chebyshev}} -pc_type none -ksp_ca_matrix_powers
+      test:
+        suffix: cacg_mpk
+        args: -ksp_ca_matrix_powers -pc_type none -ksp_ca_s 5
+      test:
+        suffix: cagmres
+        args: -convection 0.5 -ref_ksp_type gmres -ksp_type cagmres -ksp_ca_s {{1 5}} -ksp_pc_side {{left right}} -ksp_gmres_cgs_refinement_type {{refine_never refine_ifneeded}}
+      test:
+        suffix: cagmres_basis
+        args: -convection 0.5 -ref_ksp_type gmres -ksp_type cagmres -ksp_gmres_restart 12 -ref_ksp_gmres_restart 12 -ksp_ca_s 8 -ksp_ca_basis_type {{monomial chebyshev}}
+      test:
+        suffix: cagmres_mpk
+        args: -convection 0.5 -ref_ksp_type gmres -ksp_type cagmres -ksp_ca_matrix_powers -pc_type none -ksp_ca_s 4
+
+TEST*/
@@ -0,0 +1,123 @@
+static char help[] = "Tests the pseudo-block and block KSPMatSolve() of KSPCG and KSPGMRES against one KSPSolve() per column.\n\n\
+  -m <m>, -n <n>     : grid dimensions\n\
+  -N <N>             : number of right-hand sides\n\
+  -convection <c>    : convection coefficient, 0 gives a symmetric positive definite matrix\n\
+  -dependent         : the last right-hand side is a linear combination of the first two\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat         A, B, X, Xref;
+  Vec         b, x;
+  KSP         ksp;
+  PetscInt    m = 16, n = 16, N = 5, Istart, Iend, its, itsref = 0;
+  PetscReal   convection = 0.0, rtol = 1e-10, *err, *nrm;
+  PetscBool   dependent = PETSC_FALSE;
+  PetscRandom rand;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-N", &N, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-convection", &convection, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-dependent", &dependent, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * n, m * n, 5, NULL, 5, NULL, &A));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    PetscInt i = Ii / n, j = Ii - i * n;
+
+    if (i > 0) PetscCall(MatSetValue(A, Ii, Ii - n, -1.0 - convection, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, Ii, Ii + n, -1.0 + convection, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, Ii, Ii - 1, -1.0 - convection, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, Ii, Ii + 1, -1.0 + convection, INSERT_VALUES));
+    PetscCall(MatSetValue(A, Ii, Ii, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(MatCreateDense(PETSC_COMM_WORLD, Iend - Istart, PETSC_DECIDE, m * n, N, NULL, &B));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &X));
+  PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &Xref));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  PetscCall(MatSetRandom(B, rand));
+  if (dependent && N > 2) {
+    Vec b0, b1;
+
+    PetscCall(MatCreateVecs(A, &b0, &b1));
+    PetscCall(MatGetColumnVector(B, b0, 0));
+    PetscCall(MatGetColumnVector(B, b1, 1));
+    PetscCall(MatDenseGetColumnVecWrite(B, N - 1, &b));
+    PetscCall(VecAXPBYPCZ(b, 2.0, -1.0, 0.0, b0, b1));
+    PetscCall(MatDenseRestoreColumnVecWrite(B, N - 1, &b));
+    PetscCall(VecDestroy(&b1));
+    PetscCall(VecDestroy(&b0));
+  }
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPCG));
+  PetscCall(KSPSetTolerances(ksp, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(KSPSetUp(ksp));
+
+  /* the reference solutions, with the same solver and preconditioner */
+  for (PetscInt j = 0; j < N; j++) {
+    PetscCall(MatDenseGetColumnVecRead(B, j, &b));
+    PetscCall(MatDenseGetColumnVecWrite(Xref, j, &x));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(KSPGetIterationNumber(ksp, &its));
+    itsref = PetscMax(itsref, its);
+    PetscCall(MatDenseRestoreColumnVecWrite(Xref, j, &x));
+    PetscCall(MatDenseRestoreColumnVecRead(B, j, &b));
+  }
+
+  PetscCall(KSPMatSolve(ksp, B, X));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  PetscCall(PetscMalloc2(N, &err, N, &nrm));
+  PetscCall(MatGetColumnNorms(Xref, NORM_2, nrm));
+  PetscCall(MatAXPY(X, -1.0, Xref, SAME_NONZERO_PATTERN));
+  PetscCall(MatGetColumnNorms(X, NORM_2, err));
+  for (PetscInt j = 0; j < N; j++)
+    if (err[j] > 1e-6 * nrm[j]) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Column %" PetscInt_FMT ": relative difference with the reference solution %g\n", j, (double)(err[j] / nrm[j])));
+  /* the block methods need at most as many iterations as the slowest column, up to rounding errors */
+  if (its > itsref + itsref / 10 + 2) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "KSPMatSolve(): %" PetscInt_FMT " iterations instead of at most %" PetscInt_FMT "\n", its, itsref));
+  PetscCall(PetscFree2(err, nrm));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(MatDestroy(&Xref));
+  PetscCall(MatDestroy(&X));
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      test:
+        suffix: cg
+        args: -ksp_cg_matsolve_type {{pseudoblock block}} -pc_type {{none jacobi}}
+      test:
+        suffix: cg_dependent
+        args: -ksp_cg_matsolve_type block -dependent -ksp_matsolve_batch_size 4
+      test:
+        suffix: gmres
+        args: -convection 0.5 -ksp_type gmres -ksp_gmres_matsolve_type {{pseudoblock block}} -ksp_pc_side {{left right}} -ksp_gmres_restart 15
+      test:
+        suffix: gmres_dependent
+        args: -convection 0.5 -ksp_type gmres -ksp_gmres_matsolve_type block -dependent -pc_type jacobi
+      test:
+        suffix: gmres_refine_never
+        args: -convection 0.5 -ksp_type gmres -ksp_gmres_matsolve_type pseudoblock -ksp_gmres_cgs_refinement_type refine_never
+
+TEST*/
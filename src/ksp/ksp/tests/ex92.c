@@ -0,0 +1,95 @@
+static char help[] = "Tests the low-synchronization orthogonalizations of KSPGMRES and KSPFGMRES against classical Gram-Schmidt with refinement.\n\n\
+  -m <m>, -n <n>  : grid dimensions\n\
+  -convection <c> : convection coefficient\n\
+  -orthog <o>     : low-synchronization orthogonalization, lagged_cgs2, dcgs2, or mgs_icwy\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat               A;
+  Vec               b, x, xref, r;
+  KSP               ksp;
+  PetscInt          m = 24, n = 24, Istart, Iend, its, itsref, orthog = 0;
+  PetscReal         convection = 0.5, rtol = 1e-8, nrm, err;
+  const char *const orthogs[] = {"lagged_cgs2", "dcgs2", "mgs_icwy"};
+  PetscErrorCode (*const fcns[])(KSP, PetscInt) = {KSPGMRESLaggedCGS2Orthogonalization, KSPGMRESDCGS2Orthogonalization, KSPGMRESMGSICWYOrthogonalization};
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-convection", &convection, NULL));
+  PetscCall(PetscOptionsGetEList(NULL, NULL, "-orthog", orthogs, PETSC_STATIC_ARRAY_LENGTH(orthogs), &orthog, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * n, m * n, 5, NULL, 5, NULL, &A));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    PetscInt i = Ii / n, j = Ii - i * n;
+
+    if (i > 0) PetscCall(MatSetValue(A, Ii, Ii - n, -1.0 - convection, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, Ii, Ii + n, -1.0 + convection, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, Ii, Ii - 1, -1.0 - convection, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, Ii, Ii + 1, -1.0 + convection, INSERT_VALUES));
+    PetscCall(MatSetValue(A, Ii, Ii, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &xref));
+  PetscCall(VecDuplicate(b, &r));
+  PetscCall(VecSetRandom(b, NULL));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPGMRES));
+  PetscCall(KSPSetTolerances(ksp, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+
+  /* the reference solution, with classical Gram-Schmidt and one step of iterative refinement */
+  PetscCall(KSPGMRESSetOrthogonalization(ksp, KSPGMRESClassicalGramSchmidtOrthogonalization));
+  PetscCall(KSPGMRESSetCGSRefinementType(ksp, KSP_GMRES_CGS_REFINE_ALWAYS));
+  PetscCall(KSPSolve(ksp, b, xref));
+  PetscCall(KSPGetIterationNumber(ksp, &itsref));
+
+  PetscCall(KSPGMRESSetOrthogonalization(ksp, fcns[orthog]));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+
+  /* the true residual, since the residual norms of the low-synchronization orthogonalizations are lagged estimates */
+  PetscCall(MatMult(A, x, r));
+  PetscCall(VecAYPX(r, -1.0, b));
+  PetscCall(VecNorm(r, NORM_2, &err));
+  PetscCall(VecNorm(b, NORM_2, &nrm));
+  if (err > 10 * rtol * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative residual norm %g\n", (double)(err / nrm)));
+  PetscCall(VecAXPY(x, -1.0, xref));
+  PetscCall(VecNorm(x, NORM_2, &err));
+  PetscCall(VecNorm(xref, NORM_2, &nrm));
+  if (err > 1e-5 * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative difference with the reference solution %g\n", (double)(err / nrm)));
+  if (its > itsref + 2) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "%" PetscInt_FMT " iterations instead of %" PetscInt_FMT "\n", its, itsref));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&r));
+  PetscCall(VecDestroy(&xref));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      test:
+        suffix: gmres
+        args: -orthog {{lagged_cgs2 dcgs2 mgs_icwy}} -ksp_pc_side {{left right}} -pc_type jacobi -ksp_gmres_restart {{10 30}}
+      test:
+        suffix: fgmres
+        args: -ksp_type fgmres -orthog {{lagged_cgs2 dcgs2 mgs_icwy}} -pc_type jacobi -ksp_gmres_restart {{10 30}}
+
+TEST*/
@@ -0,0 +1,126 @@
+static char help[] = "Tests the recycling Krylov methods KSPGCRODR and KSPRCG on a sequence of slowly varying linear systems.\n\n\
+  -m <m>, -n <n>  : grid dimensions\n\
+  -convection <c> : convection coefficient, 0 gives a symmetric positive definite matrix\n\
+  -nsolve <s>     : number of linear systems in the sequence\n\n";
+
+#include <petscksp.h>
+
+/* A(t) is a diffusion operator whose coefficient varies slowly with t, taken at the edges so that A is symmetric without convection, plus convection */
+static PetscReal Coefficient(PetscInt m, PetscInt n, PetscReal i, PetscReal j, PetscReal t)
+{
+  return 1.0 + t * PetscSinReal(PETSC_PI * i / m) * PetscSinReal(PETSC_PI * j / n);
+}
+
+static PetscErrorCode FormMatrix(Mat A, PetscInt m, PetscInt n, PetscReal convection, PetscReal t)
+{
+  PetscInt Istart, Iend;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    PetscInt  i = Ii / n, j = Ii - i * n;
+    PetscReal cs = Coefficient(m, n, i - 0.5, j, t), cn = Coefficient(m, n, i + 0.5, j, t), cw = Coefficient(m, n, i, j - 0.5, t), ce = Coefficient(m, n, i, j + 0.5, t);
+
+    if (i > 0) PetscCall(MatSetValue(A, Ii, Ii - n, -cs - convection, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, Ii, Ii + n, -cn + convection, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, Ii, Ii - 1, -cw - convection, INSERT_VALUES));
+    if (j < n - 1) PetscCall(MatSetValue(A, Ii, Ii + 1, -ce + convection, INSERT_VALUES));
+    PetscCall(MatSetValue(A, Ii, Ii, cs + cn + cw + ce, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A;
+  Vec       b, x, r;
+  KSP       ksp, kspref;
+  PC        pc;
+  PCType    type;
+  PCSide    side;
+  PetscInt  m = 32, n = 32, nsolve = 6, its, itsref, total = 0, totalref = 0, restart;
+  PetscReal convection = 0.0, rtol = 1e-8, nrm, err;
+  PetscBool rcg;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nsolve", &nsolve, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-convection", &convection, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * n, m * n, 5, NULL, 5, NULL, &A));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(b, &r));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetType(ksp, convection == 0.0 ? KSPRCG : KSPGCRODR));
+  PetscCall(KSPSetTolerances(ksp, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, PCJACOBI));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp, KSPRCG, &rcg));
+  PetscCall(PCGetType(pc, &type));
+  PetscCall(KSPGetPCSide(ksp, &side));
+  /* the reference solver, without recycling, with the same preconditioner and restart */
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &kspref));
+  PetscCall(KSPSetType(kspref, rcg ? KSPCG : KSPGMRES));
+  PetscCall(KSPSetTolerances(kspref, rtol, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetPCSide(kspref, side));
+  if (!rcg) {
+    PetscCall(KSPGMRESGetRestart(ksp, &restart));
+    PetscCall(KSPGMRESSetRestart(kspref, restart));
+  }
+  PetscCall(KSPGetPC(kspref, &pc));
+  PetscCall(PCSetType(pc, type));
+
+  for (PetscInt s = 0; s < nsolve; s++) {
+    PetscCall(FormMatrix(A, m, n, convection, 0.05 * s));
+    PetscCall(VecSetRandom(b, NULL));
+    PetscCall(KSPSetOperators(ksp, A, A));
+    PetscCall(KSPSetOperators(kspref, A, A));
+    PetscCall(KSPSolve(kspref, b, x));
+    PetscCall(KSPGetIterationNumber(kspref, &itsref));
+    PetscCall(VecZeroEntries(x));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(KSPGetIterationNumber(ksp, &its));
+    PetscCall(MatMult(A, x, r));
+    PetscCall(VecAYPX(r, -1.0, b));
+    PetscCall(VecNorm(r, NORM_2, &err));
+    PetscCall(VecNorm(b, NORM_2, &nrm));
+    if (err > 10 * rtol * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "System %" PetscInt_FMT ": relative residual norm %g\n", s, (double)(err / nrm)));
+    /* the first system is only used to build the recycled subspace */
+    if (s) {
+      total += its;
+      totalref += itsref;
+    }
+  }
+  if (10 * total > 9 * totalref) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "%" PetscInt_FMT " iterations with recycling instead of %" PetscInt_FMT "\n", total, totalref));
+
+  PetscCall(KSPDestroy(&kspref));
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&r));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      test:
+        suffix: rcg
+        args: -pc_type {{none jacobi}} -ksp_norm_type {{preconditioned unpreconditioned natural}}
+      test:
+        suffix: gcrodr
+        args: -convection 0.5 -ksp_pc_side {{left right}} -pc_type {{none jacobi}} -ksp_gmres_restart {{20 40}}
+
+TEST*/
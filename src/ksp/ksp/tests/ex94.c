@@ -0,0 +1,83 @@
+static const char help[] = "Tests KSPECG on a 2D Laplacian, comparing with KSPCG.\n\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat       A;
+  Vec       b, x, r;
+  KSP       ksp;
+  PC        pc;
+  PetscInt  m = 40, Istart, Iend, t, its, itscg;
+  PetscReal rtol, err, nrm;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt i = II / m, j = II % m;
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -1.0, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -1.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -1.0, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(b, &r));
+  PetscCall(VecSetRandom(b, NULL));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, PCJACOBI));
+  PetscCall(KSPSetType(ksp, KSPCG));
+  PetscCall(KSPSetNormType(ksp, KSP_NORM_UNPRECONDITIONED));
+  PetscCall(KSPSetTolerances(ksp, 1e-8, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetIterationNumber(ksp, &itscg));
+
+  PetscCall(KSPSetType(ksp, KSPECG));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  PetscCall(KSPECGGetEnlargingFactor(ksp, &t));
+  PetscCall(KSPGetTolerances(ksp, &rtol, NULL, NULL, NULL));
+
+  PetscCall(MatMult(A, x, r));
+  PetscCall(VecAYPX(r, -1.0, b));
+  PetscCall(VecNorm(r, NORM_2, &err));
+  PetscCall(VecNorm(b, NORM_2, &nrm));
+  if (err > 10 * rtol * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative residual norm %g\n", (double)(err / nrm)));
+  /* with one subdomain the iterates are those of CG, with more the enlarged subspace must need fewer iterations */
+  if (t == 1 ? PetscAbsInt(its - itscg) > 1 : its >= itscg) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Iterations of KSPCG %" PetscInt_FMT ", of KSPECG %" PetscInt_FMT "\n", itscg, its));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&r));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   test:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      args: -ksp_ecg_enlarging_factor {{1 4 16}}
+
+   test:
+      suffix: view
+      requires: !single
+      args: -ksp_ecg_enlarging_factor 4 -ksp_view
+
+TEST*/
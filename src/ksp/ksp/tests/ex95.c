@@ -0,0 +1,113 @@
+static const char help[] = "Tests the eigenvalue estimates of KSPCHEBYSHEV cached on the matrix.\n\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscksp.h>
+
+/* number of MatMult() since the previous call */
+static PetscErrorCode CountMatMult(PetscInt *n)
+{
+  static PetscInt    last = 0;
+  PetscLogEvent      event;
+  PetscEventPerfInfo info;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscLogEventGetId("MatMult", &event));
+  PetscCall(PetscLogEventGetPerfInfo(PETSC_DETERMINE, event, &info));
+  *n   = info.count - last;
+  last = info.count;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateChebyshev(Mat A, KSP *ksp)
+{
+  PC pc;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, ksp));
+  PetscCall(KSPSetOperators(*ksp, A, A));
+  PetscCall(KSPSetType(*ksp, KSPCHEBYSHEV));
+  PetscCall(KSPGetPC(*ksp, &pc));
+  PetscCall(PCSetType(pc, PCJACOBI));
+  PetscCall(KSPSetFromOptions(*ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat      A;
+  Vec      b, x;
+  KSP      ksp1, ksp2;
+  PetscInt m = 32, Istart, Iend, refresh = 0, n;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscLogDefaultBegin());
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-ksp_chebyshev_esteig_refresh", &refresh, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt i = II / m, j = II % m;
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -1.0, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -1.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -1.0, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatSetOption(A, MAT_SPD, PETSC_TRUE));
+  PetscCall(MatSetOption(A, MAT_SPD_ETERNAL, PETSC_TRUE));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecSet(b, 1.0));
+
+  /* the second KSPCHEBYSHEV uses the estimates of the first one */
+  PetscCall(CreateChebyshev(A, &ksp1));
+  PetscCall(CreateChebyshev(A, &ksp2));
+  PetscCall(CountMatMult(&n));
+  PetscCall(KSPSetUp(ksp1));
+  PetscCall(CountMatMult(&n));
+  if (!n) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "The eigenvalues were not estimated\n"));
+  PetscCall(KSPSetUp(ksp2));
+  PetscCall(CountMatMult(&n));
+  if (n) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "The cached estimates were not used, %" PetscInt_FMT " MatMult()\n", n));
+
+  /* new values, the estimates are refreshed with the power method or estimated again */
+  PetscCall(MatShift(A, 1.0));
+  PetscCall(KSPSetOperators(ksp1, A, A));
+  PetscCall(KSPSetUp(ksp1));
+  PetscCall(CountMatMult(&n));
+  if (refresh ? n != refresh : n <= refresh) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "%" PetscInt_FMT " MatMult() to update the estimates\n", n));
+
+  /* the second KSPCHEBYSHEV uses the updated estimates of the first one */
+  PetscCall(KSPSetOperators(ksp2, A, A));
+  PetscCall(KSPSetUp(ksp2));
+  PetscCall(CountMatMult(&n));
+  if (n) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "The cached estimates were not used, %" PetscInt_FMT " MatMult()\n", n));
+  PetscCall(KSPView(ksp2, PETSC_VIEWER_STDOUT_WORLD));
+
+  PetscCall(KSPDestroy(&ksp2));
+  PetscCall(KSPDestroy(&ksp1));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single defined(PETSC_USE_LOG)
+      nsize: {{1 2}}
+      args: -ksp_chebyshev_esteig_cache
+      filter: grep -E "eigenvalue|refreshing"
+      test:
+        suffix: estimate
+      test:
+        suffix: refresh
+        args: -ksp_chebyshev_esteig_refresh 6
+
+TEST*/
@@ -0,0 +1,103 @@
+static const char help[] = "Tests the fused matrix, PCJACOBI and vector update of KSPCHEBYSHEV against the separate operations.\n\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscksp.h>
+
+static PetscErrorCode CreateChebyshev(Mat A, const char prefix[], KSP *ksp)
+{
+  PC pc;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, ksp));
+  PetscCall(KSPSetOptionsPrefix(*ksp, prefix));
+  PetscCall(KSPSetOperators(*ksp, A, A));
+  PetscCall(KSPSetType(*ksp, KSPCHEBYSHEV));
+  PetscCall(KSPChebyshevSetEigenvalues(*ksp, 2.0, 0.2));
+  PetscCall(KSPSetNormType(*ksp, KSP_NORM_NONE));
+  PetscCall(KSPSetTolerances(*ksp, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT, 6));
+  PetscCall(KSPSetInitialGuessNonzero(*ksp, PETSC_TRUE));
+  PetscCall(KSPGetPC(*ksp, &pc));
+  PetscCall(PCSetType(pc, PCJACOBI));
+  PetscCall(KSPSetFromOptions(*ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat                A;
+  Vec                b, x, y;
+  KSP                ksp, kspref;
+  PetscInt           m = 24, Istart, Iend;
+  PetscReal          nrm, err;
+  PetscLogEvent      event;
+  PetscEventPerfInfo info;
+  PetscLogDouble     count;
+  KSPChebyshevKind   kind;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscLogDefaultBegin());
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+
+  /* variable coefficients so that the Jacobi scaling matters */
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt  i = II / m, j = II % m;
+    PetscReal c = 1.0 + (PetscReal)II / (m * m);
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -c, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -c, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -c, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -c, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, 4.0 * c, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &y));
+  PetscCall(VecSetRandom(b, NULL));
+  PetscCall(VecSetRandom(x, NULL));
+  PetscCall(VecCopy(x, y));
+
+  PetscCall(CreateChebyshev(A, NULL, &ksp));
+  PetscCall(KSPChebyshevSetFused(ksp, PETSC_TRUE));
+  PetscCall(CreateChebyshev(A, "ref_", &kspref));
+  PetscCall(KSPChebyshevGetKind(ksp, &kind));
+  PetscCall(KSPChebyshevSetKind(kspref, kind));
+  PetscCall(KSPSetUp(ksp));
+  PetscCall(KSPSetUp(kspref));
+
+  /* the fused sweeps do not call MatMult(), only the initial residual of each solve does */
+  PetscCall(PetscLogEventGetId("MatMult", &event));
+  PetscCall(PetscLogEventGetPerfInfo(PETSC_DETERMINE, event, &info));
+  count = info.count;
+  for (PetscInt k = 0; k < 2; k++) PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(PetscLogEventGetPerfInfo(PETSC_DETERMINE, event, &info));
+  if (info.count - count != 2) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "%g MatMult() in the fused solves\n", info.count - count));
+  for (PetscInt k = 0; k < 2; k++) PetscCall(KSPSolve(kspref, b, y));
+
+  PetscCall(VecNorm(y, NORM_2, &nrm));
+  PetscCall(VecAXPY(y, -1.0, x));
+  PetscCall(VecNorm(y, NORM_2, &err));
+  if (err > 100 * PETSC_MACHINE_EPSILON * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative difference with the separate operations %g\n", (double)(err / nrm)));
+
+  PetscCall(KSPDestroy(&kspref));
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   test:
+      requires: defined(PETSC_USE_LOG)
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      args: -ksp_chebyshev_kind {{first fourth opt_fourth}}
+
+TEST*/
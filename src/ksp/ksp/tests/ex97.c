@@ -0,0 +1,113 @@
+static const char help[] = "Tests KSPMatSolve() with the MPI linear solver server, all the right-hand sides being sent in a single request.\n\n\
+  -m <m>    : number of grid points in each direction\n\
+  -nrhs <n> : number of right-hand sides\n\n";
+
+#include <petscksp.h>
+
+/* the 5-point Laplacian, when using the server the matrix lives on rank 0 only */
+static PetscErrorCode CreateMatrix(PetscInt m, Mat *A)
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatCreateSeqAIJ(PETSC_COMM_SELF, m * m, m * m, 5, NULL, A));
+  for (PetscInt II = 0; II < m * m; II++) {
+    PetscInt i = II / m, j = II % m;
+
+    if (i > 0) PetscCall(MatSetValue(*A, II, II - m, -1.0, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(*A, II, II + m, -1.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(*A, II, II - 1, -1.0, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(*A, II, II + 1, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(*A, II, II, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(*A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(*A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateDense(PetscInt n, PetscInt ncols, PetscInt lda, Mat *B)
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatCreate(PETSC_COMM_SELF, B));
+  PetscCall(MatSetSizes(*B, n, ncols, n, ncols));
+  PetscCall(MatSetType(*B, MATSEQDENSE));
+  PetscCall(MatDenseSetLDA(*B, lda));
+  PetscCall(MatSetUp(*B));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* each column of the solution must be the one computed with KSPSolve(), the columns are copied since PCMPI cannot use vectors with arrays provided by the user */
+static PetscErrorCode CheckSolution(KSP ksp, Mat B, Mat X)
+{
+  Vec       b, x, xref;
+  PetscInt  nrhs;
+  PetscReal nrm, nrmref;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatGetSize(B, NULL, &nrhs));
+  PetscCall(MatCreateVecs(B, NULL, &b));
+  PetscCall(VecDuplicate(b, &x));
+  PetscCall(VecDuplicate(b, &xref));
+  for (PetscInt j = 0; j < nrhs; j++) {
+    PetscCall(MatGetColumnVector(B, b, j));
+    PetscCall(MatGetColumnVector(X, x, j));
+    PetscCall(KSPSolve(ksp, b, xref));
+    PetscCall(VecNorm(xref, NORM_2, &nrmref));
+    PetscCall(VecAXPY(xref, -1.0, x));
+    PetscCall(VecNorm(xref, NORM_2, &nrm));
+    if (nrm > 1e-6 * nrmref) PetscCall(PetscPrintf(PETSC_COMM_SELF, "Column %" PetscInt_FMT ": relative difference of the solutions %g\n", j, (double)(nrm / nrmref)));
+  }
+  PetscCall(VecDestroy(&b));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&xref));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat      A, B, X;
+  KSP      ksp;
+  PetscInt m = 16, nrhs = 4;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nrhs", &nrhs, NULL));
+
+  PetscCall(CreateMatrix(m, &A));
+  PetscCall(KSPCreate(PETSC_COMM_SELF, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetFromOptions(ksp));
+
+  /* the second KSPMatSolve() has more right-hand sides and a leading dimension larger than the number of rows */
+  for (PetscInt k = 0; k < 2; k++) {
+    PetscInt n = m * m, lda = k ? n + 3 : n, ncols = k ? 2 * nrhs : nrhs;
+
+    PetscCall(CreateDense(n, ncols, lda, &B));
+    PetscCall(CreateDense(n, ncols, lda, &X));
+    PetscCall(MatSetRandom(B, NULL));
+    PetscCall(KSPMatSolve(ksp, B, X));
+    PetscCall(CheckSolution(ksp, B, X));
+    PetscCall(MatDestroy(&B));
+    PetscCall(MatDestroy(&X));
+  }
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: defined(PETSC_USE_SINGLE_LIBRARY) !single
+      output_file: output/empty.out
+      args: -mpi_linear_solver_server -mpi_linear_solver_server_minimum_count_per_rank 50 -ksp_rtol 1e-10
+      test:
+        suffix: server
+        nsize: 3
+        args: -mpi_linear_solver_server_use_shared_memory {{true false}} -ksp_type {{cg gmres}} -pc_type jacobi
+      test:
+        suffix: server_seq
+        args: -pc_type lu
+
+TEST*/
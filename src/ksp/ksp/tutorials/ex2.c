@@ -277,6 +277,11 @@ int main(int argc, char **args)
       suffix: fbcgs
       args: -ksp_type fbcgs -pc_type ilu
 
+   test:
+      suffix: lag_norm
+      nsize: 2
+      args: -ksp_type {{cg bcgs}separate output} -ksp_norm_type {{preconditioned unpreconditioned}separate output} -ksp_lag_norm -ksp_monitor
+
    test:
       suffix: fbcgs_2
       nsize: 3
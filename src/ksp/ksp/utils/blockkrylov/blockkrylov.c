@@ -0,0 +1,305 @@
+/*
+   Kernels on blocks of vectors shared by the block and pseudo-block Krylov methods used by KSPMatSolve() with KSPCG and KSPGMRES.
+
+   The blocks are MATDENSE, possibly obtained with MatDenseGetSubMatrix(), and the small matrices of coefficients are stored
+   column-major and are redundant on all processes.
+*/
+#include <petsc/private/kspblockimpl.h> /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+/* Y = Op X where Op is A or its transpose depending on the solve, *Y is created the first time and then reused */
+PetscErrorCode KSPBlockMatMult_Private(KSP ksp, Mat A, Mat X, Mat *Y)
+{
+  PetscFunctionBegin;
+  if (!ksp->transpose_solve) PetscCall(MatMatMult(A, X, *Y ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX, PETSC_DETERMINE, Y));
+  else PetscCall(MatTransposeMatMult(A, X, *Y ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX, PETSC_DETERMINE, Y));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* local part of G = X^H Y, where G is nx x ny with leading dimension nx */
+static PetscErrorCode KSPBlockDotLocal_Private(Mat X, Mat Y, PetscScalar G[])
+{
+  const PetscScalar *x, *y;
+  PetscInt           m, nx, ny, ldx, ldy;
+  PetscBLASInt       bm, bnx, bny, bldx, bldy;
+  PetscScalar        one = 1.0, zero = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(X, &m, NULL));
+  PetscCall(MatGetSize(X, NULL, &nx));
+  PetscCall(MatGetSize(Y, NULL, &ny));
+  PetscCall(MatDenseGetLDA(X, &ldx));
+  PetscCall(MatDenseGetLDA(Y, &ldy));
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(PetscBLASIntCast(nx, &bnx));
+  PetscCall(PetscBLASIntCast(ny, &bny));
+  PetscCall(PetscBLASIntCast(PetscMax(ldx, 1), &bldx));
+  PetscCall(PetscBLASIntCast(PetscMax(ldy, 1), &bldy));
+  if (m && nx && ny) {
+    PetscCall(MatDenseGetArrayRead(X, &x));
+    PetscCall(MatDenseGetArrayRead(Y, &y));
+    PetscCallBLAS("BLASgemm", BLASgemm_("C", "N", &bnx, &bny, &bm, &one, x, &bldx, y, &bldy, &zero, G, &bnx));
+    PetscCall(MatDenseRestoreArrayRead(Y, &y));
+    PetscCall(MatDenseRestoreArrayRead(X, &x));
+    PetscCall(PetscLogFlops(2.0 * m * nx * ny));
+  } else PetscCall(PetscArrayzero(G, nx * ny));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* G = X^H Y, where G is nx x ny with leading dimension nx */
+PetscErrorCode KSPBlockDot_Private(Mat X, Mat Y, PetscScalar G[])
+{
+  PetscInt nx, ny;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(X, NULL, &nx));
+  PetscCall(MatGetSize(Y, NULL, &ny));
+  PetscCall(KSPBlockDotLocal_Private(X, Y, G));
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, G, (PetscMPIInt)(nx * ny), MPIU_SCALAR, MPIU_SUM, PetscObjectComm((PetscObject)X)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* G[k] = X[k]^H Y[k] for 0 <= k < n as KSPBlockDot_Private() does, with a single global reduction */
+PetscErrorCode KSPBlockDots_Private(PetscInt n, const Mat X[], const Mat Y[], PetscScalar *G[])
+{
+  PetscScalar *buf;
+  PetscInt     size = 0, *offset, nx, ny;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc1(n + 1, &offset));
+  for (PetscInt k = 0; k < n; k++) {
+    PetscCall(MatGetSize(X[k], NULL, &nx));
+    PetscCall(MatGetSize(Y[k], NULL, &ny));
+    offset[k] = size;
+    size += nx * ny;
+  }
+  offset[n] = size;
+  PetscCall(PetscMalloc1(size, &buf));
+  for (PetscInt k = 0; k < n; k++) PetscCall(KSPBlockDotLocal_Private(X[k], Y[k], buf + offset[k]));
+  if (n) PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, buf, (PetscMPIInt)size, MPIU_SCALAR, MPIU_SUM, PetscObjectComm((PetscObject)X[0])));
+  for (PetscInt k = 0; k < n; k++) PetscCall(PetscArraycpy(G[k], buf + offset[k], offset[k + 1] - offset[k]));
+  PetscCall(PetscFree(buf));
+  PetscCall(PetscFree(offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   d[c] = X(:,c)^H Y(:,c % ny), where the number of columns of X is a multiple of the number ny of columns of Y,
+   so the inner products of all the columns of several blocks X_i with the matching columns of Y need a single reduction
+*/
+PetscErrorCode KSPBlockColumnDot_Private(Mat X, Mat Y, PetscScalar d[])
+{
+  const PetscScalar *x, *y;
+  PetscInt           m, nx, ny, ldx, ldy;
+  PetscBLASInt       bm, one = 1;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(X, &m, NULL));
+  PetscCall(MatGetSize(X, NULL, &nx));
+  PetscCall(MatGetSize(Y, NULL, &ny));
+  PetscCheck(ny && nx % ny == 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Number of columns %" PetscInt_FMT " not a multiple of %" PetscInt_FMT, nx, ny);
+  PetscCall(MatDenseGetLDA(X, &ldx));
+  PetscCall(MatDenseGetLDA(Y, &ldy));
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(MatDenseGetArrayRead(X, &x));
+  PetscCall(MatDenseGetArrayRead(Y, &y));
+  for (PetscInt c = 0; c < nx; c++) d[c] = m ? BLASdot_(&bm, x + c * ldx, &one, y + (c % ny) * ldy, &one) : 0.0;
+  PetscCall(MatDenseRestoreArrayRead(Y, &y));
+  PetscCall(MatDenseRestoreArrayRead(X, &x));
+  PetscCall(PetscLogFlops(2.0 * m * nx));
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, d, (PetscMPIInt)nx, MPIU_SCALAR, MPIU_SUM, PetscObjectComm((PetscObject)X)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Y = beta Y + alpha X C, where C has as many rows as X has columns and as many columns as Y, Y and X must not share storage */
+PetscErrorCode KSPBlockGEMM_Private(PetscScalar beta, Mat Y, PetscScalar alpha, Mat X, const PetscScalar C[], PetscInt ldc)
+{
+  const PetscScalar *x;
+  PetscScalar       *y;
+  PetscInt           m, nx, ny, ldx, ldy;
+  PetscBLASInt       bm, bnx, bny, bldx, bldy, bldc;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(Y, &m, NULL));
+  PetscCall(MatGetSize(X, NULL, &nx));
+  PetscCall(MatGetSize(Y, NULL, &ny));
+  if (!m || !ny) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(MatDenseGetLDA(X, &ldx));
+  PetscCall(MatDenseGetLDA(Y, &ldy));
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(PetscBLASIntCast(nx, &bnx));
+  PetscCall(PetscBLASIntCast(ny, &bny));
+  PetscCall(PetscBLASIntCast(ldx, &bldx));
+  PetscCall(PetscBLASIntCast(ldy, &bldy));
+  PetscCall(PetscBLASIntCast(PetscMax(ldc, 1), &bldc));
+  if (beta == (PetscScalar)0.0) PetscCall(MatDenseGetArrayWrite(Y, &y));
+  else PetscCall(MatDenseGetArray(Y, &y));
+  if (nx) {
+    PetscCall(MatDenseGetArrayRead(X, &x));
+    PetscCallBLAS("BLASgemm", BLASgemm_("N", "N", &bm, &bny, &bnx, &alpha, x, &bldx, C, &bldc, &beta, y, &bldy));
+    PetscCall(MatDenseRestoreArrayRead(X, &x));
+    PetscCall(PetscLogFlops(2.0 * m * nx * ny));
+  } else if (beta != (PetscScalar)1.0) {
+    for (PetscInt j = 0; j < ny; j++)
+      for (PetscInt i = 0; i < m; i++) y[i + j * ldy] = beta == (PetscScalar)0.0 ? 0.0 : beta * y[i + j * ldy];
+  }
+  if (beta == (PetscScalar)0.0) PetscCall(MatDenseRestoreArrayWrite(Y, &y));
+  else PetscCall(MatDenseRestoreArray(Y, &y));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Y(:,c % ny) += alpha d[c] X(:,c), the counterpart of KSPBlockColumnDot_Private() */
+PetscErrorCode KSPBlockColumnMAXPY_Private(Mat Y, PetscScalar alpha, Mat X, const PetscScalar d[])
+{
+  const PetscScalar *x;
+  PetscScalar       *y;
+  PetscInt           m, nx, ny, ldx, ldy;
+  PetscBLASInt       bm, one = 1;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(Y, &m, NULL));
+  PetscCall(MatGetSize(X, NULL, &nx));
+  PetscCall(MatGetSize(Y, NULL, &ny));
+  PetscCheck(ny && nx % ny == 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Number of columns %" PetscInt_FMT " not a multiple of %" PetscInt_FMT, nx, ny);
+  if (!m) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(MatDenseGetLDA(X, &ldx));
+  PetscCall(MatDenseGetLDA(Y, &ldy));
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(MatDenseGetArrayRead(X, &x));
+  PetscCall(MatDenseGetArray(Y, &y));
+  for (PetscInt c = 0; c < nx; c++) {
+    PetscScalar a = alpha * d[c];
+
+    if (a != (PetscScalar)0.0) PetscCallBLAS("BLASaxpy", BLASaxpy_(&bm, &a, x + c * ldx, &one, y + (c % ny) * ldy, &one));
+  }
+  PetscCall(MatDenseRestoreArray(Y, &y));
+  PetscCall(MatDenseRestoreArrayRead(X, &x));
+  PetscCall(PetscLogFlops(2.0 * m * nx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Given the n x n Hermitian positive semi-definite Gram matrix G = W^H B W of a block W for some inner product B, computes the
+   n x r matrix T and the r x n matrix S such that W T is B-orthonormal and W = (W T) S up to the dropped directions. The directions
+   dropped are the ones of the eigenvalues of D G D at most max(rtol lambda_max, atol), where D is the diagonal scaling d, or the
+   identity if d is NULL. A zero entry of d marks a zero column of W. T has leading dimension n and S, which may be NULL, leading
+   dimension r. G is overwritten.
+*/
+PetscErrorCode KSPBlockGramFactor_Private(PetscInt n, PetscScalar G[], const PetscReal d[], PetscReal rtol, PetscReal atol, PetscScalar T[], PetscScalar S[], PetscInt *rank)
+{
+  PetscScalar *work;
+  PetscReal   *lambda, tol;
+  PetscBLASInt bn, lwork;
+  PetscInt     r = 0;
+#if PetscDefined(USE_COMPLEX)
+  PetscReal *rwork;
+#endif
+
+  PetscFunctionBegin;
+  *rank = 0;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  if (d)
+    for (PetscInt j = 0; j < n; j++)
+      for (PetscInt i = 0; i < n; i++) G[i + j * n] *= d[i] * d[j];
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(5 * n, &lwork));
+  PetscCall(PetscMalloc2(n, &lambda, 5 * n, &work));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if PetscDefined(USE_COMPLEX)
+  PetscCall(PetscMalloc1(3 * n, &rwork));
+  PetscCallLAPACKInfo("LAPACKsyev", LAPACKsyev_("V", "U", &bn, G, &bn, lambda, work, &lwork, rwork, &info));
+  PetscCall(PetscFree(rwork));
+#else
+  PetscCallLAPACKInfo("LAPACKsyev", LAPACKsyev_("V", "U", &bn, G, &bn, lambda, work, &lwork, &info));
+#endif
+  PetscCall(PetscFPTrapPop());
+  /* the eigenvalues are in ascending order, the kept directions are ordered by decreasing eigenvalue */
+  tol = PetscMax(rtol * lambda[n - 1], atol);
+  for (PetscInt i = n - 1; i >= 0 && lambda[i] > tol && lambda[i] > 0.0; i--, r++) {
+    PetscReal sigma = PetscSqrtReal(lambda[i]);
+
+    for (PetscInt j = 0; j < n; j++) T[j + r * n] = (d ? d[j] : 1.0) * G[j + i * n] / sigma;
+  }
+  for (PetscInt k = 0; k < r && S; k++) {
+    PetscReal sigma = PetscSqrtReal(lambda[n - 1 - k]);
+
+    for (PetscInt j = 0; j < n; j++) S[k + j * r] = (d && d[j] == 0.0) ? 0.0 : sigma * PetscConj(G[j + (n - 1 - k) * n]) / (d ? d[j] : 1.0);
+  }
+  PetscCall(PetscFree2(lambda, work));
+  *rank = r;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Y(:,iy[j]) = X(:,ix[j]) or Y(:,iy[j]) += X(:,ix[j]) depending on mode, for 0 <= j < n, a NULL index set stands for the identity */
+PetscErrorCode KSPBlockCopyColumns_Private(PetscInt n, Mat X, const PetscInt ix[], Mat Y, const PetscInt iy[], InsertMode mode)
+{
+  Vec x, y;
+
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < n; j++) {
+    PetscCall(MatDenseGetColumnVecRead(X, ix ? ix[j] : j, &x));
+    if (mode == INSERT_VALUES) {
+      PetscCall(MatDenseGetColumnVecWrite(Y, iy ? iy[j] : j, &y));
+      PetscCall(VecCopy(x, y));
+      PetscCall(MatDenseRestoreColumnVecWrite(Y, iy ? iy[j] : j, &y));
+    } else {
+      PetscCall(MatDenseGetColumnVec(Y, iy ? iy[j] : j, &y));
+      PetscCall(VecAXPY(y, 1.0, x));
+      PetscCall(MatDenseRestoreColumnVec(Y, iy ? iy[j] : j, &y));
+    }
+    PetscCall(MatDenseRestoreColumnVecRead(X, ix ? ix[j] : j, &x));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Convergence test of the n columns of a block, each column is tested as KSPConvergedDefault() would do relative to its own
+   initial residual norm norms0[j]. Sets ksp->rnorm to the largest residual norm, flags the columns that have converged, and
+   declares convergence when all of them have.
+*/
+PetscErrorCode KSPBlockConverged_Private(KSP ksp, PetscInt it, PetscInt n, const PetscReal norms[], const PetscReal norms0[], PetscBool converged[], KSPConvergedReason *reason)
+{
+  PetscReal rnorm = 0.0;
+  PetscBool atol = PETSC_FALSE, all = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  *reason = KSP_CONVERGED_ITERATING;
+  for (PetscInt j = 0; j < n; j++) {
+    if (PetscIsInfOrNanReal(norms[j])) rnorm = norms[j];
+    else if (!PetscIsInfOrNanReal(rnorm)) rnorm = PetscMax(rnorm, norms[j]);
+  }
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = rnorm;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  if (ksp->normtype == KSP_NORM_NONE) {
+    for (PetscInt j = 0; j < n; j++) converged[j] = PETSC_FALSE;
+    if (it >= ksp->max_it) *reason = KSP_CONVERGED_ITS;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (PetscIsInfOrNanReal(rnorm)) {
+    PCFailedReason pcreason;
+
+    PetscCall(PCReduceFailedReason(ksp->pc));
+    PetscCall(PCGetFailedReason(ksp->pc, &pcreason));
+    *reason = pcreason ? KSP_DIVERGED_PC_FAILED : KSP_DIVERGED_NANORINF;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (PetscInt j = 0; j < n; j++) {
+    converged[j] = (PetscBool)(norms[j] <= PetscMax(ksp->rtol * norms0[j], ksp->abstol));
+    if (converged[j] && norms[j] > ksp->rtol * norms0[j]) atol = PETSC_TRUE;
+    if (!converged[j]) all = PETSC_FALSE;
+    if (norms[j] >= ksp->divtol * norms0[j] && norms0[j] > 0.0) {
+      PetscCall(PetscInfo(ksp, "Linear solver is diverging. Initial residual norm %14.12e, current residual norm %14.12e of column %" PetscInt_FMT " at iteration %" PetscInt_FMT "\n", (double)norms0[j], (double)norms[j], j, it));
+      *reason = KSP_DIVERGED_DTOL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  if (all && it >= ksp->min_it) {
+    PetscCall(PetscInfo(ksp, "Linear solver has converged. Largest residual norm of the %" PetscInt_FMT " columns %14.12e at iteration %" PetscInt_FMT "\n", n, (double)rnorm, it));
+    *reason = atol ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+  } else if (it >= ksp->max_it) {
+    PetscCall(PetscInfo(ksp, "Linear solver has not converged. Maximum number of iterations reached %" PetscInt_FMT "\n", it));
+    *reason = KSP_DIVERGED_ITS;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,637 @@
+/*
+   Polynomial bases and matrix powers kernel shared by the communication-avoiding Krylov methods KSPCACG and KSPCAGMRES.
+
+   A block of s iterations of these methods first generates s vectors v_{j+1} = p_{j+1}(Op) v_0 with no global reduction, then
+   orthogonalizes them with a single reduction. The polynomials satisfy the three-term recurrence
+
+       Op v_j = c_j v_{j+1} + a_j v_j + b_j v_{j-1},   0 <= j < s,
+
+   and the (s+1) x s tridiagonal matrix of the coefficients, the change of basis, lets the methods express Op applied to a combination
+   of the vectors in terms of the vectors.
+*/
+#include <petsc/private/kspcaimpl.h> /*I "petscksp.h" I*/
+
+static PetscErrorCode KSPCAGetContext(KSP ksp, KSP_CA **ca)
+{
+  PetscErrorCode (*f)(KSP, KSP_CA **);
+
+  PetscFunctionBegin;
+  *ca = NULL;
+  PetscCall(PetscObjectQueryFunction((PetscObject)ksp, "KSPCAGetContext_C", &f));
+  if (f) PetscCall((*f)(ksp, ca));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Drops the shifts and the data of the matrix powers kernel, which depend on the step size */
+static PetscErrorCode KSPCAChangeStepSize(KSP ksp, KSP_CA *ca, PetscInt s)
+{
+  PetscFunctionBegin;
+  if (s == ca->s) PetscFunctionReturn(PETSC_SUCCESS);
+  if (ksp->setupstage != KSP_SETUP_NEW) {
+    PetscTryTypeMethod(ksp, reset);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  ca->s = s;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCASetStepSize - Sets the number of iterations performed by `KSPCACG` and `KSPCAGMRES` for each global reduction
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov solver context
+- s   - the number of iterations per block, the default is 4
+
+  Options Database Key:
+. -ksp_ca_s s - number of iterations per block
+
+  Level: intermediate
+
+  Note:
+  A block of `s` iterations applies the operator `s` times in `KSPCAGMRES`, and `2s-1` times in `KSPCACG`, before orthogonalizing
+  the new vectors with a single global reduction. Large values of `s` reduce the number of global reductions but the basis of
+  the block becomes ill-conditioned, which delays the convergence. Values up to 8 or 10 are usually safe with the Newton or
+  Chebyshev basis, see `KSPCASetBasisType()`.
+
+.seealso: [](ch_ksp), `KSP`, `KSPCACG`, `KSPCAGMRES`, `KSPCAGetStepSize()`, `KSPCASetBasisType()`
+@*/
+PetscErrorCode KSPCASetStepSize(KSP ksp, PetscInt s)
+{
+  KSP_CA *ca;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, s, 2);
+  PetscCheck(s >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Step size %" PetscInt_FMT " must be positive", s);
+  PetscCall(KSPCAGetContext(ksp, &ca));
+  if (ca) PetscCall(KSPCAChangeStepSize(ksp, ca, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCAGetStepSize - Gets the number of iterations performed by `KSPCACG` and `KSPCAGMRES` for each global reduction
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov solver context
+
+  Output Parameter:
+. s - the number of iterations per block
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSP`, `KSPCACG`, `KSPCAGMRES`, `KSPCASetStepSize()`
+@*/
+PetscErrorCode KSPCAGetStepSize(KSP ksp, PetscInt *s)
+{
+  KSP_CA *ca;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(s, 2);
+  PetscCall(KSPCAGetContext(ksp, &ca));
+  PetscCheck(ca, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Not for KSP type %s", ((PetscObject)ksp)->type_name);
+  *s = ca->s;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCASetBasisType - Sets the polynomial basis used by `KSPCACG` and `KSPCAGMRES` to generate the vectors of a block of iterations
+
+  Logically Collective
+
+  Input Parameters:
++ ksp  - the Krylov solver context
+- type - the basis type, `KSP_CA_BASIS_NEWTON` by default
+
+  Options Database Key:
+. -ksp_ca_basis_type (monomial|newton|chebyshev) - the basis type
+
+  Level: advanced
+
+  Note:
+  Unless the bounds of the spectrum are provided with `KSPCASetEigenvalues()`, the shifts of the Newton and Chebyshev bases are
+  computed from the Ritz values of the operator given by the first `s` iterations of a solve, which are performed with the
+  standard method. These shifts are reused by later solves until the operators change.
+
+.seealso: [](ch_ksp), `KSP`, `KSPCACG`, `KSPCAGMRES`, `KSPCABasisType`, `KSPCAGetBasisType()`, `KSPCASetStepSize()`, `KSPCASetEigenvalues()`
+@*/
+PetscErrorCode KSPCASetBasisType(KSP ksp, KSPCABasisType type)
+{
+  KSP_CA *ca;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveEnum(ksp, type, 2);
+  PetscCall(KSPCAGetContext(ksp, &ca));
+  if (ca && ca->basistype != type) {
+    ca->basistype = type;
+    ca->shifts    = PETSC_FALSE;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCAGetBasisType - Gets the polynomial basis used by `KSPCACG` and `KSPCAGMRES` to generate the vectors of a block of iterations
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov solver context
+
+  Output Parameter:
+. type - the basis type
+
+  Level: advanced
+
+.seealso: [](ch_ksp), `KSP`, `KSPCACG`, `KSPCAGMRES`, `KSPCABasisType`, `KSPCASetBasisType()`
+@*/
+PetscErrorCode KSPCAGetBasisType(KSP ksp, KSPCABasisType *type)
+{
+  KSP_CA *ca;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(type, 2);
+  PetscCall(KSPCAGetContext(ksp, &ca));
+  PetscCheck(ca, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Not for KSP type %s", ((PetscObject)ksp)->type_name);
+  *type = ca->basistype;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCASetEigenvalues - Sets bounds of the (real part of the) spectrum of the preconditioned operator used to build the
+  Newton or Chebyshev basis of `KSPCACG` and `KSPCAGMRES`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp  - the Krylov solver context
+. emax - the estimate of the largest eigenvalue
+- emin - the estimate of the smallest eigenvalue
+
+  Options Database Key:
+. -ksp_ca_eigenvalues emin,emax - the bounds of the spectrum
+
+  Level: advanced
+
+  Notes:
+  With the bounds provided, the Chebyshev basis uses the Chebyshev polynomials of the interval [`emin`, `emax`] and the Newton basis
+  uses the Leja-ordered Chebyshev points of this interval as shifts. The first iterations of a solve are then performed with the
+  communication-avoiding method as well, since no Ritz values need to be computed.
+
+  Pass `emax` = `emin` = 0 to compute the shifts from Ritz values again.
+
+.seealso: [](ch_ksp), `KSP`, `KSPCACG`, `KSPCAGMRES`, `KSPCASetBasisType()`, `KSPChebyshevSetEigenvalues()`
+@*/
+PetscErrorCode KSPCASetEigenvalues(KSP ksp, PetscReal emax, PetscReal emin)
+{
+  KSP_CA *ca;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveReal(ksp, emax, 2);
+  PetscValidLogicalCollectiveReal(ksp, emin, 3);
+  PetscCheck(emax >= emin, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_INCOMP, "Maximum eigenvalue must be larger than minimum: max %g min %g", (double)emax, (double)emin);
+  PetscCall(KSPCAGetContext(ksp, &ca));
+  if (ca) {
+    ca->emax       = emax;
+    ca->emin       = emin;
+    ca->userbounds = (PetscBool)(emax != 0.0 || emin != 0.0);
+    ca->shifts     = PETSC_FALSE;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPCASetUseMatrixPowers - Use a matrix powers kernel to generate the vectors of a block of iterations of `KSPCACG` and `KSPCAGMRES`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov solver context
+- flg - `PETSC_TRUE` to use the matrix powers kernel
+
+  Options Database Key:
+. -ksp_ca_matrix_powers (true|false) - use the matrix powers kernel
+
+  Level: advanced
+
+  Notes:
+  The matrix powers kernel extracts, on each MPI process, the rows and columns of the matrix within distance `s` of its local rows
+  in the graph of the matrix, see `MatIncreaseOverlap()`. A block of iterations then gathers the ghost values of the starting
+  vector on this overlap with a single neighbor communication and computes the `s` vectors of the block locally, instead of
+  communicating in each of the `s` matrix-vector products. The redundant computations on the overlap make this worthwhile only when
+  the latency of the communication dominates, for example with few unknowns per process.
+
+  The matrix powers kernel is used only with a `MATMPIAIJ` operator, `PCNONE`, no diagonal scaling and no null space attached to the
+  operator; the standard matrix-vector product is used otherwise.
+
+.seealso: [](ch_ksp), `KSP`, `KSPCACG`, `KSPCAGMRES`, `KSPCASetStepSize()`, `MatIncreaseOverlap()`
+@*/
+PetscErrorCode KSPCASetUseMatrixPowers(KSP ksp, PetscBool flg)
+{
+  KSP_CA *ca;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(ksp, flg, 2);
+  PetscCall(KSPCAGetContext(ksp, &ca));
+  if (ca) ca->mpk = flg;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPCAInitialize_Private(KSP_CA *ca)
+{
+  PetscFunctionBegin;
+  ca->s         = 4;
+  ca->basistype = KSP_CA_BASIS_NEWTON;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPCASetFromOptions_Private(KSP ksp, KSP_CA *ca, PetscOptionItems PetscOptionsObject)
+{
+  PetscInt       s = ca->s, neig = 2;
+  PetscReal      eminmax[2] = {ca->emin, ca->emax};
+  KSPCABasisType type       = ca->basistype;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP communication-avoiding options");
+  PetscCall(PetscOptionsBoundedInt("-ksp_ca_s", "Number of iterations per global reduction", "KSPCASetStepSize", s, &s, &flg, 1));
+  if (flg) PetscCall(KSPCASetStepSize(ksp, s));
+  PetscCall(PetscOptionsEnum("-ksp_ca_basis_type", "Polynomial basis of a block of iterations", "KSPCASetBasisType", KSPCABasisTypes, (PetscEnum)type, (PetscEnum *)&type, &flg));
+  if (flg) PetscCall(KSPCASetBasisType(ksp, type));
+  PetscCall(PetscOptionsRealArray("-ksp_ca_eigenvalues", "Bounds of the spectrum used to build the basis", "KSPCASetEigenvalues", eminmax, &neig, &flg));
+  if (flg) {
+    PetscCheck(neig == 2, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_INCOMP, "-ksp_ca_eigenvalues: must specify 2 parameters, min and max eigenvalues");
+    PetscCall(KSPCASetEigenvalues(ksp, eminmax[1], eminmax[0]));
+  }
+  PetscCall(PetscOptionsBool("-ksp_ca_matrix_powers", "Use the matrix powers kernel", "KSPCASetUseMatrixPowers", ca->mpk, &ca->mpk, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPCAView_Private(KSP_CA *ca, PetscViewer viewer)
+{
+  PetscBool isascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  %" PetscInt_FMT " iterations per global reduction, %s basis\n", ca->s, KSPCABasisTypes[ca->basistype]));
+    if (ca->userbounds) PetscCall(PetscViewerASCIIPrintf(viewer, "  bounds of the spectrum: min %g, max %g\n", (double)ca->emin, (double)ca->emax));
+    if (ca->mpk) PetscCall(PetscViewerASCIIPrintf(viewer, "  using the matrix powers kernel when possible\n"));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPCASetUp_Private(KSP ksp, KSP_CA *ca)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc3(ca->s, &ca->a, ca->s, &ca->b, ca->s, &ca->c));
+  ca->shifts = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPCAReset_Private(KSP_CA *ca)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree3(ca->a, ca->b, ca->c));
+  ca->shifts = PETSC_FALSE;
+  if (ca->Xloc) PetscCall(VecDestroyVecs(ca->s + 1, &ca->Xloc));
+  PetscCall(MatDestroySubMatrices(1, &ca->Aloc));
+  PetscCall(ISDestroy(&ca->ovl));
+  PetscCall(VecScatterDestroy(&ca->scatter));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Orders m (complex) values such that each one maximizes the product of its distances to the previous ones. In real arithmetic
+   the conjugate pairs are kept together, the one with a positive imaginary part first, so they can be applied in real arithmetic */
+static PetscErrorCode KSPCALejaOrder(PetscInt m, const PetscReal re[], const PetscReal im[], PetscInt perm[])
+{
+  PetscBool *chosen;
+  PetscBool  pairs = PetscDefined(USE_COMPLEX) ? PETSC_FALSE : PETSC_TRUE;
+
+  PetscFunctionBegin;
+  PetscCall(PetscCalloc1(m, &chosen));
+  for (PetscInt k = 0; k < m;) {
+    PetscInt  best    = -1;
+    PetscReal bestval = PETSC_MIN_REAL;
+
+    for (PetscInt i = 0; i < m; i++) {
+      PetscReal val = 0.0;
+
+      if (chosen[i] || (pairs && im[i] < 0.0)) continue;
+      if (!k) val = PetscSqrtReal(re[i] * re[i] + im[i] * im[i]);
+      else {
+        for (PetscInt l = 0; l < k; l++) {
+          PetscReal dist = PetscSqrtReal(PetscSqr(re[i] - re[perm[l]]) + PetscSqr(im[i] - im[perm[l]]));
+
+          if (dist == 0.0) {
+            val = PETSC_MIN_REAL;
+            break;
+          }
+          val += PetscLogReal(dist);
+        }
+      }
+      if (best < 0 || val > bestval) {
+        best    = i;
+        bestval = val;
+      }
+    }
+    if (best < 0) { /* only unpaired values with negative imaginary parts are left */
+      for (PetscInt i = 0; i < m; i++)
+        if (!chosen[i]) perm[k++] = i;
+      break;
+    }
+    chosen[best] = PETSC_TRUE;
+    perm[k++]    = best;
+    if (pairs && im[best] > 0.0) {
+      PetscInt  conj = -1;
+      PetscReal dist = PETSC_MAX_REAL;
+
+      for (PetscInt i = 0; i < m; i++) {
+        if (chosen[i] || im[i] >= 0.0) continue;
+        if (PetscAbsReal(re[i] - re[best]) + PetscAbsReal(im[i] + im[best]) < dist) {
+          conj = i;
+          dist = PetscAbsReal(re[i] - re[best]) + PetscAbsReal(im[i] + im[best]);
+        }
+      }
+      if (conj >= 0) {
+        chosen[conj] = PETSC_TRUE;
+        perm[k++]    = conj;
+      }
+    }
+  }
+  PetscCall(PetscFree(chosen));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Newton basis with the m given shifts, used cyclically */
+static PetscErrorCode KSPCASetNewtonShifts(KSP_CA *ca, PetscInt m, const PetscReal re[], const PetscReal im[])
+{
+  PetscInt *perm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc1(m, &perm));
+  PetscCall(KSPCALejaOrder(m, re, im, perm));
+  for (PetscInt j = 0, l = 0; j < ca->s; l = (l + 1) % m) {
+    const PetscInt i = perm[l];
+
+    ca->b[j] = 0.0;
+    ca->c[j] = 1.0;
+#if PetscDefined(USE_COMPLEX)
+    ca->a[j++] = PetscCMPLX(re[i], im[i]);
+#else
+    ca->a[j++] = re[i];
+    if (im[i] > 0.0 && l + 1 < m) {
+      /* (Op - conj(theta)) (Op - theta) = (Op - Re(theta))^2 + Im(theta)^2 */
+      if (j < ca->s) {
+        ca->a[j] = re[i];
+        ca->b[j] = -im[i] * im[i];
+        ca->c[j] = 1.0;
+        j++;
+      }
+      l++;
+    }
+#endif
+  }
+  PetscCall(PetscFree(perm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Chebyshev basis of the interval [emin, emax], the polynomials are scaled to have a leading coefficient 2^(j-1)/h^j */
+static PetscErrorCode KSPCASetChebyshevInterval(KSP_CA *ca, PetscReal emin, PetscReal emax)
+{
+  const PetscReal d = (emax + emin) / 2;
+  PetscReal       h = (emax - emin) / 2;
+
+  PetscFunctionBegin;
+  if (h <= PETSC_SMALL * PetscAbsReal(d)) h = PetscMax(PETSC_SMALL * PetscAbsReal(d), PETSC_SMALL);
+  for (PetscInt j = 0; j < ca->s; j++) {
+    ca->a[j] = d;
+    ca->b[j] = j ? h / 2 : 0.0;
+    ca->c[j] = j ? h / 2 : h;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCASetBounds(KSP_CA *ca, PetscReal emin, PetscReal emax)
+{
+  PetscFunctionBegin;
+  if (ca->basistype == KSP_CA_BASIS_CHEBYSHEV) PetscCall(KSPCASetChebyshevInterval(ca, emin, emax));
+  else {
+    PetscReal *re, *im;
+
+    /* the Chebyshev points of the interval */
+    PetscCall(PetscCalloc2(ca->s, &re, ca->s, &im));
+    for (PetscInt i = 0; i < ca->s; i++) re[i] = (emax + emin) / 2 + (emax - emin) / 2 * PetscCosReal((2 * i + 1) * PETSC_PI / (2 * ca->s));
+    PetscCall(KSPCASetNewtonShifts(ca, ca->s, re, im));
+    PetscCall(PetscFree2(re, im));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  KSPCASetUpShifts_Private - Sets the recurrence of the basis if it does not need Ritz values, otherwise checks whether the
+  shifts computed by a previous solve are still valid
+
+  Output Parameter:
+. needritz - the first iterations must be performed with the standard method to compute Ritz values, which are then passed to
+             KSPCASetRitzValues_Private()
+*/
+PetscErrorCode KSPCASetUpShifts_Private(KSP ksp, KSP_CA *ca, PetscBool *needritz)
+{
+  Mat              A, P;
+  PetscObjectState Astate, Pstate;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &A, &P));
+  PetscCall(PetscObjectStateGet((PetscObject)A, &Astate));
+  PetscCall(PetscObjectStateGet((PetscObject)P, &Pstate));
+  *needritz = PETSC_FALSE;
+  if (ca->shifts && ca->state == Astate + Pstate) PetscFunctionReturn(PETSC_SUCCESS);
+  ca->state  = Astate + Pstate;
+  ca->shifts = PETSC_TRUE;
+  if (ca->basistype == KSP_CA_BASIS_MONOMIAL) {
+    for (PetscInt j = 0; j < ca->s; j++) {
+      ca->a[j] = 0.0;
+      ca->b[j] = 0.0;
+      ca->c[j] = 1.0;
+    }
+  } else if (ca->userbounds) PetscCall(KSPCASetBounds(ca, ca->emin, ca->emax));
+  else {
+    ca->shifts = PETSC_FALSE;
+    *needritz  = PETSC_TRUE;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  KSPCASetRitzValues_Private - Sets the recurrence of the Newton or Chebyshev basis from the m Ritz values re[] + i im[] of the operator
+
+  im[] may be NULL for real Ritz values
+*/
+PetscErrorCode KSPCASetRitzValues_Private(KSP ksp, KSP_CA *ca, PetscInt m, PetscReal re[], PetscReal im[])
+{
+  PetscReal *zero = NULL;
+
+  PetscFunctionBegin;
+  if (!m) PetscFunctionReturn(PETSC_SUCCESS);
+  if (!im) PetscCall(PetscCalloc1(m, &zero));
+  if (ca->basistype == KSP_CA_BASIS_CHEBYSHEV) {
+    PetscReal emin = re[0], emax = re[0];
+
+    for (PetscInt i = 1; i < m; i++) {
+      emin = PetscMin(emin, re[i]);
+      emax = PetscMax(emax, re[i]);
+    }
+    PetscCall(PetscInfo(ksp, "Chebyshev basis on the interval [%g, %g] of the Ritz values\n", (double)emin, (double)emax));
+    PetscCall(KSPCASetChebyshevInterval(ca, emin, emax));
+  } else {
+    PetscCall(KSPCASetNewtonShifts(ca, m, re, im ? im : zero));
+    PetscCall(PetscInfo(ksp, "Newton basis with %" PetscInt_FMT " Ritz values as shifts\n", m));
+  }
+  PetscCall(PetscFree(zero));
+  ca->shifts = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  KSPCAChangeOfBasis_Private - Fills the (n+1) x n tridiagonal matrix B such that Op V[0:n-1] = V[0:n] B
+
+  B is stored by columns with leading dimension ld
+*/
+PetscErrorCode KSPCAChangeOfBasis_Private(KSP_CA *ca, PetscInt n, PetscInt ld, PetscScalar B[])
+{
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt i = 0; i <= n; i++) B[i + j * ld] = 0.0;
+    if (j) B[j - 1 + j * ld] = ca->b[j];
+    B[j + j * ld]     = ca->a[j];
+    B[j + 1 + j * ld] = ca->c[j];
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* y holds Op v[j], turns it into v[j+1] */
+static PetscErrorCode KSPCARecurrence(KSP_CA *ca, PetscInt j, Vec y, Vec v[])
+{
+  const PetscScalar a = ca->a[j], b = ca->b[j], c = ca->c[j];
+
+  PetscFunctionBegin;
+  if (j && b != 0.0) PetscCall(VecAXPBYPCZ(y, -a / c, -b / c, 1.0 / c, v[j], v[j - 1]));
+  else if (a != 0.0 || c != 1.0) PetscCall(VecAXPBY(y, -a / c, 1.0 / c, v[j]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPCAMatrixPowersSetUp(KSP ksp, KSP_CA *ca, PetscBool *use)
+{
+  Mat              A;
+  MatNullSpace     nullsp;
+  PetscObjectState state;
+  PetscBool        isaij, isnone, diagonalscale;
+
+  PetscFunctionBegin;
+  *use = PETSC_FALSE;
+  if (!ca->mpk || ksp->transpose_solve) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, MATMPIAIJ, &isaij));
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp->pc, PCNONE, &isnone));
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCall(MatGetNullSpace(A, &nullsp));
+  if (!isaij || !isnone || diagonalscale || nullsp) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (!ca->Aloc) {
+    PetscInt rstart, rend, novl;
+    Vec      x;
+
+    PetscCall(MatGetOwnershipRange(A, &rstart, &rend));
+    PetscCall(ISCreateStride(PETSC_COMM_SELF, rend - rstart, rstart, 1, &ca->ovl));
+    PetscCall(MatIncreaseOverlap(A, 1, &ca->ovl, ca->s));
+    PetscCall(ISSort(ca->ovl));
+    ca->ostart = 0;
+    if (rend > rstart) PetscCall(ISLocate(ca->ovl, rstart, &ca->ostart));
+    PetscCall(MatCreateSubMatrices(A, 1, &ca->ovl, &ca->ovl, MAT_INITIAL_MATRIX, &ca->Aloc));
+    PetscCall(MatCreateVecs(ca->Aloc[0], &x, NULL));
+    PetscCall(VecDuplicateVecs(x, ca->s + 1, &ca->Xloc));
+    PetscCall(VecDestroy(&x));
+    PetscCall(MatCreateVecs(A, &x, NULL));
+    PetscCall(VecScatterCreate(x, ca->ovl, ca->Xloc[0], NULL, &ca->scatter));
+    PetscCall(VecDestroy(&x));
+    PetscCall(ISGetLocalSize(ca->ovl, &novl));
+    PetscCall(PetscInfo(ksp, "Matrix powers kernel with %" PetscInt_FMT " local rows and %" PetscInt_FMT " overlapping rows\n", rend - rstart, novl));
+  } else if (state != ca->mpkstate) PetscCall(MatCreateSubMatrices(A, 1, &ca->ovl, &ca->ovl, MAT_REUSE_MATRIX, &ca->Aloc));
+  ca->mpkstate = state;
+  *use         = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  KSPCAComputeBasis_Private - Computes the vectors V[1], ..., V[n] of the basis from V[0], n <= s
+
+  Input Parameters:
++ ksp - the Krylov solver context
+. ca  - the communication-avoiding data
+. n   - the number of vectors to compute
+. V   - V[0] is the starting vector
+. W   - if not NULL, W[0] = B^{-1} V[0] is given and the basis is the one of B A, with W[j] = B^{-1} V[j], as used by KSPCACG
+- t   - work vector
+
+  Output Parameters:
++ V - the vectors of the basis of B A (if W is provided) or of the preconditioned operator of the KSP
+- W - the vectors of the basis of A B
+
+  Note:
+  For W[] the recurrence is applied to A V[j] and V[j+1] is the preconditioner applied to W[j+1], so the preconditioner must be linear
+*/
+PetscErrorCode KSPCAComputeBasis_Private(KSP ksp, KSP_CA *ca, PetscInt n, Vec V[], Vec W[], Vec t)
+{
+  PetscBool mpk;
+
+  PetscFunctionBegin;
+  PetscCheck(n <= ca->s, PetscObjectComm((PetscObject)ksp), PETSC_ERR_PLIB, "Cannot compute %" PetscInt_FMT " vectors with step size %" PetscInt_FMT, n, ca->s);
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(KSPCAMatrixPowersSetUp(ksp, ca, &mpk));
+  if (mpk) {
+    Vec     *X = ca->Xloc;
+    PetscInt nlocal;
+
+    /* rows of the overlap at distance d of the local rows are correct in X[j] for d + j <= s */
+    PetscCall(VecScatterBegin(ca->scatter, V[0], X[0], INSERT_VALUES, SCATTER_FORWARD));
+    PetscCall(VecScatterEnd(ca->scatter, V[0], X[0], INSERT_VALUES, SCATTER_FORWARD));
+    PetscCall(VecGetLocalSize(V[0], &nlocal));
+    for (PetscInt j = 0; j < n; j++) {
+      const PetscScalar *x;
+      PetscScalar       *v;
+
+      PetscCall(MatMult(ca->Aloc[0], X[j], X[j + 1]));
+      PetscCall(KSPCARecurrence(ca, j, X[j + 1], X));
+      PetscCall(VecGetArrayRead(X[j + 1], &x));
+      PetscCall(VecGetArrayWrite(V[j + 1], &v));
+      PetscCall(PetscArraycpy(v, x + ca->ostart, nlocal));
+      PetscCall(VecRestoreArrayWrite(V[j + 1], &v));
+      PetscCall(VecRestoreArrayRead(X[j + 1], &x));
+      if (W) PetscCall(VecCopy(V[j + 1], W[j + 1]));
+    }
+  } else if (W) {
+    Mat A;
+
+    PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+    for (PetscInt j = 0; j < n; j++) {
+      PetscCall(KSP_MatMult(ksp, A, V[j], W[j + 1]));
+      PetscCall(KSPCARecurrence(ca, j, W[j + 1], W));
+      PetscCall(KSP_PCApply(ksp, W[j + 1], V[j + 1]));
+    }
+  } else {
+    for (PetscInt j = 0; j < n; j++) {
+      PetscCall(KSP_PCApplyBAorAB(ksp, V[j], V[j + 1], t));
+      PetscCall(KSPCARecurrence(ca, j, V[j + 1], V));
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
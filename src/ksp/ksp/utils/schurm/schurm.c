@@ -758,6 +758,123 @@ PetscErrorCode MatSchurComplementGetAinvType(Mat S, MatSchurComplementAinvType *
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* products kept with Sp so that MatCreateSchurComplementPmat() with MAT_REUSE_MATRIX only redoes their numeric phases */
+typedef struct {
+  Mat                        Ainv, AdB, P; /* inv(DIAGFORM(A00)) (only for MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG), inv(DIAGFORM(A00)) A01, and A10 inv(DIAGFORM(A00)) A01 */
+  MatSchurComplementAinvType ainvtype;
+  PetscInt                   bs;
+  PetscObjectId              id[4];           /* A00, A01, A10, and A11 the products were computed with */
+  PetscObjectState           nonzerostate[4]; /* and their nonzero states */
+} MatSchurComplementPmatCtx;
+
+static PetscErrorCode MatSchurComplementPmatCtxDestroy(PetscCtxRt ptr)
+{
+  MatSchurComplementPmatCtx *ctx = *(MatSchurComplementPmatCtx **)ptr;
+
+  PetscFunctionBegin;
+  PetscCall(MatDestroy(&ctx->Ainv));
+  PetscCall(MatDestroy(&ctx->AdB));
+  PetscCall(MatDestroy(&ctx->P));
+  PetscCall(PetscFree(ctx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* if match is NULL, records the matrices in ctx, otherwise checks that they are the recorded ones with unchanged nonzero patterns */
+static PetscErrorCode MatSchurComplementPmatCtxMatch(MatSchurComplementPmatCtx *ctx, Mat A00, Mat A01, Mat A10, Mat A11, MatSchurComplementAinvType ainvtype, PetscBool *match)
+{
+  Mat              M[4] = {A00, A01, A10, A11};
+  PetscObjectId    id[4]           = {0, 0, 0, 0};
+  PetscObjectState nonzerostate[4] = {0, 0, 0, 0};
+  PetscInt         bs;
+  PetscBool        flg;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetBlockSize(A00, &bs));
+  for (PetscInt i = 0; i < 4; i++) {
+    if (!M[i]) continue;
+    PetscCall(PetscObjectTypeCompareAny((PetscObject)M[i], &flg, MATTRANSPOSEVIRTUAL, MATHERMITIANTRANSPOSEVIRTUAL, ""));
+    if (flg) PetscCall(MatShellGetContext(M[i], &M[i])); /* the nonzero pattern is the one of the transposed matrix */
+    PetscCall(PetscObjectGetId((PetscObject)M[i], &id[i]));
+    PetscCall(MatGetNonzeroState(M[i], &nonzerostate[i]));
+  }
+  if (match) {
+    *match = (PetscBool)(ctx->ainvtype == ainvtype && ctx->bs == bs);
+    for (PetscInt i = 0; i < 4; i++) *match = (PetscBool)(*match && ctx->id[i] == id[i] && ctx->nonzerostate[i] == nonzerostate[i]);
+  } else {
+    ctx->ainvtype = ainvtype;
+    ctx->bs       = bs;
+    PetscCall(PetscArraycpy(ctx->id, id, 4));
+    PetscCall(PetscArraycpy(ctx->nonzerostate, nonzerostate, 4));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* computes AdB = inv(DIAGFORM(A00)) A01, with MAT_REUSE_MATRIX Ainv and AdB are those of a previous call and only their values are updated */
+static PetscErrorCode MatSchurComplementPmatComputeAdB(Mat A00, Mat A01, MatSchurComplementAinvType ainvtype, MatReuse reuse, Mat *Ainv, Mat *AdB)
+{
+  Mat       T;
+  Vec       diag;
+  PetscBool flg;
+
+  PetscFunctionBegin;
+  if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP || ainvtype == MAT_SCHUR_COMPLEMENT_AINV_DIAG) {
+    PetscCall(PetscObjectTypeCompare((PetscObject)A01, MATTRANSPOSEVIRTUAL, &flg));
+    if (flg) {
+      PetscCall(MatTransposeGetMat(A01, &T));
+      PetscCall(MatTranspose(T, reuse, AdB));
+    } else {
+      PetscCall(PetscObjectTypeCompare((PetscObject)A01, MATHERMITIANTRANSPOSEVIRTUAL, &flg));
+      if (flg) {
+        PetscCall(MatHermitianTransposeGetMat(A01, &T));
+        PetscCall(MatHermitianTranspose(T, reuse, AdB));
+      }
+    }
+    if (!flg) {
+      if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A01, MAT_COPY_VALUES, AdB));
+      else PetscCall(MatCopy(A01, *AdB, SAME_NONZERO_PATTERN));
+    } else {
+      PetscScalar shift, scale;
+
+      PetscCall(MatShellGetScalingShifts(A01, &shift, &scale, (Vec *)MAT_SHELL_NOT_ALLOWED, (Vec *)MAT_SHELL_NOT_ALLOWED, (Vec *)MAT_SHELL_NOT_ALLOWED, (Mat *)MAT_SHELL_NOT_ALLOWED, (IS *)MAT_SHELL_NOT_ALLOWED, (IS *)MAT_SHELL_NOT_ALLOWED));
+      PetscCall(MatShift(*AdB, shift));
+      PetscCall(MatScale(*AdB, scale));
+    }
+    PetscCall(MatCreateVecs(A00, &diag, NULL));
+    if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP) PetscCall(MatGetRowSum(A00, diag));
+    else PetscCall(MatGetDiagonal(A00, diag));
+    PetscCall(VecReciprocal(diag));
+    PetscCall(MatDiagonalScale(*AdB, diag, NULL));
+    PetscCall(VecDestroy(&diag));
+  } else if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG) {
+    if (reuse == MAT_INITIAL_MATRIX) {
+      MatType  type;
+      MPI_Comm comm;
+
+      PetscCall(PetscObjectGetComm((PetscObject)A00, &comm));
+      PetscCall(MatGetType(A00, &type));
+      PetscCall(MatCreate(comm, Ainv));
+      PetscCall(MatSetType(*Ainv, type));
+      PetscCall(MatInvertBlockDiagonalMat(A00, *Ainv));
+    } else { /* same block diagonal pattern, no need to preallocate again */
+      const PetscScalar *vals;
+      PetscInt           bs, rstart, rend;
+
+      PetscCall(MatInvertBlockDiagonal(A00, &vals));
+      PetscCall(MatGetBlockSize(A00, &bs));
+      PetscCall(MatGetOwnershipRange(*Ainv, &rstart, &rend));
+      PetscCall(MatSetOption(*Ainv, MAT_ROW_ORIENTED, PETSC_FALSE));
+      for (PetscInt i = rstart / bs; i < rend / bs; i++) PetscCall(MatSetValuesBlocked(*Ainv, 1, &i, 1, &i, &vals[(i - rstart / bs) * bs * bs], INSERT_VALUES));
+      PetscCall(MatSetOption(*Ainv, MAT_NO_OFF_PROC_ENTRIES, PETSC_TRUE));
+      PetscCall(MatAssemblyBegin(*Ainv, MAT_FINAL_ASSEMBLY));
+      PetscCall(MatAssemblyEnd(*Ainv, MAT_FINAL_ASSEMBLY));
+      PetscCall(MatSetOption(*Ainv, MAT_NO_OFF_PROC_ENTRIES, PETSC_FALSE));
+      PetscCall(MatSetOption(*Ainv, MAT_ROW_ORIENTED, PETSC_TRUE));
+    }
+    PetscCall(MatMatMult(*Ainv, A01, reuse, PETSC_DETERMINE, AdB));
+  } else SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Unknown MatSchurComplementAinvType: %d", ainvtype);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   MatCreateSchurComplementPmat - create a matrix for preconditioning the Schur complement by explicitly assembling the sparse matrix
   $Sp = A11 - A10 inv(DIAGFORM(A00)) A01$
@@ -777,6 +894,12 @@ PetscErrorCode MatSchurComplementGetAinvType(Mat S, MatSchurComplementAinvType *
 
   Level: advanced
 
+  Note:
+  The intermediate products are kept with `Sp`. With `MAT_REUSE_MATRIX`, if `A00`, `A01`, `A10`, and `A11` are the matrices of the previous call
+  and their nonzero patterns did not change, only the numeric phases of the products are computed again and `Sp` is updated in place.
+  Otherwise, or if `A01` is a `MATTRANSPOSEVIRTUAL` or `MATHERMITIANTRANSPOSEVIRTUAL` with a nonzero shift, `Sp` is destroyed and a new matrix
+  is created. Keeping inv(DIAGFORM(A00)) A01 and A10 inv(DIAGFORM(A00)) A01 alongside `Sp` roughly triples the memory used for `Sp`.
+
 .seealso: [](ch_ksp), `MatCreateSchurComplement()`, `MatGetSchurComplement()`, `MatSchurComplementGetPmat()`, `MatSchurComplementAinvType`
 @*/
 PetscErrorCode MatCreateSchurComplementPmat(Mat A00, Mat A01, Mat A10, Mat A11, MatSchurComplementAinvType ainvtype, MatReuse preuse, Mat *Sp)
@@ -799,58 +922,55 @@ PetscErrorCode MatCreateSchurComplementPmat(Mat A00, Mat A01, Mat A10, Mat A11,
       PetscCall(MatCopy(A11, *Sp, DIFFERENT_NONZERO_PATTERN));
     }
   } else {
-    Mat       AdB, T;
-    Vec       diag;
-    PetscBool flg;
-
-    if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP || ainvtype == MAT_SCHUR_COMPLEMENT_AINV_DIAG) {
-      PetscCall(PetscObjectTypeCompare((PetscObject)A01, MATTRANSPOSEVIRTUAL, &flg));
-      if (flg) {
-        PetscCall(MatTransposeGetMat(A01, &T));
-        PetscCall(MatTranspose(T, MAT_INITIAL_MATRIX, &AdB));
-      } else {
-        PetscCall(PetscObjectTypeCompare((PetscObject)A01, MATHERMITIANTRANSPOSEVIRTUAL, &flg));
-        if (flg) {
-          PetscCall(MatHermitianTransposeGetMat(A01, &T));
-          PetscCall(MatHermitianTranspose(T, MAT_INITIAL_MATRIX, &AdB));
-        }
+    MatSchurComplementPmatCtx *ctx = NULL;
+    PetscBool                  flg;
+
+    if (preuse == MAT_REUSE_MATRIX) {
+      PetscCall(PetscObjectContainerQuery((PetscObject)*Sp, "MatSchurComplementPmat_Ctx", (PetscCtxRt)&ctx));
+      if (ctx) PetscCall(MatSchurComplementPmatCtxMatch(ctx, A00, A01, A10, A11, ainvtype, &flg));
+      if (ctx && !flg) {
+        PetscCall(PetscInfo(*Sp, "Cannot reuse the products of a previous call, the nonzero patterns or the approximation of inv(A00) have changed\n"));
+        ctx = NULL;
       }
-      if (!flg) PetscCall(MatDuplicate(A01, MAT_COPY_VALUES, &AdB));
-      else {
+      PetscCall(PetscObjectTypeCompareAny((PetscObject)A01, &flg, MATTRANSPOSEVIRTUAL, MATHERMITIANTRANSPOSEVIRTUAL, ""));
+      if (ctx && flg) {
         PetscScalar shift, scale;
 
+        /* MatShift() may add diagonal entries to the explicit transpose, which then no longer has the pattern of the transpose of A01 */
         PetscCall(MatShellGetScalingShifts(A01, &shift, &scale, (Vec *)MAT_SHELL_NOT_ALLOWED, (Vec *)MAT_SHELL_NOT_ALLOWED, (Vec *)MAT_SHELL_NOT_ALLOWED, (Mat *)MAT_SHELL_NOT_ALLOWED, (IS *)MAT_SHELL_NOT_ALLOWED, (IS *)MAT_SHELL_NOT_ALLOWED));
-        PetscCall(MatShift(AdB, shift));
-        PetscCall(MatScale(AdB, scale));
+        if (shift != 0.0) {
+          PetscCall(PetscInfo(*Sp, "Cannot reuse the products of a previous call, A01 is a shifted transpose\n"));
+          ctx = NULL;
+        }
       }
-      PetscCall(MatCreateVecs(A00, &diag, NULL));
-      if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP) PetscCall(MatGetRowSum(A00, diag));
-      else PetscCall(MatGetDiagonal(A00, diag));
-      PetscCall(VecReciprocal(diag));
-      PetscCall(MatDiagonalScale(AdB, diag, NULL));
-      PetscCall(VecDestroy(&diag));
-    } else if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG) {
-      Mat      A00_inv;
-      MatType  type;
-      MPI_Comm comm;
-
-      PetscCall(PetscObjectGetComm((PetscObject)A00, &comm));
-      PetscCall(MatGetType(A00, &type));
-      PetscCall(MatCreate(comm, &A00_inv));
-      PetscCall(MatSetType(A00_inv, type));
-      PetscCall(MatInvertBlockDiagonalMat(A00, A00_inv));
-      PetscCall(MatMatMult(A00_inv, A01, MAT_INITIAL_MATRIX, PETSC_DETERMINE, &AdB));
-      PetscCall(MatDestroy(&A00_inv));
-    } else SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Unknown MatSchurComplementAinvType: %d", ainvtype);
-    /* Cannot really reuse Sp in MatMatMult() because of MatAYPX() -->
-         MatAXPY() --> MatHeaderReplace() --> MatDestroy_XXX_MatMatMult()  */
-    if (preuse == MAT_REUSE_MATRIX) PetscCall(MatDestroy(Sp));
-    PetscCall(MatMatMult(A10, AdB, MAT_INITIAL_MATRIX, PETSC_DETERMINE, Sp));
-    PetscCall(MatScale(*Sp, -1.0));
-    if (A11) { /* TODO: when can we pass SAME_NONZERO_PATTERN? */
-      PetscCall(MatAXPY(*Sp, 1.0, A11, DIFFERENT_NONZERO_PATTERN));
     }
-    PetscCall(MatDestroy(&AdB));
+    if (ctx) {
+      /* only the numeric phases: inv(DIAGFORM(A00)) A01 and A10 inv(DIAGFORM(A00)) A01 are updated in place */
+      PetscCall(MatSchurComplementPmatComputeAdB(A00, A01, ainvtype, MAT_REUSE_MATRIX, &ctx->Ainv, &ctx->AdB));
+      PetscCall(MatMatMult(A10, ctx->AdB, MAT_REUSE_MATRIX, PETSC_DETERMINE, &ctx->P));
+      if (A11) {
+        PetscCall(MatZeroEntries(*Sp));
+        PetscCall(MatAXPY(*Sp, -1.0, ctx->P, SUBSET_NONZERO_PATTERN));
+        PetscCall(MatAXPY(*Sp, 1.0, A11, SUBSET_NONZERO_PATTERN));
+      } else {
+        PetscCall(MatCopy(ctx->P, *Sp, SAME_NONZERO_PATTERN));
+        PetscCall(MatScale(*Sp, -1.0));
+      }
+    } else {
+      PetscCall(PetscNew(&ctx));
+      PetscCall(MatSchurComplementPmatCtxMatch(ctx, A00, A01, A10, A11, ainvtype, NULL));
+      PetscCall(MatSchurComplementPmatComputeAdB(A00, A01, ainvtype, MAT_INITIAL_MATRIX, &ctx->Ainv, &ctx->AdB));
+      /* Cannot really reuse Sp in MatMatMult() because of MatAYPX() -->
+           MatAXPY() --> MatHeaderReplace() --> MatDestroy_XXX_MatMatMult(), so the product is kept on the side */
+      PetscCall(MatMatMult(A10, ctx->AdB, MAT_INITIAL_MATRIX, PETSC_DETERMINE, &ctx->P));
+      if (preuse == MAT_REUSE_MATRIX) PetscCall(MatDestroy(Sp));
+      PetscCall(MatDuplicate(ctx->P, MAT_COPY_VALUES, Sp));
+      PetscCall(MatScale(*Sp, -1.0));
+      if (A11) { /* TODO: when can we pass SAME_NONZERO_PATTERN? */
+        PetscCall(MatAXPY(*Sp, 1.0, A11, DIFFERENT_NONZERO_PATTERN));
+      }
+      PetscCall(PetscObjectContainerCompose((PetscObject)*Sp, "MatSchurComplementPmat_Ctx", ctx, MatSchurComplementPmatCtxDestroy));
+    }
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -12,6 +12,7 @@
 
 #include <petsc/private/pcasmimpl.h> /*I "petscpc.h" I*/
 #include <petsc/private/matimpl.h>
+#include <petsc/private/hashmapi.h>
 
 static PetscErrorCode PCView_ASM(PC pc, PetscViewer viewer)
 {
@@ -34,6 +35,7 @@ static PetscErrorCode PCView_ASM(PC pc, PetscViewer viewer)
     PetscCall(PetscViewerASCIIPrintf(viewer, "  restriction/interpolation type - %s\n", PCASMTypes[osm->type]));
     if (osm->dm_subdomains) PetscCall(PetscViewerASCIIPrintf(viewer, "  Additive Schwarz: using DM to define subdomains\n"));
     if (osm->loctype != PC_COMPOSITE_ADDITIVE) PetscCall(PetscViewerASCIIPrintf(viewer, "  Additive Schwarz: local solve composition type - %s\n", PCCompositeTypes[osm->loctype]));
+    if (osm->shared_memory) PetscCall(PetscViewerASCIIPrintf(viewer, "  Additive Schwarz: subdomain matrices read from shared memory on each node\n"));
     PetscCallMPI(MPI_Comm_rank(PetscObjectComm((PetscObject)pc), &rank));
     PetscCall(PetscViewerGetFormat(viewer, &format));
     if (format != PETSC_VIEWER_ASCII_INFO_DETAIL) {
@@ -150,6 +152,242 @@ static PetscErrorCode PCASMPrintSubdomains(PC pc)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+#if PetscDefined(HAVE_MPI_PROCESS_SHARED_MEMORY)
+/* Adds the entries of a row in the subdomain columns, the global column of cols[j] is map[cols[j]] if map is given, otherwise cols[j] + shift */
+static inline PetscErrorCode PCASMAddSharedRow_Private(PetscHMapI g2l, PetscInt ncols, const PetscInt cols[], const PetscInt map[], PetscInt shift, const PetscScalar vals[], PetscInt lj[], PetscScalar lv[], PetscInt *lnnz)
+{
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < ncols; j++) {
+    PetscInt c;
+
+    PetscCall(PetscHMapIGetWithDefault(g2l, map ? map[cols[j]] : cols[j] + shift, -1, &c));
+    if (c < 0) continue;
+    lj[*lnnz] = c;
+    lv[*lnnz] = vals[j];
+    (*lnnz)++;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Extracts the overlapping subdomain matrices of a MATMPIAIJ matrix. The rows owned by the process are read in place from the
+   diagonal and off-diagonal blocks. The rows owned by other processes on the same node are read from MPI shared memory windows:
+   each process marks the rows it needs in a window of the owner that has one entry per local row, then each owner copies only the
+   marked rows, with global column indices, into shared windows and replaces the marks by the position of the rows in the copy.
+   Only the rows owned by processes on other nodes are communicated, with MatCreateSubMatrices().
+*/
+static PetscErrorCode PCASMCreateSubMatricesShared_Private(PC pc, MatReuse scall)
+{
+  PC_ASM            *osm = (PC_ASM *)pc->data;
+  Mat                A   = pc->pmat, Ad, Ao, *omats = NULL;
+  MPI_Comm           comm, shmcomm;
+  MPI_Win            swin, iwin, vwin;
+  PetscShmComm       pshmcomm;
+  PetscMPIInt        rank, shmrank, shmsize, **rowrank;
+  PetscInt           m, cstart, rstart, n, nd, no, noff, nexp = 0, nnzexp = 0, nshared = 0, *slot, *icsr, **sshm, **ishm, **jshm, **offpos;
+  const PetscInt    *ai, *aj, *bi, *bj, *garray, *idx;
+  const PetscScalar *aa, *ba;
+  PetscScalar       *vcsr, **vshm;
+  IS                *offrows;
+  PetscBool          done, anyoff = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectGetComm((PetscObject)pc, &comm));
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+  PetscCall(PetscShmCommGet(comm, &pshmcomm));
+  PetscCall(PetscShmCommGetMpiShmComm(pshmcomm, &shmcomm));
+  PetscCallMPI(MPI_Comm_rank(shmcomm, &shmrank));
+  PetscCallMPI(MPI_Comm_size(shmcomm, &shmsize));
+  PetscCall(MatMPIAIJGetSeqAIJ(A, &Ad, &Ao, &garray));
+  PetscCall(MatGetRowIJ(Ad, 0, PETSC_FALSE, PETSC_FALSE, &nd, &ai, &aj, &done));
+  PetscCheck(done, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatGetRowIJ() failed");
+  PetscCall(MatGetRowIJ(Ao, 0, PETSC_FALSE, PETSC_FALSE, &no, &bi, &bj, &done));
+  PetscCheck(done, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatGetRowIJ() failed");
+  PetscCall(MatSeqAIJGetArrayRead(Ad, &aa));
+  PetscCall(MatSeqAIJGetArrayRead(Ao, &ba));
+  PetscCall(MatGetLocalSize(A, &m, NULL));
+  PetscCall(MatGetOwnershipRange(A, &rstart, NULL));
+  PetscCall(MatGetOwnershipRangeColumn(A, &cstart, NULL));
+
+  /* the marks of the rows needed by the other processes on the node */
+  PetscCallMPI(MPI_Win_allocate_shared((MPI_Aint)(m * sizeof(PetscInt)), sizeof(PetscInt), MPI_INFO_NULL, shmcomm, &slot, &swin));
+  for (PetscInt i = 0; i < m; i++) slot[i] = -1;
+  PetscCallMPI(MPI_Barrier(shmcomm));
+  PetscCall(PetscMalloc4(shmsize, &sshm, shmsize, &ishm, shmsize, &jshm, shmsize, &vshm));
+  for (PetscMPIInt r = 0; r < shmsize; r++) {
+    MPI_Aint    sz;
+    PetscMPIInt du;
+
+    PetscCallMPI(MPI_Win_shared_query(swin, r, &sz, &du, &sshm[r]));
+  }
+
+  /* find the process owning each row of the subdomains and mark the rows of the other processes on the node, the rows owned by
+     processes on other nodes are extracted with MatCreateSubMatrices() */
+  PetscCall(PetscMalloc3(osm->n_local_true, &rowrank, osm->n_local_true, &offpos, osm->n_local_true, &offrows));
+  for (PetscInt i = 0; i < osm->n_local_true; i++) {
+    PetscInt *off;
+
+    PetscCall(ISGetLocalSize(osm->is[i], &n));
+    PetscCall(ISGetIndices(osm->is[i], &idx));
+    PetscCall(PetscMalloc1(n, &rowrank[i]));
+    PetscCall(PetscMalloc1(n, &offpos[i]));
+    PetscCall(PetscMalloc1(n, &off));
+    noff = 0;
+    for (PetscInt k = 0; k < n; k++) {
+      PetscMPIInt owner;
+
+      PetscCall(PetscLayoutFindOwner(A->rmap, idx[k], &owner));
+      if (owner == rank) rowrank[i][k] = shmrank;
+      else PetscCall(PetscShmCommGlobalToLocal(pshmcomm, owner, &rowrank[i][k]));
+      if (rowrank[i][k] == MPI_PROC_NULL) {
+        offpos[i][noff] = k;
+        off[noff++]     = idx[k];
+      } else if (owner != rank) sshm[rowrank[i][k]][idx[k] - A->rmap->range[owner]] = 0;
+    }
+    nshared += n - noff;
+    if (noff) anyoff = PETSC_TRUE;
+    PetscCall(ISRestoreIndices(osm->is[i], &idx));
+    PetscCall(ISCreateGeneral(PETSC_COMM_SELF, noff, off, PETSC_OWN_POINTER, &offrows[i]));
+  }
+  PetscCallMPI(MPI_Barrier(shmcomm));
+
+  /* expose the marked rows: their number, their row offsets, their global column indices, and their values */
+  for (PetscInt i = 0; i < m; i++) {
+    if (slot[i] < 0) continue;
+    slot[i] = nexp++;
+    nnzexp += ai[i + 1] - ai[i] + bi[i + 1] - bi[i];
+  }
+  PetscCallMPI(MPI_Win_allocate_shared((MPI_Aint)((nexp + 2 + nnzexp) * sizeof(PetscInt)), sizeof(PetscInt), MPI_INFO_NULL, shmcomm, &icsr, &iwin));
+  PetscCallMPI(MPI_Win_allocate_shared((MPI_Aint)(nnzexp * sizeof(PetscScalar)), sizeof(PetscScalar), MPI_INFO_NULL, shmcomm, &vcsr, &vwin));
+  icsr[0] = nexp;
+  icsr[1] = 0;
+  for (PetscInt i = 0, e = 0; i < m; i++) {
+    PetscInt *cols = icsr + nexp + 2, k = icsr[e + 1];
+
+    if (slot[i] < 0) continue;
+    for (PetscInt j = ai[i]; j < ai[i + 1]; j++, k++) {
+      cols[k] = aj[j] + cstart;
+      vcsr[k] = aa[j];
+    }
+    for (PetscInt j = bi[i]; j < bi[i + 1]; j++, k++) {
+      cols[k] = garray[bj[j]];
+      vcsr[k] = ba[j];
+    }
+    icsr[++e + 1] = k;
+  }
+  PetscCallMPI(MPI_Barrier(shmcomm));
+  for (PetscMPIInt r = 0; r < shmsize; r++) {
+    MPI_Aint    sz;
+    PetscMPIInt du;
+
+    PetscCallMPI(MPI_Win_shared_query(iwin, r, &sz, &du, &ishm[r]));
+    PetscCallMPI(MPI_Win_shared_query(vwin, r, &sz, &du, &vshm[r]));
+    jshm[r] = ishm[r] + ishm[r][0] + 2;
+    ishm[r]++;
+  }
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &anyoff, 1, MPI_C_BOOL, MPI_LOR, comm));
+  if (anyoff) PetscCall(MatCreateSubMatrices(A, osm->n_local_true, offrows, osm->is, MAT_INITIAL_MATRIX, &omats));
+  else PetscCall(MatSetOption(A, MAT_SUBMAT_SINGLEIS, PETSC_FALSE)); /* set by PCSetUp_ASM() for MatCreateSubMatrices(), which is not called */
+
+  /* assemble the subdomain matrices, restricting the rows to the subdomain columns */
+  if (scall == MAT_INITIAL_MATRIX) PetscCall(PetscCalloc1(osm->n_local_true + 1, &osm->pmat));
+  for (PetscInt i = 0; i < osm->n_local_true; i++) {
+    PetscHMapI   g2l;
+    PetscInt    *li, *lj, *lnnz, *lrow;
+    PetscScalar *lv;
+
+    PetscCall(ISGetLocalSize(osm->is[i], &n));
+    PetscCall(ISGetLocalSize(offrows[i], &noff));
+    PetscCall(ISGetIndices(osm->is[i], &idx));
+    PetscCall(PetscHMapICreateWithSize(n, &g2l));
+    for (PetscInt k = 0; k < n; k++) PetscCall(PetscHMapISet(g2l, idx[k], k));
+    PetscCall(PetscMalloc3(n + 1, &li, n, &lnnz, n, &lrow));
+    li[0] = 0;
+    for (PetscInt k = 0; k < n; k++) {
+      const PetscMPIInt r = rowrank[i][k];
+      PetscMPIInt       grank;
+
+      lnnz[k] = 0;
+      if (r == MPI_PROC_NULL) {
+        li[k + 1] = li[k];
+        continue;
+      }
+      if (r == shmrank) {
+        lrow[k]   = idx[k] - rstart;
+        li[k + 1] = li[k] + ai[lrow[k] + 1] - ai[lrow[k]] + bi[lrow[k] + 1] - bi[lrow[k]];
+      } else {
+        PetscCall(PetscShmCommLocalToGlobal(pshmcomm, r, &grank));
+        lrow[k]   = sshm[r][idx[k] - A->rmap->range[grank]];
+        li[k + 1] = li[k] + ishm[r][lrow[k] + 1] - ishm[r][lrow[k]];
+      }
+    }
+    PetscCall(ISRestoreIndices(osm->is[i], &idx));
+    PetscCall(PetscMalloc2(li[n], &lj, li[n], &lv));
+    for (PetscInt k = 0; k < n; k++) {
+      const PetscMPIInt r = rowrank[i][k];
+      const PetscInt    l = lrow[k];
+
+      if (r == MPI_PROC_NULL) continue;
+      if (r == shmrank) {
+        PetscCall(PCASMAddSharedRow_Private(g2l, ai[l + 1] - ai[l], aj + ai[l], NULL, cstart, aa + ai[l], lj + li[k], lv + li[k], &lnnz[k]));
+        PetscCall(PCASMAddSharedRow_Private(g2l, bi[l + 1] - bi[l], bj + bi[l], garray, 0, ba + bi[l], lj + li[k], lv + li[k], &lnnz[k]));
+      } else PetscCall(PCASMAddSharedRow_Private(g2l, ishm[r][l + 1] - ishm[r][l], jshm[r] + ishm[r][l], NULL, 0, vshm[r] + ishm[r][l], lj + li[k], lv + li[k], &lnnz[k]));
+    }
+    PetscCall(PetscHMapIDestroy(&g2l));
+    for (PetscInt k = 0; k < noff; k++) {
+      PetscCall(MatGetRow(omats[i], k, &lnnz[offpos[i][k]], NULL, NULL));
+      PetscCall(MatRestoreRow(omats[i], k, NULL, NULL, NULL));
+    }
+    if (scall == MAT_INITIAL_MATRIX) {
+      PetscInt bs;
+
+      PetscCall(MatCreate(PETSC_COMM_SELF, &osm->pmat[i]));
+      PetscCall(MatSetSizes(osm->pmat[i], n, n, n, n));
+      PetscCall(ISGetBlockSize(osm->is[i], &bs));
+      if (bs > 1) PetscCall(MatSetBlockSize(osm->pmat[i], bs));
+      PetscCall(MatSetType(osm->pmat[i], MATSEQAIJ));
+      PetscCall(MatSeqAIJSetPreallocation(osm->pmat[i], 0, lnnz));
+    }
+    for (PetscInt k = 0; k < n; k++) {
+      if (rowrank[i][k] != MPI_PROC_NULL) PetscCall(MatSetValues(osm->pmat[i], 1, &k, lnnz[k], lj + li[k], lv + li[k], INSERT_VALUES));
+    }
+    for (PetscInt k = 0; k < noff; k++) {
+      const PetscInt    *cols;
+      const PetscScalar *vals;
+      PetscInt           ncols;
+
+      PetscCall(MatGetRow(omats[i], k, &ncols, &cols, &vals));
+      PetscCall(MatSetValues(osm->pmat[i], 1, &offpos[i][k], ncols, cols, vals, INSERT_VALUES));
+      PetscCall(MatRestoreRow(omats[i], k, &ncols, &cols, &vals));
+    }
+    PetscCall(MatAssemblyBegin(osm->pmat[i], MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(osm->pmat[i], MAT_FINAL_ASSEMBLY));
+    PetscCall(PetscFree2(lj, lv));
+    PetscCall(PetscFree3(li, lnnz, lrow));
+  }
+  PetscCall(PetscInfo(pc, "%" PetscInt_FMT " subdomain rows read in place or from shared memory, %" PetscInt_FMT " local rows exposed to the other processes of the node%s\n", nshared, nexp, anyoff ? ", the rows owned by processes on other nodes are communicated" : ""));
+
+  PetscCall(MatSeqAIJRestoreArrayRead(Ao, &ba));
+  PetscCall(MatSeqAIJRestoreArrayRead(Ad, &aa));
+  PetscCall(MatRestoreRowIJ(Ao, 0, PETSC_FALSE, PETSC_FALSE, &no, &bi, &bj, &done));
+  PetscCall(MatRestoreRowIJ(Ad, 0, PETSC_FALSE, PETSC_FALSE, &nd, &ai, &aj, &done));
+  if (omats) PetscCall(MatDestroySubMatrices(osm->n_local_true, &omats));
+  for (PetscInt i = 0; i < osm->n_local_true; i++) {
+    PetscCall(ISDestroy(&offrows[i]));
+    PetscCall(PetscFree(rowrank[i]));
+    PetscCall(PetscFree(offpos[i]));
+  }
+  PetscCall(PetscFree3(rowrank, offpos, offrows));
+  PetscCall(PetscFree4(sshm, ishm, jshm, vshm));
+  /* no process may free its windows while the others still read them */
+  PetscCallMPI(MPI_Barrier(shmcomm));
+  PetscCallMPI(MPI_Win_free(&vwin));
+  PetscCallMPI(MPI_Win_free(&iwin));
+  PetscCallMPI(MPI_Win_free(&swin));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+#endif
+
 static PetscErrorCode PCSetUp_ASM(PC pc)
 {
   PC_ASM       *osm = (PC_ASM *)pc->data;
@@ -163,6 +401,7 @@ static PetscErrorCode PCSetUp_ASM(PC pc)
   Vec           vec;
   DM           *domain_dm = NULL;
   MatNullSpace *nullsp    = NULL;
+  PetscBool     shared    = PETSC_FALSE;
 
   PetscFunctionBegin;
   if (!pc->setupcalled) {
@@ -293,7 +532,11 @@ static PetscErrorCode PCSetUp_ASM(PC pc)
   /*
      Extract out the submatrices
   */
-  PetscCall(MatCreateSubMatrices(pc->pmat, osm->n_local_true, osm->is, osm->is, scall, &osm->pmat));
+#if PetscDefined(HAVE_MPI_PROCESS_SHARED_MEMORY)
+  if (osm->shared_memory) PetscCall(PetscObjectTypeCompare((PetscObject)pc->pmat, MATMPIAIJ, &shared));
+  if (shared) PetscCall(PCASMCreateSubMatricesShared_Private(pc, scall));
+#endif
+  if (!shared) PetscCall(MatCreateSubMatrices(pc->pmat, osm->n_local_true, osm->is, osm->is, scall, &osm->pmat));
   if (scall == MAT_INITIAL_MATRIX) {
     PetscCall(PetscObjectGetOptionsPrefix((PetscObject)pc->pmat, &pprefix));
     for (i = 0; i < osm->n_local_true; i++) PetscCall(PetscObjectSetOptionsPrefix((PetscObject)osm->pmat[i], pprefix));
@@ -742,6 +985,7 @@ static PetscErrorCode PCSetFromOptions_ASM(PC pc, PetscOptionItems PetscOptionsO
   if (flg) PetscCall(PCASMSetLocalType(pc, loctype));
   PetscCall(PetscOptionsFList("-pc_asm_sub_mat_type", "Subsolve Matrix Type", "PCASMSetSubMatType", MatList, NULL, sub_mat_type, 256, &flg));
   if (flg) PetscCall(PCASMSetSubMatType(pc, sub_mat_type));
+  PetscCall(PetscOptionsBool("-pc_asm_shared_memory", "Read the subdomain matrix rows of processes on the same node from shared memory", "PCASMSetSharedMemory", osm->shared_memory, &osm->shared_memory, NULL));
   PetscOptionsHeadEnd();
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -1252,6 +1496,7 @@ PetscErrorCode PCASMGetSubKSP(PC pc, PetscInt *n_local, PetscInt *first_local, K
 .  -pc_asm_overlap ovl                            - Sets overlap
 .  -pc_asm_type (basic|restrict|interpolate|none) - Sets `PCASMType`, default is restrict. See `PCASMSetType()`
 .  -pc_asm_dm_subdomains (true|false)             - use subdomains defined by the `DM` with `DMCreateDomainDecomposition()`
+.  -pc_asm_shared_memory (true|false)             - read the rows of the subdomain matrices owned by processes on the same node from shared memory, see `PCASMSetSharedMemory()`
 -  -pc_asm_local_type (additive|multiplicative)   - Sets `PCCompositeType`, default is additive. See `PCASMSetLocalType()`
 
    Level: beginner
@@ -1274,7 +1519,7 @@ PetscErrorCode PCASMGetSubKSP(PC pc, PetscInt *n_local, PetscInt *first_local, K
 
 .seealso: [](ch_ksp), `PCCreate()`, `PCSetType()`, `PCType`, `PC`, `PCASMType`, `PCCompositeType`,
           `PCBJACOBI`, `PCASMGetSubKSP()`, `PCASMSetLocalSubdomains()`, `PCASMGetType()`, `PCASMSetLocalType()`, `PCASMGetLocalType()`,
-          `PCASMSetTotalSubdomains()`, `PCSetModifySubMatrices()`, `PCASMSetOverlap()`, `PCASMSetType()`
+          `PCASMSetTotalSubdomains()`, `PCSetModifySubMatrices()`, `PCASMSetOverlap()`, `PCASMSetType()`, `PCASMSetSharedMemory()`
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC pc)
@@ -1302,6 +1547,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC pc)
   osm->loctype       = PC_COMPOSITE_ADDITIVE;
   osm->sort_indices  = PETSC_TRUE;
   osm->dm_subdomains = PETSC_FALSE;
+  osm->shared_memory = PETSC_FALSE;
   osm->sub_mat_type  = NULL;
 
   pc->data                   = (void *)osm;
@@ -1777,6 +2023,79 @@ PetscErrorCode PCASMGetDMSubdomains(PC pc, PetscBool *flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PCASMSetSharedMemory - Indicates whether the rows of the subdomain matrices owned by processes on the same compute node are read
+  directly from MPI shared memory instead of being communicated
+
+  Logically Collective
+
+  Input Parameters:
++ pc  - the preconditioner
+- flg - `PETSC_TRUE` to read the rows of the processes on the same node from shared memory
+
+  Options Database Key:
+. -pc_asm_shared_memory (true|false) - read the rows of the processes on the same node from shared memory
+
+  Level: advanced
+
+  Notes:
+  By default the overlapping subdomain matrices are extracted with `MatCreateSubMatrices()`, which copies all the rows owned by
+  other processes into message buffers. With this option each process exposes the rows of a `MATMPIAIJ` matrix needed by the
+  other processes on the same node in MPI shared memory windows during `PCSetUp()`, the subdomain matrices are assembled directly from the rows of the processes on the same node,
+  and only the rows owned by processes on other nodes are communicated with `MatCreateSubMatrices()`.
+
+  The rows owned by a process are read in place. Only the rows needed by the other processes of the node, i.e., those in the overlap
+  of their subdomains, are copied with global column indices into the shared memory windows, which also hold one integer per local row
+  and are freed at the end of the extraction.
+
+  The option is ignored for other matrix types, or if PETSc was configured with an MPI without process shared memory support.
+
+.seealso: [](ch_ksp), `PCASM`, `PCASMGetSharedMemory()`, `PCASMSetOverlap()`, `MatCreateSubMatrices()`, `PetscShmCommGet()`
+@*/
+PetscErrorCode PCASMSetSharedMemory(PC pc, PetscBool flg)
+{
+  PC_ASM   *osm = (PC_ASM *)pc->data;
+  PetscBool match;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(pc, flg, 2);
+  PetscCheck(!pc->setupcalled, ((PetscObject)pc)->comm, PETSC_ERR_ARG_WRONGSTATE, "Not for a setup PC.");
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCASM, &match));
+  if (match) osm->shared_memory = flg;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCASMGetSharedMemory - Returns flag indicating whether the rows of the subdomain matrices owned by processes on the same compute node
+  are read from MPI shared memory
+
+  Not Collective
+
+  Input Parameter:
+. pc - the preconditioner
+
+  Output Parameter:
+. flg - `PETSC_TRUE` if the rows of the processes on the same node are read from shared memory
+
+  Level: advanced
+
+.seealso: [](ch_ksp), `PCASM`, `PCASMSetSharedMemory()`
+@*/
+PetscErrorCode PCASMGetSharedMemory(PC pc, PetscBool *flg)
+{
+  PC_ASM   *osm = (PC_ASM *)pc->data;
+  PetscBool match;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscAssertPointer(flg, 2);
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCASM, &match));
+  if (match) *flg = osm->shared_memory;
+  else *flg = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PCASMGetSubMatType - Gets the matrix type used for `PCASM` subsolves, as a string.
 
@@ -0,0 +1,687 @@
+#include <petsc/private/pcimpl.h>
+#include <petsc/private/kspimpl.h>
+#include <petsc/private/kernels/batchlu.h>
+#include <petscksp.h> /*I "petscksp.h" I*/
+
+/* number of systems interleaved in a pack, the innermost loop of all the kernels below runs over them */
+#define PCBJBATCH_LANES PETSC_KERNEL_BATCH_LANES
+
+typedef enum {
+  PCBJBATCH_LU,
+  PCBJBATCH_GMRES,
+  PCBJBATCH_BCGS
+} PCBJBatchSolver;
+
+/*
+   A pack holds PCBJBATCH_LANES systems of the same size n. Entry (i,j) of the matrix of system l is stored in
+   a[(i + j * n) * PCBJBATCH_LANES + l] and entry i of a vector of system l in v[i * PCBJBATCH_LANES + l], so that every operation
+   is a loop over the systems with unit stride. Unused lanes hold the identity matrix and a zero right-hand side.
+*/
+typedef struct {
+  PetscInt           n;
+  PetscInt           nsys;
+  PetscInt           rstart[PCBJBATCH_LANES]; /* local row of the first equation of each system */
+  PetscScalar       *a;                       /* the LU factors, or the matrices scaled on the right by idiag for the Krylov methods */
+  PetscScalar       *idiag;                   /* the right Jacobi preconditioner used by the Krylov methods */
+  PetscInt          *piv;
+  PetscBool          zeropivot[PCBJBATCH_LANES];
+  PetscScalar       *work;
+  PetscInt           its[PCBJBATCH_LANES];
+  KSPConvergedReason reason[PCBJBATCH_LANES];
+  PetscLogDouble     flops;
+} PCBJBatchPack;
+
+typedef struct {
+  KSP             ksp; /* only holds the type, the tolerances, and the restart of the batched solver */
+  PCBJBatchSolver solver;
+  PetscInt        restart;
+  PetscInt        nblocks, min_bs, max_bs, npacks;
+  PCBJBatchPack  *packs;
+  PetscInt        max_its, total_its, nfailed; /* of the last PCApply() */
+} PC_BJBatch;
+
+static inline void PCBJBatchMult(PetscInt n, const PetscScalar *a, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt i = 0; i < n * PCBJBATCH_LANES; i++) y[i] = 0.0;
+  for (PetscInt j = 0; j < n; j++) {
+    const PetscScalar *xj = x + j * PCBJBATCH_LANES;
+
+    for (PetscInt i = 0; i < n; i++) {
+      const PetscScalar *aij = a + (i + j * n) * PCBJBATCH_LANES;
+      PetscScalar       *yi  = y + i * PCBJBATCH_LANES;
+
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) yi[l] += aij[l] * xj[l];
+    }
+  }
+}
+
+/* d_l = y_l^H x_l as in VecDot() */
+static inline void PCBJBatchDot(PetscInt n, const PetscScalar *x, const PetscScalar *y, PetscScalar *d)
+{
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) d[l] = 0.0;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) d[l] += x[i * PCBJBATCH_LANES + l] * PetscConj(y[i * PCBJBATCH_LANES + l]);
+  }
+}
+
+static inline void PCBJBatchNorm(PetscInt n, const PetscScalar *x, PetscReal *nrm)
+{
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) nrm[l] = 0.0;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) nrm[l] += PetscRealPart(x[i * PCBJBATCH_LANES + l] * PetscConj(x[i * PCBJBATCH_LANES + l]));
+  }
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) nrm[l] = PetscSqrtReal(nrm[l]);
+}
+
+/* y_l <- y_l + alpha_l x_l */
+static inline void PCBJBatchAXPY(PetscInt n, const PetscScalar *alpha, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt i = 0; i < n; i++) {
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) y[i * PCBJBATCH_LANES + l] += alpha[l] * x[i * PCBJBATCH_LANES + l];
+  }
+}
+
+/* dense LU factorization with partial pivoting, the pivot search and the row swaps are done system by system */
+static void PCBJBatchLUFactor(PCBJBatchPack *pack)
+{
+  PetscKernel_BatchLUFactor(pack->n, pack->a, pack->piv, pack->zeropivot);
+  pack->flops += PCBJBATCH_LANES * (2.0 * pack->n * pack->n * pack->n) / 3.0;
+}
+
+static void PCBJBatchSolve_LU(PCBJBatchPack *pack, PetscScalar *x)
+{
+  PetscKernel_BatchLUSolve(pack->n, pack->a, pack->piv, x);
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    pack->its[l]    = 1;
+    pack->reason[l] = pack->zeropivot[l] ? KSP_DIVERGED_PC_FAILED : KSP_CONVERGED_ITS;
+  }
+  pack->flops += PCBJBATCH_LANES * 2.0 * pack->n * pack->n;
+}
+
+static PetscInt PCBJBatchConverged(PCBJBatchPack *pack, const PetscReal *rnorm, const PetscReal *bnorm, PetscReal rtol, PetscReal atol, PetscReal dtol, PetscInt maxit, PetscBool *active)
+{
+  PetscInt nactive = 0;
+
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    if (!active[l]) continue;
+    if (PetscIsInfOrNanReal(rnorm[l])) pack->reason[l] = KSP_DIVERGED_NANORINF;
+    else if (rnorm[l] <= PetscMax(rtol * bnorm[l], atol)) pack->reason[l] = rnorm[l] < atol ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+    else if (pack->its[l] >= maxit) pack->reason[l] = KSP_DIVERGED_ITS;
+    else if (rnorm[l] >= dtol * bnorm[l]) pack->reason[l] = KSP_DIVERGED_DTOL;
+    if (pack->reason[l]) active[l] = PETSC_FALSE;
+    else nactive++;
+  }
+  return nactive;
+}
+
+/* right preconditioned restarted GMRES, a converged system stops updating its solution while the others continue */
+static void PCBJBatchSolve_GMRES(PCBJBatchPack *pack, PetscInt m, PetscReal rtol, PetscReal atol, PetscReal dtol, PetscInt maxit, const PetscScalar *b, PetscScalar *x)
+{
+  const PetscInt N = pack->n * PCBJBATCH_LANES;
+  PetscScalar   *r = pack->work + 2 * N, *V = r + N, *H = V + (m + 1) * N, *g = H + (m + 1) * m * PCBJBATCH_LANES, *c = g + (m + 1) * PCBJBATCH_LANES, *s = c + m * PCBJBATCH_LANES, *y = s + m * PCBJBATCH_LANES;
+  PetscReal      bnorm[PCBJBATCH_LANES], rnorm[PCBJBATCH_LANES], hnorm[PCBJBATCH_LANES];
+  PetscBool      active[PCBJBATCH_LANES], cycle[PCBJBATCH_LANES];
+  PetscInt       k[PCBJBATCH_LANES], ncycle;
+  PetscScalar    scale[PCBJBATCH_LANES];
+
+  PCBJBatchNorm(pack->n, b, bnorm);
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    active[l]       = PETSC_TRUE;
+    pack->its[l]    = 0;
+    pack->reason[l] = KSP_CONVERGED_ITERATING;
+  }
+  for (PetscInt i = 0; i < N; i++) {
+    x[i] = 0.0;
+    r[i] = b[i];
+  }
+  for (;;) {
+    PCBJBatchNorm(pack->n, r, rnorm);
+    if (!PCBJBatchConverged(pack, rnorm, bnorm, rtol, atol, dtol, maxit, active)) break;
+    ncycle = 0;
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      cycle[l] = active[l];
+      k[l]     = 0;
+      g[l]     = active[l] ? rnorm[l] : 0.0;
+      scale[l] = active[l] ? 1.0 / rnorm[l] : 0.0;
+      ncycle += active[l];
+    }
+    for (PetscInt i = 0; i < pack->n; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) V[i * PCBJBATCH_LANES + l] = scale[l] * r[i * PCBJBATCH_LANES + l];
+    }
+    for (PetscInt j = 0; j < m && ncycle; j++) {
+      PetscScalar *w = V + (j + 1) * N, *h = H + j * (m + 1) * PCBJBATCH_LANES;
+
+      PCBJBatchMult(pack->n, pack->a, V + j * N, w);
+      /* modified Gram-Schmidt */
+      for (PetscInt i = 0; i <= j; i++) {
+        PCBJBatchDot(pack->n, w, V + i * N, h + i * PCBJBATCH_LANES);
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) scale[l] = -h[i * PCBJBATCH_LANES + l];
+        PCBJBatchAXPY(pack->n, scale, V + i * N, w);
+      }
+      PCBJBatchNorm(pack->n, w, hnorm);
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        h[(j + 1) * PCBJBATCH_LANES + l] = hnorm[l];
+        scale[l]                         = hnorm[l] > 0.0 ? 1.0 / hnorm[l] : 0.0;
+      }
+      for (PetscInt i = 0; i < pack->n; i++) {
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) w[i * PCBJBATCH_LANES + l] *= scale[l];
+      }
+      pack->flops += PCBJBATCH_LANES * (2.0 * pack->n * pack->n + 4.0 * (j + 1) * pack->n + 3.0 * pack->n);
+      /* apply the previous plane rotations and compute the new one, as KSPGMRESUpdateHessenberg() does for each system */
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        PetscScalar tt;
+
+        if (!cycle[l]) continue;
+        for (PetscInt i = 0; i < j; i++) {
+          tt                               = h[i * PCBJBATCH_LANES + l];
+          h[i * PCBJBATCH_LANES + l]       = PetscConj(c[i * PCBJBATCH_LANES + l]) * tt + s[i * PCBJBATCH_LANES + l] * h[(i + 1) * PCBJBATCH_LANES + l];
+          h[(i + 1) * PCBJBATCH_LANES + l] = c[i * PCBJBATCH_LANES + l] * h[(i + 1) * PCBJBATCH_LANES + l] - s[i * PCBJBATCH_LANES + l] * tt;
+        }
+        tt = PetscSqrtScalar(PetscConj(h[j * PCBJBATCH_LANES + l]) * h[j * PCBJBATCH_LANES + l] + PetscConj(h[(j + 1) * PCBJBATCH_LANES + l]) * h[(j + 1) * PCBJBATCH_LANES + l]);
+        if (tt == 0.0) {
+          pack->reason[l] = KSP_DIVERGED_BREAKDOWN;
+          active[l] = cycle[l] = PETSC_FALSE;
+          ncycle--;
+          continue;
+        }
+        c[j * PCBJBATCH_LANES + l]       = h[j * PCBJBATCH_LANES + l] / tt;
+        s[j * PCBJBATCH_LANES + l]       = h[(j + 1) * PCBJBATCH_LANES + l] / tt;
+        g[(j + 1) * PCBJBATCH_LANES + l] = -(s[j * PCBJBATCH_LANES + l] * g[j * PCBJBATCH_LANES + l]);
+        g[j * PCBJBATCH_LANES + l]       = PetscConj(c[j * PCBJBATCH_LANES + l]) * g[j * PCBJBATCH_LANES + l];
+        h[j * PCBJBATCH_LANES + l]       = PetscConj(c[j * PCBJBATCH_LANES + l]) * h[j * PCBJBATCH_LANES + l] + s[j * PCBJBATCH_LANES + l] * h[(j + 1) * PCBJBATCH_LANES + l];
+        k[l]                             = j + 1;
+        pack->its[l]++;
+        /* the true residual decides convergence once the cycle ends */
+        if (PetscAbsScalar(g[(j + 1) * PCBJBATCH_LANES + l]) <= PetscMax(rtol * bnorm[l], atol) || hnorm[l] == 0.0 || pack->its[l] >= maxit) {
+          cycle[l] = PETSC_FALSE;
+          ncycle--;
+        }
+      }
+    }
+    /* solve the upper triangular systems and update the solutions */
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      for (PetscInt i = m - 1; i >= 0; i--) {
+        y[i * PCBJBATCH_LANES + l] = 0.0;
+        if (i >= k[l]) continue;
+        y[i * PCBJBATCH_LANES + l] = g[i * PCBJBATCH_LANES + l];
+        for (PetscInt q = i + 1; q < k[l]; q++) y[i * PCBJBATCH_LANES + l] -= H[(i + q * (m + 1)) * PCBJBATCH_LANES + l] * y[q * PCBJBATCH_LANES + l];
+        y[i * PCBJBATCH_LANES + l] /= H[(i + i * (m + 1)) * PCBJBATCH_LANES + l];
+      }
+    }
+    for (PetscInt i = 0; i < m; i++) PCBJBatchAXPY(pack->n, y + i * PCBJBATCH_LANES, V + i * N, x);
+    PCBJBatchMult(pack->n, pack->a, x, r);
+    for (PetscInt i = 0; i < N; i++) r[i] = b[i] - r[i];
+    pack->flops += PCBJBATCH_LANES * (2.0 * m * pack->n + 2.0 * pack->n * pack->n + pack->n);
+  }
+}
+
+/* right preconditioned BiCGStab with the same recurrences as KSPSolve_BCGS() */
+static void PCBJBatchSolve_BCGS(PCBJBatchPack *pack, PetscReal rtol, PetscReal atol, PetscReal dtol, PetscInt maxit, const PetscScalar *b, PetscScalar *x)
+{
+  const PetscInt N = pack->n * PCBJBATCH_LANES;
+  PetscScalar   *r = pack->work + 2 * N, *rp = r + N, *p = rp + N, *v = p + N, *s = v + N, *t = s + N;
+  PetscReal      bnorm[PCBJBATCH_LANES], rnorm[PCBJBATCH_LANES], tnorm[PCBJBATCH_LANES];
+  PetscBool      active[PCBJBATCH_LANES];
+  PetscScalar    rho[PCBJBATCH_LANES], rhoold[PCBJBATCH_LANES], alpha[PCBJBATCH_LANES], beta[PCBJBATCH_LANES], omega[PCBJBATCH_LANES], omegaold[PCBJBATCH_LANES], d1[PCBJBATCH_LANES];
+
+  PCBJBatchNorm(pack->n, b, bnorm);
+  for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+    active[l]       = PETSC_TRUE;
+    pack->its[l]    = 0;
+    pack->reason[l] = KSP_CONVERGED_ITERATING;
+    rnorm[l]        = bnorm[l];
+    rhoold[l]       = 1.0;
+    alpha[l]        = 1.0;
+    omegaold[l]     = 1.0;
+  }
+  for (PetscInt i = 0; i < N; i++) {
+    x[i] = 0.0;
+    r[i] = rp[i] = b[i];
+    p[i] = v[i] = 0.0;
+  }
+  while (PCBJBatchConverged(pack, rnorm, bnorm, rtol, atol, dtol, maxit, active)) {
+    PCBJBatchDot(pack->n, r, rp, rho);
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      if (active[l] && (rhoold[l] == 0.0 || omegaold[l] == 0.0)) {
+        pack->reason[l] = KSP_DIVERGED_BREAKDOWN;
+        active[l]       = PETSC_FALSE;
+      }
+      beta[l] = active[l] ? (rho[l] / rhoold[l]) * (alpha[l] / omegaold[l]) : 0.0;
+    }
+    for (PetscInt i = 0; i < pack->n; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) p[i * PCBJBATCH_LANES + l] = r[i * PCBJBATCH_LANES + l] + beta[l] * (p[i * PCBJBATCH_LANES + l] - omegaold[l] * v[i * PCBJBATCH_LANES + l]);
+    }
+    PCBJBatchMult(pack->n, pack->a, p, v);
+    PCBJBatchDot(pack->n, v, rp, d1);
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      if (active[l] && d1[l] == 0.0) {
+        pack->reason[l] = KSP_DIVERGED_BREAKDOWN;
+        active[l]       = PETSC_FALSE;
+      }
+      alpha[l] = active[l] ? rho[l] / d1[l] : 0.0;
+    }
+    for (PetscInt i = 0; i < pack->n; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) s[i * PCBJBATCH_LANES + l] = r[i * PCBJBATCH_LANES + l] - alpha[l] * v[i * PCBJBATCH_LANES + l];
+    }
+    PCBJBatchMult(pack->n, pack->a, s, t);
+    PCBJBatchDot(pack->n, s, t, d1);
+    PCBJBatchNorm(pack->n, t, tnorm);
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) omega[l] = active[l] && tnorm[l] > 0.0 ? d1[l] / (tnorm[l] * tnorm[l]) : 0.0;
+    for (PetscInt i = 0; i < pack->n; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+        x[i * PCBJBATCH_LANES + l] += alpha[l] * p[i * PCBJBATCH_LANES + l] + omega[l] * s[i * PCBJBATCH_LANES + l];
+        r[i * PCBJBATCH_LANES + l] = s[i * PCBJBATCH_LANES + l] - omega[l] * t[i * PCBJBATCH_LANES + l];
+      }
+    }
+    PCBJBatchNorm(pack->n, r, rnorm);
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      if (!active[l]) continue;
+      pack->its[l]++;
+      rhoold[l]   = rho[l];
+      omegaold[l] = omega[l];
+    }
+    pack->flops += PCBJBATCH_LANES * (4.0 * pack->n * pack->n + 20.0 * pack->n);
+  }
+}
+
+static void PCBJBatchSolvePack(PC_BJBatch *jac, PCBJBatchPack *pack, const PetscScalar *barray, PetscScalar *xarray)
+{
+  const PetscInt N = pack->n * PCBJBATCH_LANES;
+  PetscScalar   *b = pack->work, *x = pack->work + N;
+  KSP            ksp = jac->ksp;
+
+  for (PetscInt i = 0; i < N; i++) b[i] = 0.0;
+  for (PetscInt l = 0; l < pack->nsys; l++) {
+    for (PetscInt i = 0; i < pack->n; i++) b[i * PCBJBATCH_LANES + l] = barray[pack->rstart[l] + i];
+  }
+  switch (jac->solver) {
+  case PCBJBATCH_LU:
+    PCBJBatchSolve_LU(pack, b);
+    x = b;
+    break;
+  case PCBJBATCH_GMRES:
+    PCBJBatchSolve_GMRES(pack, PetscMin(jac->restart, pack->n), ksp->rtol, ksp->abstol, ksp->divtol, ksp->max_it, b, x);
+    break;
+  case PCBJBATCH_BCGS:
+    PCBJBatchSolve_BCGS(pack, ksp->rtol, ksp->abstol, ksp->divtol, ksp->max_it, b, x);
+    break;
+  }
+  for (PetscInt l = 0; l < pack->nsys; l++) {
+    if (jac->solver == PCBJBATCH_LU) {
+      for (PetscInt i = 0; i < pack->n; i++) xarray[pack->rstart[l] + i] = x[i * PCBJBATCH_LANES + l];
+    } else {
+      for (PetscInt i = 0; i < pack->n; i++) xarray[pack->rstart[l] + i] = pack->idiag[i * PCBJBATCH_LANES + l] * x[i * PCBJBATCH_LANES + l];
+    }
+  }
+}
+
+static PetscErrorCode PCBJBatchCreateKSP_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  const char *prefix;
+
+  PetscFunctionBegin;
+  PetscCall(KSPCreate(PetscObjectComm((PetscObject)pc), &jac->ksp));
+  PetscCall(KSPSetNestLevel(jac->ksp, pc->kspnestlevel));
+  PetscCall(PetscObjectIncrementTabLevel((PetscObject)jac->ksp, (PetscObject)pc, 1));
+  PetscCall(PCGetOptionsPrefix(pc, &prefix));
+  PetscCall(KSPSetOptionsPrefix(jac->ksp, prefix));
+  PetscCall(KSPAppendOptionsPrefix(jac->ksp, "pc_bjbatch_"));
+  PetscCall(KSPSetType(jac->ksp, KSPPREONLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCBJBatchDestroyPacks(PC_BJBatch *jac)
+{
+  PetscFunctionBegin;
+  for (PetscInt p = 0; p < jac->npacks; p++) {
+    PetscCall(PetscFree3(jac->packs[p].a, jac->packs[p].idiag, jac->packs[p].piv));
+    PetscCall(PetscFree(jac->packs[p].work));
+  }
+  PetscCall(PetscFree(jac->packs));
+  jac->npacks = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* sorts the diagonal blocks by size and groups blocks of the same size into packs */
+static PetscErrorCode PCBJBatchCreatePacks(PC pc)
+{
+  PC_BJBatch     *jac = (PC_BJBatch *)pc->data;
+  PetscInt        nblocks, nlocal, bs, *sizes, *starts, *perm;
+  const PetscInt *bsizes;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(pc->pmat, &nlocal, NULL));
+  PetscCall(MatGetVariableBlockSizes(pc->pmat, &nblocks, &bsizes));
+  if (!nblocks) {
+    PetscCall(MatGetBlockSize(pc->pmat, &bs));
+    nblocks = bs ? nlocal / bs : 0;
+  }
+  PetscCall(PetscMalloc3(nblocks, &sizes, nblocks, &starts, nblocks, &perm));
+  jac->min_bs = PETSC_INT_MAX;
+  jac->max_bs = 0;
+  for (PetscInt i = 0, start = 0; i < nblocks; i++) {
+    sizes[i]    = bsizes ? bsizes[i] : bs;
+    starts[i]   = start;
+    perm[i]     = i;
+    jac->min_bs = PetscMin(jac->min_bs, sizes[i]);
+    jac->max_bs = PetscMax(jac->max_bs, sizes[i]);
+    start += sizes[i];
+  }
+  PetscCheck(!nblocks || starts[nblocks - 1] + sizes[nblocks - 1] == nlocal, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Sum of block sizes does not match the local size %" PetscInt_FMT " of the matrix", nlocal);
+  if (!nblocks) jac->min_bs = 0;
+  jac->nblocks = nblocks;
+  PetscCall(PetscSortIntWithArray(nblocks, sizes, perm));
+
+  jac->npacks = 0;
+  for (PetscInt i = 0, cnt = 0; i < nblocks; i++) {
+    if (!cnt) jac->npacks++;
+    cnt = (i + 1 < nblocks && sizes[i + 1] == sizes[i]) ? (cnt + 1) % PCBJBATCH_LANES : 0;
+  }
+  PetscCall(PetscCalloc1(jac->npacks, &jac->packs));
+  for (PetscInt i = 0, p = -1, cnt = 0; i < nblocks; i++) {
+    PCBJBatchPack *pack;
+
+    if (!cnt) {
+      pack    = &jac->packs[++p];
+      pack->n = sizes[i];
+      PetscCall(PetscMalloc3(pack->n * pack->n * PCBJBATCH_LANES, &pack->a, pack->n * PCBJBATCH_LANES, &pack->idiag, pack->n * PCBJBATCH_LANES, &pack->piv));
+    } else pack = &jac->packs[p];
+    pack->rstart[pack->nsys++] = starts[perm[i]];
+    cnt                        = (i + 1 < nblocks && sizes[i + 1] == sizes[i]) ? (cnt + 1) % PCBJBATCH_LANES : 0;
+  }
+  PetscCall(PetscFree3(sizes, starts, perm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCSetUp_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  Mat         A;
+  PetscBool   flg, zeropivot = PETSC_FALSE;
+  PetscInt    nwork;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP_BJBatch(pc));
+  PetscCall(PetscObjectTypeCompare((PetscObject)jac->ksp, KSPPREONLY, &flg));
+  if (flg) jac->solver = PCBJBATCH_LU;
+  else {
+    PetscCall(PetscObjectTypeCompare((PetscObject)jac->ksp, KSPGMRES, &flg));
+    if (flg) {
+      jac->solver = PCBJBATCH_GMRES;
+      PetscCall(KSPGMRESGetRestart(jac->ksp, &jac->restart));
+    } else {
+      KSPType type;
+
+      PetscCall(KSPGetType(jac->ksp, &type));
+      PetscCall(PetscObjectTypeCompare((PetscObject)jac->ksp, KSPBCGS, &flg));
+      PetscCheck(flg, PetscObjectComm((PetscObject)pc), PETSC_ERR_SUP, "Batched solver %s not supported, use %s, %s, or %s", type, KSPPREONLY, KSPGMRES, KSPBCGS);
+      jac->solver = PCBJBATCH_BCGS;
+    }
+  }
+  if (!pc->setupcalled || pc->flag == DIFFERENT_NONZERO_PATTERN) {
+    PetscCall(PCBJBatchDestroyPacks(jac));
+    PetscCall(PCBJBatchCreatePacks(pc));
+  }
+  PetscCall(MatGetDiagonalBlock(pc->pmat, &A));
+  for (PetscInt p = 0; p < jac->npacks; p++) {
+    PCBJBatchPack *pack = &jac->packs[p];
+    const PetscInt n    = pack->n;
+
+    switch (jac->solver) {
+    case PCBJBATCH_LU:
+      nwork = 2 * n;
+      break;
+    case PCBJBATCH_GMRES: {
+      PetscInt m = PetscMin(jac->restart, n);
+
+      nwork = (4 + m) * n + (m + 1) * (m + 4);
+    } break;
+    default:
+      nwork = 8 * n;
+    }
+    PetscCall(PetscFree(pack->work));
+    PetscCall(PetscMalloc1(nwork * PCBJBATCH_LANES, &pack->work));
+    PetscCall(PetscArrayzero(pack->a, n * n * PCBJBATCH_LANES));
+    for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) {
+      if (l >= pack->nsys) {
+        for (PetscInt i = 0; i < n; i++) pack->a[(i + i * n) * PCBJBATCH_LANES + l] = 1.0;
+        continue;
+      }
+      for (PetscInt i = 0; i < n; i++) {
+        PetscInt           ncols;
+        const PetscInt    *cols;
+        const PetscScalar *vals;
+
+        PetscCall(MatGetRow(A, pack->rstart[l] + i, &ncols, &cols, &vals));
+        for (PetscInt k = 0; k < ncols; k++) {
+          PetscInt j = cols[k] - pack->rstart[l];
+
+          if (j >= 0 && j < n) pack->a[(i + j * n) * PCBJBATCH_LANES + l] = vals[k];
+        }
+        PetscCall(MatRestoreRow(A, pack->rstart[l] + i, &ncols, &cols, &vals));
+      }
+    }
+  }
+  if (jac->solver == PCBJBATCH_LU) {
+    PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+    for (PetscInt p = 0; p < jac->npacks; p++) PCBJBatchLUFactor(&jac->packs[p]);
+    for (PetscInt p = 0; p < jac->npacks; p++) {
+      for (PetscInt l = 0; l < jac->packs[p].nsys; l++) zeropivot = (PetscBool)(zeropivot || jac->packs[p].zeropivot[l]);
+      PetscCall(PetscLogFlops(jac->packs[p].flops));
+      jac->packs[p].flops = 0.0;
+    }
+    PetscCheck(!zeropivot || !pc->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot in the LU factorization of a diagonal block");
+    if (zeropivot) PetscCall(PCSetFailedReason(pc, PC_FACTOR_NUMERIC_ZEROPIVOT));
+  } else {
+    for (PetscInt p = 0; p < jac->npacks; p++) {
+      PCBJBatchPack *pack = &jac->packs[p];
+      const PetscInt n    = pack->n;
+
+      for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) pack->zeropivot[l] = PETSC_FALSE;
+      for (PetscInt j = 0; j < n; j++) {
+        PetscScalar *ajj = pack->a + (j + j * n) * PCBJBATCH_LANES, *dj = pack->idiag + j * PCBJBATCH_LANES;
+
+        for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) dj[l] = ajj[l] != 0.0 ? 1.0 / ajj[l] : 1.0;
+        for (PetscInt i = 0; i < n; i++) {
+          PetscScalar *aij = pack->a + (i + j * n) * PCBJBATCH_LANES;
+
+          PetscPragmaSIMD
+          for (PetscInt l = 0; l < PCBJBATCH_LANES; l++) aij[l] *= dj[l];
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCApply_BJBatch(PC pc, Vec b, Vec x)
+{
+  PC_BJBatch        *jac = (PC_BJBatch *)pc->data;
+  const PetscScalar *barray;
+  PetscScalar       *xarray;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(b, &barray));
+  PetscCall(VecGetArrayWrite(x, &xarray));
+  PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+  for (PetscInt p = 0; p < jac->npacks; p++) PCBJBatchSolvePack(jac, &jac->packs[p], barray, xarray);
+  PetscCall(VecRestoreArrayWrite(x, &xarray));
+  PetscCall(VecRestoreArrayRead(b, &barray));
+
+  jac->max_its   = 0;
+  jac->total_its = 0;
+  jac->nfailed   = 0;
+  for (PetscInt p = 0; p < jac->npacks; p++) {
+    PCBJBatchPack *pack = &jac->packs[p];
+
+    for (PetscInt l = 0; l < pack->nsys; l++) {
+      jac->max_its = PetscMax(jac->max_its, pack->its[l]);
+      jac->total_its += pack->its[l];
+      /* as in KSPCheckSolve() reaching the maximum number of iterations is not a failure */
+      if (pack->reason[l] < 0 && pack->reason[l] != KSP_DIVERGED_ITS) {
+        PetscCheck(!pc->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_NOT_CONVERGED, "Batched solve of the block starting at local row %" PetscInt_FMT " failed due to %s after %" PetscInt_FMT " iterations", pack->rstart[l], KSPConvergedReasons[pack->reason[l]],
+                   pack->its[l]);
+        jac->nfailed++;
+      }
+    }
+    PetscCall(PetscLogFlops(pack->flops));
+    pack->flops = 0.0;
+  }
+  /* flag the output so that all the MPI processes of the outer KSP detect the failure */
+  PetscCall(VecFlag(x, jac->nfailed > 0));
+  if (jac->nfailed) {
+    PetscCall(PetscInfo(pc, "Batched solve failed on %" PetscInt_FMT " of %" PetscInt_FMT " blocks\n", jac->nfailed, jac->nblocks));
+    PetscCall(PCSetFailedReason(pc, PC_SUBPC_ERROR));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCReset_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  PetscCall(PCBJBatchDestroyPacks(jac));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCDestroy_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  PetscCall(PCReset_BJBatch(pc));
+  PetscCall(KSPDestroy(&jac->ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCBJBatchGetKSP_C", NULL));
+  PetscCall(PetscFree(pc->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCView_BJBatch(PC pc, PetscViewer viewer)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  PetscBool   isascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii && pc->setupcalled) {
+    if (jac->solver == PCBJBATCH_LU) PetscCall(PetscViewerASCIIPrintf(viewer, "  batched solver: dense LU\n"));
+    else {
+      if (jac->solver == PCBJBATCH_GMRES) PetscCall(PetscViewerASCIIPrintf(viewer, "  batched solver: GMRES(%" PetscInt_FMT ") with Jacobi preconditioning\n", jac->restart));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "  batched solver: BCGS with Jacobi preconditioning\n"));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  tolerances: relative=%g, absolute=%g, maximum iterations=%" PetscInt_FMT "\n", (double)jac->ksp->rtol, (double)jac->ksp->abstol, jac->ksp->max_it));
+    }
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  number of blocks: %" PetscInt_FMT " in %" PetscInt_FMT " packs of up to %d\n", jac->nblocks, jac->npacks, PCBJBATCH_LANES));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  block sizes: min=%" PetscInt_FMT " max=%" PetscInt_FMT "\n", jac->min_bs, jac->max_bs));
+    if (jac->solver != PCBJBATCH_LU && jac->nblocks) PetscCall(PetscViewerASCIIPrintf(viewer, "  last application: max iterations=%" PetscInt_FMT ", average iterations=%g, failed blocks=%" PetscInt_FMT "\n", jac->max_its, (double)jac->total_its / jac->nblocks, jac->nfailed));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCSetFromOptions_BJBatch(PC pc, PetscOptionItems PetscOptionsObject)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP_BJBatch(pc));
+  PetscCall(KSPSetFromOptions(jac->ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCBJBatchGetKSP_BJBatch(PC pc, KSP *ksp)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  if (!jac->ksp) PetscCall(PCBJBatchCreateKSP_BJBatch(pc));
+  *ksp = jac->ksp;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCBJBatchGetKSP - Gets the `KSP` that selects the method and the tolerances of the batched solver of `PCBJBATCH`
+
+  Not Collective
+
+  Input Parameter:
+. pc - the preconditioner context
+
+  Output Parameter:
+. ksp - the `KSP`
+
+  Level: advanced
+
+  Notes:
+  The `KSP` is never used to solve, only its type (`KSPPREONLY` for dense LU, `KSPGMRES`, or `KSPBCGS`), its tolerances,
+  and for `KSPGMRES` its restart are used by the batched solver.
+
+  Its options prefix is the prefix of the `PC` followed by `pc_bjbatch_`.
+
+.seealso: [](ch_ksp), `PCBJBATCH`, `PCBJKOKKOSGetKSP()`
+@*/
+PetscErrorCode PCBJBatchGetKSP(PC pc, KSP *ksp)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscAssertPointer(ksp, 2);
+  PetscUseMethod(pc, "PCBJBatchGetKSP_C", (PC, KSP *), (pc, ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   PCBJBATCH - Block Jacobi preconditioner that solves all the small diagonal blocks of the matrix at once with a batched solver on the CPU
+
+   Options Database Keys:
++  -pc_bjbatch_ksp_type <preonly,gmres,bcgs> - dense LU with partial pivoting, restarted GMRES, or BiCGStab
+.  -pc_bjbatch_ksp_rtol <rtol>              - relative tolerance of each block solve
+.  -pc_bjbatch_ksp_max_it <maxit>           - maximum number of iterations of each block solve
+-  -pc_bjbatch_ksp_gmres_restart <restart>  - restart of GMRES, it is never larger than the size of the block
+
+   Level: intermediate
+
+   Notes:
+   The blocks are given by `MatSetVariableBlockSizes()`, or by the block size of the matrix; a block may not be shared
+   between MPI processes. Entries outside of the diagonal blocks are ignored so, with `KSPPREONLY`, this solves a set of
+   independent systems, for example one per cell or per particle, in a single call.
+
+   The blocks are stored as dense matrices. Blocks of the same size are interleaved in packs of 8 so that the inner loops of
+   the factorizations, the matrix-vector products, and the inner products run over the systems of a pack with unit stride and are
+   vectorized. The packs are distributed among threads when PETSc is configured with `--with-openmp-kernels`.
+
+   With `KSPGMRES` and `KSPBCGS` each block is right preconditioned by its diagonal so the convergence test is done on the true residual.
+   Every system of a pack has its own convergence test; a converged system stops updating its solution while the others continue.
+   If some block solve fails, other than by reaching the maximum number of iterations, `PCGetFailedReason()` returns `PC_SUBPC_ERROR`,
+   or an error is generated with `PCSetErrorIfFailure()`.
+
+   See `PCBJKOKKOS` for a similar solver on GPUs, and `PCVPBJACOBI` which applies the inverse of the blocks.
+
+.seealso: [](ch_ksp), `PCCreate()`, `PCSetType()`, `PCType`, `PC`, `PCBJACOBI`, `PCVPBJACOBI`, `PCBJKOKKOS`, `PCBJBatchGetKSP()`, `MatSetVariableBlockSizes()`
+M*/
+PETSC_EXTERN PetscErrorCode PCCreate_BJBatch(PC pc)
+{
+  PC_BJBatch *jac;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&jac));
+  pc->data = (void *)jac;
+
+  pc->ops->apply          = PCApply_BJBatch;
+  pc->ops->setup          = PCSetUp_BJBatch;
+  pc->ops->reset          = PCReset_BJBatch;
+  pc->ops->destroy        = PCDestroy_BJBatch;
+  pc->ops->setfromoptions = PCSetFromOptions_BJBatch;
+  pc->ops->view           = PCView_BJBatch;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCBJBatchGetKSP_C", PCBJBatchGetKSP_BJBatch));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
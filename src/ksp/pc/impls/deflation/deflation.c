@@ -1,4 +1,5 @@
 #include <../src/ksp/pc/impls/deflation/deflation.h> /*I "petscksp.h" I*/ /* header file for Fortran wrappers */
+#include <petscblaslapack.h>
 
 const char *const PCDeflationSpaceTypes[] = {"haar", "db2", "db4", "db8", "db16", "biorth22", "meyer", "aggregation", "user", "PCDeflationSpaceType", "PC_DEFLATION_SPACE_", NULL};
 
@@ -377,6 +378,60 @@ PetscErrorCode PCDeflationGetPC(PC pc, PC *apc)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode PCDeflationSetAdaptive_Deflation(PC pc, PetscInt k, PetscInt nsolves)
+{
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+
+  PetscFunctionBegin;
+  def->adaptk = k;
+  if (nsolves > 0) def->adaptsolves = nsolves;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCDeflationSetAdaptive - Extend the deflation space with approximate eigenvectors of the operator
+  computed during the first solves.
+
+  Logically Collective
+
+  Input Parameters:
++ pc      - the preconditioner context
+. k       - number of Ritz vectors appended to the deflation space, 0 turns the adaptive deflation off
+- nsolves - number of solves that update the deflation space (or `PETSC_DEFAULT`)
+
+  Options Database Keys:
++ -pc_deflation_adaptive k              - number of Ritz vectors
+- -pc_deflation_adaptive_solves nsolves - number of solves that update the deflation space
+
+  Notes:
+  The fixed part of the deflation space is the space given with `PCDeflationSetSpace()` or, if there is none,
+  the near-null space of the preconditioning matrix given with `MatSetNearNullSpace()`. No space is computed as
+  with `PCDeflationSetSpaceToCompute()`, so the first solve is not deflated when neither is provided.
+
+  During each of the first `nsolves` solves, the preconditioned residuals are stored in blocks of 2`k` vectors,
+  and each block is compressed by a Rayleigh-Ritz procedure into the `k` Ritz vectors of A associated with the
+  smallest Ritz values. After the solve, the Ritz vectors are appended to the fixed part of the deflation space,
+  and the coarse problem W'*A*W is rebuilt and factored once. Later solves with the same operator then have these
+  approximate eigenvectors deflated. The Rayleigh-Ritz procedure costs one extra matrix-vector product per
+  iteration, during the first `nsolves` solves only. The default for `nsolves` is 1.
+
+  The adaptive deflation does not support multilevel deflation.
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `PCDEFLATION`, `PCDeflationSetSpace()`, `MatSetNearNullSpace()`
+@*/
+PetscErrorCode PCDeflationSetAdaptive(PC pc, PetscInt k, PetscInt nsolves)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(pc, k, 2);
+  PetscValidLogicalCollectiveInt(pc, nsolves, 3);
+  PetscCheck(k >= 0, PetscObjectComm((PetscObject)pc), PETSC_ERR_ARG_OUTOFRANGE, "Number of Ritz vectors %" PetscInt_FMT " must be nonnegative", k);
+  PetscTryMethod(pc, "PCDeflationSetAdaptive_C", (PC, PetscInt, PetscInt), (pc, k, nsolves));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
   x <- x + W*(W'*A*W)^{-1}*W'*r  = x + Q*r
 */
@@ -388,6 +443,7 @@ static PetscErrorCode PCPreSolve_Deflation(PC pc, KSP ksp, Vec b, Vec x)
   PetscBool     nonzero;
 
   PetscFunctionBegin;
+  if (!def->W) PetscFunctionReturn(PETSC_SUCCESS); /* adaptive deflation without a space yet */
   w1 = def->workcoarse[0];
   w2 = def->workcoarse[1];
   r  = def->work;
@@ -413,6 +469,88 @@ static PetscErrorCode PCPreSolve_Deflation(PC pc, KSP ksp, Vec b, Vec x)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+  replaces V with the Ritz vectors of A in range([V Z]) associated with the smallest Ritz values
+*/
+static PetscErrorCode PCDeflationUpdateRitz_Private(PC pc)
+{
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+  Mat           Amat;
+  Vec          *U, *AU, *swap;
+  PetscInt      n = def->nv + def->nz, kk;
+  PetscScalar  *F, *G, *work;
+  PetscReal    *theta, *rwork, *s;
+  PetscBLASInt  bn, lwork, info, one = 1;
+
+  PetscFunctionBegin;
+  if (!def->nz) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PCGetOperators(pc, NULL, &Amat));
+  for (PetscInt i = 0; i < def->nz; i++) PetscCall(MatMult(Amat, def->Z[i], def->AZ[i]));
+  PetscCall(PetscMalloc2(n, &U, n, &AU));
+  for (PetscInt i = 0; i < def->nv; i++) {
+    U[i]  = def->V[i];
+    AU[i] = def->AV[i];
+  }
+  for (PetscInt i = 0; i < def->nz; i++) {
+    U[def->nv + i]  = def->Z[i];
+    AU[def->nv + i] = def->AZ[i];
+  }
+  def->nz = 0;
+
+  /* F = U^H U and G = U^H A U, with a single global reduction */
+  PetscCall(PetscMalloc6(n * n, &F, n * n, &G, n, &theta, 3 * n, &work, 3 * n, &rwork, n, &s));
+  for (PetscInt j = 0; j < n; j++) {
+    PetscCall(VecMDotBegin(U[j], n, U, F + j * n));
+    PetscCall(VecMDotBegin(AU[j], n, U, G + j * n));
+  }
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)pc)));
+  for (PetscInt j = 0; j < n; j++) {
+    PetscCall(VecMDotEnd(U[j], n, U, F + j * n));
+    PetscCall(VecMDotEnd(AU[j], n, U, G + j * n));
+  }
+  /* symmetrize and scale to a unit diagonal of F since the residuals decrease during the solve */
+  for (PetscInt i = 0; i < n; i++) s[i] = PetscRealPart(F[i + i * n]) > 0.0 ? 1.0 / PetscSqrtReal(PetscRealPart(F[i + i * n])) : 0.0;
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt i = 0; i <= j; i++) {
+      F[i + j * n] = 0.5 * (F[i + j * n] + PetscConj(F[j + i * n])) * s[i] * s[j];
+      G[i + j * n] = 0.5 * (G[i + j * n] + PetscConj(G[j + i * n])) * s[i] * s[j];
+    }
+  }
+
+  /* G y = theta F y, the eigenvalues being in ascending order */
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(3 * n, &lwork));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if PetscDefined(USE_COMPLEX)
+  PetscCallBLAS("LAPACKsygv", LAPACKsygv_(&one, "V", "U", &bn, G, &bn, F, &bn, theta, work, &lwork, rwork, &info));
+#else
+  PetscCallBLAS("LAPACKsygv", LAPACKsygv_(&one, "V", "U", &bn, G, &bn, F, &bn, theta, work, &lwork, &info));
+#endif
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(info >= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %d", (int)info);
+  if (info) {
+    PetscCall(PetscInfo(pc, "Generalized eigenvalue problem is not definite, the Ritz vectors are not updated\n"));
+  } else {
+    kk = PetscMin(def->adaptk, n);
+    for (PetscInt j = 0; j < kk; j++) {
+      for (PetscInt i = 0; i < n; i++) G[i + j * n] *= s[i];
+      PetscCall(VecMAXPBY(def->Vn[j], n, G + j * n, 0.0, U));
+      PetscCall(VecMAXPBY(def->AVn[j], n, G + j * n, 0.0, AU));
+    }
+    swap     = def->V;
+    def->V   = def->Vn;
+    def->Vn  = swap;
+    swap     = def->AV;
+    def->AV  = def->AVn;
+    def->AVn = swap;
+    def->nv  = kk;
+    PetscCall(PetscInfo(pc, "Smallest Ritz value %g, largest kept Ritz value %g\n", (double)theta[0], (double)theta[kk - 1]));
+  }
+  PetscCall(PetscFree6(F, G, theta, work, rwork, s));
+  PetscCall(PetscFree2(U, AU));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
   if (def->correct) {
     z <- M^{-1}r - W*(W'*A*W)^{-1}*(W'*A*M^{-1}r - l*W'*r) = (P*M^{-1} + l*Q)*r
@@ -427,13 +565,13 @@ static PetscErrorCode PCApply_Deflation(PC pc, Vec r, Vec z)
   Vec           u, w1, w2;
 
   PetscFunctionBegin;
-  w1 = def->workcoarse[0];
-  w2 = def->workcoarse[1];
-  u  = def->work;
+  u = def->work;
   PetscCall(PCGetOperators(pc, NULL, &A));
 
   PetscCall(PCApply(def->pc, r, z)); /*    z <- M^{-1}*r             */
-  if (!def->init) {
+  if (!def->init && def->W) {
+    w1 = def->workcoarse[0];
+    w2 = def->workcoarse[1];
     PetscCall(MatMult(def->WtA, z, w1)); /*    w1 <- W'*A*z              */
     if (def->correct) {
       if (def->Wt) {
@@ -447,103 +585,33 @@ static PetscErrorCode PCApply_Deflation(PC pc, Vec r, Vec z)
     PetscCall(MatMult(def->W, w2, u));         /*    u  <- W*w2                */
     PetscCall(VecAXPY(z, -1.0, u));            /*    z  <- z - u               */
   }
+  if (def->Z) { /* store z for the adaptive deflation */
+    if (def->nz == def->nzmax) PetscCall(PCDeflationUpdateRitz_Private(pc));
+    PetscCall(VecCopy(z, def->Z[def->nz++]));
+  }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-static PetscErrorCode PCSetUp_Deflation(PC pc)
+/*
+  assembles W'*A (unless given), the coarse problem W'*A*W (unless given) and its solver
+*/
+static PetscErrorCode PCDeflationSetUpCoarse_Private(PC pc, Mat nextDef, PetscBool transp)
 {
-  PC_Deflation    *def = (PC_Deflation *)pc->data;
-  DM               dm;
-  KSP              innerksp;
-  PC               pcinner;
-  Mat              Amat, nextDef = NULL, *mats;
-  PetscInt         i, m, red, size;
-  PetscMPIInt      commsize;
-  PetscBool        match, flgspd, isset, transp = PETSC_FALSE;
-  MatCompositeType ctype;
-  MPI_Comm         comm;
-  char             prefix[128] = "";
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+  KSP           innerksp;
+  PC            pcinner;
+  Mat           Amat;
+  PetscInt      i, m, red;
+  PetscMPIInt   commsize;
+  PetscBool     match, flgspd, isset;
+  MPI_Comm      comm;
+  char          prefix[128] = "";
 
   PetscFunctionBegin;
-  if (pc->setupcalled) PetscFunctionReturn(PETSC_SUCCESS);
   PetscCall(PetscObjectGetComm((PetscObject)pc, &comm));
   PetscCall(PCGetOperators(pc, NULL, &Amat));
-  if (!def->lvl && !def->prefix) PetscCall(PCGetOptionsPrefix(pc, &def->prefix));
   if (def->lvl) PetscCall(PetscSNPrintf(prefix, sizeof(prefix), "%" PetscInt_FMT "_", def->lvl));
 
-  /* compute a deflation space */
-  if (def->W || def->Wt) {
-    def->spacetype = PC_DEFLATION_SPACE_USER;
-  } else {
-    PetscCall(PCDeflationComputeSpace(pc));
-  }
-
-  /* nested deflation */
-  if (def->W) {
-    PetscCall(PetscObjectTypeCompare((PetscObject)def->W, MATCOMPOSITE, &match));
-    if (match) {
-      PetscCall(MatCompositeGetType(def->W, &ctype));
-      PetscCall(MatCompositeGetNumberMat(def->W, &size));
-    }
-  } else {
-    PetscCall(MatCreateHermitianTranspose(def->Wt, &def->W));
-    PetscCall(PetscObjectTypeCompare((PetscObject)def->Wt, MATCOMPOSITE, &match));
-    if (match) {
-      PetscCall(MatCompositeGetType(def->Wt, &ctype));
-      PetscCall(MatCompositeGetNumberMat(def->Wt, &size));
-    }
-    transp = PETSC_TRUE;
-  }
-  if (match && ctype == MAT_COMPOSITE_MULTIPLICATIVE) {
-    if (!transp) {
-      if (def->lvl < def->maxlvl) {
-        PetscCall(PetscMalloc1(size, &mats));
-        for (i = 0; i < size; i++) PetscCall(MatCompositeGetMat(def->W, i, &mats[i]));
-        size -= 1;
-        PetscCall(MatDestroy(&def->W));
-        def->W = mats[size];
-        PetscCall(PetscObjectReference((PetscObject)mats[size]));
-        if (size > 1) {
-          PetscCall(MatCreateComposite(comm, size, mats, &nextDef));
-          PetscCall(MatCompositeSetType(nextDef, MAT_COMPOSITE_MULTIPLICATIVE));
-        } else {
-          nextDef = mats[0];
-          PetscCall(PetscObjectReference((PetscObject)mats[0]));
-        }
-        PetscCall(PetscFree(mats));
-      } else {
-        /* TODO test merge side performance */
-        /* PetscCall(MatCompositeSetMergeType(def->W,MAT_COMPOSITE_MERGE_LEFT)); */
-        PetscCall(MatCompositeMerge(def->W));
-      }
-    } else {
-      if (def->lvl < def->maxlvl) {
-        PetscCall(PetscMalloc1(size, &mats));
-        for (i = 0; i < size; i++) PetscCall(MatCompositeGetMat(def->Wt, i, &mats[i]));
-        size -= 1;
-        PetscCall(MatDestroy(&def->Wt));
-        def->Wt = mats[0];
-        PetscCall(PetscObjectReference((PetscObject)mats[0]));
-        if (size > 1) {
-          PetscCall(MatCreateComposite(comm, size, &mats[1], &nextDef));
-          PetscCall(MatCompositeSetType(nextDef, MAT_COMPOSITE_MULTIPLICATIVE));
-        } else {
-          nextDef = mats[1];
-          PetscCall(PetscObjectReference((PetscObject)mats[1]));
-        }
-        PetscCall(PetscFree(mats));
-      } else {
-        /* PetscCall(MatCompositeSetMergeType(def->W,MAT_COMPOSITE_MERGE_LEFT)); */
-        PetscCall(MatCompositeMerge(def->Wt));
-      }
-    }
-  }
-
-  if (transp) {
-    PetscCall(MatDestroy(&def->W));
-    PetscCall(MatHermitianTranspose(def->Wt, MAT_INITIAL_MATRIX, &def->W));
-  }
-
   /* assemble WtA */
   if (!def->WtA) {
     if (def->Wt) PetscCall(MatMatMult(def->Wt, Amat, MAT_INITIAL_MATRIX, PETSC_CURRENT, &def->WtA));
@@ -650,6 +718,252 @@ static PetscErrorCode PCSetUp_Deflation(PC pc)
   PetscCall(KSPSetFromOptions(def->WtAWinv));
   PetscCall(KSPSetUp(def->WtAWinv));
 
+  PetscCall(KSPCreateVecs(def->WtAWinv, 2, &def->workcoarse, 0, NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  W <- [W(:,0:nbase-1) vecs], then rebuilds the coarse problem
+*/
+static PetscErrorCode PCDeflationAdaptiveSetSpace_Private(PC pc, PetscInt n, const Vec vecs[])
+{
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+  Mat           Amat, W, Wc, C;
+  Vec           v, w;
+  PetscInt      m = def->nbase + n, nloc, N;
+  PetscBool     flgspd, isset;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(pc, NULL, &Amat));
+  PetscCall(MatDestroy(&def->WtA));
+  PetscCall(MatDestroy(&def->WtAW));
+  PetscCall(KSPDestroy(&def->WtAWinv));
+  PetscCall(VecDestroyVecs(2, &def->workcoarse));
+  if (!m) {
+    PetscCall(MatDestroy(&def->W));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(MatGetLocalSize(Amat, NULL, &nloc));
+  PetscCall(MatGetSize(Amat, NULL, &N));
+  PetscCall(MatCreateDense(PetscObjectComm((PetscObject)pc), nloc, PETSC_DECIDE, N, m, NULL, &W));
+  for (PetscInt i = 0; i < m; i++) {
+    PetscCall(MatDenseGetColumnVecWrite(W, i, &w));
+    if (i < def->nbase) {
+      PetscCall(MatDenseGetColumnVecRead(def->W, i, &v));
+      PetscCall(VecCopy(v, w));
+      PetscCall(MatDenseRestoreColumnVecRead(def->W, i, &v));
+    } else PetscCall(VecCopy(vecs[i - def->nbase], w));
+    PetscCall(MatDenseRestoreColumnVecWrite(W, i, &w));
+  }
+  PetscCall(MatDestroy(&def->W));
+  def->W = W;
+
+  /* W'*A = (A^T*conj(W))^T and W'*A*W = (A^T*conj(W))^T*W, so only products with a dense W are needed */
+  if (PetscDefined(USE_COMPLEX)) {
+    PetscCall(MatDuplicate(W, MAT_COPY_VALUES, &Wc));
+    PetscCall(MatConjugate(Wc));
+  } else {
+    PetscCall(PetscObjectReference((PetscObject)W));
+    Wc = W;
+  }
+  PetscCall(MatTransposeMatMult(Amat, Wc, MAT_INITIAL_MATRIX, PETSC_CURRENT, &C));
+  PetscCall(MatCreateTranspose(C, &def->WtA));
+  PetscCall(MatTransposeMatMult(C, W, MAT_INITIAL_MATRIX, PETSC_CURRENT, &def->WtAW));
+  PetscCall(MatIsSPDKnown(Amat, &isset, &flgspd));
+  if (isset) PetscCall(MatSetOption(def->WtAW, MAT_SPD, flgspd));
+  PetscCall(MatDestroy(&C));
+  PetscCall(MatDestroy(&Wc));
+  PetscCall(PCDeflationSetUpCoarse_Private(pc, NULL, PETSC_FALSE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCDeflationSetUpAdaptive_Private(PC pc)
+{
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+  Mat           Amat, W;
+  MatNullSpace  nullsp;
+  Vec           v;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(pc, NULL, &Amat));
+  def->nbase = 0;
+  if (def->W || def->Wt) {
+    def->spacetype = PC_DEFLATION_SPACE_USER;
+    if (def->W) PetscCall(MatConvert(def->W, MATDENSE, MAT_INITIAL_MATRIX, &W));
+    else {
+      PetscCall(MatHermitianTranspose(def->Wt, MAT_INITIAL_MATRIX, &W));
+      PetscCall(MatConvert(W, MATDENSE, MAT_INPLACE_MATRIX, &W));
+    }
+    PetscCall(MatDestroy(&def->W));
+    PetscCall(MatDestroy(&def->Wt));
+    def->W = W;
+    PetscCall(MatGetSize(W, NULL, &def->nbase));
+    PetscCall(PCDeflationAdaptiveSetSpace_Private(pc, 0, NULL));
+  } else {
+    PetscCall(MatGetNearNullSpace(Amat, &nullsp));
+    if (nullsp) {
+      const Vec *vecs;
+      Vec       *base;
+      PetscInt   n, nb = 0;
+      PetscBool  has_cnst;
+
+      PetscCall(MatNullSpaceGetVecs(nullsp, &has_cnst, &n, &vecs));
+      PetscCall(PetscMalloc1(n + 1, &base));
+      if (has_cnst) {
+        PetscCall(MatCreateVecs(Amat, &base[nb], NULL));
+        PetscCall(VecSet(base[nb++], 1.0));
+      }
+      for (PetscInt i = 0; i < n; i++) base[nb++] = vecs[i];
+      PetscCall(PCDeflationAdaptiveSetSpace_Private(pc, nb, base));
+      if (has_cnst) PetscCall(VecDestroy(&base[0]));
+      PetscCall(PetscFree(base));
+      def->nbase = nb;
+    }
+  }
+
+  def->nz    = 0;
+  def->nv    = 0;
+  def->nzmax = 2 * def->adaptk;
+  PetscCall(MatCreateVecs(Amat, &v, NULL));
+  PetscCall(VecDuplicateVecs(v, def->nzmax, &def->Z));
+  PetscCall(VecDuplicateVecs(v, def->nzmax, &def->AZ));
+  PetscCall(VecDuplicateVecs(v, def->adaptk, &def->V));
+  PetscCall(VecDuplicateVecs(v, def->adaptk, &def->AV));
+  PetscCall(VecDuplicateVecs(v, def->adaptk, &def->Vn));
+  PetscCall(VecDuplicateVecs(v, def->adaptk, &def->AVn));
+  PetscCall(VecDestroy(&v));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCDeflationDestroyAdaptive_Private(PC pc)
+{
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+
+  PetscFunctionBegin;
+  PetscCall(VecDestroyVecs(def->nzmax, &def->Z));
+  PetscCall(VecDestroyVecs(def->nzmax, &def->AZ));
+  PetscCall(VecDestroyVecs(def->adaptk, &def->V));
+  PetscCall(VecDestroyVecs(def->adaptk, &def->AV));
+  PetscCall(VecDestroyVecs(def->adaptk, &def->Vn));
+  PetscCall(VecDestroyVecs(def->adaptk, &def->AVn));
+  def->nz = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  appends the Ritz vectors computed during the solve to the deflation space
+*/
+static PetscErrorCode PCPostSolve_Deflation(PC pc, KSP ksp, Vec b, Vec x)
+{
+  PC_Deflation *def = (PC_Deflation *)pc->data;
+
+  PetscFunctionBegin;
+  if (!def->Z) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PCDeflationUpdateRitz_Private(pc));
+  if (def->nv) PetscCall(PCDeflationAdaptiveSetSpace_Private(pc, def->nv, def->V));
+  /* the Ritz vectors are now stored in W */
+  if (++def->nadapted == def->adaptsolves) PetscCall(PCDeflationDestroyAdaptive_Private(pc));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCSetUp_Deflation(PC pc)
+{
+  PC_Deflation    *def = (PC_Deflation *)pc->data;
+  DM               dm;
+  Mat              Amat, nextDef = NULL, *mats;
+  PetscInt         i, size;
+  PetscBool        match, transp = PETSC_FALSE;
+  MatCompositeType ctype;
+  MPI_Comm         comm;
+  char             prefix[128] = "";
+
+  PetscFunctionBegin;
+  if (pc->setupcalled) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscObjectGetComm((PetscObject)pc, &comm));
+  PetscCall(PCGetOperators(pc, NULL, &Amat));
+  if (!def->lvl && !def->prefix) PetscCall(PCGetOptionsPrefix(pc, &def->prefix));
+  if (def->lvl) PetscCall(PetscSNPrintf(prefix, sizeof(prefix), "%" PetscInt_FMT "_", def->lvl));
+
+  if (def->adaptk) {
+    /* near-null space or user space, extended by Ritz vectors after each solve */
+    PetscCall(PCDeflationSetUpAdaptive_Private(pc));
+  } else {
+    /* compute a deflation space */
+    if (def->W || def->Wt) {
+      def->spacetype = PC_DEFLATION_SPACE_USER;
+    } else {
+      PetscCall(PCDeflationComputeSpace(pc));
+    }
+
+    /* nested deflation */
+    if (def->W) {
+      PetscCall(PetscObjectTypeCompare((PetscObject)def->W, MATCOMPOSITE, &match));
+      if (match) {
+        PetscCall(MatCompositeGetType(def->W, &ctype));
+        PetscCall(MatCompositeGetNumberMat(def->W, &size));
+      }
+    } else {
+      PetscCall(MatCreateHermitianTranspose(def->Wt, &def->W));
+      PetscCall(PetscObjectTypeCompare((PetscObject)def->Wt, MATCOMPOSITE, &match));
+      if (match) {
+        PetscCall(MatCompositeGetType(def->Wt, &ctype));
+        PetscCall(MatCompositeGetNumberMat(def->Wt, &size));
+      }
+      transp = PETSC_TRUE;
+    }
+    if (match && ctype == MAT_COMPOSITE_MULTIPLICATIVE) {
+      if (!transp) {
+        if (def->lvl < def->maxlvl) {
+          PetscCall(PetscMalloc1(size, &mats));
+          for (i = 0; i < size; i++) PetscCall(MatCompositeGetMat(def->W, i, &mats[i]));
+          size -= 1;
+          PetscCall(MatDestroy(&def->W));
+          def->W = mats[size];
+          PetscCall(PetscObjectReference((PetscObject)mats[size]));
+          if (size > 1) {
+            PetscCall(MatCreateComposite(comm, size, mats, &nextDef));
+            PetscCall(MatCompositeSetType(nextDef, MAT_COMPOSITE_MULTIPLICATIVE));
+          } else {
+            nextDef = mats[0];
+            PetscCall(PetscObjectReference((PetscObject)mats[0]));
+          }
+          PetscCall(PetscFree(mats));
+        } else {
+          /* TODO test merge side performance */
+          /* PetscCall(MatCompositeSetMergeType(def->W,MAT_COMPOSITE_MERGE_LEFT)); */
+          PetscCall(MatCompositeMerge(def->W));
+        }
+      } else {
+        if (def->lvl < def->maxlvl) {
+          PetscCall(PetscMalloc1(size, &mats));
+          for (i = 0; i < size; i++) PetscCall(MatCompositeGetMat(def->Wt, i, &mats[i]));
+          size -= 1;
+          PetscCall(MatDestroy(&def->Wt));
+          def->Wt = mats[0];
+          PetscCall(PetscObjectReference((PetscObject)mats[0]));
+          if (size > 1) {
+            PetscCall(MatCreateComposite(comm, size, &mats[1], &nextDef));
+            PetscCall(MatCompositeSetType(nextDef, MAT_COMPOSITE_MULTIPLICATIVE));
+          } else {
+            nextDef = mats[1];
+            PetscCall(PetscObjectReference((PetscObject)mats[1]));
+          }
+          PetscCall(PetscFree(mats));
+        } else {
+          /* PetscCall(MatCompositeSetMergeType(def->W,MAT_COMPOSITE_MERGE_LEFT)); */
+          PetscCall(MatCompositeMerge(def->Wt));
+        }
+      }
+    }
+
+    if (transp) {
+      PetscCall(MatDestroy(&def->W));
+      PetscCall(MatHermitianTranspose(def->Wt, MAT_INITIAL_MATRIX, &def->W));
+    }
+
+    PetscCall(PCDeflationSetUpCoarse_Private(pc, nextDef, transp));
+  }
+
   /* create preconditioner */
   if (!def->pc) {
     PetscCall(PCCreate(comm, &def->pc));
@@ -667,7 +981,6 @@ static PetscErrorCode PCSetUp_Deflation(PC pc)
 
   /* create work vecs */
   PetscCall(MatCreateVecs(Amat, NULL, &def->work));
-  PetscCall(KSPCreateVecs(def->WtAWinv, 2, &def->workcoarse, 0, NULL));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -684,6 +997,10 @@ static PetscErrorCode PCReset_Deflation(PC pc)
   PetscCall(MatDestroy(&def->WtAW));
   PetscCall(KSPDestroy(&def->WtAWinv));
   PetscCall(PCDestroy(&def->pc));
+  PetscCall(PCDeflationDestroyAdaptive_Private(pc));
+  def->nv       = 0;
+  def->nbase    = 0;
+  def->nadapted = 0;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -701,6 +1018,7 @@ static PetscErrorCode PCDestroy_Deflation(PC pc)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationSetCoarseMat_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationGetCoarseKSP_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationGetPC_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationSetAdaptive_C", NULL));
   PetscCall(PetscFree(pc->data));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -716,13 +1034,16 @@ static PetscErrorCode PCView_Deflation(PC pc, PetscViewer viewer)
   PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
   if (isascii) {
     if (def->correct) PetscCall(PetscViewerASCIIPrintf(viewer, "using CP correction, factor = %g+%gi\n", (double)PetscRealPart(def->correctfact), (double)PetscImaginaryPart(def->correctfact)));
-    if (!def->lvl) PetscCall(PetscViewerASCIIPrintf(viewer, "deflation space type: %s\n", PCDeflationSpaceTypes[def->spacetype]));
+    if (def->adaptk) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "adaptive deflation space: %" PetscInt_FMT " fixed vectors and %" PetscInt_FMT " Ritz vectors (at most %" PetscInt_FMT "), updated by %" PetscInt_FMT " of %" PetscInt_FMT " solves\n", def->nbase, def->nv, def->adaptk, def->nadapted, def->adaptsolves));
+    } else if (!def->lvl) PetscCall(PetscViewerASCIIPrintf(viewer, "deflation space type: %s\n", PCDeflationSpaceTypes[def->spacetype]));
 
     PetscCall(PetscViewerASCIIPrintf(viewer, "--- Additional PC:\n"));
     PetscCall(PetscViewerASCIIPushTab(viewer));
     PetscCall(PCView(def->pc, viewer));
     PetscCall(PetscViewerASCIIPopTab(viewer));
 
+    if (!def->WtAWinv) PetscFunctionReturn(PETSC_SUCCESS);
     PetscCall(PetscViewerASCIIPrintf(viewer, "--- Coarse problem solver:\n"));
     PetscCall(PetscViewerASCIIPushTab(viewer));
     PetscCall(KSPGetTotalIterations(def->WtAWinv, &its));
@@ -747,6 +1068,8 @@ static PetscErrorCode PCSetFromOptions_Deflation(PC pc, PetscOptionItems PetscOp
   PetscCall(PetscOptionsEnum("-pc_deflation_compute_space", "Compute deflation space", "PCDeflationSetSpace", PCDeflationSpaceTypes, (PetscEnum)def->spacetype, (PetscEnum *)&def->spacetype, NULL));
   PetscCall(PetscOptionsInt("-pc_deflation_compute_space_size", "Set size of the deflation space to compute", "PCDeflationSetSpace", def->spacesize, &def->spacesize, NULL));
   PetscCall(PetscOptionsBool("-pc_deflation_space_extend", "Extend deflation space instead of truncating (wavelets)", "PCDeflation", def->extendsp, &def->extendsp, NULL));
+  PetscCall(PetscOptionsInt("-pc_deflation_adaptive", "Number of Ritz vectors appended to the deflation space", "PCDeflationSetAdaptive", def->adaptk, &def->adaptk, NULL));
+  PetscCall(PetscOptionsInt("-pc_deflation_adaptive_solves", "Number of solves that update the deflation space", "PCDeflationSetAdaptive", def->adaptsolves, &def->adaptsolves, NULL));
   PetscOptionsHeadEnd();
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -761,7 +1084,9 @@ static PetscErrorCode PCSetFromOptions_Deflation(PC pc, PetscOptionItems PetscOp
 .    -pc_deflation_correction (true|false) - if true apply coarse problem correction
 .    -pc_deflation_correction_factor fact  - sets coarse problem correction factor
 .    -pc_deflation_compute_space type      - see `PCDEFLATIONSpacetype`
--    -pc_deflation_compute_space_size 1    - size of the deflation space (corresponds to number of levels for wavelet-based deflation)
+.    -pc_deflation_compute_space_size 1    - size of the deflation space (corresponds to number of levels for wavelet-based deflation)
+.    -pc_deflation_adaptive k              - append k Ritz vectors computed during the first solves to the deflation space
+-    -pc_deflation_adaptive_solves 1       - number of solves that update the Ritz vectors
 
    Notes:
     Given a (complex - transpose is always Hermitian) full rank deflation matrix W, the deflation (introduced in [1,2])
@@ -804,6 +1129,11 @@ static PetscErrorCode PCSetFromOptions_Deflation(PC pc, PetscOptionItems PetscOp
 
     The options are automatically inherited from the previous deflation level.
 
+    With `PCDeflationSetAdaptive()` or -pc_deflation_adaptive, the deflation space is built from the space given by
+    `PCDeflationSetSpace()` or the near-null space of A (see `MatSetNearNullSpace()`), and extended after each of the
+    first solves with Ritz vectors of A computed from the preconditioned residuals of that solve. The coarse problem is
+    then rebuilt and factored once, so that a sequence of solves with the same operator converges faster.
+
     The preconditioner supports `KSPMonitorDynamicTolerance()`. This is useful for the multilevel scheme for which we also
     recommend limiting the number of iterations for the coarse problems.
 
@@ -828,7 +1158,7 @@ static PetscErrorCode PCSetFromOptions_Deflation(PC pc, PetscOptionItems PetscOp
           `PCDeflationSetInitOnly()`, `PCDeflationSetLevels()`, `PCDeflationSetReductionFactor()`,
           `PCDeflationSetCorrectionFactor()`, `PCDeflationSetSpaceToCompute()`,
           `PCDeflationSetSpace()`, `PCDeflationSpaceType`, `PCDeflationSetProjectionNullSpaceMat()`,
-          `PCDeflationSetCoarseMat()`, `PCDeflationGetCoarseKSP()`, `PCDeflationGetPC()`
+          `PCDeflationSetCoarseMat()`, `PCDeflationGetCoarseKSP()`, `PCDeflationGetPC()`, `PCDeflationSetAdaptive()`
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_Deflation(PC pc)
@@ -850,9 +1180,12 @@ PETSC_EXTERN PetscErrorCode PCCreate_Deflation(PC pc)
   def->maxlvl        = 0;
   def->W             = NULL;
   def->Wt            = NULL;
+  def->adaptk        = 0;
+  def->adaptsolves   = 1;
 
   pc->ops->apply          = PCApply_Deflation;
   pc->ops->presolve       = PCPreSolve_Deflation;
+  pc->ops->postsolve      = PCPostSolve_Deflation;
   pc->ops->setup          = PCSetUp_Deflation;
   pc->ops->reset          = PCReset_Deflation;
   pc->ops->destroy        = PCDestroy_Deflation;
@@ -869,5 +1202,6 @@ PETSC_EXTERN PetscErrorCode PCCreate_Deflation(PC pc)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationSetCoarseMat_C", PCDeflationSetCoarseMat_Deflation));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationGetCoarseKSP_C", PCDeflationGetCoarseKSP_Deflation));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationGetPC_C", PCDeflationGetPC_Deflation));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCDeflationSetAdaptive_C", PCDeflationSetAdaptive_Deflation));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -21,6 +21,17 @@ typedef struct {
   PetscInt             lvl;
   PetscInt             maxlvl;
   PetscBool            extendsp;
+
+  /* adaptive deflation */
+  PetscInt adaptk;      /* number of Ritz vectors appended to the deflation space */
+  PetscInt adaptsolves; /* number of solves used to update the Ritz vectors */
+  PetscInt nadapted;    /* number of updates done so far */
+  PetscInt nbase;       /* leading columns of W that are kept fixed (user space or near-null space) */
+  PetscInt nz, nzmax;   /* number of stored preconditioned residuals */
+  PetscInt nv;          /* number of Ritz vectors */
+  Vec     *Z, *AZ;      /* stored preconditioned residuals and A times them */
+  Vec     *V, *AV;      /* Ritz vectors and A times them */
+  Vec     *Vn, *AVn;    /* work space for the updated Ritz vectors */
 } PC_Deflation;
 
 PETSC_INTERN PetscErrorCode PCDeflationComputeSpace(PC);
@@ -240,6 +240,8 @@ PetscErrorCode PCSetFromOptions_Factor(PC pc, PetscOptionItems PetscOptionsObjec
   if (set) PetscCall(PCFactorSetReuseFill(pc, flg));
   PetscCall(PetscOptionsBool("-pc_factor_reuse_ordering", "Reuse ordering from previous factorization", "PCFactorSetReuseOrdering", PETSC_FALSE, &flg, &set));
   if (set) PetscCall(PCFactorSetReuseOrdering(pc, flg));
+  PetscCall(PetscOptionsBool("-pc_factor_share_symbolic", "Share ordering and symbolic factorization with other PC having the same nonzero pattern", "PCFactorSetShareSymbolic", factor->sharesymbolic, &flg, &set));
+  if (set) PetscCall(PCFactorSetShareSymbolic(pc, flg));
 
   PetscCall(PetscOptionsDeprecated("-pc_factor_mat_solver_package", "-pc_factor_mat_solver_type", "3.9", NULL));
   PetscCall(PetscOptionsString("-pc_factor_mat_solver_type", "Specific direct solver to use", "MatGetFactor", factor->solvertype, solvertype, sizeof(solvertype), &flg));
@@ -273,6 +275,7 @@ PetscErrorCode PCView_Factor(PC pc, PetscViewer viewer)
 
     if (factor->reusefill) PetscCall(PetscViewerASCIIPrintf(viewer, "  Reusing fill from past factorization\n"));
     if (factor->reuseordering) PetscCall(PetscViewerASCIIPrintf(viewer, "  Reusing reordering from past factorization\n"));
+    if (factor->sharesymbolic) PetscCall(PetscViewerASCIIPrintf(viewer, "  Sharing reordering and symbolic factorization with other PC having the same nonzero pattern\n"));
     if (factor->factortype == MAT_FACTOR_ILU || factor->factortype == MAT_FACTOR_ICC) {
       if (factor->info.dt > 0) {
         PetscCall(PetscViewerASCIIPrintf(viewer, "  drop tolerance %g\n", (double)factor->info.dt));
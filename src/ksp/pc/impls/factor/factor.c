@@ -1,5 +1,6 @@
 #include <../src/ksp/pc/impls/factor/factor.h> /*I "petscpc.h" I*/
 #include <petsc/private/matimpl.h>
+#include <petsc/private/hashtable.h>
 
 /*
     If an ordering is not yet set and the matrix is available determine a default ordering
@@ -64,6 +65,15 @@ static PetscErrorCode PCFactorSetReuseFill_Factor(PC pc, PetscBool flag)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode PCFactorSetShareSymbolic_Factor(PC pc, PetscBool flag)
+{
+  PC_Factor *lu = (PC_Factor *)pc->data;
+
+  PetscFunctionBegin;
+  lu->sharesymbolic = flag;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PCFactorSetUseInPlace_Factor(PC pc, PetscBool flg)
 {
   PC_Factor *dir = (PC_Factor *)pc->data;
@@ -688,6 +698,40 @@ PetscErrorCode PCFactorSetReuseFill(PC pc, PetscBool flag)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PCFactorSetShareSymbolic - Shares the ordering and the symbolic factorization between all the `PCLU` and `PCILU`
+  with this option set whose matrices have the same nonzero pattern, each `PC` then only computes the numeric factorization.
+
+  Logically Collective
+
+  Input Parameters:
++ pc   - the preconditioner context
+- flag - `PETSC_TRUE` to share else `PETSC_FALSE`
+
+  Options Database Key:
+. -pc_factor_share_symbolic - Activates `PCFactorSetShareSymbolic()`
+
+  Level: intermediate
+
+  Notes:
+  The sharing is only done for sequential matrices. The `PC` must use the same `MatSolverType`, `MatOrderingType`, levels of fill and
+  diagonal fill to share the factorization. It is not done with `PCFactorReorderForNonzeroDiagonal()` or a drop tolerance since these
+  depend on the matrix values.
+
+  The orderings are shared for all `MatSolverType`, the symbolic factorization only for those that can copy it, currently `MATSOLVERPETSC`
+  with `MATSEQAIJ`. The row and column indices of the factors are then stored only once.
+
+.seealso: [](ch_ksp), `PCLU`, `PCILU`, `PCFactorSetReuseOrdering()`, `PCFactorSetReuseFill()`, `PCFactorSetMatOrderingType()`
+@*/
+PetscErrorCode PCFactorSetShareSymbolic(PC pc, PetscBool flag)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(pc, flag, 2);
+  PetscTryMethod(pc, "PCFactorSetShareSymbolic_C", (PC, PetscBool), (pc, flag));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode PCFactorInitialize(PC pc, MatFactorType ftype)
 {
   PC_Factor *fact = (PC_Factor *)pc->data;
@@ -721,6 +765,7 @@ PetscErrorCode PCFactorInitialize(PC pc, MatFactorType ftype)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorGetUseInPlace_C", PCFactorGetUseInPlace_Factor));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetReuseOrdering_C", PCFactorSetReuseOrdering_Factor));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetReuseFill_C", PCFactorSetReuseFill_Factor));
+  if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU) PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetShareSymbolic_C", PCFactorSetShareSymbolic_Factor));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -747,7 +792,170 @@ PetscErrorCode PCFactorClearComposedFunctions(PC pc)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorGetUseInPlace_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetReuseOrdering_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetReuseFill_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetShareSymbolic_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorReorderForNonzeroDiagonal_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCFactorSetDropTolerance_C", NULL));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+/*
+   Process-wide list of the orderings and symbolic factorizations shared between the PCs using PCFactorSetShareSymbolic(),
+   an entry is found by the hash of the nonzero pattern and the factorization parameters, then the pattern is compared
+*/
+struct _n_PCFactorSharedSymbolic {
+  PetscHash_t            hash;
+  char                  *mattype, *solvertype, *ordering;
+  MatFactorType          factortype;
+  PetscInt               n, bs, *ia, *ja;
+  PetscReal              levels, diagonal_fill;
+  IS                     row, col;
+  Mat                    fact;  /* factored matrix holding the symbolic factorization, NULL if it cannot be copied */
+  PetscBool              setup; /* row, col and fact have been provided by a PC */
+  PetscInt               refct;
+  PCFactorSharedSymbolic next;
+};
+
+static PCFactorSharedSymbolic PCFactorSharedSymbolicList = NULL;
+
+static PetscErrorCode PCFactorSharedSymbolicMatch_Private(PCFactorSharedSymbolic link, PC pc, PetscHash_t hash, PetscInt n, const PetscInt ia[], const PetscInt ja[], PetscBool *match)
+{
+  PC_Factor *factor = (PC_Factor *)pc->data;
+  PetscBool  flg;
+
+  PetscFunctionBegin;
+  *match = PETSC_FALSE;
+  if (link->hash != hash || link->n != n || link->bs != pc->pmat->rmap->bs || link->factortype != factor->factortype) PetscFunctionReturn(PETSC_SUCCESS);
+  if (link->levels != factor->info.levels || link->diagonal_fill != factor->info.diagonal_fill) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscStrcmp(link->mattype, ((PetscObject)pc->pmat)->type_name, &flg));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscStrcmp(link->solvertype, factor->fact->solvertype, &flg));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscStrcmp(link->ordering, factor->ordering, &flg));
+  if (!flg) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscArraycmp(link->ia, ia, n + 1, &flg));
+  if (flg) PetscCall(PetscArraycmp(link->ja, ja, ia[n], &flg));
+  *match = flg;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Finds, or creates, the entry of the list for the pattern of pc->pmat after the factored matrix has been created with PCFactorSetUpMatSolverType().
+
+   shared is true if the orderings of another PC are returned in row and col (the previous ones are destroyed), symbolic is true
+   if the symbolic factorization has also been copied in the factored matrix. Otherwise the caller computes them and then provides
+   them with PCFactorSetSharedSymbolic_Factor().
+*/
+PetscErrorCode PCFactorGetSharedSymbolic_Factor(PC pc, IS *row, IS *col, PetscBool *shared, PetscBool *symbolic)
+{
+  PC_Factor             *factor = (PC_Factor *)pc->data;
+  Mat                    A      = pc->pmat;
+  PCFactorSharedSymbolic link;
+  const PetscInt        *ia, *ja;
+  PetscInt               n;
+  PetscHash_t            hash;
+  PetscBool              done, match = PETSC_FALSE;
+  PetscMPIInt            size;
+  PetscErrorCode (*copy)(Mat, Mat, Mat) = NULL;
+
+  PetscFunctionBegin;
+  *shared   = PETSC_FALSE;
+  *symbolic = PETSC_FALSE;
+  PetscCall(PCFactorReleaseSharedSymbolic_Factor(pc));
+  PetscCallMPI(MPI_Comm_size(PetscObjectComm((PetscObject)A), &size));
+  if (size > 1 || factor->info.usedt) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PCFactorSetDefaultOrdering_Factor(pc));
+  PetscCall(MatGetRowIJ(A, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done));
+  if (!done) PetscFunctionReturn(PETSC_SUCCESS);
+  hash = PetscHashInt(n);
+  for (PetscInt i = 1; i <= n; i++) hash = PetscHashCombine(hash, PetscHashInt(ia[i]));
+  for (PetscInt i = 0; i < ia[n]; i++) hash = PetscHashCombine(hash, PetscHashInt(ja[i]));
+  for (link = PCFactorSharedSymbolicList; link; link = link->next) {
+    PetscCall(PCFactorSharedSymbolicMatch_Private(link, pc, hash, n, ia, ja, &match));
+    if (match) break;
+  }
+  if (!link) {
+    PetscCall(PetscNew(&link));
+    link->hash          = hash;
+    link->n             = n;
+    link->bs            = A->rmap->bs;
+    link->factortype    = factor->factortype;
+    link->levels        = factor->info.levels;
+    link->diagonal_fill = factor->info.diagonal_fill;
+    PetscCall(PetscStrallocpy(((PetscObject)A)->type_name, &link->mattype));
+    PetscCall(PetscStrallocpy(factor->fact->solvertype, &link->solvertype));
+    PetscCall(PetscStrallocpy(factor->ordering, &link->ordering));
+    PetscCall(PetscMalloc2(n + 1, &link->ia, ia[n], &link->ja));
+    PetscCall(PetscArraycpy(link->ia, ia, n + 1));
+    PetscCall(PetscArraycpy(link->ja, ja, ia[n]));
+    link->next                 = PCFactorSharedSymbolicList;
+    PCFactorSharedSymbolicList = link;
+  }
+  PetscCall(MatRestoreRowIJ(A, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done));
+  link->refct++;
+  factor->shared = link;
+  if (!link->setup) PetscFunctionReturn(PETSC_SUCCESS);
+
+  if (*row && *col && *row != *col) PetscCall(ISDestroy(row));
+  PetscCall(ISDestroy(col));
+  *row = link->row;
+  *col = link->col;
+  if (link->row) PetscCall(PetscObjectReference((PetscObject)link->row));
+  if (link->col && link->col != link->row) PetscCall(PetscObjectReference((PetscObject)link->col));
+  *shared = PETSC_TRUE;
+  if (link->fact) PetscCall(PetscObjectQueryFunction((PetscObject)factor->fact, "MatFactorCopySymbolic_C", &copy));
+  if (copy) {
+    PetscCall((*copy)(factor->fact, A, link->fact));
+    *symbolic = PETSC_TRUE;
+  }
+  PetscCall(PetscInfo(pc, "Using the shared ordering%s for a matrix with %" PetscInt_FMT " rows\n", *symbolic ? " and symbolic factorization" : "", link->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Provides the orderings and the symbolic factorization computed by pc to the entry found by PCFactorGetSharedSymbolic_Factor()
+*/
+PetscErrorCode PCFactorSetSharedSymbolic_Factor(PC pc, IS row, IS col)
+{
+  PC_Factor             *factor = (PC_Factor *)pc->data;
+  PCFactorSharedSymbolic link   = factor->shared;
+  PetscErrorCode (*copy)(Mat, Mat, Mat);
+
+  PetscFunctionBegin;
+  if (!link || link->setup) PetscFunctionReturn(PETSC_SUCCESS);
+  link->row = row;
+  link->col = col;
+  if (row) PetscCall(PetscObjectReference((PetscObject)row));
+  if (col && col != row) PetscCall(PetscObjectReference((PetscObject)col));
+  PetscCall(PetscObjectQueryFunction((PetscObject)factor->fact, "MatFactorCopySymbolic_C", &copy));
+  if (copy) {
+    link->fact = factor->fact;
+    PetscCall(PetscObjectReference((PetscObject)link->fact));
+  }
+  link->setup = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Stops using the entry of the list, which is destroyed when no PC uses it anymore
+*/
+PetscErrorCode PCFactorReleaseSharedSymbolic_Factor(PC pc)
+{
+  PC_Factor             *factor = (PC_Factor *)pc->data;
+  PCFactorSharedSymbolic link   = factor->shared, *prev;
+
+  PetscFunctionBegin;
+  if (!link) PetscFunctionReturn(PETSC_SUCCESS);
+  factor->shared = NULL;
+  if (--link->refct) PetscFunctionReturn(PETSC_SUCCESS);
+  for (prev = &PCFactorSharedSymbolicList; *prev != link; prev = &(*prev)->next);
+  *prev = link->next;
+  if (link->row && link->col && link->row != link->col) PetscCall(ISDestroy(&link->row));
+  PetscCall(ISDestroy(&link->col));
+  PetscCall(MatDestroy(&link->fact));
+  PetscCall(PetscFree2(link->ia, link->ja));
+  PetscCall(PetscFree(link->mattype));
+  PetscCall(PetscFree(link->solvertype));
+  PetscCall(PetscFree(link->ordering));
+  PetscCall(PetscFree(link));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -5,6 +5,8 @@
 
 #include <petsc/private/pcimpl.h>
 
+typedef struct _n_PCFactorSharedSymbolic *PCFactorSharedSymbolic;
+
 typedef struct {
   Mat             fact; /* factored matrix */
   MatFactorInfo   info;
@@ -15,6 +17,8 @@ typedef struct {
   PetscBool       inplace;       /* flag indicating in-place factorization */
   PetscBool       reuseordering; /* reuses previous reordering computed */
   PetscBool       reusefill;     /* reuse fill from previous LU */
+  PetscBool       sharesymbolic; /* share ordering and symbolic factorization with other PCs having the same nonzero pattern */
+  PCFactorSharedSymbolic shared; /* entry of the process-wide list currently used */
 } PC_Factor;
 
 PETSC_INTERN PetscErrorCode PCFactorInitialize(PC, MatFactorType);
@@ -42,3 +46,6 @@ PETSC_INTERN PetscErrorCode PCSetFromOptions_Factor(PC, PetscOptionItems PetscOp
 PETSC_INTERN PetscErrorCode PCView_Factor(PC, PetscViewer);
 PETSC_INTERN PetscErrorCode PCFactorSetDefaultOrdering_Factor(PC);
 PETSC_INTERN PetscErrorCode PCFactorClearComposedFunctions(PC);
+PETSC_INTERN PetscErrorCode PCFactorGetSharedSymbolic_Factor(PC, IS *, IS *, PetscBool *, PetscBool *);
+PETSC_INTERN PetscErrorCode PCFactorSetSharedSymbolic_Factor(PC, IS, IS);
+PETSC_INTERN PetscErrorCode PCFactorReleaseSharedSymbolic_Factor(PC);
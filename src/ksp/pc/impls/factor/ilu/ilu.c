@@ -22,6 +22,7 @@ static PetscErrorCode PCReset_ILU(PC pc)
   if (!ilu->hdr.inplace) PetscCall(MatDestroy(&((PC_Factor *)ilu)->fact));
   if (ilu->row && ilu->col && ilu->row != ilu->col) PetscCall(ISDestroy(&ilu->row));
   PetscCall(ISDestroy(&ilu->col));
+  PetscCall(PCFactorReleaseSharedSymbolic_Factor(pc));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -119,24 +120,30 @@ static PetscErrorCode PCSetUp_ILU(PC pc)
     PetscCall(PetscObjectStateGet((PetscObject)pc->pmat, &pc->matstate));
   } else {
     if (!pc->setupcalled) {
-      /* first time in so compute reordering and symbolic factorization */
-      PetscBool canuseordering;
+      /* first time in so compute reordering and symbolic factorization, unless another PC shares them */
+      PetscBool canuseordering, shared = PETSC_FALSE, symbolic = PETSC_FALSE;
 
       PetscCall(PCFactorSetUpMatSolverType(pc));
+      if (ilu->hdr.sharesymbolic && !ilu->nonzerosalongdiagonal) PetscCall(PCFactorGetSharedSymbolic_Factor(pc, &ilu->row, &ilu->col, &shared, &symbolic));
       PetscCall(MatFactorGetCanUseOrdering(((PC_Factor *)ilu)->fact, &canuseordering));
-      if (canuseordering) {
+      if (canuseordering && !shared) {
         PetscCall(PCFactorSetDefaultOrdering_Factor(pc));
         PetscCall(MatGetOrdering(pc->pmat, ((PC_Factor *)ilu)->ordering, &ilu->row, &ilu->col));
         /*  Remove zeros along diagonal?     */
         if (ilu->nonzerosalongdiagonal) PetscCall(MatReorderForNonzeroDiagonal(pc->pmat, ilu->nonzerosalongdiagonaltol, ilu->row, ilu->col));
       }
-      PetscCall(MatILUFactorSymbolic(((PC_Factor *)ilu)->fact, pc->pmat, ilu->row, ilu->col, &((PC_Factor *)ilu)->info));
+      if (!symbolic) PetscCall(MatILUFactorSymbolic(((PC_Factor *)ilu)->fact, pc->pmat, ilu->row, ilu->col, &((PC_Factor *)ilu)->info));
+      if (ilu->hdr.sharesymbolic) PetscCall(PCFactorSetSharedSymbolic_Factor(pc, ilu->row, ilu->col));
       PetscCall(MatGetInfo(((PC_Factor *)ilu)->fact, MAT_LOCAL, &info));
       ilu->hdr.actualfill = info.fill_ratio_needed;
     } else if (pc->flag != SAME_NONZERO_PATTERN) {
+      PetscBool shared = PETSC_FALSE, symbolic = PETSC_FALSE;
+
       PetscCall(MatDestroy(&((PC_Factor *)ilu)->fact));
       PetscCall(PCFactorSetUpMatSolverType(pc));
-      if (!ilu->hdr.reuseordering) {
+      if (ilu->hdr.sharesymbolic && !ilu->hdr.reuseordering && !ilu->nonzerosalongdiagonal) PetscCall(PCFactorGetSharedSymbolic_Factor(pc, &ilu->row, &ilu->col, &shared, &symbolic));
+      else PetscCall(PCFactorReleaseSharedSymbolic_Factor(pc));
+      if (!ilu->hdr.reuseordering && !shared) {
         PetscBool canuseordering;
 
         PetscCall(MatFactorGetCanUseOrdering(((PC_Factor *)ilu)->fact, &canuseordering));
@@ -150,7 +157,8 @@ static PetscErrorCode PCSetUp_ILU(PC pc)
           if (ilu->nonzerosalongdiagonal) PetscCall(MatReorderForNonzeroDiagonal(pc->pmat, ilu->nonzerosalongdiagonaltol, ilu->row, ilu->col));
         }
       }
-      PetscCall(MatILUFactorSymbolic(((PC_Factor *)ilu)->fact, pc->pmat, ilu->row, ilu->col, &((PC_Factor *)ilu)->info));
+      if (!symbolic) PetscCall(MatILUFactorSymbolic(((PC_Factor *)ilu)->fact, pc->pmat, ilu->row, ilu->col, &((PC_Factor *)ilu)->info));
+      if (ilu->hdr.sharesymbolic) PetscCall(PCFactorSetSharedSymbolic_Factor(pc, ilu->row, ilu->col));
       PetscCall(MatGetInfo(((PC_Factor *)ilu)->fact, MAT_LOCAL, &info));
       ilu->hdr.actualfill = info.fill_ratio_needed;
     }
@@ -252,6 +260,7 @@ static PetscErrorCode PCApplySymmetricRight_ILU(PC pc, Vec x, Vec y)
                                                            its factorization (overwrites original matrix)
 .  -pc_factor_diagonal_fill (true|false)                 - fill in a zero diagonal even if levels of fill indicate it wouldn't be filled
 .  -pc_factor_reuse_ordering (true|false)                - reuse ordering of factorized matrix from previous factorization
+.  -pc_factor_share_symbolic (true|false)                - share the ordering and symbolic factorization with other `PC` having the same nonzero pattern
 .  -pc_factor_fill nfill                                 - expected amount of fill in factored matrix compared to original matrix, nfill > 1
 .  -pc_factor_nonzeros_along_diagonal (true|false)       - reorder the matrix before factorization to remove zeros from the diagonal,
                                                            this decreases the chance of getting a zero pivot
@@ -280,7 +289,7 @@ static PetscErrorCode PCApplySymmetricRight_ILU(PC pc, Vec x, Vec y)
           `PCFactorSetZeroPivot()`, `PCFactorSetShiftType()`, `PCFactorSetShiftAmount()`,
           `PCFactorSetDropTolerance()`, `PCFactorSetFill()`, `PCFactorSetMatOrderingType()`, `PCFactorSetReuseOrdering()`,
           `PCFactorSetLevels()`, `PCFactorSetUseInPlace()`, `PCFactorSetAllowDiagonalFill()`, `PCFactorSetPivotInBlocks()`,
-          `PCFactorGetAllowDiagonalFill()`, `PCFactorGetUseInPlace()`
+          `PCFactorGetAllowDiagonalFill()`, `PCFactorGetUseInPlace()`, `PCFactorSetShareSymbolic()`
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_ILU(PC pc)
@@ -74,11 +74,12 @@ static PetscErrorCode PCSetUp_LU(PC pc)
     MatInfo info;
 
     if (!pc->setupcalled) {
-      PetscBool canuseordering;
+      PetscBool canuseordering, shared = PETSC_FALSE, symbolic = PETSC_FALSE;
 
       PetscCall(PCFactorSetUpMatSolverType(pc));
+      if (dir->hdr.sharesymbolic && !dir->nonzerosalongdiagonal) PetscCall(PCFactorGetSharedSymbolic_Factor(pc, &dir->row, &dir->col, &shared, &symbolic));
       PetscCall(MatFactorGetCanUseOrdering(((PC_Factor *)dir)->fact, &canuseordering));
-      if (canuseordering) {
+      if (canuseordering && !shared) {
         PetscBool external;
 
         PetscCall(PCFactorSetDefaultOrdering_Factor(pc));
@@ -88,15 +89,18 @@ static PetscErrorCode PCSetUp_LU(PC pc)
           if (dir->nonzerosalongdiagonal) PetscCall(MatReorderForNonzeroDiagonal(pc->pmat, dir->nonzerosalongdiagonaltol, dir->row, dir->col));
         }
       }
-      PetscCall(MatLUFactorSymbolic(((PC_Factor *)dir)->fact, pc->pmat, dir->row, dir->col, &((PC_Factor *)dir)->info));
+      if (!symbolic) PetscCall(MatLUFactorSymbolic(((PC_Factor *)dir)->fact, pc->pmat, dir->row, dir->col, &((PC_Factor *)dir)->info));
+      if (dir->hdr.sharesymbolic) PetscCall(PCFactorSetSharedSymbolic_Factor(pc, dir->row, dir->col));
       PetscCall(MatGetInfo(((PC_Factor *)dir)->fact, MAT_LOCAL, &info));
       dir->hdr.actualfill = info.fill_ratio_needed;
     } else if (pc->flag != SAME_NONZERO_PATTERN) {
-      PetscBool canuseordering;
+      PetscBool canuseordering, shared = PETSC_FALSE, symbolic = PETSC_FALSE;
 
       PetscCall(MatDestroy(&((PC_Factor *)dir)->fact));
       PetscCall(PCFactorSetUpMatSolverType(pc));
-      if (!dir->hdr.reuseordering) {
+      if (dir->hdr.sharesymbolic && !dir->hdr.reuseordering && !dir->nonzerosalongdiagonal) PetscCall(PCFactorGetSharedSymbolic_Factor(pc, &dir->row, &dir->col, &shared, &symbolic));
+      else PetscCall(PCFactorReleaseSharedSymbolic_Factor(pc));
+      if (!dir->hdr.reuseordering && !shared) {
         PetscCall(MatFactorGetCanUseOrdering(((PC_Factor *)dir)->fact, &canuseordering));
         if (canuseordering) {
           PetscBool external;
@@ -111,7 +115,8 @@ static PetscErrorCode PCSetUp_LU(PC pc)
           }
         }
       }
-      PetscCall(MatLUFactorSymbolic(((PC_Factor *)dir)->fact, pc->pmat, dir->row, dir->col, &((PC_Factor *)dir)->info));
+      if (!symbolic) PetscCall(MatLUFactorSymbolic(((PC_Factor *)dir)->fact, pc->pmat, dir->row, dir->col, &((PC_Factor *)dir)->info));
+      if (dir->hdr.sharesymbolic) PetscCall(PCFactorSetSharedSymbolic_Factor(pc, dir->row, dir->col));
       PetscCall(MatGetInfo(((PC_Factor *)dir)->fact, MAT_LOCAL, &info));
       dir->hdr.actualfill = info.fill_ratio_needed;
     } else {
@@ -151,6 +156,7 @@ static PetscErrorCode PCReset_LU(PC pc)
   if (!dir->hdr.inplace && ((PC_Factor *)dir)->fact) PetscCall(MatDestroy(&((PC_Factor *)dir)->fact));
   if (dir->row && dir->col && dir->row != dir->col) PetscCall(ISDestroy(&dir->row));
   PetscCall(ISDestroy(&dir->col));
+  PetscCall(PCFactorReleaseSharedSymbolic_Factor(pc));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -226,6 +232,7 @@ static PetscErrorCode PCMatApplyTranspose_LU(PC pc, Mat X, Mat Y)
 +  -pc_factor_reuse_ordering (true|false)          - Activate `PCFactorSetReuseOrdering()`
 .  -pc_factor_mat_solver_type type                 - Activates `PCFactorSetMatSolverType()` to choose the direct solver, see `MatSolverType`
 .  -pc_factor_reuse_fill (true|false)              - Activates `PCFactorSetReuseFill()`
+.  -pc_factor_share_symbolic (true|false)          - Activates `PCFactorSetShareSymbolic()`
 .  -pc_factor_fill fill                            - Sets fill amount
 .  -pc_factor_in_place (true|false)                - Activates in-place factorization
 .  -pc_factor_mat_ordering_type ordering           - Sets ordering routine, see `MatOrderingType`
@@ -253,7 +260,7 @@ static PetscErrorCode PCMatApplyTranspose_LU(PC pc, Mat X, Mat Y)
    The options prefix of the factored matrix is set to be the same as the `PC` options prefix, see `MatSetOptionsPrefixFactor()`
 
 .seealso: [](ch_ksp), `PCCreate()`, `PCSetType()`, `PCType`, `PC`, `MatSolverType`, `MatGetFactor()`, `PCQR`, `PCSVD`,
-          `PCILU`, `PCCHOLESKY`, `PCICC`, `PCFactorSetReuseOrdering()`, `PCFactorSetReuseFill()`, `PCFactorGetMatrix()`,
+          `PCILU`, `PCCHOLESKY`, `PCICC`, `PCFactorSetReuseOrdering()`, `PCFactorSetReuseFill()`, `PCFactorSetShareSymbolic()`, `PCFactorGetMatrix()`,
           `PCFactorSetFill()`, `PCFactorSetUseInPlace()`, `PCFactorSetMatOrderingType()`, `PCFactorSetColumnPivot()`,
           `PCFactorSetPivotInBlocks()`, `PCFactorSetShiftType()`, `PCFactorSetShiftAmount()`,
           `PCFactorReorderForNonzeroDiagonal()`
@@ -866,7 +866,7 @@ static PetscErrorCode PCSetUp_FieldSplit(PC pc)
       ilink = jac->head;
       PetscCall(MatCreateSubMatrix(jac->offdiag_use_amat ? pc->mat : pc->pmat, ilink->is, ilink->next->is, scall, &jac->B));
       if (!flg) PetscCall(MatCreateSubMatrix(jac->offdiag_use_amat ? pc->mat : pc->pmat, ilink->next->is, ilink->is, scall, &jac->C));
-      else {
+      else if (scall == MAT_INITIAL_MATRIX) { /* otherwise the (Hermitian) transpose of jac->B updated in place is still valid */
         PetscCall(MatIsHermitianKnown(jac->offdiag_use_amat ? pc->mat : pc->pmat, &isset, &flg));
         if (isset && flg) PetscCall(MatCreateHermitianTranspose(jac->B, &jac->C));
         else PetscCall(MatCreateTranspose(jac->B, &jac->C));
@@ -874,8 +874,9 @@ static PetscErrorCode PCSetUp_FieldSplit(PC pc)
       ilink = ilink->next;
       PetscCall(MatSchurComplementUpdateSubMatrices(jac->schur, jac->mat[0], jac->pmat[0], jac->B, jac->C, jac->mat[1]));
       if (jac->schurpre == PC_FIELDSPLIT_SCHUR_PRE_SELFP) {
-        PetscCall(MatDestroy(&jac->schurp));
-        PetscCall(MatSchurComplementGetPmat(jac->schur, MAT_INITIAL_MATRIX, &jac->schurp));
+        /* with the same nonzero patterns, only the numeric phases of the products are done again and the Schur complement KSP keeps its symbolic setup */
+        if (scall == MAT_INITIAL_MATRIX) PetscCall(MatDestroy(&jac->schurp));
+        PetscCall(MatSchurComplementGetPmat(jac->schur, jac->schurp ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX, &jac->schurp));
       } else if (jac->schurpre == PC_FIELDSPLIT_SCHUR_PRE_FULL && jac->kspupper != jac->head->ksp) {
         PetscCall(MatDestroy(&jac->schur_user));
         PetscCall(MatSchurComplementComputeExplicitOperator(jac->schur, &jac->schur_user));
@@ -591,9 +591,12 @@ static PetscErrorCode PCSetData_AGG(PC pc, Mat a_A)
 */
 static PetscErrorCode formProl0(PetscCoarsenData *agg_llists, PetscInt bs, PetscInt nSAvec, PetscInt my0crs, PetscInt data_stride, PetscReal data_in[], const PetscInt flid_fgid[], PetscReal **a_data_out, Mat a_Prol)
 {
-  PetscInt      Istart, my0, Iend, nloc, clid, flid = 0, aggID, kk, jj, ii, mm, nSelected, minsz, nghosts, out_data_stride;
+  PetscInt      Istart, my0, Iend, nloc, clid, flid = 0, aggID, kk, jj, ii, mm, nSelected, minsz, maxsz, nghosts, out_data_stride, nbatch, b0, qqsz;
+  PetscInt     *agg_ptr, *agg_flid, *qq_ptr, *fids;
   MPI_Comm      comm;
   PetscReal    *out_data;
+  PetscScalar  *qqc, *qqr, *TAU, *WORK;
+  PetscBLASInt  N, LWORK, *Mdata, *info;
   PetscCDIntNd *pos;
   PetscHMapI    fgid_flid;
 
@@ -628,94 +631,137 @@ static PetscErrorCode formProl0(PetscCoarsenData *agg_llists, PetscInt bs, Petsc
   for (ii = 0; ii < out_data_stride * nSAvec; ii++) out_data[ii] = PETSC_MAX_REAL;
   *a_data_out = out_data; /* output - stride nSelected*nSAvec */
 
-  /* find points and set prolongation */
+  /* find points of the aggregates */
+  PetscCall(PetscMalloc1(nSelected + 1, &agg_ptr));
+  for (mm = clid = 0, agg_ptr[0] = 0; mm < nloc; mm++) {
+    PetscCall(PetscCDCountAt(agg_llists, mm, &jj));
+    if (jj > 0) {
+      agg_ptr[clid + 1] = agg_ptr[clid] + jj;
+      clid++;
+    }
+  }
+  PetscCall(PetscMalloc1(agg_ptr[nSelected], &agg_flid));
   minsz = 100;
+  maxsz = 0;
   for (mm = clid = 0; mm < nloc; mm++) {
     PetscCall(PetscCDCountAt(agg_llists, mm, &jj));
     if (jj > 0) {
-      const PetscInt lid = mm, cgid = my0crs + clid;
-      PetscInt       cids[100]; /* max bs */
-      PetscBLASInt   asz, M, N;
-      PetscBLASInt   Mdata, LDA, LWORK;
-      PetscScalar   *qqc, *qqr, *TAU, *WORK;
-      PetscInt      *fids;
-      PetscReal     *data;
-
-      PetscCall(PetscBLASIntCast(jj, &asz));
-      PetscCall(PetscBLASIntCast(asz * bs, &M));
-      PetscCall(PetscBLASIntCast(nSAvec, &N));
-      PetscCall(PetscBLASIntCast(M + ((N - M > 0) ? N - M : 0), &Mdata));
-      PetscCall(PetscBLASIntCast(Mdata, &LDA));
-      PetscCall(PetscBLASIntCast(N * bs, &LWORK));
       /* count agg */
-      if (asz < minsz) minsz = asz;
-
-      /* get block */
-      PetscCall(PetscMalloc5(Mdata * N, &qqc, M * N, &qqr, N, &TAU, LWORK, &WORK, M, &fids));
-
-      aggID = 0;
-      PetscCall(PetscCDGetHeadPos(agg_llists, lid, &pos));
+      if (jj < minsz) minsz = jj;
+      if (jj > maxsz) maxsz = jj;
+      aggID = agg_ptr[clid];
+      PetscCall(PetscCDGetHeadPos(agg_llists, mm, &pos));
       while (pos) {
         PetscInt gid1;
 
         PetscCall(PetscCDIntNdGetID(pos, &gid1));
-        PetscCall(PetscCDGetNextPos(agg_llists, lid, &pos));
+        PetscCall(PetscCDGetNextPos(agg_llists, mm, &pos));
 
         if (gid1 >= my0 && gid1 < Iend) flid = gid1 - my0;
         else {
           PetscCall(PetscHMapIGet(fgid_flid, gid1, &flid));
           PetscCheck(flid >= 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot find gid1 in table");
         }
-        /* copy in B_i matrix - column-oriented */
-        data = &data_in[flid * bs];
-        for (ii = 0; ii < bs; ii++) {
-          for (jj = 0; jj < N; jj++) {
-            PetscReal d = data[jj * data_stride + ii];
+        agg_flid[aggID++] = flid;
+      }
+      clid++;
+    }
+  }
 
-            qqc[jj * Mdata + aggID * bs + ii] = d;
-          }
+  /* the aggregates are independent, their QR are computed in batches of nbatch aggregates that share the workspace, all the
+     aggregates at once with OpenMP kernels and one at a time otherwise */
+  nbatch = PetscDefined(USE_OPENMP_KERNELS) ? PetscMax(nSelected, 1) : 1;
+  PetscCall(PetscBLASIntCast(nSAvec, &N));
+  PetscCall(PetscBLASIntCast(N * bs, &LWORK));
+  PetscCall(PetscMalloc2(nSelected + 1, &qq_ptr, nSelected, &Mdata));
+  for (clid = 0, qq_ptr[0] = 0; clid < nSelected; clid++) {
+    PetscBLASInt M;
+
+    PetscCall(PetscBLASIntCast((agg_ptr[clid + 1] - agg_ptr[clid]) * bs, &M));
+    PetscCall(PetscBLASIntCast(M + ((N - M > 0) ? N - M : 0), &Mdata[clid]));
+    qq_ptr[clid + 1] = qq_ptr[clid] + (PetscInt)Mdata[clid] * nSAvec;
+  }
+  for (b0 = 0, qqsz = 0; b0 < nSelected; b0 += nbatch) qqsz = PetscMax(qqsz, qq_ptr[PetscMin(b0 + nbatch, nSelected)] - qq_ptr[b0]);
+  PetscCall(PetscMalloc4(qqsz, &qqc, nbatch * N, &TAU, nbatch * LWORK, &WORK, 2 * nbatch, &info));
+  PetscCall(PetscMalloc2(maxsz * bs * nSAvec, &qqr, maxsz * bs, &fids));
+
+  for (b0 = 0; b0 < nSelected; b0 += nbatch) {
+    const PetscInt b1 = PetscMin(b0 + nbatch, nSelected);
+
+    PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+    PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+    for (PetscInt c = b0; c < b1; c++) {
+      const PetscInt asz = agg_ptr[c + 1] - agg_ptr[c], M = asz * bs;
+      PetscScalar   *qq = qqc + qq_ptr[c] - qq_ptr[b0];
+
+      /* get block - column-oriented */
+      for (PetscInt a = 0; a < asz; a++) {
+        const PetscReal *data = &data_in[agg_flid[agg_ptr[c] + a] * bs];
+
+        for (PetscInt i = 0; i < bs; i++) {
+          for (PetscInt j = 0; j < N; j++) qq[j * Mdata[c] + a * bs + i] = data[j * data_stride + i];
         }
-        /* set fine IDs */
-        for (kk = 0; kk < bs; kk++) fids[aggID * bs + kk] = flid_fgid[flid] * bs + kk;
-        aggID++;
       }
-
       /* pad with zeros */
-      for (ii = asz * bs; ii < Mdata; ii++) {
-        for (jj = 0; jj < N; jj++, kk++) qqc[jj * Mdata + ii] = .0;
+      for (PetscInt i = M; i < Mdata[c]; i++) {
+        for (PetscInt j = 0; j < N; j++) qq[j * Mdata[c] + i] = .0;
       }
 
       /* QR */
-      PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
-      PetscCallLAPACKInfo("LAPACKgeqrf", LAPACKgeqrf_(&Mdata, &N, qqc, &LDA, TAU, WORK, &LWORK, &info));
-      PetscCall(PetscFPTrapPop());
+      LAPACKgeqrf_(&Mdata[c], &N, qq, &Mdata[c], TAU + (c - b0) * N, WORK + (c - b0) * LWORK, &LWORK, &info[2 * (c - b0)]);
+    }
+    PetscCall(PetscFPTrapPop());
+    for (clid = b0; clid < b1; clid++) {
+      const PetscScalar *qq     = qqc + qq_ptr[clid] - qq_ptr[b0];
+      PetscReal         *data   = &out_data[clid * nSAvec];
+      const PetscBLASInt qrinfo = info[2 * (clid - b0)];
+
+      PetscCheck(qrinfo >= 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "LAPACK routine LAPACKgeqrf %" PetscBLASInt_FMT "-th argument had an illegal value", -qrinfo);
+      PetscCheck(qrinfo <= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "LAPACK routine LAPACKgeqrf failed with INFO = %" PetscBLASInt_FMT, qrinfo);
       /* get R - column-oriented - output B_{i+1} */
-      {
-        PetscReal *data = &out_data[clid * nSAvec];
-
-        for (jj = 0; jj < nSAvec; jj++) {
-          for (ii = 0; ii < nSAvec; ii++) {
-            PetscCheck(data[jj * out_data_stride + ii] == PETSC_MAX_REAL, PETSC_COMM_SELF, PETSC_ERR_PLIB, "data[jj*out_data_stride + ii] != %e", (double)PETSC_MAX_REAL);
-            if (ii <= jj) data[jj * out_data_stride + ii] = PetscRealPart(qqc[jj * Mdata + ii]);
-            else data[jj * out_data_stride + ii] = 0.;
-          }
+      for (jj = 0; jj < nSAvec; jj++) {
+        for (ii = 0; ii < nSAvec; ii++) {
+          PetscCheck(data[jj * out_data_stride + ii] == PETSC_MAX_REAL, PETSC_COMM_SELF, PETSC_ERR_PLIB, "data[jj*out_data_stride + ii] != %e", (double)PETSC_MAX_REAL);
+          if (ii <= jj) data[jj * out_data_stride + ii] = PetscRealPart(qq[jj * Mdata[clid] + ii]);
+          else data[jj * out_data_stride + ii] = 0.;
         }
       }
-
+    }
+    /* get Q */
+    PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+    PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+    for (PetscInt c = b0; c < b1; c++) LAPACKorgqr_(&Mdata[c], &N, &N, qqc + qq_ptr[c] - qq_ptr[b0], &Mdata[c], TAU + (c - b0) * N, WORK + (c - b0) * LWORK, &LWORK, &info[2 * (c - b0) + 1]);
+    PetscCall(PetscFPTrapPop());
+
+    /* set prolongation */
+    for (clid = b0; clid < b1; clid++) {
+      const PetscInt     asz = agg_ptr[clid + 1] - agg_ptr[clid], cgid = my0crs + clid;
+      const PetscInt     M      = asz * bs;
+      const PetscScalar *qq     = qqc + qq_ptr[clid] - qq_ptr[b0];
+      const PetscBLASInt qrinfo = info[2 * (clid - b0) + 1];
+      PetscInt           cids[100]; /* max bs */
+
+      PetscCheck(qrinfo >= 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "LAPACK routine LAPACKorgqr %" PetscBLASInt_FMT "-th argument had an illegal value", -qrinfo);
+      PetscCheck(qrinfo <= 0, PETSC_COMM_SELF, PETSC_ERR_LIB, "LAPACK routine LAPACKorgqr failed with INFO = %" PetscBLASInt_FMT, qrinfo);
+      /* set fine IDs */
+      for (aggID = 0; aggID < asz; aggID++) {
+        for (kk = 0; kk < bs; kk++) fids[aggID * bs + kk] = flid_fgid[agg_flid[agg_ptr[clid] + aggID]] * bs + kk;
+      }
       /* get Q - row-oriented */
-      PetscCallLAPACKInfo("LAPACKorgqr", LAPACKorgqr_(&Mdata, &N, &N, qqc, &LDA, TAU, WORK, &LWORK, &info));
-
       for (ii = 0; ii < M; ii++) {
-        for (jj = 0; jj < N; jj++) qqr[N * ii + jj] = qqc[jj * Mdata + ii];
+        for (jj = 0; jj < N; jj++) qqr[N * ii + jj] = qq[jj * Mdata[clid] + ii];
       }
 
       /* add diagonal block of P0 */
       for (kk = 0; kk < N; kk++) cids[kk] = N * cgid + kk; /* global col IDs in P0 */
       PetscCall(MatSetValues(a_Prol, M, fids, N, cids, qqr, INSERT_VALUES));
-      PetscCall(PetscFree5(qqc, qqr, TAU, WORK, fids));
-      clid++;
-    } /* coarse agg */
-  } /* for all fine nodes */
+    }
+  }
+  PetscCall(PetscFree2(qqr, fids));
+  PetscCall(PetscFree4(qqc, TAU, WORK, info));
+  PetscCall(PetscFree2(qq_ptr, Mdata));
+  PetscCall(PetscFree(agg_flid));
+  PetscCall(PetscFree(agg_ptr));
   PetscCall(MatAssemblyBegin(a_Prol, MAT_FINAL_ASSEMBLY));
   PetscCall(MatAssemblyEnd(a_Prol, MAT_FINAL_ASSEMBLY));
   PetscCall(PetscHMapIDestroy(&fgid_flid));
@@ -1808,30 +1854,27 @@ static PetscErrorCode PCGAMGKernelPreservingFilter_AGG(PC pc, Mat Prol, PetscRea
 }
 
 /*
-   PCGAMGOptimizeProlongator_AGG - given the initial prolongator optimizes it by smoothed aggregation pc_gamg_agg->nsmooths times
+   PCGAMGProlongatorEstimateEigenvalues_AGG - estimates the spectrum of D^{-1}A used to smooth the prolongator and caches it for the smoothers
 
   Input Parameter:
    . pc - this
    . Amat - matrix on this fine level
- In/Output Parameter:
-   . a_P - prolongation operator to the next level
+ Output Parameter:
+   . a_emax - maximum eigenvalue estimate
 */
-static PetscErrorCode PCGAMGOptimizeProlongator_AGG(PC pc, Mat Amat, Mat *a_P)
+static PetscErrorCode PCGAMGProlongatorEstimateEigenvalues_AGG(PC pc, Mat Amat, PetscReal *a_emax)
 {
   PC_MG       *mg          = (PC_MG *)pc->data;
   PC_GAMG     *pc_gamg     = (PC_GAMG *)mg->innerctx;
   PC_GAMG_AGG *pc_gamg_agg = (PC_GAMG_AGG *)pc_gamg->subctx;
-  Mat          Prol        = *a_P;
   MPI_Comm     comm;
   KSP          eksp;
   Vec          bb, xx;
   PC           epc;
-  PetscReal    alpha, emax, emin;
+  PetscReal    emax = 0, emin = 0;
 
   PetscFunctionBegin;
   PetscCall(PetscObjectGetComm((PetscObject)Amat, &comm));
-  PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_OPT], 0, 0, 0, 0));
-
   /* compute maximum singular value of operator to be used in smoother */
   if (0 < pc_gamg_agg->nsmooths) {
     /* get eigen estimates */
@@ -1890,41 +1933,106 @@ static PetscErrorCode PCGAMGOptimizeProlongator_AGG(PC pc, Mat Amat, Mat *a_P)
     mg->min_eigen_DinvA[pc_gamg->current_level] = 0;
     mg->max_eigen_DinvA[pc_gamg->current_level] = 0;
   }
+  *a_emax = emax;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 
-  /* smooth P0 */
-  if (pc_gamg_agg->nsmooths > 0) {
-    Vec diag;
+/*
+   PCGAMGSmoothProlongator_AGG - smooths the tentative prolongator pc_gamg_agg->nsmooths times
 
-    /* TODO: Set a PCFailedReason and exit the building of the AMG preconditioner */
-    PetscCheck(emax != 0.0, PetscObjectComm((PetscObject)pc), PETSC_ERR_PLIB, "Computed maximum singular value as zero");
+  Input Parameter:
+   . pc - this
+   . Amat - matrix on this fine level
+   . emax - maximum eigenvalue estimate of D^{-1}A
+   . reuse - MAT_INITIAL_MATRIX to create the smoothed prolongator, MAT_REUSE_MATRIX to update its values
+   . P0 - tentative prolongator
+ In/Output Parameter:
+   . a_P - smoothed prolongator
+*/
+static PetscErrorCode PCGAMGSmoothProlongator_AGG(PC pc, Mat Amat, PetscReal emax, MatReuse reuse, Mat P0, Mat *a_P)
+{
+  PC_MG       *mg          = (PC_MG *)pc->data;
+  PC_GAMG     *pc_gamg     = (PC_GAMG *)mg->innerctx;
+  PC_GAMG_AGG *pc_gamg_agg = (PC_GAMG_AGG *)pc_gamg->subctx;
+  Mat          Prol        = P0;
+  PetscReal    alpha;
+  Vec          diag;
 
-    PetscCall(MatCreateVecs(Amat, &diag, NULL));
-    PetscCall(MatGetDiagonal(Amat, diag)); /* effectively PCJACOBI */
-    PetscCall(VecReciprocal(diag));
+  PetscFunctionBegin;
+  /* TODO: Set a PCFailedReason and exit the building of the AMG preconditioner */
+  PetscCheck(emax != 0.0, PetscObjectComm((PetscObject)pc), PETSC_ERR_PLIB, "Computed maximum singular value as zero");
 
-    for (PetscInt jj = 0; jj < pc_gamg_agg->nsmooths; jj++) {
-      Mat tMat;
+  PetscCall(MatCreateVecs(Amat, &diag, NULL));
+  PetscCall(MatGetDiagonal(Amat, diag)); /* effectively PCJACOBI */
+  PetscCall(VecReciprocal(diag));
 
-      PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_OPTSM], 0, 0, 0, 0));
-      /*
-        Smooth aggregation on the prolongator
+  PetscCall(PetscObjectReference((PetscObject)Prol));
+  for (PetscInt jj = 0; jj < pc_gamg_agg->nsmooths; jj++) {
+    Mat tMat = NULL;
 
-        P_{i} := (I - 1.4/emax D^{-1}A) P_i\{i-1}
-      */
-      PetscCall(PetscLogEventBegin(petsc_gamg_setup_matmat_events[pc_gamg->current_level][2], 0, 0, 0, 0));
+    PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_OPTSM], 0, 0, 0, 0));
+    /*
+      Smooth aggregation on the prolongator
+
+      P_{i} := (I - 1.4/emax D^{-1}A) P_i\{i-1}
+    */
+    PetscCall(PetscLogEventBegin(petsc_gamg_setup_matmat_events[pc_gamg->current_level][2], 0, 0, 0, 0));
+    if (reuse == MAT_REUSE_MATRIX && pc_gamg_agg->nsmooths == 1 && (*a_P)->product) {
+      /* numeric product only, into the smoothed prolongator */
+      tMat = *a_P;
+      PetscCall(MatMatMult(Amat, Prol, MAT_REUSE_MATRIX, PETSC_CURRENT, &tMat));
+      PetscCall(PetscObjectReference((PetscObject)tMat));
+    } else {
       PetscCall(MatMatMult(Amat, Prol, MAT_INITIAL_MATRIX, PETSC_CURRENT, &tMat));
-      PetscCall(PetscLogEventEnd(petsc_gamg_setup_matmat_events[pc_gamg->current_level][2], 0, 0, 0, 0));
-      PetscCall(MatProductClear(tMat));
-      PetscCall(MatDiagonalScale(tMat, diag, NULL));
-
-      /* TODO: Document the 1.4 and don't hardwire it in this routine */
-      alpha = -1.4 / emax;
-      PetscCall(MatAYPX(tMat, alpha, Prol, SUBSET_NONZERO_PATTERN));
-      PetscCall(MatDestroy(&Prol));
-      Prol = tMat;
-      PetscCall(PetscLogEventEnd(petsc_gamg_setup_events[GAMG_OPTSM], 0, 0, 0, 0));
+      /* keep the symbolic product to update the prolongator in place on the next setup */
+      if (!pc_gamg->reuse_aggs || pc_gamg_agg->nsmooths != 1) PetscCall(MatProductClear(tMat));
     }
-    PetscCall(VecDestroy(&diag));
+    PetscCall(PetscLogEventEnd(petsc_gamg_setup_matmat_events[pc_gamg->current_level][2], 0, 0, 0, 0));
+    PetscCall(MatDiagonalScale(tMat, diag, NULL));
+
+    /* TODO: Document the 1.4 and don't hardwire it in this routine */
+    alpha = -1.4 / emax;
+    PetscCall(MatAYPX(tMat, alpha, Prol, SUBSET_NONZERO_PATTERN));
+    PetscCall(MatDestroy(&Prol));
+    Prol = tMat;
+    PetscCall(PetscLogEventEnd(petsc_gamg_setup_events[GAMG_OPTSM], 0, 0, 0, 0));
+  }
+  PetscCall(VecDestroy(&diag));
+  if (reuse == MAT_REUSE_MATRIX) {
+    /* same aggregates and matrix nonzero structure, hence same nonzero structure of the prolongator */
+    if (Prol != *a_P) PetscCall(MatCopy(Prol, *a_P, SAME_NONZERO_PATTERN));
+    PetscCall(MatDestroy(&Prol));
+  } else *a_P = Prol;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   PCGAMGOptimizeProlongator_AGG - given the initial prolongator optimizes it by smoothed aggregation pc_gamg_agg->nsmooths times
+
+  Input Parameter:
+   . pc - this
+   . Amat - matrix on this fine level
+ In/Output Parameter:
+   . a_P - prolongation operator to the next level
+*/
+static PetscErrorCode PCGAMGOptimizeProlongator_AGG(PC pc, Mat Amat, Mat *a_P)
+{
+  PC_MG       *mg          = (PC_MG *)pc->data;
+  PC_GAMG     *pc_gamg     = (PC_GAMG *)mg->innerctx;
+  PC_GAMG_AGG *pc_gamg_agg = (PC_GAMG_AGG *)pc_gamg->subctx;
+  Mat          Prol        = *a_P;
+  PetscReal    emax;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_OPT], 0, 0, 0, 0));
+  PetscCall(PCGAMGProlongatorEstimateEigenvalues_AGG(pc, Amat, &emax));
+
+  /* smooth P0 */
+  if (pc_gamg_agg->nsmooths > 0) {
+    Mat P0 = Prol;
+
+    PetscCall(PCGAMGSmoothProlongator_AGG(pc, Amat, emax, MAT_INITIAL_MATRIX, P0, &Prol));
+    PetscCall(MatDestroy(&P0));
   }
   if (pc_gamg->prolongator_filter > 0.0) PetscCall(PCGAMGKernelPreservingFilter_AGG(pc, Prol, pc_gamg->prolongator_filter));
   PetscCall(PetscLogEventEnd(petsc_gamg_setup_events[GAMG_OPT], 0, 0, 0, 0));
@@ -1933,6 +2041,31 @@ static PetscErrorCode PCGAMGOptimizeProlongator_AGG(PC pc, Mat Amat, Mat *a_P)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   PCGAMGUpdateProlongator_AGG - recomputes the values of the smoothed prolongator from the tentative one after the values of the matrix changed
+
+  Input Parameter:
+   . pc - this
+   . Amat - matrix on this fine level
+   . P0 - tentative prolongator
+ In/Output Parameter:
+   . P - smoothed prolongator, with the same nonzero structure
+*/
+static PetscErrorCode PCGAMGUpdateProlongator_AGG(PC pc, Mat Amat, Mat P0, Mat P)
+{
+  PC_MG       *mg          = (PC_MG *)pc->data;
+  PC_GAMG     *pc_gamg     = (PC_GAMG *)mg->innerctx;
+  PC_GAMG_AGG *pc_gamg_agg = (PC_GAMG_AGG *)pc_gamg->subctx;
+  PetscReal    emax;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_OPT], 0, 0, 0, 0));
+  PetscCall(PCGAMGProlongatorEstimateEigenvalues_AGG(pc, Amat, &emax));
+  if (pc_gamg_agg->nsmooths > 0) PetscCall(PCGAMGSmoothProlongator_AGG(pc, Amat, emax, MAT_REUSE_MATRIX, P0, &P));
+  PetscCall(PetscLogEventEnd(petsc_gamg_setup_events[GAMG_OPT], 0, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*MC
   PCGAMGAGG - Smooth aggregation, {cite}`vanek1996algebraic`, {cite}`vanek2001convergence`, variant of PETSc's algebraic multigrid (`PCGAMG`) preconditioner
 
@@ -1983,6 +2116,7 @@ PetscErrorCode PCCreateGAMG_AGG(PC pc)
   pc_gamg->ops->coarsen           = PCGAMGCoarsen_AGG;
   pc_gamg->ops->prolongator       = PCGAMGConstructProlongator_AGG;
   pc_gamg->ops->optprolongator    = PCGAMGOptimizeProlongator_AGG;
+  pc_gamg->ops->updateprolongator = PCGAMGUpdateProlongator_AGG;
   pc_gamg->ops->createdefaultdata = PCSetData_AGG;
   pc_gamg->ops->view              = PCView_GAMG_AGG;
 
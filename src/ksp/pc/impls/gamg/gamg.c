@@ -38,6 +38,11 @@ static PetscErrorCode PCReset_GAMG(PC pc)
   }
   pc_gamg->emin = 0;
   pc_gamg->emax = 0;
+  for (PetscInt level = 0; level < PETSC_MG_MAXLEVELS; level++) {
+    PetscCall(MatDestroy(&pc_gamg->Ptent[level]));
+    PetscCall(MatDestroy(&pc_gamg->Psmooth[level]));
+    PetscCall(ISDestroy(&pc_gamg->Pcolperm[level]));
+  }
   PetscCall(PCReset_MG(pc));
   PetscCall(MatCoarsenDestroy(&pc_gamg->asm_crs));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -545,7 +550,7 @@ static PetscErrorCode PCSetUp_GAMG(PC pc)
   PetscMPIInt rank, size, nactivepe;
   Mat         Aarr[PETSC_MG_MAXLEVELS], Parr[PETSC_MG_MAXLEVELS];
   IS         *ASMLocalIDsArr[PETSC_MG_MAXLEVELS];
-  PetscBool   is_last = PETSC_FALSE;
+  PetscBool   is_last = PETSC_FALSE, keep_aggs;
 #if PetscDefined(USE_INFO)
   PetscLogDouble nnz0 = 0., nnztot = 0.;
   MatInfo        info;
@@ -556,9 +561,16 @@ static PetscErrorCode PCSetUp_GAMG(PC pc)
   PetscCallMPI(MPI_Comm_rank(comm, &rank));
   PetscCallMPI(MPI_Comm_size(comm, &size));
   PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_SETUP], 0, 0, 0, 0));
+  /* the prolongators can only be updated in place if they do not depend on the near null space data, which is not kept */
+  keep_aggs = (PetscBool)(pc_gamg->reuse_aggs && pc_gamg->ops->updateprolongator && pc_gamg->prolongator_filter <= 0.0);
   if (pc->setupcalled) {
-    if (!pc_gamg->reuse_prol || pc->flag == DIFFERENT_NONZERO_PATTERN) {
+    if ((!pc_gamg->reuse_prol && !keep_aggs) || pc->flag == DIFFERENT_NONZERO_PATTERN) {
       /* reset everything */
+      for (level = 0; level < PETSC_MG_MAXLEVELS; level++) {
+        PetscCall(MatDestroy(&pc_gamg->Ptent[level]));
+        PetscCall(MatDestroy(&pc_gamg->Psmooth[level]));
+        PetscCall(ISDestroy(&pc_gamg->Pcolperm[level]));
+      }
       PetscCall(PCReset_MG(pc));
       pc->setupcalled = PETSC_FALSE;
     } else {
@@ -577,6 +589,23 @@ static PetscErrorCode PCSetUp_GAMG(PC pc)
 #if defined(GAMG_STAGES)
           PetscCall(PetscLogStagePush(gamg_stages[gl]));
 #endif
+          /* recompute the values of the prolongator from the kept aggregates, its nonzero structure is unchanged */
+          if (keep_aggs && pc_gamg->Psmooth[gl + 1]) {
+            pc_gamg->current_level = gl;
+            PetscCall(PetscInfo(pc, "%s: update prolongator with the previous aggregates, level %" PetscInt_FMT "\n", ((PetscObject)pc)->prefix, level));
+            PetscCall(pc_gamg->ops->updateprolongator(pc, dB, pc_gamg->Ptent[gl + 1], pc_gamg->Psmooth[gl + 1]));
+            if (pc_gamg->Pcolperm[gl + 1]) {
+              IS       findices;
+              PetscInt Istart, Iend, f_bs;
+
+              PetscCall(MatGetBlockSize(dB, &f_bs));
+              PetscCall(MatGetOwnershipRange(pc_gamg->Psmooth[gl + 1], &Istart, &Iend));
+              PetscCall(ISCreateStride(comm, Iend - Istart, Istart, 1, &findices));
+              PetscCall(ISSetBlockSize(findices, f_bs));
+              PetscCall(MatCreateSubMatrix(pc_gamg->Psmooth[gl + 1], findices, pc_gamg->Pcolperm[gl + 1], MAT_REUSE_MATRIX, &mglevels[level + 1]->interpolate));
+              PetscCall(ISDestroy(&findices));
+            }
+          }
           /* matrix nonzero structure can change from repartitioning or process reduction but don't know if we have process reduction here. Should fix */
           PetscCall(KSPGetOperators(mglevels[level]->smoothd, NULL, &B));
           if (B->product) {
@@ -601,8 +630,15 @@ static PetscErrorCode PCSetUp_GAMG(PC pc)
             PetscCall(PetscObjectTypeCompare((PetscObject)smoother, KSPCHEBYSHEV, &ischeb));
             if (ischeb) {
               KSP_Chebyshev *cheb = (KSP_Chebyshev *)smoother->data;
-              cheb->emin_provided = 0;
-              cheb->emax_provided = 0;
+
+              /* the prolongator update estimated the spectrum of the new operator */
+              if (keep_aggs && pc_gamg->use_sa_esteig && mg->max_eigen_DinvA[gl] > 0) {
+                cheb->emin_provided = mg->min_eigen_DinvA[gl];
+                cheb->emax_provided = mg->max_eigen_DinvA[gl];
+              } else {
+                cheb->emin_provided = 0;
+                cheb->emax_provided = 0;
+              }
             }
             /* we could call PetscCall(KSPChebyshevSetEigenvalues(smoother, 0, 0)); but the logic does not work properly */
           }
@@ -741,8 +777,17 @@ static PetscErrorCode PCSetUp_GAMG(PC pc)
         PetscCall(MatGetBlockSizes(Prol11, NULL, &cr_bs)); // column size
 
         if (pc_gamg->ops->optprolongator) {
+          /* keep the tentative and the smoothed prolongators to update them on the next setup */
+          if (keep_aggs) {
+            PetscCall(PetscObjectReference((PetscObject)Prol11));
+            pc_gamg->Ptent[level1] = Prol11;
+          }
           /* smooth */
           PetscCall(pc_gamg->ops->optprolongator(pc, Aarr[level], &Prol11));
+          if (keep_aggs) {
+            PetscCall(PetscObjectReference((PetscObject)Prol11));
+            pc_gamg->Psmooth[level1] = Prol11;
+          }
         }
 
         if (pc_gamg->use_aggs_in_asm) {
@@ -806,7 +851,7 @@ static PetscErrorCode PCSetUp_GAMG(PC pc)
     if (level1 == pc_gamg->Nlevels - 1) is_last = PETSC_TRUE;
     if (level == PETSC_MG_MAXLEVELS - 2) is_last = PETSC_TRUE;
     PetscCall(PetscLogEventBegin(petsc_gamg_setup_events[GAMG_LEVEL], 0, 0, 0, 0));
-    PetscCall(pc_gamg->ops->createlevel(pc, Aarr[level], cr_bs, &Parr[level1], &Aarr[level1], &nactivepe, NULL, is_last));
+    PetscCall(pc_gamg->ops->createlevel(pc, Aarr[level], cr_bs, &Parr[level1], &Aarr[level1], &nactivepe, pc_gamg->Psmooth[level1] ? &pc_gamg->Pcolperm[level1] : NULL, is_last));
     PetscCall(PetscLogEventEnd(petsc_gamg_setup_events[GAMG_LEVEL], 0, 0, 0, 0));
 
     PetscCall(MatGetSize(Aarr[level1], &M, &N)); /* M is loop test variables */
@@ -986,6 +1031,7 @@ PetscErrorCode PCDestroy_GAMG(PC pc)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetUseSAEstEig_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetRecomputeEstEig_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetReuseInterpolation_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetReuseAggregates_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGASMSetUseAggs_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetParallelCoarseGridSolve_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetCpuPinCoarseGrids_C", NULL));
@@ -1276,6 +1322,51 @@ static PetscErrorCode PCGAMGSetReuseInterpolation_GAMG(PC pc, PetscBool n)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PCGAMGSetReuseAggregates - Reuse the aggregates, and the nonzero structure of the prolongation, when rebuilding a `PCGAMG` algebraic multigrid
+  preconditioner when only the values of the matrix have changed
+
+  Logically Collective
+
+  Input Parameters:
++ pc  - the preconditioner context
+- flg - `PETSC_TRUE` or `PETSC_FALSE`
+
+  Options Database Key:
+. -pc_gamg_reuse_aggregates (true|false) - reuse the previous aggregates
+
+  Level: intermediate
+
+  Notes:
+  The graph, the coarsening and the tentative prolongation are not recomputed, only the smoothing of the prolongation with the
+  new matrix values is, using the symbolic products of the previous setup, followed by the numeric Galerkin products. This is
+  between `PCGAMGSetReuseInterpolation()`, which keeps the prolongation and may converge poorly when the matrix entries change a
+  great deal, and a full setup.
+
+  This is only available for `PCGAMGAGG` without `-pc_gamg_prolongator_filter`; a full setup is done otherwise, or when the
+  nonzero structure of the matrix changes. Changes in the near null space of the matrix are not taken into account.
+
+.seealso: [the Users Manual section on PCGAMG](sec_amg), [](ch_ksp), `PCGAMG`, `PCGAMGSetReuseInterpolation()`, `PCGAMGSetNSmooths()`
+@*/
+PetscErrorCode PCGAMGSetReuseAggregates(PC pc, PetscBool flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc, PC_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(pc, flg, 2);
+  PetscTryMethod(pc, "PCGAMGSetReuseAggregates_C", (PC, PetscBool), (pc, flg));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCGAMGSetReuseAggregates_GAMG(PC pc, PetscBool flg)
+{
+  PC_MG   *mg      = (PC_MG *)pc->data;
+  PC_GAMG *pc_gamg = (PC_GAMG *)mg->innerctx;
+
+  PetscFunctionBegin;
+  pc_gamg->reuse_aggs = flg;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PCGAMGASMSetUseAggs - Have the `PCGAMG` smoother on each level use `PCASM` where the aggregates defined by the coarsening process are
   used as the subdomains for the additive Schwarz preconditioner smoother
@@ -1725,6 +1816,7 @@ static PetscErrorCode PCView_GAMG(PC pc, PetscViewer viewer)
     PetscCall(PetscViewerASCIIPopTab(viewer));
   }
   if (pc_gamg->use_parallel_coarse_grid_solver) PetscCall(PetscViewerASCIIPrintf(viewer, "      Using parallel coarse grid solver (all coarse grid equations not put on one process)\n"));
+  if (pc_gamg->reuse_aggs) PetscCall(PetscViewerASCIIPrintf(viewer, "      Reusing the aggregates when only the matrix values change\n"));
   if (pc_gamg->injection_index_size) {
     PetscCall(PetscViewerASCIIPrintf(viewer, "      Using injection restriction/prolongation on first level, dofs:"));
     for (int i = 0; i < pc_gamg->injection_index_size; i++) PetscCall(PetscViewerASCIIPrintf(viewer, " %" PetscInt_FMT, pc_gamg->injection_index[i]));
@@ -1821,6 +1913,7 @@ static PetscErrorCode PCSetFromOptions_GAMG(PC pc, PetscOptionItems PetscOptions
   PetscCall(PetscOptionsBool("-pc_gamg_use_sa_esteig", "Use eigen estimate from smoothed aggregation for smoother", "PCGAMGSetUseSAEstEig", pc_gamg->use_sa_esteig, &pc_gamg->use_sa_esteig, NULL));
   PetscCall(PetscOptionsBool("-pc_gamg_recompute_esteig", "Set flag to recompute eigen estimates for Chebyshev when matrix changes", "PCGAMGSetRecomputeEstEig", pc_gamg->recompute_esteig, &pc_gamg->recompute_esteig, NULL));
   PetscCall(PetscOptionsBool("-pc_gamg_reuse_interpolation", "Reuse prolongation operator", "PCGAMGReuseInterpolation", pc_gamg->reuse_prol, &pc_gamg->reuse_prol, NULL));
+  PetscCall(PetscOptionsBool("-pc_gamg_reuse_aggregates", "Reuse the aggregates and update the prolongation operator", "PCGAMGSetReuseAggregates", pc_gamg->reuse_aggs, &pc_gamg->reuse_aggs, NULL));
   PetscCall(PetscOptionsBool("-pc_gamg_asm_use_agg", "Use aggregation aggregates for ASM smoother", "PCGAMGASMSetUseAggs", pc_gamg->use_aggs_in_asm, &pc_gamg->use_aggs_in_asm, NULL));
   PetscCall(PetscOptionsBool("-pc_gamg_parallel_coarse_grid_solver", "Use parallel coarse grid solver (otherwise put last grid on one process)", "PCGAMGSetParallelCoarseGridSolve", pc_gamg->use_parallel_coarse_grid_solver, &pc_gamg->use_parallel_coarse_grid_solver, NULL));
   PetscCall(PetscOptionsBool("-pc_gamg_cpu_pin_coarse_grids", "Pin coarse grids to the CPU", "PCGAMGSetCpuPinCoarseGrids", pc_gamg->cpu_pin_coarse_grids, &pc_gamg->cpu_pin_coarse_grids, NULL));
@@ -1880,6 +1973,7 @@ static PetscErrorCode PCSetFromOptions_GAMG(PC pc, PetscOptionItems PetscOptions
                                                equations on each process that has degrees of freedom
 . -pc_gamg_coarse_eq_limit limit             - set maximum number of equations on coarsest grid to aim for
 . -pc_gamg_reuse_interpolation (true|false)  - when rebuilding the algebraic multigrid preconditioner reuse the previously computed interpolations (should always be true)
+. -pc_gamg_reuse_aggregates (true|false)     - when rebuilding the algebraic multigrid preconditioner reuse the previous aggregates and only update the interpolations, see `PCGAMGSetReuseAggregates()`
 . -pc_gamg_threshold l0,l1,...               - before aggregating the graph `PCGAMG` will remove small values from the graph on each level (< 0 does no filtering)
 - -pc_gamg_threshold_scale scale             - scaling of threshold on each coarser grid if not specified
 
@@ -1895,7 +1989,7 @@ static PetscErrorCode PCSetFromOptions_GAMG(PC pc, PetscOptionItems PetscOptions
   Options Database Keys for Multigrid:
 + -pc_mg_cycle_type (v|w)                            - see `PCMGSetCycleType()`
 . -pc_mg_distinct_smoothup                           - configure the up and down (pre and post) smoothers separately, see `PCMGSetDistinctSmoothUp()`
-. -pc_mg_type (additive|multiplicative|full|kaskade) - see `PCMGType`
+. -pc_mg_type (additive|multiplicative|full|kaskade|multadditive) - see `PCMGType`
 - -pc_mg_levels levels                               - number of levels of multigrid to use; `PCGAMG` has a heuristic to determine the number of levels so
                                                        this is not usually used with `PCGAMG`
 
@@ -1954,6 +2048,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetUseSAEstEig_C", PCGAMGSetUseSAEstEig_GAMG));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetRecomputeEstEig_C", PCGAMGSetRecomputeEstEig_GAMG));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetReuseInterpolation_C", PCGAMGSetReuseInterpolation_GAMG));
+  PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetReuseAggregates_C", PCGAMGSetReuseAggregates_GAMG));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGASMSetUseAggs_C", PCGAMGASMSetUseAggs_GAMG));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetParallelCoarseGridSolve_C", PCGAMGSetParallelCoarseGridSolve_GAMG));
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetCpuPinCoarseGrids_C", PCGAMGSetCpuPinCoarseGrids_GAMG));
@@ -1968,6 +2063,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   PetscCall(PetscObjectComposeFunction((PetscObject)pc, "PCGAMGSetInjectionIndex_C", PCGAMGSetInjectionIndex_GAMG));
   pc_gamg->repart                          = PETSC_FALSE;
   pc_gamg->reuse_prol                      = PETSC_TRUE;
+  pc_gamg->reuse_aggs                      = PETSC_FALSE;
   pc_gamg->use_aggs_in_asm                 = PETSC_FALSE;
   pc_gamg->use_parallel_coarse_grid_solver = PETSC_FALSE;
   pc_gamg->cpu_pin_coarse_grids            = PETSC_FALSE;
@@ -361,6 +361,20 @@ static PetscErrorCode PCApply_Jacobi(PC pc, Vec x, Vec y)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   PCJacobiGetDiagonalRead_Private - Returns the inverse diagonal used by PCApply_Jacobi(), not a copy, so that callers always see
+   the current diagonal of the preconditioner, whatever its PCJacobiType and options
+*/
+PetscErrorCode PCJacobiGetDiagonalRead_Private(PC pc, Vec *diag)
+{
+  PC_Jacobi *jac = (PC_Jacobi *)pc->data;
+
+  PetscFunctionBegin;
+  if (!jac->diag) PetscCall(PCSetUp_Jacobi_NonSymmetric(pc));
+  *diag = jac->diag;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
    PCApplySymmetricLeftOrRight_Jacobi - Applies the left or right part of a
    symmetric preconditioner to a vector.
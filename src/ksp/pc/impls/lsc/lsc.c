@@ -1,10 +1,12 @@
 #include <petsc/private/pcimpl.h> /*I "petscpc.h" I*/
 
 typedef struct {
-  PetscBool allocated, commute, scalediag;
-  KSP       kspL, kspMass;
-  Vec       Avec0, Avec1, Svec0, scale;
-  Mat       L;
+  PetscBool        allocated, commute, scalediag;
+  KSP              kspL, kspMass;
+  Vec              Avec0, Avec1, Svec0, scale;
+  Mat              L, CAdiaginv;
+  PetscObjectId    id[2];           /* B and C the product L was computed with */
+  PetscObjectState nonzerostate[2]; /* and their nonzero states */
 } PC_LSC;
 
 static PetscErrorCode PCLSCAllocate_Private(PC pc)
@@ -70,15 +72,29 @@ static PetscErrorCode PCSetUp_LSC(PC pc)
       PetscCall(VecReciprocal(lsc->scale));
     }
     if (!L) {
-      Mat B, C;
+      Mat              B, C, M[2];
+      PetscObjectId    id[2];
+      PetscObjectState nonzerostate[2];
+
       PetscCall(MatSchurComplementGetSubMatrices(pc->mat, NULL, NULL, &B, &C, NULL));
+      M[0] = B;
+      M[1] = C;
+      for (PetscInt i = 0; i < 2; i++) {
+        PetscCall(PetscObjectGetId((PetscObject)M[i], &id[i]));
+        PetscCall(MatGetNonzeroState(M[i], &nonzerostate[i]));
+      }
+      /* the symbolic phase of the product is kept as long as B and C keep their nonzero patterns */
+      if (id[0] != lsc->id[0] || id[1] != lsc->id[1] || nonzerostate[0] != lsc->nonzerostate[0] || nonzerostate[1] != lsc->nonzerostate[1]) {
+        PetscCall(MatDestroy(&lsc->CAdiaginv));
+        PetscCall(MatDestroy(&lsc->L));
+        PetscCall(PetscArraycpy(lsc->id, id, 2));
+        PetscCall(PetscArraycpy(lsc->nonzerostate, nonzerostate, 2));
+      }
       if (lsc->scale) {
-        Mat CAdiaginv;
-        PetscCall(MatDuplicate(C, MAT_COPY_VALUES, &CAdiaginv));
-        PetscCall(MatDiagonalScale(CAdiaginv, NULL, lsc->scale));
-        if (!lsc->L) PetscCall(MatMatMult(CAdiaginv, B, MAT_INITIAL_MATRIX, PETSC_CURRENT, &lsc->L));
-        else PetscCall(MatMatMult(CAdiaginv, B, MAT_REUSE_MATRIX, PETSC_CURRENT, &lsc->L));
-        PetscCall(MatDestroy(&CAdiaginv));
+        if (!lsc->CAdiaginv) PetscCall(MatDuplicate(C, MAT_COPY_VALUES, &lsc->CAdiaginv));
+        else PetscCall(MatCopy(C, lsc->CAdiaginv, SAME_NONZERO_PATTERN));
+        PetscCall(MatDiagonalScale(lsc->CAdiaginv, NULL, lsc->scale));
+        PetscCall(MatMatMult(lsc->CAdiaginv, B, lsc->L ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX, PETSC_CURRENT, &lsc->L));
       } else {
         if (!lsc->L) {
           PetscCall(MatProductCreate(C, B, NULL, &lsc->L));
@@ -145,6 +161,7 @@ static PetscErrorCode PCReset_LSC(PC pc)
   PetscCall(KSPDestroy(&lsc->kspL));
   if (lsc->commute) PetscCall(KSPDestroy(&lsc->kspMass));
   PetscCall(MatDestroy(&lsc->L));
+  PetscCall(MatDestroy(&lsc->CAdiaginv));
   PetscCall(VecDestroy(&lsc->scale));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
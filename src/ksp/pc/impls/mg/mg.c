@@ -217,6 +217,8 @@ PetscErrorCode PCReset_MG(PC pc)
       PetscCall(MatDestroy(&mglevels[i + 1]->interpolate));
       PetscCall(MatDestroy(&mglevels[i + 1]->inject));
       PetscCall(VecDestroy(&mglevels[i + 1]->rscale));
+      PetscCall(VecDestroy(&mglevels[i + 1]->dinv));
+      PetscCall(VecDestroy(&mglevels[i + 1]->w));
     }
     PetscCall(VecDestroy(&mglevels[n - 1]->crx));
     PetscCall(VecDestroy(&mglevels[n - 1]->crb));
@@ -629,6 +631,8 @@ static PetscErrorCode PCApply_MG_Internal(PC pc, Vec b, Vec x, Mat B, Mat X, Pet
     for (i = 0; i < mg->cyclesperpcapply; i++) PetscCall(PCMGMCycle_Private(pc, mglevels + levels - 1, transpose, matapp, NULL));
   } else if (mg->am == PC_MG_ADDITIVE) {
     PetscCall(PCMGACycle_Private(pc, mglevels, transpose, matapp));
+  } else if (mg->am == PC_MG_MULTADDITIVE) {
+    PetscCall(PCMGMACycle_Private(pc, mglevels, transpose, matapp));
   } else if (mg->am == PC_MG_KASKADE) {
     PetscCall(PCMGKCycle_Private(pc, mglevels, transpose, matapp));
   } else {
@@ -754,7 +758,7 @@ PetscErrorCode PCSetFromOptions_MG(PC pc, PetscOptionItems PetscOptionsObject)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-const char *const PCMGTypes[]            = {"MULTIPLICATIVE", "ADDITIVE", "FULL", "KASKADE", "PCMGType", "PC_MG", NULL};
+const char *const PCMGTypes[]            = {"MULTIPLICATIVE", "ADDITIVE", "FULL", "KASKADE", "MULTADDITIVE", "PCMGType", "PC_MG", NULL};
 const char *const PCMGCycleTypes[]       = {"invalid", "v", "w", "PCMGCycleType", "PC_MG_CYCLE", NULL};
 const char *const PCMGGalerkinTypes[]    = {"both", "pmat", "mat", "none", "external", "PCMGGalerkinType", "PC_MG_GALERKIN", NULL};
 const char *const PCMGCoarseSpaceTypes[] = {"none", "polynomial", "harmonic", "eigenvector", "generalized_eigenvector", "gdsw", "PCMGCoarseSpaceType", "PCMG_ADAPT_NONE", NULL};
@@ -1211,6 +1215,8 @@ PetscErrorCode PCSetUp_MG(PC pc)
       PetscCall(KSPGetOperators(mglevels[i]->smoothd, &mat, NULL));
       PetscCall(PCMGSetResidualTranspose(pc, i, PCMGResidualTransposeDefault, mat));
     }
+    /* the smoothed interpolation of PC_MG_MULTADDITIVE is recomputed with the new values of the operator */
+    PetscCall(VecDestroy(&mglevels[i]->dinv));
   }
   for (PetscInt i = 1; i < n; i++) {
     if (mglevels[i]->smoothu && mglevels[i]->smoothu != mglevels[i]->smoothd) {
@@ -1369,15 +1375,15 @@ PetscErrorCode PCMGGetGridComplexity(PC pc, PetscReal *gc, PetscReal *oc)
 
   Input Parameters:
 + pc   - the preconditioner context
-- form - multigrid form, one of `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`
+- form - multigrid form, one of `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`, `PC_MG_MULTADDITIVE`
 
   Options Database Key:
-. -pc_mg_type (multiplicative|additive|full|kaskade) - Sets the type
+. -pc_mg_type (multiplicative|additive|full|kaskade|multadditive) - Sets the type
 
   Level: advanced
 
 .seealso: [](ch_ksp), `PCMGType`, `PCMG`, `PCMGGetLevels()`, `PCMGSetLevels()`, `PCMGGetType()`, `PCMGCycleType`,
-          `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`
+          `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`, `PC_MG_MULTADDITIVE`
 @*/
 PetscErrorCode PCMGSetType(PC pc, PCMGType form)
 {
@@ -1401,12 +1407,12 @@ PetscErrorCode PCMGSetType(PC pc, PCMGType form)
 . pc - the preconditioner context
 
   Output Parameter:
-. type - one of `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`, `PCMGCycleType`
+. type - one of `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`, `PC_MG_MULTADDITIVE`, `PCMGCycleType`
 
   Level: advanced
 
 .seealso: [](ch_ksp), `PCMGType`, `PCMG`, `PCMGGetLevels()`, `PCMGSetLevels()`, `PCMGSetType()`,
-          `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`
+          `PC_MG_MULTIPLICATIVE`, `PC_MG_ADDITIVE`, `PC_MG_FULL`, `PC_MG_KASKADE`, `PC_MG_MULTADDITIVE`
 @*/
 PetscErrorCode PCMGGetType(PC pc, PCMGType *type)
 {
@@ -1968,7 +1974,7 @@ PetscErrorCode PCMGGetCoarseSpaceConstructor(const char name[], PCMGCoarseSpaceC
    Options Database Keys:
 +  -pc_mg_levels nlevels                              - number of levels including finest
 .  -pc_mg_cycle_type (v|w)                            - provide the cycle desired
-.  -pc_mg_type (additive|multiplicative|full|kaskade) - multiplicative is the default
+.  -pc_mg_type (additive|multiplicative|full|kaskade|multadditive) - multiplicative is the default
 .  -pc_mg_log                                         - log information about time spent on each level of the solver
 .  -pc_mg_distinct_smoothup                           - configure up (after interpolation) and down (before restriction) smoothers separately (with different options prefixes)
 .  -pc_mg_galerkin (both|pmat|mat|none)               - use the Galerkin process to compute coarser operators, i.e., $A_{coarse} = R A_{fine} R^T$
@@ -55,3 +55,69 @@ PetscErrorCode PCMGACycle_Private(PC pc, PC_MG_Levels **mglevels, PetscBool tran
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+/*
+     Mult-additive multigrid: the additive cycle with the smoothed interpolations (I - D^{-1} A) P, D the l1 row sums of A.
+   The right-hand sides are computed with their transposes and the levels are smoothed independently, so like the additive
+   cycle no level waits for the correction of another one, but the coarse corrections are smoothed as in a V-cycle
+*/
+PetscErrorCode PCMGMACycle_Private(PC pc, PC_MG_Levels **mglevels, PetscBool transpose, PetscBool matapp)
+{
+  PetscInt i, l = mglevels[0]->levels;
+
+  PetscFunctionBegin;
+  PetscCheck(!matapp, PetscObjectComm((PetscObject)pc), PETSC_ERR_SUP, "Not supported");
+  /* compute RHS on each level, the solution vectors are used as work vectors */
+  for (i = l - 1; i > 0; i--) {
+    if (!mglevels[i]->dinv) {
+      PetscCall(MatCreateVecs(mglevels[i]->A, NULL, &mglevels[i]->dinv));
+      PetscCall(MatGetRowSumAbs(mglevels[i]->A, mglevels[i]->dinv));
+      PetscCall(VecReciprocal(mglevels[i]->dinv));
+    }
+    if (mglevels[i]->eventresidual) PetscCall(PetscLogEventBegin(mglevels[i]->eventresidual, 0, 0, 0, 0));
+    PetscCall(VecPointwiseMult(mglevels[i]->x, mglevels[i]->dinv, mglevels[i]->b));
+    if (!transpose) PetscCall((*mglevels[i]->residual)(mglevels[i]->A, mglevels[i]->b, mglevels[i]->x, mglevels[i]->r));
+    else PetscCall((*mglevels[i]->residualtranspose)(mglevels[i]->A, mglevels[i]->b, mglevels[i]->x, mglevels[i]->r));
+    if (mglevels[i]->eventresidual) PetscCall(PetscLogEventEnd(mglevels[i]->eventresidual, 0, 0, 0, 0));
+    if (mglevels[i]->eventinterprestrict) PetscCall(PetscLogEventBegin(mglevels[i]->eventinterprestrict, 0, 0, 0, 0));
+    if (!transpose) PetscCall(MatRestrict(mglevels[i]->restrct, mglevels[i]->r, mglevels[i - 1]->b));
+    else PetscCall(MatRestrict(mglevels[i]->interpolate, mglevels[i]->r, mglevels[i - 1]->b));
+    if (mglevels[i]->eventinterprestrict) PetscCall(PetscLogEventEnd(mglevels[i]->eventinterprestrict, 0, 0, 0, 0));
+  }
+  /* solve separately on each level, the smoothed solutions of the finer levels are stored in r until they are added to the
+     interpolated corrections of the coarser levels */
+  for (i = 0; i < l; i++) {
+    Vec y = i ? mglevels[i]->r : mglevels[i]->x;
+
+    PetscCall(VecZeroEntries(y));
+    if (mglevels[i]->eventsmoothsolve) PetscCall(PetscLogEventBegin(mglevels[i]->eventsmoothsolve, 0, 0, 0, 0));
+    if (!transpose) {
+      PetscCall(KSPSolve(mglevels[i]->smoothd, mglevels[i]->b, y));
+      PetscCall(KSPCheckSolve(mglevels[i]->smoothd, pc, y));
+    } else {
+      PetscCall(KSPSolveTranspose(mglevels[i]->smoothu, mglevels[i]->b, y));
+      PetscCall(KSPCheckSolve(mglevels[i]->smoothu, pc, y));
+    }
+    if (mglevels[i]->eventsmoothsolve) PetscCall(PetscLogEventEnd(mglevels[i]->eventsmoothsolve, 0, 0, 0, 0));
+  }
+  /* x_i = y_i + (I - D^{-1} A) P x_{i-1}, the right-hand sides are no longer needed below the finest level and hold A P x_{i-1} */
+  for (i = 1; i < l; i++) {
+    Vec w = mglevels[i]->b;
+
+    if (i == l - 1) {
+      if (!mglevels[i]->w) PetscCall(VecDuplicate(mglevels[i]->x, &mglevels[i]->w));
+      w = mglevels[i]->w;
+    }
+    if (mglevels[i]->eventinterprestrict) PetscCall(PetscLogEventBegin(mglevels[i]->eventinterprestrict, 0, 0, 0, 0));
+    if (!transpose) PetscCall(MatInterpolate(mglevels[i]->interpolate, mglevels[i - 1]->x, mglevels[i]->x));
+    else PetscCall(MatInterpolate(mglevels[i]->restrct, mglevels[i - 1]->x, mglevels[i]->x));
+    if (mglevels[i]->eventinterprestrict) PetscCall(PetscLogEventEnd(mglevels[i]->eventinterprestrict, 0, 0, 0, 0));
+    if (mglevels[i]->eventresidual) PetscCall(PetscLogEventBegin(mglevels[i]->eventresidual, 0, 0, 0, 0));
+    if (!transpose) PetscCall(MatMult(mglevels[i]->A, mglevels[i]->x, w));
+    else PetscCall(MatMultTranspose(mglevels[i]->A, mglevels[i]->x, w));
+    PetscCall(VecPointwiseMult(w, mglevels[i]->dinv, w));
+    PetscCall(VecAXPBYPCZ(mglevels[i]->x, -1.0, 1.0, 1.0, w, mglevels[i]->r));
+    if (mglevels[i]->eventresidual) PetscCall(PetscLogEventEnd(mglevels[i]->eventresidual, 0, 0, 0, 0));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
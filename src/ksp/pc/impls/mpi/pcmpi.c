@@ -22,11 +22,13 @@
 #define PC_MPI_COMM_WORLD MPI_COMM_WORLD
 
 typedef struct {
-  KSP       ksps[PC_MPI_MAX_RANKS];                               /* The addresses of the MPI parallel KSP on each process, NULL when not on a process. */
-  PetscInt  sendcount[PC_MPI_MAX_RANKS], displ[PC_MPI_MAX_RANKS]; /* For scatter/gather of rhs/solution */
-  PetscInt  NZ[PC_MPI_MAX_RANKS], NZdispl[PC_MPI_MAX_RANKS];      /* For scatter of nonzero values in matrix (and nonzero column indices initially */
-  PetscInt  mincntperrank;                                        /* minimum number of desired matrix rows per active rank in MPI parallel KSP solve */
-  PetscBool alwaysuseserver;                                      /* for debugging use the server infrastructure even if only one MPI process is used for the solve */
+  KSP          ksps[PC_MPI_MAX_RANKS];                               /* The addresses of the MPI parallel KSP on each process, NULL when not on a process. */
+  PetscInt     sendcount[PC_MPI_MAX_RANKS], displ[PC_MPI_MAX_RANKS]; /* For scatter/gather of rhs/solution */
+  PetscInt     NZ[PC_MPI_MAX_RANKS], NZdispl[PC_MPI_MAX_RANKS];      /* For scatter of nonzero values in matrix (and nonzero column indices initially */
+  PetscInt     mincntperrank;                                        /* minimum number of desired matrix rows per active rank in MPI parallel KSP solve */
+  PetscBool    alwaysuseserver;                                      /* for debugging use the server infrastructure even if only one MPI process is used for the solve */
+  PetscScalar *matb, *matx;                                          /* right-hand sides and solutions of PCMatApply() packed by rank, in shared memory when it is used */
+  PetscInt     matn;                                                 /* allocated length of matb and matx */
 } PC_MPI;
 
 typedef enum {
@@ -35,6 +37,7 @@ typedef enum {
   PCMPI_SET_MAT,           /* set original matrix (or one with different nonzero pattern) */
   PCMPI_UPDATE_MAT_VALUES, /* update current matrix with new nonzero values */
   PCMPI_SOLVE,
+  PCMPI_MAT_SOLVE, /* solve with several right-hand sides in a single request */
   PCMPI_VIEW,
   PCMPI_DESTROY /* destroy a PC that is no longer needed */
 } PCMPICommand;
@@ -294,7 +297,7 @@ static PetscErrorCode PCMPISetMat(PC pc)
   PetscCall(KSPSetOperators(ksp, A, A));
   if (!ksp->vec_sol) PetscCall(MatCreateVecs(A, &ksp->vec_sol, &ksp->vec_rhs));
   PetscCall(PetscLogStagePop());
-  if (pc && !PCMPIServerUseShmget) { /* needed for scatterv/gatherv of rhs and solution */
+  if (pc) { /* needed for scatterv/gatherv of rhs and solution, and to pack those of PCMatApply() */
     const PetscInt *range;
 
     PetscCall(VecGetOwnershipRanges(ksp->vec_sol, &range));
@@ -463,6 +466,116 @@ static PetscErrorCode PCMPISolve(PC pc, Vec B, Vec X)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   The columns of B and X are packed by rank in km->matb and km->matx, the rows of MPI process r of all the columns being
+   contiguous, so that each process receives or maps its part of all the right-hand sides at once and uses it directly as
+   the array of its local dense matrix
+*/
+static PetscErrorCode PCMPIMatSolve(PC pc, Mat B, Mat X)
+{
+  PC_MPI            *km = pc ? (PC_MPI *)pc->data : NULL;
+  KSP                ksp;
+  MPI_Comm           comm = PC_MPI_COMM_WORLD;
+  Mat                pB, pX;
+  Vec                rhs, sol;
+  const PetscScalar *sb, *x;
+  PetscScalar       *b, *sx;
+  PetscInt           its, n, N, rstart, nrhs = 0, ld, *sendcount = NULL, *displ = NULL;
+  PetscMPIInt        size;
+  void              *addr[2];
+
+  PetscFunctionBegin;
+  PetscCallMPI(MPI_Scatter(pc ? km->ksps : &ksp, 1, MPI_AINT, &ksp, 1, MPI_AINT, 0, comm));
+  if (!ksp) PetscFunctionReturn(PETSC_SUCCESS);
+  PCMPIServerInSolve = PETSC_TRUE;
+  PetscCall(PetscLogEventBegin(EventServerDist, NULL, NULL, NULL, NULL));
+  PetscCall(PetscObjectGetComm((PetscObject)ksp, &comm));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  if (pc) PetscCall(MatGetSize(B, NULL, &nrhs));
+  PetscCallMPI(MPI_Bcast(&nrhs, 1, MPIU_INT, 0, comm));
+  PetscCall(VecGetLocalSize(ksp->vec_rhs, &n));
+  PetscCall(VecGetSize(ksp->vec_rhs, &N));
+  PetscCall(VecGetOwnershipRange(ksp->vec_rhs, &rstart, NULL));
+  if (pc) {
+    PCMPISolveCounts[size - 1] += nrhs;
+    PCMPISizes[size - 1] += N * nrhs;
+
+    /* pack the right-hand sides */
+    PetscCall(MatDenseGetArrayRead(B, &sb));
+    PetscCall(MatDenseGetLDA(B, &ld));
+    for (PetscMPIInt i = 0; i < size; i++) {
+      for (PetscInt j = 0; j < nrhs; j++) PetscCall(PetscArraycpy(km->matb + km->displ[i] * nrhs + j * km->sendcount[i], sb + j * ld + km->displ[i], km->sendcount[i]));
+    }
+    PetscCall(MatDenseRestoreArrayRead(B, &sb));
+  }
+
+  /* scatterv rhs */
+  PetscCall(PetscLogEventBegin(EventServerDistMPI, NULL, NULL, NULL, NULL));
+  if (!PCMPIServerUseShmget) {
+    if (pc) {
+      PetscCall(PetscMalloc2(size, &sendcount, size, &displ));
+      for (PetscMPIInt i = 0; i < size; i++) {
+        sendcount[i] = km->sendcount[i] * nrhs;
+        displ[i]     = km->displ[i] * nrhs;
+      }
+    }
+    PetscCall(MatCreateDense(comm, n, PETSC_DECIDE, N, nrhs, NULL, &pB));
+    PetscCall(MatCreateDense(comm, n, PETSC_DECIDE, N, nrhs, NULL, &pX));
+    PetscCall(MatDenseGetArrayWrite(pB, &b));
+    PetscCallMPI(MPIU_Scatterv(pc ? km->matb : NULL, sendcount, displ, MPIU_SCALAR, b, n * nrhs, MPIU_SCALAR, 0, comm));
+    PetscCall(MatDenseRestoreArrayWrite(pB, &b));
+  } else {
+    const void *inaddr[2] = {pc ? (const void *)km->matb : NULL, pc ? (const void *)km->matx : NULL};
+
+    PetscCall(PetscShmgetMapAddresses(comm, 2, inaddr, addr));
+    PetscCall(MatCreateDense(comm, n, PETSC_DECIDE, N, nrhs, rstart * nrhs + (PetscScalar *)addr[0], &pB));
+    PetscCall(MatCreateDense(comm, n, PETSC_DECIDE, N, nrhs, rstart * nrhs + (PetscScalar *)addr[1], &pX));
+  }
+  PetscCall(PetscLogEventEnd(EventServerDistMPI, NULL, NULL, NULL, NULL));
+
+  PetscCall(PetscLogEventEnd(EventServerDist, NULL, NULL, NULL, NULL));
+  /* a KSPMatSolve() column by column replaces the vectors of the KSP, which PCMPISolve() needs */
+  rhs = ksp->vec_rhs;
+  sol = ksp->vec_sol;
+  PetscCall(PetscObjectReference((PetscObject)rhs));
+  PetscCall(PetscObjectReference((PetscObject)sol));
+  PetscCall(PetscLogStagePush(PCMPIStage));
+  PetscCall(KSPMatSolve(ksp, pB, pX));
+  PetscCall(PetscLogStagePop());
+  PetscCall(VecDestroy(&ksp->vec_rhs));
+  PetscCall(VecDestroy(&ksp->vec_sol));
+  ksp->vec_rhs = rhs;
+  ksp->vec_sol = sol;
+  PetscCall(PetscLogEventBegin(EventServerDist, NULL, NULL, NULL, NULL));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  PCMPIIterations[size - 1] += its * nrhs;
+
+  /* gather solution */
+  PetscCall(PetscLogEventBegin(EventServerDistMPI, NULL, NULL, NULL, NULL));
+  if (!PCMPIServerUseShmget) {
+    PetscCall(MatDenseGetArrayRead(pX, &x));
+    PetscCallMPI(MPIU_Gatherv(x, n * nrhs, MPIU_SCALAR, pc ? km->matx : NULL, sendcount, displ, MPIU_SCALAR, 0, comm));
+    PetscCall(MatDenseRestoreArrayRead(pX, &x));
+    PetscCall(PetscFree2(sendcount, displ));
+  } else PetscCallMPI(MPI_Barrier(comm));
+  PetscCall(MatDestroy(&pB));
+  PetscCall(MatDestroy(&pX));
+  if (PCMPIServerUseShmget) PetscCall(PetscShmgetUnmapAddresses(2, addr));
+  PetscCall(PetscLogEventEnd(EventServerDistMPI, NULL, NULL, NULL, NULL));
+  if (pc) {
+    /* unpack the solutions */
+    PetscCall(MatDenseGetArrayWrite(X, &sx));
+    PetscCall(MatDenseGetLDA(X, &ld));
+    for (PetscMPIInt i = 0; i < size; i++) {
+      for (PetscInt j = 0; j < nrhs; j++) PetscCall(PetscArraycpy(sx + j * ld + km->displ[i], km->matx + km->displ[i] * nrhs + j * km->sendcount[i], km->sendcount[i]));
+    }
+    PetscCall(MatDenseRestoreArrayWrite(X, &sx));
+  }
+  PetscCall(PetscLogEventEnd(EventServerDist, NULL, NULL, NULL, NULL));
+  PCMPIServerInSolve = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PCMPIDestroy(PC pc)
 {
   PC_MPI  *km = pc ? (PC_MPI *)pc->data : NULL;
@@ -637,6 +750,9 @@ PetscErrorCode PCMPIServerBegin(void)
     case PCMPI_SOLVE:
       PetscCall(PCMPISolve(NULL, NULL, NULL));
       break;
+    case PCMPI_MAT_SOLVE:
+      PetscCall(PCMPIMatSolve(NULL, NULL, NULL));
+      break;
     case PCMPI_DESTROY:
       PetscCall(PCMPIDestroy(NULL));
       break;
@@ -771,6 +887,23 @@ static PetscErrorCode PCApply_Seq(PC pc, Vec b, Vec x)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode PCMatApply_Seq(PC pc, Mat B, Mat X)
+{
+  PC_MPI  *km = (PC_MPI *)pc->data;
+  PetscInt its, n, nrhs;
+
+  PetscFunctionBegin;
+  PCMPIServerInSolve = PETSC_TRUE;
+  PetscCall(KSPMatSolve(km->ksps[0], B, X));
+  PetscCall(KSPGetIterationNumber(km->ksps[0], &its));
+  PetscCall(MatGetSize(B, &n, &nrhs));
+  PCMPISolveCountsSeq += nrhs;
+  PCMPIIterationsSeq += its * nrhs;
+  PCMPISizesSeq += n * nrhs;
+  PCMPIServerInSolve = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PCView_Seq(PC pc, PetscViewer viewer)
 {
   PC_MPI *km = (PC_MPI *)pc->data;
@@ -831,10 +964,11 @@ static PetscErrorCode PCSetUp_MPI(PC pc)
       PetscCall(PCGetOperators(pc, &sA, &sA));
       PetscCall(MatGetSize(sA, &n, NULL));
       if (n < 2 * km->mincntperrank - 1 || size == 1) {
-        pc->ops->setup   = NULL;
-        pc->ops->apply   = PCApply_Seq;
-        pc->ops->destroy = PCDestroy_Seq;
-        pc->ops->view    = PCView_Seq;
+        pc->ops->setup    = NULL;
+        pc->ops->apply    = PCApply_Seq;
+        pc->ops->matapply = PCMatApply_Seq;
+        pc->ops->destroy  = PCDestroy_Seq;
+        pc->ops->view     = PCView_Seq;
         PetscCall(PCSetUp_Seq(pc));
         PetscFunctionReturn(PETSC_SUCCESS);
       }
@@ -866,11 +1000,37 @@ static PetscErrorCode PCApply_MPI(PC pc, Vec b, Vec x)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+     PCMatApply_MPI - Sends all the right-hand sides to the MPI parallel KSP in a single request, the solves are done with KSPMatSolve()
+*/
+static PetscErrorCode PCMatApply_MPI(PC pc, Mat B, Mat X)
+{
+  PC_MPI  *km = (PC_MPI *)pc->data;
+  PetscInt N, nrhs;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(B, &N, &nrhs));
+  if (N * nrhs > km->matn) {
+    PetscCall(PetscShmgetDeallocateArray((void **)&km->matb));
+    PetscCall(PetscShmgetDeallocateArray((void **)&km->matx));
+    PetscCall(PetscShmgetAllocateArray(N * nrhs, sizeof(PetscScalar), (void **)&km->matb));
+    PetscCall(PetscShmgetAllocateArray(N * nrhs, sizeof(PetscScalar), (void **)&km->matx));
+    km->matn = N * nrhs;
+  }
+  PetscCall(PCMPIServerBroadcastRequest(PCMPI_MAT_SOLVE));
+  PetscCall(PCMPIMatSolve(pc, B, X));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PCDestroy_MPI(PC pc)
 {
+  PC_MPI *km = (PC_MPI *)pc->data;
+
   PetscFunctionBegin;
   PetscCall(PCMPIServerBroadcastRequest(PCMPI_DESTROY));
   PetscCall(PCMPIDestroy(pc));
+  PetscCall(PetscShmgetDeallocateArray((void **)&km->matb));
+  PetscCall(PetscShmgetDeallocateArray((void **)&km->matx));
   PetscCall(PetscFree(pc->data));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -927,6 +1087,9 @@ static PetscErrorCode PCSetFromOptions_MPI(PC pc, PetscOptionItems PetscOptionsO
 
    It can be particularly useful for user OpenMP code or potentially user GPU code.
 
+   `KSPMatSolve()` sends all the right-hand sides to the MPI parallel `KSP` in a single request and solves with `KSPMatSolve()` on the server,
+   thus a sequence of small solves with the same matrix is better done with one `KSPMatSolve()` than with several `KSPSolve()`.
+
    When the program is running with a single MPI process then it directly uses the provided matrix and right-hand side
    and does not need to distribute the matrix and vector to the various MPI processes; thus it incurs no extra overhead over just using the `KSP` directly.
 
@@ -969,6 +1132,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_MPI(PC pc)
 
   pc->ops->setup          = PCSetUp_MPI;
   pc->ops->apply          = PCApply_MPI;
+  pc->ops->matapply       = PCMatApply_MPI;
   pc->ops->destroy        = PCDestroy_MPI;
   pc->ops->view           = PCView_MPI;
   pc->ops->setfromoptions = PCSetFromOptions_MPI;
@@ -452,6 +452,114 @@ PetscErrorCode PCPatchGetPartitionOfUnity(PC pc, PetscBool *flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PCPatchSetDenseBatch - Set whether the dense patch matrices are factored and applied in packs of patches with the same number of dofs
+
+  Logically Collective
+
+  Input Parameters:
++ pc  - the `PCPATCH` preconditioner
+- flg - `PETSC_TRUE` to interleave the patches of a pack and factor and solve them together, `PETSC_FALSE` to invert each patch matrix separately
+
+  Options Database Key:
+. -pc_patch_dense_batch <bool> - factor and apply the patches in packs
+
+  Level: intermediate
+
+  Notes:
+  This implies `-pc_patch_dense_inverse`, the patch matrices must be `MATDENSE` and saved (see `PCPatchSetSaveOperators()`). The patches are sorted by
+  number of dofs and grouped in packs of 8 whose LU factorizations with partial pivoting and triangular solves are computed with
+  the innermost loops over the patches of the pack. With an additive local composition, all the patches of a pack are solved at once in `PCApply()`.
+
+.seealso: [](ch_ksp), `PCPATCH`, `PCPatchGetDenseBatch()`, `PCPatchSetDenseReuse()`, `PCPatchSetSaveOperators()`
+@*/
+PetscErrorCode PCPatchSetDenseBatch(PC pc, PetscBool flg)
+{
+  PC_PATCH *patch = (PC_PATCH *)pc->data;
+
+  PetscFunctionBegin;
+  patch->densebatch = flg;
+  if (flg) patch->denseinverse = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCPatchGetDenseBatch - Get whether the dense patch matrices are factored and applied in packs of patches with the same number of dofs
+
+  Not Collective
+
+  Input Parameter:
+. pc - the `PCPATCH` preconditioner
+
+  Output Parameter:
+. flg - `PETSC_TRUE` if the patches are factored and solved in packs
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `PCPATCH`, `PCPatchSetDenseBatch()`
+@*/
+PetscErrorCode PCPatchGetDenseBatch(PC pc, PetscBool *flg)
+{
+  PC_PATCH *patch = (PC_PATCH *)pc->data;
+
+  PetscFunctionBegin;
+  *flg = patch->densebatch;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCPatchSetDenseReuse - Set whether the factorization of a pack of patches is kept when its patch matrices did not change since the previous `PCSetUp()`
+
+  Logically Collective
+
+  Input Parameters:
++ pc  - the `PCPATCH` preconditioner
+- flg - `PETSC_TRUE` to compare the patch matrices with those that were factored and skip the unchanged packs
+
+  Options Database Key:
+. -pc_patch_dense_reuse <bool> - keep the factorizations of the unchanged packs
+
+  Level: intermediate
+
+  Note:
+  Only used with `PCPatchSetDenseBatch()`. The patch matrices are still assembled in every `PCSetUp()`, and a copy of the factored ones is kept,
+  so this pays off when the factorizations dominate, for instance when the operator changes only in a part of the domain.
+
+.seealso: [](ch_ksp), `PCPATCH`, `PCPatchGetDenseReuse()`, `PCPatchSetDenseBatch()`
+@*/
+PetscErrorCode PCPatchSetDenseReuse(PC pc, PetscBool flg)
+{
+  PC_PATCH *patch = (PC_PATCH *)pc->data;
+
+  PetscFunctionBegin;
+  patch->densereuse = flg;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PCPatchGetDenseReuse - Get whether the factorization of a pack of patches is kept when its patch matrices did not change since the previous `PCSetUp()`
+
+  Not Collective
+
+  Input Parameter:
+. pc - the `PCPATCH` preconditioner
+
+  Output Parameter:
+. flg - `PETSC_TRUE` if the factorizations of the unchanged packs are kept
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `PCPATCH`, `PCPatchSetDenseReuse()`, `PCPatchSetDenseBatch()`
+@*/
+PetscErrorCode PCPatchGetDenseReuse(PC pc, PetscBool *flg)
+{
+  PC_PATCH *patch = (PC_PATCH *)pc->data;
+
+  PetscFunctionBegin;
+  *flg = patch->densereuse;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /* TODO: Docs */
 static PetscErrorCode PCPatchSetLocalComposition(PC pc, PCCompositeType type)
 {
@@ -2553,7 +2661,7 @@ PetscErrorCode PCPatchComputeOperator_Internal(PC pc, Vec x, Mat mat, PetscInt p
   PetscCall(MatAssemblyBegin(mat, MAT_FINAL_ASSEMBLY));
   PetscCall(MatAssemblyEnd(mat, MAT_FINAL_ASSEMBLY));
 
-  if (!(withArtificial || isNonlinear) && patch->denseinverse) {
+  if (!(withArtificial || isNonlinear) && patch->denseinverse && !patch->densebatch) {
     MatFactorInfo info;
     PetscBool     flg;
     PetscCall(PetscObjectTypeCompare((PetscObject)mat, MATSEQDENSE, &flg));
@@ -2791,6 +2899,230 @@ PetscErrorCode PCPatch_ScatterLocal_Private(PC pc, PetscInt p, Vec x, Vec y, Ins
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* sorts the patches to apply by number of dofs and groups those with the same number of dofs in packs */
+static PetscErrorCode PCPatchDenseBatchCreatePacks_Private(PC pc)
+{
+  PC_PATCH       *patch        = (PC_PATCH *)pc->data;
+  const PetscInt *iterationSet = NULL;
+  PetscInt        n            = patch->npatch, pStart, nmax = 0, *dofs, *perm;
+
+  PetscFunctionBegin;
+  if (patch->user_patches) {
+    PetscCall(ISGetLocalSize(patch->iterationSet, &n));
+    PetscCall(ISGetIndices(patch->iterationSet, &iterationSet));
+  }
+  PetscCall(PetscSectionGetChart(patch->gtolCounts, &pStart, NULL));
+  PetscCall(PetscMalloc2(n, &dofs, n, &perm));
+  for (PetscInt j = 0; j < n; j++) {
+    perm[j] = patch->user_patches ? iterationSet[j] : j;
+    PetscCall(PetscSectionGetDof(patch->gtolCounts, perm[j] + pStart, &dofs[j]));
+  }
+  if (patch->user_patches) PetscCall(ISRestoreIndices(patch->iterationSet, &iterationSet));
+  PetscCall(PetscSortIntWithArray(n, dofs, perm));
+  /* keep the patches of the same size in their original order */
+  for (PetscInt j = 0, k; j < n; j = k) {
+    for (k = j + 1; k < n && dofs[k] == dofs[j]; k++);
+    PetscCall(PetscSortInt(k - j, perm + j));
+  }
+
+  patch->npack = 0;
+  for (PetscInt j = 0, cnt = 0; j < n; j++) {
+    if (dofs[j] <= 0) continue;
+    if (!cnt) patch->npack++;
+    cnt = (j + 1 < n && dofs[j + 1] == dofs[j]) ? (cnt + 1) % PETSC_KERNEL_BATCH_LANES : 0;
+  }
+  PetscCall(PetscCalloc1(patch->npack, &patch->packs));
+  PetscCall(PetscMalloc1(patch->npatch, &patch->patchToPack));
+  for (PetscInt i = 0; i < patch->npatch; i++) patch->patchToPack[i] = -1;
+  for (PetscInt j = 0, p = -1, cnt = 0; j < n; j++) {
+    PCPatchDensePack *pack;
+
+    if (dofs[j] <= 0) continue;
+    if (!cnt) {
+      pack    = &patch->packs[++p];
+      pack->n = dofs[j];
+      nmax    = PetscMax(nmax, pack->n);
+      PetscCall(PetscMalloc2(pack->n * pack->n * PETSC_KERNEL_BATCH_LANES, &pack->a, pack->n * PETSC_KERNEL_BATCH_LANES, &pack->piv));
+    } else pack = &patch->packs[p];
+    patch->patchToPack[perm[j]] = p * PETSC_KERNEL_BATCH_LANES + pack->npatch;
+    pack->patch[pack->npatch++] = perm[j];
+    cnt                         = (j + 1 < n && dofs[j + 1] == dofs[j]) ? (cnt + 1) % PETSC_KERNEL_BATCH_LANES : 0;
+  }
+  PetscCall(PetscMalloc1(nmax * nmax * PETSC_KERNEL_BATCH_LANES, &patch->packWork));
+  PetscCall(PetscFree2(dofs, perm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCPatchDenseBatchDestroyPacks_Private(PC pc)
+{
+  PC_PATCH *patch = (PC_PATCH *)pc->data;
+
+  PetscFunctionBegin;
+  for (PetscInt p = 0; p < patch->npack; p++) {
+    PetscCall(PetscFree2(patch->packs[p].a, patch->packs[p].piv));
+    PetscCall(PetscFree(patch->packs[p].mat));
+  }
+  PetscCall(PetscFree(patch->packs));
+  PetscCall(PetscFree(patch->patchToPack));
+  PetscCall(PetscFree(patch->packWork));
+  patch->npack = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* interleaves the patch matrices of a pack in a, the unused lanes hold the identity */
+static PetscErrorCode PCPatchDenseBatchGather_Private(PC pc, PCPatchDensePack *pack, PetscScalar *a)
+{
+  PC_PATCH      *patch = (PC_PATCH *)pc->data;
+  const PetscInt n     = pack->n;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArrayzero(a, n * n * PETSC_KERNEL_BATCH_LANES));
+  for (PetscInt l = 0; l < PETSC_KERNEL_BATCH_LANES; l++) {
+    Mat                mat;
+    const PetscScalar *v;
+    PetscInt           lda;
+    PetscBool          flg;
+
+    if (l >= pack->npatch) {
+      for (PetscInt i = 0; i < n; i++) a[(i + i * n) * PETSC_KERNEL_BATCH_LANES + l] = 1.0;
+      continue;
+    }
+    mat = patch->mat[pack->patch[l]];
+    PetscCall(PetscObjectTypeCompare((PetscObject)mat, MATSEQDENSE, &flg));
+    PetscCheck(flg, PetscObjectComm((PetscObject)pc), PETSC_ERR_ARG_WRONGSTATE, "Invalid Mat type for dense inverse");
+    PetscCall(MatDenseGetLDA(mat, &lda));
+    PetscCall(MatDenseGetArrayRead(mat, &v));
+    for (PetscInt j = 0; j < n; j++) {
+      for (PetscInt i = 0; i < n; i++) a[(i + j * n) * PETSC_KERNEL_BATCH_LANES + l] = v[i + j * lda];
+    }
+    PetscCall(MatDenseRestoreArrayRead(mat, &v));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* LU factorizations of the packs, with densereuse only of those whose patch matrices changed */
+static PetscErrorCode PCPatchDenseBatchFactor_Private(PC pc)
+{
+  PC_PATCH      *patch = (PC_PATCH *)pc->data;
+  PetscBool     *factor;
+  PetscInt       nfactor = 0;
+  PetscLogDouble flops   = 0.0;
+
+  PetscFunctionBegin;
+  if (!patch->packs) PetscCall(PCPatchDenseBatchCreatePacks_Private(pc));
+  PetscCall(PetscMalloc1(patch->npack, &factor));
+  for (PetscInt p = 0; p < patch->npack; p++) {
+    PCPatchDensePack *pack = &patch->packs[p];
+    const PetscInt    N    = pack->n * pack->n * PETSC_KERNEL_BATCH_LANES;
+
+    factor[p] = PETSC_TRUE;
+    if (patch->densereuse) {
+      PetscCall(PCPatchDenseBatchGather_Private(pc, pack, patch->packWork));
+      if (pack->mat) {
+        PetscCall(PetscArraycmp(patch->packWork, pack->mat, N, &factor[p]));
+        factor[p] = (PetscBool)!factor[p];
+      } else PetscCall(PetscMalloc1(N, &pack->mat));
+      if (factor[p]) {
+        PetscCall(PetscArraycpy(pack->mat, patch->packWork, N));
+        PetscCall(PetscArraycpy(pack->a, patch->packWork, N));
+      }
+    } else {
+      /* the copy would be stale if densereuse is turned on again */
+      PetscCall(PetscFree(pack->mat));
+      PetscCall(PCPatchDenseBatchGather_Private(pc, pack, pack->a));
+    }
+    if (factor[p]) {
+      nfactor++;
+      flops += PETSC_KERNEL_BATCH_LANES * (2.0 * pack->n * pack->n * pack->n) / 3.0;
+    }
+  }
+  PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+  for (PetscInt p = 0; p < patch->npack; p++) {
+    if (factor[p]) PetscKernel_BatchLUFactor(patch->packs[p].n, patch->packs[p].a, patch->packs[p].piv, patch->packs[p].zeropivot);
+  }
+  PetscCall(PetscLogFlops(flops));
+  for (PetscInt p = 0; p < patch->npack; p++) {
+    for (PetscInt l = 0; l < patch->packs[p].npatch; l++) PetscCheck(!patch->packs[p].zeropivot[l], PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot in the LU factorization of patch %" PetscInt_FMT, patch->packs[p].patch[l]);
+  }
+  PetscCall(PetscInfo(pc, "Factored %" PetscInt_FMT " of %" PetscInt_FMT " packs of patches\n", nfactor, patch->npack));
+  PetscCall(PetscFree(factor));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* solves all the patches of all the packs with the additive local composition, adding the patch updates to patch->localUpdate */
+static PetscErrorCode PCPatchDenseBatchApply_Private(PC pc)
+{
+  PC_PATCH          *patch = (PC_PATCH *)pc->data;
+  PetscScalar       *x     = patch->packWork, *localUpdate;
+  const PetscScalar *localRHS;
+  const PetscInt    *gtol;
+  PetscInt           pStart;
+  PetscLogDouble     flops = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSectionGetChart(patch->gtolCounts, &pStart, NULL));
+  PetscCall(VecGetArrayRead(patch->localRHS, &localRHS));
+  PetscCall(VecGetArray(patch->localUpdate, &localUpdate));
+  PetscCall(ISGetIndices(patch->gtol, &gtol));
+  for (PetscInt p = 0; p < patch->npack; p++) {
+    PCPatchDensePack *pack = &patch->packs[p];
+    const PetscInt    n    = pack->n;
+    PetscInt          offset[PETSC_KERNEL_BATCH_LANES];
+
+    PetscCall(PetscArrayzero(x, n * PETSC_KERNEL_BATCH_LANES));
+    for (PetscInt l = 0; l < pack->npatch; l++) {
+      PetscCall(PetscSectionGetOffset(patch->gtolCounts, pack->patch[l] + pStart, &offset[l]));
+      for (PetscInt i = 0; i < n; i++) x[i * PETSC_KERNEL_BATCH_LANES + l] = localRHS[gtol[offset[l] + i]];
+    }
+    PetscKernel_BatchLUSolve(n, pack->a, pack->piv, x);
+    for (PetscInt l = 0; l < pack->npatch; l++) {
+      for (PetscInt i = 0; i < n; i++) localUpdate[gtol[offset[l] + i]] += x[i * PETSC_KERNEL_BATCH_LANES + l];
+    }
+    flops += PETSC_KERNEL_BATCH_LANES * 2.0 * n * n;
+  }
+  PetscCall(ISRestoreIndices(patch->gtol, &gtol));
+  PetscCall(VecRestoreArray(patch->localUpdate, &localUpdate));
+  PetscCall(VecRestoreArrayRead(patch->localRHS, &localRHS));
+  PetscCall(PetscLogFlops(flops));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* solves the single patch i with the factors of its pack */
+static PetscErrorCode PCPatchDenseBatchSolve_Private(PC pc, PetscInt i, Vec x, Vec y)
+{
+  PC_PATCH          *patch = (PC_PATCH *)pc->data;
+  PCPatchDensePack  *pack  = &patch->packs[patch->patchToPack[i] / PETSC_KERNEL_BATCH_LANES];
+  const PetscInt     l = patch->patchToPack[i] % PETSC_KERNEL_BATCH_LANES, n = pack->n;
+  const PetscScalar *a = pack->a, *xx;
+  PetscScalar       *yy;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(x, &xx));
+  PetscCall(VecGetArray(y, &yy));
+  PetscCall(PetscArraycpy(yy, xx, n));
+  for (PetscInt k = 0; k < n; k++) {
+    PetscInt p = pack->piv[k * PETSC_KERNEL_BATCH_LANES + l];
+
+    if (p != k) {
+      PetscScalar t = yy[k];
+
+      yy[k] = yy[p];
+      yy[p] = t;
+    }
+  }
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt k = j + 1; k < n; k++) yy[k] -= a[(k + j * n) * PETSC_KERNEL_BATCH_LANES + l] * yy[j];
+  }
+  for (PetscInt j = n - 1; j >= 0; j--) {
+    yy[j] /= a[(j + j * n) * PETSC_KERNEL_BATCH_LANES + l];
+    for (PetscInt k = 0; k < j; k++) yy[k] -= a[(k + j * n) * PETSC_KERNEL_BATCH_LANES + l] * yy[j];
+  }
+  PetscCall(VecRestoreArray(y, &yy));
+  PetscCall(VecRestoreArrayRead(x, &xx));
+  PetscCall(PetscLogFlops(2.0 * n * n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode PCSetUp_PATCH_Linear(PC pc)
 {
   PC_PATCH   *patch = (PC_PATCH *)pc->data;
@@ -2829,6 +3161,7 @@ static PetscErrorCode PCSetUp_PATCH_Linear(PC pc)
         PetscCall(MatGetOperation(patch->mat[i], MATOP_MULT, (PetscErrorCodeFn **)&patch->densesolve));
       }
     }
+    if (patch->denseinverse && patch->densebatch) PetscCall(PCPatchDenseBatchFactor_Private(pc));
   }
   if (patch->local_composition_type == PC_COMPOSITE_MULTIPLICATIVE) {
     for (PetscInt i = 0; i < patch->npatch; ++i) {
@@ -3105,7 +3438,8 @@ static PetscErrorCode PCApply_PATCH_Linear(PC pc, PetscInt i, Vec x, Vec y)
 
   PetscFunctionBegin;
   if (patch->denseinverse) {
-    PetscCall((*patch->densesolve)(patch->mat[i], x, y));
+    if (patch->densebatch) PetscCall(PCPatchDenseBatchSolve_Private(pc, i, x, y));
+    else PetscCall((*patch->densesolve)(patch->mat[i], x, y));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
   ksp = (KSP)patch->solver[i];
@@ -3218,6 +3552,11 @@ static PetscErrorCode PCApply_PATCH(PC pc, Vec x, Vec y)
   PetscCall(PetscSectionGetChart(patch->gtolCounts, &pStart, NULL));
   PetscCall(PetscLogEventBegin(PC_Patch_Solve, pc, 0, 0, 0));
   for (sweep = 0; sweep < nsweep; sweep++) {
+    if (patch->densebatch && patch->denseinverse && !patch->isNonlinear && patch->local_composition_type == PC_COMPOSITE_ADDITIVE) {
+      /* all the patches of a pack at once, the order does not matter in the additive composition */
+      PetscCall(PCPatchDenseBatchApply_Private(pc));
+      continue;
+    }
     for (j = start[sweep]; j * inc[sweep] < end[sweep] * inc[sweep]; j += inc[sweep]) {
       PetscInt i = patch->user_patches ? iterationSet[j] : j;
       PetscInt start, len;
@@ -3339,6 +3678,7 @@ static PetscErrorCode PCReset_PATCH(PC pc)
     for (PetscInt i = 0; i < patch->npatch; ++i) PetscCall(MatDestroy(&patch->mat[i]));
     PetscCall(PetscFree(patch->mat));
   }
+  PetscCall(PCPatchDenseBatchDestroyPacks_Private(pc));
   if (patch->matWithArtificial && !patch->isNonlinear) {
     for (PetscInt i = 0; i < patch->npatch; ++i) PetscCall(MatDestroy(&patch->matWithArtificial[i]));
     PetscCall(PetscFree(patch->matWithArtificial));
@@ -3426,6 +3766,11 @@ static PetscErrorCode PCSetFromOptions_PATCH(PC pc, PetscOptionItems PetscOption
   if (flg) PetscCall(PCPatchSetLocalComposition(pc, loctype));
   PetscCall(PetscSNPrintf(option, PETSC_MAX_PATH_LEN, "-%s_patch_dense_inverse", patch->classname));
   PetscCall(PetscOptionsBool(option, "Compute inverses of patch matrices and apply directly? Ignores KSP/PC settings on patch.", "PCPatchSetDenseInverse", patch->denseinverse, &patch->denseinverse, &flg));
+  PetscCall(PetscSNPrintf(option, PETSC_MAX_PATH_LEN, "-%s_patch_dense_batch", patch->classname));
+  PetscCall(PetscOptionsBool(option, "Factor and apply the dense patch matrices in packs of patches with the same number of dofs? Implies dense inverse.", "PCPatchSetDenseBatch", patch->densebatch, &patch->densebatch, &flg));
+  if (patch->densebatch) patch->denseinverse = PETSC_TRUE;
+  PetscCall(PetscSNPrintf(option, PETSC_MAX_PATH_LEN, "-%s_patch_dense_reuse", patch->classname));
+  PetscCall(PetscOptionsBool(option, "Keep the factors of the packs whose patch matrices did not change?", "PCPatchSetDenseReuse", patch->densereuse, &patch->densereuse, &flg));
   PetscCall(PetscSNPrintf(option, PETSC_MAX_PATH_LEN, "-%s_patch_construct_dim", patch->classname));
   PetscCall(PetscOptionsInt(option, "What dimension of mesh point to construct patches by? (0 = vertices)", "PCPATCH", patch->dim, &patch->dim, &dimflg));
   PetscCall(PetscSNPrintf(option, PETSC_MAX_PATH_LEN, "-%s_patch_construct_codim", patch->classname));
@@ -3543,7 +3888,9 @@ static PetscErrorCode PCView_PATCH(PC pc, PetscViewer viewer)
   else if (patch->patchconstructop == PCPatchConstruct_User) PetscCall(PetscViewerASCIIPrintf(viewer, "Patch construction operator: user-specified\n"));
   else PetscCall(PetscViewerASCIIPrintf(viewer, "Patch construction operator: unknown\n"));
 
-  if (patch->denseinverse) {
+  if (patch->denseinverse && patch->densebatch) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "Factoring dense patch matrices in %" PetscInt_FMT " packs of up to %d patches with the same number of dofs%s\n", patch->npack, PETSC_KERNEL_BATCH_LANES, patch->densereuse ? ", keeping the factors of unchanged packs" : ""));
+  } else if (patch->denseinverse) {
     PetscCall(PetscViewerASCIIPrintf(viewer, "Explicitly forming dense inverse and applying patch solver via MatMult.\n"));
   } else {
     if (patch->isNonlinear) {
@@ -3579,7 +3926,9 @@ static PetscErrorCode PCView_PATCH(PC pc, PetscViewer viewer)
 . -pc_patch_points_view  - Views the process local mesh point numbers for each patch
 . -pc_patch_g2l_view     - Views the map between global dofs and patch local dofs for each patch
 . -pc_patch_patches_view - Views the global dofs associated with each patch and its boundary
-- -pc_patch_sub_mat_view - Views the matrix associated with each patch
+. -pc_patch_sub_mat_view - Views the matrix associated with each patch
+. -pc_patch_dense_batch  - Factors and applies the dense patch matrices in packs of patches with the same number of dofs, see `PCPatchSetDenseBatch()`
+- -pc_patch_dense_reuse  - Keeps the factors of the packs whose patch matrices did not change, see `PCPatchSetDenseReuse()`
 
    Level: intermediate
 
@@ -0,0 +1,106 @@
+static const char help[] = "Tests PCBJBATCH on a block diagonal matrix with blocks of different sizes.\n\n\
+  -nblocks <n> : number of diagonal blocks on each MPI process\n\
+  -bs <bs>     : use a constant block size set with MatSetBlockSize() instead of variable block sizes\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat         A;
+  Vec         b, x, r;
+  KSP         ksp, bksp;
+  PC          pc;
+  PetscInt    nblocks = 100, bs = 0, *bsizes, n = 0, rstart;
+  PetscReal   rtol, err, nrm;
+  PetscRandom rand;
+  PetscBool   preonly;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nblocks", &nblocks, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscMalloc1(nblocks, &bsizes));
+  for (PetscInt i = 0; i < nblocks; i++) {
+    bsizes[i] = bs ? bs : 1 + (i * 7) % 12;
+    n += bsizes[i];
+  }
+
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetInterval(rand, -1.0, 1.0));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, n, n, PETSC_DETERMINE, PETSC_DETERMINE, 12, NULL, 0, NULL, &A));
+  PetscCall(MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  PetscCall(MatGetOwnershipRange(A, &rstart, NULL));
+  /* nonsymmetric blocks, diagonally dominant except for a few rows */
+  for (PetscInt i = 0, start = rstart; i < nblocks; start += bsizes[i++]) {
+    for (PetscInt row = start; row < start + bsizes[i]; row++) {
+      for (PetscInt col = start; col < start + bsizes[i]; col++) {
+        PetscScalar v;
+
+        PetscCall(PetscRandomGetValue(rand, &v));
+        if (row == col) v = (row % 5 ? bsizes[i] : 0.5) + PetscAbsScalar(v);
+        PetscCall(MatSetValue(A, row, col, v, INSERT_VALUES));
+      }
+    }
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  if (bs) PetscCall(MatSetBlockSize(A, bs));
+  else PetscCall(MatSetVariableBlockSizes(A, nblocks, bsizes));
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(b, &r));
+  PetscCall(VecSetRandom(b, rand));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPPREONLY));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, PCBJBATCH));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(KSPSolve(ksp, b, x));
+  /* solve a second time with new values in the same blocks */
+  PetscCall(MatScale(A, 2.0));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(VecScale(x, 2.0));
+
+  PetscCall(MatScale(A, 0.5));
+  PetscCall(MatMult(A, x, r));
+  PetscCall(VecAYPX(r, -1.0, b));
+  PetscCall(VecNorm(r, NORM_2, &err));
+  PetscCall(VecNorm(b, NORM_2, &nrm));
+  PetscCall(PCBJBatchGetKSP(pc, &bksp));
+  PetscCall(PetscObjectTypeCompare((PetscObject)bksp, KSPPREONLY, &preonly));
+  PetscCall(KSPGetTolerances(bksp, &rtol, NULL, NULL, NULL));
+  if (err > (preonly ? 1000 * PETSC_MACHINE_EPSILON : 10 * rtol) * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative residual norm %g\n", (double)(err / nrm)));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&r));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFree(bsizes));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 2}}
+      test:
+        suffix: lu
+        args: -bs {{0 5}}
+      test:
+        suffix: krylov
+        args: -bs {{0 5}} -pc_bjbatch_ksp_type {{gmres bcgs}} -pc_bjbatch_ksp_rtol 1e-8
+
+   test:
+      suffix: view
+      requires: !single
+      args: -pc_bjbatch_ksp_type gmres -pc_bjbatch_ksp_gmres_restart 4 -pc_bjbatch_ksp_rtol 1e-8 -pc_bjbatch_ksp_max_it 200 -ksp_view
+
+TEST*/
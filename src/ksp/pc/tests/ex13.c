@@ -0,0 +1,86 @@
+static const char help[] = "Tests the adaptive PCDEFLATION on a sequence of solves with the same 2D Laplacian.\n\n\
+  -m <m>         : number of grid points in each direction\n\
+  -nsolves <n>   : number of solves\n\
+  -near_null     : attach the constant near-null space to the matrix\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat          A;
+  Vec          b, x;
+  KSP          ksp;
+  MatNullSpace nullsp;
+  PetscInt     m = 48, nsolves = 3, Istart, Iend, its, its0 = 0;
+  PetscBool    near_null = PETSC_FALSE;
+  PetscRandom  rand;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nsolves", &nsolves, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-near_null", &near_null, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt i = II / m, j = II % m;
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -1.0, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -1.0, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -1.0, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatSetOption(A, MAT_SPD, PETSC_TRUE));
+  if (near_null) {
+    PetscCall(MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, NULL, &nullsp));
+    PetscCall(MatSetNearNullSpace(A, nullsp));
+    PetscCall(MatNullSpaceDestroy(&nullsp));
+  }
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPCG));
+  PetscCall(KSPSetTolerances(ksp, 1e-8, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+  for (PetscInt i = 0; i < nsolves; i++) {
+    PetscCall(VecSetRandom(b, rand));
+    PetscCall(VecZeroEntries(x));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(KSPGetIterationNumber(ksp, &its));
+    if (!i) its0 = its;
+  }
+  /* the last solve is deflated with the Ritz vectors of the first ones */
+  if (4 * its > 3 * its0) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Iterations of the first solve %" PetscInt_FMT ", of the last solve %" PetscInt_FMT "\n", its0, its));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 2}}
+      args: -pc_type deflation -pc_deflation_adaptive 16 -pc_deflation_adaptive_solves 2
+      test:
+        suffix: adaptive
+        args: -near_null {{0 1}}
+      test:
+        suffix: adaptive_jacobi
+        args: -deflation_pc_pc_type jacobi
+
+TEST*/
@@ -0,0 +1,126 @@
+static const char help[] = "Tests PCGAMGSetReuseAggregates() on a 2D variable coefficient Laplacian whose coefficients change.\n\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscksp.h>
+
+/* number of PCGAMG graphs created since the previous call */
+static PetscErrorCode CountGraphs(PetscInt *n)
+{
+  static PetscInt    last = 0;
+  PetscLogEvent      event;
+  PetscEventPerfInfo info;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscLogEventGetId(" PCGAMGCreateG", &event));
+  PetscCall(PetscLogEventGetPerfInfo(PETSC_DETERMINE, event, &info));
+  *n   = info.count - last;
+  last = info.count;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* coefficient k = 1 + c sin(x)^2 cos(y)^2 */
+static PetscReal Coefficient(PetscReal x, PetscReal y, PetscReal c)
+{
+  return 1.0 + c * PetscSqr(PetscSinReal(x)) * PetscSqr(PetscCosReal(y));
+}
+
+/* -div(k grad u) with k on the edges, the nonzero structure does not depend on c */
+static PetscErrorCode FillMatrix(Mat A, PetscInt m, PetscReal c)
+{
+  PetscInt Istart, Iend;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt  i = II / m, j = II % m;
+    PetscReal h = 6.0 / m, ks = Coefficient((i - 0.5) * h, j * h, c), kn = Coefficient((i + 0.5) * h, j * h, c), kw = Coefficient(i * h, (j - 0.5) * h, c), ke = Coefficient(i * h, (j + 0.5) * h, c);
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -ks, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -kn, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -kw, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -ke, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, ks + kn + kw + ke, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateGAMG(Mat A, PetscBool reuse, KSP *ksp)
+{
+  PC pc;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, ksp));
+  PetscCall(KSPSetOperators(*ksp, A, A));
+  PetscCall(KSPSetType(*ksp, KSPCG));
+  PetscCall(KSPSetTolerances(*ksp, 1e-8, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(*ksp, &pc));
+  PetscCall(PCSetType(pc, PCGAMG));
+  if (reuse) PetscCall(PCGAMGSetReuseAggregates(pc, PETSC_TRUE));
+  else PetscCall(PCGAMGSetReuseInterpolation(pc, PETSC_FALSE));
+  PetscCall(KSPSetFromOptions(*ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat      A;
+  Vec      b, x;
+  KSP      ksp, kspref;
+  PetscInt m = 48, n, its, itsref;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscLogDefaultBegin());
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(FillMatrix(A, m, 0.0));
+  PetscCall(MatSetOption(A, MAT_SPD, PETSC_TRUE));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecSet(b, 1.0));
+
+  PetscCall(CreateGAMG(A, PETSC_TRUE, &ksp));
+  PetscCall(KSPSolve(ksp, b, x));
+
+  /* new values, the aggregates of the first setup are reused */
+  PetscCall(FillMatrix(A, m, 50.0));
+  PetscCall(CountGraphs(&n));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(VecZeroEntries(x));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  PetscCall(CountGraphs(&n));
+  if (n) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "%" PetscInt_FMT " graphs created by the second setup\n", n));
+
+  /* full setup on the new values */
+  PetscCall(CreateGAMG(A, PETSC_FALSE, &kspref));
+  PetscCall(VecZeroEntries(x));
+  PetscCall(KSPSolve(kspref, b, x));
+  PetscCall(KSPGetIterationNumber(kspref, &itsref));
+  if (PetscAbsInt(its - itsref) > 1) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Iterations with the previous aggregates %" PetscInt_FMT ", with a full setup %" PetscInt_FMT "\n", its, itsref));
+
+  PetscCall(KSPDestroy(&kspref));
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single defined(PETSC_USE_LOG)
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      test:
+        suffix: reuse
+        args: -pc_gamg_agg_nsmooths {{0 1 2}}
+      test:
+        suffix: reuse_reduction
+        args: -pc_gamg_process_eq_limit 200
+
+TEST*/
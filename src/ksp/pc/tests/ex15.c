@@ -0,0 +1,131 @@
+static const char help[] = "Tests the PCASM subdomain matrices read from shared memory on a 2D variable coefficient Laplacian.\n\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscksp.h>
+
+/* -div(k grad u) with k = 1 + c x y on the edges */
+static PetscErrorCode FillMatrix(Mat A, PetscInt m, PetscReal c)
+{
+  PetscInt Istart, Iend;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt  i = II / m, j = II % m;
+    PetscReal ks = 1.0 + c * (i - 0.5) * j, kn = 1.0 + c * (i + 0.5) * j, kw = 1.0 + c * i * (j - 0.5), ke = 1.0 + c * i * (j + 0.5);
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -ks, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -kn, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -kw, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -ke, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, ks + kn + kw + ke, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* compares the subdomain matrices of the PCASM with the ones extracted by MatCreateSubMatrices() */
+static PetscErrorCode CheckSubMatrices(KSP ksp, Mat A)
+{
+  PC        pc;
+  IS       *is;
+  Mat      *mats, *refs;
+  PetscInt  n;
+  PetscBool flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPSetUp(ksp));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCASMGetLocalSubdomains(pc, &n, &is, NULL));
+  PetscCall(PCASMGetLocalSubmatrices(pc, &n, &mats));
+  PetscCall(MatCreateSubMatrices(A, n, is, is, MAT_INITIAL_MATRIX, &refs));
+  for (PetscInt i = 0; i < n; i++) {
+    PetscCall(MatEqual(mats[i], refs[i], &flg));
+    if (!flg) PetscCall(PetscPrintf(PETSC_COMM_SELF, "[%d] subdomain matrix %" PetscInt_FMT " differs from MatCreateSubMatrices()\n", PetscGlobalRank, i));
+  }
+  PetscCall(MatDestroySubMatrices(n, &refs));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* extracts two submatrices at once after PCSetUp(), this must not take the single IS path PCASM may request for its own extraction */
+static PetscErrorCode CheckSeveralSubMatrices(KSP ksp, Mat A)
+{
+  IS        is[2];
+  Mat      *mats, *ref;
+  PetscInt  rstart, rend;
+  PetscBool flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPSetUp(ksp));
+  PetscCall(MatGetOwnershipRange(A, &rstart, &rend));
+  PetscCall(ISCreateStride(PETSC_COMM_SELF, (rend - rstart) / 2, rstart, 1, &is[0]));
+  PetscCall(ISCreateStride(PETSC_COMM_SELF, rend - rstart - (rend - rstart) / 2, rstart + (rend - rstart) / 2, 1, &is[1]));
+  PetscCall(MatCreateSubMatrices(A, 2, is, is, MAT_INITIAL_MATRIX, &mats));
+  for (PetscInt i = 0; i < 2; i++) {
+    PetscCall(MatCreateSubMatrices(A, 1, &is[i], &is[i], MAT_INITIAL_MATRIX, &ref));
+    PetscCall(MatEqual(mats[i], ref[0], &flg));
+    if (!flg) PetscCall(PetscPrintf(PETSC_COMM_SELF, "[%d] submatrix %" PetscInt_FMT " differs when extracted alone\n", PetscGlobalRank, i));
+    PetscCall(MatDestroySubMatrices(1, &ref));
+    PetscCall(ISDestroy(&is[i]));
+  }
+  PetscCall(MatDestroySubMatrices(2, &mats));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat      A;
+  Vec      b, x;
+  KSP      ksp;
+  PC       pc;
+  PetscInt m = 24;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(FillMatrix(A, m, 0.1));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecSet(b, 1.0));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, PCASM));
+  PetscCall(PCASMSetSharedMemory(pc, PETSC_TRUE));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(CheckSeveralSubMatrices(ksp, A));
+  PetscCall(CheckSubMatrices(ksp, A));
+  PetscCall(KSPSolve(ksp, b, x));
+
+  /* new values, the subdomain matrices are updated in place */
+  PetscCall(FillMatrix(A, m, 0.5));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(CheckSubMatrices(ksp, A));
+  PetscCall(KSPSolve(ksp, b, x));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      output_file: output/empty.out
+      args: -pc_asm_overlap {{1 3}} -pc_asm_local_blocks {{1 2}}
+      test:
+        suffix: shared
+        nsize: {{1 4}}
+      test:
+        suffix: noshared
+        nsize: 4
+        args: -pc_asm_shared_memory false
+
+TEST*/
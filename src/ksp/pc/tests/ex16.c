@@ -0,0 +1,101 @@
+static const char help[] = "Tests MATSOLVERPARILU on a 2D convection-diffusion problem, comparing with the ILU of PCBJACOBI.\n\n\
+  -m <m>   : number of grid points in each direction\n\
+  -dt <dt> : drop tolerance of the factors\n\n";
+
+#include <petscksp.h>
+
+int main(int argc, char **argv)
+{
+  Mat       A;
+  Vec       b, x;
+  KSP       ksp, kspref, *subksp;
+  PC        pc, subpc;
+  PetscInt  m = 32, Istart, Iend, levels = 0, solveits = 3, its, itsref, nsub;
+  PetscReal h, beta = 20.0, dt = 0.0;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-pc_factor_levels", &levels, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-mat_parilu_solve_iterations", &solveits, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-dt", &dt, NULL));
+
+  /* -Laplacian u + beta (u_x + u_y) with centered differences */
+  h = 1.0 / (m + 1);
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m, 5, NULL, 2, NULL, &A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt II = Istart; II < Iend; II++) {
+    PetscInt i = II / m, j = II % m;
+
+    if (i > 0) PetscCall(MatSetValue(A, II, II - m, -1.0 - 0.5 * beta * h, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, II, II + m, -1.0 + 0.5 * beta * h, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, II, II - 1, -1.0 - 0.5 * beta * h, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, II, II + 1, -1.0 + 0.5 * beta * h, INSERT_VALUES));
+    PetscCall(MatSetValue(A, II, II, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecSet(b, 1.0));
+
+  /* ILU(k) of the diagonal blocks */
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &kspref));
+  PetscCall(KSPSetOperators(kspref, A, A));
+  PetscCall(KSPSetTolerances(kspref, 1e-8, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(kspref, &pc));
+  PetscCall(PCSetType(pc, PCBJACOBI));
+  PetscCall(KSPSetUp(kspref));
+  PetscCall(PCBJacobiGetSubKSP(pc, &nsub, NULL, &subksp));
+  PetscCall(KSPGetPC(subksp[0], &subpc));
+  PetscCall(PCSetType(subpc, PCILU));
+  PetscCall(PCFactorSetLevels(subpc, levels));
+  PetscCall(KSPSolve(kspref, b, x));
+  PetscCall(KSPGetIterationNumber(kspref, &itsref));
+
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetTolerances(ksp, 1e-8, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, PCILU));
+  PetscCall(PCFactorSetMatSolverType(pc, MATSOLVERPARILU));
+  if (dt > 0.0) PetscCall(PCFactorSetDropTolerance(pc, dt, PETSC_DEFAULT, PETSC_DEFAULT));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(VecZeroEntries(x));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  /* with exact triangular solves the factors are those of ILU(k), the Jacobi iterations of the triangular solves may need more iterations */
+  if (solveits ? its > 2 * itsref + 2 : its > itsref + 1) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Iterations of ILU(%" PetscInt_FMT ") %" PetscInt_FMT ", of ParILU %" PetscInt_FMT "\n", levels, itsref, its));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(KSPDestroy(&kspref));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 3}}
+      args: -pc_factor_levels {{0 2}}
+      test:
+        suffix: parilu
+        args: -mat_parilu_solve_iterations {{0 3}}
+      test:
+        suffix: parilu_sweeps
+        args: -mat_parilu_sweeps 1 -mat_parilu_solve_iterations 5
+      test:
+        suffix: parilu_droptol
+        args: -dt 1e-3
+
+   test:
+      suffix: parilu_view
+      requires: !single
+      args: -ksp_view
+      filter: grep -E "ParILU|parilu|sweeps|Jacobi"
+
+TEST*/
@@ -0,0 +1,116 @@
+static const char help[] = "Tests MATSOLVERSUPERNODAL on a 3D convection-diffusion problem whose coefficients change.\n\n\
+  -m <m>       : number of grid points in each direction\n\
+  -beta <beta> : convection coefficient, 0 for a symmetric matrix\n\n";
+
+#include <petscksp.h>
+
+/* -div(k grad u) + beta (u_x + u_y + u_z) with k = 1 + c z on the edges */
+static PetscErrorCode FillMatrix(Mat A, PetscInt m, PetscReal c, PetscReal beta)
+{
+  PetscReal h = 1.0 / (m + 1);
+
+  PetscFunctionBeginUser;
+  PetscCall(MatZeroEntries(A));
+  for (PetscInt II = 0; II < m * m * m; II++) {
+    PetscInt  idx[3] = {II / (m * m), (II / m) % m, II % m}, stride[3] = {m * m, m, 1};
+    PetscReal diag = 0.0;
+
+    for (PetscInt d = 0; d < 3; d++) {
+      PetscReal km = 1.0 + c * (2 * idx[0] - (d == 0)) * h / 2, kp = 1.0 + c * (2 * idx[0] + (d == 0)) * h / 2;
+
+      if (idx[d] > 0) PetscCall(MatSetValue(A, II, II - stride[d], -km - 0.5 * beta * h, INSERT_VALUES));
+      if (idx[d] < m - 1) PetscCall(MatSetValue(A, II, II + stride[d], -kp + 0.5 * beta * h, INSERT_VALUES));
+      diag += km + kp;
+    }
+    PetscCall(MatSetValue(A, II, II, diag, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckSolution(KSP ksp, Mat A, Vec b, Vec x)
+{
+  Vec       r;
+  PetscReal nrm, nrmb;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(VecDuplicate(b, &r));
+  PetscCall(MatMult(A, x, r));
+  PetscCall(VecAYPX(r, -1.0, b));
+  PetscCall(VecNorm(r, NORM_2, &nrm));
+  PetscCall(VecNorm(b, NORM_2, &nrmb));
+  if (nrm > 1e-10 * nrmb) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative residual norm %g\n", (double)(nrm / nrmb)));
+  PetscCall(VecDestroy(&r));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A;
+  Vec       b, x;
+  KSP       ksp;
+  PC        pc;
+  PetscInt  m = 10;
+  PetscReal beta = 0.0;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-beta", &beta, NULL));
+
+  PetscCall(MatCreate(PETSC_COMM_SELF, &A));
+  PetscCall(MatSetSizes(A, m * m * m, m * m * m, m * m * m, m * m * m));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSeqAIJSetPreallocation(A, 7, NULL));
+  PetscCall(MatSeqSBAIJSetPreallocation(A, 1, 4, NULL));
+  PetscCall(MatSetOption(A, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE));
+  PetscCall(FillMatrix(A, m, 0.0, beta));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecSetRandom(b, NULL));
+
+  PetscCall(KSPCreate(PETSC_COMM_SELF, &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPPREONLY));
+  PetscCall(KSPGetPC(ksp, &pc));
+  PetscCall(PCSetType(pc, beta == 0.0 ? PCCHOLESKY : PCLU));
+  PetscCall(PCFactorSetMatSolverType(pc, MATSOLVERSUPERNODAL));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(CheckSolution(ksp, A, b, x));
+
+  /* new values, only the numeric factorization is done again */
+  PetscCall(FillMatrix(A, m, 10.0, beta));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(CheckSolution(ksp, A, b, x));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !complex !single
+      output_file: output/empty.out
+      test:
+        suffix: cholesky
+        args: -pc_factor_mat_ordering_type {{natural nd rcm}}
+      test:
+        suffix: cholesky_sbaij
+        args: -mat_type sbaij
+      test:
+        suffix: lu
+        args: -beta {{1 50}} -pc_factor_mat_ordering_type {{natural nd}}
+
+   test:
+      suffix: view
+      requires: !complex !single
+      args: -beta 1 -ksp_view
+      filter: grep -E "Supernod|supernodal"
+
+TEST*/
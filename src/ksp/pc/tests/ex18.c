@@ -0,0 +1,145 @@
+static const char help[] = "Tests PCFactorSetShareSymbolic() with several PCLU or PCILU whose matrices have the same nonzero pattern.\n\n\
+  -m <m>    : number of grid points in each direction\n\
+  -n <n>    : number of matrices\n\
+  -noshare  : do not share the symbolic factorizations\n\n";
+
+#include <petscksp.h>
+
+/* -div(k grad u) with k = 1 + c x y on the edges, with the 9-point stencil the diagonal neighbors are added */
+static PetscErrorCode CreateMatrix(PetscInt m, PetscReal c, PetscBool nine, Mat *A)
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatCreateSeqAIJ(PETSC_COMM_SELF, m * m, m * m, nine ? 9 : 5, NULL, A));
+  for (PetscInt II = 0; II < m * m; II++) {
+    PetscInt  i = II / m, j = II % m;
+    PetscReal ks = 1.0 + c * (i - 0.5) * j, kn = 1.0 + c * (i + 0.5) * j, kw = 1.0 + c * i * (j - 0.5), ke = 1.0 + c * i * (j + 0.5), diag = ks + kn + kw + ke;
+
+    if (i > 0) PetscCall(MatSetValue(*A, II, II - m, -ks, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(*A, II, II + m, -kn, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(*A, II, II - 1, -kw, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(*A, II, II + 1, -ke, INSERT_VALUES));
+    if (nine) {
+      for (PetscInt di = -1; di <= 1; di += 2) {
+        for (PetscInt dj = -1; dj <= 1; dj += 2) {
+          if (i + di < 0 || i + di >= m || j + dj < 0 || j + dj >= m) continue;
+          PetscCall(MatSetValue(*A, II, II + di * m + dj, -0.25, INSERT_VALUES));
+          diag += 0.25;
+        }
+      }
+    }
+    PetscCall(MatSetValue(*A, II, II, diag, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(*A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(*A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateKSP(Mat A, PetscBool share, KSP *ksp)
+{
+  PC pc;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPCreate(PETSC_COMM_SELF, ksp));
+  PetscCall(KSPSetOperators(*ksp, A, A));
+  PetscCall(KSPSetTolerances(*ksp, 1e-8, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(*ksp, &pc));
+  PetscCall(PCSetType(pc, PCILU));
+  PetscCall(KSPSetFromOptions(*ksp));
+  PetscCall(PCFactorSetShareSymbolic(pc, share));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the solution with the shared symbolic factorization must be the one computed with a factorization of its own */
+static PetscErrorCode CheckSolution(KSP ksp, KSP kspref, Vec b, PetscInt k)
+{
+  Vec       x, xref;
+  PetscReal nrm, nrmref;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecDuplicate(b, &x));
+  PetscCall(VecDuplicate(b, &xref));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPSolve(kspref, b, xref));
+  PetscCall(VecNorm(xref, NORM_2, &nrmref));
+  PetscCall(VecAXPY(x, -1.0, xref));
+  PetscCall(VecNorm(x, NORM_2, &nrm));
+  if (nrm > 1e-10 * nrmref) PetscCall(PetscPrintf(PETSC_COMM_SELF, "Matrix %" PetscInt_FMT ": relative difference of the solutions %g\n", k, (double)(nrm / nrmref)));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&xref));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat      *A;
+  Vec       b;
+  KSP      *ksp, *kspref;
+  PetscInt  m = 16, n = 4;
+  PetscBool share = PETSC_TRUE, flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsHasName(NULL, NULL, "-noshare", &flg));
+  if (flg) share = PETSC_FALSE;
+  PetscCheck(n > 1, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Needs at least two matrices");
+
+  PetscCall(PetscMalloc3(n, &A, n, &ksp, n, &kspref));
+  for (PetscInt k = 0; k < n; k++) {
+    PetscCall(CreateMatrix(m, 0.1 * k, PETSC_FALSE, &A[k]));
+    PetscCall(CreateKSP(A[k], share, &ksp[k]));
+    PetscCall(CreateKSP(A[k], PETSC_FALSE, &kspref[k]));
+  }
+  PetscCall(MatCreateVecs(A[0], &b, NULL));
+  PetscCall(VecSet(b, 1.0));
+  for (PetscInt k = 0; k < n; k++) PetscCall(CheckSolution(ksp[k], kspref[k], b, k));
+
+  /* new nonzero pattern for the first matrices, they share a new symbolic factorization while the others keep the previous one */
+  for (PetscInt k = 0; k < n / 2; k++) {
+    PetscCall(MatDestroy(&A[k]));
+    PetscCall(CreateMatrix(m, 0.2 * k, PETSC_TRUE, &A[k]));
+    PetscCall(KSPSetOperators(ksp[k], A[k], A[k]));
+    PetscCall(KSPSetOperators(kspref[k], A[k], A[k]));
+  }
+  for (PetscInt k = 0; k < n; k++) PetscCall(CheckSolution(ksp[k], kspref[k], b, k));
+
+  /* the PC which computed the first symbolic factorization no longer uses it, the others still do */
+  PetscCall(KSPDestroy(&ksp[n - 1]));
+  PetscCall(KSPDestroy(&kspref[n - 1]));
+  PetscCall(MatScale(A[n - 2], 2.0));
+  PetscCall(KSPSetOperators(ksp[n - 2], A[n - 2], A[n - 2]));
+  PetscCall(KSPSetOperators(kspref[n - 2], A[n - 2], A[n - 2]));
+  PetscCall(CheckSolution(ksp[n - 2], kspref[n - 2], b, n - 2));
+
+  for (PetscInt k = 0; k < n; k++) {
+    PetscCall(KSPDestroy(&ksp[k]));
+    PetscCall(KSPDestroy(&kspref[k]));
+    PetscCall(MatDestroy(&A[k]));
+  }
+  PetscCall(PetscFree3(A, ksp, kspref));
+  PetscCall(VecDestroy(&b));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/empty.out
+      test:
+        suffix: ilu
+        args: -pc_factor_levels {{0 2}} -pc_factor_mat_ordering_type {{natural rcm}}
+      test:
+        suffix: lu
+        args: -pc_type lu -pc_factor_mat_ordering_type {{natural nd}}
+      test:
+        suffix: noshare
+        args: -pc_type lu -noshare
+
+   test:
+      suffix: info
+      args: -pc_type lu -info :pc
+      filter: grep -E "shared"
+
+TEST*/
@@ -0,0 +1,164 @@
+static const char help[] = "Tests the reuse of the assembled Schur complement approximations of PCFIELDSPLIT when the values of a Stokes-like matrix change.\n\n\
+  -m <m>     : number of grid points in each direction\n\
+  -steps <n> : number of changes of the values\n\n";
+
+#include <petscksp.h>
+
+/* velocities (u, v) and pressure p interleaved at each grid point, -div(k grad) on the velocities with a coupling of u and v,
+   a discrete gradient and divergence, and a stabilization of the pressure, k and the coupling depend on t */
+static PetscErrorCode FillMatrix(Mat A, PetscInt m, PetscReal t)
+{
+  PetscInt Istart, Iend;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatZeroEntries(A));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt k = Istart / 3; k < Iend / 3; k++) {
+    PetscInt    i = k / m, j = k % m, nb[4] = {-1, -1, -1, -1}, nn = 0;
+    PetscScalar kappa = 1.0 + t * (i + 1) / m, diag = 0.0;
+
+    if (i > 0) nb[nn++] = k - m;
+    if (i < m - 1) nb[nn++] = k + m;
+    if (j > 0) nb[nn++] = k - 1;
+    if (j < m - 1) nb[nn++] = k + 1;
+    for (PetscInt c = 0; c < 2; c++) {
+      for (PetscInt l = 0; l < nn; l++) PetscCall(MatSetValue(A, 3 * k + c, 3 * nb[l] + c, -kappa, INSERT_VALUES));
+      PetscCall(MatSetValue(A, 3 * k + c, 3 * k + c, 4.0 * kappa, INSERT_VALUES));
+      PetscCall(MatSetValue(A, 3 * k + c, 3 * k + 1 - c, 0.5 * t, INSERT_VALUES));
+    }
+    /* gradient of the pressure with the east and north neighbors, the divergence is its transpose */
+    if (j < m - 1) {
+      PetscCall(MatSetValue(A, 3 * k, 3 * (k + 1) + 2, 1.0, INSERT_VALUES));
+      PetscCall(MatSetValue(A, 3 * (k + 1) + 2, 3 * k, 1.0, INSERT_VALUES));
+    }
+    if (i < m - 1) {
+      PetscCall(MatSetValue(A, 3 * k + 1, 3 * (k + m) + 2, 1.0, INSERT_VALUES));
+      PetscCall(MatSetValue(A, 3 * (k + m) + 2, 3 * k + 1, 1.0, INSERT_VALUES));
+    }
+    PetscCall(MatSetValue(A, 3 * k, 3 * k + 2, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(A, 3 * k + 2, 3 * k, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(A, 3 * k + 1, 3 * k + 2, -1.0, INSERT_VALUES));
+    PetscCall(MatSetValue(A, 3 * k + 2, 3 * k + 1, -1.0, INSERT_VALUES));
+    for (PetscInt l = 0; l < nn; l++) {
+      PetscCall(MatSetValue(A, 3 * k + 2, 3 * nb[l] + 2, 0.01, INSERT_VALUES));
+      diag -= 0.01;
+    }
+    PetscCall(MatSetValue(A, 3 * k + 2, 3 * k + 2, diag, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateKSP(Mat A, KSP *ksp)
+{
+  PC pc;
+
+  PetscFunctionBeginUser;
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, ksp));
+  PetscCall(KSPSetOperators(*ksp, A, A));
+  PetscCall(KSPSetType(*ksp, KSPFGMRES));
+  PetscCall(KSPSetTolerances(*ksp, 1e-10, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPGetPC(*ksp, &pc));
+  PetscCall(PCSetType(pc, PCFIELDSPLIT));
+  PetscCall(PCFieldSplitSetBlockSize(pc, 3));
+  PetscCall(PCFieldSplitSetFields(pc, "0", 2, (PetscInt[]){0, 1}, (PetscInt[]){0, 1}));
+  PetscCall(PCFieldSplitSetFields(pc, "1", 1, (PetscInt[]){2}, (PetscInt[]){2}));
+  PetscCall(PCFieldSplitSetType(pc, PC_COMPOSITE_SCHUR));
+  PetscCall(PCFieldSplitSetSchurPre(pc, PC_FIELDSPLIT_SCHUR_PRE_SELFP, NULL));
+  PetscCall(KSPSetFromOptions(*ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat                        A, A00 = NULL, A01 = NULL, A10 = NULL, A11 = NULL, Sp = NULL, Spref;
+  Vec                        b, x, xref;
+  KSP                        ksp, kspref;
+  IS                         is[2];
+  PetscInt                   m = 8, steps = 2, Istart, Iend;
+  PetscReal                  nrm, nrmref;
+  MatSchurComplementAinvType ainvtype = MAT_SCHUR_COMPLEMENT_AINV_DIAG;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-steps", &steps, NULL));
+  PetscCall(PetscOptionsGetEnum(NULL, NULL, "-ainv_type", MatSchurComplementAinvTypes, (PetscEnum *)&ainvtype, NULL));
+
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, 3 * m * m, 3 * m * m, 16, NULL, 8, NULL, &A));
+  PetscCall(MatSetBlockSize(A, 3));
+  PetscCall(MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  PetscCall(FillMatrix(A, m, 0.0));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &xref));
+  PetscCall(VecSet(b, 1.0));
+  PetscCall(CreateKSP(A, &ksp));
+
+  /* the fields of the assembled approximations of the Schur complement */
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  PetscCall(ISCreateStride(PETSC_COMM_WORLD, Iend / 3 - Istart / 3, Istart + 2, 3, &is[1]));
+  PetscCall(ISComplement(is[1], Istart, Iend, &is[0]));
+  PetscCall(ISSetBlockSize(is[0], 2));
+
+  for (PetscInt s = 0; s <= steps; s++) {
+    Mat       Sp0 = Sp;
+    MatReuse  scall = s ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX;
+    PetscReal t     = s;
+
+    if (s) PetscCall(FillMatrix(A, m, t));
+    /* the preconditioner whose products are reused must be the one computed from scratch */
+    PetscCall(KSPSetOperators(ksp, A, A));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(CreateKSP(A, &kspref));
+    PetscCall(KSPSolve(kspref, b, xref));
+    PetscCall(VecNorm(xref, NORM_2, &nrmref));
+    PetscCall(VecAXPY(x, -1.0, xref));
+    PetscCall(VecNorm(x, NORM_2, &nrm));
+    if (nrm > 1e-8 * nrmref) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Step %" PetscInt_FMT ": relative difference of the solutions %g\n", s, (double)(nrm / nrmref)));
+    PetscCall(KSPDestroy(&kspref));
+
+    PetscCall(MatCreateSubMatrix(A, is[0], is[0], scall, &A00));
+    PetscCall(MatCreateSubMatrix(A, is[0], is[1], scall, &A01));
+    PetscCall(MatCreateSubMatrix(A, is[1], is[0], scall, &A10));
+    PetscCall(MatCreateSubMatrix(A, is[1], is[1], scall, &A11));
+    PetscCall(MatCreateSchurComplementPmat(A00, A01, A10, A11, ainvtype, scall, &Sp));
+    PetscCall(MatCreateSchurComplementPmat(A00, A01, A10, A11, ainvtype, MAT_INITIAL_MATRIX, &Spref));
+    PetscCall(MatNorm(Spref, NORM_FROBENIUS, &nrmref));
+    PetscCall(MatAXPY(Spref, -1.0, Sp, DIFFERENT_NONZERO_PATTERN));
+    PetscCall(MatNorm(Spref, NORM_FROBENIUS, &nrm));
+    if (nrm > PETSC_SMALL * nrmref) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Step %" PetscInt_FMT ": relative difference of the Schur complement approximations %g\n", s, (double)(nrm / nrmref)));
+    if (s && Sp != Sp0) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Step %" PetscInt_FMT ": the Schur complement approximation was not updated in place\n", s));
+    PetscCall(MatDestroy(&Spref));
+  }
+
+  PetscCall(ISDestroy(&is[0]));
+  PetscCall(ISDestroy(&is[1]));
+  PetscCall(MatDestroy(&Sp));
+  PetscCall(MatDestroy(&A00));
+  PetscCall(MatDestroy(&A01));
+  PetscCall(MatDestroy(&A10));
+  PetscCall(MatDestroy(&A11));
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&xref));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      requires: !single
+      output_file: output/empty.out
+      nsize: {{1 2}}
+      test:
+        suffix: selfp
+        args: -ainv_type {{diag lump blockdiag}} -fieldsplit_1_mat_schur_complement_ainv_type {{diag blockdiag}}
+      test:
+        suffix: lsc
+        args: -pc_fieldsplit_schur_precondition self -fieldsplit_1_pc_type lsc -fieldsplit_1_pc_lsc_scale_diag {{0 1}}
+
+TEST*/
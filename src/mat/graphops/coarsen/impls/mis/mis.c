@@ -8,11 +8,126 @@
 #define MIS_REMOVED        -3
 #define MIS_IS_SELECTED(s) (s != MIS_DELETED && s != MIS_NOT_DONE && s != MIS_REMOVED)
 
+/* status of the candidates in MatCoarsenMISLuby_Private() */
+#define MIS_LUBY_UNDECIDED 0
+#define MIS_LUBY_IN        1
+#define MIS_LUBY_OUT       2
+
+/*
+   MatCoarsenMISLuby_Private - Luby-style selection of the vertices of one sweep of the greedy MIS, in parallel within the process
+
+   Input Parameters:
+   . n - number of local vertices
+   . ai, aj - local adjacency graph in CSR format, structurally symmetric
+   . pos - position of each vertex in the greedy ordering, the random weight of Luby's algorithm
+   . kind - MIS_LUBY_CANDIDATE for a vertex that may be selected, MIS_LUBY_DONE for one that is already in an aggregate,
+            any other kind for one that may only be added to an aggregate
+
+   Output Parameters:
+   . claim - claim[v] = v if v is selected, otherwise the selected neighbor of v with the smallest position, or -1
+   . agg_i, agg_j - for each selected vertex, its neighbors added to its aggregate in the order of its row, agg_i[] has n + 1 entries,
+                    agg_j[] is allocated here
+
+   Note:
+   A candidate is selected when it precedes all its undecided candidate neighbors in the ordering, its undecided candidate neighbors
+   are then discarded, in rounds until all candidates are decided. This selects the lexicographically first MIS of the candidates,
+   i.e., the same vertices as a sweep of the greedy algorithm in the same ordering, and a vertex that is not selected joins the
+   aggregate of the first selected neighbor the greedy sweep would find. The aggregates are therefore the same as with the serial
+   sweep for a given ordering, whatever the number of threads. The number of rounds is small for random orderings, such as the
+   ones used by PCGAMG, but not for the natural ordering.
+*/
+PetscErrorCode MatCoarsenMISLuby_Private(PetscInt n, const PetscInt ai[], const PetscInt aj[], const PetscInt pos[], const PetscInt kind[], PetscInt claim[], PetscInt agg_i[], PetscInt *agg_j[])
+{
+  PetscInt *status, nleft, nrounds = 0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc1(n, &status));
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt v = 0; v < n; v++) {
+    status[v] = kind[v] == MIS_LUBY_CANDIDATE ? MIS_LUBY_UNDECIDED : MIS_LUBY_OUT;
+    claim[v]  = -1;
+  }
+  do {
+    nleft = 0;
+    /* select the undecided vertices that precede all their undecided neighbors */
+    PetscPragmaUseOMPKernels(parallel for)
+    for (PetscInt v = 0; v < n; v++) {
+      PetscBool first = PETSC_TRUE;
+
+      if (status[v] != MIS_LUBY_UNDECIDED) continue;
+      for (PetscInt j = ai[v]; j < ai[v + 1] && first; j++) {
+        const PetscInt w = aj[j];
+
+        if (w != v && status[w] == MIS_LUBY_UNDECIDED && pos[w] < pos[v]) first = PETSC_FALSE;
+      }
+      if (first) claim[v] = v;
+    }
+    /* the undecided neighbors of the selected vertices are discarded */
+    PetscPragmaUseOMPKernels(parallel for reduction(+:nleft))
+    for (PetscInt v = 0; v < n; v++) {
+      if (status[v] != MIS_LUBY_UNDECIDED) continue;
+      if (claim[v] == v) status[v] = MIS_LUBY_IN;
+      else {
+        for (PetscInt j = ai[v]; j < ai[v + 1]; j++) {
+          if (claim[aj[j]] == aj[j]) {
+            status[v] = MIS_LUBY_OUT;
+            break;
+          }
+        }
+        if (status[v] == MIS_LUBY_UNDECIDED) nleft++;
+      }
+    }
+    nrounds++;
+  } while (nleft);
+  PetscCall(PetscInfo(NULL, "Luby-style MIS of %" PetscInt_FMT " vertices in %" PetscInt_FMT " rounds\n", n, nrounds));
+  /* the other vertices join the aggregate of their first selected neighbor */
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt v = 0; v < n; v++) {
+    PetscInt first = -1;
+
+    if (status[v] == MIS_LUBY_IN || kind[v] == MIS_LUBY_DONE) continue;
+    for (PetscInt j = ai[v]; j < ai[v + 1]; j++) {
+      const PetscInt w = aj[j];
+
+      if (status[w] == MIS_LUBY_IN && (first < 0 || pos[w] < pos[first])) first = w;
+    }
+    claim[v] = first;
+  }
+  /* the aggregates of the selected vertices */
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt v = 0; v < n; v++) {
+    agg_i[v + 1] = 0;
+    if (status[v] != MIS_LUBY_IN) continue;
+    for (PetscInt j = ai[v]; j < ai[v + 1]; j++) {
+      const PetscInt w = aj[j];
+
+      if (w != v && kind[w] != MIS_LUBY_DONE && claim[w] == v) agg_i[v + 1]++;
+    }
+  }
+  agg_i[0] = 0;
+  for (PetscInt v = 0; v < n; v++) agg_i[v + 1] += agg_i[v];
+  PetscCall(PetscMalloc1(agg_i[n], agg_j));
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt v = 0; v < n; v++) {
+    PetscInt k = agg_i[v];
+
+    if (status[v] != MIS_LUBY_IN) continue;
+    for (PetscInt j = ai[v]; j < ai[v + 1]; j++) {
+      const PetscInt w = aj[j];
+
+      if (w != v && kind[w] != MIS_LUBY_DONE && claim[w] == v) (*agg_j)[k++] = w;
+    }
+  }
+  PetscCall(PetscFree(status));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
    MatCoarsenApply_MIS_private - parallel maximal independent set (MIS) with data locality info. MatAIJ specific!!!
 
    Input Parameter:
    . perm - serial permutation of rows of local to process in MIS
+   . luby - select the vertices of each sweep with MatCoarsenMISLuby_Private(), the aggregates are the same
    . Gmat - global matrix of graph (data not defined)
    . strict_aggs - flag for whether to keep strict (non overlapping) aggregates in 'llist';
 
@@ -20,13 +135,14 @@
    . a_selected - IS of selected vertices, includes 'ghost' nodes at end with natural local indices
    . a_locals_llist - array of list of nodes rooted at selected nodes
 */
-static PetscErrorCode MatCoarsenApply_MIS_private(IS perm, Mat Gmat, PetscBool strict_aggs, PetscCoarsenData **a_locals_llist)
+static PetscErrorCode MatCoarsenApply_MIS_private(IS perm, PetscBool luby, Mat Gmat, PetscBool strict_aggs, PetscCoarsenData **a_locals_llist)
 {
   Mat_SeqAIJ       *matA, *matB = NULL;
   Mat_MPIAIJ       *mpimat = NULL;
   MPI_Comm          comm;
   PetscInt          num_fine_ghosts, kk, n, ix, j, *idx, *ii, Iend, my0, nremoved, gid, lid, cpid, lidj, sgid, t2, slid, nDone, nselected = 0, state, statej;
   PetscInt         *cpcol_gid, *cpcol_state, *lid_cprowID, *lid_gid, *cpcol_sel_gid, *icpcol_gid, *lid_state, *lid_parent_gid = NULL, nrm_tot = 0;
+  PetscInt         *pos = NULL, *kind = NULL, *claim = NULL, *agg_i = NULL, *agg_j;
   PetscBool        *lid_removed;
   PetscBool         isMPI, isAIJ, isOK;
   const PetscInt   *perm_ix;
@@ -87,85 +203,151 @@ static PetscErrorCode MatCoarsenApply_MIS_private(IS perm, Mat Gmat, PetscBool s
   nremoved = nDone = 0;
 
   PetscCall(ISGetIndices(perm, &perm_ix));
+  if (luby) {
+    PetscCall(PetscMalloc4(nloc, &pos, nloc, &kind, nloc, &claim, nloc + 1, &agg_i));
+    for (kk = 0; kk < nloc; kk++) pos[perm_ix[kk]] = kk;
+  }
   while (nDone < nloc || PETSC_TRUE) { /* asynchronous not implemented */
-    /* check all vertices */
-    for (kk = 0; kk < nloc; kk++) {
-      lid   = perm_ix[kk];
-      state = lid_state[lid];
-      if (lid_removed[lid]) continue;
-      if (state == MIS_NOT_DONE) {
-        /* parallel test, delete if selected ghost */
-        isOK = PETSC_TRUE;
-        if ((ix = lid_cprowID[lid]) != -1) { /* if I have any ghost neighbors */
+    if (luby) {
+      PetscInt sel = -1;
+
+      /* the tests of the greedy sweep that do not depend on the vertices selected during the sweep */
+      PetscPragmaUseOMPKernels(parallel for reduction(max:sel))
+      for (PetscInt v = 0; v < nloc; v++) {
+        const PetscInt cp = lid_cprowID[v], *bi = matB ? matB->compressedrow.i : NULL;
+
+        if (lid_state[v] != MIS_NOT_DONE) kind[v] = MIS_LUBY_DONE;
+        else if (lid_removed[v]) kind[v] = MIS_LUBY_BLOCKED;
+        else {
+          kind[v] = MIS_LUBY_CANDIDATE;
+          if (cp != -1) {
+            for (PetscInt j = bi[cp]; j < bi[cp + 1]; j++) {
+              const PetscInt c = matB->j[j];
+
+              if (MIS_IS_SELECTED(cpcol_state[c])) sel = PetscMax(sel, cpcol_gid[c]);
+              if (cpcol_state[c] == MIS_NOT_DONE && cpcol_gid[c] >= Iend) {
+                kind[v] = MIS_LUBY_BLOCKED;
+                break;
+              }
+            }
+          }
+          if (kind[v] == MIS_LUBY_CANDIDATE && matA->i[v + 1] - matA->i[v] < 2 && (cp == -1 || !(bi[cp + 1] - bi[cp]))) kind[v] = MIS_LUBY_SINGLETON;
+        }
+      }
+      PetscCheck(sel < 0, PETSC_COMM_SELF, PETSC_ERR_SUP, "selected ghost: %" PetscInt_FMT, sel);
+      PetscCall(MatCoarsenMISLuby_Private(nloc, matA->i, matA->j, pos, kind, claim, agg_i, &agg_j));
+      /* same sweep as below, with the vertices selected and their aggregates computed in parallel */
+      for (kk = 0; kk < nloc; kk++) {
+        lid = perm_ix[kk];
+        if (lid_state[lid] != MIS_NOT_DONE || (kind[lid] != MIS_LUBY_CANDIDATE && kind[lid] != MIS_LUBY_SINGLETON)) continue;
+        nDone++;
+        if (kind[lid] == MIS_LUBY_SINGLETON) {
+          nremoved++;
+          nrm_tot++;
+          lid_removed[lid] = PETSC_TRUE;
+          continue;
+        }
+        lid_state[lid] = lid + my0;
+        nselected++;
+        PetscCall(PetscCDAppendID(agg_lists, lid, strict_aggs ? lid + my0 : lid));
+        for (j = agg_i[lid]; j < agg_i[lid + 1]; j++) {
+          lidj = agg_j[j];
+          if (lid_state[lidj] != MIS_NOT_DONE) continue; /* only with a structurally nonsymmetric graph */
+          nDone++;
+          PetscCall(PetscCDAppendID(agg_lists, lid, strict_aggs ? lidj + my0 : lidj));
+          lid_state[lidj] = MIS_DELETED;
+        }
+        if (!strict_aggs && (ix = lid_cprowID[lid]) != -1) {
           ii  = matB->compressedrow.i;
           n   = ii[ix + 1] - ii[ix];
           idx = matB->j + ii[ix];
           for (j = 0; j < n; j++) {
-            cpid   = idx[j]; /* compressed row ID in B mat */
-            gid    = cpcol_gid[cpid];
-            statej = cpcol_state[cpid];
-            PetscCheck(!MIS_IS_SELECTED(statej), PETSC_COMM_SELF, PETSC_ERR_SUP, "selected ghost: %" PetscInt_FMT, gid);
-            if (statej == MIS_NOT_DONE && gid >= Iend) { /* should be (pe>rank), use gid as pe proxy */
-              isOK = PETSC_FALSE;                        /* can not delete */
-              break;
-            }
+            cpid = idx[j];
+            if (cpcol_state[cpid] == MIS_NOT_DONE) PetscCall(PetscCDAppendID(agg_lists, lid, nloc + cpid));
           }
-        } /* parallel test */
-        if (isOK) { /* select or remove this vertex */
-          nDone++;
-          /* check for singleton */
-          ii = matA->i;
-          n  = ii[lid + 1] - ii[lid];
-          if (n < 2) {
-            /* if I have any ghost adj then not a sing */
-            ix = lid_cprowID[lid];
-            if (ix == -1 || !(matB->compressedrow.i[ix + 1] - matB->compressedrow.i[ix])) {
-              nremoved++;
-              nrm_tot++;
-              lid_removed[lid] = PETSC_TRUE;
-              continue;
-              // lid_state[lidj] = MIS_REMOVED; /* add singleton to MIS (can cause low rank with elasticity on fine grid) */
+        }
+      }
+      PetscCall(PetscFree(agg_j));
+    } else {
+      /* check all vertices */
+      for (kk = 0; kk < nloc; kk++) {
+        lid   = perm_ix[kk];
+        state = lid_state[lid];
+        if (lid_removed[lid]) continue;
+        if (state == MIS_NOT_DONE) {
+          /* parallel test, delete if selected ghost */
+          isOK = PETSC_TRUE;
+          if ((ix = lid_cprowID[lid]) != -1) { /* if I have any ghost neighbors */
+            ii  = matB->compressedrow.i;
+            n   = ii[ix + 1] - ii[ix];
+            idx = matB->j + ii[ix];
+            for (j = 0; j < n; j++) {
+              cpid   = idx[j]; /* compressed row ID in B mat */
+              gid    = cpcol_gid[cpid];
+              statej = cpcol_state[cpid];
+              PetscCheck(!MIS_IS_SELECTED(statej), PETSC_COMM_SELF, PETSC_ERR_SUP, "selected ghost: %" PetscInt_FMT, gid);
+              if (statej == MIS_NOT_DONE && gid >= Iend) { /* should be (pe>rank), use gid as pe proxy */
+                isOK = PETSC_FALSE;                        /* can not delete */
+                break;
+              }
             }
-          }
-          /* SELECTED state encoded with global index */
-          lid_state[lid] = lid + my0;
-          nselected++;
-          if (strict_aggs) {
-            PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
-          } else {
-            PetscCall(PetscCDAppendID(agg_lists, lid, lid));
-          }
-          /* delete local adj */
-          idx = matA->j + ii[lid];
-          for (j = 0; j < n; j++) {
-            lidj   = idx[j];
-            statej = lid_state[lidj];
-            if (statej == MIS_NOT_DONE) {
-              nDone++;
-              if (strict_aggs) {
-                PetscCall(PetscCDAppendID(agg_lists, lid, lidj + my0));
-              } else {
-                PetscCall(PetscCDAppendID(agg_lists, lid, lidj));
+          } /* parallel test */
+          if (isOK) { /* select or remove this vertex */
+            nDone++;
+            /* check for singleton */
+            ii = matA->i;
+            n  = ii[lid + 1] - ii[lid];
+            if (n < 2) {
+              /* if I have any ghost adj then not a sing */
+              ix = lid_cprowID[lid];
+              if (ix == -1 || !(matB->compressedrow.i[ix + 1] - matB->compressedrow.i[ix])) {
+                nremoved++;
+                nrm_tot++;
+                lid_removed[lid] = PETSC_TRUE;
+                continue;
+                // lid_state[lidj] = MIS_REMOVED; /* add singleton to MIS (can cause low rank with elasticity on fine grid) */
               }
-              lid_state[lidj] = MIS_DELETED; /* delete this */
             }
-          }
-          /* delete ghost adj of lid - deleted ghost done later for strict_aggs */
-          if (!strict_aggs) {
-            if ((ix = lid_cprowID[lid]) != -1) { /* if I have any ghost neighbors */
-              ii  = matB->compressedrow.i;
-              n   = ii[ix + 1] - ii[ix];
-              idx = matB->j + ii[ix];
-              for (j = 0; j < n; j++) {
-                cpid   = idx[j]; /* compressed row ID in B mat */
-                statej = cpcol_state[cpid];
-                if (statej == MIS_NOT_DONE) PetscCall(PetscCDAppendID(agg_lists, lid, nloc + cpid));
+            /* SELECTED state encoded with global index */
+            lid_state[lid] = lid + my0;
+            nselected++;
+            if (strict_aggs) {
+              PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
+            } else {
+              PetscCall(PetscCDAppendID(agg_lists, lid, lid));
+            }
+            /* delete local adj */
+            idx = matA->j + ii[lid];
+            for (j = 0; j < n; j++) {
+              lidj   = idx[j];
+              statej = lid_state[lidj];
+              if (statej == MIS_NOT_DONE) {
+                nDone++;
+                if (strict_aggs) {
+                  PetscCall(PetscCDAppendID(agg_lists, lid, lidj + my0));
+                } else {
+                  PetscCall(PetscCDAppendID(agg_lists, lid, lidj));
+                }
+                lid_state[lidj] = MIS_DELETED; /* delete this */
               }
             }
-          }
-        } /* selected */
-      } /* not done vertex */
-    } /* vertex loop */
+            /* delete ghost adj of lid - deleted ghost done later for strict_aggs */
+            if (!strict_aggs) {
+              if ((ix = lid_cprowID[lid]) != -1) { /* if I have any ghost neighbors */
+                ii  = matB->compressedrow.i;
+                n   = ii[ix + 1] - ii[ix];
+                idx = matB->j + ii[ix];
+                for (j = 0; j < n; j++) {
+                  cpid   = idx[j]; /* compressed row ID in B mat */
+                  statej = cpcol_state[cpid];
+                  if (statej == MIS_NOT_DONE) PetscCall(PetscCDAppendID(agg_lists, lid, nloc + cpid));
+                }
+              }
+            }
+          } /* selected */
+        } /* not done vertex */
+      } /* vertex loop */
+    }
 
     /* update ghost states and count todos */
     if (isMPI) {
@@ -205,6 +387,7 @@ static PetscErrorCode MatCoarsenApply_MIS_private(IS perm, Mat Gmat, PetscBool s
     } else break; /* all done */
   } /* outer parallel MIS loop */
   PetscCall(ISRestoreIndices(perm, &perm_ix));
+  PetscCall(PetscFree4(pos, kind, claim, agg_i));
   PetscCall(PetscInfo(info_is, "\t removed %" PetscInt_FMT " of %" PetscInt_FMT " vertices.  %" PetscInt_FMT " selected.\n", nremoved, nloc, nselected));
 
   /* tell adj who my lid_parent_gid vertices belong to - fill in agg_lists selected ghost lists */
@@ -260,10 +443,10 @@ static PetscErrorCode MatCoarsenApply_MIS(MatCoarsen coarse)
     PetscCall(PetscObjectGetComm((PetscObject)mat, &comm));
     PetscCall(MatGetLocalSize(mat, &m, &n));
     PetscCall(ISCreateStride(comm, m, 0, 1, &perm));
-    PetscCall(MatCoarsenApply_MIS_private(perm, mat, coarse->strict_aggs, &coarse->agg_lists));
+    PetscCall(MatCoarsenApply_MIS_private(perm, PETSC_FALSE, mat, coarse->strict_aggs, &coarse->agg_lists));
     PetscCall(ISDestroy(&perm));
   } else {
-    PetscCall(MatCoarsenApply_MIS_private(coarse->perm, mat, coarse->strict_aggs, &coarse->agg_lists));
+    PetscCall(MatCoarsenApply_MIS_private(coarse->perm, coarse->luby, mat, coarse->strict_aggs, &coarse->agg_lists));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -38,12 +38,13 @@ static PetscErrorCode PetscCoarsenDataView_private(PetscCoarsenData *agg_lists,
 
   Input Parameter:
    . perm - permutation
+   . luby - select the vertices of the first, permuted, MIS with MatCoarsenMISLuby_Private(), the aggregates are the same
    . Gmat - global matrix of graph (data not defined)
 
   Output Parameter:
    . a_locals_llist - array of list of local nodes rooted at local node
 */
-static PetscErrorCode MatCoarsenApply_MISK_private(IS perm, const PetscInt misk, Mat Gmat, PetscCoarsenData **a_locals_llist)
+static PetscErrorCode MatCoarsenApply_MISK_private(IS perm, PetscBool luby, const PetscInt misk, Mat Gmat, PetscCoarsenData **a_locals_llist)
 {
   PetscBool   isMPI;
   MPI_Comm    comm;
@@ -53,8 +54,8 @@ static PetscErrorCode MatCoarsenApply_MISK_private(IS perm, const PetscInt misk,
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(perm, IS_CLASSID, 1);
-  PetscValidHeaderSpecific(Gmat, MAT_CLASSID, 3);
-  PetscAssertPointer(a_locals_llist, 4);
+  PetscValidHeaderSpecific(Gmat, MAT_CLASSID, 4);
+  PetscAssertPointer(a_locals_llist, 5);
   PetscCheck(misk < 5 && misk > 0, PETSC_COMM_SELF, PETSC_ERR_SUP, "too many/few levels: %" PetscInt_FMT, misk);
   PetscCall(PetscObjectBaseTypeCompare((PetscObject)Gmat, MATMPIAIJ, &isMPI));
   PetscCall(PetscObjectGetComm((PetscObject)Gmat, &comm));
@@ -72,6 +73,7 @@ static PetscErrorCode MatCoarsenApply_MISK_private(IS perm, const PetscInt misk,
     PetscCoarsenData *agg_lists;
     PetscInt         *cpcol_gid = NULL, *cpcol_state, *lid_cprowID, *lid_state, *lid_parent_gid = NULL;
     PetscInt          num_fine_ghosts, kk, n, ix, j, *idx, *ai, Iend, my0, nremoved, gid, cpid, lidj, sgid, t2, slid, nDone, nselected = 0, state;
+    PetscInt         *pos = NULL, *kind = NULL, *claim = NULL, *agg_i = NULL, *agg_j;
     PetscBool        *lid_removed, isOK;
     PetscSF           sf;
 
@@ -123,65 +125,118 @@ static PetscErrorCode MatCoarsenApply_MISK_private(IS perm, const PetscInt misk,
     nremoved = nDone = 0;
     if (!iterIdx) PetscCall(ISGetIndices(perm, &perm_ix)); // use permutation on first MIS
     else perm_ix = NULL;
+    if (luby && perm_ix) {
+      PetscCall(PetscMalloc4(nloc_inner, &pos, nloc_inner, &kind, nloc_inner, &claim, nloc_inner + 1, &agg_i));
+      for (kk = 0; kk < nloc_inner; kk++) pos[perm_ix[kk]] = kk;
+    }
     while (nDone < nloc_inner || PETSC_TRUE) { /* asynchronous not implemented */
-      /* check all vertices */
-      for (kk = 0; kk < nloc_inner; kk++) {
-        const PetscInt lid = perm_ix ? perm_ix[kk] : kk;
-        state              = lid_state[lid];
-        if (iterIdx == 0 && lid_removed[lid]) continue;
-        if (state == MIS_NOT_DONE) {
-          /* parallel test, delete if selected ghost */
-          isOK = PETSC_TRUE;
-          /* parallel test */
-          if ((ix = lid_cprowID[lid]) != -1) { /* if I have any ghost neighbors */
-            ai  = matB->compressedrow.i;
-            n   = ai[ix + 1] - ai[ix];
-            idx = matB->j + ai[ix];
-            for (j = 0; j < n; j++) {
-              cpid = idx[j]; /* compressed row ID in B mat */
-              gid  = cpcol_gid[cpid];
-              if (cpcol_state[cpid] == MIS_NOT_DONE && gid >= Iend) { /* or pe>rank */
-                isOK = PETSC_FALSE;                                   /* can not delete */
-                break;
+      if (pos) {
+        /* the tests of the greedy sweep that do not depend on the vertices selected during the sweep */
+        PetscPragmaUseOMPKernels(parallel for)
+        for (PetscInt v = 0; v < nloc_inner; v++) {
+          const PetscInt cp = lid_cprowID[v], *bi = matB ? matB->compressedrow.i : NULL;
+
+          if (lid_state[v] != MIS_NOT_DONE) kind[v] = MIS_LUBY_DONE;
+          else if (lid_removed[v]) kind[v] = MIS_LUBY_BLOCKED;
+          else {
+            kind[v] = MIS_LUBY_CANDIDATE;
+            if (cp != -1) {
+              for (PetscInt j = bi[cp]; j < bi[cp + 1]; j++) {
+                const PetscInt c = matB->j[j];
+
+                if (cpcol_state[c] == MIS_NOT_DONE && cpcol_gid[c] >= Iend) {
+                  kind[v] = MIS_LUBY_BLOCKED;
+                  break;
+                }
               }
             }
+            if (kind[v] == MIS_LUBY_CANDIDATE && matA->i[v + 1] - matA->i[v] < 2 && (cp == -1 || !(bi[cp + 1] - bi[cp]))) kind[v] = MIS_LUBY_SINGLETON;
+          }
+        }
+        PetscCall(MatCoarsenMISLuby_Private(nloc_inner, matA->i, matA->j, pos, kind, claim, agg_i, &agg_j));
+        /* same sweep as below, with the vertices selected and their aggregates computed in parallel */
+        for (kk = 0; kk < nloc_inner; kk++) {
+          const PetscInt lid = perm_ix[kk];
+
+          if (lid_state[lid] != MIS_NOT_DONE || (kind[lid] != MIS_LUBY_CANDIDATE && kind[lid] != MIS_LUBY_SINGLETON)) continue;
+          nDone++;
+          if (kind[lid] == MIS_LUBY_SINGLETON) {
+            lid_removed[lid] = PETSC_TRUE;
+            nremoved++;
+            continue;
           }
-          if (isOK) { /* select or remove this vertex if it is a true singleton like a BC */
+          lid_state[lid] = nselected;
+          nselected++;
+          PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
+          for (j = agg_i[lid]; j < agg_i[lid + 1]; j++) {
+            lidj = agg_j[j];
+            if (lid_state[lidj] != MIS_NOT_DONE) continue; /* only with a structurally nonsymmetric graph */
             nDone++;
-            /* check for singleton */
-            ai = matA->i;
-            n  = ai[lid + 1] - ai[lid];
-            if (n < 2) {
-              /* if I have any ghost adj then not a singleton */
-              ix = lid_cprowID[lid];
-              if (ix == -1 || !(matB->compressedrow.i[ix + 1] - matB->compressedrow.i[ix])) {
-                if (iterIdx == 0) {
-                  lid_removed[lid] = PETSC_TRUE;
-                  nremoved++; // let it get selected
+            PetscCall(PetscCDAppendID(agg_lists, lid, lidj + my0));
+            lid_state[lidj] = MIS_DELETED;
+          }
+        }
+        PetscCall(PetscFree(agg_j));
+      } else {
+        /* check all vertices */
+        for (kk = 0; kk < nloc_inner; kk++) {
+          const PetscInt lid = perm_ix ? perm_ix[kk] : kk;
+          state              = lid_state[lid];
+          if (iterIdx == 0 && lid_removed[lid]) continue;
+          if (state == MIS_NOT_DONE) {
+            /* parallel test, delete if selected ghost */
+            isOK = PETSC_TRUE;
+            /* parallel test */
+            if ((ix = lid_cprowID[lid]) != -1) { /* if I have any ghost neighbors */
+              ai  = matB->compressedrow.i;
+              n   = ai[ix + 1] - ai[ix];
+              idx = matB->j + ai[ix];
+              for (j = 0; j < n; j++) {
+                cpid = idx[j]; /* compressed row ID in B mat */
+                gid  = cpcol_gid[cpid];
+                if (cpcol_state[cpid] == MIS_NOT_DONE && gid >= Iend) { /* or pe>rank */
+                  isOK = PETSC_FALSE;                                   /* can not delete */
+                  break;
                 }
-                // PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
-                // lid_state[lid] = nselected; // >= 0  is selected, cache for ordering coarse grid
-                /* should select this because it is technically in the MIS but lets not */
-                continue; /* one local adj (me) and no ghost - singleton */
               }
             }
-            /* SELECTED state encoded with global index */
-            lid_state[lid] = nselected; // >= 0  is selected, cache for ordering coarse grid
-            nselected++;
-            PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
-            /* delete local adj */
-            idx = matA->j + ai[lid];
-            for (j = 0; j < n; j++) {
-              lidj = idx[j];
-              if (lid_state[lidj] == MIS_NOT_DONE) {
-                nDone++;
-                PetscCall(PetscCDAppendID(agg_lists, lid, lidj + my0));
-                lid_state[lidj] = MIS_DELETED; /* delete this */
+            if (isOK) { /* select or remove this vertex if it is a true singleton like a BC */
+              nDone++;
+              /* check for singleton */
+              ai = matA->i;
+              n  = ai[lid + 1] - ai[lid];
+              if (n < 2) {
+                /* if I have any ghost adj then not a singleton */
+                ix = lid_cprowID[lid];
+                if (ix == -1 || !(matB->compressedrow.i[ix + 1] - matB->compressedrow.i[ix])) {
+                  if (iterIdx == 0) {
+                    lid_removed[lid] = PETSC_TRUE;
+                    nremoved++; // let it get selected
+                  }
+                  // PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
+                  // lid_state[lid] = nselected; // >= 0  is selected, cache for ordering coarse grid
+                  /* should select this because it is technically in the MIS but lets not */
+                  continue; /* one local adj (me) and no ghost - singleton */
+                }
               }
-            }
-          } /* selected */
-        } /* not done vertex */
-      } /* vertex loop */
+              /* SELECTED state encoded with global index */
+              lid_state[lid] = nselected; // >= 0  is selected, cache for ordering coarse grid
+              nselected++;
+              PetscCall(PetscCDAppendID(agg_lists, lid, lid + my0));
+              /* delete local adj */
+              idx = matA->j + ai[lid];
+              for (j = 0; j < n; j++) {
+                lidj = idx[j];
+                if (lid_state[lidj] == MIS_NOT_DONE) {
+                  nDone++;
+                  PetscCall(PetscCDAppendID(agg_lists, lid, lidj + my0));
+                  lid_state[lidj] = MIS_DELETED; /* delete this */
+                }
+              }
+            } /* selected */
+          } /* not done vertex */
+        } /* vertex loop */
+      }
 
       /* update ghost states and count todos */
       if (isMPI) {
@@ -215,6 +270,7 @@ static PetscErrorCode MatCoarsenApply_MISK_private(IS perm, const PetscInt misk,
       } else break; /* no mpi - all done */
     } /* outer parallel MIS loop */
     if (!iterIdx) PetscCall(ISRestoreIndices(perm, &perm_ix));
+    PetscCall(PetscFree4(pos, kind, claim, agg_i));
     PetscCall(PetscInfo(Gmat, "\t removed %" PetscInt_FMT " of %" PetscInt_FMT " vertices.  %" PetscInt_FMT " selected.\n", nremoved, nloc_inner, nselected));
 
     /* tell adj who my lid_parent_gid vertices belong to - fill in agg_lists selected ghost lists */
@@ -360,10 +416,10 @@ static PetscErrorCode MatCoarsenApply_MISK(MatCoarsen coarse)
 
     PetscCall(MatGetLocalSize(mat, &m, &n));
     PetscCall(ISCreateStride(PetscObjectComm((PetscObject)mat), m, 0, 1, &perm));
-    PetscCall(MatCoarsenApply_MISK_private(perm, k, mat, &coarse->agg_lists));
+    PetscCall(MatCoarsenApply_MISK_private(perm, PETSC_FALSE, k, mat, &coarse->agg_lists));
     PetscCall(ISDestroy(&perm));
   } else {
-    PetscCall(MatCoarsenApply_MISK_private(coarse->perm, k, mat, &coarse->agg_lists));
+    PetscCall(MatCoarsenApply_MISK_private(coarse->perm, coarse->luby, k, mat, &coarse->agg_lists));
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
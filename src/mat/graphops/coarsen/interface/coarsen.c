@@ -140,6 +140,44 @@ PetscErrorCode MatCoarsenSetStrictAggs(MatCoarsen agg, PetscBool str)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  MatCoarsenSetLuby - Set whether the greedy `MATCOARSENMIS` and `MATCOARSENMISK` coarsenings select the vertices of each sweep with a
+  parallel Luby-style algorithm within each process
+
+  Logically Collective
+
+  Input Parameters:
++ coarse - the coarsen context
+- flg    - `PETSC_TRUE` to use the Luby-style selection
+
+  Options Database Key:
+. -mat_coarsen_luby (true|false) - use the Luby-style selection
+
+  Level: advanced
+
+  Notes:
+  The position of each vertex in the ordering set with `MatCoarsenSetGreedyOrdering()`, a random permutation seeded by `PCGAMG`, serves as
+  the random weight of Luby's algorithm, which then selects exactly the vertices of the greedy sweep in this ordering. The aggregates
+  are therefore the same as with the serial sweep, for any number of OpenMP threads, when the graph is structurally symmetric, which
+  is the case of the graphs of `PCGAMG` unless `PCGAMGSetGraphSymmetrize()` turned off the symmetrization. The parallelism comes from
+  `PetscPragmaUseOMPKernels()` and this is on by default when PETSc is configured with `--with-openmp-kernels`.
+
+  It is only used when an ordering was set, since the number of rounds of the algorithm is large for the natural ordering, and only for
+  the first, permuted, sweep of `MATCOARSENMISK`.
+
+  When the coarsening is used inside `PCGAMG` then the options database keys are prefixed with `-pc_gamg_`
+
+.seealso: `MatCoarsen`, `MatCoarsenSetGreedyOrdering()`, `MATCOARSENMIS`, `MATCOARSENMISK`, `MatCoarsenSetFromOptions()`
+@*/
+PetscErrorCode MatCoarsenSetLuby(MatCoarsen coarse, PetscBool flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(coarse, MAT_COARSEN_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(coarse, flg, 2);
+  coarse->luby = flg;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   MatCoarsenDestroy - Destroys the coarsen context.
 
@@ -337,7 +375,8 @@ PetscErrorCode MatCoarsenGetData(MatCoarsen coarser, PetscCoarsenData **llist)
   Options Database Key:
 + -mat_coarsen_type  (mis|hem|misk) - see `MatCoarsenType`
 . -mat_coarsen_max_it its           - number of iterations to use in the coarsening process, see `MatCoarsenSetMaximumIterations()`
-- -mat_coarsen_threshold threshold  - see `MatCoarsenSetThreshold()`, for `MATCOARSENHEM` only
+. -mat_coarsen_threshold threshold  - see `MatCoarsenSetThreshold()`, for `MATCOARSENHEM` only
+- -mat_coarsen_luby (true|false)    - see `MatCoarsenSetLuby()`, for `MATCOARSENMIS` and `MATCOARSENMISK`
 
   Level: advanced
 
@@ -347,7 +386,7 @@ PetscErrorCode MatCoarsenGetData(MatCoarsen coarser, PetscCoarsenData **llist)
   Sets the `MatCoarsenType` to `MATCOARSENMISK` if has not been set previously
 
 .seealso: `MatCoarsen`, `MatCoarsenType`, `MatCoarsenApply()`, `MatCoarsenCreate()`, `MatCoarsenSetType()`,
-          `MatCoarsenSetMaximumIterations()`, `MATCOARSENHEM`, `MATCOARSENMIS`, `MATCOARSENMISK`
+          `MatCoarsenSetMaximumIterations()`, `MatCoarsenSetLuby()`, `MATCOARSENHEM`, `MATCOARSENMIS`, `MATCOARSENMISK`
 @*/
 PetscErrorCode MatCoarsenSetFromOptions(MatCoarsen coarser)
 {
@@ -367,6 +406,7 @@ PetscErrorCode MatCoarsenSetFromOptions(MatCoarsen coarser)
 
   PetscCall(PetscOptionsInt("-mat_coarsen_max_it", "Number of iterations (for HEM)", "MatCoarsenSetMaximumIterations", coarser->max_it, &coarser->max_it, NULL));
   PetscCall(PetscOptionsReal("-mat_coarsen_threshold", "Threshold (for HEM)", "MatCoarsenSetThreshold", coarser->threshold, &coarser->threshold, NULL));
+  PetscCall(PetscOptionsBool("-mat_coarsen_luby", "Select the vertices of each greedy sweep in parallel (for MIS and MISK)", "MatCoarsenSetLuby", coarser->luby, &coarser->luby, NULL));
   coarser->strength_index_size = MAT_COARSEN_STRENGTH_INDEX_SIZE;
   PetscCall(PetscOptionsIntArray("-mat_coarsen_strength_index", "Array of indices to use strength of connection measure (default is all indices)", "MatCoarsenSetStrengthIndex", coarser->strength_index, &coarser->strength_index_size, NULL));
   /*
@@ -518,6 +558,7 @@ PetscErrorCode MatCoarsenCreate(MPI_Comm comm, MatCoarsen *newcrs)
   PetscCall(PetscObjectComposeFunction((PetscObject)agg, "MatCoarsenSetThreshold_C", MatCoarsenSetThreshold_MATCOARSEN));
   PetscCall(PetscObjectComposeFunction((PetscObject)agg, "MatCoarsenSetStrengthIndex_C", MatCoarsenSetStrengthIndex_MATCOARSEN));
   agg->strength_index_size = 0;
+  agg->luby                = PetscDefined(USE_OPENMP_KERNELS) ? PETSC_TRUE : PETSC_FALSE;
   *newcrs                  = agg;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
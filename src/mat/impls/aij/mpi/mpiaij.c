@@ -64,6 +64,7 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatStoreValues_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatRetrieveValues_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatGetMultPetscSF_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatJacobiPolynomialUpdate_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatIsTranspose_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetPreallocation_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatResetPreallocation_C", NULL));
@@ -1060,6 +1061,23 @@ static PetscErrorCode MatMult_MPIAIJ(Mat A, Vec xx, Vec yy)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* the products of the diagonal block are computed in z while the off-process entries of v arrive */
+static PetscErrorCode MatJacobiPolynomialUpdate_MPIAIJ(Mat A, Vec dinv, Vec v, Vec s, Vec r, PetscScalar alpha, Vec w, PetscScalar beta, PetscScalar gamma, Vec z, PetscScalar delta, Vec x)
+{
+  Mat_MPIAIJ *a = (Mat_MPIAIJ *)A->data;
+  Mat_SeqAIJ *b = (Mat_SeqAIJ *)a->B->data;
+
+  PetscFunctionBegin;
+  PetscCall(VecScatterBegin(a->Mvctx, v, a->lvec, INSERT_VALUES, SCATTER_FORWARD));
+  PetscUseTypeMethod(a->A, mult, v, z);
+  PetscCall(VecScatterEnd(a->Mvctx, v, a->lvec, INSERT_VALUES, SCATTER_FORWARD));
+  if (b->inode.use && b->inode.checked) {
+    PetscUseTypeMethod(a->B, multadd, a->lvec, z, z);
+    PetscCall(MatJacobiPolynomialUpdate_SeqAIJ_Private(NULL, NULL, PETSC_TRUE, dinv, v, s, r, alpha, w, beta, gamma, z, delta, x));
+  } else PetscCall(MatJacobiPolynomialUpdate_SeqAIJ_Private(a->B, a->lvec, PETSC_TRUE, dinv, v, s, r, alpha, w, beta, gamma, z, delta, x));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatMultDiagonalBlock_MPIAIJ(Mat A, Vec bb, Vec xx)
 {
   Mat_MPIAIJ *a = (Mat_MPIAIJ *)A->data;
@@ -6924,6 +6942,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetPreallocationCOO_C", MatSetPreallocationCOO_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetValuesCOO_C", MatSetValuesCOO_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatGetMultPetscSF_C", MatGetMultPetscSF_MPIAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatJacobiPolynomialUpdate_C", MatJacobiPolynomialUpdate_MPIAIJ));
   PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATMPIAIJ));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -7825,9 +7844,7 @@ PETSC_INTERN PetscErrorCode MatCreateGraph_Simple_AIJ(Mat Amat, PetscBool symmet
     PetscCall(MatSetSizes(Gmat, nloc, nloc, PETSC_DETERMINE, PETSC_DETERMINE));
     PetscCall(MatSetBlockSizes(Gmat, 1, 1));
     if (isseqaij || ((Mat_MPIAIJ *)Amat->data)->garray) {
-      PetscInt  *d_nnz, *o_nnz;
-      MatScalar *aa, val, *AA;
-      PetscInt  *aj, *ai, *AJ, nc, nmax = 0;
+      PetscInt *d_nnz, *o_nnz;
 
       if (isseqaij) {
         a = Amat;
@@ -7847,7 +7864,6 @@ PETSC_INTERN PetscErrorCode MatCreateGraph_Simple_AIJ(Mat Amat, PetscBool symmet
           PetscCall(MatGetRow(c, brow, &nc2, &cols2, NULL));
           nnz[brow / bs] = nc2 / bs;
           if (nc2 % bs) ok = 0;
-          if (nnz[brow / bs] > nmax) nmax = nnz[brow / bs];
           for (PetscInt ii = 1; ii < bs; ii++) { // check for non-dense blocks
             PetscCall(MatGetRow(c, brow + ii, &nc1, &cols1, NULL));
             if (nc1 != nc2) ok = 0;
@@ -7869,88 +7885,56 @@ PETSC_INTERN PetscErrorCode MatCreateGraph_Simple_AIJ(Mat Amat, PetscBool symmet
       }
       PetscCall(MatSeqAIJSetPreallocation(Gmat, 0, d_nnz));
       PetscCall(MatMPIAIJSetPreallocation(Gmat, 0, d_nnz, 0, o_nnz));
-      PetscCall(PetscFree2(d_nnz, o_nnz));
-      PetscCall(PetscMalloc2(nmax, &AA, nmax, &AJ));
-      // diag
-      for (PetscInt brow = 0, n, grow; brow < nloc * bs; brow += bs) { // block rows
-        Mat_SeqAIJ *aseq = (Mat_SeqAIJ *)a->data;
-
-        ai = aseq->i;
-        n  = ai[brow + 1] - ai[brow];
-        aj = aseq->j + ai[brow];
-        for (PetscInt k = 0; k < n; k += bs) {   // block columns
-          AJ[k / bs] = aj[k] / bs + Istart / bs; // diag starts at (Istart,Istart)
-          val        = 0;
-          if (index_size == 0) {
-            for (PetscInt ii = 0; ii < bs; ii++) { // rows in block
-              aa = aseq->a + ai[brow + ii] + k;
-              for (PetscInt jj = 0; jj < bs; jj++) {    // columns in block
-                val += PetscAbs(PetscRealPart(aa[jj])); // a sort of norm
+      /* compute the rows of the diagonal and off-diagonal parts of the graph independently, then insert them */
+      for (c = a, kk = 0; c && kk < 2; c = b, kk++) {
+        const PetscInt  *nnz = (c == a) ? d_nnz : o_nnz, *garray = (c == a) ? NULL : ((Mat_MPIAIJ *)Amat->data)->garray;
+        const PetscInt  *ci = ((Mat_SeqAIJ *)c->data)->i, *cj = ((Mat_SeqAIJ *)c->data)->j;
+        const MatScalar *ca;
+        PetscInt        *gi, *gj;
+        MatScalar       *ga;
+
+        PetscCall(MatSeqAIJGetArrayRead(c, &ca));
+        PetscCall(PetscMalloc1(nloc + 1, &gi));
+        for (gi[0] = 0, Ii = 0; Ii < nloc; Ii++) gi[Ii + 1] = gi[Ii] + nnz[Ii];
+        PetscCall(PetscMalloc2(gi[nloc], &gj, gi[nloc], &ga));
+        PetscPragmaUseOMPKernels(parallel for schedule(static))
+        for (PetscInt brow = 0; brow < nloc * bs; brow += bs) { // block rows
+          PetscInt  *AJ = gj + gi[brow / bs];
+          MatScalar *AA = ga + gi[brow / bs];
+
+          for (PetscInt k = 0; k < ci[brow + 1] - ci[brow]; k += bs) { // block columns
+            const PetscInt col = cj[ci[brow] + k];
+            MatScalar      val = 0;
+
+            AJ[k / bs] = garray ? garray[col] / bs : col / bs + Istart / bs; // diag starts at (Istart,Istart)
+            if (index_size == 0) {
+              for (PetscInt ii = 0; ii < bs; ii++) { // rows in block
+                const MatScalar *aa = ca + ci[brow + ii] + k;
+
+                for (PetscInt jj = 0; jj < bs; jj++) val += PetscAbs(PetscRealPart(aa[jj])); // a sort of norm
               }
-            }
-          } else {                                            // use (index,index) value if provided
-            for (PetscInt iii = 0; iii < index_size; iii++) { // rows in block
-              PetscInt ii = index[iii];
-              aa          = aseq->a + ai[brow + ii] + k;
-              for (PetscInt jjj = 0; jjj < index_size; jjj++) { // columns in block
-                PetscInt jj = index[jjj];
-                val += PetscAbs(PetscRealPart(aa[jj]));
+            } else {                                            // use (index,index) value if provided
+              for (PetscInt iii = 0; iii < index_size; iii++) { // rows in block
+                const MatScalar *aa = ca + ci[brow + index[iii]] + k;
+
+                for (PetscInt jjj = 0; jjj < index_size; jjj++) val += PetscAbs(PetscRealPart(aa[index[jjj]])); // columns in block
               }
             }
+            AA[k / bs] = val;
           }
-          PetscAssert(k / bs < nmax, comm, PETSC_ERR_USER, "k / bs (%" PetscInt_FMT ") >= nmax (%" PetscInt_FMT ")", k / bs, nmax);
-          AA[k / bs] = val;
         }
-        grow = Istart / bs + brow / bs;
-        PetscCall(MatSetValues(Gmat, 1, &grow, n / bs, AJ, AA, ADD_VALUES));
-      }
-      // off-diag
-      if (ismpiaij) {
-        Mat_MPIAIJ        *aij = (Mat_MPIAIJ *)Amat->data;
-        const PetscScalar *vals;
-        const PetscInt    *cols, *garray = aij->garray;
-
-        PetscCheck(garray, PETSC_COMM_SELF, PETSC_ERR_USER, "No garray ?");
-        for (PetscInt brow = 0, grow; brow < nloc * bs; brow += bs) { // block rows
-          PetscCall(MatGetRow(b, brow, &ncols, &cols, NULL));
-          for (PetscInt k = 0, cidx = 0; k < ncols; k += bs, cidx++) {
-            PetscAssert(k / bs < nmax, comm, PETSC_ERR_USER, "k / bs >= nmax");
-            AA[k / bs] = 0;
-            AJ[cidx]   = garray[cols[k]] / bs;
-          }
-          nc = ncols / bs;
-          PetscCall(MatRestoreRow(b, brow, &ncols, &cols, NULL));
-          if (index_size == 0) {
-            for (PetscInt ii = 0; ii < bs; ii++) { // rows in block
-              PetscCall(MatGetRow(b, brow + ii, &ncols, &cols, &vals));
-              for (PetscInt k = 0; k < ncols; k += bs) {
-                for (PetscInt jj = 0; jj < bs; jj++) { // cols in block
-                  PetscAssert(k / bs < nmax, comm, PETSC_ERR_USER, "k / bs (%" PetscInt_FMT ") >= nmax (%" PetscInt_FMT ")", k / bs, nmax);
-                  AA[k / bs] += PetscAbs(PetscRealPart(vals[k + jj]));
-                }
-              }
-              PetscCall(MatRestoreRow(b, brow + ii, &ncols, &cols, &vals));
-            }
-          } else {                                            // use (index,index) value if provided
-            for (PetscInt iii = 0; iii < index_size; iii++) { // rows in block
-              PetscInt ii = index[iii];
-              PetscCall(MatGetRow(b, brow + ii, &ncols, &cols, &vals));
-              for (PetscInt k = 0; k < ncols; k += bs) {
-                for (PetscInt jjj = 0; jjj < index_size; jjj++) { // cols in block
-                  PetscInt jj = index[jjj];
-                  AA[k / bs] += PetscAbs(PetscRealPart(vals[k + jj]));
-                }
-              }
-              PetscCall(MatRestoreRow(b, brow + ii, &ncols, &cols, &vals));
-            }
-          }
-          grow = Istart / bs + brow / bs;
-          PetscCall(MatSetValues(Gmat, 1, &grow, nc, AJ, AA, ADD_VALUES));
+        PetscCall(MatSeqAIJRestoreArrayRead(c, &ca));
+        for (Ii = 0; Ii < nloc; Ii++) {
+          const PetscInt grow = Istart / bs + Ii;
+
+          PetscCall(MatSetValues(Gmat, 1, &grow, nnz[Ii], gj + gi[Ii], ga + gi[Ii], ADD_VALUES));
         }
+        PetscCall(PetscFree2(gj, ga));
+        PetscCall(PetscFree(gi));
       }
+      PetscCall(PetscFree2(d_nnz, o_nnz));
       PetscCall(MatAssemblyBegin(Gmat, MAT_FINAL_ASSEMBLY));
       PetscCall(MatAssemblyEnd(Gmat, MAT_FINAL_ASSEMBLY));
-      PetscCall(PetscFree2(AA, AJ));
     } else {
       const PetscScalar *vals;
       const PetscInt    *idx;
@@ -8040,7 +8024,8 @@ PETSC_INTERN PetscErrorCode MatCreateGraph_Simple_AIJ(Mat Amat, PetscBool symmet
 
         PetscCall(MatGetInfo(c, MAT_LOCAL, &info));
         PetscCall(MatSeqAIJGetArray(c, &avals));
-        for (int jj = 0; jj < info.nz_used; jj++) avals[jj] = PetscAbsScalar(avals[jj]);
+        PetscPragmaUseOMPKernels(parallel for)
+        for (PetscInt jj = 0; jj < (PetscInt)info.nz_used; jj++) avals[jj] = PetscAbsScalar(avals[jj]);
         PetscCall(MatSeqAIJRestoreArray(c, &avals));
       }
     }
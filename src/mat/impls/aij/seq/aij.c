@@ -1288,7 +1288,9 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSeqAIJKron_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSetPreallocationCOO_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSetValuesCOO_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatJacobiPolynomialUpdate_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatFactorGetSolverType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatFactorCopySymbolic_C", NULL));
   /* these calls do not belong here: the subclasses Duplicate/Destroy are wrong */
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsell_seqaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijperm_seqaij_C", NULL));
@@ -1657,6 +1659,89 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A, Vec xx, Vec yy, Vec zz)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   Computes, in a single sweep over the rows of A,
+
+     r = s - (z + A xx)       z = 0 when add is false
+     z = alpha w + beta v + gamma D r
+     x = x + delta z
+
+   where D is the diagonal matrix with entries dinv and w and x may be NULL. With A = NULL the products must
+   have been computed in z; the parallel matrices pass their off-process block to add its products to those of the diagonal block. This is the residual, Jacobi and solution
+   update of a polynomial smoother such as KSPCHEBYSHEV with PCJACOBI; the arithmetic of each entry is that
+   of the separate MatMult(), VecAYPX(), VecPointwiseMult() and VecAXPBYPCZ() calls it replaces.
+*/
+PetscErrorCode MatJacobiPolynomialUpdate_SeqAIJ_Private(Mat A, Vec xx, PetscBool add, Vec dinv, Vec v, Vec s, Vec r, PetscScalar alpha, Vec w, PetscScalar beta, PetscScalar gamma, Vec z, PetscScalar delta, Vec x)
+{
+  const PetscScalar *xa = NULL, *da, *va, *sa, *wa = NULL;
+  const MatScalar   *a_a = NULL;
+  const PetscInt    *ii = NULL, *jj = NULL;
+  PetscScalar       *ra, *za, *xxa = NULL;
+  PetscInt           m;
+
+  PetscFunctionBegin;
+  PetscCheck(A || add, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Needs a matrix or the products in z");
+  PetscCall(VecGetLocalSize(r, &m));
+  if (A) {
+    Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+    PetscCheck(A->rmap->n == m, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Incompatible local sizes of A (%" PetscInt_FMT ") and r (%" PetscInt_FMT ")", A->rmap->n, m);
+    PetscCall(MatSeqAIJGetArrayRead(A, &a_a));
+    PetscCall(VecGetArrayRead(xx, &xa));
+    ii = a->i;
+    jj = a->j;
+  }
+  PetscCall(VecGetArrayRead(dinv, &da));
+  PetscCall(VecGetArrayRead(v, &va));
+  if (s != r) PetscCall(VecGetArrayRead(s, &sa));
+  if (w) PetscCall(VecGetArrayRead(w, &wa));
+  PetscCall(VecGetArray(r, &ra));
+  if (s == r) sa = ra;
+  PetscCall(VecGetArray(z, &za));
+  if (x) PetscCall(VecGetArray(x, &xxa));
+  PetscPragmaUseOMPKernels(parallel for)
+  for (PetscInt i = 0; i < m; i++) {
+    PetscScalar sum = add ? za[i] : 0.0, t;
+
+    if (A) {
+      PetscInt           n  = ii[i + 1] - ii[i];
+      const PetscInt    *aj = jj + ii[i];
+      const PetscScalar *aa = a_a + ii[i];
+
+      PetscSparseDensePlusDot(sum, xa, aa, aj, n);
+    }
+    ra[i] = sa[i] - sum;
+    t     = ra[i] * da[i];
+    za[i] = wa ? alpha * wa[i] + beta * va[i] + gamma * t : beta * va[i] + gamma * t;
+    if (xxa) xxa[i] += delta * za[i];
+  }
+  PetscCall(PetscLogFlops((A ? 2.0 * ((Mat_SeqAIJ *)A->data)->nz : 0.0) + (w ? 7.0 : 5.0) * m + (x ? 2.0 * m : 0.0)));
+  if (x) PetscCall(VecRestoreArray(x, &xxa));
+  PetscCall(VecRestoreArray(z, &za));
+  PetscCall(VecRestoreArray(r, &ra));
+  if (w) PetscCall(VecRestoreArrayRead(w, &wa));
+  if (s != r) PetscCall(VecRestoreArrayRead(s, &sa));
+  PetscCall(VecRestoreArrayRead(v, &va));
+  PetscCall(VecRestoreArrayRead(dinv, &da));
+  if (A) {
+    PetscCall(VecRestoreArrayRead(xx, &xa));
+    PetscCall(MatSeqAIJRestoreArrayRead(A, &a_a));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatJacobiPolynomialUpdate_SeqAIJ(Mat A, Vec dinv, Vec v, Vec s, Vec r, PetscScalar alpha, Vec w, PetscScalar beta, PetscScalar gamma, Vec z, PetscScalar delta, Vec x)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  if (a->inode.use && a->inode.checked) { /* keep the summation order of the inode product */
+    PetscCall(MatMult_SeqAIJ_Inode(A, v, z));
+    PetscCall(MatJacobiPolynomialUpdate_SeqAIJ_Private(NULL, NULL, PETSC_TRUE, dinv, v, s, r, alpha, w, beta, gamma, z, delta, x));
+  } else PetscCall(MatJacobiPolynomialUpdate_SeqAIJ_Private(A, v, PETSC_FALSE, dinv, v, s, r, alpha, w, beta, gamma, z, delta, x));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatShift_SeqAIJ(Mat A, PetscScalar v)
 {
   Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
@@ -4831,6 +4916,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSeqAIJKron_C", MatSeqAIJKron_SeqAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetPreallocationCOO_C", MatSetPreallocationCOO_SeqAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetValuesCOO_C", MatSetValuesCOO_SeqAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatJacobiPolynomialUpdate_C", MatJacobiPolynomialUpdate_SeqAIJ));
   PetscCall(MatCreate_SeqAIJ_Inode(B));
   PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ));
   PetscCall(MatSeqAIJSetTypeFromOptions(B)); /* this allows changing the matrix subtype to say MATSEQAIJPERM */
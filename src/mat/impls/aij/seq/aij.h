@@ -326,6 +326,7 @@ PETSC_INTERN PetscErrorCode MatMult_SeqAIJ(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqAIJ_Inode(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatJacobiPolynomialUpdate_SeqAIJ_Private(Mat, Vec, PetscBool, Vec, Vec, Vec, Vec, PetscScalar, Vec, PetscScalar, PetscScalar, Vec, PetscScalar, Vec);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat, Vec, PetscReal, MatSORType, PetscReal, PetscInt, PetscInt, Vec);
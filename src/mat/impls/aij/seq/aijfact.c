@@ -10,6 +10,81 @@ static PetscErrorCode MatFactorGetSolverType_petsc(Mat A, MatSolverType *type)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+typedef struct {
+  PetscInt *i, *j;
+} MatFactorSymbolicIJ_SeqAIJ;
+
+static PetscErrorCode MatFactorSymbolicIJDestroy_SeqAIJ(PetscCtxRt data)
+{
+  MatFactorSymbolicIJ_SeqAIJ *ij = *(MatFactorSymbolicIJ_SeqAIJ **)data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscShmgetDeallocateArray((void **)&ij->j));
+  PetscCall(PetscShmgetDeallocateArray((void **)&ij->i));
+  PetscCall(PetscFree(ij));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Gives fact the symbolic LU or ILU factorization of A computed in ref, the row and column indices are not copied but
+   shared with ref. They are handed over to a reference counted container composed with both factors, and freed with it.
+*/
+static PetscErrorCode MatFactorCopySymbolic_SeqAIJ(Mat fact, Mat A, Mat ref)
+{
+  Mat_SeqAIJ                 *a = (Mat_SeqAIJ *)A->data, *r = (Mat_SeqAIJ *)ref->data, *b;
+  PetscInt                    n = A->rmap->n;
+  PetscContainer              container;
+  MatFactorSymbolicIJ_SeqAIJ *ij = NULL;
+
+  PetscFunctionBegin;
+  PetscCheck(ref->factortype == fact->factortype && ref->rmap->n == n, PETSC_COMM_SELF, PETSC_ERR_ARG_INCOMP, "Factored matrices of different types or sizes");
+  PetscCheck(r->i && r->diag, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Symbolic factorization has not been computed");
+  PetscCall(PetscObjectQuery((PetscObject)ref, "MatFactorSymbolic_IJ", (PetscObject *)&container));
+  if (container) PetscCall(PetscContainerGetPointer(container, &ij));
+  if (!ij || ij->i != r->i) {
+    PetscCheck(r->free_ij, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Row and column indices of the symbolic factorization are not owned by the factored matrix");
+    PetscCall(PetscNew(&ij));
+    ij->i = r->i;
+    ij->j = r->j;
+    PetscCall(PetscContainerCreate(PETSC_COMM_SELF, &container));
+    PetscCall(PetscContainerSetPointer(container, ij));
+    PetscCall(PetscContainerSetCtxDestroy(container, MatFactorSymbolicIJDestroy_SeqAIJ));
+    PetscCall(PetscObjectCompose((PetscObject)ref, "MatFactorSymbolic_IJ", (PetscObject)container));
+    PetscCall(PetscContainerDestroy(&container));
+    r->free_ij = PETSC_FALSE;
+    PetscCall(PetscObjectQuery((PetscObject)ref, "MatFactorSymbolic_IJ", (PetscObject *)&container));
+  }
+  PetscCall(MatSeqAIJSetPreallocation_SeqAIJ(fact, MAT_SKIP_ALLOCATION, NULL));
+  b          = (Mat_SeqAIJ *)fact->data;
+  b->free_ij = PETSC_FALSE;
+  b->i       = r->i;
+  b->j       = r->j;
+  PetscCall(PetscObjectCompose((PetscObject)fact, "MatFactorSymbolic_IJ", (PetscObject)container));
+  PetscCall(PetscShmgetAllocateArray(r->nz, sizeof(PetscScalar), (void **)&b->a));
+  b->free_a = PETSC_TRUE;
+  PetscCall(PetscMalloc1(n + 1, &b->diag));
+  PetscCall(PetscArraycpy(b->diag, r->diag, n + 1));
+  b->ilen = NULL;
+  b->imax = NULL;
+  b->row  = r->row;
+  b->col  = r->col;
+  b->icol = r->icol;
+  PetscCall(PetscObjectReference((PetscObject)b->row));
+  PetscCall(PetscObjectReference((PetscObject)b->col));
+  PetscCall(PetscObjectReference((PetscObject)b->icol));
+  PetscCall(PetscMalloc1(n, &b->solve_work));
+  b->maxnz = b->nz = r->nz;
+
+  fact->info.factor_mallocs    = 0;
+  fact->info.fill_ratio_given  = ref->info.fill_ratio_given;
+  fact->info.fill_ratio_needed = ref->info.fill_ratio_needed;
+  fact->ops->lufactornumeric   = MatLUFactorNumeric_SeqAIJ;
+  if (a->inode.size_csr) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
+  PetscCall(MatSeqAIJCheckInode_FactorLU(fact));
+  PetscCall(PetscObjectStateIncrease((PetscObject)fact));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A, MatFactorType ftype, Mat *B)
 {
   PetscInt n = A->rmap->n;
@@ -28,6 +103,7 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A, MatFactorType ftype
 
     (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJ;
     (*B)->ops->lufactorsymbolic  = MatLUFactorSymbolic_SeqAIJ;
+    PetscCall(PetscObjectComposeFunction((PetscObject)*B, "MatFactorCopySymbolic_C", MatFactorCopySymbolic_SeqAIJ));
 
     PetscCall(MatSetBlockSizesFromMats(*B, A, A));
     PetscCall(PetscStrallocpy(MATORDERINGND, (char **)&(*B)->preferredordering[MAT_FACTOR_LU]));
@@ -0,0 +1,416 @@
+/*
+   Incomplete LU factorization computed with fixed-point sweeps over the nonzeros of the factors, as in Chow and Patel (2015).
+
+   The factors are applied with Jacobi iterations on the triangular systems. For a MATMPIAIJ matrix the diagonal block is factored,
+   as with block Jacobi, and each process works on its own rows without communication.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+typedef struct {
+  PetscInt     sweeps;                     /* number of fixed-point sweeps of the factorization */
+  PetscInt     its;                        /* number of Jacobi iterations of the triangular solves, 0 for exact solves */
+  PetscInt     n, nza;                     /* number of rows and nonzeros of the (diagonal block of the) matrix */
+  PetscInt    *li, *lj, *ui, *uj;          /* ILU(k) pattern of L, strictly lower, and U, diagonal first, stored by rows */
+  PetscInt    *ci, *cr, *cp;               /* U stored by columns, row indices and positions in ua[] */
+  PetscInt    *lmap, *umap;                /* positions of the entries of the factors in the values of the matrix, -1 for fill */
+  PetscScalar *la, *ua, *lav, *uav;        /* values of the factors and of the matrix on their pattern */
+  PetscInt    *sli, *slj, *sui, *suj, snz; /* factors used by the solves, after dropping small entries, U without diagonal */
+  PetscScalar *sla, *sua, *sud, *work;     /* sud[] is the inverse of the diagonal of U */
+} Mat_ParILU;
+
+static PetscErrorCode MatParILUGetLocalMatrix_Private(Mat A, Mat *Aloc)
+{
+  PetscBool mpi;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectBaseTypeCompare((PetscObject)A, MATMPIAIJ, &mpi));
+  if (mpi) PetscCall(MatMPIAIJGetSeqAIJ(A, Aloc, NULL, NULL));
+  else *Aloc = A;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatParILUReset_Private(Mat_ParILU *lu)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree4(lu->li, lu->lj, lu->ui, lu->uj));
+  PetscCall(PetscFree5(lu->ci, lu->cr, lu->cp, lu->lmap, lu->umap));
+  PetscCall(PetscFree4(lu->la, lu->ua, lu->lav, lu->uav));
+  PetscCall(PetscFree4(lu->sli, lu->slj, lu->sui, lu->suj));
+  PetscCall(PetscFree4(lu->sla, lu->sua, lu->sud, lu->work));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatDestroy_ParILU(Mat A)
+{
+  Mat_ParILU *lu = (Mat_ParILU *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatParILUReset_Private(lu));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatFactorGetSolverType_C", NULL));
+  PetscCall(PetscFree(A->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* sum of l_ik u_kj for k < m, merging row i of L with column j of U */
+static inline PetscScalar MatParILUDot_Private(const Mat_ParILU *lu, PetscInt i, PetscInt j, PetscInt m)
+{
+  PetscInt    p = lu->li[i], pend = lu->li[i + 1], q = lu->ci[j], qend = lu->ci[j + 1];
+  PetscScalar sum = 0.0;
+
+  while (p < pend && q < qend) {
+    PetscInt k = lu->lj[p], r = lu->cr[q];
+
+    if (k >= m || r >= m) break;
+    if (k == r) sum += lu->la[p++] * lu->ua[lu->cp[q++]];
+    else if (k < r) p++;
+    else q++;
+  }
+  return sum;
+}
+
+static PetscErrorCode MatLUFactorNumeric_ParILU(Mat F, Mat A, const MatFactorInfo *info)
+{
+  Mat_ParILU        *lu = (Mat_ParILU *)F->data;
+  Mat                Aloc;
+  const PetscScalar *aa;
+  PetscInt           n = lu->n, *li = lu->li, *lj = lu->lj, *ui = lu->ui, *uj = lu->uj;
+  PetscScalar       *la = lu->la, *ua = lu->ua, *lav = lu->lav, *uav = lu->uav;
+  PetscReal          dt = info->usedt ? info->dt : 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(MatParILUGetLocalMatrix_Private(A, &Aloc));
+  PetscCall(MatSeqAIJGetArrayRead(Aloc, &aa));
+  for (PetscInt p = 0; p < li[n]; p++) lav[p] = lu->lmap[p] >= 0 ? aa[lu->lmap[p]] : 0.0;
+  for (PetscInt p = 0; p < ui[n]; p++) uav[p] = lu->umap[p] >= 0 ? aa[lu->umap[p]] : 0.0;
+  PetscCall(MatSeqAIJRestoreArrayRead(Aloc, &aa));
+
+  /* initial guess, U = triu(A) and L = tril(A) D^{-1} */
+  PetscCall(PetscArraycpy(ua, uav, ui[n]));
+  for (PetscInt i = 0; i < n; i++) {
+    for (PetscInt p = li[i]; p < li[i + 1]; p++) la[p] = lav[p] / uav[ui[lj[p]]];
+  }
+
+  /* each sweep updates the entries in place with the latest available values, a sweep in the natural order gives the exact ILU(k) factors */
+  for (PetscInt s = 0; s < lu->sweeps; s++) {
+    PetscPragmaUseOMPKernels(parallel for schedule(static))
+    for (PetscInt i = 0; i < n; i++) {
+      for (PetscInt p = li[i]; p < li[i + 1]; p++) {
+        PetscInt j = lj[p];
+
+        la[p] = (lav[p] - MatParILUDot_Private(lu, i, j, j)) / ua[ui[j]];
+      }
+      for (PetscInt p = ui[i]; p < ui[i + 1]; p++) ua[p] = uav[p] - MatParILUDot_Private(lu, i, uj[p], i);
+    }
+  }
+  PetscCall(PetscLogFlops(2.0 * lu->sweeps * (li[n] + ui[n]) * (li[n] + ui[n]) / PetscMax(n, 1)));
+
+  F->factorerrortype = MAT_FACTOR_NOERROR;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscReal pv = PetscAbsScalar(ua[ui[i]]);
+
+    if (pv <= info->zeropivot || PetscIsInfOrNanReal(pv)) {
+      PetscCheck(!A->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot row %" PetscInt_FMT " value %g tolerance %g", i, (double)pv, (double)info->zeropivot);
+      PetscCall(PetscInfo(A, "Detected zero pivot in factorization in row %" PetscInt_FMT " value %g tolerance %g\n", i, (double)pv, (double)info->zeropivot));
+      F->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      F->factorerror_zeropivot_value = pv;
+      F->factorerror_zeropivot_row   = i;
+      break;
+    }
+  }
+
+  /* factors used by the solves, entries below the drop tolerance, relative to the pivot for U, are discarded */
+  lu->sli[0] = lu->sui[0] = 0;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscInt nz = lu->sli[i];
+
+    for (PetscInt p = li[i]; p < li[i + 1]; p++) {
+      if (PetscAbsScalar(la[p]) < dt) continue;
+      lu->slj[nz]   = lj[p];
+      lu->sla[nz++] = la[p];
+    }
+    lu->sli[i + 1] = nz;
+    nz             = lu->sui[i];
+    for (PetscInt p = ui[i] + 1; p < ui[i + 1]; p++) {
+      if (PetscAbsScalar(ua[p]) < dt * PetscAbsScalar(ua[ui[i]])) continue;
+      lu->suj[nz]   = uj[p];
+      lu->sua[nz++] = ua[p];
+    }
+    lu->sui[i + 1] = nz;
+    lu->sud[i]     = 1.0 / ua[ui[i]];
+  }
+  lu->snz = lu->sli[n] + lu->sui[n] + n;
+  if (dt > 0.0) PetscCall(PetscInfo(F, "Dropped %" PetscInt_FMT " of %" PetscInt_FMT " nonzeros of the factors with tolerance %g\n", li[n] + ui[n] - lu->snz, li[n] + ui[n], (double)dt));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSolve_ParILU(Mat F, Vec b, Vec x)
+{
+  Mat_ParILU        *lu = (Mat_ParILU *)F->data;
+  const PetscInt    *li = lu->sli, *lj = lu->slj, *ui = lu->sui, *uj = lu->suj;
+  const PetscScalar *la = lu->sla, *ua = lu->sua, *ud = lu->sud, *ba;
+  PetscScalar       *xa, *y = lu->work, *z = lu->work + lu->n, *w = lu->work + 2 * lu->n, *t;
+  PetscInt           n = lu->n;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(b, &ba));
+  PetscCall(VecGetArrayWrite(x, &xa));
+  if (!lu->its) {
+    /* exact forward and backward substitutions */
+    for (PetscInt i = 0; i < n; i++) {
+      const PetscScalar *v   = la + li[i];
+      const PetscInt    *vi  = lj + li[i];
+      PetscScalar        sum = ba[i];
+
+      PetscSparseDenseMinusDot(sum, xa, v, vi, li[i + 1] - li[i]);
+      xa[i] = sum;
+    }
+    for (PetscInt i = n - 1; i >= 0; i--) {
+      const PetscScalar *v   = ua + ui[i];
+      const PetscInt    *vi  = uj + ui[i];
+      PetscScalar        sum = xa[i];
+
+      PetscSparseDenseMinusDot(sum, xa, v, vi, ui[i + 1] - ui[i]);
+      xa[i] = sum * ud[i];
+    }
+  } else {
+    /* Jacobi iterations y <- b - (L - I) y starting from y = b, then x <- D^{-1} (y - (U - D) x) starting from x = D^{-1} y */
+    PetscCall(PetscArraycpy(y, ba, n));
+    for (PetscInt k = 0; k < lu->its; k++) {
+      PetscPragmaUseOMPKernels(parallel for schedule(static))
+      for (PetscInt i = 0; i < n; i++) {
+        const PetscScalar *v   = la + li[i];
+        const PetscInt    *vi  = lj + li[i];
+        PetscScalar        sum = ba[i];
+
+        PetscSparseDenseMinusDot(sum, y, v, vi, li[i + 1] - li[i]);
+        z[i] = sum;
+      }
+      t = y;
+      y = z;
+      z = t;
+    }
+    for (PetscInt i = 0; i < n; i++) z[i] = ud[i] * y[i];
+    for (PetscInt k = 0; k < lu->its; k++) {
+      PetscPragmaUseOMPKernels(parallel for schedule(static))
+      for (PetscInt i = 0; i < n; i++) {
+        const PetscScalar *v   = ua + ui[i];
+        const PetscInt    *vi  = uj + ui[i];
+        PetscScalar        sum = y[i];
+
+        PetscSparseDenseMinusDot(sum, z, v, vi, ui[i + 1] - ui[i]);
+        w[i] = ud[i] * sum;
+      }
+      t = z;
+      z = w;
+      w = t;
+    }
+    PetscCall(PetscArraycpy(xa, z, n));
+  }
+  PetscCall(VecRestoreArrayWrite(x, &xa));
+  PetscCall(VecRestoreArrayRead(b, &ba));
+  PetscCall(PetscLogFlops(2.0 * PetscMax(lu->its, 1) * lu->snz));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_ParILU(Mat F, Mat A, IS r, IS c, const MatFactorInfo *info)
+{
+  Mat_ParILU     *lu = (Mat_ParILU *)F->data;
+  Mat             Aloc, P;
+  Mat_SeqAIJ     *a, *b;
+  IS              is;
+  const PetscInt *adiag;
+  PetscInt        n, *bi, *bj, *bdiag, nzl, nzu, *cnt;
+  PetscBool       diagDense;
+
+  PetscFunctionBegin;
+  PetscCall(MatParILUGetLocalMatrix_Private(A, &Aloc));
+  PetscCheck(Aloc->rmap->n == Aloc->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Must be square matrix, rows %" PetscInt_FMT " columns %" PetscInt_FMT, Aloc->rmap->n, Aloc->cmap->n);
+  PetscCall(MatGetDiagonalMarkers_SeqAIJ(Aloc, &adiag, &diagDense));
+  PetscCheck(diagDense, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Matrix is missing diagonal entries");
+  PetscOptionsBegin(PetscObjectComm((PetscObject)F), ((PetscObject)F)->prefix, "ParILU Options", "Mat");
+  PetscCall(PetscOptionsInt("-mat_parilu_sweeps", "Number of fixed-point sweeps of the factorization", "None", lu->sweeps, &lu->sweeps, NULL));
+  PetscCall(PetscOptionsInt("-mat_parilu_solve_iterations", "Number of Jacobi iterations of the triangular solves, 0 for exact solves", "None", lu->its, &lu->its, NULL));
+  PetscOptionsEnd();
+  PetscCheck(lu->sweeps >= 1, PetscObjectComm((PetscObject)F), PETSC_ERR_ARG_OUTOFRANGE, "Number of sweeps %" PetscInt_FMT " must be at least 1", lu->sweeps);
+  PetscCheck(lu->its >= 0, PetscObjectComm((PetscObject)F), PETSC_ERR_ARG_OUTOFRANGE, "Number of solve iterations %" PetscInt_FMT " cannot be negative", lu->its);
+
+  /* the nonzero pattern of the ILU(k) factors in the natural ordering */
+  n = Aloc->rmap->n;
+  PetscCall(ISCreateStride(PETSC_COMM_SELF, n, 0, 1, &is));
+  PetscCall(MatGetFactor(Aloc, MATSOLVERPETSC, MAT_FACTOR_ILU, &P));
+  PetscCall(MatILUFactorSymbolic(P, Aloc, is, is, info));
+  PetscCall(ISDestroy(&is));
+  a     = (Mat_SeqAIJ *)Aloc->data;
+  b     = (Mat_SeqAIJ *)P->data;
+  bi    = b->i;
+  bj    = b->j;
+  bdiag = b->diag;
+  nzl   = bi[n];
+  nzu   = bdiag[0] - bdiag[n];
+
+  PetscCall(MatParILUReset_Private(lu));
+  lu->n   = n;
+  lu->nza = a->nz;
+  PetscCall(PetscMalloc4(n + 1, &lu->li, nzl, &lu->lj, n + 1, &lu->ui, nzu, &lu->uj));
+  PetscCall(PetscMalloc5(n + 1, &lu->ci, nzu, &lu->cr, nzu, &lu->cp, nzl, &lu->lmap, nzu, &lu->umap));
+  PetscCall(PetscMalloc4(nzl, &lu->la, nzu, &lu->ua, nzl, &lu->lav, nzu, &lu->uav));
+  PetscCall(PetscMalloc4(n + 1, &lu->sli, nzl, &lu->slj, n + 1, &lu->sui, nzu - n, &lu->suj));
+  PetscCall(PetscMalloc4(nzl, &lu->sla, nzu - n, &lu->sua, n, &lu->sud, 3 * n, &lu->work));
+  lu->li[0] = lu->ui[0] = 0;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscInt nz = bdiag[i] - bdiag[i + 1] - 1;
+
+    lu->li[i + 1] = bi[i + 1];
+    PetscCall(PetscArraycpy(lu->lj + bi[i], bj + bi[i], bi[i + 1] - bi[i]));
+    PetscCall(PetscSortInt(bi[i + 1] - bi[i], lu->lj + bi[i]));
+    lu->ui[i + 1]     = lu->ui[i] + nz + 1;
+    lu->uj[lu->ui[i]] = i;
+    PetscCall(PetscArraycpy(lu->uj + lu->ui[i] + 1, bj + bdiag[i + 1] + 1, nz));
+    PetscCall(PetscSortInt(nz, lu->uj + lu->ui[i] + 1));
+  }
+  PetscCall(MatDestroy(&P));
+
+  /* U by columns, the rows of each column are sorted */
+  PetscCall(PetscCalloc1(n + 1, &cnt));
+  for (PetscInt p = 0; p < nzu; p++) cnt[lu->uj[p] + 1]++;
+  for (PetscInt j = 0; j < n; j++) cnt[j + 1] += cnt[j];
+  PetscCall(PetscArraycpy(lu->ci, cnt, n + 1));
+  for (PetscInt i = 0; i < n; i++) {
+    for (PetscInt p = lu->ui[i]; p < lu->ui[i + 1]; p++) {
+      PetscInt q = cnt[lu->uj[p]]++;
+
+      lu->cr[q] = i;
+      lu->cp[q] = p;
+    }
+  }
+  PetscCall(PetscFree(cnt));
+
+  /* positions of the entries of the matrix in the factors, the ILU(k) pattern contains the pattern of the matrix */
+  for (PetscInt p = 0; p < nzl; p++) lu->lmap[p] = -1;
+  for (PetscInt p = 0; p < nzu; p++) lu->umap[p] = -1;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscInt p = lu->li[i], q = lu->ui[i] + 1;
+
+    for (PetscInt k = a->i[i]; k < a->i[i + 1]; k++) {
+      PetscInt j = a->j[k];
+
+      if (j < i) {
+        while (lu->lj[p] < j) p++;
+        lu->lmap[p] = k;
+      } else if (j == i) {
+        lu->umap[lu->ui[i]] = k;
+      } else {
+        while (lu->uj[q] < j) q++;
+        lu->umap[q] = k;
+      }
+    }
+  }
+  PetscCall(PetscInfo(F, "Fill ratio %g with %" PetscInt_FMT " levels\n", (double)((PetscReal)(nzl + nzu) / PetscMax(lu->nza, 1)), (PetscInt)info->levels));
+  F->ops->lufactornumeric = MatLUFactorNumeric_ParILU;
+  F->ops->solve           = MatSolve_ParILU;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatGetInfo_ParILU(Mat A, MatInfoType flag, MatInfo *info)
+{
+  Mat_ParILU *lu = (Mat_ParILU *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMemzero(info, sizeof(MatInfo)));
+  if (lu->li) {
+    info->nz_used           = lu->li[lu->n] + lu->ui[lu->n];
+    info->nz_allocated      = info->nz_used;
+    info->fill_ratio_needed = info->nz_used / PetscMax(lu->nza, 1);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatView_ParILU(Mat A, PetscViewer viewer)
+{
+  Mat_ParILU       *lu = (Mat_ParILU *)A->data;
+  PetscBool         isascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii) {
+    PetscCall(PetscViewerGetFormat(viewer, &format));
+    if (format == PETSC_VIEWER_ASCII_INFO) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "ParILU run parameters:\n"));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  Fixed-point sweeps of the factorization: %" PetscInt_FMT "\n", lu->sweeps));
+      if (lu->its) PetscCall(PetscViewerASCIIPrintf(viewer, "  Jacobi iterations of the triangular solves: %" PetscInt_FMT "\n", lu->its));
+      else PetscCall(PetscViewerASCIIPrintf(viewer, "  Exact triangular solves\n"));
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatFactorGetSolverType_aij_parilu(Mat A, MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERPARILU;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+  MATSOLVERPARILU = "parilu" - A matrix type providing an incomplete LU factorization, ILU(k), for `MATSEQAIJ` matrices and for the diagonal
+  blocks of `MATMPIAIJ` matrices, computed with fine-grained fixed-point sweeps and applied with Jacobi iterations on the triangular systems
+
+  Use `-pc_type ilu` `-pc_factor_mat_solver_type parilu` to use this preconditioner
+
+  Options Database Keys:
++ -mat_parilu_sweeps <3>           - number of fixed-point sweeps of the factorization
+- -mat_parilu_solve_iterations <3> - number of Jacobi iterations of the triangular solves, 0 for exact triangular solves
+
+   Level: intermediate
+
+   Notes:
+   Each entry of the factors is updated from the latest available values of the other entries. The rows of the factors and of the triangular
+   solves are distributed among the threads when PETSc is configured with `--with-openmp-kernels`; without threads a single sweep gives the
+   factors of the `MATSOLVERPETSC` ILU(k) factorization.
+
+   Only the natural ordering is used. With `PCFactorSetDropTolerance()` the entries of $L$ smaller than the tolerance, and the entries of $U$
+   smaller than the tolerance times the pivot of their row, are dropped before the triangular solves.
+
+   For a `MATMPIAIJ` matrix each process factors its diagonal block, so the preconditioner is the same as `PCBJACOBI` with one block per process.
+
+   See {cite}`chowpatel2015`
+
+.seealso: [](ch_matrices), `Mat`, `PCILU`, `MATSOLVERPETSC`, `PCFactorSetMatSolverType()`, `MatSolverType`, `PCFactorSetLevels()`, `PCFactorSetDropTolerance()`
+M*/
+
+PETSC_INTERN PetscErrorCode MatGetFactor_aij_parilu(Mat A, MatFactorType ftype, Mat *F)
+{
+  Mat         B;
+  Mat_ParILU *lu;
+
+  PetscFunctionBegin;
+  PetscCall(MatCreate(PetscObjectComm((PetscObject)A), &B));
+  PetscCall(MatSetSizes(B, A->rmap->n, A->cmap->n, A->rmap->N, A->cmap->N));
+  PetscCall(PetscStrallocpy("parilu", &((PetscObject)B)->type_name));
+  PetscCall(MatSetUp(B));
+
+  PetscCall(PetscNew(&lu));
+  lu->sweeps = 3;
+  lu->its    = 3;
+
+  B->data                   = lu;
+  B->ops->getinfo           = MatGetInfo_ParILU;
+  B->ops->ilufactorsymbolic = MatILUFactorSymbolic_ParILU;
+  B->ops->destroy           = MatDestroy_ParILU;
+  B->ops->view              = MatView_ParILU;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatFactorGetSolverType_C", MatFactorGetSolverType_aij_parilu));
+
+  B->factortype   = MAT_FACTOR_ILU;
+  B->assembled    = PETSC_TRUE; /* required by -ksp_view */
+  B->preallocated = PETSC_TRUE;
+
+  PetscCall(PetscFree(B->solvertype));
+  PetscCall(PetscStrallocpy(MATSOLVERPARILU, &B->solvertype));
+  B->canuseordering = PETSC_FALSE;
+  PetscCall(PetscStrallocpy(MATORDERINGNATURAL, (char **)&B->preferredordering[MAT_FACTOR_ILU]));
+  *F = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
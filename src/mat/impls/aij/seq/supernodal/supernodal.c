@@ -0,0 +1,635 @@
+/*
+   Supernodal sparse Cholesky and LU factorizations, without pivoting, on dense supernode panels with BLAS-3 operations.
+
+   The supernodes are the fundamental supernodes of the elimination tree of the (symmetrized) pattern. Each supernode s holds the
+   columns [f, f + w) of the factors and the sorted rows R of its columns, the first w rows being f, ..., f + w - 1. L is stored as a
+   dense m x w column major panel containing the diagonal block. For LU the diagonal block holds L and U, and the rows of U right
+   of the diagonal block are stored transposed in a dense (m - w) x w panel.
+
+   The numeric factorization is left-looking: a supernode gathers the updates of its descendants and then factors its panel. The
+   supernodes of a level of the supernodal elimination tree are independent and are factored by different threads when PETSc is
+   configured with --with-openmp-kernels. The analysis is done once in the symbolic factorization and reused by all the numeric ones.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/sbaij/seq/sbaij.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscInt        n, nsuper, nlevels;
+  PetscInt       *sfirst;              /* first column of each supernode, nsuper + 1 entries */
+  PetscInt       *rptr, *rind;         /* sorted row indices of each supernode */
+  PetscInt       *sn;                  /* supernode of each column */
+  PetscInt       *lvlptr, *lvlsn;      /* supernodes of each level of the supernodal elimination tree */
+  PetscInt       *uptr, *ud, *up, *uq; /* updates of each supernode: descendant ud and rows [up, uq) of the descendant in its columns */
+  PetscCount     *loff, *uoff;         /* offsets of the panels of L and of the transposed off-diagonal panels of U */
+  PetscCount     *coff, *roff;         /* offsets of the work of each supernode in its level */
+  PetscCount      nzl, nzu, nza;       /* sizes of the panels and number of nonzeros of the matrix */
+  PetscCount     *amap;                /* position of each nonzero of the matrix in the panels, -1 if not used, -2 - k in the panels of U */
+  PetscScalar    *lval, *uval, *cwork, *swork;
+  PetscInt       *rwork, *ferr;
+  PetscInt        maxw, maxm;
+  PetscLogDouble  flops;
+  IS              row;
+  PetscBool       sbaij;
+  MatFactorType   ftype;
+} Mat_Supernodal;
+
+static PetscErrorCode MatSupernodalReset_Private(Mat_Supernodal *sp)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree2(sp->sfirst, sp->rptr));
+  PetscCall(PetscFree(sp->rind));
+  PetscCall(PetscFree3(sp->sn, sp->lvlptr, sp->lvlsn));
+  PetscCall(PetscFree4(sp->uptr, sp->ud, sp->up, sp->uq));
+  PetscCall(PetscFree4(sp->loff, sp->uoff, sp->coff, sp->roff));
+  PetscCall(PetscFree(sp->amap));
+  PetscCall(PetscFree2(sp->lval, sp->uval));
+  PetscCall(PetscFree4(sp->cwork, sp->swork, sp->rwork, sp->ferr));
+  PetscCall(ISDestroy(&sp->row));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatDestroy_Supernodal(Mat A)
+{
+  Mat_Supernodal *sp = (Mat_Supernodal *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatSupernodalReset_Private(sp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatFactorGetSolverType_C", NULL));
+  PetscCall(PetscFree(A->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* LU factorization without pivoting of a dense column major matrix, returns the first zero pivot or -1 */
+static PetscInt MatSupernodalDenseLU_Private(PetscBLASInt n, PetscScalar *a, PetscBLASInt lda, PetscReal zeropivot)
+{
+  const PetscScalar one = 1.0, mone = -1.0;
+  PetscBLASInt      n1, n2;
+  PetscInt          err;
+
+  if (n <= 32) {
+    for (PetscBLASInt k = 0; k < n; k++) {
+      PetscScalar piv = a[k + k * lda];
+
+      if (PetscAbsScalar(piv) <= zeropivot) return k;
+      for (PetscBLASInt i = k + 1; i < n; i++) a[i + k * lda] /= piv;
+      for (PetscBLASInt j = k + 1; j < n; j++) {
+        PetscScalar akj = a[k + j * lda];
+
+        for (PetscBLASInt i = k + 1; i < n; i++) a[i + j * lda] -= a[i + k * lda] * akj;
+      }
+    }
+    return -1;
+  }
+  /* recursive blocking, [A11 A12; A21 A22] = [L11 0; L21 L22] [U11 U12; 0 U22] */
+  n1  = n / 2;
+  n2  = n - n1;
+  err = MatSupernodalDenseLU_Private(n1, a, lda, zeropivot);
+  if (err >= 0) return err;
+  BLAStrsm_("L", "L", "N", "U", &n1, &n2, &one, a, &lda, a + n1 * lda, &lda);
+  BLAStrsm_("R", "U", "N", "N", &n2, &n1, &one, a, &lda, a + n1, &lda);
+  BLASgemm_("N", "N", &n2, &n2, &n1, &mone, a + n1, &lda, a + n1 * lda, &lda, &one, a + n1 + n1 * lda, &lda);
+  err = MatSupernodalDenseLU_Private(n2, a + n1 + n1 * lda, lda, zeropivot);
+  return err >= 0 ? n1 + err : -1;
+}
+
+/* gathers the updates of the descendants of the supernode s and factors its panels, returns the first zero pivot or -1 */
+static PetscInt MatSupernodalFactorSupernode_Private(Mat_Supernodal *sp, PetscInt s, PetscReal zeropivot)
+{
+  const PetscScalar one = 1.0, zero = 0.0;
+  PetscInt          f = sp->sfirst[s], ws = sp->sfirst[s + 1] - f, ms = sp->rptr[s + 1] - sp->rptr[s], err = -1;
+  const PetscInt   *rs = sp->rind + sp->rptr[s];
+  PetscScalar      *ls = sp->lval + sp->loff[s], *uts = sp->uval + sp->uoff[s], *c = sp->cwork + sp->coff[s];
+  PetscInt         *rel = sp->rwork + sp->roff[s];
+  PetscBLASInt      bm, bms = (PetscBLASInt)ms, bws = (PetscBLASInt)ws, bmw = (PetscBLASInt)(ms - ws), info;
+
+  for (PetscInt k = sp->uptr[s]; k < sp->uptr[s + 1]; k++) {
+    PetscInt        d = sp->ud[k], p = sp->up[k], q = sp->uq[k], wd = sp->sfirst[d + 1] - sp->sfirst[d], md = sp->rptr[d + 1] - sp->rptr[d];
+    const PetscInt *rd = sp->rind + sp->rptr[d];
+    PetscScalar    *ld = sp->lval + sp->loff[d], *utd = sp->uval + sp->uoff[d];
+    PetscBLASInt    bmd = (PetscBLASInt)md, bwd = (PetscBLASInt)wd, bmdw = (PetscBLASInt)(md - wd), bnq = (PetscBLASInt)(q - p);
+
+    /* local rows in s of the rows [p, md) of d, both are sorted */
+    for (PetscInt i = p, r = 0; i < md; i++) {
+      while (rs[r] < rd[i]) r++;
+      rel[i - p] = r;
+    }
+    bm = (PetscBLASInt)(md - p);
+    if (sp->ftype == MAT_FACTOR_CHOLESKY) BLASgemm_("N", "T", &bm, &bnq, &bwd, &one, ld + p, &bmd, ld + p, &bmd, &zero, c, &bm);
+    else BLASgemm_("N", "T", &bm, &bnq, &bwd, &one, ld + p, &bmd, utd + (p - wd), &bmdw, &zero, c, &bm);
+    for (PetscInt j = 0; j < q - p; j++) {
+      PetscScalar *lc = ls + (rd[p + j] - f) * ms, *cc = c + j * (md - p);
+
+      for (PetscInt i = 0; i < md - p; i++) lc[rel[i]] -= cc[i];
+    }
+    if (sp->ftype == MAT_FACTOR_LU && md > q) {
+      bm = (PetscBLASInt)(md - q);
+      BLASgemm_("N", "T", &bm, &bnq, &bwd, &one, utd + (q - wd), &bmdw, ld + p, &bmd, &zero, c, &bm);
+      for (PetscInt j = 0; j < q - p; j++) {
+        PetscScalar *uc = uts + (rd[p + j] - f) * (ms - ws) - ws, *cc = c + j * (md - q);
+
+        for (PetscInt i = 0; i < md - q; i++) uc[rel[q - p + i]] -= cc[i];
+      }
+    }
+  }
+
+  if (sp->ftype == MAT_FACTOR_CHOLESKY) {
+    LAPACKpotrf_("L", &bws, ls, &bms, &info);
+    if (info) return f + info - 1;
+    if (ms > ws) BLAStrsm_("R", "L", "T", "N", &bmw, &bws, &one, ls, &bms, ls + ws, &bms);
+  } else {
+    err = MatSupernodalDenseLU_Private(bws, ls, bms, zeropivot);
+    if (err >= 0) return f + err;
+    if (ms > ws) {
+      BLAStrsm_("R", "U", "N", "N", &bmw, &bws, &one, ls, &bms, ls + ws, &bms);
+      BLAStrsm_("R", "L", "T", "U", &bmw, &bws, &one, ls, &bms, uts, &bmw);
+    }
+  }
+  return -1;
+}
+
+static PetscErrorCode MatFactorNumeric_Supernodal(Mat F, Mat A, const MatFactorInfo *info)
+{
+  Mat_Supernodal    *sp = (Mat_Supernodal *)F->data;
+  const PetscScalar *aa;
+  PetscInt           err = -1;
+
+  PetscFunctionBegin;
+  if (sp->sbaij) PetscCall(MatSeqSBAIJGetArray(A, (PetscScalar **)&aa));
+  else PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(PetscArrayzero(sp->lval, sp->nzl));
+  PetscCall(PetscArrayzero(sp->uval, sp->nzu));
+  for (PetscCount k = 0; k < sp->nza; k++) {
+    if (sp->amap[k] >= 0) sp->lval[sp->amap[k]] = aa[k];
+    else if (sp->amap[k] < -1) sp->uval[-2 - sp->amap[k]] = aa[k];
+  }
+  if (sp->sbaij) PetscCall(MatSeqSBAIJRestoreArray(A, (PetscScalar **)&aa));
+  else PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  for (PetscInt l = 0; l < sp->nlevels && err < 0; l++) {
+    PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+    for (PetscInt k = sp->lvlptr[l]; k < sp->lvlptr[l + 1]; k++) sp->ferr[k - sp->lvlptr[l]] = MatSupernodalFactorSupernode_Private(sp, sp->lvlsn[k], info->zeropivot);
+    for (PetscInt k = 0; k < sp->lvlptr[l + 1] - sp->lvlptr[l]; k++) {
+      if (sp->ferr[k] >= 0 && (err < 0 || sp->ferr[k] < err)) err = sp->ferr[k];
+    }
+  }
+  PetscCall(PetscFPTrapPop());
+  PetscCall(PetscLogFlops(sp->flops));
+
+  F->factorerrortype = MAT_FACTOR_NOERROR;
+  if (err >= 0) {
+    PetscCheck(!A->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot in row %" PetscInt_FMT " of the permuted matrix", err);
+    PetscCall(PetscInfo(A, "Detected zero pivot in factorization in row %" PetscInt_FMT " of the permuted matrix\n", err));
+    F->factorerrortype           = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+    F->factorerror_zeropivot_row = err;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSolve_Supernodal(Mat F, Vec b, Vec x)
+{
+  Mat_Supernodal    *sp = (Mat_Supernodal *)F->data;
+  const PetscScalar *ba, one = 1.0, zero = 0.0, mone = -1.0;
+  PetscScalar       *xa, *y = sp->swork, *t = sp->swork + sp->n;
+  const PetscInt    *r;
+  PetscBLASInt       ione = 1;
+
+  PetscFunctionBegin;
+  PetscCall(ISGetIndices(sp->row, &r));
+  PetscCall(VecGetArrayRead(b, &ba));
+  for (PetscInt i = 0; i < sp->n; i++) y[i] = ba[r[i]];
+  PetscCall(VecRestoreArrayRead(b, &ba));
+  for (PetscInt s = 0; s < sp->nsuper; s++) {
+    PetscInt        f = sp->sfirst[s], ws = sp->sfirst[s + 1] - f, ms = sp->rptr[s + 1] - sp->rptr[s];
+    const PetscInt *rs = sp->rind + sp->rptr[s];
+    PetscScalar    *ls = sp->lval + sp->loff[s];
+    PetscBLASInt    bw = (PetscBLASInt)ws, bms = (PetscBLASInt)ms, bmw = (PetscBLASInt)(ms - ws);
+
+    PetscCallBLAS("BLAStrsv", BLAStrsv_("L", "N", sp->ftype == MAT_FACTOR_CHOLESKY ? "N" : "U", &bw, ls, &bms, y + f, &ione));
+    if (ms > ws) {
+      PetscCallBLAS("BLASgemv", BLASgemv_("N", &bmw, &bw, &one, ls + ws, &bms, y + f, &ione, &zero, t, &ione));
+      for (PetscInt i = ws; i < ms; i++) y[rs[i]] -= t[i - ws];
+    }
+  }
+  for (PetscInt s = sp->nsuper - 1; s >= 0; s--) {
+    PetscInt        f = sp->sfirst[s], ws = sp->sfirst[s + 1] - f, ms = sp->rptr[s + 1] - sp->rptr[s];
+    const PetscInt *rs = sp->rind + sp->rptr[s];
+    PetscScalar    *ls = sp->lval + sp->loff[s];
+    PetscBLASInt    bw = (PetscBLASInt)ws, bms = (PetscBLASInt)ms, bmw = (PetscBLASInt)(ms - ws);
+
+    if (ms > ws) {
+      for (PetscInt i = ws; i < ms; i++) t[i - ws] = y[rs[i]];
+      if (sp->ftype == MAT_FACTOR_CHOLESKY) PetscCallBLAS("BLASgemv", BLASgemv_("T", &bmw, &bw, &mone, ls + ws, &bms, t, &ione, &one, y + f, &ione));
+      else PetscCallBLAS("BLASgemv", BLASgemv_("T", &bmw, &bw, &mone, sp->uval + sp->uoff[s], &bmw, t, &ione, &one, y + f, &ione));
+    }
+    if (sp->ftype == MAT_FACTOR_CHOLESKY) PetscCallBLAS("BLAStrsv", BLAStrsv_("L", "T", "N", &bw, ls, &bms, y + f, &ione));
+    else PetscCallBLAS("BLAStrsv", BLAStrsv_("U", "N", "N", &bw, ls, &bms, y + f, &ione));
+  }
+  PetscCall(VecGetArrayWrite(x, &xa));
+  for (PetscInt i = 0; i < sp->n; i++) xa[r[i]] = y[i];
+  PetscCall(VecRestoreArrayWrite(x, &xa));
+  PetscCall(ISRestoreIndices(sp->row, &r));
+  PetscCall(PetscLogFlops(2.0 * (sp->nzl + sp->nzu) * (sp->ftype == MAT_FACTOR_CHOLESKY ? 2 : 1)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatFactorSymbolic_Supernodal(Mat F, Mat A, IS perm)
+{
+  Mat_Supernodal *sp = (Mat_Supernodal *)F->data;
+  PetscInt        n  = A->rmap->n, nsuper, nlevels, *ai, *aj, *ip, *parent, *cptr, *cind, *lptr, *lind, *chptr, *chind, *cnt, *sptr, *sind, *mark, *height, *work, nupd, maxs = 0;
+  PetscCount      ssize, csum, rsum, maxc = 0, maxr = 0;
+  const PetscInt *r;
+  PetscBLASInt    bn;
+
+  PetscFunctionBegin;
+  PetscCheck(A->rmap->n == A->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Must be square matrix, rows %" PetscInt_FMT " columns %" PetscInt_FMT, A->rmap->n, A->cmap->n);
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(MatSupernodalReset_Private(sp));
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, MATSEQSBAIJ, &sp->sbaij));
+  if (sp->sbaij) {
+    Mat_SeqSBAIJ *a = (Mat_SeqSBAIJ *)A->data;
+
+    PetscCheck(A->rmap->bs == 1, PETSC_COMM_SELF, PETSC_ERR_SUP, "Block size %" PetscInt_FMT " is not supported, use MATSEQAIJ", A->rmap->bs);
+    ai = a->i;
+    aj = a->j;
+  } else {
+    Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+    ai = a->i;
+    aj = a->j;
+  }
+  sp->n   = n;
+  sp->nza = ai[n];
+  if (perm) {
+    PetscCall(PetscObjectReference((PetscObject)perm));
+    sp->row = perm;
+  } else PetscCall(ISCreateStride(PETSC_COMM_SELF, n, 0, 1, &sp->row));
+  PetscCall(ISGetIndices(sp->row, &r));
+  PetscCall(PetscMalloc1(n, &ip));
+  for (PetscInt i = 0; i < n; i++) ip[r[i]] = i;
+  PetscCall(ISRestoreIndices(sp->row, &r));
+
+  /* strictly lower part of the symmetrized permuted pattern, by columns and by rows */
+  PetscCall(PetscCalloc2(n + 1, &cptr, n + 1, &lptr));
+  for (PetscInt i = 0; i < n; i++) {
+    for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+      PetscInt pi = ip[i], pj = ip[aj[k]];
+
+      if (pi == pj) continue;
+      cptr[PetscMin(pi, pj) + 1]++;
+      lptr[PetscMax(pi, pj) + 1]++;
+    }
+  }
+  for (PetscInt i = 0; i < n; i++) {
+    cptr[i + 1] += cptr[i];
+    lptr[i + 1] += lptr[i];
+  }
+  PetscCall(PetscMalloc2(cptr[n], &cind, lptr[n], &lind));
+  for (PetscInt i = 0; i < n; i++) {
+    for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+      PetscInt pi = ip[i], pj = ip[aj[k]], lo = PetscMin(pi, pj), hi = PetscMax(pi, pj);
+
+      if (pi == pj) continue;
+      cind[cptr[lo]++] = hi;
+      lind[lptr[hi]++] = lo;
+    }
+  }
+  for (PetscInt i = n; i > 0; i--) {
+    cptr[i] = cptr[i - 1];
+    lptr[i] = lptr[i - 1];
+  }
+  cptr[0] = lptr[0] = 0;
+
+  /* elimination tree, with path compression */
+  PetscCall(PetscMalloc3(n, &parent, n, &mark, n, &work));
+  for (PetscInt k = 0; k < n; k++) {
+    parent[k] = -1;
+    work[k]   = -1;
+    for (PetscInt p = lptr[k]; p < lptr[k + 1]; p++) {
+      for (PetscInt i = lind[p], next; i != -1 && i < k; i = next) {
+        next    = work[i];
+        work[i] = k;
+        if (next == -1) parent[i] = k;
+      }
+    }
+  }
+  PetscCall(PetscCalloc1(n + 1, &chptr));
+  for (PetscInt j = 0; j < n; j++) {
+    if (parent[j] >= 0) chptr[parent[j] + 1]++;
+  }
+  for (PetscInt j = 0; j < n; j++) chptr[j + 1] += chptr[j];
+  PetscCall(PetscMalloc1(chptr[n], &chind));
+  for (PetscInt j = 0; j < n; j++) {
+    if (parent[j] >= 0) chind[chptr[parent[j]]++] = j;
+  }
+  for (PetscInt j = n; j > 0; j--) chptr[j] = chptr[j - 1];
+  chptr[0] = 0;
+
+  /* row structure of each column of L, the structure of the children without their diagonal merged with the pattern of the column */
+  ssize = cptr[n] + n;
+  PetscCall(PetscMalloc1(n + 1, &sptr));
+  PetscCall(PetscMalloc1(ssize, &sind));
+  sptr[0] = 0;
+  for (PetscInt j = 0; j < n; j++) mark[j] = -1;
+  for (PetscInt j = 0; j < n; j++) {
+    PetscCount nz = sptr[j];
+
+    for (PetscInt c = chptr[j]; c < chptr[j + 1]; c++) {
+      PetscInt ch = chind[c];
+
+      for (PetscInt p = sptr[ch] + 1; p < sptr[ch + 1]; p++) nz++;
+    }
+    nz += cptr[j + 1] - cptr[j] + 1;
+    if (nz > ssize) {
+      ssize = PetscMax(2 * ssize, nz);
+      PetscCall(PetscRealloc(ssize * sizeof(PetscInt), &sind));
+    }
+    nz         = sptr[j];
+    sind[nz++] = j;
+    mark[j]    = j;
+    for (PetscInt p = cptr[j]; p < cptr[j + 1]; p++) {
+      if (mark[cind[p]] != j) {
+        mark[cind[p]] = j;
+        sind[nz++]    = cind[p];
+      }
+    }
+    for (PetscInt c = chptr[j]; c < chptr[j + 1]; c++) {
+      PetscInt ch = chind[c];
+
+      for (PetscInt p = sptr[ch] + 1; p < sptr[ch + 1]; p++) {
+        if (mark[sind[p]] != j) {
+          mark[sind[p]] = j;
+          sind[nz++]    = sind[p];
+        }
+      }
+    }
+    PetscCall(PetscSortInt(nz - sptr[j] - 1, sind + sptr[j] + 1));
+    sptr[j + 1] = nz;
+  }
+  PetscCall(PetscFree2(cptr, lptr));
+  PetscCall(PetscFree2(cind, lind));
+
+  /* fundamental supernodes, j + 1 joins the supernode of j when j is its only child and the structures match */
+  PetscCall(PetscMalloc2(n + 1, &sp->sfirst, n + 1, &sp->rptr));
+  nsuper = 0;
+  for (PetscInt j = 0; j < n; j++) {
+    if (j && parent[j - 1] == j && chptr[j + 1] - chptr[j] == 1 && sptr[j] - sptr[j - 1] == sptr[j + 1] - sptr[j] + 1) continue;
+    sp->sfirst[nsuper++] = j;
+  }
+  sp->sfirst[nsuper] = n;
+  sp->nsuper         = nsuper;
+  sp->rptr[0]        = 0;
+  for (PetscInt s = 0; s < nsuper; s++) {
+    PetscInt f = sp->sfirst[s];
+
+    sp->rptr[s + 1] = sp->rptr[s] + sptr[f + 1] - sptr[f];
+    sp->maxw        = PetscMax(sp->maxw, sp->sfirst[s + 1] - f);
+    sp->maxm        = PetscMax(sp->maxm, sptr[f + 1] - sptr[f]);
+  }
+  PetscCall(PetscMalloc1(sp->rptr[nsuper], &sp->rind));
+  for (PetscInt s = 0; s < nsuper; s++) PetscCall(PetscArraycpy(sp->rind + sp->rptr[s], sind + sptr[sp->sfirst[s]], sp->rptr[s + 1] - sp->rptr[s]));
+  PetscCall(PetscFree(sptr));
+  PetscCall(PetscFree(sind));
+  PetscCall(PetscFree(chind));
+  PetscCall(PetscFree(chptr));
+
+  /* levels of the supernodal elimination tree, the leaves are on level 0 */
+  PetscCall(PetscMalloc3(n, &sp->sn, nsuper + 1, &sp->lvlptr, nsuper, &sp->lvlsn));
+  PetscCall(PetscCalloc1(nsuper, &height));
+  for (PetscInt s = 0; s < nsuper; s++) {
+    for (PetscInt j = sp->sfirst[s]; j < sp->sfirst[s + 1]; j++) sp->sn[j] = s;
+  }
+  nlevels = nsuper ? 1 : 0;
+  for (PetscInt s = 0; s < nsuper; s++) {
+    PetscInt pj = parent[sp->sfirst[s + 1] - 1];
+
+    if (pj >= 0) height[sp->sn[pj]] = PetscMax(height[sp->sn[pj]], height[s] + 1);
+    nlevels = PetscMax(nlevels, height[s] + 1);
+  }
+  PetscCall(PetscArrayzero(sp->lvlptr, nsuper + 1));
+  for (PetscInt s = 0; s < nsuper; s++) sp->lvlptr[height[s] + 1]++;
+  for (PetscInt l = 0; l < nlevels; l++) sp->lvlptr[l + 1] += sp->lvlptr[l];
+  for (PetscInt s = 0; s < nsuper; s++) sp->lvlsn[sp->lvlptr[height[s]]++] = s;
+  for (PetscInt l = nlevels; l > 0; l--) sp->lvlptr[l] = sp->lvlptr[l - 1];
+  sp->lvlptr[0] = 0;
+  sp->nlevels   = nlevels;
+  PetscCall(PetscFree(height));
+  PetscCall(PetscFree3(parent, mark, work));
+
+  /* updates of each supernode by its descendants, the rows of a descendant in the columns of a supernode are contiguous */
+  PetscCall(PetscCalloc1(nsuper + 1, &cnt));
+  nupd = 0;
+  for (PetscInt d = 0; d < nsuper; d++) {
+    const PetscInt *rd = sp->rind + sp->rptr[d];
+    PetscInt        md = sp->rptr[d + 1] - sp->rptr[d];
+
+    for (PetscInt p = sp->sfirst[d + 1] - sp->sfirst[d], q; p < md; p = q) {
+      PetscInt t = sp->sn[rd[p]];
+
+      for (q = p + 1; q < md && rd[q] < sp->sfirst[t + 1]; q++);
+      cnt[t + 1]++;
+      nupd++;
+    }
+  }
+  for (PetscInt s = 0; s < nsuper; s++) cnt[s + 1] += cnt[s];
+  PetscCall(PetscMalloc4(nsuper + 1, &sp->uptr, nupd, &sp->ud, nupd, &sp->up, nupd, &sp->uq));
+  PetscCall(PetscArraycpy(sp->uptr, cnt, nsuper + 1));
+  PetscCall(PetscMalloc4(nsuper + 1, &sp->loff, nsuper + 1, &sp->uoff, nsuper, &sp->coff, nsuper, &sp->roff));
+  sp->flops = 0.0;
+  for (PetscInt d = 0; d < nsuper; d++) {
+    const PetscInt *rd = sp->rind + sp->rptr[d];
+    PetscInt        md = sp->rptr[d + 1] - sp->rptr[d], wd = sp->sfirst[d + 1] - sp->sfirst[d];
+
+    for (PetscInt p = wd, q; p < md; p = q) {
+      PetscInt t = sp->sn[rd[p]], k = cnt[t]++;
+
+      for (q = p + 1; q < md && rd[q] < sp->sfirst[t + 1]; q++);
+      sp->ud[k] = d;
+      sp->up[k] = p;
+      sp->uq[k] = q;
+      sp->flops += 2.0 * (md - p) * (q - p) * wd * (sp->ftype == MAT_FACTOR_LU ? 2 : 1);
+    }
+    sp->flops += (PetscLogDouble)wd * wd * wd / (sp->ftype == MAT_FACTOR_LU ? 1.5 : 3.0) + (PetscLogDouble)(md - wd) * wd * wd * (sp->ftype == MAT_FACTOR_LU ? 2 : 1);
+  }
+  PetscCall(PetscFree(cnt));
+
+  /* panels and work of the supernodes, the work of a level is shared by its supernodes */
+  sp->loff[0] = sp->uoff[0] = 0;
+  for (PetscInt s = 0; s < nsuper; s++) {
+    PetscInt ws = sp->sfirst[s + 1] - sp->sfirst[s], ms = sp->rptr[s + 1] - sp->rptr[s];
+
+    sp->loff[s + 1] = sp->loff[s] + (PetscCount)ms * ws;
+    sp->uoff[s + 1] = sp->uoff[s] + (sp->ftype == MAT_FACTOR_LU ? (PetscCount)(ms - ws) * ws : 0);
+  }
+  sp->nzl = sp->loff[nsuper];
+  sp->nzu = sp->uoff[nsuper];
+  for (PetscInt l = 0; l < nlevels; l++) {
+    csum = rsum = 0;
+    for (PetscInt k = sp->lvlptr[l]; k < sp->lvlptr[l + 1]; k++) {
+      PetscInt   s = sp->lvlsn[k];
+      PetscCount c = 0;
+
+      for (PetscInt u = sp->uptr[s]; u < sp->uptr[s + 1]; u++) {
+        PetscInt d = sp->ud[u];
+
+        c = PetscMax(c, (PetscCount)(sp->rptr[d + 1] - sp->rptr[d] - sp->up[u]) * (sp->uq[u] - sp->up[u]));
+      }
+      sp->coff[s] = csum;
+      sp->roff[s] = rsum;
+      csum += c;
+      rsum += sp->rptr[s + 1] - sp->rptr[s];
+    }
+    maxc = PetscMax(maxc, csum);
+    maxr = PetscMax(maxr, rsum);
+    maxs = PetscMax(maxs, sp->lvlptr[l + 1] - sp->lvlptr[l]);
+  }
+  PetscCall(PetscMalloc2(sp->nzl, &sp->lval, sp->nzu, &sp->uval));
+  PetscCall(PetscMalloc4(maxc, &sp->cwork, 2 * n, &sp->swork, maxr, &sp->rwork, maxs, &sp->ferr));
+
+  /* position of each nonzero of the matrix in the panels */
+  PetscCall(PetscMalloc1(sp->nza, &sp->amap));
+  for (PetscInt i = 0; i < n; i++) {
+    for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+      PetscInt pi = ip[i], pj = ip[aj[k]], s, f, ws, ms, loc;
+
+      if (pi < pj && sp->ftype == MAT_FACTOR_CHOLESKY) {
+        if (!sp->sbaij) {
+          sp->amap[k] = -1;
+          continue;
+        }
+        pi = ip[aj[k]];
+        pj = ip[i];
+      }
+      s  = sp->sn[PetscMin(pi, pj)];
+      f  = sp->sfirst[s];
+      ws = sp->sfirst[s + 1] - f;
+      ms = sp->rptr[s + 1] - sp->rptr[s];
+      PetscCall(PetscFindInt(PetscMax(pi, pj), ms, sp->rind + sp->rptr[s], &loc));
+      PetscCheck(loc >= 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Entry (%" PetscInt_FMT ", %" PetscInt_FMT ") of the permuted matrix is not in the structure of the factors", pi, pj);
+      if (pi >= pj) sp->amap[k] = sp->loff[s] + loc + (PetscCount)(pj - f) * ms;
+      else if (loc < ws) sp->amap[k] = sp->loff[s] + (pi - f) + (PetscCount)loc * ms;
+      else sp->amap[k] = -2 - (sp->uoff[s] + (loc - ws) + (PetscCount)(pi - f) * (ms - ws));
+    }
+  }
+  PetscCall(PetscFree(ip));
+  PetscCall(PetscInfo(F, "%" PetscInt_FMT " supernodes on %" PetscInt_FMT " levels, largest width %" PetscInt_FMT ", fill ratio %g\n", nsuper, nlevels, sp->maxw, (double)((PetscReal)(sp->nzl + sp->nzu) / PetscMax(sp->nza, 1))));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_Supernodal(Mat F, Mat A, IS r, IS c, const MatFactorInfo *info)
+{
+  PetscBool same = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  if (r && c) PetscCall(ISEqual(r, c, &same));
+  PetscCheck(same, PetscObjectComm((PetscObject)F), PETSC_ERR_SUP, "Only symmetric permutations, with the same row and column ordering, are supported");
+  PetscCall(MatFactorSymbolic_Supernodal(F, A, r));
+  F->ops->lufactornumeric = MatFactorNumeric_Supernodal;
+  F->ops->solve           = MatSolve_Supernodal;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatCholeskyFactorSymbolic_Supernodal(Mat F, Mat A, IS perm, const MatFactorInfo *info)
+{
+  PetscFunctionBegin;
+  PetscCall(MatFactorSymbolic_Supernodal(F, A, perm));
+  F->ops->choleskyfactornumeric = MatFactorNumeric_Supernodal;
+  F->ops->solve                 = MatSolve_Supernodal;
+  F->ops->solvetranspose        = MatSolve_Supernodal;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatGetInfo_Supernodal(Mat A, MatInfoType flag, MatInfo *info)
+{
+  Mat_Supernodal *sp = (Mat_Supernodal *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMemzero(info, sizeof(MatInfo)));
+  info->nz_used           = (PetscLogDouble)(sp->nzl + sp->nzu);
+  info->nz_allocated      = info->nz_used;
+  info->fill_ratio_needed = sp->nza ? info->nz_used / sp->nza : 0.0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatView_Supernodal(Mat A, PetscViewer viewer)
+{
+  Mat_Supernodal   *sp = (Mat_Supernodal *)A->data;
+  PetscBool         isascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  if (isascii) {
+    PetscCall(PetscViewerGetFormat(viewer, &format));
+    if (format == PETSC_VIEWER_ASCII_INFO) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "Supernodal factorization:\n"));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  Supernodes: %" PetscInt_FMT " on %" PetscInt_FMT " levels of the elimination tree\n", sp->nsuper, sp->nlevels));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "  Largest supernode: %" PetscInt_FMT " columns, %" PetscInt_FMT " rows\n", sp->maxw, sp->maxm));
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatFactorGetSolverType_seqaij_supernodal(Mat A, MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERSUPERNODAL;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+  MATSOLVERSUPERNODAL = "supernodal" - A matrix type providing supernodal sparse Cholesky and LU factorizations, without pivoting, for sequential
+  matrices, `MATSEQAIJ` and `MATSEQSBAIJ` with block size 1 for Cholesky
+
+  Use `-pc_type cholesky` or `-pc_type lu` with `-pc_factor_mat_solver_type supernodal` to use this direct solver
+
+   Level: intermediate
+
+   Notes:
+   The columns of the factors with the same structure are grouped in dense panels, and the factorization is done with BLAS-3 operations on the
+   panels. The supernodes are factored level by level of their elimination tree; the supernodes of a level are factored by different threads
+   when PETSc is configured with `--with-openmp-kernels`. The analysis of the symbolic factorization is reused by all the numeric
+   factorizations with the same nonzero structure.
+
+   The default ordering is `MATORDERINGND`. LU requires the same row and column orderings and factors the pattern of $A + A^T$.
+
+   Like the `MATSOLVERPETSC` factorizations no pivoting is done; shifts of the zero pivots are not supported. Only real scalars are supported.
+
+.seealso: [](ch_matrices), `Mat`, `PCLU`, `PCCHOLESKY`, `MATSOLVERPETSC`, `PCFactorSetMatSolverType()`, `MatSolverType`
+M*/
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_supernodal(Mat A, MatFactorType ftype, Mat *F)
+{
+  Mat             B;
+  Mat_Supernodal *sp;
+
+  PetscFunctionBegin;
+  PetscCall(MatCreate(PetscObjectComm((PetscObject)A), &B));
+  PetscCall(MatSetSizes(B, A->rmap->n, A->cmap->n, A->rmap->N, A->cmap->N));
+  PetscCall(PetscStrallocpy("supernodal", &((PetscObject)B)->type_name));
+  PetscCall(MatSetUp(B));
+
+  PetscCall(PetscNew(&sp));
+  sp->ftype = ftype;
+
+  B->data         = sp;
+  B->ops->getinfo = MatGetInfo_Supernodal;
+  B->ops->destroy = MatDestroy_Supernodal;
+  B->ops->view    = MatView_Supernodal;
+  if (ftype == MAT_FACTOR_LU) B->ops->lufactorsymbolic = MatLUFactorSymbolic_Supernodal;
+  else B->ops->choleskyfactorsymbolic = MatCholeskyFactorSymbolic_Supernodal;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatFactorGetSolverType_C", MatFactorGetSolverType_seqaij_supernodal));
+
+  B->factortype   = ftype;
+  B->assembled    = PETSC_TRUE; /* required by -ksp_view */
+  B->preallocated = PETSC_TRUE;
+
+  PetscCall(PetscFree(B->solvertype));
+  PetscCall(PetscStrallocpy(MATSOLVERSUPERNODAL, &B->solvertype));
+  B->canuseordering = PETSC_TRUE;
+  PetscCall(PetscStrallocpy(MATORDERINGND, (char **)&B->preferredordering[ftype]));
+  *F = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
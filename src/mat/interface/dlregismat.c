@@ -126,6 +126,10 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqsbaij_petsc(Mat, MatFactorType, Mat
 PETSC_INTERN PetscErrorCode MatGetFactor_seqdense_petsc(Mat, MatFactorType, Mat *);
 PETSC_INTERN PetscErrorCode MatGetFactor_constantdiagonal_petsc(Mat, MatFactorType, Mat *);
 PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_bas(Mat, MatFactorType, Mat *);
+PETSC_INTERN PetscErrorCode MatGetFactor_aij_parilu(Mat, MatFactorType, Mat *);
+#if !PetscDefined(USE_COMPLEX)
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_supernodal(Mat, MatFactorType, Mat *);
+#endif
 
 #include <petscbm.h>
 PETSC_INTERN PetscErrorCode PetscBenchCreate_HPL(PetscBench);
@@ -375,6 +379,13 @@ PetscErrorCode MatInitializePackage(void)
 #endif
 
   PetscCall(MatSolverTypeRegister(MATSOLVERBAS, MATSEQAIJ, MAT_FACTOR_ICC, MatGetFactor_seqaij_bas));
+  PetscCall(MatSolverTypeRegister(MATSOLVERPARILU, MATSEQAIJ, MAT_FACTOR_ILU, MatGetFactor_aij_parilu));
+  PetscCall(MatSolverTypeRegister(MATSOLVERPARILU, MATMPIAIJ, MAT_FACTOR_ILU, MatGetFactor_aij_parilu));
+#if !PetscDefined(USE_COMPLEX)
+  PetscCall(MatSolverTypeRegister(MATSOLVERSUPERNODAL, MATSEQAIJ, MAT_FACTOR_LU, MatGetFactor_seqaij_supernodal));
+  PetscCall(MatSolverTypeRegister(MATSOLVERSUPERNODAL, MATSEQAIJ, MAT_FACTOR_CHOLESKY, MatGetFactor_seqaij_supernodal));
+  PetscCall(MatSolverTypeRegister(MATSOLVERSUPERNODAL, MATSEQSBAIJ, MAT_FACTOR_CHOLESKY, MatGetFactor_seqaij_supernodal));
+#endif
 
   /*
      Register the external package factorization based solvers
@@ -537,10 +537,12 @@ PetscErrorCode MatFilter(Mat A, PetscReal tol, PetscBool compress, PetscBool kee
   Mat          a;
   PetscScalar *newVals;
   PetscInt    *newCols, rStart, rEnd, maxRows, r, colMax = 0, nnz0 = 0, nnz1 = 0;
-  PetscBool    flg;
+  PetscBool    flg, isaij;
 
   PetscFunctionBegin;
   PetscCall(PetscObjectBaseTypeCompareAny((PetscObject)A, &flg, MATSEQDENSE, MATMPIDENSE, ""));
+  /* only the exact types, the subclasses, for example on devices, keep their values elsewhere */
+  PetscCall(PetscObjectTypeCompareAny((PetscObject)A, &isaij, MATSEQAIJ, MATMPIAIJ, ""));
   if (flg) {
     PetscCall(MatDenseGetLocalMatrix(A, &a));
     PetscCall(MatDenseGetLDA(a, &r));
@@ -550,6 +552,35 @@ PetscErrorCode MatFilter(Mat A, PetscReal tol, PetscBool compress, PetscBool kee
       for (maxRows = 0; maxRows < rStart; ++maxRows) newVals[maxRows + colMax * r] = PetscAbsScalar(newVals[maxRows + colMax * r]) <= tol ? 0.0 : newVals[maxRows + colMax * r];
     }
     PetscCall(MatDenseRestoreArray(a, &newVals));
+  } else if (isaij) {
+    Mat      b[2] = {A, NULL};
+    MatInfo  info;
+    PetscInt m;
+
+    /* zero the small values in place, with no MatSetValues() and assembly per row */
+    PetscCall(PetscObjectTypeCompare((PetscObject)A, MATMPIAIJ, &flg));
+    if (flg) PetscCall(MatMPIAIJGetSeqAIJ(A, &b[0], &b[1], NULL));
+    PetscCall(MatGetLocalSize(A, &m, NULL));
+    for (PetscInt k = 0; k < 2 && b[k]; k++) {
+      PetscInt nnz = 0, nz;
+
+      PetscCall(MatGetInfo(b[k], MAT_LOCAL, &info));
+      nz = (PetscInt)info.nz_used;
+      PetscCall(MatSeqAIJGetArray(b[k], &newVals));
+      PetscPragmaUseOMPKernels(parallel for reduction(+:nnz))
+      for (PetscInt i = 0; i < nz; i++) {
+        if (PetscUnlikely(PetscAbsScalar(newVals[i]) <= tol)) newVals[i] = 0.0;
+        else nnz++;
+      }
+      PetscCall(MatSeqAIJRestoreArray(b[k], &newVals));
+      nnz0 += nz;
+      nnz1 += nnz;
+    }
+    if (b[1]) PetscCall(PetscObjectStateIncrease((PetscObject)A));
+    nnz0 -= m;
+    nnz1 -= m;
+    if (nnz0 > 0) PetscCall(PetscInfo(NULL, "Filtering left %g%% edges in graph\n", 100 * (double)nnz1 / (double)nnz0));
+    else PetscCall(PetscInfo(NULL, "Warning: %" PetscInt_FMT " edges to filter with %" PetscInt_FMT " rows\n", nnz0, m));
   } else {
     const PetscInt *ranges;
     PetscMPIInt     rank, size;
@@ -968,7 +968,8 @@ int main(int argc, char **argv)
    test:
      requires: !single
      suffix: mis_view_detailed
-     args: -pc_type gamg -ksp_view ::ascii_info_detail -pc_gamg_mat_coarsen_type mis
+     output_file: output/ex5_mis_view_detailed.out
+     args: -pc_type gamg -ksp_view ::ascii_info_detail -pc_gamg_mat_coarsen_type mis -pc_gamg_mat_coarsen_luby {{false true}}
 
    test:
      requires: !single
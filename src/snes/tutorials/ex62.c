@@ -948,6 +948,24 @@ int main(int argc, char **argv)
       -ksp_type fgmres -ksp_atol 1e-5 -ksp_error_if_not_converged \
       -pc_type patch -pc_patch_partition_of_unity 0 -pc_patch_construct_codim 0 -pc_patch_construct_type vanka \
         -pc_patch_dense_inverse -pc_patch_sub_mat_type seqdense
+  test:
+    suffix: 2d_q1_p0_vanka_densebatch
+    output_file: output/empty.out
+    requires: double !complex
+    args: -sol quadratic -dm_plex_simplex 0 -dm_refine 2 -vel_petscspace_degree 1 -pres_petscspace_degree 0 -petscds_jac_pre 0 \
+      -snes_rtol 1.0e-4 \
+      -ksp_type fgmres -ksp_atol 1e-5 -ksp_error_if_not_converged \
+      -pc_type patch -pc_patch_partition_of_unity 0 -pc_patch_construct_codim 0 -pc_patch_construct_type vanka \
+        -pc_patch_dense_batch -pc_patch_dense_reuse {{0 1}} -pc_patch_sub_mat_type seqdense
+  test:
+    suffix: 2d_q1_p0_vanka_densebatch_reuse
+    requires: double !complex
+    args: -sol quadratic -dm_plex_simplex 0 -dm_refine 2 -vel_petscspace_degree 1 -pres_petscspace_degree 0 -petscds_jac_pre 0 \
+      -snes_rtol 1.0e-14 -snes_atol 0 -snes_max_it 2 \
+      -ksp_type fgmres -ksp_rtol 1e-3 \
+      -pc_type patch -pc_patch_partition_of_unity 0 -pc_patch_construct_codim 0 -pc_patch_construct_type vanka \
+        -pc_patch_dense_batch -pc_patch_dense_reuse -pc_patch_sub_mat_type seqdense -info :pc
+    filter: grep -E "packs of patches"
   #   Vanka smoother
   test:
     suffix: 2d_q1_p0_gmg_vanka
@@ -0,0 +1,795 @@
+/*
+       Index sets stored as a list of contiguous segments, each
+    defined by a start and a length.
+*/
+#include <petsc/private/isimpl.h> /*I   "petscis.h"   I*/
+#include <petscviewer.h>
+
+typedef struct {
+  PetscInt  nseg;     /* number of (nonempty) segments */
+  PetscInt *start;    /* first index of each segment */
+  PetscInt *offset;   /* offset[s] is the location of the first index of segment s, offset[nseg] is the local size */
+  PetscBool borrowed; /* start[] and offset[] belong to the ISSEGMENT this one was created from with ISOnComm() and PETSC_USE_POINTER */
+} IS_Segment;
+
+/* Frees the segments, unless they are borrowed from another index set */
+static PetscErrorCode ISSegmentFreeSegments_Private(IS_Segment *sub)
+{
+  PetscFunctionBegin;
+  if (!sub->borrowed) PetscCall(PetscFree2(sub->start, sub->offset));
+  sub->start    = NULL;
+  sub->offset   = NULL;
+  sub->borrowed = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Sets the segments, taking ownership of start[] and offset[] */
+static PetscErrorCode ISSegmentSetSegments_Private(IS is, PetscInt nseg, PetscInt start[], PetscInt offset[])
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscLayout map;
+  PetscInt    n = offset[nseg];
+
+  PetscFunctionBegin;
+  PetscCall(PetscLayoutCreateFromSizes(PetscObjectComm((PetscObject)is), n, PETSC_DECIDE, is->map->bs, &map));
+  PetscCall(PetscLayoutDestroy(&is->map));
+  is->map = map;
+
+  PetscCall(ISSegmentFreeSegments_Private(sub));
+  sub->nseg   = nseg;
+  sub->start  = start;
+  sub->offset = offset;
+
+  is->min = PETSC_INT_MAX;
+  is->max = PETSC_INT_MIN;
+  for (PetscInt s = 0; s < nseg; s++) {
+    is->min = PetscMin(is->min, start[s]);
+    is->max = PetscMax(is->max, start[s] + offset[s + 1] - offset[s] - 1);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Run-length encodes a list of indices into segments of consecutive integers */
+static PetscErrorCode ISSegmentEncode_Private(PetscInt n, const PetscInt idx[], PetscInt *nseg, PetscInt *start[], PetscInt *offset[])
+{
+  PetscInt s = 0;
+
+  PetscFunctionBegin;
+  *nseg = 0;
+  for (PetscInt i = 0; i < n; i++)
+    if (!i || idx[i] != idx[i - 1] + 1) (*nseg)++;
+  PetscCall(PetscMalloc2(*nseg, start, *nseg + 1, offset));
+  for (PetscInt i = 0; i < n; i++) {
+    if (!i || idx[i] != idx[i - 1] + 1) {
+      (*start)[s]  = idx[i];
+      (*offset)[s] = i;
+      s++;
+    }
+  }
+  (*offset)[*nseg] = n;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Returns copies of the segments (as start and length) sorted by their start */
+static PetscErrorCode ISSegmentGetSortedSegments_Private(IS is, PetscInt *start[], PetscInt *len[])
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc2(sub->nseg, start, sub->nseg, len));
+  for (PetscInt s = 0; s < sub->nseg; s++) {
+    (*start)[s] = sub->start[s];
+    (*len)[s]   = sub->offset[s + 1] - sub->offset[s];
+  }
+  PetscCall(PetscSortIntWithArray(sub->nseg, *start, *len));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Merges sorted segments (given as start and length) into disjoint, non-adjacent intervals [start, end) */
+static PetscErrorCode ISSegmentMergeSorted_Private(PetscInt nseg, const PetscInt start[], const PetscInt len[], PetscInt *nint, PetscInt istart[], PetscInt iend[])
+{
+  PetscFunctionBegin;
+  *nint = 0;
+  for (PetscInt s = 0; s < nseg; s++) {
+    if (*nint && start[s] <= iend[*nint - 1]) iend[*nint - 1] = PetscMax(iend[*nint - 1], start[s] + len[s]);
+    else {
+      istart[*nint] = start[s];
+      iend[*nint]   = start[s] + len[s];
+      (*nint)++;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Creates an ISSEGMENT from disjoint intervals [istart, iend) */
+static PetscErrorCode ISCreateSegmentFromIntervals_Private(MPI_Comm comm, PetscInt nint, const PetscInt istart[], const PetscInt iend[], IS *is)
+{
+  PetscInt *start, *offset, nseg = 0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc2(nint, &start, nint + 1, &offset));
+  offset[0] = 0;
+  for (PetscInt s = 0; s < nint; s++) {
+    if (iend[s] <= istart[s]) continue;
+    start[nseg]      = istart[s];
+    offset[nseg + 1] = offset[nseg] + iend[s] - istart[s];
+    nseg++;
+  }
+  PetscCall(ISCreate(comm, is));
+  PetscCall(ISSetType(*is, ISSEGMENT));
+  PetscCall(ISSegmentSetSegments_Private(*is, nseg, start, offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISDuplicateSegments_Private(IS is, PetscInt shift, PetscInt *start[], PetscInt *offset[])
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc2(sub->nseg, start, sub->nseg + 1, offset));
+  for (PetscInt s = 0; s < sub->nseg; s++) (*start)[s] = sub->start[s] + shift;
+  PetscCall(PetscArraycpy(*offset, sub->offset, sub->nseg + 1));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISCopy_Segment(IS is, IS isy)
+{
+  PetscInt *start, *offset;
+
+  PetscFunctionBegin;
+  PetscCall(ISDuplicateSegments_Private(is, 0, &start, &offset));
+  PetscCall(ISSegmentSetSegments_Private(isy, ((IS_Segment *)is->data)->nseg, start, offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISShift_Segment(IS is, PetscInt shift, IS isy)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *start, *offset, min = isy->min, max = isy->max;
+
+  PetscFunctionBegin;
+  PetscCall(ISDuplicateSegments_Private(is, shift, &start, &offset));
+  PetscCall(ISSegmentSetSegments_Private(isy, sub->nseg, start, offset));
+  /* ISShift() already computed the saturated range */
+  isy->min = min;
+  isy->max = max;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISDuplicate_Segment(IS is, IS *newIS)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *start, *offset;
+
+  PetscFunctionBegin;
+  PetscCall(ISDuplicateSegments_Private(is, 0, &start, &offset));
+  PetscCall(ISCreate(PetscObjectComm((PetscObject)is), newIS));
+  PetscCall(ISSetType(*newIS, ISSEGMENT));
+  PetscCall(PetscLayoutSetBlockSize((*newIS)->map, is->map->bs));
+  PetscCall(ISSegmentSetSegments_Private(*newIS, sub->nseg, start, offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISDestroy_Segment(IS is)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+
+  PetscFunctionBegin;
+  PetscCall(ISSegmentFreeSegments_Private(sub));
+  PetscCall(PetscObjectComposeFunction((PetscObject)is, "ISSegmentSetSegments_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)is, "ISSegmentSetIndices_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)is, "ISShift_C", NULL));
+  PetscCall(PetscFree(is->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+     The indices are expanded on demand and freed in ISRestoreIndices(),
+   so the compressed representation is the only one kept in memory.
+*/
+static PetscErrorCode ISGetIndices_Segment(IS is, const PetscInt *idx[])
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *dx;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc1(is->map->n, &dx));
+  for (PetscInt s = 0; s < sub->nseg; s++) {
+    for (PetscInt i = sub->offset[s], j = sub->start[s]; i < sub->offset[s + 1]; i++, j++) dx[i] = j;
+  }
+  *idx = dx;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISRestoreIndices_Segment(IS is, const PetscInt *idx[])
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree(*(void **)idx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISToGeneral_Segment(IS inis)
+{
+  const PetscInt *idx;
+  PetscInt        n;
+
+  PetscFunctionBegin;
+  PetscCall(ISGetLocalSize(inis, &n));
+  PetscCall(ISGetIndices(inis, &idx));
+  PetscCall(ISSetType(inis, ISGENERAL));
+  PetscCall(ISGeneralSetIndices(inis, n, idx, PETSC_OWN_POINTER));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISInvertPermutation_Segment(IS is, PetscInt nlocal, IS *perm)
+{
+  IS              tmp;
+  const PetscInt *indices;
+
+  PetscFunctionBegin;
+  PetscCall(ISGetIndices(is, &indices));
+  PetscCall(ISCreateGeneral(PetscObjectComm((PetscObject)is), is->map->n, indices, PETSC_COPY_VALUES, &tmp));
+  PetscCall(ISSetPermutation(tmp));
+  PetscCall(ISRestoreIndices(is, &indices));
+  PetscCall(ISInvertPermutation(tmp, nlocal, perm));
+  PetscCall(ISDestroy(&tmp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSortedLocal_Segment(IS is, PetscBool *flg)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+
+  PetscFunctionBegin;
+  *flg = PETSC_TRUE;
+  for (PetscInt s = 1; s < sub->nseg; s++) {
+    if (sub->start[s] < sub->start[s - 1] + sub->offset[s] - sub->offset[s - 1] - 1) {
+      *flg = PETSC_FALSE;
+      break;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSorted_Segment(IS is, PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscCall(ISGetInfo(is, IS_SORTED, IS_LOCAL, PETSC_TRUE, flg));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISUniqueLocal_Segment(IS is, PetscBool *flg)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *start, *len;
+
+  PetscFunctionBegin;
+  PetscCall(ISSegmentGetSortedSegments_Private(is, &start, &len));
+  *flg = PETSC_TRUE;
+  for (PetscInt s = 1; s < sub->nseg; s++) {
+    if (start[s] < start[s - 1] + len[s - 1]) {
+      *flg = PETSC_FALSE;
+      break;
+    }
+  }
+  PetscCall(PetscFree2(start, len));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISIntervalLocal_Segment(IS is, PetscBool *flg)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+
+  PetscFunctionBegin;
+  *flg = PETSC_TRUE;
+  for (PetscInt s = 1; s < sub->nseg; s++) {
+    if (sub->start[s] != sub->start[s - 1] + sub->offset[s] - sub->offset[s - 1]) {
+      *flg = PETSC_FALSE;
+      break;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISPermutationLocal_Segment(IS is, PetscBool *flg)
+{
+  PetscFunctionBegin;
+  *flg = PETSC_TRUE;
+  if (!is->map->n) PetscFunctionReturn(PETSC_SUCCESS);
+  if (is->min != 0 || is->max != is->map->n - 1) *flg = PETSC_FALSE;
+  else PetscCall(ISUniqueLocal_Segment(is, flg));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISContiguousLocal_Segment(IS is, PetscInt gstart, PetscInt gend, PetscInt *start, PetscBool *contig)
+{
+  PetscBool interval;
+
+  PetscFunctionBegin;
+  *start  = -1;
+  *contig = PETSC_FALSE;
+  if (!is->map->n) {
+    *start  = 0;
+    *contig = PETSC_TRUE;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(ISIntervalLocal_Segment(is, &interval));
+  if (interval && is->min >= gstart && is->max < gend) {
+    *start  = is->min - gstart;
+    *contig = PETSC_TRUE;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISLocate_Segment(IS is, PetscInt key, PetscInt *location)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscBool   sorted;
+
+  PetscFunctionBegin;
+  *location = -1;
+  PetscCall(ISGetInfo(is, IS_SORTED, IS_LOCAL, PETSC_TRUE, &sorted));
+  if (sorted) {
+    PetscInt s;
+
+    /* the segment starts are sorted, so the key can only be in the last segment starting at or before it */
+    PetscCall(PetscFindInt(key, sub->nseg, sub->start, &s));
+    if (s < 0) s = -(s + 1) - 1;
+    if (s >= 0 && key - sub->start[s] < sub->offset[s + 1] - sub->offset[s]) *location = sub->offset[s] + key - sub->start[s];
+  } else {
+    for (PetscInt s = 0; s < sub->nseg; s++) {
+      if (key >= sub->start[s] && key - sub->start[s] < sub->offset[s + 1] - sub->offset[s]) {
+        *location = sub->offset[s] + key - sub->start[s];
+        break;
+      }
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSort_Segment(IS is)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *start, *len, *offset, nseg = sub->nseg;
+  PetscBool   unique;
+
+  PetscFunctionBegin;
+  PetscCall(ISUniqueLocal_Segment(is, &unique));
+  if (unique) {
+    /* the segments do not overlap, so reordering them sorts the indices */
+    PetscCall(ISSegmentGetSortedSegments_Private(is, &start, &len));
+    PetscCall(ISSegmentFreeSegments_Private(sub));
+    PetscCall(PetscMalloc2(nseg, &sub->start, nseg + 1, &sub->offset));
+    sub->offset[0] = 0;
+    for (PetscInt s = 0; s < nseg; s++) {
+      sub->start[s]      = start[s];
+      sub->offset[s + 1] = sub->offset[s] + len[s];
+    }
+    PetscCall(PetscFree2(start, len));
+  } else {
+    const PetscInt *idx;
+    PetscInt       *sidx, n = is->map->n;
+
+    PetscCall(ISGetIndices(is, &idx));
+    PetscCall(PetscMalloc1(n, &sidx));
+    PetscCall(PetscArraycpy(sidx, idx, n));
+    PetscCall(ISRestoreIndices(is, &idx));
+    PetscCall(PetscIntSortSemiOrdered(n, sidx));
+    PetscCall(ISSegmentEncode_Private(n, sidx, &nseg, &start, &offset));
+    PetscCall(PetscFree(sidx));
+    PetscCall(ISSegmentFreeSegments_Private(sub));
+    sub->nseg   = nseg;
+    sub->start  = start;
+    sub->offset = offset;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSortRemoveDups_Segment(IS is)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *start, *len, *istart, *iend, *offset, nint;
+
+  PetscFunctionBegin;
+  PetscCall(ISSegmentGetSortedSegments_Private(is, &start, &len));
+  PetscCall(PetscMalloc2(sub->nseg, &istart, sub->nseg + 1, &iend));
+  PetscCall(ISSegmentMergeSorted_Private(sub->nseg, start, len, &nint, istart, iend));
+  PetscCall(PetscFree2(start, len));
+  /* reuse iend[] as the offset array */
+  offset = iend;
+  for (PetscInt s = nint; s > 0; s--) offset[s] = iend[s - 1] - istart[s - 1];
+  offset[0] = 0;
+  for (PetscInt s = 0; s < nint; s++) offset[s + 1] += offset[s];
+  PetscCall(ISSegmentSetSegments_Private(is, nint, istart, offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISView_Segment(IS is, PetscViewer viewer)
+{
+  IS_Segment       *sub = (IS_Segment *)is->data;
+  PetscMPIInt       rank, size;
+  PetscBool         isascii, ibinary;
+  PetscViewerFormat fmt;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERBINARY, &ibinary));
+  if (isascii) {
+    PetscCallMPI(MPI_Comm_rank(PetscObjectComm((PetscObject)is), &rank));
+    PetscCallMPI(MPI_Comm_size(PetscObjectComm((PetscObject)is), &size));
+    PetscCall(PetscViewerGetFormat(viewer, &fmt));
+    PetscCall(PetscViewerASCIIPushSynchronized(viewer));
+    if (fmt == PETSC_VIEWER_ASCII_MATLAB) {
+      const char *name;
+
+      PetscCall(PetscObjectGetName((PetscObject)is, &name));
+      if (size > 1) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "%s_%d = [", name, rank));
+      else PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "%s = [", name));
+      for (PetscInt s = 0; s < sub->nseg; s++) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "%s%" PetscInt_FMT " : %" PetscInt_FMT, s ? ", " : "", sub->start[s] + 1, sub->start[s] + sub->offset[s + 1] - sub->offset[s]));
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "];\n"));
+    } else {
+      if (size > 1) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "[%d] ", rank));
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "Number of indices in (segment) set %" PetscInt_FMT ", number of segments %" PetscInt_FMT "\n", is->map->n, sub->nseg));
+      for (PetscInt s = 0; s < sub->nseg; s++) {
+        if (size > 1) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "[%d] ", rank));
+        PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "%" PetscInt_FMT " [%" PetscInt_FMT ", %" PetscInt_FMT ")\n", sub->offset[s], sub->start[s], sub->start[s] + sub->offset[s + 1] - sub->offset[s]));
+      }
+    }
+    PetscCall(PetscViewerFlush(viewer));
+    PetscCall(PetscViewerASCIIPopSynchronized(viewer));
+  } else if (ibinary) PetscCall(ISView_Binary(is, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISLoad_Segment(IS is, PetscViewer viewer)
+{
+  IS              tmp;
+  const PetscInt *idx;
+  const char     *name;
+  PetscInt        n;
+
+  PetscFunctionBegin;
+  PetscCall(ISCreate(PetscObjectComm((PetscObject)is), &tmp));
+  PetscCall(ISSetType(tmp, ISGENERAL));
+  PetscCall(PetscObjectGetName((PetscObject)is, &name));
+  PetscCall(PetscObjectSetName((PetscObject)tmp, name));
+  PetscCall(ISLoad(tmp, viewer));
+  PetscCall(ISGetLocalSize(tmp, &n));
+  PetscCall(ISGetIndices(tmp, &idx));
+  PetscCall(ISSegmentSetIndices(is, n, idx));
+  PetscCall(ISRestoreIndices(tmp, &idx));
+  PetscCall(ISDestroy(&tmp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISOnComm_Segment(IS is, MPI_Comm comm, PetscCopyMode mode, IS *newis)
+{
+  IS_Segment *sub = (IS_Segment *)is->data;
+  PetscInt   *start, *offset;
+
+  PetscFunctionBegin;
+  PetscCheck(mode != PETSC_OWN_POINTER, comm, PETSC_ERR_ARG_WRONG, "Cannot use PETSC_OWN_POINTER");
+  if (mode == PETSC_COPY_VALUES) PetscCall(ISDuplicateSegments_Private(is, 0, &start, &offset));
+  else {
+    start  = sub->start;
+    offset = sub->offset;
+  }
+  PetscCall(ISCreate(comm, newis));
+  PetscCall(ISSetType(*newis, ISSEGMENT));
+  PetscCall(PetscLayoutSetBlockSize((*newis)->map, is->map->bs));
+  PetscCall(ISSegmentSetSegments_Private(*newis, sub->nseg, start, offset));
+  ((IS_Segment *)(*newis)->data)->borrowed = (PetscBool)(mode == PETSC_USE_POINTER);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSetBlockSize_Segment(IS is, PetscInt bs)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscLayoutSetBlockSize(is->map, bs));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+// clang-format off
+static const struct _ISOps myops = {
+  PetscDesignatedInitializer(getindices, ISGetIndices_Segment),
+  PetscDesignatedInitializer(restoreindices, ISRestoreIndices_Segment),
+  PetscDesignatedInitializer(invertpermutation, ISInvertPermutation_Segment),
+  PetscDesignatedInitializer(sort, ISSort_Segment),
+  PetscDesignatedInitializer(sortremovedups, ISSortRemoveDups_Segment),
+  PetscDesignatedInitializer(sorted, ISSorted_Segment),
+  PetscDesignatedInitializer(duplicate, ISDuplicate_Segment),
+  PetscDesignatedInitializer(destroy, ISDestroy_Segment),
+  PetscDesignatedInitializer(view, ISView_Segment),
+  PetscDesignatedInitializer(load, ISLoad_Segment),
+  PetscDesignatedInitializer(copy, ISCopy_Segment),
+  PetscDesignatedInitializer(togeneral, ISToGeneral_Segment),
+  PetscDesignatedInitializer(oncomm, ISOnComm_Segment),
+  PetscDesignatedInitializer(setblocksize, ISSetBlockSize_Segment),
+  PetscDesignatedInitializer(contiguous, ISContiguousLocal_Segment),
+  PetscDesignatedInitializer(locate, ISLocate_Segment),
+  PetscDesignatedInitializer(sortedlocal, ISSortedLocal_Segment),
+  PetscDesignatedInitializer(sortedglobal, NULL),
+  PetscDesignatedInitializer(uniquelocal, ISUniqueLocal_Segment),
+  PetscDesignatedInitializer(uniqueglobal, NULL),
+  PetscDesignatedInitializer(permlocal, ISPermutationLocal_Segment),
+  PetscDesignatedInitializer(permglobal, NULL),
+  PetscDesignatedInitializer(intervallocal, ISIntervalLocal_Segment),
+  PetscDesignatedInitializer(intervalglobal, NULL)
+};
+// clang-format on
+
+/*
+  ISDifference_Segment - computes is1 - is2 for two index sets of type ISSEGMENT with interval arithmetic,
+  with the same result as ISDifference(), i.e. the sorted unique nonnegative indices of is1 not in is2
+*/
+PETSC_INTERN PetscErrorCode ISDifference_Segment(IS is1, IS is2, IS *isout)
+{
+  PetscInt *s1, *l1, *s2, *l2, *b1, *e1, *b2, *e2, *bout, *eout, n1, n2, nout = 0;
+
+  PetscFunctionBegin;
+  PetscCall(ISSegmentGetSortedSegments_Private(is1, &s1, &l1));
+  PetscCall(ISSegmentGetSortedSegments_Private(is2, &s2, &l2));
+  n1 = ((IS_Segment *)is1->data)->nseg;
+  n2 = ((IS_Segment *)is2->data)->nseg;
+  PetscCall(PetscMalloc4(n1, &b1, n1, &e1, n2, &b2, n2, &e2));
+  PetscCall(ISSegmentMergeSorted_Private(n1, s1, l1, &n1, b1, e1));
+  PetscCall(ISSegmentMergeSorted_Private(n2, s2, l2, &n2, b2, e2));
+  PetscCall(PetscFree2(s1, l1));
+  PetscCall(PetscFree2(s2, l2));
+  /* each interval of is2 can split at most one interval of is1 */
+  PetscCall(PetscMalloc2(n1 + n2, &bout, n1 + n2, &eout));
+  for (PetscInt i = 0, j = 0; i < n1; i++) {
+    PetscInt b = PetscMax(b1[i], 0), e = e1[i];
+
+    while (j < n2 && e2[j] <= b) j++;
+    for (PetscInt k = j; k < n2 && b2[k] < e; k++) {
+      if (b2[k] > b) {
+        bout[nout]   = b;
+        eout[nout++] = b2[k];
+      }
+      b = PetscMax(b, e2[k]);
+    }
+    if (b < e) {
+      bout[nout]   = b;
+      eout[nout++] = e;
+    }
+  }
+  PetscCall(ISCreateSegmentFromIntervals_Private(PetscObjectComm((PetscObject)is1), nout, bout, eout, isout));
+  PetscCall(PetscFree4(b1, e1, b2, e2));
+  PetscCall(PetscFree2(bout, eout));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  ISSum_Segment - computes the union of two sorted index sets of type ISSEGMENT without duplicates with interval arithmetic,
+  with the same result as ISSum()
+*/
+PETSC_INTERN PetscErrorCode ISSum_Segment(IS is1, IS is2, IS *is3)
+{
+  IS_Segment *sub1 = (IS_Segment *)is1->data, *sub2 = (IS_Segment *)is2->data;
+  PetscInt   *start, *len, *b, *e, nseg = sub1->nseg + sub2->nseg, nint;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc2(nseg, &start, nseg, &len));
+  PetscCall(PetscMalloc2(nseg, &b, nseg, &e));
+  /* merge the two sorted segment lists */
+  for (PetscInt i = 0, j = 0, k = 0; k < nseg; k++) {
+    if (j == sub2->nseg || (i < sub1->nseg && sub1->start[i] <= sub2->start[j])) {
+      start[k] = sub1->start[i];
+      len[k]   = sub1->offset[i + 1] - sub1->offset[i];
+      i++;
+    } else {
+      start[k] = sub2->start[j];
+      len[k]   = sub2->offset[j + 1] - sub2->offset[j];
+      j++;
+    }
+  }
+  PetscCall(ISSegmentMergeSorted_Private(nseg, start, len, &nint, b, e));
+  PetscCall(ISCreateSegmentFromIntervals_Private(PetscObjectComm((PetscObject)is1), nint, b, e, is3));
+  PetscCall(PetscFree2(start, len));
+  PetscCall(PetscFree2(b, e));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  ISLocalToGlobalMappingApplySegment_Private - applies a mapping to the segments of an ISSEGMENT without expanding its indices;
+  the indices must be nonnegative and the output array must have the local size of the index set
+*/
+PETSC_INTERN PetscErrorCode ISLocalToGlobalMappingApplySegment_Private(ISLocalToGlobalMapping mapping, IS is, PetscInt out[])
+{
+  IS_Segment     *sub = (IS_Segment *)is->data;
+  const PetscInt *idx = mapping->indices;
+  PetscInt        bs = mapping->bs, Nmax = mapping->bs * mapping->n;
+
+  PetscFunctionBegin;
+  PetscCheck(is->max < Nmax, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Local index %" PetscInt_FMT " too large %" PetscInt_FMT " (max)", is->max, Nmax - 1);
+  for (PetscInt s = 0; s < sub->nseg; s++) {
+    PetscInt first = sub->start[s], len = sub->offset[s + 1] - sub->offset[s];
+
+    if (bs == 1) PetscCall(PetscArraycpy(out + sub->offset[s], idx + first, len));
+    else {
+      for (PetscInt i = 0, j = first; i < len; i++, j++) out[sub->offset[s] + i] = idx[j / bs] * bs + (j % bs);
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  ISSegmentSetSegments - Sets the segments of an `ISSEGMENT` index set
+
+  Collective
+
+  Input Parameters:
++ is     - the index set
+. nseg   - the number of segments
+. start  - the first index of each segment
+- length - the number of consecutive indices in each segment
+
+  Level: intermediate
+
+  Notes:
+  The local indices of `is` are start[0], start[0]+1, ..., start[0]+length[0]-1, start[1], ... Segments of zero length are dropped.
+
+  The arrays are copied and may be freed by the caller after this call.
+
+  `ISCreateSegment()` can be used to create an `ISSEGMENT` and set its segments in one function call
+
+.seealso: [](sec_scatter), `IS`, `ISSEGMENT`, `ISCreateSegment()`, `ISSegmentSetIndices()`, `ISSegmentGetSegments()`
+@*/
+PetscErrorCode ISSegmentSetSegments(IS is, PetscInt nseg, const PetscInt start[], const PetscInt length[])
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(is, IS_CLASSID, 1);
+  PetscCheck(nseg >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Negative number of segments %" PetscInt_FMT, nseg);
+  if (nseg) {
+    PetscAssertPointer(start, 3);
+    PetscAssertPointer(length, 4);
+  }
+  PetscCall(ISClearInfoCache(is, PETSC_FALSE));
+  PetscUseMethod(is, "ISSegmentSetSegments_C", (IS, PetscInt, const PetscInt[], const PetscInt[]), (is, nseg, start, length));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSegmentSetSegments_Segment(IS is, PetscInt nseg, const PetscInt start[], const PetscInt length[])
+{
+  PetscInt *sstart, *offset, n = 0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc2(nseg, &sstart, nseg + 1, &offset));
+  offset[0] = 0;
+  for (PetscInt s = 0; s < nseg; s++) {
+    PetscCheck(length[s] >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Segment %" PetscInt_FMT " has negative length %" PetscInt_FMT, s, length[s]);
+    if (!length[s]) continue;
+    sstart[n]     = start[s];
+    offset[n + 1] = offset[n] + length[s];
+    n++;
+  }
+  PetscCall(ISSegmentSetSegments_Private(is, n, sstart, offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  ISSegmentSetIndices - Sets the indices of an `ISSEGMENT` index set from a list of integers, storing each run of consecutive integers as one segment
+
+  Collective
+
+  Input Parameters:
++ is  - the index set
+. n   - the length of the list of indices
+- idx - the list of integers
+
+  Level: intermediate
+
+  Note:
+  The array is not referenced after this call and may be freed by the caller.
+
+.seealso: [](sec_scatter), `IS`, `ISSEGMENT`, `ISCreateSegment()`, `ISSegmentSetSegments()`, `ISGeneralSetIndices()`
+@*/
+PetscErrorCode ISSegmentSetIndices(IS is, PetscInt n, const PetscInt idx[])
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(is, IS_CLASSID, 1);
+  PetscCheck(n >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "length < 0");
+  if (n) PetscAssertPointer(idx, 3);
+  PetscCall(ISClearInfoCache(is, PETSC_FALSE));
+  PetscUseMethod(is, "ISSegmentSetIndices_C", (IS, PetscInt, const PetscInt[]), (is, n, idx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode ISSegmentSetIndices_Segment(IS is, PetscInt n, const PetscInt idx[])
+{
+  PetscInt *start, *offset, nseg;
+
+  PetscFunctionBegin;
+  PetscCall(ISSegmentEncode_Private(n, idx, &nseg, &start, &offset));
+  PetscCall(ISSegmentSetSegments_Private(is, nseg, start, offset));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@C
+  ISSegmentGetSegments - Returns the segments of an `IS` of `ISType` `ISSEGMENT`
+
+  Not Collective
+
+  Input Parameter:
+. is - the index set
+
+  Output Parameters:
++ nseg   - the number of segments, pass `NULL` if not needed
+. start  - the first index of each segment, pass `NULL` if not needed
+- offset - the location of the first index of each segment in the local indices, with `offset[nseg]` the local size; pass `NULL` if not needed
+
+  Level: intermediate
+
+  Note:
+  The arrays are owned by `is` and must not be modified or freed
+
+.seealso: [](sec_scatter), `IS`, `ISSEGMENT`, `ISCreateSegment()`, `ISSegmentSetSegments()`
+@*/
+PetscErrorCode ISSegmentGetSegments(IS is, PetscInt *nseg, const PetscInt *start[], const PetscInt *offset[])
+{
+  IS_Segment *sub;
+  PetscBool   flg;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(is, IS_CLASSID, 1);
+  PetscCall(PetscObjectTypeCompare((PetscObject)is, ISSEGMENT, &flg));
+  PetscCheck(flg, PetscObjectComm((PetscObject)is), PETSC_ERR_ARG_WRONG, "IS must be of type ISSEGMENT");
+  sub = (IS_Segment *)is->data;
+  if (nseg) *nseg = sub->nseg;
+  if (start) *start = sub->start;
+  if (offset) *offset = sub->offset;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  ISCreateSegment - Creates a data structure for an index set containing a list of segments of consecutive integers.
+
+  Collective
+
+  Input Parameters:
++ comm   - the MPI communicator
+. nseg   - the number of segments in the locally owned portion of the index set
+. start  - the first index of each segment
+- length - the number of consecutive indices in each segment
+
+  Output Parameter:
+. is - the new index set
+
+  Level: intermediate
+
+  Notes:
+  The memory used by the index set is proportional to the number of segments, not to the number of indices. This is much smaller than `ISGENERAL`
+  for index sets made of long contiguous runs, such as the fields of a `PCFIELDSPLIT` or the subdomains of `PCASM`.
+
+  `ISGetIndices()` expands the indices on demand, while `ISLocate()`, `ISSorted()`, `ISSum()`, `ISDifference()` and `ISLocalToGlobalMappingApplyIS()`
+  operate directly on the segments.
+
+  The arrays are copied and may be freed by the caller after this call.
+
+.seealso: [](sec_scatter), `IS`, `ISSEGMENT`, `ISSegmentSetSegments()`, `ISSegmentSetIndices()`, `ISSegmentGetSegments()`, `ISCreateGeneral()`, `ISCreateStride()`
+@*/
+PetscErrorCode ISCreateSegment(MPI_Comm comm, PetscInt nseg, const PetscInt start[], const PetscInt length[], IS *is)
+{
+  PetscFunctionBegin;
+  PetscCall(ISCreate(comm, is));
+  PetscCall(ISSetType(*is, ISSEGMENT));
+  PetscCall(ISSegmentSetSegments(*is, nseg, start, length));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode ISCreate_Segment(IS is)
+{
+  IS_Segment *sub;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&sub));
+  PetscCall(PetscMalloc2(0, &sub->start, 1, &sub->offset));
+  sub->offset[0] = 0;
+  is->data       = (void *)sub;
+  is->ops[0]     = myops;
+  PetscCall(PetscObjectComposeFunction((PetscObject)is, "ISSegmentSetSegments_C", ISSegmentSetSegments_Segment));
+  PetscCall(PetscObjectComposeFunction((PetscObject)is, "ISSegmentSetIndices_C", ISSegmentSetIndices_Segment));
+  PetscCall(PetscObjectComposeFunction((PetscObject)is, "ISShift_C", ISShift_Segment));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -2,6 +2,7 @@
 PETSC_INTERN PetscErrorCode ISCreate_General(IS);
 PETSC_INTERN PetscErrorCode ISCreate_Stride(IS);
 PETSC_INTERN PetscErrorCode ISCreate_Block(IS);
+PETSC_INTERN PetscErrorCode ISCreate_Segment(IS);
 
 /*@
   ISRegisterAll - Registers all of the index set components in the `IS` package.
@@ -21,5 +22,6 @@ PetscErrorCode ISRegisterAll(void)
   PetscCall(ISRegister(ISGENERAL, ISCreate_General));
   PetscCall(ISRegister(ISSTRIDE, ISCreate_Stride));
   PetscCall(ISRegister(ISBLOCK, ISCreate_Block));
+  PetscCall(ISRegister(ISSEGMENT, ISCreate_Segment));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
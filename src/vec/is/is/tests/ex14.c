@@ -0,0 +1,179 @@
+static char help[] = "Tests ISSEGMENT against ISGENERAL with the same indices.\n\n";
+
+#include <petscis.h>
+#include <petscviewer.h>
+
+static PetscErrorCode CheckSame(IS is, IS isg, const char name[])
+{
+  PetscBool flg, flgg;
+  PetscInt  n, ng, loc, locg, min, max;
+
+  PetscFunctionBegin;
+  PetscCall(ISGetLocalSize(is, &n));
+  PetscCall(ISGetLocalSize(isg, &ng));
+  PetscCheck(n == ng, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: local sizes differ %" PetscInt_FMT " != %" PetscInt_FMT, name, n, ng);
+  PetscCall(ISEqualUnsorted(is, isg, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: indices differ", name);
+  PetscCall(ISSorted(is, &flg));
+  PetscCall(ISSorted(isg, &flgg));
+  PetscCheck(flg == flgg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: ISSorted() differs", name);
+  PetscCall(ISGetInfo(is, IS_UNIQUE, IS_LOCAL, PETSC_TRUE, &flg));
+  PetscCall(ISGetInfo(isg, IS_UNIQUE, IS_LOCAL, PETSC_TRUE, &flgg));
+  PetscCheck(flg == flgg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: IS_UNIQUE differs", name);
+  PetscCall(ISGetInfo(is, IS_INTERVAL, IS_LOCAL, PETSC_TRUE, &flg));
+  PetscCall(ISGetInfo(isg, IS_INTERVAL, IS_LOCAL, PETSC_TRUE, &flgg));
+  PetscCheck(flg == flgg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: IS_INTERVAL differs", name);
+  PetscCall(ISGetInfo(is, IS_PERMUTATION, IS_LOCAL, PETSC_TRUE, &flg));
+  PetscCall(ISGetInfo(isg, IS_PERMUTATION, IS_LOCAL, PETSC_TRUE, &flgg));
+  PetscCheck(flg == flgg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: IS_PERMUTATION differs", name);
+  PetscCall(ISGetMinMax(isg, &min, &max));
+  for (PetscInt key = (n ? min : 0) - 2; key <= (n ? max : 0) + 2; key++) {
+    const PetscInt *idx;
+
+    PetscCall(ISLocate(is, key, &loc));
+    PetscCall(ISLocate(isg, key, &locg));
+    PetscCheck((loc < 0) == (locg < 0), PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: ISLocate() of %" PetscInt_FMT " differs", name, key);
+    PetscCall(ISGetIndices(isg, &idx));
+    PetscCheck(loc < 0 || idx[loc] == key, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: ISLocate() of %" PetscInt_FMT " is wrong", name, key);
+    PetscCall(ISRestoreIndices(isg, &idx));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  /* segments overlap, are unsorted and include an empty segment */
+  const PetscInt         start[] = {10, 0, 5, 3, 30}, length[] = {4, 3, 0, 4, 2};
+  const PetscInt         start2[] = {12, 2, 31}, length2[] = {10, 3, 1};
+  PetscInt               nseg = 5, n = 0, *idx, ltog[64];
+  IS                     is, isg, is2, is2g, tmp, tmpg, out, outg;
+  ISLocalToGlobalMapping map;
+  PetscBool              view = PETSC_FALSE, flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-view", &view, NULL));
+
+  PetscCall(ISCreateSegment(PETSC_COMM_SELF, nseg, start, length, &is));
+  PetscCall(PetscMalloc1(64, &idx));
+  for (PetscInt s = 0; s < nseg; s++)
+    for (PetscInt i = 0; i < length[s]; i++) idx[n++] = start[s] + i;
+  PetscCall(ISCreateGeneral(PETSC_COMM_SELF, n, idx, PETSC_COPY_VALUES, &isg));
+  if (view) PetscCall(ISView(is, PETSC_VIEWER_STDOUT_SELF));
+  PetscCall(CheckSame(is, isg, "create"));
+
+  /* run-length encoding from a list of indices */
+  PetscCall(ISCreate(PETSC_COMM_SELF, &tmp));
+  PetscCall(ISSetType(tmp, ISSEGMENT));
+  PetscCall(ISSegmentSetIndices(tmp, n, idx));
+  PetscCall(CheckSame(tmp, isg, "setindices"));
+  PetscCall(ISDestroy(&tmp));
+
+  PetscCall(ISDuplicate(is, &tmp));
+  PetscCall(ISDuplicate(isg, &tmpg));
+  PetscCall(ISShift(tmp, 7, tmp));
+  PetscCall(ISShift(tmpg, 7, tmpg));
+  PetscCall(CheckSame(tmp, tmpg, "shift"));
+  PetscCall(ISSort(tmp));
+  PetscCall(ISSort(tmpg));
+  PetscCall(CheckSame(tmp, tmpg, "sort"));
+  PetscCall(ISSortRemoveDups(tmp));
+  PetscCall(ISSortRemoveDups(tmpg));
+  PetscCall(CheckSame(tmp, tmpg, "sortremovedups"));
+  if (view) PetscCall(ISView(tmp, PETSC_VIEWER_STDOUT_SELF));
+
+  /* nonoverlapping segments are sorted by reordering the segments */
+  PetscCall(ISCreateSegment(PETSC_COMM_SELF, 3, start2, length2, &is2));
+  PetscCall(ISDuplicate(is2, &is2g));
+  PetscCall(ISToGeneral(is2g));
+  PetscCall(PetscObjectTypeCompare((PetscObject)is2g, ISGENERAL, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "ISToGeneral() failed");
+  PetscCall(CheckSame(is2, is2g, "togeneral"));
+
+  /* ISOnComm() copies or borrows the segments and keeps the block size, a borrowed ISSEGMENT does not free them when sorted */
+  for (PetscInt m = 0; m < 2; m++) {
+    IS       isw, oncomm;
+    PetscInt bs;
+
+    PetscCall(ISCreateSegment(PETSC_COMM_WORLD, 3, start2, length2, &isw));
+    PetscCall(ISSetBlockSize(isw, 2));
+    PetscCall(ISOnComm(isw, PETSC_COMM_SELF, m ? PETSC_USE_POINTER : PETSC_COPY_VALUES, &oncomm));
+    PetscCall(ISGetBlockSize(oncomm, &bs));
+    PetscCheck(bs == 2, PETSC_COMM_SELF, PETSC_ERR_PLIB, "ISOnComm() lost the block size");
+    PetscCall(CheckSame(oncomm, is2g, "oncomm"));
+    if (oncomm != isw) { /* with a single process ISOnComm() returns isw for PETSC_USE_POINTER */
+      const PetscInt *iw, *ig;
+      PetscInt        nw;
+
+      PetscCall(ISSort(oncomm));
+      PetscCall(ISGetLocalSize(isw, &nw));
+      PetscCall(ISGetIndices(isw, &iw));
+      PetscCall(ISGetIndices(is2g, &ig));
+      PetscCall(PetscArraycmp(iw, ig, nw, &flg));
+      PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "ISSort() of the ISOnComm() result changed the original");
+      PetscCall(ISRestoreIndices(is2g, &ig));
+      PetscCall(ISRestoreIndices(isw, &iw));
+    }
+    PetscCall(ISDestroy(&oncomm));
+    PetscCall(ISDestroy(&isw));
+  }
+  PetscCall(ISSort(is2));
+  PetscCall(ISSort(is2g));
+  PetscCall(CheckSame(is2, is2g, "sort segments"));
+
+  PetscCall(ISDifference(is, is2, &out));
+  PetscCall(ISDifference(isg, is2g, &outg));
+  PetscCall(PetscObjectTypeCompare((PetscObject)out, ISSEGMENT, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "ISDifference() of ISSEGMENT is not an ISSEGMENT");
+  PetscCall(CheckSame(out, outg, "difference"));
+  PetscCall(ISDestroy(&out));
+  PetscCall(ISDestroy(&outg));
+
+  PetscCall(ISSum(tmp, is2, &out));
+  PetscCall(ISSum(tmpg, is2g, &outg));
+  PetscCall(PetscObjectTypeCompare((PetscObject)out, ISSEGMENT, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "ISSum() of ISSEGMENT is not an ISSEGMENT");
+  PetscCall(CheckSame(out, outg, "sum"));
+  if (view) PetscCall(ISView(out, PETSC_VIEWER_STDOUT_SELF));
+  PetscCall(ISDestroy(&out));
+  PetscCall(ISDestroy(&outg));
+
+  for (PetscInt i = 0; i < 64; i++) ltog[i] = 1000 - 3 * i;
+  for (PetscInt bs = 1; bs <= 2; bs++) {
+    PetscCall(ISLocalToGlobalMappingCreate(PETSC_COMM_SELF, bs, 64 / bs, ltog, PETSC_COPY_VALUES, &map));
+    PetscCall(ISLocalToGlobalMappingApplyIS(map, is, &out));
+    PetscCall(ISLocalToGlobalMappingApplyIS(map, isg, &outg));
+    PetscCall(ISEqualUnsorted(out, outg, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "ISLocalToGlobalMappingApplyIS() differs for bs %" PetscInt_FMT, bs);
+    PetscCall(ISDestroy(&out));
+    PetscCall(ISDestroy(&outg));
+    PetscCall(ISLocalToGlobalMappingDestroy(&map));
+  }
+
+  PetscCall(PetscFree(idx));
+  PetscCall(ISDestroy(&tmp));
+  PetscCall(ISDestroy(&tmpg));
+  PetscCall(ISDestroy(&is2));
+  PetscCall(ISDestroy(&is2g));
+  PetscCall(ISDestroy(&is));
+  PetscCall(ISDestroy(&isg));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+    test:
+      suffix: 1
+      output_file: output/empty.out
+
+    test:
+      suffix: 2
+      nsize: 2
+      output_file: output/empty.out
+
+    test:
+      suffix: view
+      args: -view
+
+TEST*/
@@ -0,0 +1,95 @@
+static char help[] = "Tests ISGlobalToLocalMappingApply() with ISLOCALTOGLOBALMAPPINGSORTED against ISLOCALTOGLOBALMAPPINGBASIC.\n\n";
+
+#include <petscis.h>
+
+static PetscErrorCode CompareApply(ISLocalToGlobalMapping ltog, ISLocalToGlobalMapping ref, PetscBool block, PetscInt n, const PetscInt idx[])
+{
+  PetscInt *out, *outref, nout, noutref;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc2(n, &out, n, &outref));
+  for (ISGlobalToLocalMappingMode mode = IS_GTOLM_MASK; mode <= IS_GTOLM_DROP; mode = (ISGlobalToLocalMappingMode)(mode + 1)) {
+    if (block) {
+      PetscCall(ISGlobalToLocalMappingApplyBlock(ltog, mode, n, idx, &nout, NULL));
+      PetscCall(ISGlobalToLocalMappingApplyBlock(ltog, mode, n, idx, NULL, out));
+      PetscCall(ISGlobalToLocalMappingApplyBlock(ref, mode, n, idx, &noutref, outref));
+    } else {
+      PetscCall(ISGlobalToLocalMappingApply(ltog, mode, n, idx, &nout, NULL));
+      PetscCall(ISGlobalToLocalMappingApply(ltog, mode, n, idx, NULL, out));
+      PetscCall(ISGlobalToLocalMappingApply(ref, mode, n, idx, &noutref, outref));
+    }
+    PetscCheck(nout == noutref, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Mode %d: %" PetscInt_FMT " indices found instead of %" PetscInt_FMT, (int)mode, nout, noutref);
+    for (PetscInt i = 0; i < nout; i++) PetscCheck(out[i] == outref[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Mode %d: entry %" PetscInt_FMT " is %" PetscInt_FMT " instead of %" PetscInt_FMT, (int)mode, i, out[i], outref[i]);
+  }
+  PetscCall(PetscFree2(out, outref));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  PetscInt               bs = 2, nowned = 50, nghost = 20, nruns = 5, n, nq, *indices, *query;
+  PetscRandom            rand;
+  ISLocalToGlobalMapping ltog, ref;
+  PetscReal              r;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nowned", &nowned, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nghost", &nghost, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_SELF, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+
+  /* a contiguous owned range, runs of ghosts, some random ghosts, duplicates and negative entries */
+  n = nowned + nghost + 3;
+  PetscCall(PetscMalloc1(n, &indices));
+  for (PetscInt i = 0; i < nowned; i++) indices[i] = 1000 + i;
+  for (PetscInt i = 0; i < nghost; i++) {
+    if (i < nghost / 2) indices[nowned + i] = 5000 + 7 * (i / nruns) + i % nruns;
+    else {
+      PetscCall(PetscRandomGetValueReal(rand, &r));
+      indices[nowned + i] = (PetscInt)(r * 10000);
+    }
+  }
+  indices[n - 3] = -1;
+  indices[n - 2] = 1003;
+  indices[n - 1] = indices[nowned];
+  PetscCall(ISLocalToGlobalMappingCreate(PETSC_COMM_SELF, bs, n, indices, PETSC_OWN_POINTER, &ltog));
+  PetscCall(ISLocalToGlobalMappingSetType(ltog, ISLOCALTOGLOBALMAPPINGSORTED));
+  PetscCall(ISLocalToGlobalMappingSetFromOptions(ltog));
+  PetscCall(ISLocalToGlobalMappingDuplicate(ltog, &ref));
+  PetscCall(ISLocalToGlobalMappingSetType(ref, ISLOCALTOGLOBALMAPPINGBASIC));
+
+  /* query every index around the mapped ones, in order and in random order */
+  nq = 12000 * bs;
+  PetscCall(PetscMalloc1(nq, &query));
+  for (PetscInt i = 0; i < nq; i++) query[i] = i - 10;
+  PetscCall(CompareApply(ltog, ref, PETSC_FALSE, nq, query));
+  PetscCall(CompareApply(ltog, ref, PETSC_TRUE, nq / bs, query));
+  for (PetscInt i = 0; i < nq; i++) {
+    PetscCall(PetscRandomGetValueReal(rand, &r));
+    query[i] = (PetscInt)(r * 12000 * bs);
+  }
+  PetscCall(CompareApply(ltog, ref, PETSC_FALSE, nq, query));
+  PetscCall(CompareApply(ltog, ref, PETSC_TRUE, nq, query));
+
+  PetscCall(PetscFree(query));
+  PetscCall(ISLocalToGlobalMappingDestroy(&ltog));
+  PetscCall(ISLocalToGlobalMappingDestroy(&ref));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    output_file: output/empty.out
+    args: -bs {{1 3}}
+
+  test:
+    suffix: empty
+    output_file: output/empty.out
+    args: -nowned 0 -nghost 0
+
+TEST*/
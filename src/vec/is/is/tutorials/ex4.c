@@ -56,4 +56,8 @@ int main(int argc, char **argv)
       suffix: 2
       args: -islocaltoglobalmapping_type hash
 
+   test:
+      suffix: 3
+      args: -islocaltoglobalmapping_type sorted
+
 TEST*/
@@ -23,6 +23,9 @@
   This computation requires O(imax-imin) memory and O(imax-imin)
   work, where imin and imax are the bounds on the indices in is1.
 
+  If both `is1` and `is2` are of type `ISSEGMENT` the difference is computed from the segments, in time
+  proportional to the number of segments, and `isout` is also of type `ISSEGMENT`.
+
   If `is2` is `NULL`, the result is the same as for an empty `IS`, i.e., a duplicate of `is1`.
 
   The difference is computed separately on each MPI rank
@@ -35,6 +38,7 @@ PetscErrorCode ISDifference(IS is1, IS is2, IS *isout)
   const PetscInt *i1, *i2;
   PetscBT         mask;
   MPI_Comm        comm;
+  PetscBool       seg1, seg2;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(is1, IS_CLASSID, 1);
@@ -45,6 +49,13 @@ PetscErrorCode ISDifference(IS is1, IS is2, IS *isout)
   }
   PetscValidHeaderSpecific(is2, IS_CLASSID, 2);
 
+  PetscCall(PetscObjectTypeCompare((PetscObject)is1, ISSEGMENT, &seg1));
+  PetscCall(PetscObjectTypeCompare((PetscObject)is2, ISSEGMENT, &seg2));
+  if (seg1 && seg2) {
+    PetscCall(ISDifference_Segment(is1, is2, isout));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
   PetscCall(ISGetIndices(is1, &i1));
   PetscCall(ISGetLocalSize(is1, &n1));
 
@@ -113,13 +124,16 @@ PetscErrorCode ISDifference(IS is1, IS is2, IS *isout)
 
   Both index sets need to be sorted on input.
 
+  If both `is1` and `is2` are of type `ISSEGMENT` and contain no duplicates, the sum is computed from the segments,
+  in time proportional to the number of segments, and `is3` is also of type `ISSEGMENT`.
+
   The sum is computed separately on each MPI rank
 
 .seealso: [](sec_scatter), `IS`, `ISDestroy()`, `ISView()`, `ISDifference()`, `ISExpand()`
 @*/
 PetscErrorCode ISSum(IS is1, IS is2, IS *is3)
 {
-  PetscBool       f;
+  PetscBool       f, seg1, seg2;
   const PetscInt *i1, *i2;
   PetscInt        n1, n2, n3, p1, p2, *iout;
 
@@ -139,6 +153,18 @@ PetscErrorCode ISSum(IS is1, IS is2, IS *is3)
     PetscCall(ISDuplicate(is1, is3));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
+  PetscCall(PetscObjectTypeCompare((PetscObject)is1, ISSEGMENT, &seg1));
+  PetscCall(PetscObjectTypeCompare((PetscObject)is2, ISSEGMENT, &seg2));
+  if (seg1 && seg2) {
+    PetscBool u1, u2;
+
+    PetscCall(ISGetInfo(is1, IS_UNIQUE, IS_LOCAL, PETSC_TRUE, &u1));
+    PetscCall(ISGetInfo(is2, IS_UNIQUE, IS_LOCAL, PETSC_TRUE, &u2));
+    if (u1 && u2) {
+      PetscCall(ISSum_Segment(is1, is2, is3));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
   PetscCall(ISGetIndices(is1, &i1));
   PetscCall(ISGetIndices(is2, &i2));
 
@@ -7,6 +7,166 @@
 
 PetscClassId PETSC_SECTION_CLASSID;
 
+/*
+  A section may store its layout as ranges of consecutive points with the same number of dof instead of the per-point arrays
+  atlasDof and atlasOff. The offset of the point q in range r is rangeOff[r] + (q - rangeStart[r]) * rangeStride[r].
+  Any modification that cannot be expressed with the ranges converts the section back to arrays with PetscSectionMaterialize_Internal().
+*/
+static PetscErrorCode PetscSectionDestroyRanges_Private(PetscSection s)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree4(s->rangeStart, s->rangeDof, s->rangeOff, s->rangeStride));
+  s->numRanges = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Takes ownership of the arrays, which must have been obtained with PetscMalloc4() */
+static PetscErrorCode PetscSectionSetRanges_Private(PetscSection s, PetscInt numRanges, PetscInt start[], PetscInt dof[], PetscInt off[], PetscInt stride[])
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree2(s->atlasDof, s->atlasOff));
+  PetscCall(PetscSectionDestroyRanges_Private(s));
+  s->numRanges   = numRanges;
+  s->rangeStart  = start;
+  s->rangeDof    = dof;
+  s->rangeOff    = off;
+  s->rangeStride = stride;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Merge neighboring ranges whose points have the same dof and continue the same offset progression */
+static void PetscSectionMergeRanges_Private(PetscInt *numRanges, PetscInt start[], PetscInt dof[], PetscInt off[], PetscInt stride[])
+{
+  PetscInt m = 0;
+
+  for (PetscInt r = 1; r < *numRanges; ++r) {
+    if (dof[r] == dof[m] && stride[r] == stride[m] && off[r] == off[m] + (start[r] - start[m]) * stride[m]) continue;
+    ++m;
+    start[m]  = start[r];
+    dof[m]    = dof[r];
+    off[m]    = off[r];
+    stride[m] = stride[r];
+  }
+  start[m + 1] = start[*numRanges];
+  *numRanges   = m + 1;
+}
+
+PetscErrorCode PetscSectionMaterialize_Internal(PetscSection s)
+{
+  const PetscInt n = s->pEnd - s->pStart;
+
+  PetscFunctionBegin;
+  if (!s->numRanges) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscMalloc2(n, &s->atlasDof, n, &s->atlasOff));
+  for (PetscInt r = 0; r < s->numRanges; ++r) {
+    for (PetscInt q = s->rangeStart[r]; q < s->rangeStart[r + 1]; ++q) {
+      s->atlasDof[q] = s->rangeDof[r];
+      s->atlasOff[q] = s->rangeOff[r] + (q - s->rangeStart[r]) * s->rangeStride[r];
+    }
+  }
+  PetscCall(PetscSectionDestroyRanges_Private(s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Returns the end of the run of points starting at q with equal dof and, if useOff, offsets with a constant stride */
+static inline PetscInt PetscSectionGetRunEnd_Private(PetscSection s, PetscBool useOff, PetscInt q, PetscInt *stride)
+{
+  const PetscInt n = s->pEnd - s->pStart;
+  PetscInt       e = q + 1;
+
+  *stride = 0;
+  if (useOff && e < n && s->atlasDof[e] == s->atlasDof[q]) *stride = s->atlasOff[e] - s->atlasOff[q];
+  while (e < n && s->atlasDof[e] == s->atlasDof[q] && (!useOff || s->atlasOff[e] == s->atlasOff[e - 1] + *stride)) ++e;
+  return e;
+}
+
+/* Switch from the arrays to ranges if this saves memory. If useOff is false the offsets are not meaningful and are dropped */
+static PetscErrorCode PetscSectionEncodeRanges_Private(PetscSection s, PetscBool useOff)
+{
+  const PetscInt n  = s->pEnd - s->pStart;
+  PetscInt       nr = 0, *start, *dof, *off, *stride;
+
+  PetscFunctionBegin;
+  if (s->numRanges || s->bc || n <= 0) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt q = 0, st; q < n; q = PetscSectionGetRunEnd_Private(s, useOff, q, &st)) ++nr;
+  if (4 * nr + 1 >= 2 * n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscMalloc4(nr + 1, &start, nr, &dof, nr, &off, nr, &stride));
+  nr = 0;
+  for (PetscInt q = 0; q < n; q = start[nr + 1], ++nr) {
+    start[nr + 1] = PetscSectionGetRunEnd_Private(s, useOff, q, &stride[nr]);
+    start[nr]     = q;
+    dof[nr]       = s->atlasDof[q];
+    off[nr]       = useOff ? s->atlasOff[q] : 0;
+  }
+  PetscCall(PetscSectionSetRanges_Private(s, nr, start, dof, off, stride));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Give the points [qStart, qEnd), relative to pStart, numDof dof; this is only used before the offsets are computed */
+static PetscErrorCode PetscSectionInsertRange_Private(PetscSection s, PetscInt qStart, PetscInt qEnd, PetscInt numDof)
+{
+  PetscInt nr = 0, *start, *dof, *off, *stride;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc4(s->numRanges + 3, &start, s->numRanges + 2, &dof, s->numRanges + 2, &off, s->numRanges + 2, &stride));
+  for (PetscInt r = 0; r < s->numRanges; ++r) {
+    const PetscInt a = s->rangeStart[r], b = s->rangeStart[r + 1];
+
+    if (a < qStart) {
+      start[nr] = a;
+      dof[nr++] = s->rangeDof[r];
+    }
+    if (a <= qStart && qStart < b) {
+      start[nr] = qStart;
+      dof[nr++] = numDof;
+    }
+    if (qEnd < b) {
+      start[nr] = PetscMax(a, qEnd);
+      dof[nr++] = s->rangeDof[r];
+    }
+  }
+  start[nr] = s->pEnd - s->pStart;
+  PetscCall(PetscArrayzero(off, nr));
+  PetscCall(PetscArrayzero(stride, nr));
+  PetscSectionMergeRanges_Private(&nr, start, dof, off, stride);
+  PetscCall(PetscSectionSetRanges_Private(s, nr, start, dof, off, stride));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Split the ranges so that they begin at the given boundaries, which must include all current range starts */
+static PetscErrorCode PetscSectionRefineRanges_Private(PetscSection s, PetscInt nr, const PetscInt bnd[])
+{
+  PetscInt *start, *dof, *off, *stride;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc4(nr + 1, &start, nr, &dof, nr, &off, nr, &stride));
+  for (PetscInt r = 0; r < nr; ++r) {
+    start[r]  = bnd[r];
+    dof[r]    = PetscSectionGetDof_Private(s, bnd[r]);
+    off[r]    = PetscSectionGetOffset_Private(s, bnd[r]);
+    stride[r] = s->rangeStride[PetscSectionFindRange_Private(s, bnd[r])];
+  }
+  start[nr] = bnd[nr];
+  PetscCall(PetscSectionSetRanges_Private(s, nr, start, dof, off, stride));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscSectionCopyRanges_Private(PetscSection s, PetscSection newSection)
+{
+  const PetscInt nr = s->numRanges;
+  PetscInt      *start, *dof, *off, *stride;
+
+  PetscFunctionBegin;
+  PetscCall(PetscMalloc4(nr + 1, &start, nr, &dof, nr, &off, nr, &stride));
+  PetscCall(PetscArraycpy(start, s->rangeStart, nr + 1));
+  PetscCall(PetscArraycpy(dof, s->rangeDof, nr));
+  PetscCall(PetscArraycpy(off, s->rangeOff, nr));
+  PetscCall(PetscArraycpy(stride, s->rangeStride, nr));
+  PetscCall(PetscSectionSetRanges_Private(newSection, nr, start, dof, off, stride));
+  PetscCall(PetscSectionInvalidateMaxDof_Internal(newSection));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PetscSectionCreate - Allocates a `PetscSection` and sets the map contents to the default.
 
@@ -48,6 +208,11 @@ PetscErrorCode PetscSectionCreate(MPI_Comm comm, PetscSection *s)
   (*s)->includesConstraints = PETSC_TRUE;
   (*s)->atlasDof            = NULL;
   (*s)->atlasOff            = NULL;
+  (*s)->numRanges           = 0;
+  (*s)->rangeStart          = NULL;
+  (*s)->rangeDof            = NULL;
+  (*s)->rangeOff            = NULL;
+  (*s)->rangeStride         = NULL;
   (*s)->bc                  = NULL;
   (*s)->bcIndices           = NULL;
   (*s)->setup               = PETSC_FALSE;
@@ -124,6 +289,19 @@ PetscErrorCode PetscSectionCopy_Internal(PetscSection section, PetscSection newS
   PetscCall(PetscSectionSetPermutation(newSection, perm));
   PetscCall(PetscSectionGetSym(section, &sym));
   PetscCall(PetscSectionSetSym(newSection, sym));
+  if (section->numRanges && !constrained_dofs) {
+    PetscBool useRanges = PETSC_TRUE;
+
+    for (f = 0; f < numFields; ++f) useRanges = (PetscBool)(useRanges && section->field[f]->numRanges);
+    if (useRanges) {
+      /* Sections stored as ranges have no constraints */
+      PetscCall(PetscSectionCopyRanges_Private(section, newSection));
+      for (f = 0; f < numFields; ++f) PetscCall(PetscSectionCopyRanges_Private(section->field[f], newSection->field[f]));
+      if (section->setup) newSection->setup = PETSC_TRUE;
+      else PetscCall(PetscSectionSetUp(newSection));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
   for (p = pStart; p < pEnd; ++p) {
     PetscInt  dof, cdof, fcdof = 0;
     PetscBool force_constrained = (PetscBool)(constrained_dofs && PetscBTLookup(constrained_dofs, p - pStart));
@@ -669,11 +847,22 @@ PetscErrorCode PetscSectionSetChart(PetscSection s, PetscInt pStart, PetscInt pE
   PetscCall(PetscSectionDestroy(&s->bc));
   PetscCall(PetscFree(s->bcIndices));
   PetscCall(PetscFree2(s->atlasDof, s->atlasOff));
+  PetscCall(PetscSectionDestroyRanges_Private(s));
 
   s->pStart = pStart;
   s->pEnd   = pEnd;
-  PetscCall(PetscMalloc2(pEnd - pStart, &s->atlasDof, pEnd - pStart, &s->atlasOff));
-  PetscCall(PetscArrayzero(s->atlasDof, pEnd - pStart));
+  /* The per-point arrays are only allocated when a point gets a dof different from its range, so that uniform sections never need them */
+  if (pEnd > pStart) {
+    PetscInt *start, *dof, *off, *stride;
+
+    PetscCall(PetscMalloc4(2, &start, 1, &dof, 1, &off, 1, &stride));
+    start[0]  = 0;
+    start[1]  = pEnd - pStart;
+    dof[0]    = 0;
+    off[0]    = 0;
+    stride[0] = 0;
+    PetscCall(PetscSectionSetRanges_Private(s, 1, start, dof, off, stride));
+  }
   for (PetscInt f = 0; f < s->numFields; ++f) PetscCall(PetscSectionSetChart(s->field[f], pStart, pEnd));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -937,7 +1126,7 @@ PetscErrorCode PetscSectionGetDof(PetscSection s, PetscInt point, PetscInt *numD
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscAssertPointer(numDof, 3);
   PetscAssert(point >= s->pStart && point < s->pEnd, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Section point %" PetscInt_FMT " should be in [%" PetscInt_FMT ", %" PetscInt_FMT ")", point, s->pStart, s->pEnd);
-  *numDof = s->atlasDof[point - s->pStart];
+  *numDof = PetscSectionGetDof_Private(s, point - s->pStart);
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -963,6 +1152,10 @@ PetscErrorCode PetscSectionSetDof(PetscSection s, PetscInt point, PetscInt numDo
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscAssert(point >= s->pStart && point < s->pEnd, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Section point %" PetscInt_FMT " should be in [%" PetscInt_FMT ", %" PetscInt_FMT ")", point, s->pStart, s->pEnd);
+  if (s->numRanges) {
+    if (PetscSectionGetDof_Private(s, point - s->pStart) == numDof) PetscFunctionReturn(PETSC_SUCCESS);
+    PetscCall(PetscSectionMaterialize_Internal(s));
+  }
   s->atlasDof[point - s->pStart] = numDof;
   PetscCall(PetscSectionInvalidateMaxDof_Internal(s));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -991,6 +1184,10 @@ PetscErrorCode PetscSectionAddDof(PetscSection s, PetscInt point, PetscInt numDo
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscAssert(point >= s->pStart && point < s->pEnd, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Section point %" PetscInt_FMT " should be in [%" PetscInt_FMT ", %" PetscInt_FMT ")", point, s->pStart, s->pEnd);
   PetscCheck(numDof >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "numDof %" PetscInt_FMT " should not be negative", numDof);
+  if (s->numRanges) {
+    if (!numDof) PetscFunctionReturn(PETSC_SUCCESS);
+    PetscCall(PetscSectionMaterialize_Internal(s));
+  }
   s->atlasDof[point - s->pStart] += numDof;
   PetscCall(PetscSectionInvalidateMaxDof_Internal(s));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -1093,6 +1290,82 @@ PetscErrorCode PetscSectionAddFieldDof(PetscSection s, PetscInt point, PetscInt
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode PetscSectionSetUniformDof_Private(PetscSection s, PetscInt pStart, PetscInt pEnd, PetscInt numDof, PetscBool setup)
+{
+  PetscFunctionBegin;
+  PetscCheck(pStart >= s->pStart && pEnd <= s->pEnd && pStart <= pEnd, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Section points [%" PetscInt_FMT ", %" PetscInt_FMT ") should be in [%" PetscInt_FMT ", %" PetscInt_FMT ")", pStart, pEnd, s->pStart, s->pEnd);
+  if (pStart == pEnd) PetscFunctionReturn(PETSC_SUCCESS);
+  /* Once the offsets are computed they must be kept, so we only store ranges before PetscSectionSetUp() */
+  if (!setup) PetscCall(PetscSectionEncodeRanges_Private(s, PETSC_FALSE));
+  if (!setup && s->numRanges) PetscCall(PetscSectionInsertRange_Private(s, pStart - s->pStart, pEnd - s->pStart, numDof));
+  else {
+    PetscCall(PetscSectionMaterialize_Internal(s));
+    for (PetscInt q = pStart - s->pStart; q < pEnd - s->pStart; ++q) s->atlasDof[q] = numDof;
+  }
+  PetscCall(PetscSectionInvalidateMaxDof_Internal(s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PetscSectionSetUniformDof - Sets the total number of degrees of freedom for all points in a range
+
+  Not Collective
+
+  Input Parameters:
++ s      - the `PetscSection`
+. pStart - the first point
+. pEnd   - one past the last point
+- numDof - the number of dof of each point
+
+  Level: intermediate
+
+  Notes:
+  This is equivalent to calling `PetscSectionSetDof()` for each point in [`pStart`, `pEnd`), but if called before `PetscSectionSetUp()`
+  the `PetscSection` stores the layout as ranges of points with the same number of dof, rather than as arrays over the chart. `PetscSectionGetDof()`
+  and `PetscSectionGetOffset()` are then computed arithmetically, which requires memory proportional to the number of ranges, for example the number of strata of a mesh,
+  instead of the number of points.
+
+  The per-point arrays are created again, with the same values, as soon as the layout is modified in a way that cannot be represented with ranges, such as setting
+  a different number of dof for a single point, adding constraints, or using a permutation.
+
+.seealso: [PetscSection](ch_petscsection), `PetscSection`, `PetscSectionSetDof()`, `PetscSectionSetFieldUniformDof()`, `PetscSectionCompress()`, `PetscSectionSetUp()`
+@*/
+PetscErrorCode PetscSectionSetUniformDof(PetscSection s, PetscInt pStart, PetscInt pEnd, PetscInt numDof)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
+  PetscCall(PetscSectionSetUniformDof_Private(s, pStart, pEnd, numDof, s->setup));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PetscSectionSetFieldUniformDof - Sets the number of degrees of freedom of a field for all points in a range
+
+  Not Collective
+
+  Input Parameters:
++ s      - the `PetscSection`
+. field  - the field
+. pStart - the first point
+. pEnd   - one past the last point
+- numDof - the number of dof of each point
+
+  Level: intermediate
+
+  Note:
+  See `PetscSectionSetUniformDof()`. One must also set the total number of dof of the points, for example with `PetscSectionSetUniformDof()`
+
+.seealso: [PetscSection](ch_petscsection), `PetscSection`, `PetscSectionSetFieldDof()`, `PetscSectionSetUniformDof()`, `PetscSectionCompress()`
+@*/
+PetscErrorCode PetscSectionSetFieldUniformDof(PetscSection s, PetscInt field, PetscInt pStart, PetscInt pEnd, PetscInt numDof)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
+  PetscSectionCheckValidField(field, s->numFields);
+  PetscCall(PetscSectionSetUniformDof_Private(s->field[field], pStart, pEnd, numDof, (PetscBool)(s->setup || s->field[field]->setup)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PetscSectionGetConstraintDof - Return the number of constrained degrees of freedom associated with a given point.
 
@@ -1264,12 +1537,63 @@ PetscErrorCode PetscSectionSetUpBC(PetscSection s)
     const PetscInt last = (s->bc->pEnd - s->bc->pStart) - 1;
 
     PetscCall(PetscSectionSetUp(s->bc));
-    if (last >= 0) PetscCall(PetscMalloc1(s->bc->atlasOff[last] + s->bc->atlasDof[last], &s->bcIndices));
+    if (last >= 0) PetscCall(PetscMalloc1(PetscSectionGetOffset_Private(s->bc, last) + PetscSectionGetDof_Private(s->bc, last), &s->bcIndices));
     else s->bcIndices = NULL;
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* Compute the offsets of a section, and its fields, which are all stored as ranges */
+static PetscErrorCode PetscSectionSetUpRanges_Private(PetscSection s)
+{
+  PetscInt   nb = s->numRanges + 1, nr, *bnd;
+  PetscCount offset = 0;
+
+  PetscFunctionBegin;
+  for (PetscInt f = 0; f < s->numFields; ++f) nb += s->field[f]->numRanges + 1;
+  PetscCall(PetscMalloc1(nb, &bnd));
+  PetscCall(PetscArraycpy(bnd, s->rangeStart, s->numRanges + 1));
+  for (PetscInt f = 0, b = s->numRanges + 1; f < s->numFields; b += s->field[f]->numRanges + 1, ++f) PetscCall(PetscArraycpy(&bnd[b], s->field[f]->rangeStart, s->field[f]->numRanges + 1));
+  PetscCall(PetscSortRemoveDupsInt(&nb, bnd));
+  nr = nb - 1;
+  PetscCall(PetscSectionRefineRanges_Private(s, nr, bnd));
+  for (PetscInt f = 0; f < s->numFields; ++f) PetscCall(PetscSectionRefineRanges_Private(s->field[f], nr, bnd));
+  PetscCall(PetscFree(bnd));
+  if (s->pointMajor) {
+    for (PetscInt r = 0; r < nr; ++r) {
+      const PetscInt len  = s->rangeStart[r + 1] - s->rangeStart[r];
+      PetscCount     foff = offset;
+
+      PetscCall(PetscIntCast(offset, &s->rangeOff[r]));
+      s->rangeStride[r] = s->rangeDof[r];
+      for (PetscInt f = 0; f < s->numFields; ++f) {
+        PetscSection sf = s->field[f];
+
+        PetscCall(PetscIntCast(foff, &sf->rangeOff[r]));
+        sf->rangeStride[r] = s->rangeDof[r];
+        foff += sf->rangeDof[r];
+      }
+      offset += (PetscCount)len * s->rangeDof[r];
+    }
+  } else {
+    for (PetscInt f = 0; f < s->numFields; ++f) {
+      PetscSection sf = s->field[f];
+
+      for (PetscInt r = 0; r < nr; ++r) {
+        PetscCall(PetscIntCast(offset, &sf->rangeOff[r]));
+        sf->rangeStride[r] = sf->rangeDof[r];
+        offset += (PetscCount)(s->rangeStart[r + 1] - s->rangeStart[r]) * sf->rangeDof[r];
+      }
+    }
+    /* Disable point offsets since these are unused */
+    for (PetscInt r = 0; r < nr; ++r) {
+      s->rangeOff[r]    = -1;
+      s->rangeStride[r] = 0;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PetscSectionSetUp - Calculate offsets based upon the number of degrees of freedom for each point in preparation for use of the `PetscSection`
 
@@ -1300,6 +1624,18 @@ PetscErrorCode PetscSectionSetUp(PetscSection s)
   /* Set offsets and field offsets for all points */
   /*   Assume that all fields have the same chart */
   PetscCheck(s->includesConstraints, PETSC_COMM_SELF, PETSC_ERR_SUP, "PetscSectionSetUp is currently unsupported for includesConstraints = PETSC_TRUE");
+  if (s->numRanges) {
+    PetscBool useRanges = (PetscBool)!s->perm;
+
+    for (f = 0; f < s->numFields; ++f) useRanges = (PetscBool)(useRanges && s->field[f]->numRanges);
+    /* Sections stored as ranges have no constraints, so there is no BC section to set up */
+    if (useRanges) {
+      PetscCall(PetscSectionSetUpRanges_Private(s));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  PetscCall(PetscSectionMaterialize_Internal(s));
+  for (f = 0; f < s->numFields; ++f) PetscCall(PetscSectionMaterialize_Internal(s->field[f]));
   if (s->perm) PetscCall(ISGetIndices(s->perm, &pind));
   if (s->pointMajor) {
     PetscCount foff;
@@ -1339,6 +1675,33 @@ PetscErrorCode PetscSectionSetUp(PetscSection s)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PetscSectionCompress - Detects runs of consecutive points with the same number of dof and stores them as ranges
+
+  Not Collective
+
+  Input Parameter:
+. s - the `PetscSection`
+
+  Level: advanced
+
+  Notes:
+  The per-point arrays of the `PetscSection`, and of its fields, are replaced by ranges of points with the same number of dof, and offsets
+  with a constant stride if the section is set up, when this reduces the memory used. `PetscSectionGetDof()` and `PetscSectionGetOffset()` are then computed arithmetically.
+
+  Sections with constraints are not compressed.
+
+.seealso: [PetscSection](ch_petscsection), `PetscSection`, `PetscSectionSetUniformDof()`, `PetscSectionSetUp()`
+@*/
+PetscErrorCode PetscSectionCompress(PetscSection s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
+  PetscCall(PetscSectionEncodeRanges_Private(s, s->setup));
+  for (PetscInt f = 0; f < s->numFields; ++f) PetscCall(PetscSectionEncodeRanges_Private(s->field[f], (PetscBool)(s->setup || s->field[f]->setup)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   PetscSectionGetMaxDof - Return the maximum number of degrees of freedom on any point in the `PetscSection`
 
@@ -1378,7 +1741,11 @@ PetscErrorCode PetscSectionGetMaxDof(PetscSection s, PetscInt *maxDof)
   PetscAssertPointer(maxDof, 2);
   if (s->maxDof == PETSC_INT_MIN) {
     s->maxDof = 0;
-    for (p = 0; p < s->pEnd - s->pStart; ++p) s->maxDof = PetscMax(s->maxDof, s->atlasDof[p]);
+    if (s->numRanges) {
+      for (p = 0; p < s->numRanges; ++p) s->maxDof = PetscMax(s->maxDof, s->rangeDof[p]);
+    } else {
+      for (p = 0; p < s->pEnd - s->pStart; ++p) s->maxDof = PetscMax(s->maxDof, s->atlasDof[p]);
+    }
   }
   *maxDof = s->maxDof;
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -1406,7 +1773,11 @@ PetscErrorCode PetscSectionGetStorageSize(PetscSection s, PetscInt *size)
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscAssertPointer(size, 2);
-  for (PetscInt p = 0; p < s->pEnd - s->pStart; ++p) n += s->atlasDof[p] > 0 ? s->atlasDof[p] : 0;
+  if (s->numRanges) {
+    for (PetscInt r = 0; r < s->numRanges; ++r) n += s->rangeDof[r] > 0 ? (PetscInt64)s->rangeDof[r] * (s->rangeStart[r + 1] - s->rangeStart[r]) : 0;
+  } else {
+    for (PetscInt p = 0; p < s->pEnd - s->pStart; ++p) n += s->atlasDof[p] > 0 ? s->atlasDof[p] : 0;
+  }
   PetscCall(PetscIntCast(n, size));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -1433,8 +1804,13 @@ PetscErrorCode PetscSectionGetConstrainedStorageSize(PetscSection s, PetscInt *s
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscAssertPointer(size, 2);
+  /* Sections stored as ranges have no constraints */
+  if (s->numRanges) {
+    PetscCall(PetscSectionGetStorageSize(s, size));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   for (PetscInt p = 0; p < s->pEnd - s->pStart; ++p) {
-    const PetscInt cdof = s->bc ? s->bc->atlasDof[p] : 0;
+    const PetscInt cdof = s->bc ? PetscSectionGetDof_Private(s->bc, p) : 0;
     n += s->atlasDof[p] > 0 ? s->atlasDof[p] - cdof : 0;
   }
   PetscCall(PetscIntCast(n, size));
@@ -1507,7 +1883,9 @@ PetscErrorCode PetscSectionCreateGlobalSection(PetscSection s, PetscSF sf, Petsc
     if (neg) neg[p] = -(dof + 1);
   }
   PetscCall(PetscSectionSetUpBC(gs));
-  if (gs->bcIndices) PetscCall(PetscArraycpy(gs->bcIndices, s->bcIndices, gs->bc->atlasOff[gs->bc->pEnd - gs->bc->pStart - 1] + gs->bc->atlasDof[gs->bc->pEnd - gs->bc->pStart - 1]));
+  /* The ghost dof and the offsets are set directly in the per-point arrays */
+  PetscCall(PetscSectionMaterialize_Internal(gs));
+  if (gs->bcIndices) PetscCall(PetscArraycpy(gs->bcIndices, s->bcIndices, PetscSectionGetOffset_Private(gs->bc, gs->bc->pEnd - gs->bc->pStart - 1) + PetscSectionGetDof_Private(gs->bc, gs->bc->pEnd - gs->bc->pStart - 1)));
   if (nroots >= 0) {
     PetscCall(PetscArrayzero(recv, nlocal));
     PetscCall(PetscSFBcastBegin(sf, MPIU_INT, neg, recv, MPI_REPLACE));
@@ -1525,7 +1903,7 @@ PetscErrorCode PetscSectionCreateGlobalSection(PetscSection s, PetscSF sf, Petsc
   for (p = 0, off = 0; p < pEnd - pStart; ++p) {
     const PetscInt q = pind ? pind[p] : p;
 
-    cdof            = (!includeConstraints && s->bc) ? s->bc->atlasDof[q] : 0;
+    cdof            = (!includeConstraints && s->bc) ? PetscSectionGetDof_Private(s->bc, q) : 0;
     gs->atlasOff[q] = off;
     off += gs->atlasDof[q] > 0 ? gs->atlasDof[q] - cdof : 0;
   }
@@ -1574,9 +1952,10 @@ PetscErrorCode PetscSectionCreateGlobalSection(PetscSection s, PetscSF sf, Petsc
     PetscSection gfs = gs->field[f];
 
     PetscCall(PetscSectionSetUpBC(gfs));
-    if (gfs->bcIndices) PetscCall(PetscArraycpy(gfs->bcIndices, s->field[f]->bcIndices, gfs->bc->atlasOff[gfs->bc->pEnd - gfs->bc->pStart - 1] + gfs->bc->atlasDof[gfs->bc->pEnd - gfs->bc->pStart - 1]));
+    if (gfs->bcIndices) PetscCall(PetscArraycpy(gfs->bcIndices, s->field[f]->bcIndices, PetscSectionGetOffset_Private(gfs->bc, gfs->bc->pEnd - gfs->bc->pStart - 1) + PetscSectionGetDof_Private(gfs->bc, gfs->bc->pEnd - gfs->bc->pStart - 1)));
   }
   gs->setup = PETSC_TRUE;
+  if (s->numRanges) PetscCall(PetscSectionCompress(gs));
   PetscCall(PetscSectionViewFromOptions(gs, NULL, "-global_section_view"));
   *gsection = gs;
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -1625,6 +2004,8 @@ PetscErrorCode PetscSectionCreateGlobalSectionCensored(PetscSection s, PetscSF s
   PetscCall(PetscSectionCreate(PetscObjectComm((PetscObject)s), gsection));
   PetscCall(PetscSectionGetChart(s, &pStart, &pEnd));
   PetscCall(PetscSectionSetChart(*gsection, pStart, pEnd));
+  /* The ghost dof and the offsets are set directly in the per-point arrays */
+  PetscCall(PetscSectionMaterialize_Internal(*gsection));
   PetscCall(PetscSFGetGraph(sf, &nroots, NULL, NULL, NULL));
   if (nroots >= 0) {
     PetscCheck(nroots >= pEnd - pStart, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "PetscSF nroots %" PetscInt_FMT " < %" PetscInt_FMT " section size", nroots, pEnd - pStart);
@@ -1665,7 +2046,7 @@ PetscErrorCode PetscSectionCreateGlobalSectionCensored(PetscSection s, PetscSF s
   for (p = 0, off = 0; p < pEnd - pStart; ++p) {
     const PetscInt q = pind ? pind[p] : p;
 
-    cdof                     = (!includeConstraints && s->bc) ? s->bc->atlasDof[q] : 0;
+    cdof                     = (!includeConstraints && s->bc) ? PetscSectionGetDof_Private(s->bc, q) : 0;
     (*gsection)->atlasOff[q] = off;
     off += (*gsection)->atlasDof[q] > 0 ? (*gsection)->atlasDof[q] - cdof : 0;
   }
@@ -1823,7 +2204,7 @@ PetscErrorCode PetscSectionGetOffset(PetscSection s, PetscInt point, PetscInt *o
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscAssertPointer(offset, 3);
   PetscAssert(!(point < s->pStart) && !(point >= s->pEnd), PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Section point %" PetscInt_FMT " should be in [%" PetscInt_FMT ", %" PetscInt_FMT ")", point, s->pStart, s->pEnd);
-  *offset = s->atlasOff[point - s->pStart];
+  *offset = PetscSectionGetOffset_Private(s, point - s->pStart);
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -1849,6 +2230,10 @@ PetscErrorCode PetscSectionSetOffset(PetscSection s, PetscInt point, PetscInt of
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   PetscCheck(!(point < s->pStart) && !(point >= s->pEnd), PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Section point %" PetscInt_FMT " should be in [%" PetscInt_FMT ", %" PetscInt_FMT ")", point, s->pStart, s->pEnd);
+  if (s->numRanges) {
+    if (PetscSectionGetOffset_Private(s, point - s->pStart) == offset) PetscFunctionReturn(PETSC_SUCCESS);
+    PetscCall(PetscSectionMaterialize_Internal(s));
+  }
   s->atlasOff[point - s->pStart] = offset;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -1977,17 +2362,38 @@ PetscErrorCode PetscSectionGetOffsetRange(PetscSection s, PetscInt *start, Petsc
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
-  if (s->atlasOff) {
-    os = s->atlasOff[0];
-    oe = s->atlasOff[0];
+  if (s->atlasOff || s->numRanges) {
+    os = PetscSectionGetOffset_Private(s, 0);
+    oe = os;
   }
   PetscCall(PetscSectionGetChart(s, &pStart, &pEnd));
-  for (p = 0; p < pEnd - pStart; ++p) {
-    PetscInt dof = s->atlasDof[p], off = s->atlasOff[p];
+  if (s->numRanges) {
+    for (PetscInt r = 0; r < s->numRanges; ++r) {
+      const PetscInt dof = s->rangeDof[r], first = s->rangeOff[r], last = first + (s->rangeStart[r + 1] - s->rangeStart[r] - 1) * s->rangeStride[r];
+
+      /* the offsets are monotone in a range, so only the ends matter unless the range mixes owned and unowned offsets */
+      if (first >= 0 && last >= 0) {
+        os = PetscMin(os, PetscMin(first, last));
+        oe = PetscMax(oe, PetscMax(first, last) + dof);
+      } else if (first >= 0 || last >= 0) {
+        for (p = s->rangeStart[r]; p < s->rangeStart[r + 1]; ++p) {
+          const PetscInt off = first + (p - s->rangeStart[r]) * s->rangeStride[r];
+
+          if (off >= 0) {
+            os = PetscMin(os, off);
+            oe = PetscMax(oe, off + dof);
+          }
+        }
+      }
+    }
+  } else {
+    for (p = 0; p < pEnd - pStart; ++p) {
+      PetscInt dof = s->atlasDof[p], off = s->atlasOff[p];
 
-    if (off >= 0) {
-      os = PetscMin(os, off);
-      oe = PetscMax(oe, off + dof);
+      if (off >= 0) {
+        os = PetscMin(os, off);
+        oe = PetscMax(oe, off + dof);
+      }
     }
   }
   if (start) *start = os;
@@ -2458,14 +2864,14 @@ static PetscErrorCode PetscSectionView_ASCII(PetscSection s, PetscViewer viewer)
   PetscCall(PetscViewerASCIIPushSynchronized(viewer));
   PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "Process %d:\n", rank));
   for (PetscInt p = 0; p < s->pEnd - s->pStart; ++p) {
-    if (s->bc && s->bc->atlasDof[p] > 0) {
-      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT " constrained", p + s->pStart, s->atlasDof[p], s->atlasOff[p]));
+    if (s->bc && PetscSectionGetDof_Private(s->bc, p) > 0) {
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT " constrained", p + s->pStart, PetscSectionGetDof_Private(s, p), PetscSectionGetOffset_Private(s, p)));
       if (s->bcIndices) {
-        for (PetscInt b = 0; b < s->bc->atlasDof[p]; ++b) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, " %" PetscInt_FMT, s->bcIndices[s->bc->atlasOff[p] + b]));
+        for (PetscInt b = 0; b < PetscSectionGetDof_Private(s->bc, p); ++b) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, " %" PetscInt_FMT, s->bcIndices[PetscSectionGetOffset_Private(s->bc, p) + b]));
       }
       PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "\n"));
     } else {
-      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT "\n", p + s->pStart, s->atlasDof[p], s->atlasOff[p]));
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT "\n", p + s->pStart, PetscSectionGetDof_Private(s, p), PetscSectionGetOffset_Private(s, p)));
     }
   }
   PetscCall(PetscViewerFlush(viewer));
@@ -2664,15 +3070,17 @@ PetscErrorCode PetscSectionArrayView_ASCII_Internal(PetscSection s, void *array,
   PetscCall(PetscViewerASCIIPushSynchronized(viewer));
   PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "Process %d:\n", rank));
   for (PetscInt p = 0; p < s->pEnd - s->pStart; ++p) {
-    if (s->bc && (s->bc->atlasDof[p] > 0)) {
-      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT, p + s->pStart, s->atlasDof[p], s->atlasOff[p]));
-      for (i = s->atlasOff[p]; i < s->atlasOff[p] + s->atlasDof[p]; ++i) PetscCall(PrintArrayElement(array, data_type, i, viewer));
+    const PetscInt dof = PetscSectionGetDof_Private(s, p), off = PetscSectionGetOffset_Private(s, p);
+
+    if (s->bc && (PetscSectionGetDof_Private(s->bc, p) > 0)) {
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT, p + s->pStart, dof, off));
+      for (i = off; i < off + dof; ++i) PetscCall(PrintArrayElement(array, data_type, i, viewer));
       PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, " constrained"));
-      for (PetscInt b = 0; b < s->bc->atlasDof[p]; ++b) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, " %" PetscInt_FMT, s->bcIndices[s->bc->atlasOff[p] + b]));
+      for (PetscInt b = 0; b < PetscSectionGetDof_Private(s->bc, p); ++b) PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, " %" PetscInt_FMT, s->bcIndices[PetscSectionGetOffset_Private(s->bc, p) + b]));
       PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "\n"));
     } else {
-      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT, p + s->pStart, s->atlasDof[p], s->atlasOff[p]));
-      for (i = s->atlasOff[p]; i < s->atlasOff[p] + s->atlasDof[p]; ++i) PetscCall(PrintArrayElement(array, data_type, i, viewer));
+      PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "  (%4" PetscInt_FMT ") dof %2" PetscInt_FMT " offset %3" PetscInt_FMT, p + s->pStart, dof, off));
+      for (i = off; i < off + dof; ++i) PetscCall(PrintArrayElement(array, data_type, i, viewer));
       PetscCall(PetscViewerASCIISynchronizedPrintf(viewer, "\n"));
     }
   }
@@ -2781,6 +3189,7 @@ PetscErrorCode PetscSectionReset(PetscSection s)
   PetscCall(PetscSectionDestroy(&s->bc));
   PetscCall(PetscFree(s->bcIndices));
   PetscCall(PetscFree2(s->atlasDof, s->atlasOff));
+  PetscCall(PetscSectionDestroyRanges_Private(s));
   PetscCall(PetscSectionDestroy(&s->clSection));
   PetscCall(ISDestroy(&s->clPoints));
   PetscCall(ISDestroy(&s->perm));
@@ -2831,7 +3240,7 @@ static PetscErrorCode VecIntGetValuesSection_Private(const PetscInt *baseArray,
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 2);
-  *values = &baseArray[s->atlasOff[p]];
+  *values = &baseArray[PetscSectionGetOffset_Private(s, p)];
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -2845,10 +3254,10 @@ static PetscErrorCode VecIntSetValuesSection_Private(PetscInt *baseArray, PetscS
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 2);
   PetscCall(PetscSectionGetConstraintDof(s, p, &cDim));
-  array = &baseArray[s->atlasOff[p]];
+  array = &baseArray[PetscSectionGetOffset_Private(s, p)];
   if (!cDim) {
     if (orientation >= 0) {
-      const PetscInt dim = s->atlasDof[p];
+      const PetscInt dim = PetscSectionGetDof_Private(s, p);
       PetscInt       i;
 
       if (mode == INSERT_VALUES) {
@@ -2861,7 +3270,7 @@ static PetscErrorCode VecIntSetValuesSection_Private(PetscInt *baseArray, PetscS
       PetscInt j      = -1, field, i;
 
       for (field = 0; field < s->numFields; ++field) {
-        const PetscInt dim = s->field[field]->atlasDof[p];
+        const PetscInt dim = PetscSectionGetDof_Private(s->field[field], p);
 
         for (i = dim - 1; i >= 0; --i) array[++j] = values ? values[i + offset] : i + offset;
         offset += dim;
@@ -2869,7 +3278,7 @@ static PetscErrorCode VecIntSetValuesSection_Private(PetscInt *baseArray, PetscS
     }
   } else {
     if (orientation >= 0) {
-      const PetscInt  dim  = s->atlasDof[p];
+      const PetscInt  dim  = PetscSectionGetDof_Private(s, p);
       PetscInt        cInd = 0, i;
       const PetscInt *cDof;
 
@@ -2899,8 +3308,8 @@ static PetscErrorCode VecIntSetValuesSection_Private(PetscInt *baseArray, PetscS
 
       PetscCall(PetscSectionGetConstraintIndices(s, point, &cDof));
       for (field = 0; field < s->numFields; ++field) {
-        const PetscInt dim  = s->field[field]->atlasDof[p];     /* PetscSectionGetFieldDof() */
-        const PetscInt tDim = s->field[field]->bc->atlasDof[p]; /* PetscSectionGetFieldConstraintDof() */
+        const PetscInt dim  = PetscSectionGetDof_Private(s->field[field], p); /* PetscSectionGetFieldDof() */
+        const PetscInt tDim = PetscSectionGetDof_Private(s->field[field]->bc, p);               /* PetscSectionGetFieldConstraintDof() */
         const PetscInt sDim = dim - tDim;
         PetscInt       cInd = 0, i, k;
 
@@ -2990,8 +3399,8 @@ PetscErrorCode PetscSectionSetConstraintIndices(PetscSection s, PetscInt point,
   PetscFunctionBegin;
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   if (s->bc) {
-    const PetscInt dof  = s->atlasDof[point];
-    const PetscInt cdof = s->bc->atlasDof[point];
+    const PetscInt dof  = PetscSectionGetDof_Private(s, point);
+    const PetscInt cdof = PetscSectionGetDof_Private(s->bc, point);
     if (indices)
       for (PetscInt d = 0; d < cdof; ++d)
         PetscCheck(indices[d] < dof, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Point %" PetscInt_FMT " dof %" PetscInt_FMT ", invalid constraint index[%" PetscInt_FMT "]: %" PetscInt_FMT, point, dof, d, indices[d]);
@@ -240,7 +240,7 @@ PetscErrorCode PetscSFDistributeSection(PetscSF sf, PetscSection rootSection, Pe
   const PetscInt *indices;
   IS              selected;
   PetscInt        numFields, nroots, rpStart, rpEnd, lpStart = PETSC_INT_MAX, lpEnd = -1, f, c;
-  PetscBool      *sub, hasc;
+  PetscBool      *sub, hasc, compress;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(sf, PETSCSF_CLASSID, 1);
@@ -309,6 +309,14 @@ PetscErrorCode PetscSFDistributeSection(PetscSF sf, PetscSection rootSection, Pe
   hasc = sub[1];
   for (f = 0; f < numFields; ++f) hasc = (PetscBool)(hasc || sub[2 + f]);
 
+  /* The dof and offsets are communicated directly from the per-point arrays, so sections stored as ranges are expanded and compressed again at the end */
+  compress = (PetscBool)(rootSection->numRanges > 0);
+  PetscCall(PetscSectionMaterialize_Internal(rootSection));
+  PetscCall(PetscSectionMaterialize_Internal(leafSection));
+  for (f = 0; f < numFields; ++f) {
+    PetscCall(PetscSectionMaterialize_Internal(rootSection->field[f]));
+    PetscCall(PetscSectionMaterialize_Internal(leafSection->field[f]));
+  }
   /* Could fuse these at the cost of copies and extra allocation */
   PetscCall(PetscSFBcastBegin(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootSection->atlasDof, -rpStart), PetscSafePointerPlusOffset(leafSection->atlasDof, -lpStart), MPI_REPLACE));
   PetscCall(PetscSFBcastEnd(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootSection->atlasDof, -rpStart), PetscSafePointerPlusOffset(leafSection->atlasDof, -lpStart), MPI_REPLACE));
@@ -360,6 +368,10 @@ PetscErrorCode PetscSFDistributeSection(PetscSF sf, PetscSection rootSection, Pe
     }
     PetscCall(PetscFree(rOffBc));
   }
+  if (compress) {
+    PetscCall(PetscSectionCompress(rootSection));
+    PetscCall(PetscSectionCompress(leafSection));
+  }
   PetscCall(PetscSFDestroy(&embedSF));
   PetscCall(PetscFree(sub));
   PetscCall(PetscLogEventEnd(PETSCSF_DistSect, sf, 0, 0, 0));
@@ -413,8 +425,18 @@ PetscErrorCode PetscSFCreateRemoteOffsets(PetscSF sf, PetscSection rootSection,
   PetscCall(ISRestoreIndices(selected, &indices));
   PetscCall(ISDestroy(&selected));
   PetscCall(PetscCalloc1(lpEnd - lpStart, remoteOffsets));
-  PetscCall(PetscSFBcastBegin(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootSection->atlasOff, -rpStart), PetscSafePointerPlusOffset(*remoteOffsets, -lpStart), MPI_REPLACE));
-  PetscCall(PetscSFBcastEnd(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootSection->atlasOff, -rpStart), PetscSafePointerPlusOffset(*remoteOffsets, -lpStart), MPI_REPLACE));
+  if (rootSection->numRanges) {
+    PetscInt *rootOffsets;
+
+    PetscCall(PetscMalloc1(rpEnd - rpStart, &rootOffsets));
+    for (PetscInt q = 0; q < rpEnd - rpStart; ++q) rootOffsets[q] = PetscSectionGetOffset_Private(rootSection, q);
+    PetscCall(PetscSFBcastBegin(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootOffsets, -rpStart), PetscSafePointerPlusOffset(*remoteOffsets, -lpStart), MPI_REPLACE));
+    PetscCall(PetscSFBcastEnd(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootOffsets, -rpStart), PetscSafePointerPlusOffset(*remoteOffsets, -lpStart), MPI_REPLACE));
+    PetscCall(PetscFree(rootOffsets));
+  } else {
+    PetscCall(PetscSFBcastBegin(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootSection->atlasOff, -rpStart), PetscSafePointerPlusOffset(*remoteOffsets, -lpStart), MPI_REPLACE));
+    PetscCall(PetscSFBcastEnd(embedSF, MPIU_INT, PetscSafePointerPlusOffset(rootSection->atlasOff, -rpStart), PetscSafePointerPlusOffset(*remoteOffsets, -lpStart), MPI_REPLACE));
+  }
   PetscCall(PetscSFDestroy(&embedSF));
   PetscCall(PetscLogEventEnd(PETSCSF_RemoteOff, sf, 0, 0, 0));
   PetscFunctionReturn(PETSC_SUCCESS);
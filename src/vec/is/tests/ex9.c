@@ -0,0 +1,147 @@
+static char help[] = "Tests PetscSectionSetUniformDof() and PetscSectionCompress().\n\n";
+
+#include <petsc/private/sectionimpl.h>
+#include <petscsf.h>
+
+/* Compares a section stored as ranges with the same section stored point by point */
+static PetscErrorCode CheckSame(PetscSection s, PetscSection t, PetscBool setup, const char name[])
+{
+  PetscInt pStart, pEnd, tStart, tEnd, nf, a, b;
+
+  PetscFunctionBegin;
+  PetscCall(PetscSectionGetChart(s, &pStart, &pEnd));
+  PetscCall(PetscSectionGetChart(t, &tStart, &tEnd));
+  PetscCheck(pStart == tStart && pEnd == tEnd, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: charts differ", name);
+  PetscCall(PetscSectionGetNumFields(s, &nf));
+  for (PetscInt p = pStart; p < pEnd; ++p) {
+    PetscCall(PetscSectionGetDof(s, p, &a));
+    PetscCall(PetscSectionGetDof(t, p, &b));
+    PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: dof of point %" PetscInt_FMT " differ %" PetscInt_FMT " != %" PetscInt_FMT, name, p, a, b);
+    if (!setup) continue;
+    PetscCall(PetscSectionGetOffset(s, p, &a));
+    PetscCall(PetscSectionGetOffset(t, p, &b));
+    PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: offset of point %" PetscInt_FMT " differ %" PetscInt_FMT " != %" PetscInt_FMT, name, p, a, b);
+    for (PetscInt f = 0; f < nf; ++f) {
+      PetscCall(PetscSectionGetFieldDof(s, p, f, &a));
+      PetscCall(PetscSectionGetFieldDof(t, p, f, &b));
+      PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: field %" PetscInt_FMT " dof of point %" PetscInt_FMT " differ %" PetscInt_FMT " != %" PetscInt_FMT, name, f, p, a, b);
+      if (!setup) continue;
+      PetscCall(PetscSectionGetFieldOffset(s, p, f, &a));
+      PetscCall(PetscSectionGetFieldOffset(t, p, f, &b));
+      PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: field %" PetscInt_FMT " offset of point %" PetscInt_FMT " differ %" PetscInt_FMT " != %" PetscInt_FMT, name, f, p, a, b);
+    }
+  }
+  PetscCall(PetscSectionGetStorageSize(s, &a));
+  PetscCall(PetscSectionGetStorageSize(t, &b));
+  PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: storage sizes differ", name);
+  PetscCall(PetscSectionGetConstrainedStorageSize(s, &a));
+  PetscCall(PetscSectionGetConstrainedStorageSize(t, &b));
+  PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: constrained storage sizes differ", name);
+  PetscCall(PetscSectionGetMaxDof(s, &a));
+  PetscCall(PetscSectionGetMaxDof(t, &b));
+  PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: maximum dof differ", name);
+  if (!setup) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscSectionGetOffsetRange(s, &a, NULL));
+  PetscCall(PetscSectionGetOffsetRange(t, &b, NULL));
+  PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: offset ranges differ", name);
+  PetscCall(PetscSectionGetOffsetRange(s, NULL, &a));
+  PetscCall(PetscSectionGetOffsetRange(t, NULL, &b));
+  PetscCheck(a == b, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s: offset ranges differ", name);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  /* A mesh-like chart with strata [0, 6), [6, 20), [20, 40), each with a uniform number of dof per field */
+  const PetscInt strata[] = {0, 6, 20, 40}, fdof[2][3] = {{1, 2, 3}, {0, 1, 4}};
+  PetscSection s, t, c, gs, gt;
+  PetscSF      sf;
+  PetscInt     off;
+  PetscBool    view = PETSC_FALSE, pointMajor = PETSC_TRUE;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-view", &view, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-point_major", &pointMajor, NULL));
+
+  PetscCall(PetscSectionCreate(PETSC_COMM_SELF, &s));
+  PetscCall(PetscSectionCreate(PETSC_COMM_SELF, &t));
+  PetscCall(PetscSectionSetNumFields(s, 2));
+  PetscCall(PetscSectionSetNumFields(t, 2));
+  PetscCall(PetscSectionSetChart(s, strata[0], strata[3]));
+  PetscCall(PetscSectionSetChart(t, strata[0], strata[3]));
+  PetscCall(PetscSectionSetPointMajor(s, pointMajor));
+  PetscCall(PetscSectionSetPointMajor(t, pointMajor));
+  for (PetscInt d = 0; d < 3; ++d) {
+    PetscCall(PetscSectionSetUniformDof(s, strata[d], strata[d + 1], fdof[0][d] + fdof[1][d]));
+    for (PetscInt f = 0; f < 2; ++f) PetscCall(PetscSectionSetFieldUniformDof(s, f, strata[d], strata[d + 1], fdof[f][d]));
+    for (PetscInt p = strata[d]; p < strata[d + 1]; ++p) {
+      PetscCall(PetscSectionSetDof(t, p, fdof[0][d] + fdof[1][d]));
+      for (PetscInt f = 0; f < 2; ++f) PetscCall(PetscSectionSetFieldDof(t, p, f, fdof[f][d]));
+    }
+  }
+  /* Overwrite part of a stratum, which splits the ranges */
+  PetscCall(PetscSectionSetUniformDof(s, 10, 12, 5));
+  PetscCall(PetscSectionSetFieldUniformDof(s, 1, 10, 12, 2));
+  for (PetscInt p = 10; p < 12; ++p) {
+    PetscCall(PetscSectionSetDof(t, p, 5));
+    PetscCall(PetscSectionSetFieldDof(t, p, 1, 2));
+  }
+  PetscCall(CheckSame(s, t, PETSC_FALSE, "dof"));
+  PetscCall(PetscSectionSetUp(s));
+  PetscCall(PetscSectionSetUp(t));
+  PetscCall(CheckSame(s, t, PETSC_TRUE, "setup"));
+  PetscCheck(s->numRanges && !s->atlasDof, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Section is not stored as ranges");
+  if (view) PetscCall(PetscSectionView(s, NULL));
+
+  PetscCall(PetscSectionClone(s, &c));
+  PetscCall(CheckSame(c, t, PETSC_TRUE, "clone"));
+  /* Setting the current value keeps the ranges, a new value expands them */
+  PetscCall(PetscSectionSetDof(c, 7, 3));
+  PetscCall(PetscSectionGetOffset(c, 7, &off));
+  PetscCall(PetscSectionSetOffset(c, 7, off));
+  PetscCall(CheckSame(c, t, PETSC_TRUE, "set same"));
+  PetscCheck(c->numRanges, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Section is not stored as ranges");
+  PetscCall(PetscSectionDestroy(&c));
+
+  /* The global section of a section stored as ranges is compressed as well */
+  PetscCall(PetscSFCreate(PETSC_COMM_SELF, &sf));
+  if (pointMajor) {
+    PetscCall(PetscSectionCreateGlobalSection(s, sf, PETSC_TRUE, PETSC_FALSE, PETSC_FALSE, &gs));
+    PetscCall(PetscSectionCreateGlobalSection(t, sf, PETSC_TRUE, PETSC_FALSE, PETSC_FALSE, &gt));
+    PetscCall(CheckSame(gs, gt, PETSC_TRUE, "global"));
+    PetscCheck(gs->numRanges, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Global section is not stored as ranges");
+    PetscCall(PetscSectionDestroy(&gs));
+    PetscCall(PetscSectionDestroy(&gt));
+  }
+  PetscCall(PetscSFDestroy(&sf));
+
+  /* Detect the ranges of a section set up point by point */
+  PetscCall(PetscSectionCompress(t));
+  PetscCall(CheckSame(s, t, PETSC_TRUE, "compress"));
+  PetscCheck(t->numRanges, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Section is not stored as ranges");
+
+  /* Constraints expand the ranges */
+  PetscCall(PetscSectionSetConstraintDof(s, 7, 1));
+  PetscCall(PetscSectionSetConstraintDof(t, 7, 1));
+  PetscCall(CheckSame(s, t, PETSC_TRUE, "constraint"));
+  PetscCheck(!s->numRanges, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Section with constraints is stored as ranges");
+
+  PetscCall(PetscSectionDestroy(&s));
+  PetscCall(PetscSectionDestroy(&t));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+  test:
+    suffix: 0
+    args: -view
+
+  test:
+    suffix: 1
+    args: -point_major 0
+    output_file: output/empty.out
+
+TEST*/
@@ -15,6 +15,12 @@ typedef struct {
   PetscHMapI globalht;
 } ISLocalToGlobalMapping_Hash;
 
+/* Runs of consecutive global indices mapped to consecutive local indices, sorted by global index */
+typedef struct {
+  PetscInt  nruns;
+  PetscInt *gstart, *lstart, *len;
+} ISLocalToGlobalMapping_Sorted;
+
 /*@
   ISGetPointRange - Returns a description of the points in an `IS` suitable for traversal
 
@@ -194,6 +200,76 @@ static PetscErrorCode ISGlobalToLocalMappingSetUp_Hash(ISLocalToGlobalMapping ma
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode ISGlobalToLocalMappingSetUp_Sorted(ISLocalToGlobalMapping mapping)
+{
+  PetscInt                       *idx = mapping->indices, n = mapping->n, *g, *l, m = 0, k = -1, nruns = 0;
+  ISLocalToGlobalMapping_Sorted *map;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&map));
+  PetscCall(PetscMalloc2(n, &g, n, &l));
+  for (PetscInt i = 0; i < n; i++) {
+    if (idx[i] < 0) continue;
+    g[m]   = idx[i];
+    l[m++] = i;
+  }
+  PetscCall(PetscSortIntWithArray(m, g, l));
+  /* a global index appearing several times maps to its last local index, as with the other types */
+  for (PetscInt i = 0; i < m; i++) {
+    if (k >= 0 && g[i] == g[k]) l[k] = PetscMax(l[k], l[i]);
+    else {
+      k++;
+      g[k] = g[i];
+      l[k] = l[i];
+    }
+  }
+  m = k + 1;
+  for (PetscInt i = 0; i < m; i++)
+    if (!i || g[i] != g[i - 1] + 1 || l[i] != l[i - 1] + 1) nruns++;
+  PetscCall(PetscMalloc3(nruns, &map->gstart, nruns, &map->lstart, nruns, &map->len));
+  k = -1;
+  for (PetscInt i = 0; i < m; i++) {
+    if (!i || g[i] != g[i - 1] + 1 || l[i] != l[i - 1] + 1) {
+      k++;
+      map->gstart[k] = g[i];
+      map->lstart[k] = l[i];
+      map->len[k]    = 0;
+    }
+    map->len[k]++;
+  }
+  map->nruns = nruns;
+  PetscCall(PetscFree2(g, l));
+  mapping->data = (void *)map;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Finds the run containing the global index g, alternating interpolation and bisection steps so that evenly spread runs are
+   found in a few steps while the worst case stays logarithmic. Returns the local index or -1.
+*/
+static inline PetscInt ISLocalToGlobalMappingSortedFind_Private(const ISLocalToGlobalMapping_Sorted *map, PetscInt g)
+{
+  const PetscInt *gstart = map->gstart;
+  PetscInt        lo = 0, hi = map->nruns - 1;
+  PetscBool       interpolate = PETSC_TRUE;
+
+  if (hi < 0 || g < gstart[0]) return -1;
+  if (g >= gstart[hi]) lo = hi;
+  /* invariant gstart[lo] <= g < gstart[hi] */
+  while (hi - lo > 1) {
+    PetscInt mid;
+
+    if (interpolate) {
+      mid = lo + (PetscInt)((PetscReal)(g - gstart[lo]) / (PetscReal)(gstart[hi] - gstart[lo]) * (PetscReal)(hi - lo));
+      mid = PetscMin(PetscMax(mid, lo + 1), hi - 1);
+    } else mid = lo + (hi - lo) / 2;
+    if (gstart[mid] <= g) lo = mid;
+    else hi = mid;
+    interpolate = PetscNot(interpolate);
+  }
+  return g - gstart[lo] < map->len[lo] ? map->lstart[lo] + (g - gstart[lo]) : -1;
+}
+
 static PetscErrorCode ISLocalToGlobalMappingDestroy_Basic(ISLocalToGlobalMapping mapping)
 {
   ISLocalToGlobalMapping_Basic *map = (ISLocalToGlobalMapping_Basic *)mapping->data;
@@ -216,6 +292,17 @@ static PetscErrorCode ISLocalToGlobalMappingDestroy_Hash(ISLocalToGlobalMapping
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode ISLocalToGlobalMappingDestroy_Sorted(ISLocalToGlobalMapping mapping)
+{
+  ISLocalToGlobalMapping_Sorted *map = (ISLocalToGlobalMapping_Sorted *)mapping->data;
+
+  PetscFunctionBegin;
+  if (!map) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscFree3(map->gstart, map->lstart, map->len));
+  PetscCall(PetscFree(mapping->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode ISLocalToGlobalMappingResetBlockInfo_Private(ISLocalToGlobalMapping mapping)
 {
   PetscFunctionBegin;
@@ -270,6 +357,25 @@ static PetscErrorCode ISLocalToGlobalMappingResetBlockInfo_Private(ISLocalToGlob
   } while (0)
 #include <../src/vec/is/utils/isltog.h>
 
+#define GTOLTYPE _Sorted
+#define GTOLNAME _Sorted
+#define GTOLBS   mapping->bs
+#define GTOL(g, local) \
+  do { \
+    local = ISLocalToGlobalMappingSortedFind_Private(map, g / bs); \
+    if (local >= 0) local = bs * local + (g % bs); \
+  } while (0)
+#include <../src/vec/is/utils/isltog.h>
+
+#define GTOLTYPE _Sorted
+#define GTOLNAME Block_Sorted
+#define GTOLBS   1
+#define GTOL(g, local) \
+  do { \
+    local = ISLocalToGlobalMappingSortedFind_Private(map, g); \
+  } while (0)
+#include <../src/vec/is/utils/isltog.h>
+
 /*@
   ISLocalToGlobalMappingDuplicate - Duplicates the local to global mapping object
 
@@ -688,9 +794,10 @@ PetscErrorCode ISLocalToGlobalMappingGetBlockSize(ISLocalToGlobalMapping mapping
   For "small" problems when using `ISGlobalToLocalMappingApply()` and `ISGlobalToLocalMappingApplyBlock()`, the `ISLocalToGlobalMappingType`
   of `ISLOCALTOGLOBALMAPPINGBASIC` will be used; this uses more memory but is faster; this approach is not scalable for extremely large mappings.
 
-  For large problems `ISLOCALTOGLOBALMAPPINGHASH` is used, this is scalable.
+  For large problems `ISLOCALTOGLOBALMAPPINGHASH` is used, this is scalable. `ISLOCALTOGLOBALMAPPINGSORTED` is also scalable and
+  uses less memory and time than `ISLOCALTOGLOBALMAPPINGHASH` when the indices consist of long runs of consecutive global indices.
   Use `ISLocalToGlobalMappingSetType()` or call `ISLocalToGlobalMappingSetFromOptions()` with the option
-  `-islocaltoglobalmapping_type` <`basic`,`hash`> to control which is used.
+  `-islocaltoglobalmapping_type` <`basic`,`hash`,`sorted`> to control which is used.
 
 .seealso: [](sec_scatter), `ISLocalToGlobalMapping`, `ISLocalToGlobalMappingDestroy()`, `ISLocalToGlobalMappingCreateIS()`, `ISLocalToGlobalMappingSetFromOptions()`,
           `ISLOCALTOGLOBALMAPPINGBASIC`, `ISLOCALTOGLOBALMAPPINGHASH`,
@@ -735,7 +842,7 @@ PetscFunctionList ISLocalToGlobalMappingList = NULL;
 . mapping - mapping data structure
 
   Options Database Key:
-. -islocaltoglobalmapping_type (basic|hash) - nonscalable and scalable versions
+. -islocaltoglobalmapping_type (basic|hash|sorted) - nonscalable and scalable versions
 
   Level: advanced
 
@@ -807,6 +914,8 @@ PetscErrorCode ISLocalToGlobalMappingDestroy(ISLocalToGlobalMapping *mapping)
   Note:
   The output `IS` will have the same communicator as the input `IS` as well as the same block size.
 
+  If `is` is of type `ISSEGMENT` its indices are not expanded, the segments are mapped directly.
+
 .seealso: [](sec_scatter), `ISLocalToGlobalMappingApply()`, `ISLocalToGlobalMappingCreate()`,
           `ISLocalToGlobalMappingDestroy()`, `ISGlobalToLocalMappingApply()`
 @*/
@@ -814,6 +923,7 @@ PetscErrorCode ISLocalToGlobalMappingApplyIS(ISLocalToGlobalMapping mapping, IS
 {
   PetscInt        n, *idxout, bs;
   const PetscInt *idxin;
+  PetscBool       segment;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(mapping, IS_LTOGM_CLASSID, 1);
@@ -822,10 +932,14 @@ PetscErrorCode ISLocalToGlobalMappingApplyIS(ISLocalToGlobalMapping mapping, IS
 
   PetscCall(ISGetLocalSize(is, &n));
   PetscCall(ISGetBlockSize(is, &bs));
-  PetscCall(ISGetIndices(is, &idxin));
   PetscCall(PetscMalloc1(n, &idxout));
-  PetscCall(ISLocalToGlobalMappingApply(mapping, n, idxin, idxout));
-  PetscCall(ISRestoreIndices(is, &idxin));
+  PetscCall(PetscObjectTypeCompare((PetscObject)is, ISSEGMENT, &segment));
+  if (segment && (!n || is->min >= 0)) PetscCall(ISLocalToGlobalMappingApplySegment_Private(mapping, is, idxout));
+  else {
+    PetscCall(ISGetIndices(is, &idxin));
+    PetscCall(ISLocalToGlobalMappingApply(mapping, n, idxin, idxout));
+    PetscCall(ISRestoreIndices(is, &idxin));
+  }
   PetscCall(ISCreateGeneral(PetscObjectComm((PetscObject)is), n, idxout, PETSC_OWN_POINTER, newis));
   PetscCall(ISSetBlockSize(*newis, bs));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -1766,7 +1880,7 @@ PetscErrorCode ISLocalToGlobalMappingConcatenate(MPI_Comm comm, PetscInt n, cons
    Developer Note:
    This stores all the mapping information on each MPI rank.
 
-.seealso: [](sec_scatter), `ISLocalToGlobalMappingCreate()`, `ISLocalToGlobalMappingSetType()`, `ISLOCALTOGLOBALMAPPINGHASH`
+.seealso: [](sec_scatter), `ISLocalToGlobalMappingCreate()`, `ISLocalToGlobalMappingSetType()`, `ISLOCALTOGLOBALMAPPINGHASH`, `ISLOCALTOGLOBALMAPPINGSORTED`
 M*/
 PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingCreate_Basic(ISLocalToGlobalMapping ltog)
 {
@@ -1790,7 +1904,7 @@ PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingCreate_Basic(ISLocalToGlobalMa
    Note:
     This is selected automatically for large problems if the user does not set the type.
 
-.seealso: [](sec_scatter), `ISLocalToGlobalMappingCreate()`, `ISLocalToGlobalMappingSetType()`, `ISLOCALTOGLOBALMAPPINGBASIC`
+.seealso: [](sec_scatter), `ISLocalToGlobalMappingCreate()`, `ISLocalToGlobalMappingSetType()`, `ISLOCALTOGLOBALMAPPINGBASIC`, `ISLOCALTOGLOBALMAPPINGSORTED`
 M*/
 PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingCreate_Hash(ISLocalToGlobalMapping ltog)
 {
@@ -1802,6 +1916,35 @@ PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingCreate_Hash(ISLocalToGlobalMap
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*MC
+      ISLOCALTOGLOBALMAPPINGSORTED - implementation of the `ISLocalToGlobalMapping` object that stores the global indices as sorted runs
+                                     of consecutive global indices mapped to consecutive local indices. When `ISGlobalToLocalMappingApply()`
+                                     is used this is good for large problems whose local indices are mostly numbered in the global order.
+
+   Options Database Key:
+.   -islocaltoglobalmapping_type sorted - select this method
+
+   Level: intermediate
+
+   Notes:
+   The memory used is proportional to the number of runs, which is small when the owned indices and the ghost indices of each
+   neighbor are numbered contiguously, as is common for `DM` and `Mat` local numberings. A global index is found by searching
+   the runs with interpolation search.
+
+   When PETSc is configured with `--with-openmp-kernels` the lookups in `ISGlobalToLocalMappingApply()` are done by multiple threads.
+
+.seealso: [](sec_scatter), `ISLocalToGlobalMappingCreate()`, `ISLocalToGlobalMappingSetType()`, `ISLOCALTOGLOBALMAPPINGBASIC`, `ISLOCALTOGLOBALMAPPINGHASH`
+M*/
+PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingCreate_Sorted(ISLocalToGlobalMapping ltog)
+{
+  PetscFunctionBegin;
+  ltog->ops->globaltolocalmappingapply      = ISGlobalToLocalMappingApply_Sorted;
+  ltog->ops->globaltolocalmappingsetup      = ISGlobalToLocalMappingSetUp_Sorted;
+  ltog->ops->globaltolocalmappingapplyblock = ISGlobalToLocalMappingApplyBlock_Sorted;
+  ltog->ops->destroy                        = ISLocalToGlobalMappingDestroy_Sorted;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   ISLocalToGlobalMappingRegister -  Registers a method for applying a global to local mapping with an `ISLocalToGlobalMapping`
 
@@ -1831,7 +1974,7 @@ PETSC_EXTERN PetscErrorCode ISLocalToGlobalMappingCreate_Hash(ISLocalToGlobalMap
   `ISLocalToGlobalMappingRegister()` may be called multiple times to add several user-defined mappings.
 
 .seealso: [](sec_scatter), `ISLocalToGlobalMappingRegisterAll()`, `ISLocalToGlobalMappingRegisterDestroy()`, `ISLOCALTOGLOBALMAPPINGBASIC`,
-          `ISLOCALTOGLOBALMAPPINGHASH`, `ISLocalToGlobalMapping`, `ISLocalToGlobalMappingApply()`
+          `ISLOCALTOGLOBALMAPPINGHASH`, `ISLOCALTOGLOBALMAPPINGSORTED`, `ISLocalToGlobalMapping`, `ISLocalToGlobalMappingApply()`
 @*/
 PetscErrorCode ISLocalToGlobalMappingRegister(const char sname[], PetscErrorCode (*function)(ISLocalToGlobalMapping))
 {
@@ -1940,5 +2083,6 @@ PetscErrorCode ISLocalToGlobalMappingRegisterAll(void)
   ISLocalToGlobalMappingRegisterAllCalled = PETSC_TRUE;
   PetscCall(ISLocalToGlobalMappingRegister(ISLOCALTOGLOBALMAPPINGBASIC, ISLocalToGlobalMappingCreate_Basic));
   PetscCall(ISLocalToGlobalMappingRegister(ISLOCALTOGLOBALMAPPINGHASH, ISLocalToGlobalMappingCreate_Hash));
+  PetscCall(ISLocalToGlobalMappingRegister(ISLOCALTOGLOBALMAPPINGSORTED, ISLocalToGlobalMappingCreate_Sorted));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -19,8 +19,10 @@ static PetscErrorCode PETSCMAPNAME(ISGlobalToLocalMappingApply)(ISLocalToGlobalM
   end   = mapping->globalend;
   bs    = GTOLBS;
 
+  /* the lookups only read the mapping, so the loops without dependencies may be threaded */
   if (type == IS_GTOLM_MASK) {
     if (idxout) {
+      PetscPragmaUseOMPKernels(parallel for)
       for (i = 0; i < n; i++) {
         if (idx[i] < 0) idxout[i] = idx[i];
         else if (idx[i] < bs * start) idxout[i] = -1;
@@ -40,12 +42,15 @@ static PetscErrorCode PETSCMAPNAME(ISGlobalToLocalMappingApply)(ISLocalToGlobalM
         idxout[nf++] = tmp;
       }
     } else {
+      PetscPragmaUseOMPKernels(parallel for reduction(+ : nf))
       for (i = 0; i < n; i++) {
+        PetscInt local;
+
         if (idx[i] < 0) continue;
         if (idx[i] < bs * start) continue;
         if (idx[i] > bs * (end + 1) - 1) continue;
-        GTOL(idx[i], tmp);
-        if (tmp < 0) continue;
+        GTOL(idx[i], local);
+        if (local < 0) continue;
         nf++;
       }
     }
@@ -231,7 +231,7 @@ static PetscErrorCode PetscKDTreeBuildStemAndLeaves(KDTreeBuild kd_build, PetscC
   Developer Note:
   Building algorithm detailed in 'Building a Balanced k-d Tree in O(kn log n) Time' Brown, 2015
 
-.seealso: `PetscKDTree`, `PetscKDTreeDestroy()`, `PetscKDTreeQueryPointsNearestNeighbor()`
+.seealso: `PetscKDTree`, `PetscKDTreeDestroy()`, `PetscKDTreeQueryPointsNearestNeighbor()`, `PetscKDTreeQueryPointsRadius()`
 @*/
 PetscErrorCode PetscKDTreeCreate(PetscCount num_coords, PetscInt dim, const PetscReal coords[], PetscCopyMode copy_mode, PetscInt max_bucket_size, PetscKDTree *new_tree)
 {
@@ -321,82 +321,131 @@ static inline PetscReal PetscSquareDistance(PetscInt dim, const PetscReal *PETSC
   return dist;
 }
 
-static inline PetscErrorCode PetscKDTreeQueryLeaf(PetscKDTree tree, KDLeaf leaf, const PetscReal point[], PetscCount *index, PetscReal *distance_sqr)
+// Number of leaf points whose distances are computed together, small enough for the distances to stay in cache
+#define KDTREE_LEAF_BLOCK 32
+
+// Squared distances from point to the points [start, start + n) of the leaf, with n <= KDTREE_LEAF_BLOCK
+static inline void PetscKDTreeLeafDistances(PetscKDTree tree, KDLeaf leaf, const PetscReal point[], PetscInt start, PetscInt n, PetscReal dist[])
 {
   PetscInt dim = tree->dim;
 
-  PetscFunctionBeginUser;
-  *distance_sqr = PETSC_MAX_REAL;
-  *index        = -1;
-  for (PetscInt i = 0; i < leaf.count; i++) {
-    PetscCount point_index = tree->bucket_indices[leaf.indices_handle + i];
-    PetscReal  dist        = PetscSquareDistance(dim, point, &tree->coords[point_index * dim]);
-    if (dist < *distance_sqr) {
-      *distance_sqr = dist;
-      *index        = point_index;
+  if (leaf.coords_handle > -1) {
+    // Coord data saved in axis-major ordering, so each axis is a contiguous stream
+    for (PetscInt i = 0; i < n; i++) dist[i] = 0.;
+    for (PetscInt d = 0; d < dim; d++) {
+      const PetscReal *PETSC_RESTRICT x = &tree->coords[leaf.coords_handle + d * leaf.count + start];
+      const PetscReal                 p = point[d];
+
+      PetscPragmaSIMD
+      for (PetscInt i = 0; i < n; i++) dist[i] += PetscSqr(p - x[i]);
     }
+  } else {
+    const PetscCount *bucket_indices = &tree->bucket_indices[leaf.indices_handle + start];
+
+    for (PetscInt i = 0; i < n; i++) dist[i] = PetscSquareDistance(dim, point, &tree->coords[bucket_indices[i] * dim]);
   }
-  PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-static inline PetscErrorCode PetscKDTreeQueryLeaf_CopyCoords(PetscKDTree tree, KDLeaf leaf, const PetscReal point[], PetscCount *index, PetscReal *distance_sqr)
+// The query kernels cannot fail and do not use PetscCall(), so they may run inside threaded loops
+static inline void PetscKDTreeQueryLeaf(PetscKDTree tree, KDLeaf leaf, const PetscReal point[], PetscCount *index, PetscReal *distance_sqr)
 {
-  PetscInt dim = tree->dim;
+  PetscReal dist[KDTREE_LEAF_BLOCK];
 
-  PetscFunctionBeginUser;
   *distance_sqr = PETSC_MAX_REAL;
   *index        = -1;
-  for (PetscInt i = 0; i < leaf.count; i++) {
-    // Coord data saved in axis-major ordering for vectorization
-    PetscReal dist = 0.;
-    for (PetscInt d = 0; d < dim; d++) dist += PetscSqr(point[d] - tree->coords[leaf.coords_handle + d * leaf.count + i]);
-    if (dist < *distance_sqr) {
-      *distance_sqr = dist;
-      *index        = tree->bucket_indices[leaf.indices_handle + i];
+  for (PetscInt start = 0; start < leaf.count; start += KDTREE_LEAF_BLOCK) {
+    PetscInt n = PetscMin(KDTREE_LEAF_BLOCK, leaf.count - start);
+
+    PetscKDTreeLeafDistances(tree, leaf, point, start, n, dist);
+    for (PetscInt i = 0; i < n; i++) {
+      if (dist[i] < *distance_sqr) {
+        *distance_sqr = dist[i];
+        *index        = tree->bucket_indices[leaf.indices_handle + start + i];
+      }
     }
   }
-  PetscFunctionReturn(PETSC_SUCCESS);
 }
 
 // Recursive point query from 'Algorithms for Fast Vector Quantization' by  Sunil Arya and David Mount
 // Variant also implemented in pykdtree
-static PetscErrorCode PetscKDTreeQuery_Recurse(PetscKDTree tree, const PetscReal point[], PetscCount node_handle, char is_node_leaf, PetscReal offset[], PetscReal rd, PetscReal tol_sqr, PetscCount *index, PetscReal *dist_sqr)
+static void PetscKDTreeQuery_Recurse(PetscKDTree tree, const PetscReal point[], PetscCount node_handle, char is_node_leaf, PetscReal offset[], PetscReal rd, PetscReal tol_sqr, PetscCount *index, PetscReal *dist_sqr)
 {
-  PetscFunctionBeginUser;
-  if (*dist_sqr < tol_sqr) PetscFunctionReturn(PETSC_SUCCESS);
+  if (*dist_sqr < tol_sqr) return;
   if (is_node_leaf) {
-    KDLeaf     leaf = tree->leaves[node_handle];
     PetscReal  dist;
     PetscCount point_index;
 
-    if (leaf.coords_handle > -1) PetscCall(PetscKDTreeQueryLeaf_CopyCoords(tree, leaf, point, &point_index, &dist));
-    else PetscCall(PetscKDTreeQueryLeaf(tree, leaf, point, &point_index, &dist));
+    PetscKDTreeQueryLeaf(tree, tree->leaves[node_handle], point, &point_index, &dist);
     if (dist < *dist_sqr) {
       *dist_sqr = dist;
       *index    = point_index;
     }
-    PetscFunctionReturn(PETSC_SUCCESS);
+    return;
   }
 
   KDStem    stem       = tree->stems[node_handle];
   PetscReal old_offset = offset[stem.axis], new_offset = point[stem.axis] - stem.split;
   if (new_offset <= 0) {
-    PetscCall(PetscKDTreeQuery_Recurse(tree, point, stem.less_equal_handle, PetscBTLookup(&stem.are_handles_leaves, LESS_EQUAL_BIT), offset, rd, tol_sqr, index, dist_sqr));
+    PetscKDTreeQuery_Recurse(tree, point, stem.less_equal_handle, PetscBTLookup(&stem.are_handles_leaves, LESS_EQUAL_BIT), offset, rd, tol_sqr, index, dist_sqr);
     rd += -PetscSqr(old_offset) + PetscSqr(new_offset);
     if (rd < *dist_sqr) {
       offset[stem.axis] = new_offset;
-      PetscCall(PetscKDTreeQuery_Recurse(tree, point, stem.greater_handle, PetscBTLookup(&stem.are_handles_leaves, GREATER_BIT), offset, rd, tol_sqr, index, dist_sqr));
+      PetscKDTreeQuery_Recurse(tree, point, stem.greater_handle, PetscBTLookup(&stem.are_handles_leaves, GREATER_BIT), offset, rd, tol_sqr, index, dist_sqr);
       offset[stem.axis] = old_offset;
     }
   } else {
-    PetscCall(PetscKDTreeQuery_Recurse(tree, point, stem.greater_handle, PetscBTLookup(&stem.are_handles_leaves, GREATER_BIT), offset, rd, tol_sqr, index, dist_sqr));
+    PetscKDTreeQuery_Recurse(tree, point, stem.greater_handle, PetscBTLookup(&stem.are_handles_leaves, GREATER_BIT), offset, rd, tol_sqr, index, dist_sqr);
     rd += -PetscSqr(old_offset) + PetscSqr(new_offset);
     if (rd < *dist_sqr) {
       offset[stem.axis] = new_offset;
-      PetscCall(PetscKDTreeQuery_Recurse(tree, point, stem.less_equal_handle, PetscBTLookup(&stem.are_handles_leaves, LESS_EQUAL_BIT), offset, rd, tol_sqr, index, dist_sqr));
+      PetscKDTreeQuery_Recurse(tree, point, stem.less_equal_handle, PetscBTLookup(&stem.are_handles_leaves, LESS_EQUAL_BIT), offset, rd, tol_sqr, index, dist_sqr);
       offset[stem.axis] = old_offset;
     }
   }
+}
+
+// Handle of the leaf whose cell contains point
+static inline PetscCount PetscKDTreeFindLeaf(PetscKDTree tree, const PetscReal point[])
+{
+  PetscCount handle = tree->root_handle;
+
+  if (tree->is_root_leaf) return handle;
+  while (PETSC_TRUE) {
+    KDStem stem = tree->stems[handle];
+
+    if (point[stem.axis] - stem.split <= 0) {
+      handle = stem.less_equal_handle;
+      if (PetscBTLookup(&stem.are_handles_leaves, LESS_EQUAL_BIT)) return handle;
+    } else {
+      handle = stem.greater_handle;
+      if (PetscBTLookup(&stem.are_handles_leaves, GREATER_BIT)) return handle;
+    }
+  }
+}
+
+// Below this number of query points, the points are queried in the given order without sorting them by leaf
+#define KDTREE_QUERY_SORT_MIN 64
+
+// Orders the query points by the leaf containing them, so that consecutive queries traverse the same part of the tree.
+// On output the points in batch b are perm[batch_offsets[b]], ..., perm[batch_offsets[b + 1] - 1], all the arrays are sized by num_points
+static PetscErrorCode PetscKDTreeSortPointsByLeaf(PetscKDTree tree, PetscCount num_points, const PetscReal points[], PetscCount *num_batches, PetscCount **batch_offsets, PetscCount **perm)
+{
+  PetscInt *point_leaf;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscMalloc1(num_points, &point_leaf));
+  PetscCall(PetscMalloc2(num_points, perm, num_points + 1, batch_offsets));
+  for (PetscCount p = 0; p < num_points; p++) {
+    point_leaf[p] = (PetscInt)PetscKDTreeFindLeaf(tree, &points[p * tree->dim]);
+    (*perm)[p]    = p;
+  }
+  PetscCall(PetscSortIntWithCountArray(num_points, point_leaf, *perm));
+  *num_batches = 0;
+  for (PetscCount p = 0; p < num_points; p++) {
+    if (!p || point_leaf[p] != point_leaf[p - 1]) (*batch_offsets)[(*num_batches)++] = p;
+  }
+  (*batch_offsets)[*num_batches] = num_points;
+  PetscCall(PetscFree(point_leaf));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -422,14 +471,18 @@ static PetscErrorCode PetscKDTreeQuery_Recurse(PetscKDTree tree, const PetscReal
 
   The `indices` and `distances` arrays should be at least of size `num_points`.
 
-.seealso: `PetscKDTree`, `PetscKDTreeCreate()`
+  Unless there are only a few query points, they are processed in batches of points lying in the same leaf of the tree, which improves
+  the cache reuse when the query points are not spatially ordered. When PETSc is configured with `--with-openmp-kernels` the batches are processed by multiple threads.
+
+.seealso: `PetscKDTree`, `PetscKDTreeCreate()`, `PetscKDTreeQueryPointsRadius()`
 @*/
 PetscErrorCode PetscKDTreeQueryPointsNearestNeighbor(PetscKDTree tree, PetscCount num_points, const PetscReal points[], PetscReal tolerance, PetscCount indices[], PetscReal distances[])
 {
-  PetscReal *offsets, rd;
+  PetscReal  *offsets, tol_sqr = PetscSqr(tolerance);
+  PetscCount *batch_offsets = NULL, *perm = NULL, num_batches = 0;
+  PetscInt    dim;
 
   PetscFunctionBeginUser;
-  PetscCall(PetscLogEventBegin(PetscKDTree_Query, 0, 0, 0, 0));
   if (tree == NULL) {
     PetscCheck(num_points == 0, PETSC_COMM_SELF, PETSC_ERR_USER_INPUT, "num_points may only be zero, if tree is NULL");
     PetscFunctionReturn(PETSC_SUCCESS);
@@ -437,15 +490,132 @@ PetscErrorCode PetscKDTreeQueryPointsNearestNeighbor(PetscKDTree tree, PetscCoun
   PetscAssertPointer(points, 3);
   PetscAssertPointer(indices, 5);
   PetscAssertPointer(distances, 6);
-  PetscCall(PetscCalloc1(tree->dim, &offsets));
+  PetscCall(PetscLogEventBegin(PetscKDTree_Query, 0, 0, 0, 0));
+  dim = tree->dim;
+  if (num_points < KDTREE_QUERY_SORT_MIN) {
+    PetscCall(PetscCalloc1(dim, &offsets));
+    for (PetscCount p = 0; p < num_points; p++) {
+      distances[p] = PETSC_MAX_REAL;
+      indices[p]   = -1;
+      PetscKDTreeQuery_Recurse(tree, &points[p * dim], tree->root_handle, (char)tree->is_root_leaf, offsets, 0., tol_sqr, &indices[p], &distances[p]);
+      distances[p] = PetscSqrtReal(distances[p]);
+    }
+  } else {
+    PetscCall(PetscKDTreeSortPointsByLeaf(tree, num_points, points, &num_batches, &batch_offsets, &perm));
+    // Each batch gets its own offsets, so that batches are independent
+    PetscCall(PetscCalloc1(num_batches * dim, &offsets));
+
+    PetscPragmaUseOMPKernels(parallel for schedule(dynamic))
+    for (PetscCount b = 0; b < num_batches; b++) {
+      for (PetscCount i = batch_offsets[b]; i < batch_offsets[b + 1]; i++) {
+        PetscCount p = perm[i];
+
+        distances[p] = PETSC_MAX_REAL;
+        indices[p]   = -1;
+        PetscKDTreeQuery_Recurse(tree, &points[p * dim], tree->root_handle, (char)tree->is_root_leaf, &offsets[b * dim], 0., tol_sqr, &indices[p], &distances[p]);
+        distances[p] = PetscSqrtReal(distances[p]);
+      }
+    }
+  }
+  PetscCall(PetscFree2(perm, batch_offsets));
+  PetscCall(PetscFree(offsets));
+  PetscCall(PetscLogEventEnd(PetscKDTree_Query, 0, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PetscKDTreeQueryRadius_Recurse(PetscKDTree tree, const PetscReal point[], PetscCount node_handle, char is_node_leaf, PetscReal offset[], PetscReal rd, PetscReal radius_sqr, PetscSegBuffer neighbors)
+{
+  PetscFunctionBeginUser;
+  if (is_node_leaf) {
+    KDLeaf    leaf = tree->leaves[node_handle];
+    PetscReal dist[KDTREE_LEAF_BLOCK];
+
+    for (PetscInt start = 0; start < leaf.count; start += KDTREE_LEAF_BLOCK) {
+      PetscInt n = PetscMin(KDTREE_LEAF_BLOCK, leaf.count - start);
+
+      PetscKDTreeLeafDistances(tree, leaf, point, start, n, dist);
+      for (PetscInt i = 0; i < n; i++) {
+        if (dist[i] <= radius_sqr) {
+          PetscCount *neighbor;
+
+          PetscCall(PetscSegBufferGet(neighbors, 1, &neighbor));
+          *neighbor = tree->bucket_indices[leaf.indices_handle + start + i];
+        }
+      }
+    }
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  KDStem     stem             = tree->stems[node_handle];
+  PetscReal  old_offset       = offset[stem.axis], new_offset = point[stem.axis] - stem.split;
+  PetscBool  less_equal_first = new_offset <= 0 ? PETSC_TRUE : PETSC_FALSE;
+  PetscCount near_handle      = less_equal_first ? stem.less_equal_handle : stem.greater_handle;
+  PetscCount far_handle       = less_equal_first ? stem.greater_handle : stem.less_equal_handle;
+  char       is_near_leaf     = PetscBTLookup(&stem.are_handles_leaves, less_equal_first ? LESS_EQUAL_BIT : GREATER_BIT);
+  char       is_far_leaf      = PetscBTLookup(&stem.are_handles_leaves, less_equal_first ? GREATER_BIT : LESS_EQUAL_BIT);
+
+  PetscCall(PetscKDTreeQueryRadius_Recurse(tree, point, near_handle, is_near_leaf, offset, rd, radius_sqr, neighbors));
+  rd += -PetscSqr(old_offset) + PetscSqr(new_offset);
+  if (rd <= radius_sqr) {
+    offset[stem.axis] = new_offset;
+    PetscCall(PetscKDTreeQueryRadius_Recurse(tree, point, far_handle, is_far_leaf, offset, rd, radius_sqr, neighbors));
+    offset[stem.axis] = old_offset;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@C
+  PetscKDTreeQueryPointsRadius - find all the points of a `PetscKDTree` within a given distance of the query points
+
+  Not Collective, No Fortran Support
+
+  Input Parameters:
++ tree       - tree to query
+. num_points - number of points to query
+. points     - array of the coordinates, in point-major order
+- radius     - the search radius
+
+  Output Parameters:
++ neighbor_offsets - array of size `num_points` + 1, the neighbors of query point `p` are `neighbors[neighbor_offsets[p]]`, ..., `neighbors[neighbor_offsets[p + 1] - 1]`
+- neighbors        - indices of the tree points within `radius` of each query point, sorted in increasing order for each query point
 
+  Level: advanced
+
+  Note:
+  The caller is responsible for freeing `neighbor_offsets` and `neighbors` with `PetscFree()`.
+
+.seealso: `PetscKDTree`, `PetscKDTreeCreate()`, `PetscKDTreeQueryPointsNearestNeighbor()`
+@*/
+PetscErrorCode PetscKDTreeQueryPointsRadius(PetscKDTree tree, PetscCount num_points, const PetscReal points[], PetscReal radius, PetscCount *neighbor_offsets[], PetscCount *neighbors[])
+{
+  PetscReal     *offsets, radius_sqr = PetscSqr(radius);
+  PetscCount    *noffsets;
+  PetscSegBuffer seg;
+
+  PetscFunctionBeginUser;
+  PetscAssertPointer(neighbor_offsets, 5);
+  PetscAssertPointer(neighbors, 6);
+  PetscCheck(radius >= 0, PETSC_COMM_SELF, PETSC_ERR_USER_INPUT, "Radius may not be negative, received %g", (double)radius);
+  PetscCall(PetscMalloc1(num_points + 1, &noffsets));
+  noffsets[0] = 0;
+  if (tree == NULL) {
+    PetscCheck(num_points == 0, PETSC_COMM_SELF, PETSC_ERR_USER_INPUT, "num_points may only be zero, if tree is NULL");
+    PetscCall(PetscMalloc1(0, neighbors));
+    *neighbor_offsets = noffsets;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscAssertPointer(points, 3);
+  PetscCall(PetscLogEventBegin(PetscKDTree_Query, 0, 0, 0, 0));
+  PetscCall(PetscCalloc1(tree->dim, &offsets));
+  PetscCall(PetscSegBufferCreate(sizeof(PetscCount), num_points, &seg));
   for (PetscCount p = 0; p < num_points; p++) {
-    rd           = 0.;
-    distances[p] = PETSC_MAX_REAL;
-    indices[p]   = -1;
-    PetscCall(PetscKDTreeQuery_Recurse(tree, &points[p * tree->dim], tree->root_handle, (char)tree->is_root_leaf, offsets, rd, PetscSqr(tolerance), &indices[p], &distances[p]));
-    distances[p] = PetscSqrtReal(distances[p]);
+    PetscCall(PetscKDTreeQueryRadius_Recurse(tree, &points[p * tree->dim], tree->root_handle, (char)tree->is_root_leaf, offsets, 0., radius_sqr, seg));
+    PetscCall(PetscSegBufferGetSize(seg, &noffsets[p + 1]));
   }
+  PetscCall(PetscSegBufferExtractAlloc(seg, neighbors));
+  PetscCall(PetscSegBufferDestroy(&seg));
+  for (PetscCount p = 0; p < num_points; p++) PetscCall(PetscSortCount(noffsets[p + 1] - noffsets[p], &(*neighbors)[noffsets[p]]));
+  *neighbor_offsets = noffsets;
   PetscCall(PetscFree(offsets));
   PetscCall(PetscLogEventEnd(PetscKDTree_Query, 0, 0, 0, 0));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -1,5 +1,6 @@
 #include <petsc/private/petscimpl.h>
 #include <petscis.h> /*I "petscis.h" I*/
+#include <petscsf.h>
 
 /* This is the bitonic merge that works on non-power-of-2 sizes found at http://www.iti.fh-flensburg.de/lang/algorithmen/sortieren/bitonic/oddn.htm */
 static PetscErrorCode PetscParallelSortInt_Bitonic_Merge(MPI_Comm comm, PetscMPIInt tag, PetscMPIInt rankStart, PetscMPIInt rankEnd, PetscMPIInt rank, PetscMPIInt n, PetscInt keys[], PetscInt buffer[], PetscBool forward)
@@ -80,13 +81,15 @@ static PetscErrorCode PetscParallelSortInt_Bitonic(MPI_Comm comm, PetscInt n, Pe
 
   PetscFunctionBegin;
   PetscAssertPointer(keys, 3);
-  PetscCall(PetscCommGetNewTag(comm, &tag));
+  /* layouts may live on a communicator that was not created by PETSc, which cannot provide tags */
+  PetscCall(PetscCommDuplicate(comm, &comm, &tag));
   PetscCallMPI(MPI_Comm_size(comm, &size));
   PetscCallMPI(MPI_Comm_rank(comm, &rank));
   PetscCall(PetscMPIIntCast(n, &mpin));
   PetscCall(PetscMalloc1(n, &buffer));
   PetscCall(PetscParallelSortInt_Bitonic_Recursive(comm, tag, 0, size, rank, mpin, keys, buffer, PETSC_TRUE));
   PetscCall(PetscFree(buffer));
+  PetscCall(PetscCommDestroy(&comm));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -165,6 +168,7 @@ static PetscErrorCode PetscParallelSampleSelect(PetscLayout mapin, PetscLayout m
 
 static PetscErrorCode PetscParallelRedistribute(PetscLayout map, PetscInt n, PetscInt arrayin[], PetscInt arrayout[])
 {
+  MPI_Comm     comm;
   PetscMPIInt  size, rank;
   PetscInt     myOffset, nextOffset;
   PetscCount   total;
@@ -175,15 +179,15 @@ static PetscErrorCode PetscParallelRedistribute(PetscLayout map, PetscInt n, Pet
   MPI_Request *secondreqs;
 
   PetscFunctionBegin;
-  PetscCallMPI(MPI_Comm_size(map->comm, &size));
-  PetscCallMPI(MPI_Comm_rank(map->comm, &rank));
-  PetscCall(PetscCommGetNewTag(map->comm, &firsttag));
-  PetscCall(PetscCommGetNewTag(map->comm, &secondtag));
+  PetscCall(PetscCommDuplicate(map->comm, &comm, &firsttag));
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+  PetscCall(PetscCommGetNewTag(comm, &secondtag));
   PetscCall(PetscMalloc2(size, &firstreqs, size, &secondreqs));
-  PetscCallMPI(MPI_Scan(&n, &nextOffset, 1, MPIU_INT, MPI_SUM, map->comm));
+  PetscCallMPI(MPI_Scan(&n, &nextOffset, 1, MPIU_INT, MPI_SUM, comm));
   myOffset = nextOffset - n;
   total    = map->range[rank + 1] - map->range[rank];
-  if (total > 0) PetscCallMPI(MPIU_Irecv(arrayout, total, MPIU_INT, MPI_ANY_SOURCE, firsttag, map->comm, &firstreqrcv));
+  if (total > 0) PetscCallMPI(MPIU_Irecv(arrayout, total, MPIU_INT, MPI_ANY_SOURCE, firsttag, comm, &firstreqrcv));
   nsecond = 0;
   nfirst  = 0;
   for (PetscMPIInt i = 0; i < size; i++) {
@@ -197,13 +201,13 @@ static PetscErrorCode PetscParallelRedistribute(PetscLayout map, PetscInt n, Pet
     overlap = oEnd - oStart;
     if (map->range[i] >= myOffset && map->range[i] < nextOffset) {
       /* send first message */
-      PetscCallMPI(MPIU_Isend(&arrayin[map->range[i] - myOffset], overlap, MPIU_INT, i, firsttag, map->comm, &firstreqs[nfirst++]));
+      PetscCallMPI(MPIU_Isend(&arrayin[map->range[i] - myOffset], overlap, MPIU_INT, i, firsttag, comm, &firstreqs[nfirst++]));
     } else if (overlap > 0) {
       /* send second message */
-      PetscCallMPI(MPIU_Isend(&arrayin[oStart - myOffset], overlap, MPIU_INT, i, secondtag, map->comm, &secondreqs[nsecond++]));
+      PetscCallMPI(MPIU_Isend(&arrayin[oStart - myOffset], overlap, MPIU_INT, i, secondtag, comm, &secondreqs[nsecond++]));
     } else if (overlap == 0 && myOffset > map->range[i] && myOffset < map->range[i + 1]) {
       /* send empty second message */
-      PetscCallMPI(MPIU_Isend(&arrayin[oStart - myOffset], 0, MPIU_INT, i, secondtag, map->comm, &secondreqs[nsecond++]));
+      PetscCallMPI(MPIU_Isend(&arrayin[oStart - myOffset], 0, MPIU_INT, i, secondtag, comm, &secondreqs[nsecond++]));
     }
   }
   if (total > 0) {
@@ -218,7 +222,7 @@ static PetscErrorCode PetscParallelRedistribute(PetscLayout map, PetscInt n, Pet
       PetscCount mfilled;
 
       sender++;
-      PetscCallMPI(MPIU_Recv(&arrayout[filled], total - filled, MPIU_INT, sender, secondtag, map->comm, &status));
+      PetscCallMPI(MPIU_Recv(&arrayout[filled], total - filled, MPIU_INT, sender, secondtag, comm, &status));
       PetscCallMPI(MPIU_Get_count(&status, MPIU_INT, &mfilled));
       filled += mfilled;
     }
@@ -226,6 +230,7 @@ static PetscErrorCode PetscParallelRedistribute(PetscLayout map, PetscInt n, Pet
   PetscCallMPI(MPI_Waitall(nfirst, firstreqs, MPI_STATUSES_IGNORE));
   PetscCallMPI(MPI_Waitall(nsecond, secondreqs, MPI_STATUSES_IGNORE));
   PetscCall(PetscFree2(firstreqs, secondreqs));
+  PetscCall(PetscCommDestroy(&comm));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -311,7 +316,7 @@ static PetscErrorCode PetscParallelSortInt_Samplesort(PetscLayout mapin, PetscLa
 
   If `keysin` != `keysout`, then `keysin` will not be changed during `PetscParallelSortInt()`.
 
-.seealso: `PetscSortInt()`, `PetscParallelSortedInt()`
+.seealso: `PetscSortInt()`, `PetscParallelSortedInt()`, `PetscParallelSortIntWithDataArray()`
 @*/
 PetscErrorCode PetscParallelSortInt(PetscLayout mapin, PetscLayout mapout, PetscInt keysin[], PetscInt keysout[])
 {
@@ -350,3 +355,219 @@ PetscErrorCode PetscParallelSortInt(PetscLayout mapin, PetscLayout mapout, Petsc
   PetscCall(PetscFree(keysincopy));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+/* Below this size the comparison sort is faster than the radix sort */
+#define PETSC_RADIX_SORT_MIN 1024
+
+/* Flipping the sign bit orders the keys as unsigned integers; only the low sizeof(PetscInt) bytes are used */
+#define PetscRadixKey(k) ((uint64_t)(k) ^ ((uint64_t)1 << (8 * sizeof(PetscInt) - 1)))
+
+/* Stable LSD radix sort of keys[] carrying perm[], one byte per pass. Passes in which all keys have the same byte are
+   skipped, so small key ranges need few passes. */
+static PetscErrorCode PetscSortIntWithArray_Radix(PetscInt n, PetscInt keys[], PetscInt perm[])
+{
+  const int npass = (int)sizeof(PetscInt);
+  PetscInt *count, *kbuf, *pbuf, *ksrc = keys, *psrc = perm;
+
+  PetscFunctionBegin;
+  if (n < PETSC_RADIX_SORT_MIN) {
+    PetscCall(PetscSortIntWithArray(n, keys, perm));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscCalloc1(256 * npass, &count));
+  PetscCall(PetscMalloc2(n, &kbuf, n, &pbuf));
+  /* histograms of all passes in one sweep */
+  for (PetscInt i = 0; i < n; i++) {
+    uint64_t u = PetscRadixKey(keys[i]);
+
+    for (int b = 0; b < npass; b++) count[256 * b + ((u >> (8 * b)) & 0xff)]++;
+  }
+  for (int b = 0; b < npass; b++) {
+    PetscInt *c = &count[256 * b], *kdst, *pdst, sum = 0;
+    uint64_t  first = PetscRadixKey(ksrc[0]);
+
+    if (c[(first >> (8 * b)) & 0xff] == n) continue;
+    for (int d = 0; d < 256; d++) {
+      PetscInt t = c[d];
+
+      c[d] = sum;
+      sum += t;
+    }
+    kdst = ksrc == keys ? kbuf : keys;
+    pdst = psrc == perm ? pbuf : perm;
+    for (PetscInt i = 0; i < n; i++) {
+      uint64_t u = PetscRadixKey(ksrc[i]);
+      PetscInt j = c[(u >> (8 * b)) & 0xff]++;
+
+      kdst[j] = ksrc[i];
+      pdst[j] = psrc[i];
+    }
+    ksrc = kdst;
+    psrc = pdst;
+  }
+  if (ksrc != keys) {
+    PetscCall(PetscArraycpy(keys, ksrc, n));
+    PetscCall(PetscArraycpy(perm, psrc, n));
+  }
+  PetscCall(PetscFree2(kbuf, pbuf));
+  PetscCall(PetscFree(count));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PetscParallelSortIntWithDataArray - Globally sort a distributed array of integers, carrying along a payload of fixed size with each integer
+
+  Collective
+
+  Input Parameters:
++ mapin     - `PetscLayout` describing the distribution of the input keys
+. mapout    - `PetscLayout` describing the desired distribution of the output keys
+. keysin    - the array of integers
+. datain    - the payloads of the integers, `unitbytes` bytes each
+- unitbytes - the size in bytes of one payload
+
+  Output Parameters:
++ keysout - the array in which the sorted integers will be stored
+- dataout - the array in which the payloads will be stored, in the order of `keysout`
+
+  Level: developer
+
+  Notes:
+  If `mapin` == `mapout`, then `keysin` may be equal to `keysout` and `datain` may be equal to `dataout`. Otherwise `keysin` and `datain` are not changed.
+
+  `mapout` determines how many keys end on each process, so the output can be balanced by count or, by choosing its local sizes, by any other weight.
+
+  This uses the same samplesort as `PetscParallelSortInt()`, except that the keys are sorted locally with a radix sort that moves
+  a permutation instead of the payloads. The keys are repartitioned according to the pivots and then redistributed to match
+  `mapout` with two `PetscSF` reductions whose leaves are permuted, so each payload is only moved twice, directly between `datain`,
+  an intermediate array and `dataout`.
+
+  The relative order of equal keys is not preserved.
+
+.seealso: `PetscParallelSortInt()`, `PetscSortIntWithDataArray()`, `PetscParallelSortedInt()`
+@*/
+PetscErrorCode PetscParallelSortIntWithDataArray(PetscLayout mapin, PetscLayout mapout, PetscInt keysin[], void *datain, size_t unitbytes, PetscInt keysout[], void *dataout)
+{
+  MPI_Comm     comm;
+  MPI_Datatype unit;
+  PetscMPIInt  size, result, mpiunitbytes, r;
+  PetscInt     nin, *keys, *perm, *pivots, *nsend, *nrecv, *roffsets, *soffsets, *kmid, nmid = 0, midstart;
+  PetscSF      sf;
+  PetscSFNode *remote;
+  char        *dmid;
+
+  PetscFunctionBegin;
+  PetscAssertPointer(mapin, 1);
+  PetscAssertPointer(mapout, 2);
+  comm = mapin->comm;
+  PetscCallMPI(MPI_Comm_compare(comm, mapout->comm, &result));
+  PetscCheck(result == MPI_IDENT || result == MPI_CONGRUENT, comm, PETSC_ERR_ARG_NOTSAMECOMM, "layouts are not on the same communicator");
+  PetscCheck(unitbytes > 0, comm, PETSC_ERR_ARG_OUTOFRANGE, "The payload size must be positive, use PetscParallelSortInt() to sort keys without payload");
+  PetscCall(PetscLayoutSetUp(mapin));
+  PetscCall(PetscLayoutSetUp(mapout));
+  nin = mapin->n;
+  if (nin) {
+    PetscAssertPointer(keysin, 3);
+    PetscAssertPointer(datain, 4);
+  }
+  if (mapout->n) {
+    PetscAssertPointer(keysout, 6);
+    PetscAssertPointer(dataout, 7);
+  }
+  PetscCheck(mapin->N == mapout->N, comm, PETSC_ERR_ARG_SIZ, "Input and output layouts have different global sizes (%" PetscInt_FMT " != %" PetscInt_FMT ")", mapin->N, mapout->N);
+  PetscCallMPI(MPI_Comm_size(comm, &size));
+
+  /* sort a copy of the keys locally, carrying the permutation */
+  PetscCall(PetscMalloc1(nin, &keys));
+  PetscCall(PetscMalloc1(nin, &perm));
+  PetscCall(PetscArraycpy(keys, keysin, nin));
+  for (PetscInt i = 0; i < nin; i++) perm[i] = i;
+  PetscCall(PetscSortIntWithArray_Radix(nin, keys, perm));
+  if (size == 1) {
+    char *buffer;
+
+    PetscCall(PetscMalloc(nin * unitbytes, &buffer));
+    for (PetscInt i = 0; i < nin; i++) PetscCall(PetscMemcpy(&buffer[i * unitbytes], &((char *)datain)[perm[i] * unitbytes], unitbytes));
+    PetscCall(PetscMemcpy(dataout, buffer, nin * unitbytes));
+    PetscCall(PetscArraycpy(keysout, keys, nin));
+    PetscCall(PetscFree(buffer));
+    PetscCall(PetscFree(keys));
+    PetscCall(PetscFree(perm));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  PetscCall(PetscMPIIntCast(unitbytes, &mpiunitbytes));
+  PetscCallMPI(MPI_Type_contiguous(mpiunitbytes, MPI_BYTE, &unit));
+  PetscCallMPI(MPI_Type_commit(&unit));
+  /* get P - 1 pivots and count the keys going to each process */
+  PetscCall(PetscParallelSampleSelect(mapin, mapout, keys, &pivots));
+  PetscCall(PetscCalloc4(size, &nsend, size, &nrecv, size, &roffsets, size, &soffsets));
+  r = 0;
+  for (PetscInt i = 0; i < nin; i++) {
+    while (r < size - 1 && keys[i] >= pivots[r]) r++;
+    nsend[r]++;
+  }
+  /* each process gets the offsets of its keys in the intermediate arrays of the others */
+  PetscCallMPI(MPI_Alltoall(nsend, 1, MPIU_INT, nrecv, 1, MPIU_INT, comm));
+  for (PetscMPIInt i = 0; i < size; i++) {
+    roffsets[i] = nmid;
+    nmid += nrecv[i];
+  }
+  PetscCallMPI(MPI_Alltoall(roffsets, 1, MPIU_INT, soffsets, 1, MPIU_INT, comm));
+  /* the leaves are the input entries in place, so the payloads are read through the permutation without copying them */
+  PetscCall(PetscMalloc1(nin, &remote));
+  r = 0;
+  for (PetscInt i = 0; i < nin; i++) {
+    while (r < size - 1 && keys[i] >= pivots[r]) r++;
+    remote[perm[i]].rank  = r;
+    remote[perm[i]].index = soffsets[r]++;
+  }
+  PetscCall(PetscFree4(nsend, nrecv, roffsets, soffsets));
+  PetscCall(PetscFree(pivots));
+  PetscCall(PetscFree(keys));
+  PetscCall(PetscFree(perm));
+
+  /* repartition the keys and payloads according to the pivots */
+  PetscCall(PetscMalloc2(nmid, &kmid, nmid * unitbytes, &dmid));
+  PetscCall(PetscSFCreate(comm, &sf));
+  PetscCall(PetscSFSetGraph(sf, nmid, nin, NULL, PETSC_OWN_POINTER, remote, PETSC_OWN_POINTER));
+  PetscCall(PetscSFReduceBegin(sf, MPIU_INT, keysin, kmid, MPI_REPLACE));
+  PetscCall(PetscSFReduceBegin(sf, unit, datain, dmid, MPI_REPLACE));
+  PetscCall(PetscSFReduceEnd(sf, MPIU_INT, keysin, kmid, MPI_REPLACE));
+  PetscCall(PetscSFReduceEnd(sf, unit, datain, dmid, MPI_REPLACE));
+  PetscCall(PetscSFDestroy(&sf));
+
+  /* merge the sorted runs received from each process and redistribute to the desired layout */
+  PetscCall(PetscMalloc1(nmid, &keys));
+  PetscCall(PetscMalloc1(nmid, &perm));
+  PetscCall(PetscArraycpy(keys, kmid, nmid));
+  for (PetscInt i = 0; i < nmid; i++) perm[i] = i;
+  PetscCall(PetscSortIntWithArray_Radix(nmid, keys, perm));
+  if (PetscDefined(USE_DEBUG)) {
+    PetscBool sorted;
+
+    PetscCall(PetscParallelSortedInt(comm, nmid, keys, &sorted));
+    PetscCheck(sorted, comm, PETSC_ERR_PLIB, "samplesort (pre-redistribute) sort failed");
+  }
+  PetscCallMPI(MPI_Scan(&nmid, &midstart, 1, MPIU_INT, MPI_SUM, comm));
+  midstart -= nmid;
+  PetscCall(PetscMalloc1(nmid, &remote));
+  r = 0;
+  for (PetscInt i = 0; i < nmid; i++) {
+    while (midstart + i >= mapout->range[r + 1]) r++;
+    remote[perm[i]].rank  = r;
+    remote[perm[i]].index = midstart + i - mapout->range[r];
+  }
+  PetscCall(PetscFree(keys));
+  PetscCall(PetscFree(perm));
+  PetscCall(PetscSFCreate(comm, &sf));
+  PetscCall(PetscSFSetGraph(sf, mapout->n, nmid, NULL, PETSC_OWN_POINTER, remote, PETSC_OWN_POINTER));
+  PetscCall(PetscSFReduceBegin(sf, MPIU_INT, kmid, keysout, MPI_REPLACE));
+  PetscCall(PetscSFReduceBegin(sf, unit, dmid, dataout, MPI_REPLACE));
+  PetscCall(PetscSFReduceEnd(sf, MPIU_INT, kmid, keysout, MPI_REPLACE));
+  PetscCall(PetscSFReduceEnd(sf, unit, dmid, dataout, MPI_REPLACE));
+  PetscCall(PetscSFDestroy(&sf));
+  PetscCall(PetscFree2(kmid, dmid));
+  PetscCallMPI(MPI_Type_free(&unit));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -14,9 +14,9 @@ int main(int argc, char **argv)
   MPI_Comm      comm;
   PetscInt      num_coords, dim, num_rand_points = 0, bucket_size = PETSC_DECIDE;
   PetscRandom   random;
-  PetscReal    *coords;
+  PetscReal    *coords, radius = 0.2;
   PetscInt      coords_size, num_points_queried = 0, num_trees_built = 0, loops = 1;
-  PetscBool     view_tree = PETSC_FALSE, view_performance = PETSC_TRUE, test_tree_points = PETSC_FALSE, test_rand_points = PETSC_FALSE, query_rand_points = PETSC_FALSE;
+  PetscBool     view_tree = PETSC_FALSE, view_performance = PETSC_TRUE, test_tree_points = PETSC_FALSE, test_rand_points = PETSC_FALSE, query_rand_points = PETSC_FALSE, test_radius = PETSC_FALSE;
   PetscCopyMode copy_mode = PETSC_OWN_POINTER;
   PetscKDTree   tree;
 
@@ -36,7 +36,9 @@ int main(int argc, char **argv)
   PetscCall(PetscOptionsBool("-test_tree_points", "Test querying tree points against itself", "", test_tree_points, &test_tree_points, NULL));
   PetscCall(PetscOptionsBool("-test_rand_points", "Test querying random points via brute force", "", test_rand_points, &test_rand_points, NULL));
   PetscCall(PetscOptionsBool("-query_rand_points", "Query querying random points", "", query_rand_points, &query_rand_points, NULL));
-  if (test_rand_points || query_rand_points) PetscCall(PetscOptionsInt("-num_rand_points", "Number of random points to test with", "", num_rand_points, &num_rand_points, NULL));
+  PetscCall(PetscOptionsBool("-test_radius", "Test the radius query of random points via brute force", "", test_radius, &test_radius, NULL));
+  if (test_rand_points || query_rand_points || test_radius) PetscCall(PetscOptionsInt("-num_rand_points", "Number of random points to test with", "", num_rand_points, &num_rand_points, NULL));
+  if (test_radius) PetscCall(PetscOptionsReal("-radius", "Radius of the radius query", "", radius, &radius, NULL));
   PetscOptionsEnd();
 
   coords_size = num_coords * dim;
@@ -89,6 +91,28 @@ int main(int argc, char **argv)
             PetscCall(PetscPrintf(comm, "Query failed for random point %" PetscInt_FMT ". Query returned index %" PetscCount_FMT " with distance %g, but coordinate %" PetscInt_FMT " with distance %g is closer\n", i, indices[i], (double)distances[i], index, (double)nearest_distance));
         }
       }
+
+      if (test_radius) {
+        PetscCount *neighbor_offsets, *neighbors;
+
+        PetscCall(PetscKDTreeQueryPointsRadius(tree, num_rand_points, rand_points, radius, &neighbor_offsets, &neighbors));
+        for (PetscInt i = 0; i < num_rand_points; i++) {
+          PetscCount n = neighbor_offsets[i];
+
+          // Neighbors are sorted, so they match the brute force search in order
+          for (PetscInt j = 0; j < num_coords; j++) {
+            if (Distance(dim, &rand_points[dim * i], &coords[dim * j]) > radius) continue;
+            if (n == neighbor_offsets[i + 1] || neighbors[n] != j) {
+              PetscCall(PetscPrintf(comm, "Radius query failed for random point %" PetscInt_FMT ". Coordinate %" PetscInt_FMT " is within the radius but was not found\n", i, j));
+              break;
+            }
+            n++;
+          }
+          if (n != neighbor_offsets[i + 1]) PetscCall(PetscPrintf(comm, "Radius query failed for random point %" PetscInt_FMT ". Query returned %" PetscCount_FMT " neighbors, but %" PetscCount_FMT " are within the radius\n", i, neighbor_offsets[i + 1] - neighbor_offsets[i], n - neighbor_offsets[i]));
+        }
+        PetscCall(PetscFree(neighbor_offsets));
+        PetscCall(PetscFree(neighbors));
+      }
       PetscCall(PetscFree3(rand_points, indices, distances));
     }
   }
@@ -117,7 +141,7 @@ int main(int argc, char **argv)
 /*TEST
   testset:
     suffix: kdtree
-    args: -num_coords 35 -test_tree_points -test_rand_points -num_rand_points 300 -bucket_size 13 -view_performance false -view_tree true -kdtree_debug
+    args: -num_coords 35 -test_tree_points -test_rand_points -test_radius -num_rand_points 300 -bucket_size 13 -view_performance false -view_tree true -kdtree_debug
     test:
       suffix: 1D
       args: -dim 1
@@ -133,7 +157,7 @@ int main(int argc, char **argv)
 
   testset:
     suffix: kdtree_3D_large
-    args: -dim 3 -num_coords 350 -test_tree_points -test_rand_points -num_rand_points 300 -view_performance false -kdtree_debug
+    args: -dim 3 -num_coords 350 -test_tree_points -test_rand_points -test_radius -num_rand_points 300 -view_performance false -kdtree_debug
     output_file: output/empty.out
     test:
     test:
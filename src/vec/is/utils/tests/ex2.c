@@ -0,0 +1,111 @@
+static const char help[] = "Benchmark and test PetscParallelSortIntWithDataArray()\n\n";
+
+#include <petscis.h>
+#include <petsctime.h>
+
+int main(int argc, char **argv)
+{
+  MPI_Comm       comm;
+  PetscMPIInt    rank;
+  PetscInt       n = 1000, payload = 2, max_key = PETSC_INT_MAX, loops = 1, rstart, N;
+  PetscInt      *keys, *keyssorted, *data, *datasorted, *keysref;
+  PetscBool      view_performance = PETSC_TRUE, in_place = PETSC_FALSE, sorted;
+  PetscLayout    mapin, mapout = NULL;
+  PetscRandom    random;
+  PetscLogDouble time_data = 0, time_keys = 0;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  comm = PETSC_COMM_WORLD;
+  PetscCallMPI(MPI_Comm_rank(comm, &rank));
+
+  PetscOptionsBegin(comm, "", "Test Options", "none");
+  PetscCall(PetscOptionsInt("-n", "Average number of keys per process", "", n, &n, NULL));
+  PetscCall(PetscOptionsBoundedInt("-payload", "Number of PetscInt in the payload of each key, at least 2", "", payload, &payload, NULL, 2));
+  PetscCall(PetscOptionsInt("-max_key", "Keys are drawn in (-max_key, max_key)", "", max_key, &max_key, NULL));
+  PetscCall(PetscOptionsBoundedInt("-loops", "Number of times to sort", "", loops, &loops, NULL, 1));
+  PetscCall(PetscOptionsBool("-in_place", "Sort in place", "", in_place, &in_place, NULL));
+  PetscCall(PetscOptionsBool("-view_performance", "View the time of the sorts", "", view_performance, &view_performance, NULL));
+  PetscOptionsEnd();
+
+  /* unbalanced input, balanced output */
+  PetscCall(PetscLayoutCreateFromSizes(comm, n + (rank % 2 ? -rank : rank), PETSC_DECIDE, 1, &mapin));
+  PetscCall(PetscLayoutGetRange(mapin, &rstart, NULL));
+  PetscCall(PetscLayoutGetSize(mapin, &N));
+  if (in_place) PetscCall(PetscLayoutReference(mapin, &mapout));
+  else PetscCall(PetscLayoutCreateFromSizes(comm, PETSC_DECIDE, N, 1, &mapout));
+  PetscCall(PetscMalloc3(mapin->n, &keys, mapin->n, &keysref, mapin->n * payload, &data));
+  PetscCall(PetscMalloc2(mapout->n, &keyssorted, mapout->n * payload, &datasorted));
+  PetscCall(PetscRandomCreate(comm, &random));
+  PetscCall(PetscRandomSetInterval(random, -(PetscReal)max_key, (PetscReal)max_key));
+  PetscCall(PetscRandomSetFromOptions(random));
+
+  for (PetscInt loop = 0; loop < loops; loop++) {
+    PetscInt *kout = in_place ? keys : keyssorted, *dout = in_place ? data : datasorted;
+    PetscInt  sum = 0, sumref = 0;
+
+    /* the payload holds the key and its global input index */
+    for (PetscInt i = 0; i < mapin->n; i++) {
+      PetscReal r;
+
+      PetscCall(PetscRandomGetValueReal(random, &r));
+      keys[i] = keysref[i] = PetscMin((PetscInt)r, max_key - 1);
+      for (PetscInt j = 0; j < payload; j++) data[i * payload + j] = j ? rstart + i : keys[i];
+    }
+    PetscCallMPI(MPI_Barrier(comm));
+    PetscCall(PetscTimeSubtract(&time_data));
+    PetscCall(PetscParallelSortIntWithDataArray(mapin, mapout, keys, data, payload * sizeof(PetscInt), kout, dout));
+    PetscCall(PetscTimeAdd(&time_data));
+
+    PetscCall(PetscParallelSortedInt(comm, mapout->n, kout, &sorted));
+    PetscCheck(sorted, comm, PETSC_ERR_PLIB, "PetscParallelSortIntWithDataArray() failed to sort");
+    if (!in_place) {
+      for (PetscInt i = 0; i < mapin->n; i++) PetscCheck(keys[i] == keysref[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "PetscParallelSortIntWithDataArray() modified input array");
+    }
+    for (PetscInt i = 0; i < mapout->n; i++) {
+      PetscCheck(dout[i * payload] == kout[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Payload of key %" PetscInt_FMT " was not moved with it", kout[i]);
+      sum += dout[i * payload + 1];
+    }
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &sum, 1, MPIU_INT, MPI_SUM, comm));
+    for (PetscInt i = 0; i < N; i++) sumref += i;
+    PetscCheck(sum == sumref, comm, PETSC_ERR_PLIB, "Payloads were lost");
+
+    /* compare with the sort of the keys only */
+    PetscCallMPI(MPI_Barrier(comm));
+    PetscCall(PetscTimeSubtract(&time_keys));
+    PetscCall(PetscParallelSortInt(mapin, mapout, keysref, keyssorted));
+    PetscCall(PetscTimeAdd(&time_keys));
+    for (PetscInt i = 0; i < mapout->n; i++) PetscCheck(keyssorted[i] == kout[i], PETSC_COMM_SELF, PETSC_ERR_PLIB, "Sorts with and without payload differ");
+  }
+  if (view_performance) {
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &time_data, 1, MPI_DOUBLE, MPI_MAX, comm));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &time_keys, 1, MPI_DOUBLE, MPI_MAX, comm));
+    PetscCall(PetscPrintf(comm, "Sorted %" PetscInt_FMT " keys with %" PetscInt_FMT " bytes of payload %" PetscInt_FMT " times\n", N, (PetscInt)(payload * sizeof(PetscInt)), loops));
+    PetscCall(PetscPrintf(comm, "\tPetscParallelSortIntWithDataArray(): %.6e s per sort\n", time_data / loops));
+    PetscCall(PetscPrintf(comm, "\tPetscParallelSortInt() (keys only): %.6e s per sort\n", time_keys / loops));
+  }
+
+  PetscCall(PetscRandomDestroy(&random));
+  PetscCall(PetscFree3(keys, keysref, data));
+  PetscCall(PetscFree2(keyssorted, datasorted));
+  PetscCall(PetscLayoutDestroy(&mapin));
+  PetscCall(PetscLayoutDestroy(&mapout));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+  testset:
+    args: -view_performance false
+    output_file: output/empty.out
+    nsize: {{1 3}}
+    test:
+      suffix: small
+      args: -n 20 -max_key 10
+    test:
+      suffix: radix
+      args: -n 3000 -payload 3
+    test:
+      suffix: in_place
+      args: -n 2000 -in_place
+TEST*/
@@ -77,7 +77,7 @@ PetscErrorCode VecGetValuesSection(Vec v, PetscSection s, PetscInt point, PetscS
   PetscValidHeaderSpecific(v, VEC_CLASSID, 1);
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 2);
   PetscCall(VecGetArray(v, &baseArray));
-  *values = &baseArray[s->atlasOff[p]];
+  *values = &baseArray[PetscSectionGetOffset_Private(s, p)];
   PetscCall(VecRestoreArray(v, &baseArray));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -113,10 +113,10 @@ PetscErrorCode VecSetValuesSection(Vec v, PetscSection s, PetscInt point, const
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 2);
   PetscCall(PetscSectionGetConstraintDof(s, point, &cDim));
   PetscCall(VecGetArray(v, &baseArray));
-  array = &baseArray[s->atlasOff[p]];
+  array = &baseArray[PetscSectionGetOffset_Private(s, p)];
   if (!cDim && doInterior) {
     if (orientation >= 0) {
-      const PetscInt dim = s->atlasDof[p];
+      const PetscInt dim = PetscSectionGetDof_Private(s, p);
       PetscInt       i;
 
       if (doInsert) {
@@ -129,7 +129,7 @@ PetscErrorCode VecSetValuesSection(Vec v, PetscSection s, PetscInt point, const
       PetscInt j      = -1, field, i;
 
       for (field = 0; field < s->numFields; ++field) {
-        const PetscInt dim = s->field[field]->atlasDof[p]; /* PetscSectionGetFieldDof() */
+        const PetscInt dim = PetscSectionGetDof_Private(s->field[field], p); /* PetscSectionGetFieldDof() */
 
         for (i = dim - 1; i >= 0; --i) array[++j] = values[i + offset];
         offset += dim;
@@ -137,7 +137,7 @@ PetscErrorCode VecSetValuesSection(Vec v, PetscSection s, PetscInt point, const
     }
   } else if (cDim) {
     if (orientation >= 0) {
-      const PetscInt  dim  = s->atlasDof[p];
+      const PetscInt  dim  = PetscSectionGetDof_Private(s, p);
       PetscInt        cInd = 0, i;
       const PetscInt *cDof;
 
@@ -170,8 +170,8 @@ PetscErrorCode VecSetValuesSection(Vec v, PetscSection s, PetscInt point, const
 
       PetscCall(PetscSectionGetConstraintIndices(s, point, &cDof));
       for (field = 0; field < s->numFields; ++field) {
-        const PetscInt dim  = s->field[field]->atlasDof[p];     /* PetscSectionGetFieldDof() */
-        const PetscInt tDim = s->field[field]->bc->atlasDof[p]; /* PetscSectionGetFieldConstraintDof() */
+        const PetscInt dim  = PetscSectionGetDof_Private(s->field[field], p); /* PetscSectionGetFieldDof() */
+        const PetscInt tDim = PetscSectionGetDof_Private(s->field[field]->bc, p); /* PetscSectionGetFieldConstraintDof() */
         const PetscInt sDim = dim - tDim;
         PetscInt       cInd = 0, i, k;
 